@@ -98,6 +98,13 @@ using std::uint64_t;
 
 #define CINDER_LITTLE_ENDIAN
 
+// SIMD instruction sets which are guaranteed to be available by the compilation target
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && ( _M_IX86_FP >= 2 ) )
+	#define CINDER_SIMD_SSE2
+#elif defined( __ARM_NEON ) || defined( __ARM_NEON__ )
+	#define CINDER_SIMD_NEON
+#endif
+
 } // namespace cinder
 
 #if defined( CINDER_COCOA ) && ! defined( _LIBCPP_VERSION ) // libstdc++
@@ -25,12 +25,27 @@
 
 #pragma once
 
+#if defined( CINDER_LOCK_FREE_CIRCULAR_BUFFER )
+
+#include "cinder/LockFreeCircularBuffer.h"
+
+namespace cinder {
+
+//! With CINDER_LOCK_FREE_CIRCULAR_BUFFER defined, ConcurrentCircularBuffer is the lock-free LockFreeCircularBuffer.
+template<typename T>
+using ConcurrentCircularBuffer = LockFreeCircularBuffer<T>;
+
+} // namespace cinder
+
+#else
+
 #include "circular/circular.h"
 #include "cinder/Noncopyable.h"
 #include "cinder/Thread.h"
 
 namespace cinder {
 
+//! Bounded queue guarded by a mutex, where pushFront() and popBack() wait for space or items. \see LockFreeCircularBuffer
 template<typename T>
 class ConcurrentCircularBuffer : private Noncopyable {
   public:
@@ -123,4 +138,6 @@ class ConcurrentCircularBuffer : private Noncopyable {
 	bool					mCanceled;
 };
 
-} // namespace cinder
\ No newline at end of file
+} // namespace cinder
+
+#endif // defined( CINDER_LOCK_FREE_CIRCULAR_BUFFER )
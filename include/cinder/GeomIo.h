@@ -37,6 +37,7 @@
 #include <map>
 #include <algorithm>
 #include <array>
+#include <typeinfo>
 
 // Forward declarations in cinder::
 namespace cinder {
@@ -147,6 +148,8 @@ class CI_API Source {
 	
 	virtual void		loadInto( Target *target, const AttribSet &requestedAttribs ) const = 0;
 	virtual Source*		clone() const = 0;
+	//! Combines a hash of every parameter that determines the generated geometry into \a hash. Returns \c false if the geometry can't be identified by its parameters, which is the default. \see SourceMods::cache()
+	virtual bool		hashParams( uint64_t * /*hash*/ ) const { return false; }
 
   protected:
 	//! Builds a sequential list of vertices to simulate an indexed geometry when Source is non-indexed. Assumes \a dest contains storage for getNumVertices() entries
@@ -210,6 +213,8 @@ class CI_API Modifier {
 	virtual AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const;
 	
 	virtual void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const = 0;
+	//! Combines a hash of every parameter that determines the output of process() into \a hash. Returns \c false if the output can't be identified by its parameters or process() has side effects, which is the default. \see SourceMods::cache()
+	virtual bool		hashParams( uint64_t * /*hash*/ ) const { return false; }
 };
 
 class CI_API Rect : public Source {
@@ -233,6 +238,7 @@ class CI_API Rect : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Rect*		clone() const override { return new Rect( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void					setDefaultColors();
@@ -261,6 +267,7 @@ class CI_API RoundedRect : public Source {
 	AttribSet		getAvailableAttribs() const override;
 	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	RoundedRect*	clone() const override { return new RoundedRect( *this ); }
+	bool			hashParams( uint64_t *hash ) const override;
 	
   protected:
 	void updateVertexCount();
@@ -297,6 +304,7 @@ class CI_API Cube : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Cube*		clone() const override { return new Cube( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	ivec3					mSubdivisions;
@@ -319,6 +327,7 @@ class CI_API Icosahedron : public Source {
 	AttribSet		getAvailableAttribs() const override;
 	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Icosahedron*	clone() const override { return new Icosahedron( *this ); }
+	bool			hashParams( uint64_t *hash ) const override;
 
   protected:
 	void		calculate( std::vector<vec3> *positions, std::vector<vec3> *normals, std::vector<vec3> *colors, std::vector<vec2> *texcoords, std::vector<uint32_t> *indices ) const;
@@ -348,6 +357,7 @@ class CI_API Icosphere : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Icosphere*	clone() const override { return new Icosphere( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void	calculate() const;
@@ -375,6 +385,7 @@ class CI_API Teapot : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Teapot*		clone() const override { return new Teapot( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void			calculate( std::vector<float> *positions, std::vector<float> *normals, std::vector<float> *texCoords, std::vector<uint32_t> *indices ) const;
@@ -412,6 +423,7 @@ class CI_API Circle : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Circle*		clone() const override { return new Circle( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   private:
 	void	updateVertexCounts();
@@ -438,6 +450,7 @@ class CI_API Ring : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Ring*		clone() const override { return new Ring( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
 private:
 	void	updateVertexCounts();
@@ -467,6 +480,7 @@ class CI_API Sphere : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Sphere*		clone() const override { return new Sphere( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void		numRingsAndSegments( int *numRings, int *numSegments ) const;
@@ -501,6 +515,7 @@ class CI_API Capsule : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Capsule*	clone() const override { return new Capsule( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   private:
 	void	updateCounts();
@@ -539,6 +554,7 @@ class CI_API Torus : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Torus*		clone() const override { return new Torus( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void		updateCounts();
@@ -581,6 +597,7 @@ public:
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	TorusKnot*	clone() const override { return new TorusKnot( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
 protected:
 	void		calculate( std::vector<vec3> *positions, std::vector<vec3> *normals, std::vector<vec2> *texCoords, std::vector<vec3> *colors, std::vector<vec3> *tangents, std::vector<uint32_t> *indices ) const;
@@ -666,6 +683,7 @@ class CI_API Cylinder : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Cylinder*	clone() const override { return new Cylinder( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void	updateCounts();
@@ -734,6 +752,7 @@ class CI_API Plane : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Plane*		clone() const override { return new Plane( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	ivec2		mSubdivisions;
@@ -763,6 +782,7 @@ class CI_API Extrude : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	Extrude*	clone() const override { return new Extrude( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 	
   protected:
 	void		updatePathSubdivision();
@@ -833,6 +853,7 @@ class CI_API BSpline : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	BSpline*	clone() const override { return new BSpline( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 	
   protected:
 	template<typename T>
@@ -883,6 +904,7 @@ class CI_API WireCapsule : public WireSource {
 	size_t			getNumVertices() const override;
 	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireCapsule*	clone() const override { return new WireCapsule( *this ); }
+	bool			hashParams( uint64_t *hash ) const override;
 
   private:
 	void	calculate( std::vector<vec3> *positions ) const;
@@ -914,6 +936,7 @@ class CI_API WireCircle : public Source {
 	size_t			getNumVertices() const override;
 	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireCircle*		clone() const override { return new WireCircle( *this ); }
+	bool			hashParams( uint64_t *hash ) const override;
 
   private:
 	vec3		mCenter;
@@ -934,6 +957,7 @@ class CI_API WireRoundedRect : public WireSource {
 	size_t				getNumVertices() const override { return mNumVertices; }
 	void				loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireRoundedRect*	clone() const override { return new WireRoundedRect( *this ); }
+	bool				hashParams( uint64_t *hash ) const override;
 	
   protected:
 	void updateVertexCount();
@@ -954,6 +978,7 @@ class CI_API WireRect : public WireSource {
 	Primitive			getPrimitive() const override { return geom::LINE_STRIP; }
   	void 				loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
   	WireRect* 			clone() const override { return new WireRect( *this ); };
+  	bool				hashParams( uint64_t *hash ) const override;
 
   protected:
   	std::array<vec2, 5> mPositions;
@@ -978,6 +1003,7 @@ class CI_API WireCube : public WireSource {
 	size_t		getNumVertices() const override { return ( mSubdivisions.x - 1 ) * 8 + ( mSubdivisions.y - 1 ) * 8 + ( mSubdivisions.z - 1 ) * 8 + 24; }
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireCube*	clone() const override { return new WireCube( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 	
   protected:
 	ivec3					mSubdivisions;
@@ -1013,6 +1039,7 @@ class CI_API WireCylinder : public WireSource {
 	size_t			getNumVertices() const override;
 	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireCylinder*	clone() const override { return new WireCylinder( *this ); }
+	bool			hashParams( uint64_t *hash ) const override;
 
   protected:
 	vec3		mOrigin;
@@ -1064,6 +1091,7 @@ public:
 	size_t				getNumVertices() const override;
 	void				loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireIcosahedron*	clone() const override { return new WireIcosahedron( *this ); }
+	bool				hashParams( uint64_t *hash ) const override;
 
 protected:
 	void		calculate() const;
@@ -1081,6 +1109,7 @@ class CI_API WireFrustum : public WireSource {
 	size_t			getNumVertices() const override { return 24; }
 	void			loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireFrustum*	clone() const override { return new WireFrustum( *this ); }
+	bool			hashParams( uint64_t *hash ) const override;
 
   private:
 	vec3 ntl, ntr, nbl, nbr, ftl, ftr, fbl, fbr;
@@ -1106,6 +1135,7 @@ class CI_API WirePlane : public WireSource {
 	size_t		getNumVertices() const override { return ( mSubdivisions.x + 1 ) * 2 + ( mSubdivisions.y + 1 ) * 2; }
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WirePlane*	clone() const override { return new WirePlane( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	ivec2		mSubdivisions;
@@ -1129,6 +1159,7 @@ class CI_API WireSphere : public WireSource {
 	size_t		getNumVertices() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireSphere*	clone() const override { return new WireSphere( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	vec3		mCenter;
@@ -1157,6 +1188,7 @@ class CI_API WireTorus : public WireSource {
 	size_t		getNumVertices() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	WireTorus*	clone() const override { return new WireTorus( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	vec3		mCenter;
@@ -1189,6 +1221,7 @@ class CI_API Transform : public Modifier {
 	Modifier*			clone() const override { return new Transform( mTransform ); }
 	uint8_t				getAttribDims( Attrib attr, uint8_t upstreamDims ) const override;
 	void				process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool				hashParams( uint64_t *hash ) const override;
 
   protected:
 	mat4		mTransform;
@@ -1235,6 +1268,7 @@ class CI_API Twist : public Modifier {
 
 	Modifier*	clone() const override { return new Twist( *this ); }
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool		hashParams( uint64_t *hash ) const override;
 	
   protected:
 	vec3					mAxisStart, mAxisEnd;
@@ -1249,6 +1283,7 @@ class CI_API Lines : public Modifier {
 	size_t		getNumIndices( const Modifier::Params &upstreamParams ) const override;
 	Primitive	getPrimitive( const Modifier::Params &/*upstreamParams*/ ) const override { return geom::LINES; }
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	static size_t	calcNumIndices( Primitive primitive, size_t upstreamNumIndices, size_t upstreamNumVertices );
@@ -1296,6 +1331,7 @@ class CI_API Constant : public Modifier {
 		: mAttrib( attrib ), mValue( v ), mDims( 4 ) {}
 
 	Modifier*	clone() const override { return new geom::Constant( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 	uint8_t		getAttribDims( Attrib attr, uint8_t upstreamDims ) const override;
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 
@@ -1348,6 +1384,7 @@ class CI_API VertexNormalLines : public Modifier {
 	AttribSet	getAvailableAttribs( const Modifier::Params &upstreamParams ) const override;
 
 	Modifier*	clone() const override { return new VertexNormalLines( mLength, mAttrib ); }
+	bool		hashParams( uint64_t *hash ) const override;
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
 
   protected:
@@ -1365,6 +1402,7 @@ class CI_API Tangents : public Modifier {
 	
 	Modifier*	clone() const override { return new Tangents; }
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool		hashParams( uint64_t *hash ) const override;
 };
 
 //! Inverts the value of an attribute. Works for any dimension.
@@ -1376,6 +1414,7 @@ class CI_API Invert : public Modifier {
 
 	Modifier*	clone() const override { return new Invert( mAttrib ); }
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	Attrib		mAttrib;
@@ -1393,6 +1432,7 @@ class CI_API Remove : public Modifier {
 	
 	Modifier*	clone() const override { return new Remove( mAttrib ); }
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool		hashParams( uint64_t *hash ) const override;
 	
   protected:
 	Attrib		mAttrib;
@@ -1426,6 +1466,7 @@ class CI_API Subdivide : public Modifier {
 	
 	Modifier*	clone() const override { return new Subdivide(); }
 	void		process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const override;
+	bool		hashParams( uint64_t *hash ) const override;
 };
 
 
@@ -1490,16 +1531,16 @@ class CI_API SourceModsContext : public Target {
 class CI_API SourceMods : public Source {
   public:
 	SourceMods()
-		: mVariablesCached( false ), mSourcePtr( nullptr )
+		: mVariablesCached( false ), mSourcePtr( nullptr ), mCacheEnabled( false )
 	{}
 	SourceMods( const geom::Source &source )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( false )
 	{
 		mSourceStorage = std::unique_ptr<Source>( source.clone() );
 		mSourcePtr = mSourceStorage.get();
 	}
 	SourceMods( const geom::Source *source )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( false )
 	{
 		mSourcePtr = source;
 	}
@@ -1510,7 +1551,7 @@ class CI_API SourceMods : public Source {
 	}
 
 	SourceMods( SourceMods &&rhs )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( rhs.mCacheEnabled )
 	{
 		mSourceStorage = std::move( rhs.mSourceStorage );
 		mSourcePtr = rhs.mSourcePtr;
@@ -1519,7 +1560,7 @@ class CI_API SourceMods : public Source {
 	}
 
 	explicit SourceMods( const Source *source, bool clone )
-		: mVariablesCached( false )
+		: mVariablesCached( false ), mCacheEnabled( false )
 	{
 		if( clone ) {
 			mSourceStorage = std::unique_ptr<Source>( source->clone() );
@@ -1542,6 +1583,20 @@ class CI_API SourceMods : public Source {
 	//! Not generally useful. Use getSource() instead. Maps to nullptr when the SourceMods is not responsible for ownership.
 	const std::unique_ptr<Source>&					getSourceStorage() const { return mSourceStorage; }
 
+	//! Enables memoizing the output of loadInto() in a process-wide cache, keyed by the hashParams() of the Source and every Modifier and by the requested attributes.
+	//! Loading an unchanged chain again, even from a different SourceMods, then only copies the stored buffers. Has no effect if any part of the chain doesn't support hashParams(),
+	//! e.g. ExtrudeSpline, ColorFromAttrib, AttribFn and Bounds, whose output depends on a callback or which write a result. Besides the hash, a cache hit compares the types
+	//! in the chain, the requested attributes and their dimensions, and the vertex and index counts, so a hash collision regenerates the geometry. Disabled by default.
+	SourceMods&	cache( bool enable = true )	{ mCacheEnabled = enable; return *this; }
+	//! Returns whether the output of loadInto() is memoized. \see cache()
+	bool		isCacheEnabled() const		{ return mCacheEnabled; }
+	//! Releases all geometry held by the cache used by cache().
+	static void	clearCache();
+	//! Sets the maximum number of geometries kept by the cache used by cache(). The least recently used are evicted first. Defaults to \c 32.
+	static void	setCacheCapacity( size_t numEntries );
+	//! Returns the number of geometries currently held by the cache used by cache().
+	static size_t	getCacheSize();
+
 	// geom::Source methods
 	size_t		getNumVertices() const override;
 	size_t		getNumIndices() const override;
@@ -1550,10 +1605,14 @@ class CI_API SourceMods : public Source {
 	AttribSet	getAvailableAttribs() const override;
 	void		loadInto( Target *target, const AttribSet &requestedAttribs ) const override;
 	SourceMods*	clone() const override { return new SourceMods( *this ); }
+	bool		hashParams( uint64_t *hash ) const override;
 
   protected:
 	void		copyImpl( const SourceMods &rhs );
 	void		cacheVariables() const;
+	void		loadIntoImpl( Target *target, const AttribSet &requestedAttribs ) const;
+	//! Appends the types of the Source and Modifiers, or of the children, which the cache compares in addition to hashParams().
+	void		appendTypes( std::vector<const std::type_info*> *types ) const;
 	
 	const Source* 							mSourcePtr; // null if we have children
 	std::unique_ptr<Source>					mSourceStorage; // null if we don't have ownership
@@ -1563,6 +1622,7 @@ class CI_API SourceMods : public Source {
 	mutable std::vector<Modifier::Params>	mParamsStack;
 	
 	std::vector<std::unique_ptr<SourceMods>>	mChildren;
+	bool										mCacheEnabled;
 	
 	friend class SourceModsContext;
 };
@@ -37,21 +37,39 @@ typedef std::shared_ptr<class ImageTargetFileTinyExr> ImageTargetFileTinyExrRef;
 
 typedef std::shared_ptr<class ImageSourceFileTinyExr>	ImageSourceFileTinyExrRef;
 
+//! Loads OpenEXR scanline and tiled images. Blocks are decoded in parallel on ThreadPool::getDefault(), straight into the target's rows when the target allows it. ImageSource::Options::channels() selects the channels that are loaded.
 class ImageSourceFileTinyExr : public ImageSource {
   public:
 	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options options = ImageSource::Options() );
 
 	void load( ImageTargetRef target ) override;
 
+	//! Returns the names of every channel in the file, such as "R" or "diffuse.R".
+	const std::vector<std::string>&	getChannelNames() const { return mChannelNames; }
+
 	static void		registerSelf();
 
 protected:
 	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, ImageSource::Options options );
 
-	std::unique_ptr<EXRHeader, std::function<int( EXRHeader * )>> mExrHeader; // We're using the provided FreeEXRHeader function as a custom deleter
-	std::unique_ptr<EXRImage, std::function<int( EXRImage * )>>   mExrImage;  // We're using the provided FreeEXRImage function as a custom deleter
+	void	selectChannels( const std::vector<std::string> &names );
+	template<typename T>
+	void	loadBlocks( const ImageTargetRef &target, RowFunc rowFunc );
+	template<typename T>
+	void	decodeBlock( size_t block, const std::function<T*( int32_t row )> &rowPointer, std::vector<uint8_t> *scratch, std::vector<uint8_t> *raw );
+	Area	getBlockArea( size_t block ) const;
+
+	BufferRef					mBuffer;
+	std::unique_ptr<EXRHeader, std::function<int( EXRHeader * )>> mExrHeader; // freed with FreeEXRHeader()
+	std::unique_ptr<EXRImage, std::function<int( EXRImage * )>>   mExrImage;  // freed with FreeEXRImage(); only loaded for compressions decoded by TinyExr
+	std::vector<std::string>	mChannelNames;
+	std::vector<int>			mLoadChannels;		// file channel of each interleaved channel
+	std::vector<uint64_t>		mBlockOffsets;
+	bool						mDecodeBlocks;		// whether blocks are decompressed here rather than by TinyExr
+	int32_t						mBlockWidth, mBlockHeight, mNumBlocksX;
 };
 
+//! Writes scanline OpenEXR images as half floats, compressing blocks of lines in parallel. ImageTarget::Options::compressionLevel() above \c 0 selects ZIP compression at that level.
 class ImageTargetFileTinyExr : public ImageTarget {
   public:
 	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
@@ -64,10 +82,16 @@ class ImageTargetFileTinyExr : public ImageTarget {
   protected:
 	ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
 
+	template<typename T>
+	void	encodeBlock( int32_t y0, int32_t y1, std::vector<uint8_t> *block );
+
 	uint8_t                  mNumComponents;
-	fs::path                 mFilePath;
-	std::vector<float>       mData;
-	std::vector<std::string> mChannelNames;
+	ImageTarget::Options     mOptions;
+	DataTargetRef            mDataTarget;
+	size_t                   mRowBytes;
+	std::vector<uint8_t>     mData;
+	std::vector<std::string> mChannelNames;		// in file order, which is alphabetical
+	std::vector<int>         mChannelIndices;	// interleaved channel of each file channel
 };
 
 class ImageIoExceptionFailedLoadTinyExr : public ImageIoExceptionFailedLoad {
@@ -85,27 +85,44 @@ class CI_API ImageIo {
 
 class CI_API ImageSource : public ImageIo {
   public:
-	ImageSource() : ImageIo(), mIsPremultiplied( false ), mPixelAspectRatio( 1 ), mCustomPixelInc( 0 ), mFrameCount( 1 ) {}
+	ImageSource() : ImageIo(), mIsPremultiplied( false ), mPixelAspectRatio( 1 ), mCustomPixelInc( 0 ), mFrameCount( 1 ), mSourceArea( 0, 0, 0, 0 ), mReduction( 1 ), mRegionApplied( false ) {}
 	virtual ~ImageSource() {}  
 
 	//! Optional parameters passed when creating an Image. \see loadImage()
 	class Options {
 	  public:
-		Options() : mIndex( 0 ), mThrowOnFirstException( false ) {}
+		Options() : mIndex( 0 ), mThrowOnFirstException( false ), mArea( 0, 0, 0, 0 ), mMaxSize( 0 ) {}
 
 		//! Specifies an image index for multi-part images, like animated GIFs. 0-based index.
 		Options& index( int32_t index )						{ mIndex = index; return *this; }
 		//! If an exception occurs, enabling this will prevent any attempts at using other handlers to load the image. Default = false, all handlers are tried and if none succeed, the last exception is rethrown. \see ImageIoException
 		Options& throwOnFirstException( bool b = true )		{ mThrowOnFirstException = b; return *this; }
+		//! Specifies the region of the image to decode, in pixels of the full resolution image. An empty Area, the default, decodes the whole image.
+		Options& area( const Area &area )					{ mArea = area; return *this; }
+		//! Specifies the maximum size of the decoded image. The image, or its area(), is reduced by the smallest integer factor that fits within \a maxSize, so the result may be smaller. A component of \c 0, the default, is unbounded.
+		Options& maxSize( const ivec2 &maxSize )			{ mMaxSize = maxSize; return *this; }
+		//! Selects the named channels to load from formats that support them, such as OpenEXR, in the order R, G, B and A. One or two names load as gray and alpha. Empty, the default, loads R, G, B and A or Y and A.
+		Options& channels( const std::vector<std::string> &names )	{ mChannels = names; return *this; }
 
 		//! Returns image index. \see index()
 		int32_t				getIndex() const				{ return mIndex; }
 		//! Returns whether throwOnFirstException() is enabled or not.
 		bool				getThrowOnFirstException()		{ return mThrowOnFirstException; }
-		
+		//! Returns the region of the image to decode. \see area()
+		const Area&			getArea() const					{ return mArea; }
+		//! Returns the maximum size of the decoded image. \see maxSize()
+		const ivec2&		getMaxSize() const				{ return mMaxSize; }
+		//! Returns whether area() or maxSize() ask for less than the whole image at full resolution.
+		bool				isRegionSpecified() const		{ return mArea.calcArea() != 0 || mMaxSize.x > 0 || mMaxSize.y > 0; }
+		//! Returns the names of the channels to load. \see channels()
+		const std::vector<std::string>&	getChannels() const	{ return mChannels; }
+
 	  protected:
-		int32_t			mIndex;
-		bool			mThrowOnFirstException;
+		int32_t						mIndex;
+		bool						mThrowOnFirstException;
+		Area						mArea;
+		ivec2						mMaxSize;
+		std::vector<std::string>	mChannels;
 	};
 
 	//! Returns the aspect ratio of individual pixels to accommodate non-square pixels
@@ -116,11 +133,22 @@ class CI_API ImageSource : public ImageIo {
 	size_t		getRowBytes() const;	
 	//! Returns the number of images. Generally \c 1 but may not be in the case of animated GIFs. \see Options::index()
 	int32_t		getCount() const { return mFrameCount; }
+	//! Returns the region of the full resolution image that is decoded, as specified by Options::area(). Empty if Options::area() and Options::maxSize() weren't applied.
+	const Area&	getSourceArea() const { return mSourceArea; }
+	//! Returns the factor by which getSourceArea() is reduced to fit within Options::maxSize(). \c 1 if the image is decoded at full resolution.
+	int32_t		getReduction() const { return mReduction; }
+	//! Returns whether Options::area() and Options::maxSize() have been applied, in which case getWidth() and getHeight() return the size of the decoded result.
+	bool		isRegionApplied() const { return mRegionApplied; }
 
 	virtual void	load( ImageTargetRef target ) = 0;
 
 	typedef void (ImageSource::*RowFunc)(ImageTargetRef, int32_t, const void*);
 
+	//! Enables or disables the SIMD row conversion kernels that setupRowFunc() selects for common 8-bit layouts. Enabled by default; disabling them is mostly useful for testing and benchmarking.
+	static void		setRowFuncKernelsEnabled( bool enable );
+	//! Returns whether the SIMD row conversion kernels are enabled. \see setRowFuncKernelsEnabled()
+	static bool		isRowFuncKernelsEnabled();
+
   protected:
 	void		setPixelAspectRatio( float pixelAspectRatio ) { mPixelAspectRatio = pixelAspectRatio; }
 	void		setPremultiplied( bool premult = true ) { mIsPremultiplied = premult; }
@@ -128,7 +156,17 @@ class CI_API ImageSource : public ImageIo {
 	void		setCustomPixelInc( int8_t customPixelInc ) { mCustomPixelInc = customPixelInc; }
 	void		setFrameCount( int32_t frameCount ) { mFrameCount = frameCount; }
 
+	//! Applies Options::area() and Options::maxSize() once the full resolution size has been set with setSize(), after which getWidth() and getHeight() return the reduced size. Rows should then be passed through processRow().
+	void		setupRegion( const Options &options );
+	//! Passes full resolution row \a sourceRow, in the source's format, through \a func to \a target, cropping and averaging it as specified by setupRegion(). Rows must arrive top to bottom. Returns \c false once no further rows are needed, so decoders can stop early.
+	bool		processRow( const ImageTargetRef &target, RowFunc func, int32_t sourceRow, const void *data );
+	template<typename SD>
+	void		accumulateRow( const void *data );
+	template<typename SD>
+	void		resolveRow();
+
 	RowFunc		setupRowFunc( ImageTargetRef target );
+	RowFunc		setupRowFuncKernel( const ImageTargetRef &target );
 	void		setupRowFuncRgbSource( ImageTargetRef target );
 	void		setupRowFuncGraySource( ImageTargetRef target );
 	template<typename SD, typename TD, ColorModel TCS>
@@ -142,16 +180,27 @@ class CI_API ImageSource : public ImageIo {
 	void		rowFuncSourceRgb( ImageTargetRef target, int32_t row, const void *data );
 	template<typename SD, typename TD, ColorModel TCM, bool ALPHA>
 	void		rowFuncSourceGray( ImageTargetRef target, int32_t row, const void *data );
+	void		rowFuncCopy( ImageTargetRef target, int32_t row, const void *data );
+	void		rowFunc8uTo32f( ImageTargetRef target, int32_t row, const void *data );
+	template<int SOURCE_INC, int TARGET_INC>
+	void		rowFuncSwizzle8u( ImageTargetRef target, int32_t row, const void *data );
 
 	float						mPixelAspectRatio;
 	bool						mIsPremultiplied;
 	int8_t						mCustomPixelInc;
 	int32_t						mFrameCount;
+
+	Area						mSourceArea;
+	int32_t						mReduction;
+	bool						mRegionApplied;
+	std::vector<float>			mReductionSums;
+	std::vector<uint8_t>		mReductionRow;
 	
 	int8_t						mRowFuncSourceRed, mRowFuncSourceGreen, mRowFuncSourceBlue, mRowFuncSourceAlpha;
 	int8_t						mRowFuncTargetRed, mRowFuncTargetGreen, mRowFuncTargetBlue, mRowFuncTargetAlpha;
 	int8_t						mRowFuncSourceGray, mRowFuncTargetGray;
 	int8_t						mRowFuncSourceInc, mRowFuncTargetInc;
+	int8_t						mRowFuncSwizzle[4]; // source channel of each target channel for rowFuncSwizzle8u(), -1 for opaque
 };
 
 class CI_API ImageTarget : public ImageIo {
@@ -161,35 +210,50 @@ class CI_API ImageTarget : public ImageIo {
 	virtual void*	getRowPointer( int32_t row ) = 0;
 	virtual void	setRow( int32_t /*row*/, const void * /*data*/ ) { throw; }
 	virtual void	finalize() { }
+	//! Returns whether distinct rows may be requested and written from several threads at once, which lets decoders fill them from their worker threads. Default is \c false.
+	virtual bool	isRowAccessThreadSafe() const { return false; }
 	
 	class Options {
 	  public:
-		Options() : mQuality( 0.9f ), mColorModelDefault( true ) {}
+		//! The row filter applied by PNG encoders before compression. PNG_FILTER_ADAPTIVE picks the filter per row.
+		enum PngFilter { PNG_FILTER_NONE, PNG_FILTER_SUB, PNG_FILTER_UP, PNG_FILTER_AVERAGE, PNG_FILTER_PAETH, PNG_FILTER_ADAPTIVE };
+
+		Options() : mQuality( 0.9f ), mColorModelDefault( true ), mCompressionLevel( -1 ), mPngFilter( PNG_FILTER_ADAPTIVE ), mNumThreads( 0 ) {}
 		
 		Options& quality( float quality ) { mQuality = quality; return *this; }
 		Options& colorModel( ImageIo::ColorModel cm ) { mColorModelDefault = false; mColorModel = cm; return *this; }
+		//! Sets the compression level of lossless encoders, from \c 0 (none) to \c 9 (smallest and slowest). \c -1 uses the encoder's default. PNG maps it to the zlib level and EXR compresses with ZIP when it is above \c 0.
+		Options& compressionLevel( int level ) { mCompressionLevel = level; return *this; }
+		//! Sets the row filter used by PNG encoders. Default is PNG_FILTER_ADAPTIVE.
+		Options& pngFilter( PngFilter filter ) { mPngFilter = filter; return *this; }
+		//! Sets the number of image parts encoded concurrently by encoders that support it. \c 1 encodes on the calling thread and \c 0, the default, uses every thread of ThreadPool::getDefault().
+		Options& numThreads( size_t numThreads ) { mNumThreads = numThreads; return *this; }
 		
 		void	setColorModelDefault() { mColorModelDefault = true; }
 		
 		float				getQuality() const { return mQuality; }
 		bool				isColorModelDefault() const { return mColorModelDefault; }
 		ImageIo::ColorModel	getColorModel() const { return mColorModel; }
+		int					getCompressionLevel() const { return mCompressionLevel; }
+		PngFilter			getPngFilter() const { return mPngFilter; }
+		size_t				getNumThreads() const { return mNumThreads; }
 		
 	  protected:
 		float					mQuality;
 		bool					mColorModelDefault;
 		ImageIo::ColorModel		mColorModel;
+		int						mCompressionLevel;
+		PngFilter				mPngFilter;
+		size_t					mNumThreads;
 	};
 	
   protected:
 	ImageTarget() {}	
 };
 
-#if defined( CINDER_UWP )
 //! Asynchronously loads an image from the file path \a path. Callback function \a callback will be called on main UI thread. Optional \a extension parameter allows specification of a file type. For example, "jpg" would force the file to load as a JPEG
-
-void loadImageAsync(const fs::path path, std::function<void (ImageSourceRef)> callback, ImageSource::Options options = ImageSource::Options(), std::string extension = "" );
-#endif
+//! Outside of UWP the image is decoded by ImageLoader::instance(), and \a callback receives a null ImageSourceRef if loading fails. \see ImageLoader
+CI_API void loadImageAsync(const fs::path path, std::function<void (ImageSourceRef)> callback, ImageSource::Options options = ImageSource::Options(), std::string extension = "" );
 
 
 //! Loads an image from the file path \a path. Optional \a extension parameter allows specification of a file type. For example, "jpg" would force the file to load as a JPEG
@@ -0,0 +1,170 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Signals.h"
+#include "cinder/Surface.h"
+
+#include <deque>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageLoader>	ImageLoaderRef;
+typedef std::shared_ptr<class ThreadPool>	ThreadPoolRef;
+
+//! Decodes images on a pool of worker threads and keeps the most recently used Surfaces in a cache bounded by bytes.
+//! Requests for an image that is already queued or decoding share a single decode. Results are delivered from update(), which by default is
+//! connected to the App's update signal, so callbacks and getSignalLoaded() fire on the main thread.
+//! Images are always decoded to 8 bits per channel, so 16-bit and floating point sources lose precision and HDR values are clamped. Use loadImage() directly for those.
+class CI_API ImageLoader : private Noncopyable {
+  public:
+	//! Construction options for ImageLoader.
+	struct CI_API Options {
+		Options() : mNumThreads( 2 ), mCacheCapacity( 256 * 1024 * 1024 ), mConnectToAppUpdate( true ) {}
+
+		//! Sets the number of decoding threads. \c 0 uses one thread less than the number of hardware threads. Default is \c 2, since decoding is usually bound by I/O as much as by the CPU.
+		Options& numThreads( size_t numThreads )		{ mNumThreads = numThreads; return *this; }
+		//! Sets the maximum number of bytes of decoded pixels kept in the cache. \c 0 disables caching. Default is 256 MB.
+		Options& cacheCapacity( size_t bytes )			{ mCacheCapacity = bytes; return *this; }
+		//! Sets whether update() is connected to the App's update signal when there is an App instance. Default is \c true.
+		Options& connectToAppUpdate( bool b = true )	{ mConnectToAppUpdate = b; return *this; }
+
+		size_t	getNumThreads() const				{ return mNumThreads; }
+		size_t	getCacheCapacity() const			{ return mCacheCapacity; }
+		bool	isConnectToAppUpdateEnabled() const	{ return mConnectToAppUpdate; }
+
+	  private:
+		size_t	mNumThreads, mCacheCapacity;
+		bool	mConnectToAppUpdate;
+	};
+
+	//! The outcome of a load() request, as passed to its callback and to getSignalLoaded().
+	class CI_API Result {
+	  public:
+		//! Returns the path that was requested.
+		const fs::path&		getPath() const			{ return mPath; }
+		//! Returns the decoded image converted to 8 bits per channel, or \c nullptr if decoding failed.
+		const Surface8uRef&	getSurface() const		{ return mSurface; }
+		//! Returns whether the image was served from the cache without decoding.
+		bool				isFromCache() const		{ return mFromCache; }
+		//! Returns a description of the error if decoding failed, otherwise an empty string.
+		const std::string&	getError() const		{ return mError; }
+
+	  private:
+		fs::path		mPath;
+		Surface8uRef	mSurface;
+		bool			mFromCache = false;
+		std::string		mError;
+
+		friend class ImageLoader;
+	};
+
+	typedef std::function<void( const Result& )>	CallbackFn;
+
+	static ImageLoaderRef	create( const Options &options = Options() )	{ return ImageLoaderRef( new ImageLoader( options ) ); }
+	//! Returns the global instance of ImageLoader, which is created with default Options on first use.
+	static ImageLoader&		instance();
+
+	~ImageLoader();
+
+	//! Requests the image at \a path, calling \a callback from update() once it is available. Requests are serviced in the order they were made.
+	//! If the image is cached no decoding takes place, and if it is already queued or decoding the request joins that decode. Requests that differ in ImageSource::Options::area() or maxSize() are decoded and cached separately.
+	void	load( const fs::path &path, const CallbackFn &callback = CallbackFn(), const ImageSource::Options &options = ImageSource::Options(), const std::string &extension = "" );
+	//! Removes the queued request for \a path without calling its callbacks. Returns \c false if there was none, or if it is already decoding.
+	bool	cancel( const fs::path &path, const ImageSource::Options &options = ImageSource::Options(), const std::string &extension = "" );
+	//! Removes every queued request. Images that are already decoding are still delivered.
+	void	cancelAll();
+
+	//! Returns the cached image for \a path and marks it as recently used, or \c nullptr if it is not cached.
+	Surface8uRef	getCached( const fs::path &path, const ImageSource::Options &options = ImageSource::Options(), const std::string &extension = "" );
+	//! Returns whether the image for \a path is in the cache.
+	bool			isCached( const fs::path &path, const ImageSource::Options &options = ImageSource::Options(), const std::string &extension = "" ) const;
+
+	//! Delivers completed requests to their callbacks and to getSignalLoaded(). Called automatically from the App's update signal unless Options::connectToAppUpdate() was disabled.
+	void	update();
+	//! Returns the signal emitted from update() for every completed request, including those without a callback.
+	signals::Signal<void( const Result& )>&	getSignalLoaded()	{ return mSignalLoaded; }
+
+	//! Returns the number of requested images that haven't been delivered by update() yet.
+	size_t	getNumPending() const;
+
+	//! Sets the maximum number of bytes of decoded pixels kept in the cache, evicting the least recently used images as needed.
+	void	setCacheCapacity( size_t bytes );
+	//! Returns the maximum number of bytes of decoded pixels kept in the cache.
+	size_t	getCacheCapacity() const;
+	//! Returns the number of bytes of decoded pixels currently in the cache.
+	size_t	getCacheSize() const;
+	//! Returns the number of images currently in the cache.
+	size_t	getNumCached() const;
+	//! Removes every image from the cache. Surfaces that are still referenced elsewhere stay valid.
+	void	clearCache();
+
+  private:
+	explicit ImageLoader( const Options &options );
+
+	struct Request {
+		std::string					mKey;
+		fs::path					mPath;
+		ImageSource::Options		mOptions;
+		std::string					mExtension;
+		std::vector<CallbackFn>		mCallbacks;
+		Result						mResult;
+	};
+
+	struct CacheEntry {
+		std::string		mKey;
+		Surface8uRef	mSurface;
+		size_t			mNumBytes;
+	};
+
+	static std::string	makeKey( const fs::path &path, const ImageSource::Options &options, const std::string &extension );
+
+	void	decodeNext();
+	void	insertCachedImpl( const std::string &key, const Surface8uRef &surface );
+	void	evictImpl( size_t capacity );
+	void	connectAppUpdate();
+
+	mutable std::mutex												mMutex;
+	std::unordered_map<std::string, std::shared_ptr<Request>>		mRequests;		// queued or decoding, by key
+	std::deque<std::shared_ptr<Request>>							mQueue;			// not yet picked up by a worker
+	std::vector<std::shared_ptr<Request>>							mCompleted;		// waiting for update()
+
+	std::list<CacheEntry>											mCache;			// most recently used first
+	std::unordered_map<std::string, std::list<CacheEntry>::iterator>	mCacheIndex;
+	size_t															mCacheCapacity, mCacheSize;
+
+	signals::Signal<void( const Result& )>	mSignalLoaded;
+	signals::Connection						mConnectionAppUpdate;
+	bool									mConnectToAppUpdate;
+	ThreadPoolRef							mThreadPool;
+};
+
+} // namespace cinder
@@ -0,0 +1,134 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Signals.h"
+#include "cinder/Surface.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageWriter>	ImageWriterRef;
+typedef std::shared_ptr<class ThreadPool>	ThreadPoolRef;
+
+//! Encodes and writes images on background threads, so that capturing frames overlaps with compressing and writing the previous ones.
+//! Completions are delivered from update(), which by default is connected to the App's update signal, so callbacks and getSignalWritten() fire on the main thread.
+class CI_API ImageWriter : private Noncopyable {
+  public:
+	//! Construction options for ImageWriter.
+	struct CI_API Options {
+		Options() : mNumThreads( 1 ), mMaxQueued( 4 ), mConnectToAppUpdate( true ) {}
+
+		//! Sets the number of images encoded at the same time. Default is \c 1, since the PNG encoder already spreads each image across ThreadPool::getDefault().
+		Options& numThreads( size_t numThreads )		{ mNumThreads = numThreads; return *this; }
+		//! Sets how many images may wait to be encoded before write() blocks, which bounds the memory held by queued copies. \c 0 never blocks. Default is \c 4.
+		Options& maxQueued( size_t maxQueued )			{ mMaxQueued = maxQueued; return *this; }
+		//! Sets whether update() is connected to the App's update signal when there is an App instance. Default is \c true.
+		Options& connectToAppUpdate( bool b = true )	{ mConnectToAppUpdate = b; return *this; }
+
+		size_t	getNumThreads() const				{ return mNumThreads; }
+		size_t	getMaxQueued() const				{ return mMaxQueued; }
+		bool	isConnectToAppUpdateEnabled() const	{ return mConnectToAppUpdate; }
+
+	  private:
+		size_t	mNumThreads, mMaxQueued;
+		bool	mConnectToAppUpdate;
+	};
+
+	//! The outcome of a write() request, as passed to its callback and to getSignalWritten().
+	class CI_API Result {
+	  public:
+		//! Returns the path that was written.
+		const fs::path&		getPath() const		{ return mPath; }
+		//! Returns a description of the error if writing failed, otherwise an empty string.
+		const std::string&	getError() const	{ return mError; }
+
+	  private:
+		fs::path		mPath;
+		std::string		mError;
+
+		friend class ImageWriter;
+	};
+
+	typedef std::function<void( const Result& )>	CallbackFn;
+
+	static ImageWriterRef	create( const Options &options = Options() )	{ return ImageWriterRef( new ImageWriter( options ) ); }
+
+	//! Waits for every queued image to be written. Callbacks of the writes that complete during destruction are not called.
+	~ImageWriter();
+
+	//! Copies \a surface and queues the copy to be written to \a path, calling \a callback from update() once it has been written. Blocks while Options::maxQueued() images are waiting.
+	template<typename T>
+	void	write( const fs::path &path, const SurfaceT<T> &surface, const ImageTarget::Options &options = ImageTarget::Options(), const std::string &extension = "", const CallbackFn &callback = CallbackFn() )
+	{
+		write( path, (ImageSourceRef)surface.clone(), options, extension, callback );
+	}
+	//! Queues \a imageSource to be written to \a path. \a imageSource is read on a worker thread, so its pixels must stay unchanged until the write completes.
+	void	write( const fs::path &path, const ImageSourceRef &imageSource, const ImageTarget::Options &options = ImageTarget::Options(), const std::string &extension = "", const CallbackFn &callback = CallbackFn() );
+
+	//! Blocks until every queued image has been written. Their callbacks are still delivered by update().
+	void	flush();
+
+	//! Delivers completed writes to their callbacks and to getSignalWritten(). Called automatically from the App's update signal unless Options::connectToAppUpdate() was disabled.
+	void	update();
+	//! Returns the signal emitted from update() for every completed write, including those without a callback.
+	signals::Signal<void( const Result& )>&	getSignalWritten()	{ return mSignalWritten; }
+
+	//! Returns the number of queued writes that haven't been delivered by update() yet.
+	size_t	getNumPending() const;
+
+  private:
+	explicit ImageWriter( const Options &options );
+
+	struct Request {
+		ImageSourceRef			mImageSource;
+		ImageTarget::Options	mOptions;
+		std::string				mExtension;
+		CallbackFn				mCallback;
+		Result					mResult;
+	};
+
+	void	writeNext();
+	void	connectAppUpdate();
+
+	mutable std::mutex							mMutex;
+	std::condition_variable						mCond;			// signaled when a request leaves the queue or completes
+	std::deque<std::shared_ptr<Request>>		mQueue;			// not yet picked up by a worker
+	std::vector<std::shared_ptr<Request>>		mCompleted;		// waiting for update()
+	size_t										mNumWriting, mMaxQueued;
+
+	signals::Signal<void( const Result& )>	mSignalWritten;
+	signals::Connection						mConnectionAppUpdate;
+	bool									mConnectToAppUpdate;
+	ThreadPoolRef							mThreadPool;
+};
+
+} // namespace cinder
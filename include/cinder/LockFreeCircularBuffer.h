@@ -0,0 +1,261 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Exception.h"
+#include "cinder/Noncopyable.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+namespace cinder {
+
+//! \brief Bounded, lock-free multi-producer / multi-consumer queue with the interface of ConcurrentCircularBuffer.
+//!
+//! Each slot carries a sequence number that tells producers and consumers whether it is free or filled for their turn, so
+//! tryPushFront() and tryPopBack() only need a single compare-and-swap on a shared position and never block one another. The
+//! blocking pushFront() and popBack() spin briefly and then sleep; a thread that makes room or adds an item only takes a
+//! mutex to wake others when somebody is actually sleeping. tryPopBack( T*, size_t ) claims a run of filled slots with one
+//! compare-and-swap, which is cheaper than popping items one at a time when a consumer drains a busy queue.
+//!
+//! Define CINDER_LOCK_FREE_CIRCULAR_BUFFER before including ConcurrentCircularBuffer.h (or project wide) to make
+//! ConcurrentCircularBuffer an alias of this class.
+//!
+//! Items are moved into and out of a slot after it has been claimed, so \a T's move constructor and move assignment must not
+//! throw. Copies are made before a slot is claimed, so a throwing copy constructor leaves the buffer unchanged.
+template<typename T>
+class LockFreeCircularBuffer : private Noncopyable {
+	static_assert( std::is_nothrow_move_constructible<T>::value && std::is_nothrow_move_assignable<T>::value,
+					"LockFreeCircularBuffer requires T's move constructor and move assignment to be noexcept" );
+
+  public:
+	typedef size_t size_type;
+
+	//! Creates a buffer that holds up to \a capacity items. Throws ci::Exception if \a capacity is \c 0.
+	explicit LockFreeCircularBuffer( size_type capacity )
+		: mCapacity( capacity ), mCells( new Cell[capacity] ), mEnqueuePos( 0 ), mDequeuePos( 0 ), mNumWaiting( 0 ), mCanceled( false )
+	{
+		if( mCapacity == 0 )
+			throw Exception( "LockFreeCircularBuffer capacity must be greater than zero" );
+
+		for( size_t i = 0; i < mCapacity; i++ )
+			mCells[i].mSequence.store( i, std::memory_order_relaxed );
+	}
+
+	~LockFreeCircularBuffer()
+	{
+		for( size_t pos = mDequeuePos; pos != mEnqueuePos; pos++ )
+			reinterpret_cast<T *>( &mCells[pos % mCapacity].mStorage )->~T();
+	}
+
+	//! Pushes \a item to the front of the buffer, waiting for space if it is full. Returns without pushing if cancel() is called.
+	void pushFront( const T &item )
+	{
+		T copy( item );
+		for( size_t attempt = 0; ! mCanceled.load( std::memory_order_acquire ); attempt++ ) {
+			if( tryPushMoved( &copy ) )
+				return;
+
+			wait( attempt, [this] { return isNotFull(); } );
+		}
+	}
+
+	//! Pops an item from the back of the buffer into \a pItem, waiting for one if it is empty. Returns without popping if cancel() is called.
+	void popBack( T *pItem )
+	{
+		for( size_t attempt = 0; ! mCanceled.load( std::memory_order_acquire ); attempt++ ) {
+			if( tryPopBack( pItem ) )
+				return;
+
+			wait( attempt, [this] { return isNotEmpty(); } );
+		}
+	}
+
+	//! Attempts to push \a item to the front of the buffer, but does not wait for an availability. Returns success as true or false.
+	bool tryPushFront( const T &item )
+	{
+		T copy( item );
+		return tryPushMoved( &copy );
+	}
+
+	//! Attempts to pop an item from the back of the buffer, but does not wait for an availability. Returns success as true or false.
+	bool tryPopBack( T *pItem )
+	{
+		return tryPopBack( pItem, 1 ) == 1;
+	}
+
+	//! Pops up to \a maxItems items from the back of the buffer into \a items without waiting. Returns the number of items popped.
+	size_t tryPopBack( T *items, size_t maxItems )
+	{
+		if( ! maxItems )
+			return 0;
+
+		size_t pos = mDequeuePos.load( std::memory_order_relaxed );
+		size_t count;
+		while( true ) {
+			// count the run of filled cells starting at pos, then claim all of them at once
+			count = 0;
+			while( count < maxItems && count < mCapacity ) {
+				const size_t sequence = mCells[( pos + count ) % mCapacity].mSequence.load( std::memory_order_acquire );
+				if( sequence != pos + count + 1 )
+					break;
+				count++;
+			}
+
+			if( count == 0 ) {
+				const size_t sequence = mCells[pos % mCapacity].mSequence.load( std::memory_order_acquire );
+				if( (std::ptrdiff_t)sequence - (std::ptrdiff_t)( pos + 1 ) < 0 )
+					return 0; // empty
+
+				pos = mDequeuePos.load( std::memory_order_relaxed );
+				continue;
+			}
+
+			if( mDequeuePos.compare_exchange_weak( pos, pos + count, std::memory_order_relaxed ) )
+				break;
+		}
+
+		for( size_t i = 0; i < count; i++ ) {
+			Cell &cell = mCells[( pos + i ) % mCapacity];
+			T *item = reinterpret_cast<T *>( &cell.mStorage );
+			items[i] = std::move( *item );
+			item->~T();
+			cell.mSequence.store( pos + i + mCapacity, std::memory_order_release );
+		}
+
+		notifyWaiting();
+		return count;
+	}
+
+	//! Returns whether the buffer holds any items. Only a snapshot when other threads are pushing or popping.
+	bool isNotEmpty() const		{ return getSize() > 0; }
+	//! Returns whether the buffer has room for another item. Only a snapshot when other threads are pushing or popping.
+	bool isNotFull() const		{ return getSize() < mCapacity; }
+
+	//! Wakes all threads waiting in pushFront() or popBack(), which return without pushing or popping. Later calls return immediately as well.
+	void cancel()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mWaitMutex );
+			mCanceled = true;
+		}
+		mWaitCond.notify_all();
+	}
+
+	//! Returns the number of items the buffer can hold
+	size_t getCapacity() const { return mCapacity; }
+
+	//! Returns the number of items the buffer is currently holding. Only a snapshot when other threads are pushing or popping.
+	size_t getSize() const
+	{
+		const size_t dequeuePos = mDequeuePos.load( std::memory_order_acquire );
+		const size_t enqueuePos = mEnqueuePos.load( std::memory_order_acquire );
+		const std::ptrdiff_t size = (std::ptrdiff_t)enqueuePos - (std::ptrdiff_t)dequeuePos;
+		return size < 0 ? 0 : std::min( (size_t)size, mCapacity );
+	}
+
+  private:
+	struct Cell {
+		std::atomic<size_t>										mSequence;
+		typename std::aligned_storage<sizeof( T ), alignof( T )>::type	mStorage;
+	};
+
+	// Claims a slot and moves *item into it. Nothing can throw once the slot is claimed, so it is always published.
+	bool tryPushMoved( T *item )
+	{
+		size_t pos = mEnqueuePos.load( std::memory_order_relaxed );
+		Cell *cell;
+		while( true ) {
+			cell = &mCells[pos % mCapacity];
+			const size_t sequence = cell->mSequence.load( std::memory_order_acquire );
+			const std::ptrdiff_t diff = (std::ptrdiff_t)sequence - (std::ptrdiff_t)pos;
+			if( diff == 0 ) {
+				if( mEnqueuePos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed ) )
+					break;
+			}
+			else if( diff < 0 )
+				return false; // full
+			else
+				pos = mEnqueuePos.load( std::memory_order_relaxed );
+		}
+
+		new( &cell->mStorage ) T( std::move( *item ) );
+		cell->mSequence.store( pos + 1, std::memory_order_release );
+		notifyWaiting();
+		return true;
+	}
+
+	// number of failed attempts that yield before a blocking call goes to sleep
+	static const size_t NUM_SPINS = 64;
+
+	template <typename ReadyFn>
+	void wait( size_t attempt, const ReadyFn &ready )
+	{
+		if( attempt < NUM_SPINS ) {
+			std::this_thread::yield();
+			return;
+		}
+
+		// The waiter count is raised before checking the condition and the notifier publishes its change before reading the
+		// count, with a full fence on both sides, so that one of them always sees the other.
+		std::unique_lock<std::mutex> lock( mWaitMutex );
+		mNumWaiting.fetch_add( 1 );
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( ! ready() && ! mCanceled )
+			mWaitCond.wait( lock );
+		mNumWaiting.fetch_sub( 1 );
+	}
+
+	void notifyWaiting()
+	{
+		std::atomic_thread_fence( std::memory_order_seq_cst );
+		if( mNumWaiting.load( std::memory_order_relaxed ) ) {
+			std::lock_guard<std::mutex> lock( mWaitMutex );
+			mWaitCond.notify_all();
+		}
+	}
+
+	const size_t				mCapacity;
+	std::unique_ptr<Cell[]>		mCells;
+
+	// kept apart so that producers and consumers don't invalidate each other's cache line
+	char						mPad0[64];
+	std::atomic<size_t>			mEnqueuePos;
+	char						mPad1[64];
+	std::atomic<size_t>			mDequeuePos;
+	char						mPad2[64];
+
+	std::atomic<size_t>			mNumWaiting;
+	std::atomic<bool>			mCanceled;
+	std::mutex					mWaitMutex;
+	std::condition_variable		mWaitCond;
+};
+
+} // namespace cinder
@@ -0,0 +1,138 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/TriMesh.h"
+#include "cinder/Exception.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Noncopyable.h"
+
+#include <array>
+
+namespace cinder {
+
+typedef std::shared_ptr<class MappedTriMesh>	MappedTriMeshRef;
+
+//! Read-only triangle mesh backed by a memory-mapped file in the binary format written by MappedTriMeshWriter.
+//! Each attribute is stored as one contiguous, 64-byte aligned array, so the accessors return pointers directly into the mapping and loading a mesh doesn't copy or parse its contents.
+//! Pages are read by the operating system on first access. Copy into a TriMesh (which is a geom::Source) when the mesh needs to be modified.
+class CI_API MappedTriMesh : public geom::Source {
+  public:
+	//! Maps the file at \a path. Throws MappedTriMeshExc if the file can't be mapped or isn't a valid mesh.
+	static MappedTriMeshRef	create( const fs::path &path )				{ return MappedTriMeshRef( new MappedTriMesh( path ) ); }
+	//! Maps the file behind \a dataSource when it is a file path, otherwise references the DataSource's Buffer. Throws MappedTriMeshExc if the contents aren't a valid mesh.
+	static MappedTriMeshRef	create( const DataSourceRef &dataSource )	{ return MappedTriMeshRef( new MappedTriMesh( dataSource ) ); }
+
+	explicit MappedTriMesh( const fs::path &path );
+	explicit MappedTriMesh( const DataSourceRef &dataSource );
+
+	//! Returns the version of the file format the mesh was written with.
+	uint32_t	getVersion() const			{ return mVersion; }
+	//! Returns whether the mesh references a memory-mapped file, as opposed to a DataSource's Buffer.
+	bool		isMapped() const			{ return mIsMapped; }
+	//! Returns the total number of triangles contained by the mesh.
+	size_t		getNumTriangles() const		{ return mNumIndices / 3; }
+
+	//! Returns a pointer to the tightly packed values of \a attr, or \c nullptr if the mesh doesn't contain \a attr. \see getAttribDims()
+	const float*	getAttribData( geom::Attrib attr ) const;
+	//! Returns a pointer to the positions of the mesh as vec<DIM>*. For example, for a mesh with 3D vertices, call getPositions<3>().
+	template<uint8_t DIM>
+	const typename VECDIM<DIM,float>::TYPE*	getPositions() const { assert( getAttribDims( geom::POSITION ) == DIM ); return (const typename VECDIM<DIM,float>::TYPE*)getAttribData( geom::POSITION ); }
+	//! Returns a pointer to the normals of the mesh, or \c nullptr if it has none.
+	const vec3*		getNormals() const		{ return (const vec3*)getAttribData( geom::NORMAL ); }
+	//! Returns a pointer to the mesh's getNumIndices() indices, ordered like TriMesh::getIndices().
+	const uint32_t*	getIndices() const		{ return mIndices; }
+
+	// geom::Source virtuals
+	size_t				getNumVertices() const override		{ return mNumVertices; }
+	size_t				getNumIndices() const override		{ return mNumIndices; }
+	geom::Primitive		getPrimitive() const override		{ return geom::Primitive::TRIANGLES; }
+	uint8_t				getAttribDims( geom::Attrib attr ) const override;
+	geom::AttribSet		getAvailableAttribs() const override;
+	void				loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const override;
+	//! The clone shares the mapping with this MappedTriMesh.
+	MappedTriMesh*		clone() const override				{ return new MappedTriMesh( *this ); }
+
+  protected:
+	void	parse();
+
+	std::shared_ptr<const void>		mStorage; // keeps the mapping or Buffer alive
+	const uint8_t					*mData;
+	size_t							mDataSize;
+	bool							mIsMapped;
+
+	uint32_t						mVersion;
+	size_t							mNumVertices, mNumIndices;
+	const uint32_t					*mIndices;
+	std::array<const float*, geom::NUM_ATTRIBS>	mAttribData;
+	std::array<uint8_t, geom::NUM_ATTRIBS>		mAttribDims;
+};
+
+//! Writes a mesh in the binary format read by MappedTriMesh. The number of vertices and indices is declared up front, which
+//! allows every attribute to be appended in pieces and in any order, so the whole mesh never needs to be held in memory.
+class CI_API MappedTriMeshWriter : private Noncopyable {
+  public:
+	//! Creates the file at \a path for a mesh with the attributes enabled in \a format. Throws MappedTriMeshExc if the file can't be created.
+	MappedTriMeshWriter( const fs::path &path, const TriMesh::Format &format, size_t numVertices, size_t numIndices );
+	//! Closes the file, without checking whether the mesh is complete. \see finish()
+	~MappedTriMeshWriter();
+
+	//! Appends \a numVertices values of \a attr, which are tightly packed with the dimensions declared in the Format. Throws MappedTriMeshExc if more vertices are appended than were declared.
+	void	appendAttrib( geom::Attrib attr, const float *data, size_t numVertices );
+	//! Appends \a numIndices triangle indices. Throws MappedTriMeshExc if more indices are appended than were declared.
+	void	appendIndices( const uint32_t *indices, size_t numIndices );
+
+	//! Returns the number of vertices of \a attr appended so far.
+	size_t	getNumAttribVerticesAppended( geom::Attrib attr ) const;
+	//! Returns the number of indices appended so far.
+	size_t	getNumIndicesAppended() const	{ return mNumIndicesAppended; }
+
+	//! Flushes and closes the file. Throws MappedTriMeshExc if any attribute or the indices are incomplete, or if writing failed.
+	void	finish();
+
+	//! Streams \a source into the file at \a path, with the attributes described by TriMesh::formatFromSource(). The Source must produce triangles.
+	static void	write( const fs::path &path, const geom::Source &source );
+	//! Streams \a source into the file at \a path, with the attributes enabled in \a format. The Source must produce triangles.
+	static void	write( const fs::path &path, const geom::Source &source, const TriMesh::Format &format );
+
+  private:
+	void	writeAt( uint64_t offset, const void *data, size_t numBytes );
+
+	FILE						*mFile;
+	fs::path					mPath;
+	size_t						mNumVertices, mNumIndices, mNumIndicesAppended;
+	uint64_t					mIndicesOffset;
+	std::array<uint8_t, geom::NUM_ATTRIBS>		mAttribDims;
+	std::array<uint64_t, geom::NUM_ATTRIBS>		mAttribOffsets;
+	std::array<size_t, geom::NUM_ATTRIBS>		mAttribVerticesAppended;
+};
+
+class CI_API MappedTriMeshExc : public Exception {
+  public:
+	MappedTriMeshExc( const std::string &description )
+		: Exception( description )
+	{}
+};
+
+} // namespace cinder
@@ -0,0 +1,84 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Noncopyable.h"
+#include "cinder/Thread.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class ThreadPool>	ThreadPoolRef;
+
+//! A fixed-size pool of worker threads used by Cinder's data-parallel algorithms. Tasks are serviced in FIFO order.
+class CI_API ThreadPool : private Noncopyable {
+  public:
+	//! Creates a pool of \a numThreads worker threads. A value of \c 0 uses one thread less than std::thread::hardware_concurrency(), since the calling thread participates in parallelFor().
+	static ThreadPoolRef	create( size_t numThreads = 0 )	{ return ThreadPoolRef( new ThreadPool( numThreads ) ); }
+	//! Returns the process-wide pool shared by Cinder's parallel algorithms, which is created on first use.
+	static ThreadPool*		getDefault();
+
+	~ThreadPool();
+
+	//! Returns the number of worker threads owned by the pool.
+	size_t	getNumThreads() const	{ return mThreads.size(); }
+
+	//! Queues \a task for execution on a worker thread. Returns a future that can be used to retrieve the result or exception of \a task.
+	template<typename FnT>
+	std::future<typename std::result_of<FnT()>::type>	enqueue( FnT &&task );
+
+	//! Splits the range [\a begin, \a end) into contiguous chunks of at least \a minChunkSize items and calls \a fn( chunkBegin, chunkEnd ) for each of them in parallel. The calling thread processes chunks as well and the call returns once every chunk has completed. The first exception thrown by \a fn is rethrown. Safe to call from within a task running on the pool.
+	void	parallelFor( size_t begin, size_t end, const std::function<void( size_t, size_t )> &fn, size_t minChunkSize = 1 );
+
+  protected:
+	explicit ThreadPool( size_t numThreads );
+
+	void	pushTask( std::function<void()> &&task );
+	void	workerLoop();
+
+	std::vector<std::thread>			mThreads;
+	std::deque<std::function<void()>>	mTasks;
+	std::mutex							mMutex;
+	std::condition_variable				mTaskCond;
+	bool								mStopping;
+};
+
+template<typename FnT>
+std::future<typename std::result_of<FnT()>::type> ThreadPool::enqueue( FnT &&task )
+{
+	typedef typename std::result_of<FnT()>::type ResultT;
+
+	auto packagedTask = std::make_shared<std::packaged_task<ResultT()>>( std::forward<FnT>( task ) );
+	std::future<ResultT> result = packagedTask->get_future();
+	pushTask( [packagedTask] { (*packagedTask)(); } );
+
+	return result;
+}
+
+} // namespace cinder
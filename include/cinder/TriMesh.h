@@ -366,6 +366,8 @@ class CI_API TriMesh : public geom::Source {
 	std::vector<uint32_t>	mIndices;
 	
 	friend class TriMeshGeomTarget;
+	friend class MappedTriMesh;
+	friend class MappedTriMeshWriter;
 };
 
 } // namespace cinder
@@ -36,6 +36,7 @@
 namespace cinder { namespace audio {
 
 class DeviceManager;
+class GraphScheduler;
 
 //! \brief Manages the creation, connections, and lifecycle of audio::Node's.
 
@@ -81,9 +82,18 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	//! Returns whether or not this \a Context is current enabled and processing audio.
 	bool isEnabled() const		{ return mEnabled; }
 
-	//! Called by \a node when it's connections have changed. Default implementation is empty.
+	//! Called by \a node when it's connections have changed. Default implementation marks the graph for rescheduling if parallel processing is enabled.
 	virtual void connectionsDidChange( const NodeRef &node );
 
+	//! Enables processing independent branches of the graph in parallel on \a numThreads worker threads. A value of \c 0 uses one thread less than the number of hardware threads. Disabled by default. \see GraphScheduler
+	void	enableParallelProcessing( size_t numThreads = 0 );
+	//! Disables parallel processing, after which all Node's are pulled serially on the audio thread.
+	void	disableParallelProcessing();
+	//! Returns whether independent branches of the graph are processed in parallel. \see enableParallelProcessing()
+	bool	isParallelProcessingEnabled() const		{ return (bool)mGraphScheduler; }
+	//! Returns the GraphScheduler used for parallel processing, or \c nullptr if parallel processing is disabled.
+	GraphScheduler*	getGraphScheduler() const		{ return mGraphScheduler.get(); }
+
 	//! Returns the samplerate of this Context, which is governed by the current OutputNode.
 	size_t		getSampleRate()				{ return getOutput()->getOutputSampleRate(); }
 	//! Returns the number of frames processed in one block by this Node, which is governed by the current OutputNode.
@@ -163,7 +173,7 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 
 	static void registerClearStatics();
 
-	bool						mEnabled;
+	std::atomic<bool>			mEnabled;
 	std::atomic<uint64_t>		mNumProcessedFrames;
 	OutputNodeRef				mOutput;
 	std::list<ScheduledEvent>	mScheduledEvents;
@@ -179,6 +189,8 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	mutable std::mutex		mMutex;
 	std::thread::id			mAudioThreadId;
 
+	std::unique_ptr<GraphScheduler>	mGraphScheduler;
+
 	// - Context is stored in Node classes as a weak_ptr, so it needs to (for now) be created as a shared_ptr
 	static std::shared_ptr<Context>			sMasterContext;
 	static std::unique_ptr<DeviceManager>	sDeviceManager; // TODO: consider turning DeviceManager into a HardwareContext class
@@ -0,0 +1,112 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/audio/Context.h"
+#include "cinder/audio/OutputNode.h"
+#include "cinder/audio/Target.h"
+
+#include <functional>
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class OutputOfflineNode>	OutputOfflineNodeRef;
+typedef std::shared_ptr<class ContextOffline>		ContextOfflineRef;
+
+//! \brief OutputNode that is not backed by hardware, used by ContextOffline to pull the audio graph as fast as the CPU allows.
+//!
+//! You do not directly construct an OutputOfflineNode, it is created by ContextOffline::create(). If the number of channels hasn't
+//! been specified via Node::Format, defaults to 2. Clip detection is disabled by default, so that rendered files are never silenced.
+class CI_API OutputOfflineNode : public OutputNode {
+  public:
+	OutputOfflineNode( size_t sampleRate, size_t framesPerBlock, const Format &format = Format() );
+
+	//! Returns the samplerate specified at construction.
+	size_t getOutputSampleRate() override		{ return mSampleRate; }
+	//! Returns the frames per block specified at construction.
+	size_t getOutputFramesPerBlock() override	{ return mFramesPerBlock; }
+
+  protected:
+	bool supportsProcessInPlace() const override	{ return false; }
+
+  private:
+	//! Pulls one block through the graph and returns the result, which is valid until the next call.
+	const Buffer*	renderBlock();
+
+	size_t		mSampleRate, mFramesPerBlock;
+
+	friend class ContextOffline;
+};
+
+//! \brief Context that renders its audio graph on the calling thread, as fast as possible, instead of being driven by an audio device.
+//!
+//! Processing is identical to a hardware Context: each block calls preProcess() / postProcess(), so Param events and
+//! Node's enabled with Node::enable( double when ) happen at the same frames as they would in real-time. Time is measured
+//! against getNumProcessedSeconds(), which only advances while rendering.
+//! \code
+//! auto ctx = audio::ContextOffline::create( 48000 );
+//! auto gen = ctx->makeNode( new audio::GenSineNode( 440 ) );
+//! gen >> ctx->getOutput();
+//! gen->enable();
+//! ctx->render( 48000 * 10, audio::TargetFile::create( "sine.wav", 48000, 2 ).get() );
+//! \endcode
+class CI_API ContextOffline : public Context {
+  public:
+	//! Creates a ContextOffline whose OutputOfflineNode runs at \a sampleRate with \a framesPerBlock frames per block, formatted by \a outputFormat.
+	static ContextOfflineRef	create( size_t sampleRate = 44100, size_t framesPerBlock = 512, const Node::Format &outputFormat = Node::Format() );
+
+	//! Throws AudioContextExc, ContextOffline has no hardware output.
+	OutputDeviceNodeRef		createOutputDeviceNode( const DeviceRef &device = Device::getDefaultOutput(), const Node::Format &format = Node::Format() ) override;
+	//! Throws AudioContextExc, ContextOffline has no hardware input.
+	InputDeviceNodeRef		createInputDeviceNode( const DeviceRef &device = Device::getDefaultInput(), const Node::Format &format = Node::Format() ) override;
+
+	//! Renders the next \a numFrames frames into \a buffer, which is resized to \a numFrames and the number of output channels.
+	void	render( size_t numFrames, BufferDynamic *buffer );
+	//! Renders the next \a numFrames frames and writes them to \a target, which must have as many channels as the output.
+	void	render( size_t numFrames, TargetFile *target );
+	//! Renders the next \a numFrames frames, passing them to \a consumer in chunks of at most getFramesPerBlock() frames. \a consumer receives the buffer, the number of frames to read from it and the frame offset to start reading at.
+	void	render( size_t numFrames, const std::function<void ( const Buffer *, size_t, size_t )> &consumer );
+
+	//! Returns the number of blocks processed per second of wall-clock time during the last call to render().
+	double		getBlocksPerSecond() const		{ return mBlocksPerSecond; }
+	//! Returns how many times faster than real-time the last call to render() ran.
+	double		getRealtimeRatio() const		{ return mRealtimeRatio; }
+	//! Returns the total number of blocks processed by this Context.
+	uint64_t	getNumRenderedBlocks() const	{ return mNumRenderedBlocks; }
+
+  protected:
+	ContextOffline();
+
+  private:
+	OutputOfflineNode*	getOutputOffline();
+
+	// frames left over from the last block of the previous render(), which are delivered first by the next one
+	BufferDynamic	mPendingBuffer;
+	size_t			mPendingOffset, mPendingFrames;
+
+	double			mBlocksPerSecond, mRealtimeRatio;
+	uint64_t		mNumRenderedBlocks;
+};
+
+} } // namespace cinder::audio
@@ -0,0 +1,100 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/audio/Node.h"
+#include "cinder/audio/Source.h"
+#include "cinder/audio/dsp/Convolver.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class ConvolverNode>	ConvolverNodeRef;
+
+//! \brief Convolves its input with an impulse response, for example to apply a recorded reverb.
+//!
+//! Uses non-uniformly partitioned convolution with two stages of dsp::Convolver. The head of the impulse response is split
+//! into partitions of getHeadPartitionSize() frames and convolved on the audio thread, so the output isn't delayed. The
+//! remainder, the tail, is split into larger partitions of getTailPartitionSize() frames and convolved on a background
+//! thread, which has the duration of one tail partition to deliver each result. This keeps the work done on the audio thread
+//! small even for impulse responses several seconds long at small block sizes.
+//!
+//! A mono impulse response is applied to every channel, otherwise each channel uses the impulse response channel with the
+//! same index (or the last one, if there are fewer). Without an impulse response the output is silent.
+//! \note Requires the frames per block to be a multiple of 16.
+class CI_API ConvolverNode : public Node {
+  public:
+	//! Constructs a ConvolverNode without an impulse response, and with an optional \a format.
+	ConvolverNode( const Format &format = Format() );
+	//! Constructs a ConvolverNode that convolves with \a impulseResponse, and with an optional \a format.
+	ConvolverNode( const BufferRef &impulseResponse, const Format &format = Format() );
+	virtual ~ConvolverNode();
+
+	//! Sets the impulse response, which is assumed to be at the Context's samplerate.
+	void				setImpulseResponse( const BufferRef &impulseResponse );
+	//! Loads the impulse response from \a sourceFile, resampling it to the Context's samplerate if needed.
+	void				loadImpulseResponse( const SourceFileRef &sourceFile );
+	//! Returns the impulse response, or an empty BufferRef if none is set.
+	const BufferRef&	getImpulseResponse() const	{ return mImpulseResponse; }
+
+	//! Sets the partition size of the tail, which is rounded up to a power of two no smaller than the head partition size. A value of \c 0 convolves the whole impulse response on the audio thread. Default is 1024.
+	void	setTailPartitionSize( size_t frames );
+	//! Returns the requested partition size of the tail. \see getTailPartitionSize()
+	size_t	getTailPartitionSize() const	{ return mTailPartitionSize; }
+	//! Returns the partition size used on the audio thread, which is the largest power of two that divides the frames per block. Only valid while initialized.
+	size_t	getHeadPartitionSize() const	{ return mHeadPartitionSize; }
+	//! Returns whether the tail of the impulse response is being convolved on a background thread.
+	bool	isTailThreaded() const			{ return mTailThread.joinable(); }
+
+  protected:
+	void initialize()				override;
+	void uninitialize()				override;
+	void process( Buffer *buffer )	override;
+
+  private:
+	void	configureStages();
+	void	stopTailThread();
+	void	tailThreadLoop();
+	void	waitForTail();
+
+	BufferRef		mImpulseResponse;
+	size_t			mTailPartitionSize, mHeadPartitionSize, mTailFrames, mTailIndex;
+
+	std::vector<std::unique_ptr<dsp::Convolver>>	mHeads, mTails;
+
+	// The audio thread fills mTailInput and reads mTailOutput, while the background thread convolves mTailJobInput into
+	// mTailJobOutput. They're swapped at each tail partition boundary, once the previous job is complete.
+	Buffer					mTailInput, mTailOutput, mTailJobInput, mTailJobOutput;
+	std::thread				mTailThread;
+	std::atomic<uint64_t>	mNumJobsSubmitted, mNumJobsCompleted;
+	std::atomic<bool>		mStopping;
+	std::mutex				mWakeMutex;
+	std::condition_variable	mWakeCond;
+};
+
+} } // namespace cinder::audio
@@ -0,0 +1,104 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Noncopyable.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder { namespace audio {
+
+//! \brief Services the read-ahead of many streaming readers (e.g. asynchronous FilePlayerNodes) from one small pool of threads.
+//!
+//! Each reader registers a read function with addReader(). When its buffered audio runs low, requestRead() marks it pending
+//! along with a deadline, the time at which it will run out. Requests are lock-free and may be made from the audio thread.
+//! Whenever a worker thread is free it services the pending reader with the earliest deadline, so a player that is about to
+//! underrun is read before one that still has plenty buffered, no matter how many players there are.
+class CI_API FileReadScheduler : private Noncopyable {
+  public:
+	class Reader;
+	typedef std::shared_ptr<Reader>	ReaderRef;
+
+	//! Returns the FileReadScheduler that is shared by all FilePlayerNodes, which starts its threads on first use. It is never destroyed, so it remains usable during static destruction.
+	static FileReadScheduler*	get();
+
+	//! Starts \a numThreads worker threads. A value of \c 0 uses two threads, or one on single core machines.
+	FileReadScheduler( size_t numThreads = 0 );
+	~FileReadScheduler();
+
+	//! Registers \a readFn, which will be called from a worker thread after each requestRead(). A reader is never read by more than one thread at a time.
+	ReaderRef	addReader( const std::function<void()> &readFn );
+	//! Unregisters \a reader. If it is currently being read, blocks until the read completes. Must not be called from within a read function.
+	void		removeReader( const ReaderRef &reader );
+	//! Requests that \a reader be read before \a secondsUntilDeadline seconds have passed. Lock-free, suitable for the audio thread.
+	//! Because the request doesn't lock, a worker can rarely miss it; callers should repeat the request (e.g. every processing block) until the read has started.
+	void		requestRead( const ReaderRef &reader, double secondsUntilDeadline );
+
+	//! Stops the current worker threads and starts \a numThreads new ones (see the constructor). Pending requests are kept.
+	void		setNumThreads( size_t numThreads );
+	//! Returns the number of worker threads.
+	size_t		getNumThreads() const;
+	//! Returns the number of registered readers.
+	size_t		getNumReaders() const;
+	//! Returns the number of reads that have been serviced since the FileReadScheduler was created.
+	uint64_t	getNumReadsServiced() const		{ return mNumReadsServiced; }
+
+  private:
+	void	startThreads( size_t numThreads );
+	void	stopThreads();
+	void	workerLoop();
+
+	std::vector<ReaderRef>		mReaders;
+	std::vector<std::thread>	mThreads;
+	mutable std::mutex			mMutex;
+	std::condition_variable		mWakeCond, mReadCompleteCond;
+	bool						mStopping;
+	std::atomic<uint64_t>		mNumReadsServiced;
+};
+
+//! Handle returned by FileReadScheduler::addReader().
+class CI_API FileReadScheduler::Reader : private Noncopyable {
+  public:
+	Reader( const std::function<void()> &readFn ) : mReadFn( readFn ), mPending( false ), mDeadline( 0 ), mBusy( false ) {}
+
+	//! Returns whether a read has been requested and not yet started.
+	bool	isPending() const	{ return mPending; }
+
+  private:
+	std::function<void()>	mReadFn;
+	std::atomic<bool>		mPending;
+	std::atomic<int64_t>	mDeadline;	// steady clock nanoseconds
+	bool					mBusy;		// guarded by the FileReadScheduler's mutex
+
+	friend class FileReadScheduler;
+};
+
+} } // namespace cinder::audio
@@ -0,0 +1,113 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/audio/Buffer.h"
+#include "cinder/Noncopyable.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace cinder { namespace audio {
+
+class Context;
+typedef std::shared_ptr<class Node>		NodeRef;
+
+//! \brief Processes independent branches of a Context's audio graph in parallel.
+//!
+//! You do not construct a GraphScheduler directly, it is owned by a Context and enabled with Context::enableParallelProcessing().
+//! Whenever connections change, the graph is flattened into a topologically sorted list of tasks, one for each input of a
+//! Node with multiple inputs whose upstream sub-graph is only reachable through that input (a 'private branch'). At the
+//! beginning of each processing block these tasks are processed on a fixed pool of worker threads, with the audio thread
+//! participating, and afterwards the regular serial pull picks up their results. Summing still happens in the order of
+//! Node::getInputs(), so the output is identical to processing the same graph serially.
+//!
+//! Nodes that are shared between branches, nodes that support cycles (e.g. DelayNode) and everything downstream of them are
+//! processed serially. Nodes that only modulate a Param (see Param::setProcessor()) are not visible to the scheduler and must
+//! not be shared between branches.
+class CI_API GraphScheduler : private Noncopyable {
+  public:
+	//! Starts \a numThreads worker threads, which will process branches of \a context's graph. A value of \c 0 uses one thread less than std::thread::hardware_concurrency(), since the audio thread participates as well.
+	GraphScheduler( Context *context, size_t numThreads = 0 );
+	~GraphScheduler();
+
+	//! Returns the number of worker threads, not including the audio thread.
+	size_t	getNumThreads() const	{ return mThreads.size(); }
+	//! Returns the number of branches that are processed in parallel, as of the last processed block.
+	size_t	getNumTasks() const		{ return mNumTasks; }
+	//! Returns true if the calling thread is a worker thread of \a context's GraphScheduler. Doesn't access the GraphScheduler, so it is safe to call while parallel processing is being disabled.
+	static bool	isWorkerThread( const Context *context );
+
+	//! Causes the task list to be rebuilt at the beginning of the next block. Called by the Context when connections change.
+	void	markDirty()				{ mDirty = true; }
+
+	//! Processes all tasks for the current block. Called by the Context on the audio thread after Context::preProcess() has handled scheduled events.
+	void	processBlock( const NodeRef &output, const std::set<NodeRef> &autoPulledNodes );
+	//! Releases the results of the current block. Called by the Context on the audio thread from Context::postProcess().
+	void	finishBlock();
+
+  private:
+	struct Task {
+		NodeRef			mOwner;				// Node that sums this branch
+		NodeRef			mInput;				// root of the branch, connected to mOwner
+		BufferDynamic	mBuffer;			// in-place processing buffer for mInput
+		int				mParent;			// index of the task whose branch contains mOwner, or -1
+		size_t			mNumChildren;		// number of tasks whose parent is this task
+		std::atomic<size_t>	mPendingChildren;
+	};
+
+	void	rebuild( const NodeRef &output, const std::set<NodeRef> &autoPulledNodes );
+	void	countConsumers( Node *node, std::map<Node *, size_t> &consumers, std::set<Node *> &traversed );
+	bool	isPrivate( Node *node, const std::map<Node *, size_t> &consumers, std::map<Node *, int> &cache );
+	void	appendTasks( const NodeRef &node, bool insideBranch, const std::map<Node *, size_t> &consumers, std::map<Node *, int> &privateCache, std::set<Node *> &traversed );
+
+	void	workerLoop();
+	void	runTasks( uint32_t generation );
+	void	runTask( size_t index );
+
+	Context*							mContext;
+	std::vector<std::thread>			mThreads;
+	std::vector<std::unique_ptr<Task>>	mTasks;
+	size_t								mNumTasks, mFramesPerBlock;
+	std::atomic<bool>					mDirty;
+
+	// Claims are packed as generation (32 bits) | number of tasks (16 bits) | next task (16 bits), so that a worker
+	// waking up late can never claim a task from a different block.
+	std::atomic<uint64_t>				mClaim;
+	std::atomic<size_t>					mNumCompleted;
+	uint32_t							mGeneration;
+
+	std::mutex							mWakeMutex;
+	std::condition_variable				mWakeCond;
+	std::atomic<size_t>					mNumSleeping;
+	std::atomic<bool>					mStopping;
+};
+
+} } // namespace cinder::audio
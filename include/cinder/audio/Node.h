@@ -243,6 +243,8 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	std::pair<size_t, size_t>	mProcessFramesRange;
 
 	uint64_t				mLastProcessedFrame;
+	// set by GraphScheduler once this Node has been processed for the current block, until the end of the block
+	const Buffer*			mScheduledResult;
 	std::string				mName;
 	BufferDynamic			mInternalBuffer, mSummingBuffer;
 
@@ -250,6 +252,7 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	std::vector<std::weak_ptr<Node> >	mOutputs;
 
 	friend class Context;
+	friend class GraphScheduler;
 	friend class Param;
 };
 
@@ -25,11 +25,13 @@
 
 #include "cinder/Export.h"
 #include "cinder/audio/Buffer.h"
+#include "cinder/audio/dsp/RingBuffer.h"
 
-#include <list>
 #include <atomic>
 #include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 
 namespace cinder { namespace audio {
 
@@ -48,6 +50,14 @@ void CI_API rampInQuad( float *array, size_t count, double t, double tIncr, floa
 //! Array-based quadradic (t^2) ease-out ramping function.
 void CI_API rampOutQuad( float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd );
 
+//! Identifies the ramping function of an Event. The built-in types are evaluated without going through a RampFn.
+enum class RampType {
+	LINEAR,		//!< rampLinear()
+	IN_QUAD,	//!< rampInQuad()
+	OUT_QUAD,	//!< rampOutQuad()
+	CUSTOM		//!< a user supplied RampFn
+};
+
 //! Class representing a sample-accurate parameter control instruction. \see Param::applyRamp(), Param::appendRamp()
 class CI_API Event {
   public:
@@ -58,6 +68,8 @@ class CI_API Event {
 	float getValueBegin()		const	{ return mValueBegin; }
 	float getValueEnd()			const	{ return mValueEnd; }
 	const RampFn& getRampFn()	const	{ return mRampFn; }
+	//! Returns the type of ramping function, which is RampType::CUSTOM unless one of the built-in ramping functions is used.
+	RampType getRampType()		const	{ return mRampType; }
 	//! Returns whether the Param's current value will be copied when this Event begins or not.
 	bool getCopyValueOnBegin()  const	{ return mCopyValueOnBegin; }
 	//! Sets the value that will be used when this Event begins.
@@ -70,13 +82,15 @@ class CI_API Event {
 	const std::string&	getLabel() const	{ return mLabel; }
 
   private:
-	Event( double timeBegin, double timeEnd, float valueBegin, float valueEnd, bool copyValueOnBegin, const RampFn &rampFn );
+	Event( double timeBegin, double timeEnd, float valueBegin, float valueEnd, bool copyValueOnBegin, RampType rampType, const RampFn &rampFn );
 
-	double				mTimeBegin, mTimeEnd, mTimeCancel, mDuration;
+	double				mTimeBegin, mTimeEnd, mDuration;
+	std::atomic<double>	mTimeCancel; // set by the user thread when a later Event is applied, read on the audio thread
 	float				mValueBegin, mValueEnd;
 	std::atomic<bool>	mIsComplete, mIsCanceled;
 	bool				mCopyValueOnBegin;
 	std::string			mLabel;
+	RampType			mRampType;
 	RampFn				mRampFn;
 
 	friend class Param;
@@ -91,6 +105,9 @@ class CI_API Event {
 //! A Param is owned by a parent Node, from which it gains access to the current Context.  This is a necessary step in making it sample
 //! accurate yet still controllable in a thread-safe manager on the user thread.
 //!
+//! Events are handed to the audio thread through a preallocated lock-free queue, so scheduling ramps never contends with the
+//! audio thread and the audio thread never locks, allocates or frees memory on their behalf. The queue grows on the user thread if needed.
+//!
 //! \note Ramp Events should not overlap, or you may get discontinuities in the evaluated curve. This could potentially happen when
 //! using multiple appendRamp() calls. Instead, use applyRamp() and set Options::beginTime() accordingly, which will remove any
 //! Events that would otherwise be overlapping.
@@ -99,14 +116,16 @@ class CI_API Param {
 
 	//! Optional parameters when applying or appending ramps. \see applyRamp() \see appendRamp()
 	struct Options {
-		Options() : mDelay( 0 ), mBeginTime( -1 ), mRampFn( rampLinear ) {}
+		Options() : mDelay( 0 ), mBeginTime( -1 ), mRampType( RampType::LINEAR ), mRampFn( rampLinear ) {}
 
 		//! Specifies a delay of \a delay in seconds.
 		Options& delay( double delay )				{ mDelay = delay; return *this; }
 		//! Specifies the begin time in seconds. If this is value is greater or equal to zero, delay() is ignored.
 		Options& beginTime( double time )			{ mBeginTime = time; return *this; }
-		//! Specifies the ramping function used during evaluation.
-		Options& rampFn( const RampFn &rampFn )		{ mRampFn = rampFn; return *this; }
+		//! Specifies the ramping function used during evaluation. Passing one of the built-in ramping functions is equivalent to calling rampType().
+		Options& rampFn( const RampFn &rampFn );
+		//! Specifies one of the built-in ramping functions used during evaluation.
+		Options& rampType( RampType type );
 		//! Sets a label that will be assigned to the Event. Useful when debugging.
 		Options& label( const std::string &label )	{ mLabel = label; return *this; }
 
@@ -116,12 +135,15 @@ class CI_API Param {
 		double				getBeginTime() const	{ return mBeginTime; }
 		//! Returns the ramping function that will be used during evaluation.
 		const RampFn&		getRampFn() const		{ return mRampFn; }
+		//! Returns the type of ramping function that will be used during evaluation.
+		RampType			getRampType() const		{ return mRampType; }
 		//! Returns a label that will be assigned to the Event. Useful when debugging.
 		const std::string&	getLabel() const		{ return mLabel; }
 
 	  private:
-		double	mDelay, mBeginTime;
-		RampFn	mRampFn;
+		double		mDelay, mBeginTime;
+		RampType	mRampType;
+		RampFn		mRampFn;
 		std::string	mLabel;
 	};
 
@@ -179,7 +201,25 @@ class CI_API Param {
 	void		removeEventsAt( double time );
 	ContextRef	getContext() const;
 
-	std::list<EventRef>	mEvents;
+	// Event queue methods. scheduleEvent() locks mScheduleMutex, which the others, resetImpl() and removeEventsAt() expect to be held.
+	// Those suffixed with Impl also require the Context mutex.
+	EventRef	scheduleEvent( bool append, bool copyValueOnBegin, float valueBegin, float valueEnd, double rampSeconds, const Options &options );
+	void		collectRetiredEvents() const;
+	void		collectEventsImpl();
+	void		growEventQueuesImpl( size_t maxEvents );
+	// audio thread methods
+	void		readQueuedEvents();
+	void		retireEvent( size_t index );
+
+	// User thread side: keeps every scheduled Event alive until the audio thread has retired it.
+	mutable std::vector<EventRef>				mEvents;
+	mutable std::mutex							mScheduleMutex;
+	size_t										mMaxEvents;
+	// Audio thread side: Events currently being evaluated, reserved to the queue size so it never allocates.
+	std::vector<Event *>						mActiveEvents;
+	dsp::RingBufferT<Event *>					mQueuedEvents;
+	mutable dsp::RingBufferT<Event *>			mRetiredEvents;
+
 	std::atomic<float>	mValue;
 	bool				mIsVaryingThisBlock;
 	Node*				mParentNode;
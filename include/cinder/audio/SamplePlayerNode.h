@@ -24,12 +24,11 @@
 #pragma once
 
 #include "cinder/audio/InputNode.h"
+#include "cinder/audio/FileReadScheduler.h"
 #include "cinder/audio/Source.h"
 #include "cinder/audio/dsp/RingBuffer.h"
 
-#include <thread>
 #include <mutex>
-#include <condition_variable>
 
 namespace cinder { namespace audio {
 
@@ -125,7 +124,10 @@ class CI_API BufferPlayerNode : public SamplePlayerNode {
 	BufferRef mBuffer;
 };
 
-//! File-based SamplePlayerNode, where samples are constantly streamed from file. Suitable for large audio files.
+//! \brief File-based SamplePlayerNode, where samples are constantly streamed from file. Suitable for large audio files.
+//!
+//! Asynchronous reads are serviced by the FileReadScheduler shared between all FilePlayerNodes, rather than by a thread per
+//! player, and samples are decoded directly into the ringbuffer that the audio thread reads from.
 class CI_API FilePlayerNode : public SamplePlayerNode {
   public:
 	//! Constructs a FilePlayerNode with optional \a format.
@@ -137,7 +139,7 @@ class CI_API FilePlayerNode : public SamplePlayerNode {
 	void stop() override;
 	void seek( size_t readPositionFrames ) override;
 
-	//! Returns whether reading occurs asynchronously (default is false). If true, file reading is done from an internal thread, if false it is done directly on the audio thread.
+	//! Returns whether reading occurs asynchronously (default is false). If true, file reading is done by FileReadScheduler::get(), if false it is done directly on the audio thread.
 	bool isReadAsync() const	{ return mIsReadAsync; }
 
 	//! \note \a sourceFile's samplerate is forced to match this Node's Context. Resets the loop points to 0:getNumFrames()).
@@ -160,19 +162,18 @@ class CI_API FilePlayerNode : public SamplePlayerNode {
 	void readImpl();
 	void seekImpl( size_t readPos );
 	void stopImpl();
-	void destroyReadThreadImpl();
+	void removeReaderImpl();
 
-	std::vector<dsp::RingBuffer>				mRingBuffers;	// used to transfer samples from io to audio thread, one ring buffer per channel
-	BufferDynamic								mIoBuffer;		// used to read samples from the file on read thread, resizeable so the ringbuffer can be filled
+	dsp::MultiChannelRingBuffer					mRingBuffer;	// used to transfer samples from io to audio thread, the SourceFile decodes directly into it
 
 	SourceFileRef								mSourceFile;
 	size_t										mBufferFramesThreshold, mRingBufferPaddingFactor;
 	std::atomic<uint64_t>						mLastUnderrun, mLastOverrun;
 
-	std::unique_ptr<std::thread>				mReadThread;
+	FileReadScheduler::ReaderRef				mReader;
 	std::mutex									mAsyncReadMutex;
-	std::condition_variable						mIssueAsyncReadCond;
-	bool										mIsReadAsync, mAsyncReadShouldQuit;
+	size_t										mLastAsyncReadPos;
+	bool										mIsReadAsync;
 };
 
 } } // namespace cinder::audio
@@ -86,6 +86,8 @@ class CI_API SourceFile : public Source {
 	virtual ~SourceFile()	{}
 
 	size_t	read( Buffer *buffer ) override;
+	//! Reads up to \a numFrames frames into \a buffer, starting at frame \a bufferFrameOffset, so that a caller can decode directly into part of a larger buffer. \return number of frames read into \a buffer.
+	size_t	read( Buffer *buffer, size_t bufferFrameOffset, size_t numFrames );
 
 	//! Returns a copy of this Source, with identical properties and pointing at the same data source.
 	SourceFileRef clone() const		{ return cloneWithSampleRate( getSampleRate() ); }
@@ -118,7 +120,8 @@ class CI_API SourceFile : public Source {
 	//! Sets up samplerate conversion if needed. Can be overridden by implementation if they handle samplerate conversion in a specific way, else it is handled generically with a dsp::Converter.
 	virtual void setupSampleRateConversion();
 
-	size_t mNumFrames, mFileNumFrames, mReadPos;
+	size_t			mNumFrames, mFileNumFrames, mReadPos;
+	BufferDynamic	mConverterOutputBuffer;
 };
 
 //! Convenience method for loading a SourceFile from \a dataSource. \return SourceFileRef. \see SourceFile::create()
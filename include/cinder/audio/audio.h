@@ -26,6 +26,8 @@
 // general
 #include "cinder/audio/Buffer.h"
 #include "cinder/audio/Context.h"
+#include "cinder/audio/ContextOffline.h"
+#include "cinder/audio/GraphScheduler.h"
 #include "cinder/audio/Device.h"
 #include "cinder/audio/Exception.h"
 #include "cinder/audio/Param.h"
@@ -50,6 +52,8 @@
 // audio::dsp
 #include "cinder/audio/dsp/Dsp.h"
 #include "cinder/audio/dsp/Biquad.h"
+#include "cinder/audio/dsp/BiquadCascade.h"
+#include "cinder/audio/dsp/Convolver.h"
 #include "cinder/audio/dsp/Converter.h"
 #include "cinder/audio/dsp/Fft.h"
 #include "cinder/audio/dsp/RingBuffer.h"
@@ -0,0 +1,87 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/audio/dsp/Biquad.h"
+
+#include <vector>
+
+namespace cinder { namespace audio { namespace dsp {
+
+//! \brief Processes a cascade of biquad sections on many channels at once.
+//!
+//! Each channel runs its own chain of \a numSections biquads, in transposed direct form II. Channels are packed into the
+//! lanes of SIMD registers (groups of 8 channels in single precision, 4 in double precision), so the cost of filtering
+//! 16 channels is close to that of filtering 2 to 4 with dsp::Biquad. The instruction set follows dsp::getSimdBackend().
+//! Sections within a channel are evaluated one after the other, as each depends on the output of the previous one.
+class CI_API BiquadCascade {
+  public:
+	//! The type used for the coefficients and filter state.
+	enum class Precision {
+		FLOAT,		//!< faster, suitable for most EQ and tone shaping
+		DOUBLE		//!< more stable with low cutoff frequencies or high Q
+	};
+
+	//! Constructs a cascade of \a numSections pass-through sections for each of \a numChannels channels.
+	BiquadCascade( size_t numChannels = 1, size_t numSections = 1, Precision precision = Precision::DOUBLE );
+
+	//! Returns the number of channels processed.
+	size_t		getNumChannels() const	{ return mNumChannels; }
+	//! Returns the number of sections per channel.
+	size_t		getNumSections() const	{ return mNumSections; }
+	//! Returns the type used for the coefficients and filter state.
+	Precision	getPrecision() const	{ return mPrecision; }
+
+	//! Sets the coefficients of \a section on \a channel. The filter is defined as y[n] + a1 * y[n-1] + a2 * y[n-2] = b0 * x[n] + b1 * x[n-1] + b2 * x[n-2].
+	void setCoefficients( size_t channel, size_t section, double b0, double b1, double b2, double a1, double a2 );
+	//! Copies the coefficients of \a biquad to \a section on \a channel, which can be configured with any of the Biquad::set*Params() methods.
+	void setSection( size_t channel, size_t section, const Biquad &biquad );
+	//! Copies the coefficients of \a biquad to \a section on every channel.
+	void setSection( size_t section, const Biquad &biquad );
+
+	//! Processes \a buffer in place. \a buffer must have getNumChannels() channels.
+	void process( Buffer *buffer );
+	//! Processes \a source, leaving the result in \a dest. Both must have getNumChannels() channels and the same number of frames, \a source and \a dest can be the same.
+	void process( const Buffer &source, Buffer *dest );
+	//! Processes \a framesToProcess frames of non-interleaved \a source, where channels are \a channelStride samples apart, leaving the result in \a dest with the same layout.
+	void process( const float *source, float *dest, size_t framesToProcess, size_t channelStride );
+	//! Resets the filter state of all sections.
+	void reset();
+
+  private:
+	template <typename T>
+	void processImpl( const float *source, float *dest, size_t framesToProcess, size_t channelStride, std::vector<T> &coefficients, std::vector<T> &state, std::vector<T> &scratch );
+	template <typename T>
+	void storeCoefficients( std::vector<T> &coefficients, size_t channel, size_t section, const double *values );
+
+	size_t		mNumChannels, mNumSections, mNumLanes;
+	Precision	mPrecision;
+
+	// Coefficients and state are stored per group of mNumLanes channels, as [group][section][coefficient][lane] and
+	// [group][section][state][lane]. The scratch buffer holds a block of frames for one group, transposed to [frame][lane].
+	std::vector<float>	mCoefficientsf, mStatef, mScratchf;
+	std::vector<double>	mCoefficientsd, mStated, mScratchd;
+};
+
+} } } // namespace cinder::audio::dsp
@@ -0,0 +1,62 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/audio/dsp/Fft.h"
+
+#include <memory>
+#include <vector>
+
+namespace cinder { namespace audio { namespace dsp {
+
+//! \brief Convolves a signal with an impulse response using uniformly partitioned overlap-save.
+//!
+//! The impulse response is split into partitions of getPartitionSize() frames, whose spectra are computed once. Each call
+//! to process() transforms one partition of input, multiplies it with every impulse response partition against the
+//! matching past input spectrum (a frequency-domain delay line) and transforms the sum back. The output is not delayed:
+//! the frames returned by process() include the contribution of the frames passed to that same call.
+class CI_API Convolver {
+  public:
+	//! Constructs a Convolver for the first \a impulseResponseLength frames of \a impulseResponse. \a partitionSize must be a power of two.
+	Convolver( const float *impulseResponse, size_t impulseResponseLength, size_t partitionSize );
+
+	//! Convolves getPartitionSize() frames of \a input, writing getPartitionSize() frames to \a output. \a input and \a output can be the same.
+	void process( const float *input, float *output );
+	//! Clears the input history, as if only silence had been processed.
+	void reset();
+
+	//! Returns the number of frames consumed and produced by each call to process().
+	size_t getPartitionSize() const		{ return mPartitionSize; }
+	//! Returns the number of partitions the impulse response was split into.
+	size_t getNumPartitions() const		{ return mImpulseResponseSpectra.size(); }
+
+  private:
+	size_t						mPartitionSize, mDelayLineIndex;
+	std::unique_ptr<Fft>		mFft;
+	std::vector<BufferSpectral>	mImpulseResponseSpectra, mDelayLine;
+	Buffer						mTimeDomain, mInverse;
+	BufferSpectral				mSum;
+};
+
+} } } // namespace cinder::audio::dsp
@@ -56,7 +56,25 @@ enum class WindowType {
 //! fills \a window array with a windowing function specified by \a windowType
 CI_API void generateWindow( WindowType windowType, float *window, size_t length );
 
-// Vector based math routines.
+//! Describes the instruction sets that can be used by the vector math routines. \see setSimdBackend()
+enum class SimdBackend {
+	SCALAR,		//!< plain C++ loops
+	SSE2,
+	AVX2,
+	NEON,
+	VDSP		//!< Apple's Accelerate framework, the only back-end available on Cocoa platforms
+};
+
+//! Returns the back-end used by the vector math routines, which is selected at runtime as the fastest one supported by the CPU.
+CI_API SimdBackend getSimdBackend();
+//! Returns whether \a backend was compiled in and is supported by the CPU.
+CI_API bool isSimdBackendSupported( SimdBackend backend );
+//! Overrides the back-end used by the vector math routines, mostly useful for testing and benchmarking. Returns false and leaves the back-end unchanged if \a backend isn't supported. \note Not synchronized with the audio thread.
+CI_API bool setSimdBackend( SimdBackend backend );
+//! Returns a human readable name for \a backend.
+CI_API const char* getSimdBackendName( SimdBackend backend );
+
+// Vector based math routines. Element-wise results are identical on all back-ends, while sum() and rms() may differ in the last bits because vectorized back-ends accumulate in a different order.
 
 //! fills \a array with value \a value
 CI_API void fill( float value, float *array, size_t length );
@@ -82,8 +100,8 @@ CI_API void addMul( const float *arrayA, const float *arrayB, float scalar, floa
 CI_API float sum( const float *array, size_t length );
 //! returns the Root-Mean-Squared value of \a array
 CI_API float rms( const float *array, size_t length );
-//! normalizes \a array to \a maxValue (default = 1)
-CI_API void normalize( float *array, size_t length, float maxValue = 1 );
+//! normalizes \a array to \a normalizedMax (default = 1)
+CI_API void normalize( float *array, size_t length, float normalizedMax = 1 );
 //! returns the spectral centroid of the frequency magnitude spectrum in \a magArray, computed the provided \a sampleRate. \a magArrayLength is expected to be half of the FFT size used to compute the magnitude spectrum.
 CI_API float spectralCentroid( const float *magArray, size_t magArrayLength, size_t sampleRate );
 
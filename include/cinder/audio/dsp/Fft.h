@@ -28,6 +28,7 @@
 
 #include "cinder/Cinder.h"
 
+#include <memory>
 #include <vector>
 
 #if defined( CINDER_AUDIO_VDSP )
@@ -39,6 +40,9 @@
 namespace cinder { namespace audio { namespace dsp {
 
 //! Real Discrete Fourier Transform (DFT).
+//!
+//! The twiddle and bit reversal tables of each size are computed once and shared by every Fft of that size, so
+//! constructing many Fft objects (one per channel, for example) is cheap.
 class CI_API Fft {
   public:
 	//! Constructs an Fft object. \a fftSize must be a power of two and greater than two.
@@ -49,23 +53,41 @@ class CI_API Fft {
 	void forward( const Buffer *waveform, BufferSpectral *spectral );
 	//! Computes the Inverse DFT of \a spectral, filling \a waveform with time-domain audio data
 	void inverse( const BufferSpectral *spectral, Buffer *waveform );
+
+	//! Computes the Forward DFT of \a count waveforms of getSize() samples each, filling \a spectra[0 ... count). The results are the same as calling forward() on each, but several waveforms are transformed at once in SIMD lanes.
+	void forwardBatch( const float * const *waveforms, BufferSpectral *spectra, size_t count );
+	//! Computes the Forward DFT of each channel of \a waveforms, filling \a spectra[0 ... waveforms.getNumChannels()).
+	void forwardBatch( const Buffer &waveforms, BufferSpectral *spectra );
+	//! Computes the Inverse DFT of \a spectra[0 ... count), filling \a count waveforms of getSize() samples each.
+	void inverseBatch( const BufferSpectral *spectra, float * const *waveforms, size_t count );
+	//! Computes the Inverse DFT of \a spectra[0 ... waveforms->getNumChannels()), filling each channel of \a waveforms.
+	void inverseBatch( const BufferSpectral *spectra, Buffer *waveforms );
+
 	//! Returns the size of the FFT.
 	size_t getSize() const	{ return mSize; }
 
+	//! Returns the number of sizes that currently have tables in the plan cache.
+	static size_t	getNumCachedPlans();
+	//! Frees the cached tables of every size that is no longer used by an Fft object.
+	static void		clearPlanCache();
+
   protected:
+	struct Plan;
+
 	void init();
 
-	size_t				mSize, mSizeOverTwo;
+	static std::shared_ptr<const Plan>	getPlan( size_t fftSize );
+
+	size_t						mSize, mSizeOverTwo;
+	std::shared_ptr<const Plan>	mPlan;
 
 #if defined( CINDER_AUDIO_VDSP )
-	size_t				mLog2FftSize;
-	::FFTSetup			mFftSetup;
 	::DSPSplitComplex	mSplitComplexSignal, mSplitComplexResult;
 #elif defined( CINDER_AUDIO_FFT_OOURA )
 	Buffer				mBufferCopy;
-	int					*mOouraIp;
-	float				*mOouraW;
+	std::vector<float>	mBatchReal, mBatchImag;
 #endif
+	std::vector<float *>		mBatchWaveforms;
 };
 
 } } } // namespace cinder::audio::dsp
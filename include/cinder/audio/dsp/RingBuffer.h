@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "cinder/audio/Buffer.h"
 #include "cinder/CinderAssert.h"
 
 #include <atomic>
@@ -186,6 +187,157 @@ class RingBufferT {
 	std::atomic<size_t>		mWriteIndex, mReadIndex;
 };
 
-typedef RingBufferT<float> RingBuffer;
+//! \brief Multichannel ringbuffer that stores each channel contiguously in a BufferT, with the same single write thread / single read thread guarantees as RingBufferT.
+//!
+//! Besides copying in with write(), the write thread can fill the free space in place: getWriteRegion() returns where in getBuffer()
+//! the next frames belong and how many fit before the end of the buffer, and commitWrite() makes them available to the read thread.
+//! This lets a producer such as SourceFile::read() decode directly into the ringbuffer.
+template <typename T>
+class MultiChannelRingBufferT {
+  public:
+	//! Constructs a MultiChannelRingBufferT with size = 0
+	MultiChannelRingBufferT() : mWriteIndex( 0 ), mReadIndex( 0 ) {}
+	//! Constructs a MultiChannelRingBufferT with \a numFrames maximum frames of \a numChannels channels.
+	MultiChannelRingBufferT( size_t numFrames, size_t numChannels )
+	{
+		resize( numFrames, numChannels );
+	}
+
+	//! Resizes the container to contain \a numFrames maximum frames of \a numChannels channels. Resets read / write indices to 0. \note Must be synchronized with both read and write threads.
+	void resize( size_t numFrames, size_t numChannels )
+	{
+		// one frame is used to distinguish between the read and write indices when full.
+		mBuffer = BufferT<T>( numFrames + 1, numChannels );
+		clear();
+	}
+	//! Invalidates the internal buffer and resets read / write indices to 0. \note Must be synchronized with both read and write threads.
+	void clear()
+	{
+		mWriteIndex = 0;
+		mReadIndex = 0;
+	}
+	//! Returns the maximum number of frames.
+	size_t getSize() const			{ return mBuffer.getNumFrames() ? mBuffer.getNumFrames() - 1 : 0; }
+	//! Returns the number of channels.
+	size_t getNumChannels() const	{ return mBuffer.getNumChannels(); }
+
+	//! Returns the number of frames available for writing. \note Only safe to call from the write thread.
+	size_t getAvailableWrite() const
+	{
+		return getAvailableWrite( mWriteIndex.load( std::memory_order_relaxed ), mReadIndex.load( std::memory_order_acquire ) );
+	}
+	//! Returns the number of frames available for reading. \note Only safe to call from the read thread.
+	size_t getAvailableRead() const
+	{
+		return getAvailableRead( mWriteIndex.load( std::memory_order_acquire ), mReadIndex.load( std::memory_order_relaxed ) );
+	}
+
+	//! Returns the internal buffer, which getWriteRegion() indexes into.
+	BufferT<T>*	getBuffer()		{ return &mBuffer; }
+	//! Returns the frame of getBuffer() where the next write begins and sets \a numFrames to the number of frames that can be written there contiguously. \note Only safe to call from the write thread.
+	size_t getWriteRegion( size_t *numFrames ) const
+	{
+		const size_t writeIndex = mWriteIndex.load( std::memory_order_relaxed );
+		const size_t available = getAvailableWrite( writeIndex, mReadIndex.load( std::memory_order_acquire ) );
+
+		*numFrames = std::min( available, mBuffer.getNumFrames() - writeIndex );
+		return writeIndex;
+	}
+	//! Makes \a numFrames frames written to the region returned by getWriteRegion() available for reading. \note Only safe to call from the write thread.
+	void commitWrite( size_t numFrames )
+	{
+		size_t writeIndexAfter = mWriteIndex.load( std::memory_order_relaxed ) + numFrames;
+		CI_ASSERT( writeIndexAfter <= mBuffer.getNumFrames() );
+
+		if( writeIndexAfter == mBuffer.getNumFrames() )
+			writeIndexAfter = 0;
+
+		mWriteIndex.store( writeIndexAfter, std::memory_order_release );
+	}
+
+	//! \brief Writes the first \a numFrames frames of each channel in \a buffer. \return `true` if all frames were successfully written, or `false` otherwise.
+	//!
+	//! \note only safe to call from the write thread.
+	bool write( const BufferT<T> &buffer, size_t numFrames )
+	{
+		CI_ASSERT( buffer.getNumChannels() == getNumChannels() && numFrames <= buffer.getNumFrames() );
+
+		if( numFrames > getAvailableWrite() )
+			return false;
+
+		size_t numWritten = 0;
+		while( numWritten < numFrames ) {
+			size_t regionFrames;
+			const size_t writeIndex = getWriteRegion( &regionFrames );
+			const size_t count = std::min( regionFrames, numFrames - numWritten );
+
+			for( size_t ch = 0; ch < getNumChannels(); ch++ )
+				std::memcpy( mBuffer.getChannel( ch ) + writeIndex, buffer.getChannel( ch ) + numWritten, count * sizeof( T ) );
+
+			commitWrite( count );
+			numWritten += count;
+		}
+
+		return true;
+	}
+	//! \brief Reads \a numFrames frames into the beginning of each channel in \a buffer.  \return `true` if all frames were successfully read, or `false` otherwise.
+	//!
+	//! \note only safe to call from the read thread.
+	bool read( BufferT<T> *buffer, size_t numFrames )
+	{
+		CI_ASSERT( buffer->getNumChannels() == getNumChannels() && numFrames <= buffer->getNumFrames() );
+
+		const size_t writeIndex = mWriteIndex.load( std::memory_order_acquire );
+		const size_t readIndex = mReadIndex.load( std::memory_order_relaxed );
+
+		if( numFrames > getAvailableRead( writeIndex, readIndex ) )
+			return false;
+
+		const size_t allocatedFrames = mBuffer.getNumFrames();
+		const size_t countA = std::min( numFrames, allocatedFrames - readIndex );
+		const size_t countB = numFrames - countA;
+
+		for( size_t ch = 0; ch < getNumChannels(); ch++ ) {
+			const T *channel = mBuffer.getChannel( ch );
+			std::memcpy( buffer->getChannel( ch ), channel + readIndex, countA * sizeof( T ) );
+			if( countB )
+				std::memcpy( buffer->getChannel( ch ) + countA, channel, countB * sizeof( T ) );
+		}
+
+		size_t readIndexAfter = readIndex + numFrames;
+		if( readIndexAfter >= allocatedFrames )
+			readIndexAfter -= allocatedFrames;
+
+		mReadIndex.store( readIndexAfter, std::memory_order_release );
+		return true;
+	}
+
+  private:
+	size_t getAvailableWrite( size_t writeIndex, size_t readIndex ) const
+	{
+		if( ! mBuffer.getNumFrames() )
+			return 0;
+
+		size_t result = readIndex - writeIndex - 1;
+		if( writeIndex >= readIndex )
+			result += mBuffer.getNumFrames();
+
+		return result;
+	}
+
+	size_t getAvailableRead( size_t writeIndex, size_t readIndex ) const
+	{
+		if( writeIndex >= readIndex )
+			return writeIndex - readIndex;
+
+		return writeIndex + mBuffer.getNumFrames() - readIndex;
+	}
+
+	BufferT<T>				mBuffer;
+	std::atomic<size_t>		mWriteIndex, mReadIndex;
+};
+
+typedef RingBufferT<float>				RingBuffer;
+typedef MultiChannelRingBufferT<float>	MultiChannelRingBuffer;
 
 } } } // namespace cinder::audio::dsp
@@ -0,0 +1,117 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/platform.h"
+#include "cinder/Color.h"
+#include "cinder/Rect.h"
+#include "cinder/Noncopyable.h"
+
+#include <vector>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class Batch2d>		Batch2dRef;
+typedef std::shared_ptr<class Vao>			VaoRef;
+typedef std::shared_ptr<class StreamVbo>	StreamVboRef;
+typedef std::shared_ptr<class TextureBase>	TextureBaseRef;
+typedef std::shared_ptr<class Texture2d>	Texture2dRef;
+class GlslProg;
+class Context;
+
+//! Records the 2D convenience functions drawSolidRect(), drawSolidCircle(), drawLine( vec2, vec2 ) and draw( TextureRef, Area, Rectf ) while a ScopedBatch2d is active.
+//! Vertices are transformed by the model matrix on the CPU and appended to a single stream, and consecutive calls that share a GlslProg, texture,
+//! blend state, view and projection matrices, viewport and framebuffer are drawn with one glDrawArrays() when the state changes or the batch is flushed.
+//! Calls whose GlslProg needs attributes other than positions, texture coordinates and colors are drawn immediately. State that isn't recorded, such as
+//! depth testing, culling, scissoring or custom uniforms, should not change between batched calls without calling flush() first. Any other draw through the
+//! Context flushes the batch before it, though calls that bypass it, like gl::clear() or raw OpenGL, require an explicit flush().
+class CI_API Batch2d : private Noncopyable {
+  public:
+	static Batch2dRef	create();
+
+	//! Records drawSolidRect(). Returns \c false if the call has to be drawn immediately.
+	bool	addSolidRect( const Rectf &r, const vec2 &upperLeftTexCoord, const vec2 &lowerRightTexCoord );
+	//! Records drawSolidCircle(). Returns \c false if the call has to be drawn immediately.
+	bool	addSolidCircle( const vec2 &center, float radius, int numSegments );
+	//! Records drawLine( vec2, vec2 ). Returns \c false if the call has to be drawn immediately.
+	bool	addLine( const vec2 &a, const vec2 &b );
+	//! Records draw( TextureRef, Area, Rectf ), with \a texRect in texture coordinates. Returns \c false if the call has to be drawn immediately.
+	bool	addTexture( const Texture2dRef &texture, const Rectf &texRect, const Rectf &dstRect );
+
+	//! Draws the recorded vertices, restoring the state they were recorded with.
+	void	flush();
+	//! Returns the number of vertices waiting for flush().
+	size_t	getNumPendingVertices() const { return mVertices.size(); }
+
+	//! The number of vertices beyond which the batch is flushed, which keeps each flush well within its StreamVbo.
+	static const size_t	MAX_VERTICES = 32768;
+
+  protected:
+	Batch2d();
+
+	struct Vertex {
+		vec4		mPosition;
+		vec2		mTexCoord;
+		vec4		mColor;
+	};
+
+	struct State {
+		bool operator==( const State &rhs ) const;
+		bool operator!=( const State &rhs ) const { return ! ( *this == rhs ); }
+
+		//! Keeps the GlslProg alive until the batch is flushed, as it may be released while its draws are pending
+		std::shared_ptr<const GlslProg>	mGlslProg;
+		GLenum					mPrimitive;
+		GLenum					mTextureTarget;
+		GLuint					mTextureId;
+		GLboolean				mBlend;
+		GLenum					mBlendSrcRgb, mBlendDstRgb, mBlendSrcAlpha, mBlendDstAlpha;
+		GLuint					mFramebuffer;
+		std::pair<ivec2,ivec2>	mViewport;
+		mat4					mViewMatrix, mProjectionMatrix;
+		float					mLineWidth;
+	};
+
+	//! Flushes if the current state differs from the batch's, then returns the first of \a numVertices new vertices, or \c nullptr if \a glsl can't be batched.
+	Vertex*	beginVertices( const GlslProg *glsl, GLenum primitive, const TextureBaseRef &texture, size_t numVertices );
+	//! Appends the two triangles of \a r, transformed by the model matrix, with texture coordinates from \a upperLeftTexCoord to \a lowerRightTexCoord.
+	bool	addQuad( const GlslProg *glsl, const TextureBaseRef &texture, const Rectf &r, const vec2 &upperLeftTexCoord, const vec2 &lowerRightTexCoord );
+	//! Returns whether \a glsl only consumes positions, texture coordinates and colors, caching the result for the last GlslProg while it is alive.
+	bool	isBatchable( const GlslProg *glsl );
+
+	Context					*mContext;
+	VaoRef					mVao;
+	//! Separate from Context::getStreamArrayVbo(), since a flush can happen after a convenience function has written its own vertices there
+	StreamVboRef			mStream;
+	std::vector<Vertex>		mVertices;
+	std::vector<vec2>		mPoints;
+	std::vector<vec4>		mTransformedPoints;
+	State					mState;
+	//! Keeps the texture of draw( TextureRef ) calls alive until the batch is flushed
+	TextureBaseRef			mTexture;
+
+	std::weak_ptr<const GlslProg>	mCachedGlslProg;
+	bool					mCachedBatchable;
+};
+
+} } // namespace cinder::gl
@@ -52,6 +52,8 @@ class CI_API BufferObj {
 #if ! defined( CINDER_GL_ES )
 	//! Returns some or all of the data from the buffer object currently bound for this objects \a target.
 	void		getBufferSubData( GLintptr offset, GLsizeiptr size, GLvoid *data );
+	//! Analogous to glBufferStorage(). Allocates immutable storage, which \a flags such as \c GL_MAP_PERSISTENT_BIT allow to stay mapped. Requires OpenGL 4.4 or \c ARB_buffer_storage.
+	void		bufferStorage( GLsizeiptr size, const GLvoid *data, GLbitfield flags );
 #endif // ! defined( CINDER_GL_ES )
 	//! Calls bufferSubData when the size is adequate, otherwise calls bufferData, forcing a reallocation of the data store
 	void		copyData( GLsizeiptr size, const GLvoid *data );
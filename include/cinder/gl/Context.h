@@ -29,6 +29,7 @@
 #include "cinder/Vector.h"
 #include "cinder/gl/Shader.h"
 
+#include <array>
 #include <vector>
 #include <map>
 
@@ -52,10 +53,41 @@ class Fbo;
 typedef std::shared_ptr<Fbo>			FboRef;
 class VertBatch;
 typedef std::shared_ptr<VertBatch>		VertBatchRef;
+class StreamVbo;
+typedef std::shared_ptr<StreamVbo>		StreamVboRef;
+class Batch2d;
+typedef std::shared_ptr<Batch2d>		Batch2dRef;
 class Renderbuffer;
 
 class TextureBase;
 
+//! Stacks of OpenGL state keyed by a GLenum, such as a binding target or capability. The keys that \a SlotFn maps to a slot below \a N
+//! live in a flat array, so that the common ones are found without searching a map. Any others fall back to a map.
+template<typename T, size_t N, size_t (*SlotFn)( GLenum )>
+class StateStackMap {
+  public:
+	//! Returns the stack for \a key, which is empty until the state of \a key is known.
+	std::vector<T>&		operator[]( GLenum key )
+	{
+		const size_t slot = SlotFn( key );
+		return ( slot < N ) ? mSlots[slot] : mOther[key];
+	}
+
+	//! Returns the stack for \a key, or \c nullptr if \a key has no slot and hasn't been encountered.
+	std::vector<T>*		find( GLenum key )
+	{
+		const size_t slot = SlotFn( key );
+		if( slot < N )
+			return &mSlots[slot];
+		auto it = mOther.find( key );
+		return ( it != mOther.end() ) ? &it->second : nullptr;
+	}
+
+  private:
+	std::array<std::vector<T>,N>		mSlots;
+	std::map<GLenum,std::vector<T>>		mOther;
+};
+
 class CI_API Context {
   public:
 	struct CI_API PlatformData {
@@ -386,6 +418,20 @@ class CI_API Context {
 	
 	void		sanityCheck();
 	void		printState( std::ostream &os ) const;
+
+	//! Counts of the state changes requested through the Context, such as binds, enables and blend functions
+	struct StateChangeCounters {
+		StateChangeCounters() : mIssued( 0 ), mElided( 0 ) {}
+
+		//! Changes that were passed on to OpenGL
+		uint64_t	mIssued;
+		//! Changes that were skipped because OpenGL already had the requested state
+		uint64_t	mElided;
+	};
+	//! Returns the state changes counted since the last resetStateChangeCounters(). Call that at the start of each frame for per-frame counts.
+	const StateChangeCounters&	getStateChangeCounters() const { return mStateChangeCounters; }
+	//! Zeroes the counters returned by getStateChangeCounters().
+	void						resetStateChangeCounters() { mStateChangeCounters = StateChangeCounters(); }
 	
 	// Object Tracking
 	//! Returns the container of live Textures. Requires object tracking to be enabled.
@@ -454,6 +500,11 @@ class CI_API Context {
 	void		multiDrawElementsIndirect( GLenum mode, GLenum type, const GLvoid *indirect, GLsizei drawcount, GLsizei stride );
 #endif // defined( CINDER_GL_HAS_MULTI_DRAW_INDIRECT )
 
+#if defined( CINDER_GL_HAS_COMPUTE_SHADER )
+	//! Analogous to glDispatchCompute()
+	void		dispatchCompute( GLuint numGroupsX, GLuint numGroupsY, GLuint numGroupsZ );
+#endif // defined( CINDER_GL_HAS_COMPUTE_SHADER )
+
 	//! Returns the current active color, used in immediate-mode emulation and as UNIFORM_COLOR
 	const ColorAf&		getCurrentColor() const { return mColor; }
 	void				setCurrentColor( const ColorAf &color ) { mColor = color; }
@@ -464,8 +515,18 @@ class CI_API Context {
 	VboRef			getDefaultArrayVbo( size_t requiredSize = 0 );
 	//! Returns default VBO for element array data, ensuring it is at least \a requiredSize bytes. Designed for use with convenience functions.
 	VboRef			getDefaultElementVbo( size_t requiredSize = 0 );
+	//! Returns the ring buffer that the convenience functions stream vertex array data through. Unlike getDefaultArrayVbo(), writes don't wait on earlier draws.
+	const StreamVboRef&	getStreamArrayVbo();
+	//! Returns the ring buffer that the convenience functions stream element array data through.
+	const StreamVboRef&	getStreamElementVbo();
 	//! Returns default VAO, designed for use with convenience functions.
 	Vao*			getDefaultVao();
+	//! Begins recording the 2D convenience functions into getBatch2d(). Calls nest, and only the outermost popBatch2d() draws the batch. Generally use ScopedBatch2d instead.
+	void			pushBatch2d();
+	//! Ends a pushBatch2d(), drawing anything recorded once the outermost one ends.
+	void			popBatch2d();
+	//! Returns the Batch2d that the 2D convenience functions are recorded into while a ScopedBatch2d is active, or \c nullptr.
+	Batch2d*		getBatch2d() const { return mBatch2dDepth ? mBatch2d.get() : nullptr; }
 	//! Returns a VBO for drawing textured rectangles; used by gl::draw(TextureRef)
 	VboRef			getDrawTextureVbo();
 	//! Returns a VBO for drawing textured rectangles; used by gl::draw(TextureRef)
@@ -483,6 +544,33 @@ class CI_API Context {
 #endif
 
   protected:
+	//! Slots of the buffer targets whose binding stacks live in a flat array
+	enum BufferSlot { BUFFER_SLOT_ARRAY, BUFFER_SLOT_ELEMENT_ARRAY, BUFFER_SLOT_UNIFORM, BUFFER_SLOT_PIXEL_PACK, BUFFER_SLOT_PIXEL_UNPACK,
+		BUFFER_SLOT_TRANSFORM_FEEDBACK, BUFFER_SLOT_COPY_READ, BUFFER_SLOT_COPY_WRITE, BUFFER_SLOT_TEXTURE, BUFFER_SLOT_DRAW_INDIRECT,
+		BUFFER_SLOT_DISPATCH_INDIRECT, BUFFER_SLOT_SHADER_STORAGE, BUFFER_SLOT_ATOMIC_COUNTER, NUM_BUFFER_SLOTS };
+	//! Slots of the capabilities whose stacks live in a flat array
+	enum BoolStateSlot { BOOL_STATE_SLOT_BLEND, BOOL_STATE_SLOT_DEPTH_TEST, BOOL_STATE_SLOT_CULL_FACE, BOOL_STATE_SLOT_SCISSOR_TEST,
+		BOOL_STATE_SLOT_STENCIL_TEST, BOOL_STATE_SLOT_POLYGON_OFFSET_FILL, BOOL_STATE_SLOT_SAMPLE_ALPHA_TO_COVERAGE, BOOL_STATE_SLOT_DITHER,
+		BOOL_STATE_SLOT_MULTISAMPLE, BOOL_STATE_SLOT_LINE_SMOOTH, BOOL_STATE_SLOT_PROGRAM_POINT_SIZE, BOOL_STATE_SLOT_FRAMEBUFFER_SRGB,
+		BOOL_STATE_SLOT_RASTERIZER_DISCARD, BOOL_STATE_SLOT_PRIMITIVE_RESTART_FIXED_INDEX, NUM_BOOL_STATE_SLOTS };
+	//! Slots of the texture targets whose binding stacks live in a flat array, for the first MAX_SLOT_TEXTURE_UNITS texture units
+	enum TextureTargetSlot { TEXTURE_TARGET_SLOT_2D, TEXTURE_TARGET_SLOT_CUBE_MAP, TEXTURE_TARGET_SLOT_3D, TEXTURE_TARGET_SLOT_2D_ARRAY,
+		TEXTURE_TARGET_SLOT_RECTANGLE, TEXTURE_TARGET_SLOT_1D, TEXTURE_TARGET_SLOT_1D_ARRAY, TEXTURE_TARGET_SLOT_CUBE_MAP_ARRAY,
+		TEXTURE_TARGET_SLOT_BUFFER, TEXTURE_TARGET_SLOT_2D_MULTISAMPLE, TEXTURE_TARGET_SLOT_EXTERNAL, NUM_TEXTURE_TARGET_SLOTS };
+	static const size_t MAX_SLOT_TEXTURE_UNITS = 32;
+
+	//! Returns the BufferSlot of \a target, or \c NUM_BUFFER_SLOTS if it has none
+	static size_t	getBufferSlot( GLenum target );
+	//! Returns the BoolStateSlot of \a cap, or \c NUM_BOOL_STATE_SLOTS if it has none
+	static size_t	getBoolStateSlot( GLenum cap );
+	//! Returns the key of the binding of \a target on \a textureUnit in mTextureBindingStack
+	static GLenum	getTextureBindingKey( GLenum target, uint8_t textureUnit ) { return ( GLenum( textureUnit ) << 16 ) | target; }
+	//! Returns the slot of a getTextureBindingKey() in mTextureBindingStack, or an out of range value if it has none
+	static size_t	getTextureBindingSlot( GLenum key );
+
+	//! Counts a state change as issued if \a changed, or elided otherwise, and returns \a changed
+	bool		countStateChange( bool changed ) { if( changed ) mStateChangeCounters.mIssued++; else mStateChangeCounters.mElided++; return changed; }
+
 	//! Returns \c true if \a value is different from the previous top of the stack
 	template<typename T>
 	bool		pushStackState( std::vector<T> &stack, T value );
@@ -500,8 +588,8 @@ class CI_API Context {
 
 	std::map<ShaderDef,GlslProgRef>		mStockShaders;
 	
-	std::map<GLenum,std::vector<int>>	mBufferBindingStack;
-	std::map<GLenum,std::vector<int>>	mRenderbufferBindingStack;
+	StateStackMap<GLint,NUM_BUFFER_SLOTS,&getBufferSlot>		mBufferBindingStack;
+	std::vector<GLint>					mRenderbufferBindingStack;
 	std::vector<const GlslProg*>		mGlslProgStack;
 	std::vector<Vao*>					mVaoStack;
 	
@@ -535,9 +623,9 @@ class CI_API Context {
 	std::vector<GLboolean>		mDepthMaskStack;
 	std::vector<GLenum>			mDepthFuncStack;
 	
-	std::map<GLenum,std::vector<GLboolean>>	mBoolStateStack;
-	// map<TextureUnit,map<TextureTarget,vector<Binding ID Stack>>>
-	std::map<uint8_t,std::map<GLenum,std::vector<GLint>>>	mTextureBindingStack;
+	StateStackMap<GLboolean,NUM_BOOL_STATE_SLOTS,&getBoolStateSlot>	mBoolStateStack;
+	// keyed by getTextureBindingKey()
+	StateStackMap<GLint,MAX_SLOT_TEXTURE_UNITS * NUM_TEXTURE_TARGET_SLOTS,&getTextureBindingSlot>	mTextureBindingStack;
 	std::vector<uint8_t>					mActiveTextureStack;
 	
 #if defined( CINDER_GL_HAS_SAMPLERS )
@@ -545,8 +633,12 @@ class CI_API Context {
 #endif	
 	
 	VaoRef						mDefaultVao;
-	VboRef						mDefaultArrayVbo[4], mDefaultElementVbo;
-	uint8_t						mDefaultArrayVboIdx;
+	VboRef						mDefaultArrayVbo, mDefaultElementVbo;
+	StreamVboRef				mStreamArrayVbo, mStreamElementVbo;
+	Batch2dRef					mBatch2d;
+	int							mBatch2dDepth;
+
+	StateChangeCounters			mStateChangeCounters;
 	VertBatchRef				mImmediateMode;
 	VaoRef						mDrawTextureVao;
 	VboRef						mDrawTextureVbo;
@@ -555,6 +647,14 @@ class CI_API Context {
 	Context( const std::shared_ptr<PlatformData> &platformData );
 
 	void	allocateDrawTextureVboAndVao();
+	//! Draws the vertices recorded by an active ScopedBatch2d ahead of another draw call
+	void	flushBatch2d();
+	//! Uploads the uniforms staged by the bound GlslProg ahead of a draw call
+	void	flushGlslProgUniforms();
+#if ! defined( CINDER_GL_ES_2 )
+	//! Reflects the generic binding of \a target after an indexed bind of buffer \a id
+	void	indexedBufferBound( GLenum target, GLuint id );
+#endif
 
 	std::shared_ptr<PlatformData>	mPlatformData;
 	
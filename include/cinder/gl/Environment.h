@@ -87,6 +87,8 @@ class CI_API Environment {
 	virtual bool			supportsTextureLod() const = 0;
 	virtual bool 			supportsGeometryShader() const = 0;
 	virtual bool 			supportsTessellationShader() const = 0;
+	//! Returns whether glBufferStorage() and persistently mapped buffers are available
+	virtual bool			supportsBufferStorage() const = 0;
 
 	virtual GLenum			getPreferredIndexType() const  = 0;
 
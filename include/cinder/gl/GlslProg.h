@@ -30,6 +30,7 @@
 #include <fstream>
 #include <map>
 #include <set>
+#include <future>
 
 #include "cinder/gl/wrapper.h"
 #include "cinder/gl/ShaderPreprocessor.h"
@@ -49,9 +50,10 @@ namespace cinder { namespace gl {
 typedef std::shared_ptr<class GlslProg> GlslProgRef;
 
 class UniformValueCache;
+class UniformStaging;
 class ShaderPreprocessor;
 
-class CI_API GlslProg {
+class CI_API GlslProg : public std::enable_shared_from_this<GlslProg> {
   public:
 	struct CI_API Attribute {
 		//! Returns a const reference of the name as defined in the Vertex Shader.
@@ -107,6 +109,21 @@ class CI_API GlslProg {
 		
 		friend class GlslProg;
 	};
+
+	//! Precompiled reference to an active uniform, returned by getUniformHandle(). Setting a uniform through its handle skips the lookup by name.
+	struct CI_API UniformHandle {
+		//! Returns whether the handle refers to an active uniform.
+		bool	isValid() const { return mUniform >= 0 || mBlockMember >= 0; }
+
+	  private:
+		GLuint	mProgram = 0;
+		//! Index into the GlslProg's active uniforms and location, accounting for indices like "example[2]"
+		GLint	mUniform = -1, mLocation = -1;
+		//! Index into the members of buffer-backed uniform blocks and array index within the member
+		GLint	mBlockMember = -1, mArrayIndex = 0;
+
+		friend class GlslProg;
+	};
 	
 #if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
 
@@ -280,6 +297,24 @@ class CI_API GlslProg {
 		//! Sets the debugging label associated with the Program. Calls glObjectLabel() when available.
 		Format&				label( const std::string &label ) { setLabel( label ); return *this; }
         
+		//! Enables staging of uniform values on the CPU. Changed uniforms are uploaded together by flushUniforms(), which gl::Context calls before every draw and gl::dispatchCompute(). \default false.
+		Format&		uniformStaging( bool enable = true ) { mUniformStaging = enable; return *this; }
+		//! Returns whether uniform values are staged on the CPU until the next draw.
+		bool		isUniformStagingEnabled() const { return mUniformStaging || mUniformBufferBacking; }
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+		//! Backs each active uniform block with a Ubo owned by the GlslProg, so that block members can be set with uniform() like any other uniform. Only the dirty byte range of each block is uploaded before a draw. Blocks are bound to consecutive bindings starting at \a firstBinding. Implies uniformStaging(). \default false.
+		Format&		uniformBufferBacking( bool enable = true, GLuint firstBinding = 0 ) { mUniformBufferBacking = enable; mUniformBufferBackingBinding = firstBinding; return *this; }
+		//! Returns whether uniform blocks are backed by Ubos owned by the GlslProg.
+		bool		isUniformBufferBackingEnabled() const { return mUniformBufferBacking; }
+		//! Returns the binding of the first buffer-backed uniform block.
+		GLuint		getUniformBufferBackingBinding() const { return mUniformBufferBackingBinding; }
+#endif
+
+		//! Enables loading this program from and storing it in the program binary cache, see GlslProg::setBinaryCacheDirectory(). \default true.
+		Format&		binaryCache( bool enable = true ) { mBinaryCache = enable; return *this; }
+		//! Returns whether this program uses the program binary cache.
+		bool		isBinaryCacheEnabled() const { return mBinaryCache; }
+
 		//! Returns the fs::path for the vertex shader. Returns an empty fs::path if it isn't present.
 		const fs::path&	getVertexPath() const { return mVertexShaderPath; }
 		//! Returns the fs::path for the fragment shader. Returns an empty fs::path if it isn't present.
@@ -324,6 +359,10 @@ class CI_API GlslProg {
 		std::vector<Uniform>			mUniforms;
 		std::string						mLabel;
 		ShaderPreprocessorRef			mPreprocessor;
+		bool							mUniformStaging = false;
+		bool							mUniformBufferBacking = false;
+		GLuint							mUniformBufferBackingBinding = 0;
+		bool							mBinaryCache = true;
 
 		friend class		GlslProg;
 	};
@@ -348,6 +387,8 @@ class CI_API GlslProg {
 	static GlslProgRef create( DataSourceRef vertexShader, DataSourceRef fragmentShader = DataSourceRef() );
 	static GlslProgRef create( const std::string &vertexShader, const std::string &fragmentShader = std::string() );
 #endif
+	//! Creates a GlslProg on a background thread, which has a gl::Context that shares resources with the current one. The returned future holds the linked program, or rethrows the GlslProgCompileExc or GlslProgLinkExc. Requests are serviced in order. The Format's ShaderPreprocessor is used on the worker thread, so it shouldn't be modified until the future is ready. Must be called from a thread with a current gl::Context.
+	static std::future<GlslProgRef>	createAsync( const Format &format );
 	~GlslProg();
 	
 	void			bind() const;
@@ -413,6 +454,42 @@ class CI_API GlslProg {
 	void	uniform( int location, const mat2 *data, int count, bool transpose = false ) const;
 	void	uniform( int location, const mat3 *data, int count, bool transpose = false ) const;
 	void	uniform( int location, const mat4 *data, int count, bool transpose = false ) const;
+
+	//! Returns a precompiled handle to the uniform that matches \a name, accounting for indices like "example[2]" and members of buffer-backed uniform blocks. Returns an invalid handle if the uniform doesn't exist.
+	UniformHandle	getUniformHandle( const std::string &name ) const;
+	void	uniform( const UniformHandle &handle, bool data ) const;
+	void	uniform( const UniformHandle &handle, int data ) const;
+	void	uniform( const UniformHandle &handle, float data ) const;
+	void	uniform( const UniformHandle &handle, const vec2 &data ) const;
+	void	uniform( const UniformHandle &handle, const vec3 &data ) const;
+	void	uniform( const UniformHandle &handle, const vec4 &data ) const;
+	void	uniform( const UniformHandle &handle, const ivec2 &data ) const;
+	void	uniform( const UniformHandle &handle, const ivec3 &data ) const;
+	void	uniform( const UniformHandle &handle, const ivec4 &data ) const;
+#if ! defined( CINDER_GL_ES_2 )
+	void	uniform( const UniformHandle &handle, uint32_t data ) const;
+	void	uniform( const UniformHandle &handle, const uvec2 &data ) const;
+	void	uniform( const UniformHandle &handle, const uvec3 &data ) const;
+	void	uniform( const UniformHandle &handle, const uvec4 &data ) const;
+	void	uniform( const UniformHandle &handle, const uint32_t *data, int count ) const;
+#endif // ! defined( CINDER_GL_ES_2 )
+	void	uniform( const UniformHandle &handle, const mat2 &data, bool transpose = false ) const;
+	void	uniform( const UniformHandle &handle, const mat3 &data, bool transpose = false ) const;
+	void	uniform( const UniformHandle &handle, const mat4 &data, bool transpose = false ) const;
+	void	uniform( const UniformHandle &handle, const int *data, int count ) const;
+	void	uniform( const UniformHandle &handle, const float *data, int count ) const;
+	void	uniform( const UniformHandle &handle, const ivec2 *data, int count ) const;
+	void	uniform( const UniformHandle &handle, const vec2 *data, int count ) const;
+	void	uniform( const UniformHandle &handle, const vec3 *data, int count ) const;
+	void	uniform( const UniformHandle &handle, const vec4 *data, int count ) const;
+	void	uniform( const UniformHandle &handle, const mat2 *data, int count, bool transpose = false ) const;
+	void	uniform( const UniformHandle &handle, const mat3 *data, int count, bool transpose = false ) const;
+	void	uniform( const UniformHandle &handle, const mat4 *data, int count, bool transpose = false ) const;
+
+	//! Uploads the uniforms staged since the last flush with a single call per changed uniform and a single buffer update per changed uniform block. gl::Context calls this before every draw, so it only needs to be called before drawing with raw GL calls.
+	void	flushUniforms() const;
+	//! Returns whether uniform values are staged on the CPU until the next draw. See Format::uniformStaging().
+	bool	isUniformStagingEnabled() const { return mUniformStaging != nullptr; }
 	
 	bool	hasAttribSemantic( geom::Attrib semantic ) const;
 	GLint	getAttribSemanticLocation( geom::Attrib semantic ) const;
@@ -468,12 +545,43 @@ class CI_API GlslProg {
 	//! Sets the debugging label associated with the Program. Calls glObjectLabel() when available.
 	void				setLabel( const std::string &label );
 
+	//! Counts and times of the programs created since the last resetCreateStats(), for measuring cold and warm startup.
+	struct CI_API CreateStats {
+		//! Number of programs compiled from source and number of programs loaded from the binary cache
+		size_t	mNumCompiled = 0, mNumLoadedFromCache = 0;
+		//! Seconds spent creating the programs compiled from source and the programs loaded from the binary cache
+		double	mCompileSeconds = 0, mLoadSeconds = 0;
+	};
+
+	//! Returns the counts and times of the programs created since the last resetCreateStats(), on any thread.
+	static CreateStats	getCreateStats();
+	//! Resets the counts and times returned by getCreateStats().
+	static void			resetCreateStats();
+
+	//! Enables the persistent program binary cache in \a directory, which is created if needed. Programs are keyed by a hash of their preprocessed sources, defines, bindings and the driver's vendor, renderer and version strings, and cache hits are loaded with glProgramBinary() instead of being compiled. An empty path disables the cache, which is the default. Requires program binary support from the driver.
+	static void			setBinaryCacheDirectory( const fs::path &directory );
+	//! Returns the directory of the program binary cache, which is empty when the cache is disabled.
+	static fs::path		getBinaryCacheDirectory();
+
   protected:
 	GlslProg( const Format &format );
 
 	void			bindImpl() const;
-	GLuint			loadShader( const std::string &shaderSource, const fs::path &shaderPath, GLint shaderType, const ShaderPreprocessorRef &preprocessor );
+	//! Returns \a shaderSource after running it through \a preprocessor, recording the included files.
+	std::string		preprocessShader( const std::string &shaderSource, const fs::path &shaderPath, const ShaderPreprocessorRef &preprocessor );
+	//! Compiles the preprocessed \a shaderSource and attaches it. Returns 0 if \a shaderSource is empty.
+	GLuint			loadShader( const std::string &shaderSource, GLint shaderType );
 	void			link();
+#if defined( CINDER_GL_HAS_PROGRAM_BINARY )
+	//! Returns the path of the cached binary of this program, or an empty path if the binary cache is disabled or unsupported.
+	static fs::path	getProgramBinaryPath( const Format &format, const std::vector<std::pair<GLint,std::string>> &shaderSources );
+	//! Loads the binary at \a path into the program. Returns false if it doesn't exist or the driver rejects it.
+	bool			loadProgramBinary( const fs::path &path );
+	//! Writes the binary of the linked program to \a path.
+	void			storeProgramBinary( const fs::path &path ) const;
+#endif
+	//! Adds the creation of a program to the stats returned by getCreateStats().
+	static void		recordCreateTime( bool loadedFromCache, double seconds );
 	
 	//! Caches all active Attributes after linking.
 	void			cacheActiveAttribs();
@@ -483,6 +591,21 @@ class CI_API GlslProg {
 	void			cacheActiveUniforms();
 	//! Returns a pointer to the Uniform that matches \a location. Returns nullptr if the uniform doesn't exist.
 	const Uniform*	findUniform( int location, int *resultLocation ) const;
+	//! Returns a pointer to the Uniform referenced by \a handle. Returns nullptr if the handle doesn't reference an active uniform outside of a uniform block.
+	const Uniform*	findUniform( const UniformHandle &handle, int *resultLocation ) const;
+	//! Returns the index of the buffer-backed uniform block member that matches \a name, or -1. The array index of names like "example[2]" is stored in \a arrayIndex.
+	int				findBlockMember( const std::string &name, int *arrayIndex ) const;
+	int				findBlockMember( const UniformHandle &handle, int *arrayIndex ) const;
+	//! Uniform block members have no location, returns -1.
+	int				findBlockMember( int /*location*/, int * /*arrayIndex*/ ) const { return -1; }
+	//! Allocates the staging storage and the Ubos of buffer-backed uniform blocks after the active uniforms have been cached.
+	void			setupUniformStaging( const Format &format );
+	//! Copies \a count values of \a uniform starting at \a location into the staging storage. Returns false if staging is disabled and the values should be uploaded immediately.
+	template<typename T>
+	bool			stageUniform( const Uniform &uniform, int location, const T *data, int count ) const;
+	//! Writes \a count values into the buffer-backed uniform block member matching \a lookUp. Returns false if there is no such member.
+	template<typename LookUp, typename T>
+	bool			uniformBlockMemberImpl( const LookUp &lookUp, const T *data, int count ) const;
 	
 	//! Performs the finding, validation, and implementation of single uniform variables. Ends by calling the location
 	//! variant uniform function.
@@ -513,6 +636,8 @@ class CI_API GlslProg {
 	void			logMissingUniform( const std::string &name ) const;
 	//! Logs an error and caches the name.
 	void			logMissingUniform( int location ) const;
+	//! getUniformHandle() has already logged the missing uniform of an invalid handle.
+	void			logMissingUniform( const UniformHandle &/*handle*/ ) const {}
 	//! Logs a warning and caches the name.
 	void			logUniformWrongType( const std::string &name, GLenum uniformType, const std::string &userType ) const;
 	//! Checks the validity of the settings on this uniform, specifically type and value
@@ -550,6 +675,7 @@ class CI_API GlslProg {
 	std::vector<Attribute>						mAttributes;
 	std::vector<Uniform>						mUniforms;
 	mutable std::unique_ptr<UniformValueCache>	mUniformValueCache;
+	mutable std::unique_ptr<UniformStaging>		mUniformStaging;
 #if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
 	std::vector<UniformBlock>				mUniformBlocks;
 #endif
@@ -47,8 +47,6 @@ public:
 	inline void bindBase( GLuint index ) { glBindBufferBase( mTarget, index, mId );  mBase = index; }
 	//! Unbinds the buffer.
 	inline void unbindBase() { glBindBufferBase( mTarget, mBase, 0 ); mBase = 0; }
-	//! Analogous to bufferStorage.
-	inline void bufferStorage( GLsizeiptr size, const void *data, GLbitfield flags ) const { glBufferStorage( mTarget, size, data, flags ); }
 protected:
 	Ssbo( GLsizeiptr allocationSize, const void *data = nullptr, GLenum usage = GL_STATIC_DRAW )
 		: BufferObj( GL_SHADER_STORAGE_BUFFER, allocationSize, data, usage ),
@@ -0,0 +1,83 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/gl/Vbo.h"
+#include "cinder/gl/Sync.h"
+
+#include <vector>
+
+namespace cinder { namespace gl {
+
+typedef std::shared_ptr<class StreamVbo>	StreamVboRef;
+
+//! A ring buffer that hands out regions of a single Vbo for data that is written once and drawn once, such as by the gl::draw*() convenience functions.
+//! With OpenGL 4.4 or \c ARB_buffer_storage the Vbo is persistently mapped and written with memcpy(). The ring is split into regions which are fenced
+//! when writing moves past them and waited on before they are reused, so only a full ring of in-flight data can stall. Elsewhere the Vbo is orphaned
+//! with glBufferData() each time the ring wraps around and written with glBufferSubData().
+class CI_API StreamVbo {
+  public:
+	//! Creates a StreamVbo of \a size bytes for \a target, typically \c GL_ARRAY_BUFFER or \c GL_ELEMENT_ARRAY_BUFFER, fenced in \a numRegions regions.
+	static StreamVboRef	create( GLenum target, GLsizeiptr size = 4 * 1024 * 1024, size_t numRegions = 4 );
+
+	//! Reserves \a size bytes of the ring and returns a pointer to write them to, which is valid until commit(). \a offset receives their offset in getVbo().
+	//! The Vbo is reallocated when \a size exceeds it, so call getVbo() after reserve(). Data for one draw call should be written with a single reserve(), since later ones may orphan it.
+	void*			reserve( GLsizeiptr size, GLintptr *offset );
+	//! Finishes writing the data of the last reserve(), uploading it when the Vbo isn't persistently mapped.
+	void			commit();
+	//! Copies \a size bytes of \a data into the ring and returns their offset in getVbo(). Equivalent to reserve() followed by commit().
+	GLintptr		write( const void *data, GLsizeiptr size );
+
+	//! Returns the Vbo that the offsets returned by write() refer to.
+	const VboRef&	getVbo() const { return mVbo; }
+	//! Returns the size of the ring in bytes.
+	GLsizeiptr		getSize() const { return mSize; }
+	//! Returns whether the Vbo is persistently mapped and fenced, rather than orphaned.
+	bool			isPersistentlyMapped() const { return mMappedData != nullptr; }
+
+	//! Offsets returned by write() are multiples of this, which is suitable for any vertex attribute or index type.
+	static const GLintptr	ALIGNMENT = 16;
+
+  protected:
+	StreamVbo( GLenum target, GLsizeiptr size, size_t numRegions );
+
+	void		allocate( GLsizeiptr size );
+	//! Fences the current region and waits for the next one to be free, with persistent mapping
+	void		enterNextRegion();
+	size_t		getRegion( GLintptr offset ) const;
+
+	GLenum		mTarget;
+	VboRef		mVbo;
+	GLsizeiptr	mSize;
+	GLintptr	mHead;
+	uint8_t		*mMappedData;
+	std::vector<uint8_t>	mStagingData; // holds reserved data until commit() without persistent mapping
+	GLintptr	mReservedOffset;
+	GLsizeiptr	mReservedSize;
+	size_t		mNumRegions, mCurrentRegion;
+#if ! defined( CINDER_GL_ES )
+	std::vector<SyncRef>	mRegionSyncs;
+#endif
+};
+
+} } // namespace cinder::gl
@@ -28,6 +28,7 @@
 #include "cinder/gl/scoped.h"
 
 #include "cinder/gl/Batch.h"
+#include "cinder/gl/Batch2d.h"
 #include "cinder/gl/BufferTexture.h"
 #include "cinder/gl/Context.h"
 #include "cinder/gl/Environment.h"
@@ -39,6 +40,7 @@
 #include "cinder/gl/Shader.h"
 #include "cinder/gl/ShaderPreprocessor.h"
 #include "cinder/gl/Ssbo.h"
+#include "cinder/gl/StreamVbo.h"
 #include "cinder/gl/Sync.h"
 #include "cinder/gl/Texture.h"
 #include "cinder/gl/TextureFont.h"
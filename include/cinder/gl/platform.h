@@ -166,6 +166,7 @@
 		#define CINDER_GL_HAS_RENDER_SNORM
 		#define CINDER_GL_HAS_REQUIRED_INTERNALFORMAT
 		#define CINDER_GL_HAS_SAMPLERS
+		#define CINDER_GL_HAS_PROGRAM_BINARY
 	#else 
 		// OpenGL ES 2
 		#if ! defined( CINDER_GL_ES_2_RPI )
@@ -201,6 +202,7 @@
 	#define CINDER_GL_HAS_GEOM_SHADER
 	#define CINDER_GL_HAS_TESS_SHADER
 	#define CINDER_GL_HAS_SAMPLERS
+	#define CINDER_GL_HAS_PROGRAM_BINARY
 	
 	#define CINDER_GL_HAS_RENDER_SNORM
 	#define CINDER_GL_HAS_REQUIRED_INTERNALFORMAT
@@ -340,6 +340,16 @@ struct CI_API ScopedFrontFace : private Noncopyable {
 	Context		*mCtx;
 };
 
+//! Records drawSolidRect(), drawSolidCircle(), drawLine( vec2, vec2 ) and draw( TextureRef ) calls into a Batch2d, which merges consecutive calls
+//! sharing a GlslProg, texture and blend state into a single draw call. Anything pending is drawn when the outermost ScopedBatch2d ends. \see Batch2d
+struct CI_API ScopedBatch2d : private Noncopyable {
+	ScopedBatch2d();
+	~ScopedBatch2d();
+
+  private:
+	Context		*mCtx;
+};
+
 #if defined( CINDER_GL_HAS_KHR_DEBUG )
 
 //! Scopes debug group message
@@ -347,8 +347,8 @@ CI_API void	readPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenum
 
 // Compute
 #if defined( CINDER_GL_HAS_COMPUTE_SHADER )
-//! Launches one or more compute work groups. Analogous to glDispatchCompute(). 
-CI_API inline void	dispatchCompute( GLuint numGroupsX, GLuint numGroupsY = 1, GLuint numGroupsZ = 1 ) { glDispatchCompute( numGroupsX, numGroupsY, numGroupsZ ); }
+//! Launches one or more compute work groups. Analogous to glDispatchCompute(), after uploading the uniforms staged by the bound GlslProg.
+CI_API void	dispatchCompute( GLuint numGroupsX, GLuint numGroupsY = 1, GLuint numGroupsZ = 1 );
 //! Defines a barrier ordering memory transactions. Analogous to glMemoryBarrier().
 CI_API inline void	memoryBarrier( GLbitfield barriers ) { glMemoryBarrier( barriers ); }
 
@@ -20,10 +20,28 @@
  POSSIBILITY OF SUCH DAMAGE.
 */
 
+#pragma once
+
 #include "cinder/Surface.h"
 
 namespace cinder { namespace ip {
 
+//! Reusable temporary storage for stackBlurParallel(). Blurring repeatedly with the same instance only allocates when a larger image or radius is encountered.
+class CI_API StackBlurScratch {
+  public:
+	StackBlurScratch() : mCapacity( 0 ), mAligned( nullptr ) {}
+
+	//! Returns 16-byte aligned storage of at least \a numBytes. Grows the arena if necessary, discarding its previous contents.
+	void*	reserve( size_t numBytes );
+	//! Returns the number of bytes currently available without reallocating.
+	size_t	getCapacity() const		{ return mCapacity; }
+
+  private:
+	std::unique_ptr<uint8_t[]>	mData;
+	size_t						mCapacity;
+	uint8_t						*mAligned;
+};
+
 //! Blur \a surface in-place using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
 CI_API void			stackBlur( Surface8u *surface, int radius );
 //! Blur \a surface in-place in \a area using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
@@ -66,4 +84,29 @@ CI_API void			stackBlur( Channel32f *channel, const Area &area, int radius );
 //! Create a blurred copy of \a channel using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
 CI_API Channel32f	stackBlurCopy( const Channel32f &channel, int radius );
 
+//! Blur \a surface in-place using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Surface8u *surface, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a surface in-place in \a area using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Surface8u *surface, const Area &area, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a channel in-place using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Channel8u *channel, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a channel in-place in \a area using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Channel8u *channel, const Area &area, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a surface in-place using a multithreaded "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Surface16u *surface, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a surface in-place in \a area using a multithreaded "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Surface16u *surface, const Area &area, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a channel in-place using a multithreaded "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Channel16u *channel, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a channel in-place in \a area using a multithreaded "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Channel16u *channel, const Area &area, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a surface in-place using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Surface32f *surface, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a surface in-place in \a area using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Surface32f *surface, const Area &area, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a channel in-place using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Channel32f *channel, int radius, StackBlurScratch *scratch = nullptr );
+//! Blur \a channel in-place in \a area using a multithreaded, SIMD-accelerated "stackBlur" that produces the same result as stackBlur(). Temporary storage is taken from \a scratch when provided, otherwise it is allocated for the duration of the call.
+CI_API void			stackBlurParallel( Channel32f *channel, const Area &area, int radius, StackBlurScratch *scratch = nullptr );
+
 } } // namespace cinder::ip
@@ -0,0 +1,91 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Channel.h"
+#include "cinder/Area.h"
+
+#include <vector>
+
+namespace cinder { namespace ip {
+
+//! A summed-area table of a Channel, which answers the sum of any rectangle of pixels in constant time.
+/** The table is stored with an additional leading row and column of zeros, so that getValue( x, y ) is the sum of all pixels above and to the left of (x, y).
+	\a SumT should be wide enough for the total of the Channel: \c uint32_t suffices for 8-bit Channels of up to 16.8 million pixels. **/
+template<typename SumT>
+class CI_API IntegralImageT {
+  public:
+	IntegralImageT() : mWidth( 0 ), mHeight( 0 ) {}
+	//! Constructs the integral image of \a channel.
+	template<typename T>
+	explicit IntegralImageT( const ChannelT<T> &channel ) : mWidth( 0 ), mHeight( 0 )	{ calculate( channel ); }
+
+	//! Recalculates the table from \a channel in a single pass, reusing the existing allocation where possible.
+	template<typename T>
+	void	calculate( const ChannelT<T> &channel );
+
+	//! Returns the sum of the pixels inside \a area, which is clipped to the bounds of the source Channel.
+	SumT	getSum( const Area &area ) const;
+	//! Returns the sum of the pixels in the half-open rectangle [\a x1, \a x2) x [\a y1, \a y2), which must lie inside the bounds of the source Channel.
+	SumT	getSum( int32_t x1, int32_t y1, int32_t x2, int32_t y2 ) const
+	{
+		const SumT *top = &mData[y1 * getRowStride()], *bottom = &mData[y2 * getRowStride()];
+		return bottom[x2] - bottom[x1] - top[x2] + top[x1];
+	}
+	//! Returns the mean value of the pixels inside \a area, which is clipped to the bounds of the source Channel. Returns \c 0 for an empty area.
+	double	getMean( const Area &area ) const;
+
+	//! Returns the sum of all pixels in the half-open rectangle [0, \a x) x [0, \a y), for 0 <= \a x <= getWidth() and 0 <= \a y <= getHeight().
+	SumT			getValue( int32_t x, int32_t y ) const	{ return mData[y * getRowStride() + x]; }
+	//! Returns a pointer to the (getWidth() + 1) x (getHeight() + 1) table.
+	const SumT*		getData() const							{ return mData.data(); }
+	//! Returns the number of elements between consecutive rows of the table, which is getWidth() + 1.
+	ptrdiff_t		getRowStride() const					{ return mWidth + 1; }
+
+	//! Returns the width of the source Channel.
+	int32_t		getWidth() const		{ return mWidth; }
+	//! Returns the height of the source Channel.
+	int32_t		getHeight() const		{ return mHeight; }
+	//! Returns the size of the source Channel.
+	ivec2		getSize() const			{ return ivec2( mWidth, mHeight ); }
+	//! Returns the bounds of the source Channel.
+	Area		getBounds() const		{ return Area( 0, 0, mWidth, mHeight ); }
+
+  private:
+	int32_t				mWidth, mHeight;
+	std::vector<SumT>	mData;
+};
+
+//! The IntegralImageT sum type used for a ChannelT<T> by default: \c uint32_t for 8-bit, \c uint64_t for 16-bit and \c double for floating point Channels.
+template<typename T>	struct IntegralImageSum				{ typedef uint32_t Type; };
+template<>				struct IntegralImageSum<uint16_t>	{ typedef uint64_t Type; };
+template<>				struct IntegralImageSum<float>		{ typedef double Type; };
+
+typedef IntegralImageT<uint32_t>	IntegralImage;
+typedef IntegralImageT<uint32_t>	IntegralImage32u;
+typedef IntegralImageT<uint64_t>	IntegralImage64u;
+typedef IntegralImageT<double>		IntegralImage64f;
+
+} } // namespace cinder::ip
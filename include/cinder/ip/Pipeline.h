@@ -0,0 +1,117 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Surface.h"
+
+#include <type_traits>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+//! Records a chain of ip:: operations and applies them to a Surface in a single tiled pass.
+/** Each tile is taken through every operation while it is resident in cache, and tiles are processed in parallel on ThreadPool::getDefault().
+	Neighbourhood operations (edgeDetectSobel() and stackBlur()) are evaluated on tiles padded by the accumulated halo, so the result matches
+	calling the equivalent ip:: functions one after another (up to rounding for stackBlur() on floating-point Surfaces, whose running sums start at tile edges). Global operations (hdrNormalize()) split the chain into additional passes.
+	\code
+	ip::Pipeline pipeline;
+	pipeline.grayscale().stackBlur( 3 ).edgeDetectSobel().threshold( 64 );
+	Surface8u edges = pipeline.runCopy( photo );
+	\endcode **/
+template<typename T>
+class CI_API PipelineT {
+  public:
+	PipelineT() : mTileSize( 256, 256 ) {}
+
+	//! Appends ip::grayscale(), replacing the RGB channels with their luminance.
+	PipelineT&	grayscale();
+	//! Appends ip::threshold() with \a value.
+	PipelineT&	threshold( T value );
+	//! Appends ip::premultiply().
+	PipelineT&	premultiply();
+	//! Appends ip::unpremultiply().
+	PipelineT&	unpremultiply();
+	//! Appends ip::flipVertical().
+	PipelineT&	flipVertical();
+	//! Appends ip::flipHorizontal().
+	PipelineT&	flipHorizontal();
+	//! Appends ip::blend() of \a foreground placed at \a offset. \a foreground is referenced rather than copied and must remain valid while the pipeline is run.
+	PipelineT&	blend( const SurfaceT<T> &foreground, const ivec2 &offset = ivec2() );
+	//! Appends ip::edgeDetectSobel(). The outermost rows and columns of the image, which edgeDetectSobel() does not write, are cleared to zero.
+	PipelineT&	edgeDetectSobel();
+	//! Appends ip::stackBlur() with \a radius.
+	PipelineT&	stackBlur( int radius );
+	//! Appends ip::hdrNormalize(). Only available for Surface32f pipelines.
+	template<typename U = T>
+	typename std::enable_if<std::is_same<U, float>::value, PipelineT&>::type	hdrNormalize()	{ return pushOp( Op( Op::HDR_NORMALIZE ) ); }
+
+	//! Sets the size of the tiles the image is divided into. Defaults to 256x256.
+	PipelineT&		tileSize( const ivec2 &size )	{ setTileSize( size ); return *this; }
+	//! Sets the size of the tiles the image is divided into. Defaults to 256x256.
+	void			setTileSize( const ivec2 &size );
+	//! Returns the size of the tiles the image is divided into.
+	const ivec2&	getTileSize() const				{ return mTileSize; }
+
+	//! Returns the number of recorded operations.
+	size_t	getNumOperations() const	{ return mOps.size(); }
+	//! Returns whether no operations have been recorded.
+	bool	isEmpty() const				{ return mOps.empty(); }
+	//! Removes all recorded operations.
+	void	clear()						{ mOps.clear(); }
+
+	//! Runs the pipeline on \a surface in-place.
+	void		run( SurfaceT<T> *surface ) const;
+	//! Runs the pipeline on \a srcSurface, storing the result in \a dstSurface, which must be the same size as \a srcSurface.
+	void		run( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const;
+	//! Returns the result of running the pipeline on a copy of \a srcSurface.
+	SurfaceT<T>	runCopy( const SurfaceT<T> &srcSurface ) const;
+
+  private:
+	struct Op {
+		enum Type { GRAYSCALE, THRESHOLD, PREMULTIPLY, UNPREMULTIPLY, FLIP_VERTICAL, FLIP_HORIZONTAL, BLEND, EDGE_DETECT_SOBEL, STACK_BLUR, HDR_NORMALIZE };
+
+		explicit Op( Type type ) : mType( type ), mValue( 0 ), mRadius( 0 ), mForeground( nullptr ) {}
+
+		Type				mType;
+		T					mValue;
+		int					mRadius;
+		const SurfaceT<T>	*mForeground;
+		ivec2				mOffset;
+	};
+
+	struct Pass;
+
+	PipelineT&	pushOp( const Op &op )	{ mOps.push_back( op ); return *this; }
+	void		runPass( const Pass &pass, const SurfaceT<T> &input, SurfaceT<T> *dst, float *minMax ) const;
+
+	std::vector<Op>		mOps;
+	ivec2				mTileSize;
+};
+
+typedef PipelineT<uint8_t>	Pipeline;
+typedef PipelineT<uint8_t>	Pipeline8u;
+typedef PipelineT<float>	Pipeline32f;
+
+} } // namespace cinder::ip
@@ -26,8 +26,64 @@
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 
+#include <type_traits>
+#include <vector>
+
 namespace cinder { namespace ip {
 
+//! Precomputed filter weights for resizing a fixed area of a source image into a fixed area of a destination image.
+//! Constructing a plan evaluates \a filter once per destination row and column; resize() can then be called repeatedly,
+//! and concurrently, on images of the planned sizes. Each call processes bands of destination rows in parallel on the
+//! default ThreadPool, using fixed-point SIMD kernels for 8-bit images and float SIMD kernels for 32-bit images.
+template<typename T>
+class CI_API ResizePlan {
+  public:
+	//! Weights are fixed-point (14 fractional bits) for 8-bit images and normalized floats for 32-bit images.
+	typedef typename std::conditional<std::is_integral<T>::value, int32_t, float>::type	WeightT;
+
+	//! Creates a plan for resizing the entirety of a \a srcSize image into the entirety of a \a dstSize image.
+	ResizePlan( const ivec2 &srcSize, const ivec2 &dstSize, const FilterBase &filter = FilterTriangle() );
+	//! Creates a plan for resizing \a srcArea of a \a srcSize image into \a dstArea of a \a dstSize image.
+	ResizePlan( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
+
+	//! Returns the size of the source images this plan expects.
+	const ivec2&	getSrcSize() const			{ return mSrcSize; }
+	//! Returns the size of the destination images this plan expects.
+	const ivec2&	getDstSize() const			{ return mDstSize; }
+	//! Returns the area of the destination which is written, after clipping against the source and destination bounds.
+	const Area&		getClippedDstArea() const	{ return mClippedDstArea; }
+
+	//! Resizes \a srcSurface into \a dstSurface. Both must match the sizes the plan was created with.
+	void	resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const;
+	//! Resizes \a srcChannel into \a dstChannel. Both must match the sizes the plan was created with.
+	void	resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const;
+
+	//! Filter weights of a single destination row or column, which reads the source samples [start, start + count).
+	struct Taps {
+		int32_t			start, count;
+		const WeightT	*weights;
+	};
+
+	//! Returns the horizontal filter taps of destination column \a x, relative to getClippedDstArea().
+	Taps	getColumnTaps( int32_t x ) const;
+	//! Returns the vertical filter taps of destination row \a y, relative to getClippedDstArea().
+	Taps	getRowTaps( int32_t y ) const;
+
+  private:
+	void	init( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter );
+	void	resample( const T *srcData, ptrdiff_t srcRowInc, ptrdiff_t srcPixelInc, T *dstData, ptrdiff_t dstRowInc, ptrdiff_t dstPixelInc, int numComponents ) const;
+
+	ivec2					mSrcSize, mDstSize;
+	Area					mClippedDstArea;
+	ivec2					mSrcOffset;
+	int32_t					mXWidth, mYWidth;
+	std::vector<int32_t>	mXStart, mXCount, mYStart, mYCount;
+	std::vector<WeightT>	mXWeights, mYWeights;
+	// 8-bit only: weights narrowed to 16 bits for the SIMD kernels, which are used when every intermediate value fits
+	bool					mFits16;
+	std::vector<int16_t>	mXWeights16, mYWeights16;
+};
+
 template<typename T>
 CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter = FilterTriangle() );
 template<typename T>
@@ -40,4 +96,11 @@ CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcAre
 template<typename T>
 CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
 
+//! Resizes \a srcSurface into \a dstSurface using the precomputed weights of \a plan.
+template<typename T>
+CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const ResizePlan<T> &plan );
+//! Resizes \a srcChannel into \a dstChannel using the precomputed weights of \a plan.
+template<typename T>
+CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const ResizePlan<T> &plan );
+
 } } // namespace cinder::ip
@@ -24,6 +24,7 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Surface.h"
+#include "cinder/ip/IntegralImage.h"
 
 #include <vector>
 
@@ -56,24 +57,31 @@ CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize );
 
 template<typename T>
 CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+//! Thresholds \a srcChannel against the mean of the \a windowSize x \a windowSize box centered on each pixel, which is read from \a integralImage and clipped to the image. Pixels below ( 1 - \a percentageDelta ) times the mean are set to zero and the rest to the maximum value.
+/** \a integralImage must have been calculated from \a srcChannel. The cost per pixel does not depend on \a windowSize, and rows are processed in parallel. **/
+template<typename T, typename SumT>
+CI_API void adaptiveThreshold( const IntegralImageT<SumT> &integralImage, const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
+//! Adaptively thresholds the luminance of \a srcSurface as adaptiveThreshold( const IntegralImageT<SumT>&, ... ) does, storing the result in the RGB channels of \a dstSurface.
+template<typename T>
+CI_API void adaptiveThreshold( const SurfaceT<T> &srcSurface, int32_t windowSize, float percentageDelta, SurfaceT<T> *dstSurface );
 
 template<typename T>
 class CI_API AdaptiveThresholdT {
   public:
+	typedef typename IntegralImageSum<T>::Type SumT;
+
 	AdaptiveThresholdT()	{}
 	//! Uses \a channel as source, but not assume ownership
 	AdaptiveThresholdT( const ChannelT<T> *channel );
 
 	void calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
 
- private:
-	typedef typename CHANTRAIT<T>::Accum SUMT;
+	//! Returns the integral image of the source Channel, which can be used for box filter queries.
+	const IntegralImageT<SumT>&	getIntegralImage() const	{ return mIntegralImage; }
 
-	const ChannelT<T>*	mChannel;
-	int32_t				mImageWidth;
-	int32_t				mImageHeight;
-	uint8_t				mIncrement;
-	std::vector<SUMT>	mIntegralImage;
+ private:
+	const ChannelT<T>*		mChannel;
+	IntegralImageT<SumT>	mIntegralImage;
 };
 
 typedef AdaptiveThresholdT<uint8_t>		AdaptiveThreshold;
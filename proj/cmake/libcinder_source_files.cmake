@@ -29,9 +29,12 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/GeomIo.cpp
 	${CINDER_SRC_DIR}/cinder/ImageFileTinyExr.cpp
 	${CINDER_SRC_DIR}/cinder/ImageIo.cpp
+	${CINDER_SRC_DIR}/cinder/ImageLoader.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileRadiance.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileStbImage.cpp
+	${CINDER_SRC_DIR}/cinder/ImageTargetFilePng.cpp
 	${CINDER_SRC_DIR}/cinder/ImageTargetFileStbImage.cpp
+	${CINDER_SRC_DIR}/cinder/ImageWriter.cpp
 	${CINDER_SRC_DIR}/cinder/Json.cpp
 	${CINDER_SRC_DIR}/cinder/Log.cpp
 	${CINDER_SRC_DIR}/cinder/Matrix.cpp
@@ -50,11 +53,13 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Surface.cpp
 	${CINDER_SRC_DIR}/cinder/System.cpp
 	${CINDER_SRC_DIR}/cinder/Text.cpp
+	${CINDER_SRC_DIR}/cinder/ThreadPool.cpp
 	${CINDER_SRC_DIR}/cinder/Timeline.cpp
 	${CINDER_SRC_DIR}/cinder/TimelineItem.cpp
 	${CINDER_SRC_DIR}/cinder/Timer.cpp
 	${CINDER_SRC_DIR}/cinder/Triangulate.cpp
 	${CINDER_SRC_DIR}/cinder/TriMesh.cpp
+	${CINDER_SRC_DIR}/cinder/MappedTriMesh.cpp
 	${CINDER_SRC_DIR}/cinder/Tween.cpp
 	${CINDER_SRC_DIR}/cinder/Unicode.cpp
 	${CINDER_SRC_DIR}/cinder/Url.cpp
@@ -99,11 +104,15 @@ if( NOT CINDER_DISABLE_AUDIO )
 	list( APPEND SRC_SET_CINDER_AUDIO
 		${CINDER_SRC_DIR}/cinder/audio/ChannelRouterNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Context.cpp
+		${CINDER_SRC_DIR}/cinder/audio/ContextOffline.cpp
+		${CINDER_SRC_DIR}/cinder/audio/ConvolverNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/DelayNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Device.cpp
 		${CINDER_SRC_DIR}/cinder/audio/FileOggVorbis.cpp
+		${CINDER_SRC_DIR}/cinder/audio/FileReadScheduler.cpp
 		${CINDER_SRC_DIR}/cinder/audio/FilterNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/GenNode.cpp
+		${CINDER_SRC_DIR}/cinder/audio/GraphScheduler.cpp
 		${CINDER_SRC_DIR}/cinder/audio/InputNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Node.cpp
 		${CINDER_SRC_DIR}/cinder/audio/NodeMath.cpp
@@ -122,6 +131,8 @@ if( NOT CINDER_DISABLE_AUDIO )
 
 	list( APPEND SRC_SET_CINDER_AUDIO_DSP
 		${CINDER_SRC_DIR}/cinder/audio/dsp/Biquad.cpp
+		${CINDER_SRC_DIR}/cinder/audio/dsp/BiquadCascade.cpp
+		${CINDER_SRC_DIR}/cinder/audio/dsp/Convolver.cpp
 		${CINDER_SRC_DIR}/cinder/audio/dsp/Converter.cpp
 		${CINDER_SRC_DIR}/cinder/audio/dsp/Dsp.cpp
 		${CINDER_SRC_DIR}/cinder/audio/dsp/Fft.cpp
@@ -140,6 +151,7 @@ endif()
 
 list( APPEND SRC_SET_CINDER_GL
 	${CINDER_SRC_DIR}/cinder/gl/Batch.cpp
+	${CINDER_SRC_DIR}/cinder/gl/Batch2d.cpp
 	${CINDER_SRC_DIR}/cinder/gl/BufferObj.cpp
 	${CINDER_SRC_DIR}/cinder/gl/BufferTexture.cpp
 	${CINDER_SRC_DIR}/cinder/gl/ConstantConversions.cpp
@@ -156,6 +168,7 @@ list( APPEND SRC_SET_CINDER_GL
 	${CINDER_SRC_DIR}/cinder/gl/Sampler.cpp
 	${CINDER_SRC_DIR}/cinder/gl/Shader.cpp
 	${CINDER_SRC_DIR}/cinder/gl/ShaderPreprocessor.cpp
+	${CINDER_SRC_DIR}/cinder/gl/StreamVbo.cpp
 	${CINDER_SRC_DIR}/cinder/gl/Sync.cpp
 	${CINDER_SRC_DIR}/cinder/gl/Texture.cpp
 	${CINDER_SRC_DIR}/cinder/gl/TextureFont.cpp
@@ -189,6 +202,8 @@ list( APPEND SRC_SET_CINDER_IP
 	${CINDER_SRC_DIR}/cinder/ip/EdgeDetect.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Flip.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Hdr.cpp
+	${CINDER_SRC_DIR}/cinder/ip/IntegralImage.cpp
+	${CINDER_SRC_DIR}/cinder/ip/Pipeline.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Resize.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Trim.cpp
 )
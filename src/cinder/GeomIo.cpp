@@ -31,7 +31,12 @@
 #include "cinder/BSpline.h"
 #include "cinder/Matrix.h"
 #include "cinder/Sphere.h"
+#include "cinder/ThreadPool.h"
 #include <algorithm>
+#include <list>
+#include <map>
+#include <mutex>
+#include <typeinfo>
 
 #if defined( CINDER_ANDROID )
   #include "cinder/app/App.h"
@@ -41,6 +46,68 @@ using namespace std;
 
 namespace cinder { namespace geom {
 
+namespace {
+
+// Sources with fewer vertices than this are generated on the calling thread, as distributing the work would cost more than it saves
+const size_t PARALLEL_MIN_VERTICES = 16384;
+
+// Calls \a fn( ringBegin, ringEnd ) for contiguous sub-ranges of [0, \a numRings), in parallel on the default ThreadPool when the geometry is large enough.
+// \a fn must only write the vertices and indices belonging to its own rings.
+void forEachRing( size_t numRings, size_t verticesPerRing, const std::function<void( size_t, size_t )> &fn )
+{
+	if( numRings < 2 || numRings * verticesPerRing < PARALLEL_MIN_VERTICES ) {
+		fn( 0, numRings );
+		return;
+	}
+
+	size_t minChunkSize = std::max<size_t>( 1, PARALLEL_MIN_VERTICES / 4 / std::max<size_t>( 1, verticesPerRing ) );
+	ThreadPool::getDefault()->parallelFor( 0, numRings, fn, minChunkSize );
+}
+
+// FNV-1a, used by the hashParams() implementations
+const uint64_t HASH_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t HASH_PRIME = 1099511628211ULL;
+
+void hashBytes( uint64_t *hash, const void *data, size_t numBytes )
+{
+	const uint8_t *bytes = static_cast<const uint8_t*>( data );
+	for( size_t i = 0; i < numBytes; i++ ) {
+		*hash ^= bytes[i];
+		*hash *= HASH_PRIME;
+	}
+}
+
+template<typename T>
+void hashValue( uint64_t *hash, const T &value )
+{
+	hashBytes( hash, &value, sizeof( T ) );
+}
+
+// Distinguishes Sources and Modifiers whose parameters happen to hash identically
+void hashType( uint64_t *hash, const std::type_info &type )
+{
+	hashValue( hash, type.hash_code() );
+}
+
+template<typename T>
+void hashVector( uint64_t *hash, const std::vector<T> &values )
+{
+	hashValue( hash, values.size() );
+	if( ! values.empty() )
+		hashBytes( hash, values.data(), values.size() * sizeof( T ) );
+}
+
+void hashPaths( uint64_t *hash, const std::vector<Path2d> &paths )
+{
+	hashValue( hash, paths.size() );
+	for( const auto &path : paths ) {
+		hashVector( hash, path.getSegments() );
+		hashVector( hash, path.getPoints() );
+	}
+}
+
+} // anonymous namespace
+
 std::string sAttribNames[(int)Attrib::NUM_ATTRIBS] = {
 	"POSITION", "COLOR", "TEX_COORD_0", "TEX_COORD_1", "TEX_COORD_2", "TEX_COORD_3",
 	"NORMAL", "TANGENT", "BITANGENT", "BONE_INDEX", "BONE_WEIGHT",
@@ -676,6 +743,16 @@ void Rect::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 		target->copyAttrib( Attrib::TANGENT, 3, 0, sRectTangents, 4 );
 }
 
+bool Rect::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mPositions );
+	hashValue( hash, mTexCoords );
+	hashValue( hash, mColors );
+	hashValue( hash, mHasColors );
+	return true;
+}
+
 uint8_t	Rect::getAttribDims( Attrib attr ) const
 {
 	switch( attr ) {
@@ -901,6 +978,18 @@ void RoundedRect::loadInto( cinder::geom::Target *target, const AttribSet &reque
 	if( bufferColors )
 		target->copyAttrib( geom::Attrib::COLOR, 4, 0, value_ptr( *colors.data() ), colors.size() );
 }
+
+bool RoundedRect::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mRectPositions );
+	hashValue( hash, mRectTexCoords );
+	hashValue( hash, mColors );
+	hashValue( hash, mHasColors );
+	hashValue( hash, mSubdivisions );
+	hashValue( hash, mCornerRadius );
+	return true;
+}
 	
 void RoundedRect::setDefaultColors()
 {
@@ -1086,6 +1175,16 @@ void Cube::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), getNumIndices(), calcIndicesRequiredBytes( getNumIndices() ) );
 }
 
+bool Cube::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mSubdivisions );
+	hashValue( hash, mSize );
+	hashValue( hash, mHasColors );
+	hashValue( hash, mColors );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Icosahedron
 
@@ -1213,6 +1312,13 @@ void Icosahedron::loadInto( Target *target, const AttribSet & /*requestedAttribs
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), 1 );
 }
 
+bool Icosahedron::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mHasColors );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Icosphere
 Icosphere::Icosphere()
@@ -1375,6 +1481,14 @@ void Icosphere::loadInto( Target *target, const AttribSet &requestedAttribs ) co
 	target->copyIndices( Primitive::TRIANGLES, mIndices.data(), mIndices.size(), 4 );
 }
 
+bool Icosphere::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mSubdivision );
+	hashValue( hash, mHasColors );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Teapot
 const uint8_t Teapot::sPatchIndices[][16] = {
@@ -1670,6 +1784,13 @@ void Teapot::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), mNumIndices, 4 );
 }
 
+bool Teapot::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mSubdivision );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Circle
 Circle::Circle()
@@ -1755,6 +1876,15 @@ void Circle::loadInto( Target *target, const AttribSet &/*requestedAttribs*/ ) c
 	target->copyAttrib( Attrib::TEX_COORD_0, 2, 0, (const float*)texCoords.data(), mNumVertices );
 }
 
+bool Circle::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadius );
+	hashValue( hash, mNumSubdivisions );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Ring
 Ring::Ring()
@@ -1847,6 +1977,16 @@ void Ring::loadInto( Target *target, const AttribSet &/*requestedAttribs*/ ) con
 	target->copyAttrib( Attrib::TEX_COORD_0, 2, 0, (const float*) texCoords.data(), mNumVertices );
 }
 
+bool Ring::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadius );
+	hashValue( hash, mWidth );
+	hashValue( hash, mNumSubdivisions );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Sphere
 
@@ -1881,7 +2021,7 @@ size_t Sphere::getNumIndices() const
 {
 	int numRings, numSegments;
 	numRingsAndSegments( &numRings, &numSegments );
-	return numSegments * numRings * 6;
+	return ( numSegments - 1 ) * ( numRings - 1 ) * 6;
 }
 
 uint8_t Sphere::getAttribDims( Attrib attr ) const
@@ -1923,38 +2063,43 @@ void Sphere::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	float segIncr = 1.0f / (float)( numSegments - 1 );
 	float radius = mRadius;
 
-	auto vertIt = positions.begin();
-	auto normIt = normals.begin();
-	auto texIt = texCoords.begin();
-	auto colorIt = colors.begin();
-	for( int r = 0; r < numRings; r++ ) {
-		float v = r * ringIncr;
-		for( int s = 0; s < numSegments; s++ ) {
-			float u = 1.0f - s * segIncr;
-			float x = math<float>::sin( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
-			float y = math<float>::sin( float(M_PI) * (v - 0.5f) );
-			float z = math<float>::cos( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
-
-			*vertIt++ = vec3( x * radius + mCenter.x, y * radius + mCenter.y, z * radius + mCenter.z );
-
-			*normIt++ = vec3( x, y, z );
-			*texIt++ = vec2( u, v );
-			*colorIt++ = vec3( x * 0.5f + 0.5f, y * 0.5f + 0.5f, z * 0.5f + 0.5f );
+	// each ring writes its own range of the buffers, so rings can be generated in parallel
+	forEachRing( numRings, numSegments, [&]( size_t ringBegin, size_t ringEnd ) {
+		auto vertIt = positions.begin() + ringBegin * numSegments;
+		auto normIt = normals.begin() + ringBegin * numSegments;
+		auto texIt = texCoords.begin() + ringBegin * numSegments;
+		auto colorIt = colors.begin() + ringBegin * numSegments;
+		for( int r = (int)ringBegin; r < (int)ringEnd; r++ ) {
+			float v = r * ringIncr;
+			for( int s = 0; s < numSegments; s++ ) {
+				float u = 1.0f - s * segIncr;
+				float x = math<float>::sin( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
+				float y = math<float>::sin( float(M_PI) * (v - 0.5f) );
+				float z = math<float>::cos( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
+
+				*vertIt++ = vec3( x * radius + mCenter.x, y * radius + mCenter.y, z * radius + mCenter.z );
+
+				*normIt++ = vec3( x, y, z );
+				*texIt++ = vec2( u, v );
+				*colorIt++ = vec3( x * 0.5f + 0.5f, y * 0.5f + 0.5f, z * 0.5f + 0.5f );
+			}
 		}
-	}
-
-	auto indexIt = indices.begin();
-	for( int r = 0; r < numRings - 1; r++ ) {
-		for( int s = 0; s < numSegments - 1 ; s++ ) {
-			*indexIt++ = (uint32_t)(r * numSegments + ( s + 1 ));
-			*indexIt++ = (uint32_t)(r * numSegments + s);
-			*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
-
-			*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + s);
-			*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
-			*indexIt++ = (uint32_t)(r * numSegments + s);
+	} );
+
+	forEachRing( numRings - 1, numSegments, [&]( size_t ringBegin, size_t ringEnd ) {
+		auto indexIt = indices.begin() + ringBegin * ( numSegments - 1 ) * 6;
+		for( int r = (int)ringBegin; r < (int)ringEnd; r++ ) {
+			for( int s = 0; s < numSegments - 1 ; s++ ) {
+				*indexIt++ = (uint32_t)(r * numSegments + ( s + 1 ));
+				*indexIt++ = (uint32_t)(r * numSegments + s);
+				*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
+
+				*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + s);
+				*indexIt++ = (uint32_t)(( r + 1 ) * numSegments + ( s + 1 ));
+				*indexIt++ = (uint32_t)(r * numSegments + s);
+			}
 		}
-	}
+	} );
 	
 	target->copyAttrib( Attrib::POSITION, 3, 0, value_ptr( *positions.data() ), positions.size() );
 	target->copyAttrib( Attrib::NORMAL, 3, 0, value_ptr( *normals.data() ), normals.size() );
@@ -1972,6 +2117,16 @@ void Sphere::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), 4 );
 }
 
+bool Sphere::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadius );
+	hashValue( hash, mSubdivisions );
+	hashValue( hash, mHasColors );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Capsule
 Capsule::Capsule()
@@ -2125,6 +2280,20 @@ void Capsule::loadInto( Target *target, const AttribSet &requestedAttribs ) cons
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), 4 );
 }
 
+bool Capsule::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mDirection );
+	hashValue( hash, mCenter );
+	hashValue( hash, mLength );
+	hashValue( hash, mRadius );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mNumSegments );
+	hashValue( hash, mHasColors );
+	return true;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // Torus
@@ -2160,12 +2329,12 @@ size_t Torus::getNumIndices() const
 
 void Torus::calculate( vector<vec3> *positions, vector<vec3> *normals, vector<vec2> *texCoords, vector<vec3> *colors, vector<uint32_t> *indices ) const
 {
-	positions->reserve( mNumAxis * mNumRings );
-	normals->reserve( mNumAxis * mNumRings );
-	texCoords->reserve( mNumAxis * mNumRings );
+	positions->resize( mNumAxis * mNumRings );
+	normals->resize( mNumAxis * mNumRings );
+	texCoords->resize( mNumAxis * mNumRings );
 	if( colors )
-		colors->reserve( mNumAxis * mNumRings );
-	indices->reserve( (mNumAxis - 1) * (mNumRings - 1) * 6 );
+		colors->resize( mNumAxis * mNumRings );
+	indices->resize( (mNumAxis - 1) * (mNumRings - 1) * 6 );
 
 	float majorIncr = 1.0f / (mNumAxis - 1);
 	float minorIncr = 1.0f / (mNumRings - 1);
@@ -2174,43 +2343,65 @@ void Torus::calculate( vector<vec3> *positions, vector<vec3> *normals, vector<ve
 	float twist = angle * mTwist * minorIncr * majorIncr;
 
 	// vertex, normal, tex coord and color buffers
-	for( int i = 0; i < mNumAxis; ++i ) {
-		float phi = i * majorIncr * angle;
-		float cosPhi = -math<float>::cos( phi );
-		float sinPhi =  math<float>::sin( phi );
-
-		for( int j = 0; j < mNumRings; ++j ) {
-			float theta = j * minorIncr * float(M_PI * 2) + i * twist + mTwistOffset;
-			float cosTheta = -math<float>::cos( theta );
-			float sinTheta =  math<float>::sin( theta );
-
-			float r = mRadiusMinor + cosTheta * radiusDiff;
-			float x = r * cosPhi;
-			float y = i * majorIncr * mHeight + sinTheta * radiusDiff;
-			float z = r * sinPhi;
-
-			positions->emplace_back( mCenter + vec3( x, y, z ) );
-			texCoords->emplace_back( i * majorIncr, j * minorIncr );
-			normals->emplace_back( cosPhi * cosTheta, sinTheta, sinPhi * cosTheta );
-
-			const vec3 &n = normals->back();
-			if( colors )
-				colors->emplace_back( n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f, n.z * 0.5f + 0.5f );
+	forEachRing( mNumAxis, mNumRings, [&]( size_t axisBegin, size_t axisEnd ) {
+		for( int i = (int)axisBegin; i < (int)axisEnd; ++i ) {
+			float phi = i * majorIncr * angle;
+			float cosPhi = -math<float>::cos( phi );
+			float sinPhi =  math<float>::sin( phi );
+
+			for( int j = 0; j < mNumRings; ++j ) {
+				float theta = j * minorIncr * float(M_PI * 2) + i * twist + mTwistOffset;
+				float cosTheta = -math<float>::cos( theta );
+				float sinTheta =  math<float>::sin( theta );
+
+				float r = mRadiusMinor + cosTheta * radiusDiff;
+				float x = r * cosPhi;
+				float y = i * majorIncr * mHeight + sinTheta * radiusDiff;
+				float z = r * sinPhi;
+
+				size_t idx = i * mNumRings + j;
+				( *positions )[idx] = mCenter + vec3( x, y, z );
+				( *texCoords )[idx] = vec2( i * majorIncr, j * minorIncr );
+				( *normals )[idx] = vec3( cosPhi * cosTheta, sinTheta, sinPhi * cosTheta );
+
+				const vec3 &n = ( *normals )[idx];
+				if( colors )
+					( *colors )[idx] = vec3( n.x * 0.5f + 0.5f, n.y * 0.5f + 0.5f, n.z * 0.5f + 0.5f );
+			}
 		}
-	}
+	} );
 
 	// index buffer
-	for( int i = 0; i < mNumAxis - 1; ++i ) {
-		for ( int j = 0; j < mNumRings - 1; ++j ) {
-			indices->push_back( (uint32_t)((i + 0) * mNumRings + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumRings + (j + 1)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumRings + (j + 0)) );
-
-			indices->push_back( (uint32_t)((i + 0) * mNumRings + (j + 0)) );
-			indices->push_back( (uint32_t)((i + 0) * mNumRings + (j + 1)) );
-			indices->push_back( (uint32_t)((i + 1) * mNumRings + (j + 1)) );
+	forEachRing( mNumAxis - 1, mNumRings, [&]( size_t axisBegin, size_t axisEnd ) {
+		auto indexIt = indices->begin() + axisBegin * ( mNumRings - 1 ) * 6;
+		for( int i = (int)axisBegin; i < (int)axisEnd; ++i ) {
+			for ( int j = 0; j < mNumRings - 1; ++j ) {
+				*indexIt++ = (uint32_t)((i + 0) * mNumRings + (j + 0));
+				*indexIt++ = (uint32_t)((i + 1) * mNumRings + (j + 1));
+				*indexIt++ = (uint32_t)((i + 1) * mNumRings + (j + 0));
+
+				*indexIt++ = (uint32_t)((i + 0) * mNumRings + (j + 0));
+				*indexIt++ = (uint32_t)((i + 0) * mNumRings + (j + 1));
+				*indexIt++ = (uint32_t)((i + 1) * mNumRings + (j + 1));
+			}
 		}
-	}
+	} );
+}
+
+bool Torus::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadiusMajor );
+	hashValue( hash, mRadiusMinor );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mHeight );
+	hashValue( hash, mCoils );
+	hashValue( hash, mTwist );
+	hashValue( hash, mTwistOffset );
+	hashValue( hash, mHasColors );
+	return true;
 }
 
 uint8_t Torus::getAttribDims( Attrib attr ) const
@@ -2332,52 +2523,69 @@ void TorusKnot::calculate( std::vector<vec3> *positions, std::vector<vec3> *norm
 	int _p = ( divider != 0 ) ? mP / divider : 1;
 	int _q = ( divider != 0 ) ? mQ / divider : 0;
 
-	for( int i = 0; i <= mSubdivisionsHeight; ++i ) {
-		float p = _p * i * stepHeight;
-		float q = _q * i * stepHeight;
-		float r = 0.5f * ( 2.0f + glm::cos( q ) );
-		vec3 center( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
-
-		p = _p * ( i + 1 ) * stepHeight;
-		q = _q * ( i + 1 ) * stepHeight;
-		r = 0.5f * ( 2.0f + glm::cos( q ) );
-		vec3 next( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
-
-		vec3 T = normalize( next - center );
-		vec3 B = normalize( cross( T, next + center ) );
-		vec3 N = normalize( cross( B, T ) );
-
-		for( int j = 0; j <= mSubdivisionsAxis; ++j ) {
-			float x = glm::cos( j * stepAxis ) * mRadius;
-			float y = glm::sin( j * stepAxis ) * mRadius;
-
-			int idx = i * ( mSubdivisionsAxis + 1 ) + j;
-			( *normals )[idx] = B * x + N * y;
-			( *positions )[idx] = ( *normals )[idx] + center;
-			( *normals )[idx] = glm::normalize( ( *normals )[idx] );
-			( *texCoords )[idx].y = float( j ) / mSubdivisionsAxis;
-			( *texCoords )[idx].x = float( i ) / mSubdivisionsHeight;
-
-			if( tangents )
-				( *tangents )[idx] = T; 
+	forEachRing( mSubdivisionsHeight + 1, mSubdivisionsAxis + 1, [&]( size_t ringBegin, size_t ringEnd ) {
+		for( int i = (int)ringBegin; i < (int)ringEnd; ++i ) {
+			float p = _p * i * stepHeight;
+			float q = _q * i * stepHeight;
+			float r = 0.5f * ( 2.0f + glm::cos( q ) );
+			vec3 center( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
+
+			p = _p * ( i + 1 ) * stepHeight;
+			q = _q * ( i + 1 ) * stepHeight;
+			r = 0.5f * ( 2.0f + glm::cos( q ) );
+			vec3 next( r * glm::sin( p ) * mScale.x, r * glm::sin( q ) * mScale.y, r * glm::cos( p ) * mScale.z );
+
+			vec3 T = normalize( next - center );
+			vec3 B = normalize( cross( T, next + center ) );
+			vec3 N = normalize( cross( B, T ) );
+
+			for( int j = 0; j <= mSubdivisionsAxis; ++j ) {
+				float x = glm::cos( j * stepAxis ) * mRadius;
+				float y = glm::sin( j * stepAxis ) * mRadius;
+
+				int idx = i * ( mSubdivisionsAxis + 1 ) + j;
+				( *normals )[idx] = B * x + N * y;
+				( *positions )[idx] = ( *normals )[idx] + center;
+				( *normals )[idx] = glm::normalize( ( *normals )[idx] );
+				( *texCoords )[idx].y = float( j ) / mSubdivisionsAxis;
+				( *texCoords )[idx].x = float( i ) / mSubdivisionsHeight;
+
+				if( tangents )
+					( *tangents )[idx] = T; 
 			
-			if( colors )
-				( *colors )[idx] = ( *normals )[idx] * 0.5f + 0.5f;
+				if( colors )
+					( *colors )[idx] = ( *normals )[idx] * 0.5f + 0.5f;
+			}
 		}
-	}
+	} );
 
 	int nAxis = mSubdivisionsAxis + 1;
-	for( int j = 0; j < mSubdivisionsAxis; j++ ) {
-		for( int i = 0; i < mSubdivisionsHeight; i++ ) {
-			int idx = 6 * ( j * mSubdivisionsHeight + i );
-			( *indices )[idx + 0] = ( j + i * nAxis );
-			( *indices )[idx + 1] = ( j + ( i + 1 ) * nAxis );
-			( *indices )[idx + 2] = ( ( j + 1 ) + i * nAxis );
-			( *indices )[idx + 3] = ( ( j + 1 ) + i * nAxis );
-			( *indices )[idx + 4] = ( j + ( i + 1 ) * nAxis );
-			( *indices )[idx + 5] = ( ( j + 1 ) + ( i + 1 ) * nAxis );
+	forEachRing( mSubdivisionsAxis, mSubdivisionsHeight + 1, [&]( size_t axisBegin, size_t axisEnd ) {
+		for( int j = (int)axisBegin; j < (int)axisEnd; j++ ) {
+			for( int i = 0; i < mSubdivisionsHeight; i++ ) {
+				int idx = 6 * ( j * mSubdivisionsHeight + i );
+				( *indices )[idx + 0] = ( j + i * nAxis );
+				( *indices )[idx + 1] = ( j + ( i + 1 ) * nAxis );
+				( *indices )[idx + 2] = ( ( j + 1 ) + i * nAxis );
+				( *indices )[idx + 3] = ( ( j + 1 ) + i * nAxis );
+				( *indices )[idx + 4] = ( j + ( i + 1 ) * nAxis );
+				( *indices )[idx + 5] = ( ( j + 1 ) + ( i + 1 ) * nAxis );
+			}
 		}
-	}
+	} );
+}
+
+bool TorusKnot::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mP );
+	hashValue( hash, mQ );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mScale );
+	hashValue( hash, mRadius );
+	hashValue( hash, mHasColors );
+	return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////
@@ -2585,6 +2793,21 @@ void Cylinder::loadInto( Target *target, const AttribSet &requestedAttribs ) con
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), 4 );
 }
 
+bool Cylinder::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mOrigin );
+	hashValue( hash, mHeight );
+	hashValue( hash, mDirection );
+	hashValue( hash, mRadiusBase );
+	hashValue( hash, mRadiusApex );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mSubdivisionsCap );
+	hashValue( hash, mHasColors );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Plane
 Plane::Plane()
@@ -2698,6 +2921,17 @@ void Plane::loadInto( Target *target, const AttribSet &requestedAttribs ) const
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), 4 );
 }
 
+bool Plane::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mSubdivisions );
+	hashValue( hash, mSize );
+	hashValue( hash, mOrigin );
+	hashValue( hash, mAxisU );
+	hashValue( hash, mAxisV );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Transform
 uint8_t	Transform::getAttribDims( Attrib attr, uint8_t upstreamDims ) const
@@ -2758,8 +2992,25 @@ void Transform::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 		CI_LOG_W( "Unsupported dimension for geom::TANGENT passed to geom::Transform" );
 }
 
+bool Transform::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mTransform );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Twist
+bool Twist::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mAxisStart );
+	hashValue( hash, mAxisEnd );
+	hashValue( hash, mStartAngle );
+	hashValue( hash, mEndAngle );
+	return true;
+}
+
 void Twist::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -2832,6 +3083,12 @@ size_t Lines::calcNumIndices( Primitive primitive, size_t upstreamNumIndices, si
 	}
 }
 
+bool Lines::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	return true;
+}
+
 void Lines::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -3073,6 +3330,15 @@ void Constant::process( SourceModsContext *ctx, const AttribSet &requestedAttrib
 	}
 }
 
+bool Constant::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mAttrib );
+	hashValue( hash, mValue );
+	hashValue( hash, mDims );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // AttribFn
 template<typename S, typename D>
@@ -3315,6 +3581,18 @@ void Extrude::loadInto( Target *target, const AttribSet &requestedAttribs ) cons
 	target->copyIndices( Primitive::TRIANGLES, indices.data(), indices.size(), calcIndicesRequiredBytes( indices.size() ) );
 }
 
+bool Extrude::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashPaths( hash, mPaths );
+	hashValue( hash, mApproximationScale );
+	hashValue( hash, mDistance );
+	hashValue( hash, mFrontCap );
+	hashValue( hash, mBackCap );
+	hashValue( hash, mSubdivisions );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Extrude
 ExtrudeSpline::ExtrudeSpline( const Shape2d &shape, const ci::BSpline<3,float> &spline, int splineSubdivisions, float approximationScale )
@@ -3427,34 +3705,61 @@ void ExtrudeSpline::calculate( vector<vec3> *positions, vector<vec3> *normals, v
 	}
 
 	// EXTRUSION
-	for( size_t p = 0; p < mPathSubdivisionPositions.size(); ++p ) {
-		for( int sub = 0; sub <= mSubdivisions; ++sub ) {
-			const mat4 &transform = mSplineFrames[sub] * glm::scale( vec3( mThicknessFn( static_cast<float>( sub ) / static_cast<float>( mSubdivisions ) ) ) );
+	// the thickness function is user supplied and may not be thread-safe, so it's evaluated up front
+	vector<mat4> transforms( mSubdivisions + 1 );
+	for( int sub = 0; sub <= mSubdivisions; ++sub )
+		transforms[sub] = mSplineFrames[sub] * glm::scale( vec3( mThicknessFn( static_cast<float>( sub ) / static_cast<float>( mSubdivisions ) ) ) );
+
+	// every ring of every path has a fixed place in the buffers, which allows them to be generated in parallel
+	const size_t numPaths = mPathSubdivisionPositions.size();
+	const size_t ringsPerPath = mSubdivisions + 1;
+	vector<size_t> pathBaseVertex( numPaths ), pathBaseIndex( numPaths );
+	size_t numVertices = positions->size(), numIndices = indices->size();
+	for( size_t p = 0; p < numPaths; ++p ) {
+		pathBaseVertex[p] = numVertices;
+		pathBaseIndex[p] = numIndices;
+		numVertices += mPathSubdivisionPositions[p].size() * ringsPerPath;
+		numIndices += 6 * mPathSubdivisionPositions[p].size() * mSubdivisions;
+	}
+	const size_t numExtrusionVertices = numVertices - positions->size();
+	positions->resize( numVertices );
+	normals->resize( numVertices );
+	texCoords->resize( numVertices );
+	indices->resize( numIndices );
+
+	const size_t numRings = numPaths * ringsPerPath;
+	forEachRing( numRings, numRings ? numExtrusionVertices / numRings : 0, [&]( size_t ringBegin, size_t ringEnd ) {
+		for( size_t ring = ringBegin; ring < ringEnd; ++ring ) {
+			const size_t p = ring / ringsPerPath;
+			const int sub = int( ring % ringsPerPath );
+			const mat4 &transform = transforms[sub];
 			const auto &pathPositions = mPathSubdivisionPositions[p];
 			const auto &pathTangents = mPathSubdivisionTangents[p];
 			// add all the positions & normals
-			uint32_t baseIndex = (uint32_t)positions->size();
+			const size_t baseVertex = pathBaseVertex[p] + sub * pathPositions.size();
 			for( size_t v = 0; v < pathPositions.size(); ++v ) {
-				positions->emplace_back( vec3( transform * vec4( pathPositions[v], 0, 1 ) ) );
-				normals->emplace_back( transform * vec4( vec2( pathTangents[v].y, -pathTangents[v].x ), 0, 0 ) );
-				texCoords->emplace_back( (float) v / (float) ( pathPositions.size() ),
+				( *positions )[baseVertex + v] = vec3( transform * vec4( pathPositions[v], 0, 1 ) );
+				( *normals )[baseVertex + v] = vec3( transform * vec4( vec2( pathTangents[v].y, -pathTangents[v].x ), 0, 0 ) );
+				( *texCoords )[baseVertex + v] = vec3( (float) v / (float) ( pathPositions.size() ),
 										mSplineTimes[sub] * mSplineLength / mPathSubdivisionLengths[p],
 										1 ); // the uv z-component allows to differentiate caps and extrusion
 			}
 			// add the indices
 			if( sub != mSubdivisions ) {
+				uint32_t baseIndex = (uint32_t)baseVertex;
 				uint32_t numSubdivVerts = (uint32_t)pathPositions.size();
+				auto indexIt = indices->begin() + pathBaseIndex[p] + sub * 6 * pathPositions.size();
 				for( uint32_t j = numSubdivVerts-1, i = 0; i < numSubdivVerts; j = i++ ) {
-					indices->push_back( baseIndex + i );
-					indices->push_back( baseIndex + j );
-					indices->push_back( baseIndex + numSubdivVerts + j );
-					indices->push_back( baseIndex + i );
-					indices->push_back( baseIndex + numSubdivVerts + j );
-					indices->push_back( baseIndex + numSubdivVerts + i );
+					*indexIt++ = baseIndex + i;
+					*indexIt++ = baseIndex + j;
+					*indexIt++ = baseIndex + numSubdivVerts + j;
+					*indexIt++ = baseIndex + i;
+					*indexIt++ = baseIndex + numSubdivVerts + j;
+					*indexIt++ = baseIndex + numSubdivVerts + i;
 				}
 			}
 		}
-	}
+	} );
 }
 	
 size_t ExtrudeSpline::getNumVertices() const
@@ -3599,6 +3904,16 @@ void BSpline::loadInto( Target *target, const AttribSet & /*requestedAttribs*/ )
 	target->copyAttrib( Attrib::NORMAL, 3, 0, (const float*)mNormals.data(), mNumVertices );
 }
 
+bool BSpline::hashParams( uint64_t *hash ) const
+{
+	// the spline is evaluated on construction, so the sampled positions and normals are its parameters
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mPositionDims );
+	hashVector( hash, mPositions );
+	hashVector( hash, mNormals );
+	return true;
+}
+
 template CI_API BSpline::BSpline( const ci::BSpline<2, float>&, int );
 template CI_API BSpline::BSpline( const ci::BSpline<3, float>&, int );
 
@@ -3699,6 +4014,19 @@ void WireCapsule::loadInto( Target *target, const AttribSet &/*requestedAttribs*
 	target->copyAttrib( Attrib::POSITION, 3, 0, value_ptr( *positions.data() ), positions.size() );
 }
 
+bool WireCapsule::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mDirection );
+	hashValue( hash, mCenter );
+	hashValue( hash, mLength );
+	hashValue( hash, mRadius );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mNumSegments );
+	return true;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireCircle
@@ -3731,6 +4059,15 @@ void WireCircle::loadInto( Target *target, const AttribSet &/*requestedAttribs*/
 
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), numVertices );
 }
+
+bool WireCircle::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadius );
+	hashValue( hash, mNumSegments );
+	return true;
+}
 	
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireRoundedRect
@@ -3805,6 +4142,15 @@ void WireRoundedRect::loadInto( cinder::geom::Target *target, const AttribSet &
 	target->copyAttrib( geom::Attrib::POSITION, 2, 0, value_ptr( *verts.data() ), verts.size() );
 }
 
+bool WireRoundedRect::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mRectPositions );
+	hashValue( hash, mCornerSubdivisions );
+	hashValue( hash, mCornerRadius );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireRect
 WireRect::WireRect()
@@ -3837,6 +4183,13 @@ void WireRect::loadInto( Target *target, const AttribSet & /*requestedAttribs*/
 	target->copyAttrib( Attrib::POSITION, 2, 0, (const float*)mPositions.data(), 5 );
 }
 
+bool WireRect::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mPositions );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireCube
 void WireCube::loadInto( Target *target, const AttribSet & /*requestedAttribs*/ ) const
@@ -3916,6 +4269,14 @@ void WireCube::loadInto( Target *target, const AttribSet & /*requestedAttribs*/
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), numVertices );
 }
 
+bool WireCube::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mSubdivisions );
+	hashValue( hash, mSize );
+	return true;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireCylinder
@@ -3980,6 +4341,19 @@ void WireCylinder::loadInto( Target *target, const AttribSet & /*requestedAttrib
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), numVertices );
 }
 
+bool WireCylinder::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mOrigin );
+	hashValue( hash, mHeight );
+	hashValue( hash, mDirection );
+	hashValue( hash, mRadiusBase );
+	hashValue( hash, mRadiusApex );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mSubdivisionsHeight );
+	return true;
+}
+
 std::vector<vec3> WireIcosahedron::sPositions;
 
 size_t WireIcosahedron::getNumVertices() const
@@ -3993,6 +4367,12 @@ void WireIcosahedron::loadInto( Target * target, const AttribSet & /*requestedAt
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) sPositions.data(), 120 );
 }
 
+bool WireIcosahedron::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	return true;
+}
+
 void WireIcosahedron::calculate() const
 {
 	if( sPositions.empty() ) {
@@ -4056,6 +4436,20 @@ void WireFrustum::loadInto( Target *target, const AttribSet & /*requestedAttribs
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), numVertices );
 }
 
+bool WireFrustum::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, ntl );
+	hashValue( hash, ntr );
+	hashValue( hash, nbl );
+	hashValue( hash, nbr );
+	hashValue( hash, ftl );
+	hashValue( hash, ftr );
+	hashValue( hash, fbl );
+	hashValue( hash, fbr );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // WirePlane
 WirePlane& WirePlane::subdivisions( const ivec2 &subdivisions )
@@ -4116,6 +4510,17 @@ void WirePlane::loadInto( Target *target, const AttribSet & /*requestedAttribs*/
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), numVertices );
 }
 
+bool WirePlane::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mSubdivisions );
+	hashValue( hash, mSize );
+	hashValue( hash, mOrigin );
+	hashValue( hash, mAxisU );
+	hashValue( hash, mAxisV );
+	return true;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireSphere
@@ -4165,6 +4570,17 @@ void WireSphere::loadInto( Target *target, const AttribSet & /*requestedAttribs*
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), positions.size() );
 }
 
+bool WireSphere::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadius );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mNumSegments );
+	return true;
+}
+
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // WireTorus
@@ -4224,6 +4640,18 @@ void WireTorus::loadInto( Target *target, const AttribSet & /*requestedAttribs*/
 	target->copyAttrib( Attrib::POSITION, 3, 0, (const float*) positions.data(), numVertices );
 }
 
+bool WireTorus::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mCenter );
+	hashValue( hash, mRadiusMajor );
+	hashValue( hash, mRadiusMinor );
+	hashValue( hash, mSubdivisionsAxis );
+	hashValue( hash, mSubdivisionsHeight );
+	hashValue( hash, mNumSegments );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // VertexNormalLines
 VertexNormalLines::VertexNormalLines( float length, Attrib attrib )
@@ -4338,6 +4766,14 @@ void VertexNormalLines::process( SourceModsContext *ctx, const AttribSet &reques
 	ctx->clearIndices();
 }
 
+bool VertexNormalLines::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mLength );
+	hashValue( hash, mAttrib );
+	return true;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////
 // Tangents
 uint8_t Tangents::getAttribDims( Attrib attr, uint8_t upstreamDims ) const
@@ -4356,6 +4792,12 @@ AttribSet Tangents::getAvailableAttribs( const Modifier::Params &upstreamParams
 	return result;
 }
 
+bool Tangents::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	return true;
+}
+
 void Tangents::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	AttribSet request = requestedAttribs;
@@ -4402,6 +4844,13 @@ void Tangents::process( SourceModsContext *ctx, const AttribSet &requestedAttrib
 
 ///////////////////////////////////////////////////////////////////////////////////////
 // Invert
+bool Invert::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mAttrib );
+	return true;
+}
+
 void Invert::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -4436,6 +4885,13 @@ AttribSet Remove::getAvailableAttribs( const Modifier::Params &upstreamParams )
 	return result;
 }
 
+bool Remove::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	hashValue( hash, mAttrib );
+	return true;
+}
+
 void Remove::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	ctx->processUpstream( requestedAttribs );
@@ -4549,6 +5005,12 @@ size_t Subdivide::getNumIndices( const Modifier::Params &upstreamParams ) const
 		return upstreamParams.getNumIndices();
 }
 
+bool Subdivide::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	return true;
+}
+
 void Subdivide::process( SourceModsContext *ctx, const AttribSet &requestedAttribs ) const
 {
 	AttribSet request = requestedAttribs;
@@ -4623,9 +5085,193 @@ void Subdivide::process( SourceModsContext *ctx, const AttribSet &requestedAttri
 
 //////////////////////////////////////////////////////////////////////////////////////
 // SourceMods
+namespace {
+
+// The output of a SourceMods::loadInto(), recorded so that it can be replayed into any Target
+class GeometryCapture : public Target {
+  public:
+	GeometryCapture( const SourceMods *sourceMods )
+		: mSourceMods( sourceMods ), mHasIndices( false ), mPrimitive( Primitive::TRIANGLES ), mRequiredBytesPerIndex( 4 )
+	{}
+
+	uint8_t	getAttribDims( Attrib attr ) const override
+	{
+		return mSourceMods->getAttribDims( attr );
+	}
+
+	void copyAttrib( Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override
+	{
+		mAttribs.emplace_back();
+		auto &attrib = mAttribs.back();
+		attrib.mAttrib = attr;
+		attrib.mDims = dims;
+		attrib.mCount = count;
+		attrib.mData.resize( dims * count );
+		copyData( dims, strideBytes, srcData, count, dims, 0, attrib.mData.data() );
+	}
+
+	void copyIndices( Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t requiredBytesPerIndex ) override
+	{
+		mHasIndices = true;
+		mPrimitive = primitive;
+		mRequiredBytesPerIndex = requiredBytesPerIndex;
+		mIndices.assign( source, source + numIndices );
+	}
+
+	void replay( Target *target ) const
+	{
+		for( const auto &attrib : mAttribs )
+			target->copyAttrib( attrib.mAttrib, attrib.mDims, 0, attrib.mData.data(), attrib.mCount );
+		if( mHasIndices )
+			target->copyIndices( mPrimitive, mIndices.data(), mIndices.size(), mRequiredBytesPerIndex );
+	}
+
+	// only valid while capturing
+	const SourceMods	*mSourceMods;
+
+  private:
+	struct AttribData {
+		Attrib				mAttrib;
+		uint8_t				mDims;
+		size_t				mCount;
+		std::vector<float>	mData;
+	};
+
+	std::vector<AttribData>	mAttribs;
+	bool					mHasIndices;
+	Primitive				mPrimitive;
+	uint8_t					mRequiredBytesPerIndex;
+	std::vector<uint32_t>	mIndices;
+};
+
+// Identifies cached geometry. Entries are found by mHash, the remaining members are compared so that a collision is a miss.
+struct GeometryCacheKey {
+	uint64_t							mHash;
+	std::vector<const std::type_info*>	mTypes;
+	AttribSet							mRequestedAttribs;
+	std::vector<uint8_t>				mAttribDims;
+	size_t								mNumVertices, mNumIndices;
+	Primitive							mPrimitive;
+
+	bool matches( const GeometryCacheKey &rhs ) const
+	{
+		if( mHash != rhs.mHash || mRequestedAttribs != rhs.mRequestedAttribs || mAttribDims != rhs.mAttribDims
+				|| mNumVertices != rhs.mNumVertices || mNumIndices != rhs.mNumIndices || mPrimitive != rhs.mPrimitive || mTypes.size() != rhs.mTypes.size() )
+			return false;
+
+		for( size_t i = 0; i < mTypes.size(); i++ ) {
+			if( *mTypes[i] != *rhs.mTypes[i] )
+				return false;
+		}
+
+		return true;
+	}
+};
+
+// Process-wide least recently used cache of captured geometry, keyed by the hash of a SourceMods' parameters and requested attributes
+class GeometryCache {
+  public:
+	GeometryCache()
+		: mCapacity( 32 )
+	{}
+
+	std::shared_ptr<const GeometryCapture> find( const GeometryCacheKey &key )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto it = mLookup.find( key.mHash );
+		if( it == mLookup.end() || ! it->second->mKey.matches( key ) )
+			return nullptr;
+
+		// move to the front, which holds the most recently used entry
+		mEntries.splice( mEntries.begin(), mEntries, it->second );
+		return it->second->mGeometry;
+	}
+
+	void insert( const GeometryCacheKey &key, const std::shared_ptr<const GeometryCapture> &geometry )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		auto it = mLookup.find( key.mHash );
+		if( it != mLookup.end() ) {
+			// another thread loaded the same geometry concurrently, or the hash collided, in which case the newer geometry replaces the older
+			it->second->mKey = key;
+			it->second->mGeometry = geometry;
+			mEntries.splice( mEntries.begin(), mEntries, it->second );
+			return;
+		}
+
+		mEntries.push_front( Entry{ key, geometry } );
+		mLookup[key.mHash] = mEntries.begin();
+		evict();
+	}
+
+	void clear()
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mEntries.clear();
+		mLookup.clear();
+	}
+
+	void setCapacity( size_t numEntries )
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mCapacity = numEntries;
+		evict();
+	}
+
+	size_t getSize()
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		return mEntries.size();
+	}
+
+  private:
+	struct Entry {
+		GeometryCacheKey						mKey;
+		std::shared_ptr<const GeometryCapture>	mGeometry;
+	};
+	typedef std::list<Entry>	EntryList;
+
+	void evict()
+	{
+		while( mEntries.size() > mCapacity ) {
+			mLookup.erase( mEntries.back().mKey.mHash );
+			mEntries.pop_back();
+		}
+	}
+
+	std::mutex							mMutex;
+	size_t								mCapacity;
+	EntryList							mEntries;
+	std::map<uint64_t, EntryList::iterator>	mLookup;
+};
+
+GeometryCache* getGeometryCache()
+{
+	static GeometryCache sCache;
+	return &sCache;
+}
+
+} // anonymous namespace
+
+void SourceMods::clearCache()
+{
+	getGeometryCache()->clear();
+}
+
+void SourceMods::setCacheCapacity( size_t numEntries )
+{
+	getGeometryCache()->setCapacity( numEntries );
+}
+
+size_t SourceMods::getCacheSize()
+{
+	return getGeometryCache()->getSize();
+}
+
 void SourceMods::copyImpl( const SourceMods &rhs )
 {
 	mVariablesCached = false;
+	mCacheEnabled = rhs.mCacheEnabled;
 	mChildren.clear();
 	mModifiers.clear();
 	mSourceStorage.reset();
@@ -4755,7 +5401,77 @@ void SourceMods::cacheVariables() const
 	}
 }
 
+bool SourceMods::hashParams( uint64_t *hash ) const
+{
+	hashType( hash, typeid( *this ) );
+	if( mSourcePtr ) {
+		if( ! mSourcePtr->hashParams( hash ) )
+			return false;
+
+		hashValue( hash, mModifiers.size() );
+		for( auto &modifier : mModifiers ) {
+			if( ! modifier->hashParams( hash ) )
+				return false;
+		}
+	}
+	else {
+		hashValue( hash, mChildren.size() );
+		for( auto &child : mChildren ) {
+			if( ! child->hashParams( hash ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+void SourceMods::appendTypes( std::vector<const std::type_info*> *types ) const
+{
+	if( mSourcePtr ) {
+		types->push_back( &typeid( *mSourcePtr ) );
+		for( auto &modifier : mModifiers )
+			types->push_back( &typeid( *modifier ) );
+	}
+	else {
+		for( auto &child : mChildren )
+			child->appendTypes( types );
+	}
+}
+
 void SourceMods::loadInto( Target *target, const AttribSet &requestedAttribs ) const
+{
+	GeometryCacheKey key;
+	key.mHash = HASH_OFFSET_BASIS;
+	if( ! mCacheEnabled || ! hashParams( &key.mHash ) ) {
+		loadIntoImpl( target, requestedAttribs );
+		return;
+	}
+
+	for( auto attrib : requestedAttribs ) {
+		hashValue( &key.mHash, attrib );
+		key.mAttribDims.push_back( getAttribDims( attrib ) );
+	}
+
+	appendTypes( &key.mTypes );
+	key.mRequestedAttribs = requestedAttribs;
+	key.mNumVertices = getNumVertices();
+	key.mNumIndices = getNumIndices();
+	key.mPrimitive = getPrimitive();
+
+	auto cache = getGeometryCache();
+	auto geometry = cache->find( key );
+	if( ! geometry ) {
+		auto capture = std::make_shared<GeometryCapture>( this );
+		loadIntoImpl( capture.get(), requestedAttribs );
+		capture->mSourceMods = nullptr;
+		cache->insert( key, capture );
+		geometry = capture;
+	}
+
+	geometry->replay( target );
+}
+
+void SourceMods::loadIntoImpl( Target *target, const AttribSet &requestedAttribs ) const
 {
 	if( mSourcePtr ) { // normal, no children
 		if( mModifiers.empty() ) {
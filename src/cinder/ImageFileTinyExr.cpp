@@ -22,14 +22,171 @@
 */
 
 #include "cinder/ImageFileTinyExr.h"
-#include "cinder/Log.h"
+#include "cinder/CinderMath.h"
+#include "cinder/ThreadPool.h"
 
 #include "tinyexr/tinyexr.h"
 
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstring>
+
 using namespace std;
 
 namespace cinder {
 
+// OpenEXR images are stored as blocks, either runs of scanlines or tiles, which are compressed independently. Every line
+// of a block holds the samples of each channel in turn, in the alphabetical order of the header's channel list. Samples
+// are little endian, which is also the byte order of every platform Cinder supports, so they are copied as is.
+
+namespace {
+
+const uint8_t EXR_MAGIC[4] = { 0x76, 0x2f, 0x31, 0x01 };
+
+// when the target's rows can't be written directly, blocks are decoded into a buffer of about this size at a time
+const size_t BATCH_BYTES = 64 * 1024 * 1024;
+// lines converted per task for images decoded by TinyExr
+const int32_t TINYEXR_LINES_PER_TASK = 16;
+
+int32_t linesPerBlock( int compression )
+{
+	return ( compression == TINYEXR_COMPRESSIONTYPE_ZIP ) ? 16 : 1;
+}
+
+bool isBlockDecodingSupported( int compression )
+{
+	return compression == TINYEXR_COMPRESSIONTYPE_NONE || compression == TINYEXR_COMPRESSIONTYPE_RLE
+		|| compression == TINYEXR_COMPRESSIONTYPE_ZIPS || compression == TINYEXR_COMPRESSIONTYPE_ZIP;
+}
+
+size_t sampleBytes( int pixelType )
+{
+	return ( pixelType == TINYEXR_PIXELTYPE_HALF ) ? 2 : 4;
+}
+
+template<typename T>
+T read( const uint8_t *data )
+{
+	T result;
+	memcpy( &result, data, sizeof( T ) );
+	return result;
+}
+
+template<typename T>
+void append( vector<uint8_t> *data, T value )
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t*>( &value );
+	data->insert( data->end(), bytes, bytes + sizeof( T ) );
+}
+
+void appendAttribute( vector<uint8_t> *header, const string &name, const string &type, const vector<uint8_t> &value )
+{
+	header->insert( header->end(), name.c_str(), name.c_str() + name.size() + 1 );
+	header->insert( header->end(), type.c_str(), type.c_str() + type.size() + 1 );
+	append( header, int32_t( value.size() ) );
+	header->insert( header->end(), value.begin(), value.end() );
+}
+
+// a table rather than halfToFloat(), as images are converted a few hundred million samples at a time
+const float* getHalfToFloatTable()
+{
+	static const vector<float> sTable = [] {
+		vector<float> table( 65536 );
+		for( size_t i = 0; i < table.size(); ++i ) {
+			half_float h;
+			h.u = uint16_t( i );
+			table[i] = halfToFloat( h );
+		}
+		return table;
+	}();
+
+	return sTable.data();
+}
+
+// Converts \a count samples of \a pixelType to every \a dstInc'th element of \a dst. Half float rows are only used when every loaded channel is half.
+void convertSamples( const uint8_t *src, int /*pixelType*/, half_float *dst, size_t count, size_t dstInc )
+{
+	for( size_t i = 0; i < count; ++i )
+		memcpy( &dst[i * dstInc], src + i * 2, 2 );
+}
+
+void convertSamples( const uint8_t *src, int pixelType, float *dst, size_t count, size_t dstInc )
+{
+	if( pixelType == TINYEXR_PIXELTYPE_HALF ) {
+		const float *table = getHalfToFloatTable();
+		for( size_t i = 0; i < count; ++i )
+			dst[i * dstInc] = table[read<uint16_t>( src + i * 2 )];
+	}
+	else if( pixelType == TINYEXR_PIXELTYPE_FLOAT ) {
+		for( size_t i = 0; i < count; ++i )
+			dst[i * dstInc] = read<float>( src + i * 4 );
+	}
+	else {
+		for( size_t i = 0; i < count; ++i )
+			dst[i * dstInc] = float( read<uint32_t>( src + i * 4 ) );
+	}
+}
+
+inline uint16_t toHalf( float value )		{ return floatToHalf( value ).u; }
+inline uint16_t toHalf( half_float value )	{ return value.u; }
+
+// Returns the uncompressed contents of a block, using \a scratch and \a raw as storage. Blocks that compression wouldn't shrink are stored as they are.
+const uint8_t* decompressBlock( int compression, const uint8_t *data, size_t size, size_t rawSize, vector<uint8_t> *scratch, vector<uint8_t> *raw )
+{
+	if( size == rawSize )
+		return data;
+
+	scratch->resize( rawSize );
+	if( compression == TINYEXR_COMPRESSIONTYPE_ZIP || compression == TINYEXR_COMPRESSIONTYPE_ZIPS ) {
+		uLongf uncompressedSize = (uLongf)rawSize;
+		if( uncompress( scratch->data(), &uncompressedSize, data, (uLong)size ) != Z_OK || uncompressedSize != rawSize )
+			throw ImageIoExceptionFailedLoadTinyExr( "Failed to decompress OpenEXR block" );
+	}
+	else if( compression == TINYEXR_COMPRESSIONTYPE_RLE ) {
+		// a negative count is followed by that many literal bytes, anything else by a byte repeated count + 1 times
+		const uint8_t *end = data + size;
+		size_t used = 0;
+		while( data < end ) {
+			const int count = int8_t( *data++ );
+			if( count < 0 ) {
+				if( end - data < -count || used + size_t( -count ) > rawSize )
+					throw ImageIoExceptionFailedLoadTinyExr( "Corrupt OpenEXR RLE block" );
+				memcpy( &( *scratch )[used], data, size_t( -count ) );
+				data += -count;
+				used += size_t( -count );
+			}
+			else {
+				if( data == end || used + size_t( count ) + 1 > rawSize )
+					throw ImageIoExceptionFailedLoadTinyExr( "Corrupt OpenEXR RLE block" );
+				memset( &( *scratch )[used], *data++, size_t( count ) + 1 );
+				used += size_t( count ) + 1;
+			}
+		}
+		if( used != rawSize )
+			throw ImageIoExceptionFailedLoadTinyExr( "Corrupt OpenEXR RLE block" );
+	}
+	else
+		throw ImageIoExceptionFailedLoadTinyExr( "Corrupt OpenEXR block" );
+
+	// undo the delta predictor, then interleave the two halves, which hold the even and the odd bytes
+	uint8_t *predicted = scratch->data();
+	for( size_t i = 1; i < rawSize; ++i )
+		predicted[i] = uint8_t( predicted[i - 1] + predicted[i] - 128 );
+
+	raw->resize( rawSize );
+	const uint8_t *even = predicted, *odd = predicted + ( rawSize + 1 ) / 2;
+	for( size_t i = 0; i < rawSize; i += 2 ) {
+		( *raw )[i] = *even++;
+		if( i + 1 < rawSize )
+			( *raw )[i + 1] = *odd++;
+	}
+
+	return raw->data();
+}
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------------------------------
 // ImageSourceFileTinyExr
 // ----------------------------------------------------------------------------------------------------
@@ -45,131 +202,271 @@ void ImageSourceFileTinyExr::registerSelf()
 	ImageIoRegistrar::registerSourceType( "exr", sourceFunc, 1 ); // lower is higher priority
 }
 
-ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options /*options*/ )
-	: mExrHeader( new EXRHeader, FreeEXRHeader ) // We're using the provided FreeEXRHeader function as a custom deleter
-	, mExrImage( new EXRImage, FreeEXRImage )    // We're using the provided FreeEXRImage function as a custom deleter
+ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options options )
+	: mExrHeader( new EXRHeader, []( EXRHeader *header ) { FreeEXRHeader( header ); delete header; return 0; } ) // FreeEXRHeader only frees the header's contents
+	, mExrImage( new EXRImage, []( EXRImage *image ) { FreeEXRImage( image ); delete image; return 0; } )        // FreeEXRImage only frees the image's contents
+	, mDecodeBlocks( false ), mBlockWidth( 0 ), mBlockHeight( 0 ), mNumBlocksX( 1 )
 {
 	InitEXRHeader( mExrHeader.get() );
 	InitEXRImage( mExrImage.get() );
 
-	int status = 0;
+	// blocks are decoded straight from memory, so files are read in one go
+	mBuffer = dataSource->getBuffer();
+	const auto memory = static_cast<const unsigned char *>( mBuffer->getData() );
+	if( mBuffer->getSize() < 8 || memcmp( memory, EXR_MAGIC, 4 ) != 0 )
+		throw ImageIoExceptionFailedLoadTinyExr( "Not an OpenEXR file" );
 
 	EXRVersion version;
-	status = ParseEXRVersionFromFile( &version, dataSource->getFilePath().string().c_str() );
-	if( status != TINYEXR_SUCCESS )
+	if( ParseEXRVersionFromMemory( &version, memory ) != TINYEXR_SUCCESS )
 		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR version" ) );
 
 	if( version.multipart || version.non_image )
 		throw ImageIoExceptionFailedLoadTinyExr( string( "Multipart or DeepImage EXR's are not supported yet" ) );
 
-	if( dataSource->isFilePath() ) {
-		const string filename = dataSource->getFilePath().string();
+	const char *error = "";
+	if( ParseEXRHeaderFromMemory( mExrHeader.get(), &version, memory, &error ) != TINYEXR_SUCCESS )
+		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
 
-		const char *error;
-		status = ParseEXRHeaderFromFile( mExrHeader.get(), &version, filename.c_str(), &error );
-		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
+	const int *dataWindow = mExrHeader->data_window;
+	setSize( dataWindow[2] - dataWindow[0] + 1, dataWindow[3] - dataWindow[1] + 1 );
+	if( mWidth <= 0 || mHeight <= 0 )
+		throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: empty data window" );
 
-		status = LoadEXRImageFromFile( mExrImage.get(), mExrHeader.get(), filename.c_str(), &error );
-		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
-	}
-	else {
-		const auto memory = static_cast<const unsigned char *>( dataSource->getBuffer()->getData() );
-
-		const char *error;
-		status = ParseEXRHeaderFromMemory( mExrHeader.get(), &version, memory, &error );
-		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR header; Error message: " ) + error );
-		
-		status = LoadEXRImageFromMemory( mExrImage.get(), mExrHeader.get(), memory, &error );
-		if( status != TINYEXR_SUCCESS )
-			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
+	for( int c = 0; c < mExrHeader->num_channels; ++c ) {
+		if( mExrHeader->channels[c].x_sampling != 1 || mExrHeader->channels[c].y_sampling != 1 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: subsampled channels are not supported" );
+		mChannelNames.push_back( mExrHeader->channels[c].name );
 	}
 
-	// verify that the channels are all the same size; currently we don't support variably sized channels
-	const int pixelType = mExrHeader->pixel_types[0];
-	for( int c = 1; c < mExrHeader->num_channels; ++c ) {
-		if( pixelType != mExrHeader->pixel_types[c] )
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: heterogneous channel data types not supported" );
-	}
+	selectChannels( options.getChannels() );
 
-	switch( pixelType ) {
-		case TINYEXR_PIXELTYPE_HALF:
-			setDataType( ImageIo::FLOAT16 );
-			break;
-		case TINYEXR_PIXELTYPE_FLOAT:
-			setDataType( ImageIo::FLOAT32 );
+	// channels are converted individually, so the image is only half float when every loaded channel is
+	bool half = true;
+	for( int c : mLoadChannels )
+		half = half && ( mExrHeader->pixel_types[c] == TINYEXR_PIXELTYPE_HALF );
+	setDataType( half ? ImageIo::FLOAT16 : ImageIo::FLOAT32 );
+
+	switch( mLoadChannels.size() ) {
+		case 1:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ImageIo::ChannelOrder::Y );
 			break;
-		default:
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unknown data type" );
+		case 2:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( ImageIo::ChannelOrder::YA );
 			break;
-	}
-
-	setSize( mExrImage->width, mExrImage->height );
-
-	switch( mExrImage->num_channels ) {
 		case 3:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGB );
 			break;
-		case 4:
+		default:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGBA );
 			break;
-		default:
-			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: Unsupported number of channels (" + to_string( mExrImage->num_channels ) + ")" );
+	}
+
+	// Compressions other than PIZ and ZFP are decoded here a block at a time. The others are left to TinyExr, which
+	// decodes the whole image into planes on the first load(), and are then converted in runs of lines instead.
+	const int compression = mExrHeader->compression_type;
+	mDecodeBlocks = isBlockDecodingSupported( compression );
+	if( mExrHeader->tiled ) {
+		if( ! mDecodeBlocks )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: tiled images are only supported with NONE, RLE, ZIPS and ZIP compression" );
+		if( mExrHeader->tile_size_x <= 0 || mExrHeader->tile_size_y <= 0 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: invalid tile size" );
+		mBlockWidth = mExrHeader->tile_size_x;
+		mBlockHeight = mExrHeader->tile_size_y;
+	}
+	else {
+		mBlockWidth = mWidth;
+		mBlockHeight = mDecodeBlocks ? linesPerBlock( compression ) : TINYEXR_LINES_PER_TASK;
+	}
+	mNumBlocksX = ( mWidth + mBlockWidth - 1 ) / mBlockWidth;
+
+	if( mDecodeBlocks ) {
+		// the offset table follows the header; with mipmaps or ripmaps the full resolution tiles come first
+		const size_t numBlocks = size_t( mNumBlocksX ) * size_t( ( mHeight + mBlockHeight - 1 ) / mBlockHeight );
+		const size_t tableOffset = 8 + mExrHeader->header_len;
+		if( tableOffset + numBlocks * 8 > mBuffer->getSize() )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: truncated offset table" );
+
+		mBlockOffsets.resize( numBlocks );
+		memcpy( mBlockOffsets.data(), memory + tableOffset, numBlocks * 8 );
+		for( uint64_t offset : mBlockOffsets ) {
+			if( offset >= mBuffer->getSize() )
+				throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: invalid block offset" );
+		}
+	}
+}
+
+void ImageSourceFileTinyExr::selectChannels( const vector<string> &names )
+{
+	auto find = [this]( const string &name ) {
+		auto it = std::find( mChannelNames.begin(), mChannelNames.end(), name );
+		return ( it == mChannelNames.end() ) ? -1 : int( it - mChannelNames.begin() );
+	};
+
+	if( names.empty() ) {
+		const int red = find( "R" ), green = find( "G" ), blue = find( "B" ), alpha = find( "A" ), gray = find( "Y" );
+		if( red >= 0 && green >= 0 && blue >= 0 )
+			mLoadChannels = { red, green, blue };
+		else if( gray >= 0 )
+			mLoadChannels = { gray };
+		else if( mChannelNames.size() == 1 )
+			mLoadChannels = { 0 };
+		else
+			throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for RGB" );
+
+		if( alpha >= 0 && mLoadChannels[0] != alpha )
+			mLoadChannels.push_back( alpha );
+	}
+	else {
+		if( names.size() > 4 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: at most 4 channels can be loaded" );
+
+		for( const auto &name : names ) {
+			const int channel = find( name );
+			if( channel < 0 )
+				throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: no channel named \"" + name + "\"" );
+			mLoadChannels.push_back( channel );
+		}
 	}
 }
 
 void ImageSourceFileTinyExr::load( ImageTargetRef target )
 {
-	ImageSource::RowFunc rowFunc = setupRowFunc( target );
-
-	const size_t numChannels = mExrHeader->num_channels;
-	const void * red = nullptr, *green = nullptr, *blue = nullptr, *alpha = nullptr;
-
-	for( size_t c = 0; c < numChannels; ++c ) {
-		if( strcmp( mExrHeader->channels[c].name, "R" ) == 0 )
-			red = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "G" ) == 0 )
-			green = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "B" ) == 0 )
-			blue = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "A" ) == 0 )
-			alpha = mExrImage->images[c];
+	// half floats are converted on the decoding threads when the target is float, rather than by the row function
+	const ImageIo::DataType fileDataType = getDataType();
+	if( fileDataType == ImageIo::FLOAT16 && target->getDataType() == ImageIo::FLOAT32 )
+		setDataType( ImageIo::FLOAT32 );
+
+	try {
+		ImageSource::RowFunc rowFunc = setupRowFunc( target );
+		if( getDataType() == ImageIo::FLOAT16 )
+			loadBlocks<half_float>( target, rowFunc );
+		else
+			loadBlocks<float>( target, rowFunc );
+	}
+	catch( ... ) {
+		setDataType( fileDataType );
+		throw;
 	}
 
-	if( ( !red ) || ( !green ) || ( !blue ) )
-		throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for RGB" );
-
-	// load one interleaved row at a time
-	if( getDataType() == ImageIo::FLOAT32 ) {
-		vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-		for( int32_t row = 0; row < mHeight; row++ ) {
-			for( int32_t col = 0; col < mWidth; col++ ) {
-				rowData.at( col * numChannels + 0 ) = static_cast<const float *>( red )[row * mWidth + col];
-				rowData.at( col * numChannels + 1 ) = static_cast<const float *>( green )[row * mWidth + col];
-				rowData.at( col * numChannels + 2 ) = static_cast<const float *>( blue )[row * mWidth + col];
-				if( alpha )
-					rowData.at( col * numChannels + 3 ) = static_cast<const float *>( alpha )[row * mWidth + col];
-			}
+	setDataType( fileDataType );
+}
+
+Area ImageSourceFileTinyExr::getBlockArea( size_t block ) const
+{
+	const int32_t x = int32_t( block % mNumBlocksX ) * mBlockWidth, y = int32_t( block / mNumBlocksX ) * mBlockHeight;
+	return Area( x, y, std::min( x + mBlockWidth, mWidth ), std::min( y + mBlockHeight, mHeight ) );
+}
+
+template<typename T>
+void ImageSourceFileTinyExr::loadBlocks( const ImageTargetRef &target, RowFunc rowFunc )
+{
+	if( ! mDecodeBlocks && ! mExrImage->images ) {
+		const char *error = "";
+		if( LoadEXRImageFromMemory( mExrImage.get(), mExrHeader.get(), static_cast<const unsigned char *>( mBuffer->getData() ), &error ) != TINYEXR_SUCCESS )
+			throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR file; Error message: " ) + error );
+	}
+
+	ThreadPool *pool = ThreadPool::getDefault();
+	const size_t numBlocks = size_t( mNumBlocksX ) * size_t( ( mHeight + mBlockHeight - 1 ) / mBlockHeight );
+	const size_t rowSize = size_t( mWidth ) * mLoadChannels.size();
+
+	auto decodeBlocks = [&]( size_t begin, size_t end, const function<T*( int32_t )> &rowPointer ) {
+		pool->parallelFor( begin, end, [&]( size_t blockBegin, size_t blockEnd ) {
+			vector<uint8_t> scratch, raw;
+			for( size_t block = blockBegin; block < blockEnd; ++block )
+				decodeBlock<T>( block, rowPointer, &scratch, &raw );
+		} );
+	};
+
+	// rows that are already in the target's format are decoded straight into it
+	if( target->isRowAccessThreadSafe() && rowFunc == &ImageSourceFileTinyExr::rowFuncCopy ) {
+		decodeBlocks( 0, numBlocks, [&target]( int32_t row ) { return static_cast<T*>( target->getRowPointer( row ) ); } );
+		return;
+	}
 
-			( ( *this ).*rowFunc )( target, row, rowData.data() );
+	// otherwise rows of blocks are decoded into a buffer a batch at a time, with a few blocks per thread at least, and then converted
+	const int32_t numBlockRows = ( mHeight + mBlockHeight - 1 ) / mBlockHeight;
+	const int32_t minBatchBlockRows = int32_t( ( ( pool->getNumThreads() + 1 ) * 4 + mNumBlocksX - 1 ) / mNumBlocksX );
+	const int32_t batchBlockRows = std::min( numBlockRows, std::max( minBatchBlockRows, int32_t( BATCH_BYTES / ( rowSize * sizeof( T ) * mBlockHeight ) ) ) );
+	vector<T> batch( std::min( size_t( batchBlockRows * mBlockHeight ), size_t( mHeight ) ) * rowSize );
+
+	for( int32_t blockRow = 0; blockRow < numBlockRows; blockRow += batchBlockRows ) {
+		const int32_t y0 = blockRow * mBlockHeight, y1 = std::min( ( blockRow + batchBlockRows ) * mBlockHeight, mHeight );
+		auto rowPointer = [&]( int32_t row ) { return &batch[size_t( row - y0 ) * rowSize]; };
+		decodeBlocks( size_t( blockRow ) * mNumBlocksX, std::min( numBlocks, size_t( blockRow + batchBlockRows ) * mNumBlocksX ), rowPointer );
+
+		if( target->isRowAccessThreadSafe() ) {
+			pool->parallelFor( y0, y1, [&]( size_t begin, size_t end ) {
+				for( size_t row = begin; row < end; ++row )
+					( ( *this ).*rowFunc )( target, int32_t( row ), rowPointer( int32_t( row ) ) );
+			} );
+		}
+		else {
+			for( int32_t row = y0; row < y1; ++row )
+				( ( *this ).*rowFunc )( target, row, rowPointer( row ) );
 		}
 	}
-	else { // float16
-		vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-		for( int32_t row = 0; row < mHeight; row++ ) {
-			for( int32_t col = 0; col < mWidth; col++ ) {
-				rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( red )[row * mWidth + col];
-				rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( green )[row * mWidth + col];
-				rowData.at( col * numChannels + 2 ) = static_cast<const uint16_t *>( blue )[row * mWidth + col];
-				if( alpha )
-					rowData.at( col * numChannels + 3 ) = static_cast<const uint16_t *>( alpha )[row * mWidth + col];
+}
+
+template<typename T>
+void ImageSourceFileTinyExr::decodeBlock( size_t block, const function<T*( int32_t row )> &rowPointer, vector<uint8_t> *scratch, vector<uint8_t> *raw )
+{
+	const Area area = getBlockArea( block );
+	const size_t inc = mLoadChannels.size();
+	const int *pixelTypes = mExrHeader->pixel_types;
+
+	if( ! mDecodeBlocks ) {
+		// TinyExr has decoded the whole image into a plane per channel
+		for( int32_t row = area.y1; row < area.y2; ++row ) {
+			T *out = rowPointer( row );
+			for( size_t c = 0; c < inc; ++c ) {
+				const int channel = mLoadChannels[c];
+				const uint8_t *plane = mExrImage->images[channel];
+				convertSamples( plane + size_t( row ) * mWidth * sampleBytes( pixelTypes[channel] ), pixelTypes[channel], out + c, size_t( mWidth ), inc );
 			}
+		}
+		return;
+	}
 
-			( ( *this ).*rowFunc )( target, row, rowData.data() );
+	// blocks start with their tile coordinates and level, or their first line, followed by the size of their data
+	const uint8_t *memory = static_cast<const uint8_t*>( mBuffer->getData() );
+	const uint64_t offset = mBlockOffsets[block];
+	const size_t headerSize = mExrHeader->tiled ? 20 : 8;
+	if( offset + headerSize > mBuffer->getSize() )
+		throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: truncated block" );
+
+	const uint8_t *data = memory + offset;
+	if( mExrHeader->tiled ) {
+		if( read<int32_t>( data ) != area.x1 / mBlockWidth || read<int32_t>( data + 4 ) != area.y1 / mBlockHeight || read<int32_t>( data + 8 ) != 0 || read<int32_t>( data + 12 ) != 0 )
+			throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: unexpected tile" );
+	}
+	else if( read<int32_t>( data ) != mExrHeader->data_window[1] + area.y1 )
+		throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: unexpected scanline block" );
+
+	const int32_t dataSize = read<int32_t>( data + headerSize - 4 );
+	if( dataSize < 0 || offset + headerSize + uint64_t( dataSize ) > mBuffer->getSize() )
+		throw ImageIoExceptionFailedLoadTinyExr( "TinyExr: truncated block" );
+
+	const size_t width = size_t( area.getWidth() );
+	size_t lineBytes = 0;
+	for( int c = 0; c < mExrHeader->num_channels; ++c )
+		lineBytes += width * sampleBytes( pixelTypes[c] );
+
+	const uint8_t *pixels = decompressBlock( mExrHeader->compression_type, data + headerSize, size_t( dataSize ), lineBytes * area.getHeight(), scratch, raw );
+
+	for( int32_t line = 0; line < area.getHeight(); ++line ) {
+		const uint8_t *lineData = pixels + line * lineBytes;
+		T *out = rowPointer( area.y1 + line ) + size_t( area.x1 ) * inc;
+		for( size_t c = 0; c < inc; ++c ) {
+			const int channel = mLoadChannels[c];
+			size_t channelOffset = 0;
+			for( int previous = 0; previous < channel; ++previous )
+				channelOffset += width * sampleBytes( pixelTypes[previous] );
+			convertSamples( lineData + channelOffset, pixelTypes[channel], out + c, width, inc );
 		}
 	}
 }
@@ -198,13 +495,8 @@ ImageTargetRef ImageTargetFileTinyExr::create( DataTargetRef dataTarget, ImageSo
 }
 
 ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+	: mOptions( options ), mDataTarget( dataTarget )
 {
-	if( ! dataTarget->providesFilePath() ) {
-		throw ImageIoExceptionFailedWrite( "ImageTargetFileTinyExr only supports writing to files." );
-	}
-
-	mFilePath = dataTarget->getFilePath();
-
 	setSize( imageSource->getWidth(), imageSource->getHeight() );
 	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
 
@@ -213,84 +505,163 @@ ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageS
 			mNumComponents = ( imageSource->hasAlpha() ) ? 4 : 3;
 			setColorModel( ImageIo::ColorModel::CM_RGB );
 			setChannelOrder( ( mNumComponents == 3 ) ? ImageIo::ChannelOrder::BGR : ImageIo::ChannelOrder::ABGR );
-			if( mNumComponents == 3 )
+			if( mNumComponents == 3 ) {
 				mChannelNames = { "B", "G", "R" };
-			else
+				mChannelIndices = { 0, 1, 2 };
+			}
+			else {
 				mChannelNames = { "A", "B", "G", "R" };
+				mChannelIndices = { 0, 1, 2, 3 };
+			}
 			break;
 		case ImageIo::ColorModel::CM_GRAY:
 			mNumComponents = ( imageSource->hasAlpha() ) ? 2 : 1;
 			setColorModel( ImageIo::ColorModel::CM_GRAY );
 			setChannelOrder( ( mNumComponents == 2 ) ? ImageIo::ChannelOrder::YA : ImageIo::ChannelOrder::Y );
-			if( mNumComponents == 2 )
-				mChannelNames = { "Y", "A" };
-			else
+			if( mNumComponents == 2 ) {
+				mChannelNames = { "A", "Y" };
+				mChannelIndices = { 1, 0 };
+			}
+			else {
 				mChannelNames = { "Y" };
+				mChannelIndices = { 0 };
+			}
 			break;
 		default:
 			throw ImageIoExceptionIllegalColorModel();
 	}
 
-	// TODO: consider supporting half float and uint types as well
-	setDataType( ImageIo::DataType::FLOAT32 );
-	mData.resize( mHeight * mWidth * mNumComponents );
+	// half float sources are taken as they are, anything else as float; either way the file holds half floats
+	setDataType( ( imageSource->getDataType() == ImageIo::FLOAT16 ) ? ImageIo::DataType::FLOAT16 : ImageIo::DataType::FLOAT32 );
+	mRowBytes = mWidth * mNumComponents * ( ( getDataType() == ImageIo::FLOAT16 ) ? 2 : 4 );
+	mData.resize( mHeight * mRowBytes );
 }
 
 void *ImageTargetFileTinyExr::getRowPointer( int32_t row )
 {
-	return &mData[row * mWidth * mNumComponents];
+	return &mData[row * mRowBytes];
 }
 
-void ImageTargetFileTinyExr::finalize()
+template<typename T>
+void ImageTargetFileTinyExr::encodeBlock( int32_t y0, int32_t y1, vector<uint8_t> *block )
 {
-	// turn interleaved data into a series of planar channels
-	vector<Channel32f> channels;
-	unsigned char *    imagePtr[4];
-	for( int c = 0; c < mNumComponents; ++c ) {
-		channels.emplace_back( getWidth(), getHeight() );
-		Channel32f srcChannel( getWidth(), getHeight(), mNumComponents * mWidth * sizeof(float), mNumComponents, mData.data() + c );
-		channels.back().copyFrom( srcChannel, srcChannel.getBounds() );
-
-		imagePtr[c] = reinterpret_cast<unsigned char *>( channels[c].getData() );
+	// planar half float lines, one channel after another
+	const size_t numChannels = mChannelNames.size();
+	const size_t lineBytes = size_t( mWidth ) * numChannels * 2;
+	const size_t rawSize = lineBytes * ( y1 - y0 );
+	vector<uint8_t> raw( rawSize );
+	for( int32_t y = y0; y < y1; ++y ) {
+		const T *row = reinterpret_cast<const T*>( &mData[y * mRowBytes] );
+		uint16_t *line = reinterpret_cast<uint16_t*>( &raw[( y - y0 ) * lineBytes] );
+		for( size_t c = 0; c < numChannels; ++c ) {
+			const T *in = row + mChannelIndices[c];
+			uint16_t *out = line + c * mWidth;
+			for( int32_t x = 0; x < mWidth; ++x )
+				out[x] = toHalf( in[x * mNumComponents] );
+		}
 	}
 
-	int pixelTypes[4], requested_pixel_types[4];
-	for( int i = 0; i < mNumComponents; i++ ) {
-		pixelTypes[i] = TINYEXR_PIXELTYPE_FLOAT;
-		requested_pixel_types[i] = TINYEXR_PIXELTYPE_HALF; // export as half-floats to reduce file size
+	block->clear();
+	append( block, y0 );
+
+	if( mOptions.getCompressionLevel() > 0 ) {
+		// ZIP compresses the even bytes followed by the odd ones, with each byte replaced by its difference to the previous one
+		vector<uint8_t> predicted( rawSize );
+		const size_t numEven = ( rawSize + 1 ) / 2;
+		for( size_t i = 0; i < rawSize; ++i )
+			predicted[( i & 1 ) ? numEven + i / 2 : i / 2] = raw[i];
+		for( size_t i = rawSize - 1; i > 0; --i )
+			predicted[i] = uint8_t( predicted[i] - predicted[i - 1] + 128 );
+
+		uLongf compressedSize = compressBound( (uLong)rawSize );
+		block->resize( 8 + compressedSize );
+		if( compress2( block->data() + 8, &compressedSize, predicted.data(), (uLong)rawSize, std::min( mOptions.getCompressionLevel(), 9 ) ) != Z_OK )
+			throw ImageIoExceptionFailedWriteTinyExr( "TinyExr: failed to compress" );
+
+		// blocks that don't shrink are stored uncompressed
+		if( compressedSize < rawSize ) {
+			block->resize( 8 + compressedSize );
+			const int32_t size = int32_t( compressedSize );
+			memcpy( block->data() + 4, &size, 4 );
+			return;
+		}
+		block->resize( 4 );
 	}
 
-	std::vector<EXRChannelInfo> info( mNumComponents );
-
-	// create image descriptor
-	EXRImage exrImage;
-	InitEXRImage( &exrImage );
-
-	exrImage.num_channels = mNumComponents;
-	exrImage.width = mWidth;
-	exrImage.height = mHeight;
-	exrImage.images = imagePtr;
-
-	// create header descriptor
-	EXRHeader exrHeader;
-	InitEXRHeader( &exrHeader );
+	append( block, int32_t( rawSize ) );
+	block->insert( block->end(), raw.begin(), raw.end() );
+}
 
-	exrHeader.num_channels = mNumComponents;
-	exrHeader.channels = info.data();
-	for( int i = 0; i < mNumComponents; ++i ) {
-		strncpy( exrHeader.channels[i].name, mChannelNames[i].data(), mChannelNames[i].size() );
+void ImageTargetFileTinyExr::finalize()
+{
+	const bool zip = mOptions.getCompressionLevel() > 0;
+	const int32_t blockLines = linesPerBlock( zip ? TINYEXR_COMPRESSIONTYPE_ZIP : TINYEXR_COMPRESSIONTYPE_NONE );
+	const size_t numBlocks = size_t( ( mHeight + blockLines - 1 ) / blockLines );
+
+	vector<vector<uint8_t>> blocks( numBlocks );
+	auto encodeBlocks = [&]( size_t begin, size_t end ) {
+		for( size_t b = begin; b < end; ++b ) {
+			const int32_t y0 = int32_t( b ) * blockLines, y1 = std::min( y0 + blockLines, mHeight );
+			if( getDataType() == ImageIo::FLOAT16 )
+				encodeBlock<half_float>( y0, y1, &blocks[b] );
+			else
+				encodeBlock<float>( y0, y1, &blocks[b] );
+		}
+	};
+
+	// limits the number of concurrent tasks to numThreads, when it's specified
+	const size_t numThreads = mOptions.getNumThreads();
+	if( numThreads == 1 )
+		encodeBlocks( 0, numBlocks );
+	else
+		ThreadPool::getDefault()->parallelFor( 0, numBlocks, encodeBlocks, ( numThreads == 0 ) ? 1 : ( numBlocks + numThreads - 1 ) / numThreads );
+
+	vector<uint8_t> header( EXR_MAGIC, EXR_MAGIC + 4 );
+	append( &header, int32_t( 2 ) );
+
+	vector<uint8_t> channels;
+	for( const auto &name : mChannelNames ) {
+		channels.insert( channels.end(), name.c_str(), name.c_str() + name.size() + 1 );
+		append( &channels, int32_t( TINYEXR_PIXELTYPE_HALF ) );
+		append( &channels, int32_t( 0 ) ); // pLinear and reserved
+		append( &channels, int32_t( 1 ) ); // x sampling
+		append( &channels, int32_t( 1 ) ); // y sampling
+	}
+	channels.push_back( 0 );
+
+	vector<uint8_t> window;
+	for( int32_t value : { 0, 0, mWidth - 1, mHeight - 1 } )
+		append( &window, value );
+
+	vector<uint8_t> pixelAspectRatio, screenWindowCenter, screenWindowWidth;
+	append( &pixelAspectRatio, 1.0f );
+	append( &screenWindowCenter, 0.0f );
+	append( &screenWindowCenter, 0.0f );
+	append( &screenWindowWidth, 1.0f );
+
+	appendAttribute( &header, "channels", "chlist", channels );
+	appendAttribute( &header, "compression", "compression", { uint8_t( zip ? TINYEXR_COMPRESSIONTYPE_ZIP : TINYEXR_COMPRESSIONTYPE_NONE ) } );
+	appendAttribute( &header, "dataWindow", "box2i", window );
+	appendAttribute( &header, "displayWindow", "box2i", window );
+	appendAttribute( &header, "lineOrder", "lineOrder", { 0 } );
+	appendAttribute( &header, "pixelAspectRatio", "float", pixelAspectRatio );
+	appendAttribute( &header, "screenWindowCenter", "v2f", screenWindowCenter );
+	appendAttribute( &header, "screenWindowWidth", "float", screenWindowWidth );
+	header.push_back( 0 );
+
+	uint64_t offset = header.size() + numBlocks * 8;
+	for( const auto &block : blocks ) {
+		append( &header, offset );
+		offset += block.size();
 	}
-	exrHeader.pixel_types = pixelTypes;
-	exrHeader.requested_pixel_types = requested_pixel_types;
-	exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_NONE; // TODO add option to enable compression
-
-	const char *error;
 
-	const int status = SaveEXRImageToFile( &exrImage, &exrHeader, mFilePath.string().c_str(), &error );
-	if( status != TINYEXR_SUCCESS )
-		throw ImageIoExceptionFailedWriteTinyExr( string( "TinyExr: failed to write. Error: " ) + error );
+	OStreamRef stream = mDataTarget->getStream();
+	if( ! stream )
+		throw ImageIoExceptionFailedWriteTinyExr( "TinyExr: failed to open stream" );
 
-	// Note: since header and image descriptors do not own any data, we explicitely do not call FreeEXRHeader and FreeEXRImage here!
+	stream->writeData( header.data(), header.size() );
+	for( const auto &block : blocks )
+		stream->writeData( block.data(), block.size() );
 }
 
 } // namespace cinder
@@ -23,10 +23,20 @@
 */
 
 #include "cinder/ImageIo.h"
+#include "cinder/ImageLoader.h"
 #include "cinder/Utilities.h"
 
+#include <algorithm>
+#include <atomic>
 #include <iterator>
 #include <cctype>
+#include <cstring>
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <emmintrin.h>
+#elif defined( CINDER_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
 
 #if defined( CINDER_COCOA )
 	#include "cinder/cocoa/CinderCocoa.h"
@@ -45,6 +55,11 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+std::atomic<bool> sRowFuncKernelsEnabled( true );
+
+} // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSource
@@ -165,6 +180,114 @@ size_t ImageSource::getRowBytes() const
 	return getWidth() * ImageIo::channelOrderNumChannels( getChannelOrder() ) * ImageIo::dataTypeBytes( getDataType() );
 }
 
+void ImageSource::setupRegion( const Options &options )
+{
+	const Area fullArea( 0, 0, mWidth, mHeight );
+	mSourceArea = ( options.getArea().calcArea() != 0 ) ? options.getArea().getClipBy( fullArea ) : fullArea;
+	if( mSourceArea.getWidth() <= 0 || mSourceArea.getHeight() <= 0 )
+		throw ImageIoException( "ImageSource::Options::area() lies outside of the image." );
+
+	// the smallest integer factor that fits the area within maxSize
+	mReduction = 1;
+	const ivec2 &maxSize = options.getMaxSize();
+	if( maxSize.x > 0 )
+		mReduction = std::max( mReduction, ( mSourceArea.getWidth() + maxSize.x - 1 ) / maxSize.x );
+	if( maxSize.y > 0 )
+		mReduction = std::max( mReduction, ( mSourceArea.getHeight() + maxSize.y - 1 ) / maxSize.y );
+
+	setSize( std::max<int32_t>( 1, mSourceArea.getWidth() / mReduction ), std::max<int32_t>( 1, mSourceArea.getHeight() / mReduction ) );
+	mRegionApplied = true;
+}
+
+namespace {
+
+template<typename T>
+inline float toReductionSum( T v )					{ return static_cast<float>( v ); }
+inline float toReductionSum( half_float v )			{ return halfToFloat( v ); }
+
+template<typename T>
+inline T fromReductionAverage( float v )			{ return static_cast<T>( v + 0.5f ); }
+template<>
+inline float fromReductionAverage<float>( float v )	{ return v; }
+template<>
+inline half_float fromReductionAverage<half_float>( float v )	{ return floatToHalf( v ); }
+
+} // anonymous namespace
+
+template<typename SD>
+void ImageSource::accumulateRow( const void *data )
+{
+	const int32_t inc = mCustomPixelInc ? mCustomPixelInc : channelOrderNumChannels( mChannelOrder );
+	const int32_t boxWidth = std::min( mReduction, mSourceArea.getWidth() );
+	const SD *sourceData = reinterpret_cast<const SD*>( data ) + mSourceArea.x1 * inc;
+	float *sums = mReductionSums.data();
+
+	for( int32_t x = 0; x < mWidth; ++x ) {
+		const SD *pixel = sourceData + x * mReduction * inc;
+		for( int32_t i = 0; i < boxWidth; ++i, pixel += inc ) {
+			for( int32_t c = 0; c < inc; ++c )
+				sums[c] += toReductionSum( pixel[c] );
+		}
+		sums += inc;
+	}
+}
+
+template<typename SD>
+void ImageSource::resolveRow()
+{
+	const float scale = 1.0f / ( std::min( mReduction, mSourceArea.getWidth() ) * std::min( mReduction, mSourceArea.getHeight() ) );
+	SD *row = reinterpret_cast<SD*>( mReductionRow.data() );
+	for( size_t i = 0; i < mReductionSums.size(); ++i )
+		row[i] = fromReductionAverage<SD>( mReductionSums[i] * scale );
+}
+
+bool ImageSource::processRow( const ImageTargetRef &target, RowFunc func, int32_t sourceRow, const void *data )
+{
+	if( ! mRegionApplied ) {
+		((*this).*func)( target, sourceRow, data );
+		return sourceRow + 1 < mHeight;
+	}
+
+	const int32_t boxHeight = std::min( mReduction, mSourceArea.getHeight() );
+	const int32_t lastRow = mSourceArea.y1 + ( mHeight - 1 ) * mReduction + boxHeight - 1;
+	if( sourceRow < mSourceArea.y1 )
+		return true;
+	else if( sourceRow > lastRow )
+		return false;
+
+	const int32_t inc = mCustomPixelInc ? mCustomPixelInc : channelOrderNumChannels( mChannelOrder );
+	if( mReduction == 1 ) {
+		((*this).*func)( target, sourceRow - mSourceArea.y1, reinterpret_cast<const uint8_t*>( data ) + mSourceArea.x1 * inc * dataTypeBytes( mDataType ) );
+		return sourceRow < lastRow;
+	}
+
+	const int32_t rowInBox = ( sourceRow - mSourceArea.y1 ) % mReduction;
+	if( rowInBox == 0 ) {
+		mReductionSums.assign( mWidth * inc, 0 );
+		mReductionRow.resize( mWidth * inc * dataTypeBytes( mDataType ) );
+	}
+
+	switch( mDataType ) {
+		case UINT8:		accumulateRow<uint8_t>( data );		break;
+		case UINT16:	accumulateRow<uint16_t>( data );	break;
+		case FLOAT16:	accumulateRow<half_float>( data );	break;
+		case FLOAT32:	accumulateRow<float>( data );		break;
+		default:		throw ImageIoExceptionIllegalDataType( "Unknown data type." );
+	}
+
+	if( rowInBox == boxHeight - 1 ) {
+		switch( mDataType ) {
+			case UINT8:		resolveRow<uint8_t>();		break;
+			case UINT16:	resolveRow<uint16_t>();		break;
+			case FLOAT16:	resolveRow<half_float>();	break;
+			default:		resolveRow<float>();		break;
+		}
+		((*this).*func)( target, ( sourceRow - mSourceArea.y1 ) / mReduction, mReductionRow.data() );
+	}
+
+	return sourceRow < lastRow;
+}
+
 /* SD - source data type, TD - target data type, TCM - target color model */
 template<typename SD, typename TD, ImageIo::ColorModel TCM, bool ALPHA>
 void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const void *data )
@@ -359,23 +482,265 @@ ImageSource::RowFunc ImageSource::setupRowFuncForSourceType( ImageTargetRef targ
 
 ImageSource::RowFunc ImageSource::setupRowFunc( ImageTargetRef target )
 {
+	RowFunc result;
 	switch( mDataType ) {
 		case UINT8:
-			return setupRowFuncForSourceType<uint8_t>( target );
+			result = setupRowFuncForSourceType<uint8_t>( target );
 		break;
 		case UINT16:
-			return setupRowFuncForSourceType<uint16_t>( target );
+			result = setupRowFuncForSourceType<uint16_t>( target );
 		break;
 		case FLOAT16:
-			return setupRowFuncForSourceType<half_float>( target );
+			result = setupRowFuncForSourceType<half_float>( target );
 		break;
 		case FLOAT32:
-			return setupRowFuncForSourceType<float>( target );
+			result = setupRowFuncForSourceType<float>( target );
 		break;
 		case DATA_UNKNOWN:
 		default:
 			throw ImageIoExceptionIllegalDataType( "Unknown data type." );
 	}
+
+	// the generic setup above has filled in the channel offsets the kernels are built from
+	if( sRowFuncKernelsEnabled ) {
+		RowFunc kernel = setupRowFuncKernel( target );
+		if( kernel )
+			return kernel;
+	}
+
+	return result;
+}
+
+void ImageSource::setRowFuncKernelsEnabled( bool enable )
+{
+	sRowFuncKernelsEnabled = enable;
+}
+
+bool ImageSource::isRowFuncKernelsEnabled()
+{
+	return sRowFuncKernelsEnabled;
+}
+
+// Picks a specialized row function for the common layouts, or returns null to keep the generic one. Kernels write every
+// channel of the target, so a target alpha without a source alpha is made opaque rather than left untouched.
+ImageSource::RowFunc ImageSource::setupRowFuncKernel( const ImageTargetRef &target )
+{
+	if( mCustomPixelInc != 0 || mChannelOrder == CUSTOM || target->getColorModel() == CM_UNKNOWN )
+		return nullptr;
+
+	const bool sameLayout = ( mColorModel == target->getColorModel() ) && ( mChannelOrder == target->getChannelOrder() );
+	if( sameLayout && mDataType == target->getDataType() )
+		return &ImageSource::rowFuncCopy;
+	if( sameLayout && mDataType == UINT8 && target->getDataType() == FLOAT32 )
+		return &ImageSource::rowFunc8uTo32f;
+
+	if( mDataType != UINT8 || target->getDataType() != UINT8 || target->getColorModel() != CM_RGB )
+		return nullptr;
+
+	// RGB targets from RGB or gray sources are a byte shuffle, described by the source channel of each target channel
+	std::fill( mRowFuncSwizzle, mRowFuncSwizzle + 4, -1 );
+	if( mColorModel == CM_RGB ) {
+		mRowFuncSwizzle[mRowFuncTargetRed] = mRowFuncSourceRed;
+		mRowFuncSwizzle[mRowFuncTargetGreen] = mRowFuncSourceGreen;
+		mRowFuncSwizzle[mRowFuncTargetBlue] = mRowFuncSourceBlue;
+	}
+	else {
+		mRowFuncSwizzle[mRowFuncTargetRed] = mRowFuncSourceGray;
+		mRowFuncSwizzle[mRowFuncTargetGreen] = mRowFuncSourceGray;
+		mRowFuncSwizzle[mRowFuncTargetBlue] = mRowFuncSourceGray;
+	}
+	if( mRowFuncTargetAlpha != -1 )
+		mRowFuncSwizzle[mRowFuncTargetAlpha] = mRowFuncSourceAlpha;
+
+	switch( mRowFuncSourceInc * 10 + mRowFuncTargetInc ) {
+		case 13: return &ImageSource::rowFuncSwizzle8u<1,3>;
+		case 14: return &ImageSource::rowFuncSwizzle8u<1,4>;
+		case 23: return &ImageSource::rowFuncSwizzle8u<2,3>;
+		case 24: return &ImageSource::rowFuncSwizzle8u<2,4>;
+		case 33: return &ImageSource::rowFuncSwizzle8u<3,3>;
+		case 34: return &ImageSource::rowFuncSwizzle8u<3,4>;
+		case 43: return &ImageSource::rowFuncSwizzle8u<4,3>;
+		case 44: return &ImageSource::rowFuncSwizzle8u<4,4>;
+		default: return nullptr;
+	}
+}
+
+void ImageSource::rowFuncCopy( ImageTargetRef target, int32_t row, const void *data )
+{
+	memcpy( target->getRowPointer( row ), data, getRowBytes() );
+}
+
+void ImageSource::rowFunc8uTo32f( ImageTargetRef target, int32_t row, const void *data )
+{
+	const uint8_t *sourceData = reinterpret_cast<const uint8_t*>( data );
+	float *targetData = reinterpret_cast<float*>( target->getRowPointer( row ) );
+	const int32_t count = getWidth() * channelOrderNumChannels( mChannelOrder );
+	int32_t i = 0;
+
+	// divides rather than multiplying by the reciprocal, so that results match CHANTRAIT<float>::convert() exactly
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128i zero = _mm_setzero_si128();
+	const __m128 scale = _mm_set1_ps( 255.0f );
+	for( ; i + 16 <= count; i += 16 ) {
+		const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( sourceData + i ) );
+		const __m128i lo = _mm_unpacklo_epi8( bytes, zero ), hi = _mm_unpackhi_epi8( bytes, zero );
+		_mm_storeu_ps( targetData + i, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) ), scale ) );
+		_mm_storeu_ps( targetData + i + 4, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) ), scale ) );
+		_mm_storeu_ps( targetData + i + 8, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) ), scale ) );
+		_mm_storeu_ps( targetData + i + 12, _mm_div_ps( _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) ), scale ) );
+	}
+#elif defined( CINDER_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	const float32x4_t scale = vdupq_n_f32( 255.0f );
+	for( ; i + 16 <= count; i += 16 ) {
+		const uint8x16_t bytes = vld1q_u8( sourceData + i );
+		const uint16x8_t lo = vmovl_u8( vget_low_u8( bytes ) ), hi = vmovl_u8( vget_high_u8( bytes ) );
+		vst1q_f32( targetData + i, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ) ) ), scale ) );
+		vst1q_f32( targetData + i + 4, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ) ) ), scale ) );
+		vst1q_f32( targetData + i + 8, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ) ) ), scale ) );
+		vst1q_f32( targetData + i + 12, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ) ) ), scale ) );
+	}
+#endif
+
+	for( ; i < count; i++ )
+		targetData[i] = CHANTRAIT<float>::convert( sourceData[i] );
+}
+
+#if defined( CINDER_SIMD_SSE2 )
+namespace {
+
+// moves one byte of each 32-bit lane to another position; one of the two shifts is by 32, which clears the lane
+inline __m128i swizzleChannel( __m128i pixels, __m128i left, __m128i right, __m128i mask )
+{
+	return _mm_and_si128( _mm_or_si128( _mm_sll_epi32( pixels, left ), _mm_srl_epi32( pixels, right ) ), mask );
+}
+
+} // anonymous namespace
+#endif
+
+/* SOURCE_INC, TARGET_INC - bytes per source and target pixel */
+template<int SOURCE_INC, int TARGET_INC>
+void ImageSource::rowFuncSwizzle8u( ImageTargetRef target, int32_t row, const void *data )
+{
+	const uint8_t *sourceData = reinterpret_cast<const uint8_t*>( data );
+	uint8_t *targetData = reinterpret_cast<uint8_t*>( target->getRowPointer( row ) );
+	const int32_t width = getWidth();
+	int32_t x = 0;
+
+#if defined( CINDER_SIMD_SSE2 )
+	// Four pixels at a time, each widened into a 32-bit lane. Without SSSE3's pshufb every target channel is a pair of
+	// shifts and a mask of the lane, and channels without a source are or'd in as 0xFF. Three channel rows are loaded and stored 16 bytes at a time, so those leave room at the end of the row for
+	// the scalar loop.
+	__m128i shiftsLeft[4], shiftsRight[4], masks[4];
+	__m128i opaque = _mm_setzero_si128();
+	for( int c = 0; c < 4; c++ ) {
+		const int source = ( c < TARGET_INC ) ? mRowFuncSwizzle[c] : -1;
+		const __m128i channel = _mm_set1_epi32( 0xFF << ( 8 * c ) );
+		shiftsLeft[c] = _mm_cvtsi32_si128( ( source >= 0 && source <= c ) ? 8 * ( c - source ) : 32 );
+		shiftsRight[c] = _mm_cvtsi32_si128( ( source > c ) ? 8 * ( source - c ) : 32 );
+		masks[c] = ( source < 0 ) ? _mm_setzero_si128() : channel;
+		if( source < 0 && c < TARGET_INC )
+			opaque = _mm_or_si128( opaque, channel );
+	}
+	// kept in locals so that they stay in registers across the loop
+	const __m128i left0 = shiftsLeft[0], left1 = shiftsLeft[1], left2 = shiftsLeft[2], left3 = shiftsLeft[3];
+	const __m128i right0 = shiftsRight[0], right1 = shiftsRight[1], right2 = shiftsRight[2], right3 = shiftsRight[3];
+	const __m128i mask0 = masks[0], mask1 = masks[1], mask2 = masks[2], mask3 = masks[3];
+
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lowPixel = _mm_set_epi32( 0, 0x00FFFFFF, 0, 0x00FFFFFF ), highPixel = _mm_set_epi32( 0x0000FFFF, 0xFF000000, 0x0000FFFF, 0xFF000000 );
+	const __m128i lowHalf = _mm_set_epi32( 0, 0, 0x0000FFFF, 0xFFFFFFFF );
+	const int32_t slack = ( SOURCE_INC == 3 || TARGET_INC == 3 ) ? 2 : 0;
+	if( SOURCE_INC == 1 ) {
+		// every target channel of a gray source is either the gray value or opaque, so the value is broadcast across the lane
+		for( ; x + 16 + slack <= width; x += 16 ) {
+			const __m128i gray = _mm_loadu_si128( reinterpret_cast<const __m128i*>( sourceData + x ) );
+			const __m128i pairs[2] = { _mm_unpacklo_epi8( gray, gray ), _mm_unpackhi_epi8( gray, gray ) };
+			for( int p = 0; p < 4; p++ ) {
+				const __m128i result = _mm_or_si128( opaque, ( p & 1 ) ? _mm_unpackhi_epi16( pairs[p / 2], pairs[p / 2] ) : _mm_unpacklo_epi16( pairs[p / 2], pairs[p / 2] ) );
+				uint8_t *t = targetData + ( x + p * 4 ) * TARGET_INC;
+				if( TARGET_INC == 4 )
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( t ), result );
+				else {
+					const __m128i halves = _mm_or_si128( _mm_and_si128( result, lowPixel ), _mm_and_si128( _mm_srli_epi64( result, 8 ), highPixel ) );
+					_mm_storeu_si128( reinterpret_cast<__m128i*>( t ), _mm_or_si128( _mm_and_si128( halves, lowHalf ), _mm_slli_si128( _mm_srli_si128( halves, 8 ), 6 ) ) );
+				}
+			}
+		}
+	}
+	else {
+		for( ; x + 4 + slack <= width; x += 4 ) {
+			const uint8_t *s = sourceData + x * SOURCE_INC;
+			__m128i pixels;
+			if( SOURCE_INC == 2 )
+				pixels = _mm_unpacklo_epi16( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( s ) ), zero );
+			else if( SOURCE_INC == 3 ) {
+				const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s ) );
+				pixels = _mm_unpacklo_epi64( _mm_unpacklo_epi32( bytes, _mm_srli_si128( bytes, 3 ) ), _mm_unpacklo_epi32( _mm_srli_si128( bytes, 6 ), _mm_srli_si128( bytes, 9 ) ) );
+			}
+			else
+				pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s ) );
+
+			__m128i result = _mm_or_si128( opaque, swizzleChannel( pixels, left0, right0, mask0 ) );
+			result = _mm_or_si128( result, swizzleChannel( pixels, left1, right1, mask1 ) );
+			result = _mm_or_si128( result, swizzleChannel( pixels, left2, right2, mask2 ) );
+			if( TARGET_INC == 4 )
+				result = _mm_or_si128( result, swizzleChannel( pixels, left3, right3, mask3 ) );
+
+			uint8_t *t = targetData + x * TARGET_INC;
+			if( TARGET_INC == 4 )
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( t ), result );
+			else {
+				// packs the 3 byte pixels of each 64-bit half together, then the two halves into the low 12 bytes
+				const __m128i halves = _mm_or_si128( _mm_and_si128( result, lowPixel ), _mm_and_si128( _mm_srli_epi64( result, 8 ), highPixel ) );
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( t ), _mm_or_si128( _mm_and_si128( halves, lowHalf ), _mm_slli_si128( _mm_srli_si128( halves, 8 ), 6 ) ) );
+			}
+		}
+	}
+#elif defined( CINDER_SIMD_NEON )
+	// sixteen pixels at a time, deinterleaved into planes; plane 4 is all 0xFF for target channels without a source
+	int select[4];
+	for( int c = 0; c < TARGET_INC; c++ )
+		select[c] = ( mRowFuncSwizzle[c] < 0 ) ? 4 : mRowFuncSwizzle[c];
+
+	uint8x16_t planes[5];
+	planes[4] = vdupq_n_u8( 0xFF );
+	for( ; x + 16 <= width; x += 16 ) {
+		const uint8_t *s = sourceData + x * SOURCE_INC;
+		if( SOURCE_INC == 1 )
+			planes[0] = vld1q_u8( s );
+		else if( SOURCE_INC == 2 ) {
+			const uint8x16x2_t v = vld2q_u8( s );
+			planes[0] = v.val[0]; planes[1] = v.val[1];
+		}
+		else if( SOURCE_INC == 3 ) {
+			const uint8x16x3_t v = vld3q_u8( s );
+			planes[0] = v.val[0]; planes[1] = v.val[1]; planes[2] = v.val[2];
+		}
+		else {
+			const uint8x16x4_t v = vld4q_u8( s );
+			planes[0] = v.val[0]; planes[1] = v.val[1]; planes[2] = v.val[2]; planes[3] = v.val[3];
+		}
+
+		uint8_t *t = targetData + x * TARGET_INC;
+		if( TARGET_INC == 4 ) {
+			uint8x16x4_t v;
+			v.val[0] = planes[select[0]]; v.val[1] = planes[select[1]]; v.val[2] = planes[select[2]]; v.val[3] = planes[select[3]];
+			vst4q_u8( t, v );
+		}
+		else {
+			uint8x16x3_t v;
+			v.val[0] = planes[select[0]]; v.val[1] = planes[select[1]]; v.val[2] = planes[select[2]];
+			vst3q_u8( t, v );
+		}
+	}
+#endif
+
+	for( ; x < width; x++ ) {
+		const uint8_t *s = sourceData + x * SOURCE_INC;
+		uint8_t *t = targetData + x * TARGET_INC;
+		for( int c = 0; c < TARGET_INC; c++ )
+			t[c] = ( mRowFuncSwizzle[c] < 0 ) ? 255 : s[mRowFuncSwizzle[c]];
+	}
 }
 
 
@@ -408,8 +773,86 @@ void loadImageAsync(const fs::path path, std::function<void (ImageSourceRef)> ca
         }
     });
 }
+#else
+void loadImageAsync( const fs::path path, std::function<void (ImageSourceRef)> callback, ImageSource::Options options, std::string extension )
+{
+	ImageLoader::instance().load( path, [callback]( const ImageLoader::Result &result ) {
+		callback( result.getSurface() ? (ImageSourceRef)*result.getSurface() : ImageSourceRef() );
+	}, options, extension );
+}
 #endif
 
+///////////////////////////////////////////////////////////////////////////////
+// ImageSourceRegion
+namespace {
+
+// Receives the rows of a source in its own format, one at a time, and hands each one on once the next row begins.
+class ImageTargetRow : public ImageTarget {
+  public:
+	ImageTargetRow( const ImageSource &source, const std::function<void( int32_t, const void* )> &rowFn )
+		: mRowFn( rowFn ), mRow( source.getRowBytes() ), mPendingRow( -1 )
+	{
+		setSize( source.getWidth(), source.getHeight() );
+		setColorModel( source.getColorModel() );
+		setChannelOrder( source.getChannelOrder() );
+		setDataType( source.getDataType() );
+	}
+
+	void* getRowPointer( int32_t row ) override
+	{
+		if( row != mPendingRow )
+			finalize();
+
+		mPendingRow = row;
+		return mRow.data();
+	}
+
+	void finalize() override
+	{
+		if( mPendingRow >= 0 )
+			mRowFn( mPendingRow, mRow.data() );
+		mPendingRow = -1;
+	}
+
+  private:
+	std::function<void( int32_t, const void* )>	mRowFn;
+	std::vector<uint8_t>						mRow;
+	int32_t										mPendingRow;
+};
+
+// Applies ImageSource::Options::area() and maxSize() to sources that decode whole images, by streaming their rows through processRow().
+class ImageSourceRegion : public ImageSource {
+  public:
+	ImageSourceRegion( const ImageSourceRef &source, const ImageSource::Options &options )
+		: mSource( source )
+	{
+		setSize( source->getWidth(), source->getHeight() );
+		setColorModel( source->getColorModel() );
+		setChannelOrder( source->getChannelOrder() );
+		setDataType( source->getDataType() );
+		setPremultiplied( source->isPremultiplied() );
+		setPixelAspectRatio( source->getPixelAspectRatio() );
+		setFrameCount( source->getCount() );
+		setupRegion( options );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		RowFunc func = setupRowFunc( target );
+		auto rowTarget = make_shared<ImageTargetRow>( *mSource, [=]( int32_t row, const void *data ) {
+			processRow( target, func, row, data );
+		} );
+
+		mSource->load( rowTarget );
+		rowTarget->finalize();
+	}
+
+  private:
+	ImageSourceRef		mSource;
+};
+
+} // anonymous namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 ImageSourceRef loadImage( const fs::path &path, ImageSource::Options options, string extension )
 {
@@ -437,7 +880,13 @@ ImageSourceRef loadImage( DataSourceRef dataSource, ImageSource::Options options
 #else
 		extension = dataSource->getFilePathHint().extension();
 #endif	
-	return ImageIoRegistrar::createSource( dataSource, options, extension );
+	ImageSourceRef source = ImageIoRegistrar::createSource( dataSource, options, extension );
+
+	// sources that can't decode a region themselves are reduced as their rows stream out
+	if( source && options.isRegionSpecified() && ! source->isRegionApplied() )
+		source = ImageSourceRef( new ImageSourceRegion( source, options ) );
+
+	return source;
 }
 
 void writeImage( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options, std::string extension )
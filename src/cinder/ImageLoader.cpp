@@ -0,0 +1,268 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/ImageLoader.h"
+#include "cinder/ThreadPool.h"
+#include "cinder/app/AppBase.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder {
+
+ImageLoader& ImageLoader::instance()
+{
+	static ImageLoader sInstance( (Options()) );
+	return sInstance;
+}
+
+ImageLoader::ImageLoader( const Options &options )
+	: mCacheCapacity( options.getCacheCapacity() ), mCacheSize( 0 ), mConnectToAppUpdate( options.isConnectToAppUpdateEnabled() ),
+	mThreadPool( ThreadPool::create( options.getNumThreads() ) )
+{
+	if( mConnectToAppUpdate && app::AppBase::get() )
+		connectAppUpdate();
+}
+
+ImageLoader::~ImageLoader()
+{
+	mConnectionAppUpdate.disconnect();
+
+	// workers that haven't started yet find an empty queue, so the pool only waits for decodes that are in progress
+	cancelAll();
+	mThreadPool.reset();
+}
+
+string ImageLoader::makeKey( const fs::path &path, const ImageSource::Options &options, const string &extension )
+{
+	const Area &area = options.getArea();
+	const ivec2 &maxSize = options.getMaxSize();
+	string key = path.string() + '\n' + extension + '\n' + to_string( options.getIndex() );
+	if( options.isRegionSpecified() ) {
+		key += '\n' + to_string( area.x1 ) + ' ' + to_string( area.y1 ) + ' ' + to_string( area.x2 ) + ' ' + to_string( area.y2 );
+		key += '\n' + to_string( maxSize.x ) + ' ' + to_string( maxSize.y );
+	}
+
+	return key;
+}
+
+void ImageLoader::load( const fs::path &path, const CallbackFn &callback, const ImageSource::Options &options, const string &extension )
+{
+	const string key = makeKey( path, options, extension );
+
+	{
+		lock_guard<mutex> lock( mMutex );
+
+		if( mConnectToAppUpdate && ! mConnectionAppUpdate.isConnected() && app::AppBase::get() )
+			connectAppUpdate();
+
+		auto requestIt = mRequests.find( key );
+		if( requestIt != mRequests.end() ) {
+			if( callback )
+				requestIt->second->mCallbacks.push_back( callback );
+			return;
+		}
+
+		auto request = make_shared<Request>();
+		request->mKey = key;
+		request->mPath = path;
+		request->mOptions = options;
+		request->mExtension = extension;
+		request->mResult.mPath = path;
+		if( callback )
+			request->mCallbacks.push_back( callback );
+
+		auto cacheIt = mCacheIndex.find( key );
+		if( cacheIt != mCacheIndex.end() ) {
+			mCache.splice( mCache.begin(), mCache, cacheIt->second );
+			request->mResult.mSurface = cacheIt->second->mSurface;
+			request->mResult.mFromCache = true;
+			mCompleted.push_back( request );
+			return;
+		}
+
+		mRequests[key] = request;
+		mQueue.push_back( request );
+	}
+
+	mThreadPool->enqueue( [this] { decodeNext(); } );
+}
+
+void ImageLoader::decodeNext()
+{
+	shared_ptr<Request> request;
+	{
+		lock_guard<mutex> lock( mMutex );
+		// one worker task is queued per request, but cancel() may have removed it in the meantime
+		if( mQueue.empty() )
+			return;
+
+		request = mQueue.front();
+		mQueue.pop_front();
+	}
+
+	Result &result = request->mResult;
+	try {
+		auto imageSource = loadImage( request->mPath, request->mOptions, request->mExtension );
+		result.mSurface = Surface8u::create( imageSource );
+	}
+	catch( std::exception &exc ) {
+		result.mError = exc.what();
+		if( result.mError.empty() )
+			result.mError = "failed to load image";
+	}
+	catch( ... ) {
+		result.mError = "failed to load image";
+	}
+
+	lock_guard<mutex> lock( mMutex );
+	if( result.mSurface )
+		insertCachedImpl( request->mKey, result.mSurface );
+
+	mRequests.erase( request->mKey );
+	mCompleted.push_back( request );
+}
+
+bool ImageLoader::cancel( const fs::path &path, const ImageSource::Options &options, const string &extension )
+{
+	const string key = makeKey( path, options, extension );
+
+	lock_guard<mutex> lock( mMutex );
+	auto queueIt = find_if( mQueue.begin(), mQueue.end(), [&key]( const shared_ptr<Request> &request ) { return request->mKey == key; } );
+	if( queueIt == mQueue.end() )
+		return false;
+
+	mQueue.erase( queueIt );
+	mRequests.erase( key );
+	return true;
+}
+
+void ImageLoader::cancelAll()
+{
+	lock_guard<mutex> lock( mMutex );
+	for( const auto &request : mQueue )
+		mRequests.erase( request->mKey );
+
+	mQueue.clear();
+}
+
+void ImageLoader::update()
+{
+	vector<shared_ptr<Request>> completed;
+	{
+		lock_guard<mutex> lock( mMutex );
+		completed.swap( mCompleted );
+	}
+
+	for( const auto &request : completed ) {
+		for( const auto &callback : request->mCallbacks )
+			callback( request->mResult );
+
+		mSignalLoaded.emit( request->mResult );
+	}
+}
+
+size_t ImageLoader::getNumPending() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mRequests.size() + mCompleted.size();
+}
+
+Surface8uRef ImageLoader::getCached( const fs::path &path, const ImageSource::Options &options, const string &extension )
+{
+	lock_guard<mutex> lock( mMutex );
+	auto cacheIt = mCacheIndex.find( makeKey( path, options, extension ) );
+	if( cacheIt == mCacheIndex.end() )
+		return nullptr;
+
+	mCache.splice( mCache.begin(), mCache, cacheIt->second );
+	return cacheIt->second->mSurface;
+}
+
+bool ImageLoader::isCached( const fs::path &path, const ImageSource::Options &options, const string &extension ) const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mCacheIndex.count( makeKey( path, options, extension ) ) != 0;
+}
+
+void ImageLoader::setCacheCapacity( size_t bytes )
+{
+	lock_guard<mutex> lock( mMutex );
+	mCacheCapacity = bytes;
+	evictImpl( mCacheCapacity );
+}
+
+size_t ImageLoader::getCacheCapacity() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mCacheCapacity;
+}
+
+size_t ImageLoader::getCacheSize() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mCacheSize;
+}
+
+size_t ImageLoader::getNumCached() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mCache.size();
+}
+
+void ImageLoader::clearCache()
+{
+	lock_guard<mutex> lock( mMutex );
+	evictImpl( 0 );
+}
+
+void ImageLoader::insertCachedImpl( const string &key, const Surface8uRef &surface )
+{
+	const size_t numBytes = surface->getRowBytes() * surface->getHeight();
+	if( numBytes > mCacheCapacity || mCacheIndex.count( key ) )
+		return;
+
+	evictImpl( mCacheCapacity - numBytes );
+
+	mCache.push_front( CacheEntry{ key, surface, numBytes } );
+	mCacheIndex[key] = mCache.begin();
+	mCacheSize += numBytes;
+}
+
+void ImageLoader::evictImpl( size_t capacity )
+{
+	while( mCacheSize > capacity ) {
+		const CacheEntry &entry = mCache.back();
+		mCacheSize -= entry.mNumBytes;
+		mCacheIndex.erase( entry.mKey );
+		mCache.pop_back();
+	}
+}
+
+void ImageLoader::connectAppUpdate()
+{
+	mConnectionAppUpdate = app::AppBase::get()->getSignalUpdate().connect( bind( &ImageLoader::update, this ) );
+}
+
+} // namespace cinder
@@ -57,7 +57,7 @@ void ImageSourceFileStbImage::registerSelf()
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSourceFileStbImage
-ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
+ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options options )
 	: mData8u( nullptr ), mData32f( nullptr ), mRowBytes( 0 )
 {
 	int width = 0, height = 0, components = 0;
@@ -122,6 +122,10 @@ ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, I
 		default:
 			throw ImageIoException();
 	}
+
+	// stb_image can only decode whole images, but cropping and reducing while copying rows still keeps the target small
+	if( options.isRegionSpecified() )
+		setupRegion( options );
 }
 
 
@@ -137,9 +141,9 @@ void ImageSourceFileStbImage::load( ImageTargetRef target )
 {
 	ImageSource::RowFunc func = setupRowFunc( target );
 	const uint8_t *data = ( mData8u ) ? mData8u : reinterpret_cast<uint8_t*>( mData32f );
-	for( int32_t row = 0; row < mHeight; ++row ) {
-		((*this).*func)( target, row, data + row * mRowBytes );
-	}
+	int32_t row = mSourceArea.y1;
+	while( processRow( target, func, row, data + row * mRowBytes ) )
+		++row;
 }
 
 } // namespace cinder
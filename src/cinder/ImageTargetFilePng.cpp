@@ -0,0 +1,327 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/ImageTargetFilePng.h"
+#include "cinder/ThreadPool.h"
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// bands smaller than this compress noticeably worse, as every band starts with an empty dictionary
+const size_t MIN_BAND_BYTES = 256 * 1024;
+
+const uint8_t PNG_SIGNATURE[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+
+void appendUint32( vector<uint8_t> *data, uint32_t value )
+{
+	data->push_back( uint8_t( value >> 24 ) );
+	data->push_back( uint8_t( value >> 16 ) );
+	data->push_back( uint8_t( value >> 8 ) );
+	data->push_back( uint8_t( value ) );
+}
+
+// writes a chunk whose type and contents are in \a typeAndData, which is also what the CRC covers
+void writeChunk( const OStreamRef &stream, const uint8_t *typeAndData, size_t size, uint32_t crc )
+{
+	vector<uint8_t> length, footer;
+	appendUint32( &length, uint32_t( size - 4 ) );
+	appendUint32( &footer, crc );
+	stream->writeData( length.data(), length.size() );
+	stream->writeData( typeAndData, size );
+	stream->writeData( footer.data(), footer.size() );
+}
+
+void writeChunk( const OStreamRef &stream, const vector<uint8_t> &typeAndData )
+{
+	writeChunk( stream, typeAndData.data(), typeAndData.size(), (uint32_t)crc32( 0, typeAndData.data(), (uInt)typeAndData.size() ) );
+}
+
+inline uint8_t paethPredictor( int a, int b, int c )
+{
+	const int p = a + b - c;
+	const int pa = abs( p - a ), pb = abs( p - b ), pc = abs( p - c );
+	if( pa <= pb && pa <= pc )
+		return uint8_t( a );
+	else if( pb <= pc )
+		return uint8_t( b );
+	else
+		return uint8_t( c );
+}
+
+// Writes the filter type byte followed by the filtered row to \a out. \a prev is the unfiltered previous row, all zeros for the first row.
+void filterRow( ImageTarget::Options::PngFilter filter, const uint8_t *prev, const uint8_t *cur, size_t rowBytes, size_t bpp, uint8_t *out )
+{
+	out[0] = uint8_t( filter );
+	uint8_t *result = out + 1;
+	switch( filter ) {
+		case ImageTarget::Options::PNG_FILTER_SUB:
+			for( size_t i = 0; i < rowBytes; i++ )
+				result[i] = cur[i] - ( i >= bpp ? cur[i - bpp] : 0 );
+		break;
+		case ImageTarget::Options::PNG_FILTER_UP:
+			for( size_t i = 0; i < rowBytes; i++ )
+				result[i] = cur[i] - prev[i];
+		break;
+		case ImageTarget::Options::PNG_FILTER_AVERAGE:
+			for( size_t i = 0; i < rowBytes; i++ )
+				result[i] = cur[i] - uint8_t( ( ( i >= bpp ? cur[i - bpp] : 0 ) + prev[i] ) / 2 );
+		break;
+		case ImageTarget::Options::PNG_FILTER_PAETH:
+			for( size_t i = 0; i < rowBytes; i++ )
+				result[i] = cur[i] - ( i >= bpp ? paethPredictor( cur[i - bpp], prev[i], prev[i - bpp] ) : paethPredictor( 0, prev[i], 0 ) );
+		break;
+		default:
+			out[0] = uint8_t( ImageTarget::Options::PNG_FILTER_NONE );
+			copy( cur, cur + rowBytes, result );
+	}
+}
+
+// The usual heuristic: keep the filter whose output has the smallest sum when read as signed bytes.
+void filterRowAdaptive( const uint8_t *prev, const uint8_t *cur, size_t rowBytes, size_t bpp, uint8_t *out, uint8_t *scratch )
+{
+	size_t bestSum = SIZE_MAX;
+	for( int filter = ImageTarget::Options::PNG_FILTER_NONE; filter <= ImageTarget::Options::PNG_FILTER_PAETH; filter++ ) {
+		uint8_t *candidate = ( bestSum == SIZE_MAX ) ? out : scratch;
+		filterRow( ImageTarget::Options::PngFilter( filter ), prev, cur, rowBytes, bpp, candidate );
+
+		size_t sum = 0;
+		for( size_t i = 1; i <= rowBytes && sum < bestSum; i++ )
+			sum += abs( int( int8_t( candidate[i] ) ) );
+
+		if( sum < bestSum ) {
+			bestSum = sum;
+			if( candidate != out )
+				copy( candidate, candidate + rowBytes + 1, out );
+		}
+	}
+}
+
+// One band of rows, compressed as a part of the image's zlib stream and held as the type and contents of an IDAT chunk.
+struct Band {
+	vector<uint8_t>		mIdat;
+	uLong				mAdler, mNumFilteredBytes;
+	uLong				mCrc;
+};
+
+} // anonymous namespace
+
+void ImageTargetFilePng::registerSelf()
+{
+	static bool alreadyRegistered = false;
+	const int32_t PRIORITY = 1;
+
+	if( alreadyRegistered )
+		return;
+	alreadyRegistered = true;
+
+	ImageIoRegistrar::registerTargetType( "png", ImageTargetFilePng::create, PRIORITY, "png" );
+}
+
+ImageTargetRef ImageTargetFilePng::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+{
+	return ImageTargetRef( new ImageTargetFilePng( dataTarget, imageSource, options ) );
+}
+
+ImageTargetFilePng::ImageTargetFilePng( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options )
+	: mOptions( options ), mDataTarget( dataTarget )
+{
+	if( ! ( mDataTarget->providesFilePath() || mDataTarget->getStream() ) )
+		throw ImageIoExceptionFailedWrite( "No file path or stream provided" );
+
+	setSize( imageSource->getWidth(), imageSource->getHeight() );
+	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
+
+	switch( cm ) {
+		case ImageIo::ColorModel::CM_RGB:
+			mNumComponents = ( imageSource->hasAlpha() ) ? 4 : 3;
+			setColorModel( ImageIo::ColorModel::CM_RGB );
+			setChannelOrder( ( mNumComponents == 4 ) ? ImageIo::ChannelOrder::RGBA : ImageIo::ChannelOrder::RGB );
+		break;
+		case ImageIo::ColorModel::CM_GRAY:
+			mNumComponents = ( imageSource->hasAlpha() ) ? 2 : 1;
+			setColorModel( ImageIo::ColorModel::CM_GRAY );
+			setChannelOrder( ( mNumComponents == 2 ) ? ImageIo::ChannelOrder::YA : ImageIo::ChannelOrder::Y );
+		break;
+		default:
+			throw ImageIoExceptionIllegalColorModel();
+	}
+
+	// 16 bit sources are kept lossless, everything else is written as 8 bit like the other PNG encoders do
+	mBitDepth = ( imageSource->getDataType() == ImageIo::UINT16 ) ? 16 : 8;
+	setDataType( ( mBitDepth == 16 ) ? ImageIo::UINT16 : ImageIo::UINT8 );
+
+	mRowBytes = mWidth * mNumComponents * ( mBitDepth / 8 );
+	mData.resize( mHeight * mRowBytes );
+}
+
+void* ImageTargetFilePng::getRowPointer( int32_t row )
+{
+	return &mData[row * mRowBytes];
+}
+
+void ImageTargetFilePng::finalize()
+{
+	if( mHeight <= 0 || mRowBytes == 0 )
+		throw ImageIoExceptionFailedWrite( "Cannot write an empty PNG" );
+
+	const size_t bpp = mNumComponents * mBitDepth / 8;
+	const int level = ( mOptions.getCompressionLevel() < 0 ) ? 6 : std::min( mOptions.getCompressionLevel(), 9 );
+	const int strategy = ( mOptions.getPngFilter() == ImageTarget::Options::PNG_FILTER_NONE ) ? Z_DEFAULT_STRATEGY : Z_FILTERED;
+
+	// split the rows into bands, a couple per thread so that uneven bands balance out
+	const size_t numThreads = ( mOptions.getNumThreads() == 0 ) ? ThreadPool::getDefault()->getNumThreads() + 1 : mOptions.getNumThreads();
+	const size_t height = (size_t)mHeight;
+	const size_t minBandRows = std::max<size_t>( 1, MIN_BAND_BYTES / ( mRowBytes + 1 ) );
+	size_t numBands = ( numThreads <= 1 ) ? 1 : std::min( ( height + minBandRows - 1 ) / minBandRows, numThreads * 2 );
+	numBands = std::max<size_t>( numBands, 1 );
+	const size_t bandRows = ( height + numBands - 1 ) / numBands;
+	numBands = std::max<size_t>( ( height + bandRows - 1 ) / bandRows, 1 );
+
+	vector<Band> bands( numBands );
+	auto encodeBand = [&]( size_t bandIndex ) {
+		const size_t y0 = bandIndex * bandRows, y1 = std::min( y0 + bandRows, height );
+		vector<uint8_t> filtered( ( y1 - y0 ) * ( mRowBytes + 1 ) );
+		vector<uint8_t> scratch( mRowBytes + 1 ), zeros( mRowBytes, 0 );
+		// 16 bit samples are big endian in the file, so rows are swapped into these before filtering
+		vector<uint8_t> swapped[2];
+		if( mBitDepth == 16 ) {
+			swapped[0].resize( mRowBytes );
+			swapped[1].resize( mRowBytes );
+		}
+
+		auto rowData = [&]( size_t y ) -> const uint8_t* {
+			const uint8_t *row = &mData[y * mRowBytes];
+			if( mBitDepth == 8 )
+				return row;
+			uint8_t *result = swapped[y & 1].data();
+			for( size_t i = 0; i < mRowBytes; i += 2 ) {
+				result[i] = row[i + 1];
+				result[i + 1] = row[i];
+			}
+			return result;
+		};
+
+		const uint8_t *prev = ( y0 == 0 ) ? zeros.data() : rowData( y0 - 1 );
+		for( size_t y = y0; y < y1; y++ ) {
+			const uint8_t *cur = rowData( y );
+			uint8_t *out = &filtered[( y - y0 ) * ( mRowBytes + 1 )];
+			if( mOptions.getPngFilter() == ImageTarget::Options::PNG_FILTER_ADAPTIVE )
+				filterRowAdaptive( prev, cur, mRowBytes, bpp, out, scratch.data() );
+			else
+				filterRow( mOptions.getPngFilter(), prev, cur, mRowBytes, bpp, out );
+			prev = cur;
+		}
+
+		Band &band = bands[bandIndex];
+		band.mNumFilteredBytes = (uLong)filtered.size();
+		band.mAdler = adler32( adler32( 0, Z_NULL, 0 ), filtered.data(), (uInt)filtered.size() );
+
+		// Raw deflate streams; every band but the last ends with a sync flush, which byte aligns it without marking the
+		// final block, so that the bands concatenate into one stream. The first band carries the zlib header.
+		z_stream zs = {};
+		if( deflateInit2( &zs, level, Z_DEFLATED, -15, 8, strategy ) != Z_OK )
+			throw ImageIoExceptionFailedWrite( "Failed to initialize zlib" );
+
+		const bool first = ( bandIndex == 0 ), last = ( bandIndex == numBands - 1 );
+		const size_t headerSize = 4 + ( first ? 2 : 0 );
+		band.mIdat.resize( headerSize + deflateBound( &zs, (uLong)filtered.size() ) + 16 );
+		band.mIdat[0] = 'I'; band.mIdat[1] = 'D'; band.mIdat[2] = 'A'; band.mIdat[3] = 'T';
+		if( first ) {
+			const uint8_t cmf = 0x78, flevel = ( level < 2 ) ? 0 : ( level < 6 ) ? 1 : ( level == 6 ) ? 2 : 3;
+			uint8_t flg = uint8_t( flevel << 6 );
+			flg += uint8_t( 31 - ( cmf * 256 + flg ) % 31 );
+			band.mIdat[4] = cmf;
+			band.mIdat[5] = flg;
+		}
+
+		zs.next_in = filtered.data();
+		zs.avail_in = (uInt)filtered.size();
+		size_t used = headerSize;
+		int status;
+		for( ;; ) {
+			zs.next_out = &band.mIdat[used];
+			zs.avail_out = (uInt)( band.mIdat.size() - used );
+			status = deflate( &zs, last ? Z_FINISH : Z_SYNC_FLUSH );
+			used = band.mIdat.size() - zs.avail_out;
+			const bool done = last ? ( status == Z_STREAM_END ) : ( status == Z_OK && zs.avail_out != 0 );
+			if( done || ( status != Z_OK && status != Z_BUF_ERROR ) )
+				break;
+			band.mIdat.resize( band.mIdat.size() * 2 );
+		}
+		deflateEnd( &zs );
+
+		if( status != ( last ? Z_STREAM_END : Z_OK ) || zs.avail_in != 0 )
+			throw ImageIoExceptionFailedWrite( "Failed to compress PNG data" );
+
+		band.mIdat.resize( used );
+		band.mCrc = crc32( 0, band.mIdat.data(), (uInt)band.mIdat.size() );
+	};
+
+	if( numBands == 1 )
+		encodeBand( 0 );
+	else
+		ThreadPool::getDefault()->parallelFor( 0, numBands, [&]( size_t begin, size_t end ) {
+			for( size_t b = begin; b < end; b++ )
+				encodeBand( b );
+		} );
+
+	// the stream ends with the Adler-32 of all the filtered data, which is appended to the last band's chunk
+	uLong adler = bands[0].mAdler;
+	for( size_t b = 1; b < numBands; b++ )
+		adler = adler32_combine( adler, bands[b].mAdler, bands[b].mNumFilteredBytes );
+
+	Band &lastBand = bands.back();
+	const size_t adlerOffset = lastBand.mIdat.size();
+	appendUint32( &lastBand.mIdat, (uint32_t)adler );
+	lastBand.mCrc = crc32( lastBand.mCrc, &lastBand.mIdat[adlerOffset], 4 );
+
+	static const uint8_t colorTypes[5] = { 0, 0, 4, 2, 6 }; // by number of components
+	vector<uint8_t> ihdr = { 'I', 'H', 'D', 'R' };
+	appendUint32( &ihdr, (uint32_t)mWidth );
+	appendUint32( &ihdr, (uint32_t)mHeight );
+	ihdr.push_back( mBitDepth );
+	ihdr.push_back( colorTypes[mNumComponents] );
+	ihdr.push_back( 0 ); // deflate
+	ihdr.push_back( 0 ); // adaptive filtering
+	ihdr.push_back( 0 ); // no interlacing
+
+	OStreamRef stream = mDataTarget->getStream();
+	if( ! stream )
+		throw ImageIoExceptionFailedWrite( "Failed to open stream for PNG" );
+
+	stream->writeData( PNG_SIGNATURE, sizeof( PNG_SIGNATURE ) );
+	writeChunk( stream, ihdr );
+	for( const auto &band : bands )
+		writeChunk( stream, band.mIdat.data(), band.mIdat.size(), (uint32_t)band.mCrc );
+	writeChunk( stream, vector<uint8_t>{ 'I', 'E', 'N', 'D' } );
+}
+
+} // namespace cinder
@@ -0,0 +1,142 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/ImageWriter.h"
+#include "cinder/ThreadPool.h"
+#include "cinder/app/AppBase.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder {
+
+ImageWriter::ImageWriter( const Options &options )
+	: mNumWriting( 0 ), mMaxQueued( options.getMaxQueued() ), mConnectToAppUpdate( options.isConnectToAppUpdateEnabled() ),
+	mThreadPool( ThreadPool::create( std::max<size_t>( options.getNumThreads(), 1 ) ) )
+{
+	if( mConnectToAppUpdate && app::AppBase::get() )
+		connectAppUpdate();
+}
+
+ImageWriter::~ImageWriter()
+{
+	mConnectionAppUpdate.disconnect();
+
+	flush();
+	mThreadPool.reset();
+}
+
+void ImageWriter::write( const fs::path &path, const ImageSourceRef &imageSource, const ImageTarget::Options &options, const string &extension, const CallbackFn &callback )
+{
+	auto request = make_shared<Request>();
+	request->mImageSource = imageSource;
+	request->mOptions = options;
+	request->mExtension = extension;
+	request->mCallback = callback;
+	request->mResult.mPath = path;
+
+	{
+		unique_lock<mutex> lock( mMutex );
+
+		if( mConnectToAppUpdate && ! mConnectionAppUpdate.isConnected() && app::AppBase::get() )
+			connectAppUpdate();
+
+		if( mMaxQueued != 0 )
+			mCond.wait( lock, [this] { return mQueue.size() < mMaxQueued; } );
+
+		mQueue.push_back( request );
+	}
+
+	mThreadPool->enqueue( [this] { writeNext(); } );
+}
+
+void ImageWriter::writeNext()
+{
+	shared_ptr<Request> request;
+	{
+		lock_guard<mutex> lock( mMutex );
+		request = mQueue.front();
+		mQueue.pop_front();
+		mNumWriting++;
+	}
+	mCond.notify_all();
+
+	Result &result = request->mResult;
+	try {
+		writeImage( result.mPath, request->mImageSource, request->mOptions, request->mExtension );
+	}
+	catch( std::exception &exc ) {
+		result.mError = exc.what();
+		if( result.mError.empty() )
+			result.mError = "failed to write image";
+	}
+	catch( ... ) {
+		result.mError = "failed to write image";
+	}
+
+	// the source may hold a large copy of the pixels, so it is released before the request waits for update()
+	request->mImageSource.reset();
+
+	{
+		lock_guard<mutex> lock( mMutex );
+		mNumWriting--;
+		mCompleted.push_back( request );
+	}
+	mCond.notify_all();
+}
+
+void ImageWriter::flush()
+{
+	unique_lock<mutex> lock( mMutex );
+	mCond.wait( lock, [this] { return mQueue.empty() && mNumWriting == 0; } );
+}
+
+void ImageWriter::update()
+{
+	vector<shared_ptr<Request>> completed;
+	{
+		lock_guard<mutex> lock( mMutex );
+		completed.swap( mCompleted );
+	}
+
+	for( const auto &request : completed ) {
+		if( request->mCallback )
+			request->mCallback( request->mResult );
+
+		mSignalWritten.emit( request->mResult );
+	}
+}
+
+size_t ImageWriter::getNumPending() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mQueue.size() + mNumWriting + mCompleted.size();
+}
+
+void ImageWriter::connectAppUpdate()
+{
+	mConnectionAppUpdate = app::AppBase::get()->getSignalUpdate().connect( bind( &ImageWriter::update, this ) );
+}
+
+} // namespace cinder
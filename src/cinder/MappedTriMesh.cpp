@@ -0,0 +1,504 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/MappedTriMesh.h"
+#include "cinder/Buffer.h"
+#include "cinder/Stream.h"
+
+#if defined( CINDER_MSW_DESKTOP )
+	#include <windows.h>
+#elif defined( CINDER_POSIX )
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+#include <cstring>
+#include <limits>
+
+using namespace std;
+
+namespace cinder {
+
+namespace {
+
+// File layout, all values little endian:
+//	FileHeader
+//	AttribEntry[numAttribs]
+//	indices and attribute arrays, each starting at a multiple of SECTION_ALIGNMENT
+const char		FILE_MAGIC[8] = { 'C', 'I', 'T', 'R', 'I', 'M', 'S', 'H' };
+const uint32_t	FILE_VERSION = 1;
+const uint64_t	SECTION_ALIGNMENT = 64;
+
+struct FileHeader {
+	char		mMagic[8];
+	uint32_t	mVersion;
+	uint32_t	mNumAttribs;
+	uint64_t	mNumVertices;
+	uint64_t	mNumIndices;
+	uint64_t	mIndicesOffset;
+	uint8_t		mReserved[24];
+};
+
+struct AttribEntry {
+	uint32_t	mAttribMask; // same identifiers as TriMesh::write()
+	uint8_t		mDims;
+	uint8_t		mReserved[3];
+	uint64_t	mOffset;
+};
+
+static_assert( sizeof( FileHeader ) == 64, "unexpected FileHeader padding" );
+static_assert( sizeof( AttribEntry ) == 16, "unexpected AttribEntry padding" );
+
+uint64_t alignSection( uint64_t offset )
+{
+	return ( offset + SECTION_ALIGNMENT - 1 ) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+}
+
+std::array<uint8_t, geom::NUM_ATTRIBS> attribDimsFromFormat( const TriMesh::Format &format )
+{
+	std::array<uint8_t, geom::NUM_ATTRIBS> result;
+	result.fill( 0 );
+	result[geom::POSITION] = format.mPositionsDims;
+	result[geom::NORMAL] = format.mNormalsDims;
+	result[geom::TANGENT] = format.mTangentsDims;
+	result[geom::BITANGENT] = format.mBitangentsDims;
+	result[geom::COLOR] = format.mColorsDims;
+	result[geom::TEX_COORD_0] = format.mTexCoords0Dims;
+	result[geom::TEX_COORD_1] = format.mTexCoords1Dims;
+	result[geom::TEX_COORD_2] = format.mTexCoords2Dims;
+	result[geom::TEX_COORD_3] = format.mTexCoords3Dims;
+	return result;
+}
+
+#if defined( CINDER_MSW_DESKTOP )
+std::shared_ptr<const void> mapFile( const fs::path &path, size_t *resultSize )
+{
+	HANDLE file = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL );
+	if( file == INVALID_HANDLE_VALUE )
+		throw MappedTriMeshExc( "MappedTriMesh: failed to open " + path.string() );
+
+	LARGE_INTEGER size;
+	if( ! ::GetFileSizeEx( file, &size ) || size.QuadPart == 0 ) {
+		::CloseHandle( file );
+		throw MappedTriMeshExc( "MappedTriMesh: " + path.string() + " is empty or unreadable" );
+	}
+
+	// the view keeps the mapping and the file open after their handles are closed
+	HANDLE mapping = ::CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	::CloseHandle( file );
+	if( ! mapping )
+		throw MappedTriMeshExc( "MappedTriMesh: failed to map " + path.string() );
+
+	void *data = ::MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+	::CloseHandle( mapping );
+	if( ! data )
+		throw MappedTriMeshExc( "MappedTriMesh: failed to map " + path.string() );
+
+	*resultSize = (size_t)size.QuadPart;
+	return std::shared_ptr<const void>( data, []( const void *p ) { ::UnmapViewOfFile( p ); } );
+}
+#elif defined( CINDER_POSIX )
+std::shared_ptr<const void> mapFile( const fs::path &path, size_t *resultSize )
+{
+	int file = ::open( path.string().c_str(), O_RDONLY );
+	if( file < 0 )
+		throw MappedTriMeshExc( "MappedTriMesh: failed to open " + path.string() );
+
+	struct stat fileStat;
+	if( ::fstat( file, &fileStat ) != 0 || fileStat.st_size == 0 ) {
+		::close( file );
+		throw MappedTriMeshExc( "MappedTriMesh: " + path.string() + " is empty or unreadable" );
+	}
+
+	size_t size = (size_t)fileStat.st_size;
+	void *data = ::mmap( nullptr, size, PROT_READ, MAP_PRIVATE, file, 0 );
+	::close( file ); // the mapping keeps the file open
+	if( data == MAP_FAILED )
+		throw MappedTriMeshExc( "MappedTriMesh: failed to map " + path.string() );
+
+	*resultSize = size;
+	return std::shared_ptr<const void>( data, [size]( const void *p ) { ::munmap( const_cast<void*>( p ), size ); } );
+}
+#endif
+
+} // anonymous namespace
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// MappedTriMesh
+MappedTriMesh::MappedTriMesh( const fs::path &path )
+{
+#if defined( CINDER_MSW_DESKTOP ) || defined( CINDER_POSIX )
+	mStorage = mapFile( path, &mDataSize );
+	mIsMapped = true;
+#else
+	auto stream = loadFileStream( path );
+	if( ! stream )
+		throw MappedTriMeshExc( "MappedTriMesh: failed to open " + path.string() );
+
+	BufferRef buffer = loadStreamBuffer( stream );
+	mStorage = std::shared_ptr<const void>( buffer, buffer->getData() );
+	mDataSize = buffer->getSize();
+	mIsMapped = false;
+#endif
+	mData = static_cast<const uint8_t*>( mStorage.get() );
+	parse();
+}
+
+MappedTriMesh::MappedTriMesh( const DataSourceRef &dataSource )
+{
+#if ( defined( CINDER_MSW_DESKTOP ) || defined( CINDER_POSIX ) ) && ! defined( CINDER_ANDROID ) // Android asset paths can't be mapped
+	if( dataSource->isFilePath() ) {
+		mStorage = mapFile( dataSource->getFilePath(), &mDataSize );
+		mIsMapped = true;
+	}
+	else
+#endif
+	{
+		BufferRef buffer = dataSource->getBuffer();
+		mStorage = std::shared_ptr<const void>( buffer, buffer->getData() );
+		mDataSize = buffer->getSize();
+		mIsMapped = false;
+	}
+	mData = static_cast<const uint8_t*>( mStorage.get() );
+	parse();
+}
+
+void MappedTriMesh::parse()
+{
+	mAttribData.fill( nullptr );
+	mAttribDims.fill( 0 );
+
+	if( mDataSize < sizeof( FileHeader ) )
+		throw MappedTriMeshExc( "MappedTriMesh: data is too small to contain a mesh" );
+
+	FileHeader header;
+	memcpy( &header, mData, sizeof( header ) );
+	if( memcmp( header.mMagic, FILE_MAGIC, sizeof( FILE_MAGIC ) ) != 0 )
+		throw MappedTriMeshExc( "MappedTriMesh: data isn't a mesh written by MappedTriMeshWriter" );
+	if( header.mVersion != FILE_VERSION )
+		throw MappedTriMeshExc( "MappedTriMesh: unsupported version " + to_string( header.mVersion ) + ", expected version " + to_string( FILE_VERSION ) );
+	if( header.mNumAttribs > geom::NUM_ATTRIBS || sizeof( FileHeader ) + header.mNumAttribs * sizeof( AttribEntry ) > mDataSize )
+		throw MappedTriMeshExc( "MappedTriMesh: invalid attribute table" );
+	if( header.mNumVertices > numeric_limits<uint32_t>::max() || header.mNumIndices % 3 != 0 )
+		throw MappedTriMeshExc( "MappedTriMesh: invalid vertex or index count" );
+
+	mVersion = header.mVersion;
+	mNumVertices = (size_t)header.mNumVertices;
+	mNumIndices = (size_t)header.mNumIndices;
+
+	// returns a pointer to the array of 'numBytes' at 'offset', after checking that it lies within the data
+	auto section = [this]( uint64_t offset, uint64_t numBytes ) -> const uint8_t* {
+		if( numBytes == 0 )
+			return nullptr;
+		if( offset % 4 != 0 || offset > mDataSize || numBytes > mDataSize - offset )
+			throw MappedTriMeshExc( "MappedTriMesh: data is truncated or corrupt" );
+		return mData + offset;
+	};
+
+	if( header.mNumIndices > numeric_limits<uint64_t>::max() / sizeof( uint32_t ) )
+		throw MappedTriMeshExc( "MappedTriMesh: invalid vertex or index count" );
+	mIndices = reinterpret_cast<const uint32_t*>( section( header.mIndicesOffset, header.mNumIndices * sizeof( uint32_t ) ) );
+
+	for( uint32_t i = 0; i < header.mNumAttribs; ++i ) {
+		AttribEntry entry;
+		memcpy( &entry, mData + sizeof( FileHeader ) + i * sizeof( AttribEntry ), sizeof( entry ) );
+
+		geom::Attrib attr;
+		try {
+			attr = TriMesh::fromMask( entry.mAttribMask );
+		}
+		catch( Exception & ) {
+			throw MappedTriMeshExc( "MappedTriMesh: unknown attribute" );
+		}
+		if( entry.mDims < 1 || entry.mDims > 4 || mAttribDims[attr] != 0 )
+			throw MappedTriMeshExc( "MappedTriMesh: invalid attribute " + geom::attribToString( attr ) );
+
+		mAttribDims[attr] = entry.mDims;
+		mAttribData[attr] = reinterpret_cast<const float*>( section( entry.mOffset, header.mNumVertices * entry.mDims * sizeof( float ) ) );
+	}
+}
+
+const float* MappedTriMesh::getAttribData( geom::Attrib attr ) const
+{
+	if( attr >= geom::NUM_ATTRIBS )
+		return nullptr;
+
+	return mAttribData[attr];
+}
+
+uint8_t MappedTriMesh::getAttribDims( geom::Attrib attr ) const
+{
+	if( attr >= geom::NUM_ATTRIBS )
+		return 0;
+
+	return mAttribDims[attr];
+}
+
+geom::AttribSet MappedTriMesh::getAvailableAttribs() const
+{
+	geom::AttribSet result;
+	for( int attr = 0; attr < geom::NUM_ATTRIBS; ++attr ) {
+		if( mAttribDims[attr] )
+			result.insert( (geom::Attrib)attr );
+	}
+
+	return result;
+}
+
+void MappedTriMesh::loadInto( geom::Target *target, const geom::AttribSet &requestedAttribs ) const
+{
+	for( auto &attrib : requestedAttribs ) {
+		if( getAttribDims( attrib ) && mNumVertices )
+			target->copyAttrib( attrib, mAttribDims[attrib], 0, mAttribData[attrib], mNumVertices );
+	}
+
+	if( mNumIndices )
+		target->copyIndices( geom::Primitive::TRIANGLES, mIndices, mNumIndices, 4 /* bytes per index */ );
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////
+// MappedTriMeshWriter
+MappedTriMeshWriter::MappedTriMeshWriter( const fs::path &path, const TriMesh::Format &format, size_t numVertices, size_t numIndices )
+	: mPath( path ), mNumVertices( numVertices ), mNumIndices( numIndices ), mNumIndicesAppended( 0 )
+{
+	if( numIndices % 3 != 0 )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: the number of indices must be a multiple of 3" );
+
+	mAttribDims = attribDimsFromFormat( format );
+	mAttribOffsets.fill( 0 );
+	mAttribVerticesAppended.fill( 0 );
+
+	// lay out the sections
+	vector<AttribEntry> entries;
+	for( int attr = 0; attr < geom::NUM_ATTRIBS; ++attr ) {
+		if( mAttribDims[attr] ) {
+			entries.emplace_back();
+			memset( &entries.back(), 0, sizeof( AttribEntry ) );
+			entries.back().mAttribMask = TriMesh::toMask( (geom::Attrib)attr );
+			entries.back().mDims = mAttribDims[attr];
+		}
+	}
+
+	uint64_t offset = alignSection( sizeof( FileHeader ) + entries.size() * sizeof( AttribEntry ) );
+	mIndicesOffset = offset;
+	offset = alignSection( offset + (uint64_t)numIndices * sizeof( uint32_t ) );
+	for( auto &entry : entries ) {
+		geom::Attrib attr = TriMesh::fromMask( entry.mAttribMask );
+		entry.mOffset = mAttribOffsets[attr] = offset;
+		offset = alignSection( offset + (uint64_t)numVertices * entry.mDims * sizeof( float ) );
+	}
+
+	FileHeader header;
+	memset( &header, 0, sizeof( header ) );
+	memcpy( header.mMagic, FILE_MAGIC, sizeof( FILE_MAGIC ) );
+	header.mVersion = FILE_VERSION;
+	header.mNumAttribs = (uint32_t)entries.size();
+	header.mNumVertices = numVertices;
+	header.mNumIndices = numIndices;
+	header.mIndicesOffset = mIndicesOffset;
+
+	if( path.has_parent_path() )
+		fs::create_directories( path.parent_path() );
+#if defined( CINDER_MSW )
+	mFile = _wfopen( path.wstring().c_str(), L"wb" );
+#else
+	mFile = fopen( path.string().c_str(), "wb" );
+#endif
+	if( ! mFile )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: failed to create " + path.string() );
+
+	writeAt( 0, &header, sizeof( header ) );
+	if( ! entries.empty() )
+		writeAt( sizeof( header ), entries.data(), entries.size() * sizeof( AttribEntry ) );
+}
+
+MappedTriMeshWriter::~MappedTriMeshWriter()
+{
+	if( mFile )
+		fclose( mFile );
+}
+
+void MappedTriMeshWriter::writeAt( uint64_t offset, const void *data, size_t numBytes )
+{
+	if( ! mFile )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: " + mPath.string() + " has already been finished" );
+
+#if defined( CINDER_MSW )
+	int seekResult = _fseeki64( mFile, (__int64)offset, SEEK_SET );
+#else
+	int seekResult = fseeko( mFile, (off_t)offset, SEEK_SET );
+#endif
+	if( seekResult != 0 || fwrite( data, 1, numBytes, mFile ) != numBytes )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: failed writing to " + mPath.string() );
+}
+
+void MappedTriMeshWriter::appendAttrib( geom::Attrib attr, const float *data, size_t numVertices )
+{
+	if( attr >= geom::NUM_ATTRIBS || ! mAttribDims[attr] )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: attribute " + geom::attribToString( attr ) + " isn't part of the Format" );
+	if( numVertices > mNumVertices - mAttribVerticesAppended[attr] )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: too many vertices appended for " + geom::attribToString( attr ) );
+
+	const size_t vertexBytes = mAttribDims[attr] * sizeof( float );
+	writeAt( mAttribOffsets[attr] + (uint64_t)mAttribVerticesAppended[attr] * vertexBytes, data, numVertices * vertexBytes );
+	mAttribVerticesAppended[attr] += numVertices;
+}
+
+void MappedTriMeshWriter::appendIndices( const uint32_t *indices, size_t numIndices )
+{
+	if( numIndices > mNumIndices - mNumIndicesAppended )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: too many indices appended" );
+
+	writeAt( mIndicesOffset + (uint64_t)mNumIndicesAppended * sizeof( uint32_t ), indices, numIndices * sizeof( uint32_t ) );
+	mNumIndicesAppended += numIndices;
+}
+
+size_t MappedTriMeshWriter::getNumAttribVerticesAppended( geom::Attrib attr ) const
+{
+	if( attr >= geom::NUM_ATTRIBS )
+		return 0;
+
+	return mAttribVerticesAppended[attr];
+}
+
+void MappedTriMeshWriter::finish()
+{
+	if( ! mFile )
+		return;
+
+	string missing;
+	if( mNumIndicesAppended != mNumIndices )
+		missing = "indices";
+	for( int attr = 0; attr < geom::NUM_ATTRIBS && missing.empty(); ++attr ) {
+		if( mAttribDims[attr] && mAttribVerticesAppended[attr] != mNumVertices )
+			missing = geom::attribToString( (geom::Attrib)attr );
+	}
+
+	bool failed = fflush( mFile ) != 0 || ferror( mFile );
+	failed = fclose( mFile ) != 0 || failed;
+	mFile = nullptr;
+
+	if( ! missing.empty() )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: " + missing + " incomplete in " + mPath.string() );
+	if( failed )
+		throw MappedTriMeshExc( "MappedTriMeshWriter: failed writing to " + mPath.string() );
+}
+
+namespace {
+
+// Streams the output of a geom::Source into a MappedTriMeshWriter, converting attributes a chunk of vertices at a time
+class MappedTriMeshWriterTarget : public geom::Target {
+  public:
+	MappedTriMeshWriterTarget( MappedTriMeshWriter *writer, const TriMesh::Format &format )
+		: mWriter( writer ), mDims( attribDimsFromFormat( format ) )
+	{}
+
+	uint8_t getAttribDims( geom::Attrib attr ) const override
+	{
+		return attr < geom::NUM_ATTRIBS ? mDims[attr] : 0;
+	}
+
+	void copyAttrib( geom::Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override
+	{
+		const uint8_t dstDims = getAttribDims( attr );
+		if( ! dstDims )
+			return;
+
+		if( strideBytes == 0 )
+			strideBytes = dims * sizeof( float );
+		if( dims == dstDims && strideBytes == dims * sizeof( float ) ) {
+			mWriter->appendAttrib( attr, srcData, count );
+			return;
+		}
+
+		const size_t chunkSize = 16384;
+		vector<float> chunk( std::min( chunkSize, count ) * dstDims );
+		for( size_t offset = 0; offset < count; offset += chunkSize ) {
+			size_t numVertices = std::min( chunkSize, count - offset );
+			const float *src = reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( srcData ) + offset * strideBytes );
+			geom::copyData( dims, strideBytes, src, numVertices, dstDims, 0, chunk.data() );
+			mWriter->appendAttrib( attr, chunk.data(), numVertices );
+		}
+	}
+
+	void copyIndices( geom::Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t /*requiredBytesPerIndex*/ ) override
+	{
+		if( primitive == geom::Primitive::TRIANGLES ) {
+			mWriter->appendIndices( source, numIndices );
+			return;
+		}
+
+		vector<uint32_t> triangles( numIndices >= 3 ? ( numIndices - 2 ) * 3 : 0 );
+		copyIndexDataForceTriangles( primitive, source, numIndices, 0, triangles.data() );
+		mWriter->appendIndices( triangles.data(), triangles.size() );
+	}
+
+  private:
+	MappedTriMeshWriter						*mWriter;
+	std::array<uint8_t, geom::NUM_ATTRIBS>	mDims;
+};
+
+} // anonymous namespace
+
+void MappedTriMeshWriter::write( const fs::path &path, const geom::Source &source )
+{
+	write( path, source, TriMesh::formatFromSource( source ) );
+}
+
+void MappedTriMeshWriter::write( const fs::path &path, const geom::Source &source, const TriMesh::Format &format )
+{
+	const geom::Primitive primitive = source.getPrimitive();
+	size_t numIndices = source.getNumIndices() ? source.getNumIndices() : source.getNumVertices();
+	switch( primitive ) {
+		case geom::Primitive::TRIANGLES:
+		break;
+		case geom::Primitive::TRIANGLE_STRIP:
+		case geom::Primitive::TRIANGLE_FAN:
+			numIndices = numIndices >= 3 ? ( numIndices - 2 ) * 3 : 0;
+		break;
+		default:
+			throw MappedTriMeshExc( "MappedTriMeshWriter: only triangle primitives are supported" );
+	}
+
+	MappedTriMeshWriter writer( path, format, source.getNumVertices(), numIndices );
+	MappedTriMeshWriterTarget target( &writer, format );
+
+	geom::AttribSet attribs;
+	auto dims = attribDimsFromFormat( format );
+	for( int attr = 0; attr < geom::NUM_ATTRIBS; ++attr ) {
+		if( dims[attr] )
+			attribs.insert( (geom::Attrib)attr );
+	}
+
+	source.loadInto( &target, attribs );
+
+	// if source is non-indexed, generate indices
+	if( source.getNumIndices() == 0 )
+		target.generateIndices( primitive, source.getNumVertices() );
+
+	writer.finish();
+}
+
+} // namespace cinder
@@ -52,6 +52,7 @@ class ImageTargetSurface : public ImageTarget {
 	virtual bool hasAlpha() const;
 	
 	virtual void*	getRowPointer( int32_t row );
+	virtual bool	isRowAccessThreadSafe() const	{ return true; }
 	
   protected:
 	ImageTargetSurface( SurfaceT<T> *surface );
@@ -0,0 +1,179 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/ThreadPool.h"
+
+#include <algorithm>
+
+namespace cinder {
+
+namespace {
+
+// Shared between the caller of parallelFor() and the helper tasks it enqueues. Helpers may outlive the call
+// (if the caller finishes every chunk before they are scheduled), so this is reference-counted.
+struct ParallelForState {
+	ParallelForState( size_t numChunks )
+		: mNextChunk( 0 ), mNumChunks( numChunks ), mNumCompleted( 0 )
+	{}
+
+	// Claims and runs chunks until there are none left. Returns once this thread can't claim any more work.
+	void runChunks( size_t begin, size_t end, const std::function<void( size_t, size_t )> &fn )
+	{
+		const size_t count = end - begin;
+		while( true ) {
+			size_t chunk = mNextChunk.fetch_add( 1 );
+			if( chunk >= mNumChunks )
+				break;
+
+			const size_t chunkBegin = begin + ( count * chunk ) / mNumChunks;
+			const size_t chunkEnd = begin + ( count * ( chunk + 1 ) ) / mNumChunks;
+			try {
+				fn( chunkBegin, chunkEnd );
+			}
+			catch( ... ) {
+				std::lock_guard<std::mutex> lock( mMutex );
+				if( ! mException )
+					mException = std::current_exception();
+			}
+
+			if( mNumCompleted.fetch_add( 1 ) + 1 == mNumChunks ) {
+				std::lock_guard<std::mutex> lock( mMutex );
+				mCompletedCond.notify_all();
+			}
+		}
+	}
+
+	void waitUntilCompleted()
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mCompletedCond.wait( lock, [this] { return mNumCompleted.load() == mNumChunks; } );
+	}
+
+	std::atomic<size_t>		mNextChunk;
+	const size_t			mNumChunks;
+	std::atomic<size_t>		mNumCompleted;
+	std::exception_ptr		mException;
+	std::mutex				mMutex;
+	std::condition_variable	mCompletedCond;
+};
+
+} // anonymous namespace
+
+ThreadPool* ThreadPool::getDefault()
+{
+	static ThreadPool sDefaultPool( 0 );
+	return &sDefaultPool;
+}
+
+ThreadPool::ThreadPool( size_t numThreads )
+	: mStopping( false )
+{
+	if( numThreads == 0 ) {
+		const size_t hardwareThreads = std::thread::hardware_concurrency();
+		numThreads = ( hardwareThreads > 1 ) ? hardwareThreads - 1 : 0;
+	}
+
+	for( size_t i = 0; i < numThreads; i++ )
+		mThreads.emplace_back( &ThreadPool::workerLoop, this );
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStopping = true;
+	}
+	mTaskCond.notify_all();
+
+	for( auto &thread : mThreads )
+		thread.join();
+}
+
+void ThreadPool::pushTask( std::function<void()> &&task )
+{
+	if( mThreads.empty() ) {
+		// no workers to service the queue, so run the task immediately
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mTasks.push_back( std::move( task ) );
+	}
+	mTaskCond.notify_one();
+}
+
+void ThreadPool::workerLoop()
+{
+	ThreadSetup threadSetup;
+
+	while( true ) {
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mTaskCond.wait( lock, [this] { return mStopping || ! mTasks.empty(); } );
+			if( mStopping && mTasks.empty() )
+				return;
+
+			task = std::move( mTasks.front() );
+			mTasks.pop_front();
+		}
+
+		task();
+	}
+}
+
+void ThreadPool::parallelFor( size_t begin, size_t end, const std::function<void( size_t, size_t )> &fn, size_t minChunkSize )
+{
+	if( end <= begin )
+		return;
+
+	const size_t count = end - begin;
+	// rounding down keeps every chunk at least minChunkSize long
+	const size_t maxChunks = std::max<size_t>( 1, count / std::max<size_t>( minChunkSize, 1 ) );
+	// oversubscribe a little so that uneven chunks balance out across threads
+	const size_t numChunks = std::min( maxChunks, ( mThreads.size() + 1 ) * 4 );
+
+	if( numChunks <= 1 || mThreads.empty() ) {
+		fn( begin, end );
+		return;
+	}
+
+	auto state = std::make_shared<ParallelForState>( numChunks );
+	const size_t numHelpers = std::min( mThreads.size(), numChunks - 1 );
+	for( size_t i = 0; i < numHelpers; i++ ) {
+		// fn is only invoked by a helper while it holds an unfinished chunk, during which this call is still blocked, so capturing it by pointer is safe
+		const std::function<void( size_t, size_t )> *fnPtr = &fn;
+		pushTask( [state, begin, end, fnPtr] { state->runChunks( begin, end, *fnPtr ); } );
+	}
+
+	// the calling thread participates, which also guarantees progress when called from a worker thread
+	state->runChunks( begin, end, fn );
+	state->waitUntilCompleted();
+
+	if( state->mException )
+		std::rethrow_exception( state->mException );
+}
+
+} // namespace cinder
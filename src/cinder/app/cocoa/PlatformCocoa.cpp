@@ -30,6 +30,7 @@
 #include "cinder/ImageTargetFileQuartz.h"
 #include "cinder/ImageSourceFileRadiance.h"
 #include "cinder/ImageFileTinyExr.h"
+#include "cinder/ImageTargetFilePng.h"
 
 #if defined( CINDER_MAC )
 	#import <Cocoa/Cocoa.h>
@@ -65,6 +66,7 @@ PlatformCocoa::PlatformCocoa()
 	ImageSourceFileRadiance::registerSelf();
 	ImageSourceFileTinyExr::registerSelf();
 	ImageTargetFileTinyExr::registerSelf();
+	ImageTargetFilePng::registerSelf();
 }
 
 void PlatformCocoa::prepareLaunch()
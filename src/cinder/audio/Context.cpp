@@ -22,6 +22,7 @@
 */
 
 #include "cinder/audio/Context.h"
+#include "cinder/audio/GraphScheduler.h"
 #include "cinder/audio/InputNode.h"
 #include "cinder/audio/Utilities.h"
 #include "cinder/audio/dsp/Converter.h"
@@ -181,6 +182,26 @@ void Context::setEnabled( bool b )
 
 void Context::connectionsDidChange( const NodeRef & /*node*/ )
 {
+	if( mGraphScheduler )
+		mGraphScheduler->markDirty();
+}
+
+void Context::enableParallelProcessing( size_t numThreads )
+{
+	unique_ptr<GraphScheduler> scheduler( new GraphScheduler( this, numThreads ) );
+
+	lock_guard<mutex> lock( mMutex );
+	swap( mGraphScheduler, scheduler );
+}
+
+void Context::disableParallelProcessing()
+{
+	unique_ptr<GraphScheduler> scheduler;
+	{
+		lock_guard<mutex> lock( mMutex );
+		swap( mGraphScheduler, scheduler );
+	}
+	// the worker threads are joined outside of the lock, once the audio thread no longer uses them
 }
 
 void Context::initializeAllNodes()
@@ -227,6 +248,9 @@ void Context::setOutput( const OutputNodeRef &output )
 
 	if( mOutput )
 		initializeAllNodes();
+
+	if( mGraphScheduler )
+		mGraphScheduler->markDirty();
 }
 
 const OutputNodeRef& Context::getOutput()
@@ -288,7 +312,11 @@ void Context::uninitRecursive( const NodeRef &node, set<NodeRef> &traversedNodes
 
 bool Context::isAudioThread() const
 {
-	return mAudioThreadId == std::this_thread::get_id();
+	if( mAudioThreadId == std::this_thread::get_id() )
+		return true;
+
+	// worker threads only process Node's while the audio thread holds the lock, so they are treated the same
+	return GraphScheduler::isWorkerThread( this );
 }
 
 void Context::preProcess()
@@ -297,11 +325,18 @@ void Context::preProcess()
 	mAudioThreadId = std::this_thread::get_id();
 
 	preProcessScheduledEvents();
+
+	if( mGraphScheduler )
+		mGraphScheduler->processBlock( mOutput, mAutoPulledNodes );
 }
 
 void Context::postProcess()
 {
 	processAutoPulledNodes();
+
+	if( mGraphScheduler )
+		mGraphScheduler->finishBlock();
+
 	postProcessScheduledEvents();
 	incrementFrameCount();
 
@@ -324,6 +359,9 @@ void Context::addAutoPulledNode( const NodeRef &node )
 	mAutoPullRequired = true;
 	mAutoPullCacheDirty = true;
 
+	if( mGraphScheduler )
+		mGraphScheduler->markDirty();
+
 	// if not done already, allocate a buffer for auto-pulling that is large enough for stereo processing
 	size_t framesPerBlock = getFramesPerBlock();
 	if( mAutoPullBuffer.getNumFrames() < framesPerBlock )
@@ -338,6 +376,9 @@ void Context::removeAutoPulledNode( const NodeRef &node )
 	mAutoPullCacheDirty = true;
 	if( mAutoPulledNodes.empty() )
 		mAutoPullRequired = false;
+
+	if( mGraphScheduler )
+		mGraphScheduler->markDirty();
 }
 
 void Context::processAutoPulledNodes()
@@ -0,0 +1,175 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/audio/ContextOffline.h"
+#include "cinder/audio/Exception.h"
+#include "cinder/Timer.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+// ----------------------------------------------------------------------------------------------------
+// OutputOfflineNode
+// ----------------------------------------------------------------------------------------------------
+
+OutputOfflineNode::OutputOfflineNode( size_t sampleRate, size_t framesPerBlock, const Format &format )
+	: OutputNode( format ), mSampleRate( sampleRate ), mFramesPerBlock( framesPerBlock )
+{
+	if( ! mSampleRate || ! mFramesPerBlock )
+		throw AudioFormatExc( "OutputOfflineNode requires a non-zero samplerate and frames per block." );
+
+	// If number of channels hasn't been specified, default to 2.
+	if( getChannelMode() != ChannelMode::SPECIFIED ) {
+		setChannelMode( ChannelMode::SPECIFIED );
+		setNumChannels( 2 );
+	}
+
+	// a render farm has no speakers to protect, silencing clipped blocks would only corrupt the output
+	mClipDetectionEnabled = false;
+}
+
+const Buffer* OutputOfflineNode::renderBlock()
+{
+	auto ctx = getContext();
+	CI_ASSERT( ctx );
+
+	lock_guard<mutex> lock( ctx->getMutex() );
+
+	ctx->preProcess();
+
+	auto internalBuffer = getInternalBuffer();
+	internalBuffer->zero();
+	pullInputs( internalBuffer );
+
+	if( checkNotClipping() )
+		internalBuffer->zero();
+
+	ctx->postProcess();
+
+	return internalBuffer;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// ContextOffline
+// ----------------------------------------------------------------------------------------------------
+
+// static
+ContextOfflineRef ContextOffline::create( size_t sampleRate, size_t framesPerBlock, const Node::Format &outputFormat )
+{
+	// construct the output first, the Context destructor would otherwise try to create a hardware output if this throws
+	auto output = new OutputOfflineNode( sampleRate, framesPerBlock, outputFormat );
+
+	ContextOfflineRef result( new ContextOffline );
+	result->setOutput( result->makeNode( output ) );
+	return result;
+}
+
+ContextOffline::ContextOffline()
+	: mPendingOffset( 0 ), mPendingFrames( 0 ), mBlocksPerSecond( 0 ), mRealtimeRatio( 0 ), mNumRenderedBlocks( 0 )
+{
+}
+
+OutputDeviceNodeRef ContextOffline::createOutputDeviceNode( const DeviceRef & /*device*/, const Node::Format & /*format*/ )
+{
+	throw AudioContextExc( "ContextOffline does not support hardware output." );
+}
+
+InputDeviceNodeRef ContextOffline::createInputDeviceNode( const DeviceRef & /*device*/, const Node::Format & /*format*/ )
+{
+	throw AudioContextExc( "ContextOffline does not support hardware input." );
+}
+
+OutputOfflineNode* ContextOffline::getOutputOffline()
+{
+	auto result = dynamic_cast<OutputOfflineNode *>( getOutput().get() );
+	if( ! result )
+		throw AudioContextExc( "ContextOffline can only render to an OutputOfflineNode." );
+
+	return result;
+}
+
+void ContextOffline::render( size_t numFrames, BufferDynamic *buffer )
+{
+	buffer->setSize( numFrames, getOutput()->getNumChannels() );
+
+	size_t writeOffset = 0;
+	render( numFrames, [buffer, &writeOffset]( const Buffer *block, size_t blockFrames, size_t blockOffset ) {
+		buffer->copyOffset( *block, blockFrames, writeOffset, blockOffset );
+		writeOffset += blockFrames;
+	} );
+}
+
+void ContextOffline::render( size_t numFrames, TargetFile *target )
+{
+	if( target->getNumChannels() != getOutput()->getNumChannels() )
+		throw AudioFormatExc( "TargetFile channel count does not match the output of ContextOffline." );
+
+	render( numFrames, [target]( const Buffer *block, size_t blockFrames, size_t blockOffset ) {
+		target->write( block, blockFrames, blockOffset );
+	} );
+}
+
+void ContextOffline::render( size_t numFrames, const std::function<void ( const Buffer *, size_t, size_t )> &consumer )
+{
+	OutputOfflineNode *output = getOutputOffline();
+	ScopedEnableContext enableContext( this, true );
+
+	Timer timer( true );
+	uint64_t numBlocks = 0;
+
+	const Buffer *source = &mPendingBuffer;
+	size_t sourceOffset = mPendingOffset, sourceFrames = mPendingFrames;
+	for( size_t framesRendered = 0; framesRendered < numFrames; ) {
+		if( ! sourceFrames ) {
+			source = output->renderBlock();
+			sourceOffset = 0;
+			sourceFrames = source->getNumFrames();
+			numBlocks++;
+		}
+
+		const size_t chunkFrames = std::min( sourceFrames, numFrames - framesRendered );
+		consumer( source, chunkFrames, sourceOffset );
+		sourceOffset += chunkFrames;
+		sourceFrames -= chunkFrames;
+		framesRendered += chunkFrames;
+	}
+
+	// hold on to the remainder of the last block, since the output's buffer may be reconfigured before the next render()
+	if( sourceFrames && source != &mPendingBuffer ) {
+		mPendingBuffer.setSize( source->getNumFrames(), source->getNumChannels() );
+		mPendingBuffer.copy( *source );
+	}
+	mPendingOffset = sourceOffset;
+	mPendingFrames = sourceFrames;
+
+	timer.stop();
+	mNumRenderedBlocks += numBlocks;
+	const double seconds = timer.getSeconds();
+	mBlocksPerSecond = seconds > 0 ? (double)numBlocks / seconds : 0;
+	mRealtimeRatio = mBlocksPerSecond * (double)output->getOutputFramesPerBlock() / (double)output->getOutputSampleRate();
+}
+
+} } // namespace cinder::audio
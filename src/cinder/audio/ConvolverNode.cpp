@@ -0,0 +1,221 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/audio/ConvolverNode.h"
+#include "cinder/audio/Context.h"
+#include "cinder/audio/Exception.h"
+#include "cinder/CinderMath.h"
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+const size_t MIN_HEAD_PARTITION_SIZE = 16;
+
+} // anonymous namespace
+
+ConvolverNode::ConvolverNode( const Format &format )
+	: ConvolverNode( BufferRef(), format )
+{
+}
+
+ConvolverNode::ConvolverNode( const BufferRef &impulseResponse, const Format &format )
+	: Node( format ), mImpulseResponse( impulseResponse ), mTailPartitionSize( 1024 ), mHeadPartitionSize( 0 ), mTailFrames( 0 ), mTailIndex( 0 ),
+		mNumJobsSubmitted( 0 ), mNumJobsCompleted( 0 ), mStopping( false )
+{
+}
+
+ConvolverNode::~ConvolverNode()
+{
+	stopTailThread();
+}
+
+void ConvolverNode::setImpulseResponse( const BufferRef &impulseResponse )
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	mImpulseResponse = impulseResponse;
+	if( isInitialized() )
+		configureStages();
+}
+
+void ConvolverNode::loadImpulseResponse( const SourceFileRef &sourceFile )
+{
+	size_t sampleRate = getSampleRate();
+	if( sampleRate == sourceFile->getSampleRate() )
+		setImpulseResponse( sourceFile->loadBuffer() );
+	else {
+		auto sf = sourceFile->cloneWithSampleRate( sampleRate );
+		setImpulseResponse( sf->loadBuffer() );
+	}
+}
+
+void ConvolverNode::setTailPartitionSize( size_t frames )
+{
+	lock_guard<mutex> lock( getContext()->getMutex() );
+
+	mTailPartitionSize = frames;
+	if( isInitialized() )
+		configureStages();
+}
+
+void ConvolverNode::initialize()
+{
+	configureStages();
+}
+
+void ConvolverNode::uninitialize()
+{
+	stopTailThread();
+	mHeads.clear();
+	mTails.clear();
+}
+
+void ConvolverNode::configureStages()
+{
+	stopTailThread();
+	mHeads.clear();
+	mTails.clear();
+	mTailFrames = 0;
+
+	// the largest power of two dividing the block size, so partitions line up with blocks and the head adds no latency
+	const size_t framesPerBlock = getFramesPerBlock();
+	mHeadPartitionSize = framesPerBlock & ( ~framesPerBlock + 1 );
+	if( mHeadPartitionSize < MIN_HEAD_PARTITION_SIZE )
+		throw AudioFormatExc( "ConvolverNode requires the frames per block to be a multiple of 16." );
+
+	if( ! mImpulseResponse || mImpulseResponse->isEmpty() )
+		return;
+
+	// The tail's result for each partition of input is needed one partition later, so the head has to cover two tail partitions.
+	const size_t irFrames = mImpulseResponse->getNumFrames();
+	mTailFrames = mTailPartitionSize ? max( nextPowerOf2( (uint32_t)mTailPartitionSize ), (uint32_t)mHeadPartitionSize ) : 0;
+	size_t headFrames = irFrames;
+	if( mTailFrames && irFrames > mTailFrames * 2 )
+		headFrames = mTailFrames * 2;
+	else
+		mTailFrames = 0;
+
+	for( size_t ch = 0; ch < getNumChannels(); ch++ ) {
+		const float *ir = mImpulseResponse->getChannel( min( ch, mImpulseResponse->getNumChannels() - 1 ) );
+		mHeads.emplace_back( new dsp::Convolver( ir, headFrames, mHeadPartitionSize ) );
+		if( mTailFrames )
+			mTails.emplace_back( new dsp::Convolver( ir + headFrames, irFrames - headFrames, mTailFrames ) );
+	}
+
+	if( mTailFrames ) {
+		mTailInput = Buffer( mTailFrames, getNumChannels() );
+		mTailOutput = Buffer( mTailFrames, getNumChannels() );
+		mTailJobInput = Buffer( mTailFrames, getNumChannels() );
+		mTailJobOutput = Buffer( mTailFrames, getNumChannels() );
+		mTailIndex = 0;
+		mNumJobsSubmitted = 0;
+		mNumJobsCompleted = 0;
+		mStopping = false;
+		mTailThread = thread( &ConvolverNode::tailThreadLoop, this );
+	}
+}
+
+void ConvolverNode::stopTailThread()
+{
+	if( ! mTailThread.joinable() )
+		return;
+
+	{
+		lock_guard<mutex> lock( mWakeMutex );
+		mStopping = true;
+	}
+	mWakeCond.notify_all();
+	mTailThread.join();
+}
+
+void ConvolverNode::process( Buffer *buffer )
+{
+	if( mHeads.empty() ) {
+		buffer->zero();
+		return;
+	}
+
+	const size_t numFrames = buffer->getNumFrames();
+	const size_t numChannels = getNumChannels();
+
+	for( size_t offset = 0; offset < numFrames; offset += mHeadPartitionSize ) {
+		for( size_t ch = 0; ch < numChannels; ch++ ) {
+			float *channel = buffer->getChannel( ch ) + offset;
+			if( mTailFrames )
+				memcpy( mTailInput.getChannel( ch ) + mTailIndex, channel, mHeadPartitionSize * sizeof( float ) );
+
+			mHeads[ch]->process( channel, channel );
+
+			if( mTailFrames )
+				dsp::add( channel, mTailOutput.getChannel( ch ) + mTailIndex, channel, mHeadPartitionSize );
+		}
+
+		if( mTailFrames ) {
+			mTailIndex += mHeadPartitionSize;
+			if( mTailIndex == mTailFrames ) {
+				// collect the previous result, which covers the next tail partition, and hand off the input just completed
+				waitForTail();
+				swap( mTailOutput, mTailJobOutput );
+				swap( mTailInput, mTailJobInput );
+				mTailIndex = 0;
+
+				mNumJobsSubmitted++;
+				mWakeCond.notify_one();
+			}
+		}
+	}
+}
+
+void ConvolverNode::waitForTail()
+{
+	// normally the job finished long ago, unless rendering faster than realtime (e.g. with ContextOffline)
+	while( mNumJobsCompleted.load( memory_order_acquire ) != mNumJobsSubmitted.load( memory_order_relaxed ) )
+		this_thread::yield();
+}
+
+void ConvolverNode::tailThreadLoop()
+{
+	uint64_t numJobsProcessed = 0;
+	while( true ) {
+		{
+			// the audio thread doesn't take the mutex when submitting, so the timeout bounds the cost of a missed wake up
+			unique_lock<mutex> lock( mWakeMutex );
+			while( ! mStopping && mNumJobsSubmitted.load( memory_order_acquire ) == numJobsProcessed )
+				mWakeCond.wait_for( lock, chrono::milliseconds( 1 ) );
+
+			if( mStopping )
+				return;
+		}
+
+		for( size_t ch = 0; ch < mTails.size(); ch++ )
+			mTails[ch]->process( mTailJobInput.getChannel( ch ), mTailJobOutput.getChannel( ch ) );
+
+		numJobsProcessed++;
+		mNumJobsCompleted.store( numJobsProcessed, memory_order_release );
+	}
+}
+
+} } // namespace cinder::audio
@@ -0,0 +1,176 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/audio/FileReadScheduler.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+#include <chrono>
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+int64_t nowNanoseconds()
+{
+	return chrono::duration_cast<chrono::nanoseconds>( chrono::steady_clock::now().time_since_epoch() ).count();
+}
+
+} // anonymous namespace
+
+FileReadScheduler* FileReadScheduler::get()
+{
+	// intentionally leaked, FilePlayerNodes that are destroyed during static destruction still unregister from it
+	static FileReadScheduler *sScheduler = new FileReadScheduler;
+	return sScheduler;
+}
+
+FileReadScheduler::FileReadScheduler( size_t numThreads )
+	: mStopping( false ), mNumReadsServiced( 0 )
+{
+	startThreads( numThreads );
+}
+
+FileReadScheduler::~FileReadScheduler()
+{
+	stopThreads();
+}
+
+FileReadScheduler::ReaderRef FileReadScheduler::addReader( const std::function<void()> &readFn )
+{
+	auto reader = make_shared<Reader>( readFn );
+	{
+		lock_guard<mutex> lock( mMutex );
+		mReaders.push_back( reader );
+	}
+
+	mWakeCond.notify_all();
+	return reader;
+}
+
+void FileReadScheduler::removeReader( const ReaderRef &reader )
+{
+	unique_lock<mutex> lock( mMutex );
+	mReadCompleteCond.wait( lock, [&reader] { return ! reader->mBusy; } );
+
+	reader->mPending = false;
+	mReaders.erase( remove( mReaders.begin(), mReaders.end(), reader ), mReaders.end() );
+}
+
+void FileReadScheduler::requestRead( const ReaderRef &reader, double secondsUntilDeadline )
+{
+	// Requests are made without taking the mutex, so an idle worker can miss the notification. Readers keep requesting until they
+	// are read, so later requests notify again. Only the first request sets the deadline, later ones estimate the same underrun.
+	if( reader->mPending.load( memory_order_acquire ) ) {
+		mWakeCond.notify_one();
+		return;
+	}
+
+	reader->mDeadline.store( nowNanoseconds() + int64_t( secondsUntilDeadline * 1e9 ), memory_order_relaxed );
+	reader->mPending.store( true, memory_order_release );
+	mWakeCond.notify_one();
+}
+
+void FileReadScheduler::setNumThreads( size_t numThreads )
+{
+	stopThreads();
+	startThreads( numThreads );
+}
+
+size_t FileReadScheduler::getNumThreads() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mThreads.size();
+}
+
+size_t FileReadScheduler::getNumReaders() const
+{
+	lock_guard<mutex> lock( mMutex );
+	return mReaders.size();
+}
+
+void FileReadScheduler::startThreads( size_t numThreads )
+{
+	if( numThreads == 0 )
+		numThreads = std::thread::hardware_concurrency() > 1 ? 2 : 1;
+
+	lock_guard<mutex> lock( mMutex );
+	mStopping = false;
+	for( size_t i = 0; i < numThreads; i++ )
+		mThreads.emplace_back( &FileReadScheduler::workerLoop, this );
+}
+
+void FileReadScheduler::stopThreads()
+{
+	vector<thread> threads;
+	{
+		lock_guard<mutex> lock( mMutex );
+		mStopping = true;
+		threads.swap( mThreads );
+	}
+	mWakeCond.notify_all();
+
+	for( auto &thread : threads )
+		thread.join();
+}
+
+void FileReadScheduler::workerLoop()
+{
+	unique_lock<mutex> lock( mMutex );
+	while( ! mStopping ) {
+		// earliest deadline first
+		ReaderRef next;
+		int64_t nextDeadline = 0;
+		for( const auto &reader : mReaders ) {
+			if( reader->mBusy || ! reader->mPending.load( memory_order_acquire ) )
+				continue;
+
+			int64_t deadline = reader->mDeadline.load( memory_order_relaxed );
+			if( ! next || deadline < nextDeadline ) {
+				next = reader;
+				nextDeadline = deadline;
+			}
+		}
+
+		if( ! next ) {
+			mWakeCond.wait( lock );
+			continue;
+		}
+
+		// cleared before reading, so that a request made during the read is serviced again afterwards
+		next->mBusy = true;
+		next->mPending = false;
+
+		lock.unlock();
+		next->mReadFn();
+		lock.lock();
+
+		next->mBusy = false;
+		mNumReadsServiced++;
+		mReadCompleteCond.notify_all();
+	}
+}
+
+} } // namespace cinder::audio
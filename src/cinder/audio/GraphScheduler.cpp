@@ -0,0 +1,300 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/audio/GraphScheduler.h"
+#include "cinder/audio/Context.h"
+#include "cinder/audio/Node.h"
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#elif defined( CINDER_POSIX )
+	#include <pthread.h>
+#endif
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+namespace {
+
+const size_t	MAX_NUM_TASKS = 0xFFFF;
+const int		PENDING_PARENT = -2;
+
+// the Context that the calling thread processes tasks for, if it is a worker thread
+thread_local const Context *sWorkerContext = nullptr;
+
+inline uint64_t packClaim( uint32_t generation, size_t numTasks, size_t nextTask )
+{
+	return ( uint64_t( generation ) << 32 ) | ( uint64_t( numTasks ) << 16 ) | uint64_t( nextTask );
+}
+
+inline uint32_t claimGeneration( uint64_t claim )	{ return uint32_t( claim >> 32 ); }
+inline size_t	claimNumTasks( uint64_t claim )		{ return size_t( ( claim >> 16 ) & 0xFFFF ); }
+inline size_t	claimNextTask( uint64_t claim )		{ return size_t( claim & 0xFFFF ); }
+
+// Best effort, the workers fall back to the default priority if the process isn't permitted to raise it.
+void setRealtimePriority( std::thread &thread )
+{
+#if defined( CINDER_MSW_DESKTOP )
+	::SetThreadPriority( thread.native_handle(), THREAD_PRIORITY_TIME_CRITICAL );
+#elif defined( CINDER_POSIX )
+	sched_param param;
+	param.sched_priority = sched_get_priority_max( SCHED_FIFO );
+	pthread_setschedparam( thread.native_handle(), SCHED_FIFO, &param );
+#endif
+}
+
+} // anonymous namespace
+
+GraphScheduler::GraphScheduler( Context *context, size_t numThreads )
+	: mContext( context ), mNumTasks( 0 ), mFramesPerBlock( 0 ), mDirty( true ), mClaim( 0 ), mNumCompleted( 0 ), mGeneration( 0 ),
+		mNumSleeping( 0 ), mStopping( false )
+{
+	if( numThreads == 0 ) {
+		size_t hardwareThreads = std::thread::hardware_concurrency();
+		numThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	for( size_t i = 0; i < numThreads; i++ ) {
+		mThreads.emplace_back( &GraphScheduler::workerLoop, this );
+		setRealtimePriority( mThreads.back() );
+	}
+}
+
+GraphScheduler::~GraphScheduler()
+{
+	{
+		lock_guard<mutex> lock( mWakeMutex );
+		mStopping = true;
+	}
+	mWakeCond.notify_all();
+
+	for( auto &thread : mThreads )
+		thread.join();
+}
+
+bool GraphScheduler::isWorkerThread( const Context *context )
+{
+	return context && sWorkerContext == context;
+}
+
+void GraphScheduler::processBlock( const NodeRef &output, const std::set<NodeRef> &autoPulledNodes )
+{
+	if( mDirty.exchange( false ) )
+		rebuild( output, autoPulledNodes );
+
+	if( ! mNumTasks )
+		return;
+
+	for( size_t i = 0; i < mNumTasks; i++ )
+		mTasks[i]->mPendingChildren.store( mTasks[i]->mNumChildren, memory_order_relaxed );
+
+	mNumCompleted.store( 0, memory_order_relaxed );
+	// Sequentially consistent with the increment of mNumSleeping in workerLoop(), so either a worker going to sleep sees the new
+	// generation, or it is counted here. In the latter case it holds mWakeMutex until it waits, so the notification can't be missed.
+	mClaim.store( packClaim( ++mGeneration, mNumTasks, 0 ) );
+
+	if( mNumSleeping.load() ) {
+		{
+			lock_guard<mutex> lock( mWakeMutex );
+		}
+		mWakeCond.notify_all();
+	}
+
+	// the audio thread claims tasks as well, then waits for those still running on workers
+	runTasks( mGeneration );
+	while( mNumCompleted.load( memory_order_acquire ) < mNumTasks )
+		this_thread::yield();
+}
+
+void GraphScheduler::finishBlock()
+{
+	for( size_t i = 0; i < mNumTasks; i++ )
+		mTasks[i]->mInput->mScheduledResult = nullptr;
+}
+
+void GraphScheduler::workerLoop()
+{
+	sWorkerContext = mContext;
+
+	uint32_t lastGeneration = 0;
+	while( true ) {
+		uint32_t generation;
+		// workers run at real-time priority, so they sleep until the next block rather than spinning
+		while( ( generation = claimGeneration( mClaim.load() ) ) == lastGeneration ) {
+			unique_lock<mutex> lock( mWakeMutex );
+			if( mStopping )
+				return;
+
+			mNumSleeping++;
+			mWakeCond.wait( lock, [this, lastGeneration] {
+				return mStopping || claimGeneration( mClaim.load() ) != lastGeneration;
+			} );
+			mNumSleeping--;
+		}
+
+		lastGeneration = generation;
+		runTasks( generation );
+	}
+}
+
+void GraphScheduler::runTasks( uint32_t generation )
+{
+	uint64_t claim = mClaim.load( memory_order_acquire );
+	while( claimGeneration( claim ) == generation && claimNextTask( claim ) < claimNumTasks( claim ) ) {
+		if( mClaim.compare_exchange_weak( claim, claim + 1, memory_order_acq_rel, memory_order_acquire ) )
+			runTask( claimNextTask( claim ) );
+	}
+}
+
+void GraphScheduler::runTask( size_t index )
+{
+	Task &task = *mTasks[index];
+
+	// children have lower indices, so they've already been claimed by running threads
+	while( task.mPendingChildren.load( memory_order_acquire ) )
+		this_thread::yield();
+
+	// the branch may have been disconnected since the task list was built, in which case it is no longer pulled
+	if( task.mOwner->isConnectedToInput( task.mInput ) ) {
+		Node *input = task.mInput.get();
+		task.mBuffer.setSize( mFramesPerBlock, input->getNumChannels() );
+		input->pullInputs( &task.mBuffer );
+		input->mScheduledResult = &task.mBuffer;
+	}
+
+	if( task.mParent >= 0 )
+		mTasks[task.mParent]->mPendingChildren.fetch_sub( 1, memory_order_release );
+
+	mNumCompleted.fetch_add( 1, memory_order_release );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Flattening the graph
+// ----------------------------------------------------------------------------------------------------
+
+void GraphScheduler::rebuild( const NodeRef &output, const std::set<NodeRef> &autoPulledNodes )
+{
+	mTasks.clear();
+	mNumTasks = 0;
+	mFramesPerBlock = mContext->getFramesPerBlock();
+
+	// count how many Nodes pull each Node, the roots are pulled by the Context
+	map<Node *, size_t> consumers;
+	set<Node *> traversed;
+	consumers[output.get()]++;
+	countConsumers( output.get(), consumers, traversed );
+	for( const auto &node : autoPulledNodes ) {
+		consumers[node.get()]++;
+		countConsumers( node.get(), consumers, traversed );
+	}
+
+	map<Node *, int> privateCache;
+	traversed.clear();
+	appendTasks( output, false, consumers, privateCache, traversed );
+	for( const auto &node : autoPulledNodes )
+		appendTasks( node, false, consumers, privateCache, traversed );
+
+	// children come before their parents, so any excess tasks only lose their parent
+	if( mTasks.size() > MAX_NUM_TASKS ) {
+		mTasks.resize( MAX_NUM_TASKS );
+		for( auto &task : mTasks ) {
+			if( task->mParent >= (int)MAX_NUM_TASKS )
+				task->mParent = -1;
+		}
+	}
+
+	mNumTasks = mTasks.size();
+}
+
+void GraphScheduler::countConsumers( Node *node, map<Node *, size_t> &consumers, set<Node *> &traversed )
+{
+	if( ! traversed.insert( node ).second )
+		return;
+
+	for( const auto &input : node->getInputs() ) {
+		consumers[input.get()]++;
+		countConsumers( input.get(), consumers, traversed );
+	}
+}
+
+bool GraphScheduler::isPrivate( Node *node, const map<Node *, size_t> &consumers, map<Node *, int> &cache )
+{
+	auto cached = cache.find( node );
+	if( cached != cache.end() )
+		return cached->second != 0;
+
+	// cycles always pass through a Node that supports them, which is never private
+	cache[node] = 0;
+
+	bool result = ! node->supportsCycles() && consumers.at( node ) == 1;
+	if( result ) {
+		for( const auto &input : node->getInputs() ) {
+			if( ! isPrivate( input.get(), consumers, cache ) ) {
+				result = false;
+				break;
+			}
+		}
+	}
+
+	cache[node] = result ? 1 : 0;
+	return result;
+}
+
+void GraphScheduler::appendTasks( const NodeRef &node, bool insideBranch, const map<Node *, size_t> &consumers, map<Node *, int> &privateCache, set<Node *> &traversed )
+{
+	if( ! traversed.insert( node.get() ).second )
+		return;
+
+	const bool sumsInputs = node->getNumConnectedInputs() > 1;
+	for( const auto &input : node->getInputs() ) {
+		if( ! sumsInputs || ! isPrivate( input.get(), consumers, privateCache ) ) {
+			appendTasks( input, insideBranch, consumers, privateCache, traversed );
+			continue;
+		}
+
+		// tasks within the branch are appended first, those without a parent yet become children of this task
+		const size_t firstChild = mTasks.size();
+		appendTasks( input, true, consumers, privateCache, traversed );
+
+		const int index = (int)mTasks.size();
+		unique_ptr<Task> task( new Task );
+		task->mOwner = node;
+		task->mInput = input;
+		task->mBuffer.setSize( mFramesPerBlock, input->getNumChannels() );
+		task->mParent = insideBranch ? PENDING_PARENT : -1;
+		task->mNumChildren = 0;
+		for( size_t i = firstChild; i < mTasks.size(); i++ ) {
+			if( mTasks[i]->mParent == PENDING_PARENT ) {
+				mTasks[i]->mParent = index;
+				task->mNumChildren++;
+			}
+		}
+
+		mTasks.push_back( move( task ) );
+	}
+}
+
+} } // namespace cinder::audio
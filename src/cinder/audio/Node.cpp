@@ -42,7 +42,8 @@ namespace cinder { namespace audio {
 
 Node::Node( const Format &format )
 	: mInitialized( false ), mEnabled( false ), mEventScheduled( false ), mChannelMode( format.getChannelMode() ),
-		mNumChannels( 1 ), mAutoEnabled( true ), mProcessInPlace( true ), mLastProcessedFrame( numeric_limits<uint64_t>::max() )
+		mNumChannels( 1 ), mAutoEnabled( true ), mProcessInPlace( true ), mLastProcessedFrame( numeric_limits<uint64_t>::max() ),
+		mScheduledResult( nullptr )
 {
 	if( format.getChannels() ) {
 		mNumChannels = format.getChannels();
@@ -419,6 +420,14 @@ void Node::pullInputs( Buffer *inPlaceBuffer )
 {
 	CI_ASSERT( getContext() );
 
+	// This Node's branch was already processed for this block by the Context's GraphScheduler, only the in-place result needs to be handed over.
+	if( mScheduledResult ) {
+		if( mProcessInPlace && inPlaceBuffer != mScheduledResult )
+			inPlaceBuffer->copy( *mScheduledResult );
+
+		return;
+	}
+
 	if( mProcessInPlace ) {
 		if( mInputs.empty() ) {
 			// Fastest route: no inputs and process in-place. inPlaceBuffer must be cleared so that samples left over
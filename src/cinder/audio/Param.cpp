@@ -27,50 +27,170 @@
 
 #include "cinder/CinderMath.h"
 
+#include <algorithm>
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <emmintrin.h>
+#elif defined( CINDER_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	#include <arm_neon.h>
+	#define CINDER_AUDIO_PARAM_NEON
+#endif
+
 using namespace std;
 
 namespace cinder { namespace audio {
 
-void rampLinear( float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd )
+namespace {
+
+// Number of Events a Param can hold before its queues need to grow.
+const size_t DEFAULT_MAX_EVENTS = 64;
+
+struct FactorLinear {
+	double operator()( double t ) const		{ return t; }
+#if defined( CINDER_SIMD_SSE2 )
+	__m128d operator()( __m128d t ) const	{ return t; }
+#elif defined( CINDER_AUDIO_PARAM_NEON )
+	float64x2_t operator()( float64x2_t t ) const	{ return t; }
+#endif
+};
+
+struct FactorInQuad {
+	double operator()( double t ) const		{ return t * t; }
+#if defined( CINDER_SIMD_SSE2 )
+	__m128d operator()( __m128d t ) const	{ return _mm_mul_pd( t, t ); }
+#elif defined( CINDER_AUDIO_PARAM_NEON )
+	float64x2_t operator()( float64x2_t t ) const	{ return vmulq_f64( t, t ); }
+#endif
+};
+
+// -t * ( t - 2 ) is computed as t * ( 2 - t ), which is exactly the same value.
+struct FactorOutQuad {
+	double operator()( double t ) const		{ return -t * ( t - 2 ); }
+#if defined( CINDER_SIMD_SSE2 )
+	__m128d operator()( __m128d t ) const	{ return _mm_mul_pd( t, _mm_sub_pd( _mm_set1_pd( 2 ), t ) ); }
+#elif defined( CINDER_AUDIO_PARAM_NEON )
+	float64x2_t operator()( float64x2_t t ) const	{ return vmulq_f64( t, vsubq_f64( vdupq_n_f64( 2 ), t ) ); }
+#endif
+};
+
+// Evaluates the ramp four samples at a time. The time and curve are computed in double precision like the scalar path,
+// only the final interpolation is done in single precision.
+template <typename FactorT>
+void ramp( float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd, const FactorT &factorFn )
 {
-	for( size_t i = 0; i < count; i++ ) {
-		auto factor = float( t );
+	size_t i = 0;
+
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128 begin = _mm_set1_ps( valueBegin );
+	const __m128 delta = _mm_set1_ps( valueEnd - valueBegin );
+	const __m128d incr = _mm_set1_pd( 4 * tIncr );
+	__m128d t01 = _mm_set_pd( t + tIncr, t );
+	__m128d t23 = _mm_set_pd( t + 3 * tIncr, t + 2 * tIncr );
+	for( ; i + 4 <= count; i += 4 ) {
+		__m128 factor = _mm_movelh_ps( _mm_cvtpd_ps( factorFn( t01 ) ), _mm_cvtpd_ps( factorFn( t23 ) ) );
+		_mm_storeu_ps( array + i, _mm_add_ps( begin, _mm_mul_ps( delta, factor ) ) );
+		t01 = _mm_add_pd( t01, incr );
+		t23 = _mm_add_pd( t23, incr );
+	}
+#elif defined( CINDER_AUDIO_PARAM_NEON )
+	const float32x4_t begin = vdupq_n_f32( valueBegin );
+	const float32x4_t delta = vdupq_n_f32( valueEnd - valueBegin );
+	const float64x2_t incr = vdupq_n_f64( 4 * tIncr );
+	const double t01Init[2] = { t, t + tIncr };
+	const double t23Init[2] = { t + 2 * tIncr, t + 3 * tIncr };
+	float64x2_t t01 = vld1q_f64( t01Init );
+	float64x2_t t23 = vld1q_f64( t23Init );
+	for( ; i + 4 <= count; i += 4 ) {
+		float32x4_t factor = vcombine_f32( vcvt_f32_f64( factorFn( t01 ) ), vcvt_f32_f64( factorFn( t23 ) ) );
+		vst1q_f32( array + i, vmlaq_f32( begin, delta, factor ) );
+		t01 = vaddq_f64( t01, incr );
+		t23 = vaddq_f64( t23, incr );
+	}
+#endif
+
+	t += (double)i * tIncr;
+	for( ; i < count; i++ ) {
+		auto factor = float( factorFn( t ) );
 		array[i] = lerp( valueBegin, valueEnd, factor );
 		t += tIncr;
 	}
 }
 
+typedef void (*RampFnPtr)( float *, size_t, double, double, float, float );
+
+} // anonymous namespace
+
+void rampLinear( float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd )
+{
+	ramp( array, count, t, tIncr, valueBegin, valueEnd, FactorLinear() );
+}
+
 void rampInQuad( float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd )
 {
-	for( size_t i = 0; i < count; i++ ) {
-		auto factor = static_cast<float>( t * t );
-		array[i] = lerp( valueBegin, valueEnd, factor );
-		t += tIncr;
-	}
+	ramp( array, count, t, tIncr, valueBegin, valueEnd, FactorInQuad() );
 }
 
 void rampOutQuad( float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd )
 {
-	for( size_t i = 0; i < count; i++ ) {
-		auto factor = float( -t * ( t - 2 ) );
-		array[i] = lerp( valueBegin, valueEnd, factor );
-		t += tIncr;
+	ramp( array, count, t, tIncr, valueBegin, valueEnd, FactorOutQuad() );
+}
+
+Event::Event( double timeBegin, double timeEnd, float valueBegin, float valueEnd, bool copyValueOnBegin, RampType rampType, const RampFn &rampFn )
+	: mTimeBegin( timeBegin ), mTimeEnd( timeEnd ), mDuration( timeEnd - timeBegin ), mTimeCancel( -1 ), mValueBegin( valueBegin ), mValueEnd( valueEnd ),
+		mIsComplete( false ), mIsCanceled( false ), mCopyValueOnBegin( copyValueOnBegin ), mRampType( rampType ), mRampFn( rampFn )
+{
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Param::Options
+// ----------------------------------------------------------------------------------------------------
+
+Param::Options& Param::Options::rampFn( const RampFn &rampFn )
+{
+	mRampFn = rampFn;
+	mRampType = RampType::CUSTOM;
+
+	// recognize the built-in ramping functions so they can be evaluated without the indirection
+	const RampFnPtr *fnPtr = rampFn.target<RampFnPtr>();
+	if( fnPtr ) {
+		if( *fnPtr == rampLinear )
+			mRampType = RampType::LINEAR;
+		else if( *fnPtr == rampInQuad )
+			mRampType = RampType::IN_QUAD;
+		else if( *fnPtr == rampOutQuad )
+			mRampType = RampType::OUT_QUAD;
 	}
+
+	return *this;
 }
 
-Event::Event( double timeBegin, double timeEnd, float valueBegin, float valueEnd, bool copyValueOnBegin, const RampFn &rampFn )
-	: mTimeBegin( timeBegin ), mTimeEnd( timeEnd ), mDuration( timeEnd - timeBegin ), mCopyValueOnBegin( copyValueOnBegin ),
-		mValueBegin( valueBegin ), mValueEnd( valueEnd ), mRampFn( rampFn ), mIsComplete( false ), mIsCanceled( false ), mTimeCancel( -1 )
+Param::Options& Param::Options::rampType( RampType type )
 {
+	CI_ASSERT_MSG( type != RampType::CUSTOM, "use rampFn() to specify a custom ramping function" );
+
+	switch( type ) {
+		case RampType::LINEAR:		mRampFn = rampLinear;	break;
+		case RampType::IN_QUAD:		mRampFn = rampInQuad;	break;
+		case RampType::OUT_QUAD:	mRampFn = rampOutQuad;	break;
+		default:					return *this;
+	}
+
+	mRampType = type;
+	return *this;
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Param
+// ----------------------------------------------------------------------------------------------------
+
 Param::Param( Node *parentNode, float initialValue )
-	: mParentNode( parentNode ), mValue( initialValue ), mIsVaryingThisBlock( false )
+	: mMaxEvents( 0 ), mValue( initialValue ), mIsVaryingThisBlock( false ), mParentNode( parentNode )
 {
 }
 
 void Param::setValue( float value )
 {
+	lock_guard<mutex> scheduleLock( mScheduleMutex );
 	lock_guard<mutex> lock( getContext()->getMutex() );
 	resetImpl();
 	mValue = value;
@@ -78,86 +198,22 @@ void Param::setValue( float value )
 
 EventRef Param::applyRamp( float valueEnd, double rampSeconds, const Options &options )
 {
-	initInternalBuffer();
-
-	auto ctx = getContext();
-	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : ctx->getNumProcessedSeconds() + options.getDelay() );
-	double timeEnd = timeBegin + rampSeconds;
-
-	EventRef event( new Event( timeBegin, timeEnd, mValue, valueEnd, true, options.getRampFn() ) );
-
-	if( ! options.getLabel().empty() )
-		event->mLabel = options.getLabel();
-
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	removeEventsAt( timeBegin );
-	if( mProcessor )
-		mProcessor.reset();
-
-	mEvents.push_back( event );
-	return event;
+	return scheduleEvent( false, true, mValue, valueEnd, rampSeconds, options );
 }
 
 EventRef Param::applyRamp( float valueBegin, float valueEnd, double rampSeconds, const Options &options )
 {
-	initInternalBuffer();
-
-	auto ctx = getContext();
-	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : ctx->getNumProcessedSeconds() + options.getDelay() );
-	double timeEnd = timeBegin + rampSeconds;
-
-	EventRef event( new Event( timeBegin, timeEnd, valueBegin, valueEnd, false, options.getRampFn() ) );
-
-	if( ! options.getLabel().empty() )
-		event->mLabel = options.getLabel();
-
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	removeEventsAt( timeBegin );
-	if( mProcessor )
-		mProcessor.reset();
-
-	mEvents.push_back( event );
-	return event;
+	return scheduleEvent( false, false, valueBegin, valueEnd, rampSeconds, options );
 }
 
 EventRef Param::appendRamp( float valueEnd, double rampSeconds, const Options &options )
 {
-	initInternalBuffer();
-
-	auto ctx = getContext();
-	auto endTimeAndValue = findEndTimeAndValue();
-	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : endTimeAndValue.first + options.getDelay() );
-	double timeEnd = timeBegin + rampSeconds;
-
-	EventRef event( new Event( timeBegin, timeEnd, endTimeAndValue.second, valueEnd, true, options.getRampFn() ) );
-
-	if( ! options.getLabel().empty() )
-		event->mLabel = options.getLabel();
-
-	lock_guard<mutex> lock( ctx->getMutex() );
-	mEvents.push_back( event );
-	return event;
+	return scheduleEvent( true, true, mValue, valueEnd, rampSeconds, options );
 }
 
 EventRef Param::appendRamp( float valueBegin, float valueEnd, double rampSeconds, const Options &options )
 {
-	initInternalBuffer();
-
-	auto ctx = getContext();
-	auto endTimeAndValue = findEndTimeAndValue();
-	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : endTimeAndValue.first + options.getDelay() );
-	double timeEnd = timeBegin + rampSeconds;
-
-	EventRef event( new Event( timeBegin, timeEnd, valueBegin, valueEnd, false, options.getRampFn() ) );
-
-	if( ! options.getLabel().empty() )
-		event->mLabel = options.getLabel();
-
-	lock_guard<mutex> lock( ctx->getMutex() );
-	mEvents.push_back( event );
-	return event;
+	return scheduleEvent( true, false, valueBegin, valueEnd, rampSeconds, options );
 }
 
 void Param::setProcessor( const NodeRef &node )
@@ -167,6 +223,7 @@ void Param::setProcessor( const NodeRef &node )
 
 	initInternalBuffer();
 
+	lock_guard<mutex> scheduleLock( mScheduleMutex );
 	lock_guard<mutex> lock( getContext()->getMutex() );
 
 	resetImpl();
@@ -181,6 +238,7 @@ void Param::setProcessor( const NodeRef &node )
 
 void Param::reset()
 {
+	lock_guard<mutex> scheduleLock( mScheduleMutex );
 	lock_guard<mutex> lock( getContext()->getMutex() );
 	resetImpl();
 }
@@ -188,14 +246,16 @@ void Param::reset()
 
 size_t Param::getNumEvents() const
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	lock_guard<mutex> lock( mScheduleMutex );
+	collectRetiredEvents();
 	return mEvents.size();
 }
 
 float Param::findDuration() const
 {
 	auto ctx = getContext();
-	lock_guard<mutex> lock( ctx->getMutex() );
+	lock_guard<mutex> lock( mScheduleMutex );
+	collectRetiredEvents();
 
 	if( mEvents.empty() )
 		return 0;
@@ -208,7 +268,8 @@ float Param::findDuration() const
 pair<double, float> Param::findEndTimeAndValue() const
 {
 	auto ctx = getContext();
-	lock_guard<mutex> lock( ctx->getMutex() );
+	lock_guard<mutex> lock( mScheduleMutex );
+	collectRetiredEvents();
 
 	if( mEvents.empty() )
 		return make_pair( ctx->getNumProcessedSeconds(), mValue.load() );
@@ -244,21 +305,23 @@ bool Param::eval()
 
 bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sampleRate )
 {
+	readQueuedEvents();
+
 	const double samplePeriod = 1.0 / (double)sampleRate;
 	const double secondsPerBlock = (double)arrayLength * samplePeriod;
 	size_t samplesWritten = 0;
 
-	for( auto eventIt = mEvents.begin(); eventIt != mEvents.end(); /* */ ) {
-		Event &event = **eventIt;
+	for( size_t eventIndex = 0; eventIndex < mActiveEvents.size(); /* */ ) {
+		Event &event = *mActiveEvents[eventIndex];
 
 		// first remove dead events
 		const bool cancelled = event.mIsCanceled;
 		if( event.mTimeEnd <= timeBegin || cancelled ) {
 			// if we skipped over the last event, record its end value before erasing.
-			if( mEvents.size() == 1 && ! cancelled )
+			if( mActiveEvents.size() == 1 && ! cancelled )
 				mValue = event.mValueEnd;
 
-			eventIt = mEvents.erase( eventIt );
+			retireEvent( eventIndex );
 			continue;
 		}
 
@@ -280,15 +343,16 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 			double timeIncr = ( timeEndNormalized - timeBeginNormalized ) / (double)count;
 
 			// If the event has a cancel time, adjust the count if needed, but all other ramp values remain the same
-			if( event.mTimeCancel > 0 ) {
-				if( event.mTimeCancel < timeBegin ) {
+			const double timeCancel = event.mTimeCancel;
+			if( timeCancel > 0 ) {
+				if( timeCancel < timeBegin ) {
 					// event should already be over
 					event.cancel();
-					eventIt = mEvents.erase( eventIt );
+					retireEvent( eventIndex );
 					continue;
 				}
 
-				size_t endIndexModified = timeEnd < event.mTimeCancel ? arrayLength : size_t( ( event.mTimeCancel - timeBegin ) * sampleRate );
+				size_t endIndexModified = timeEnd < timeCancel ? arrayLength : size_t( ( timeCancel - timeBegin ) * sampleRate );
 				if( endIndexModified != endIndex ) {
 					count = endIndexModified - startIndex;
 					event.cancel(); // cancel but still process. This Event will be removed from the container next block.
@@ -298,14 +362,21 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 			if( event.getCopyValueOnBegin() )
 				event.setValueBegin( mValue ); // this is only copied the first block the Event is processed, as next block getCopyValueOnBegin() is false.
 
-			event.mRampFn( array + startIndex, count, timeBeginNormalized, timeIncr, event.mValueBegin, event.mValueEnd );
+			float *rampArray = array + startIndex;
+			switch( event.mRampType ) {
+				case RampType::LINEAR:		rampLinear( rampArray, count, timeBeginNormalized, timeIncr, event.mValueBegin, event.mValueEnd );	break;
+				case RampType::IN_QUAD:		rampInQuad( rampArray, count, timeBeginNormalized, timeIncr, event.mValueBegin, event.mValueEnd );	break;
+				case RampType::OUT_QUAD:	rampOutQuad( rampArray, count, timeBeginNormalized, timeIncr, event.mValueBegin, event.mValueEnd );	break;
+				default:					event.mRampFn( rampArray, count, timeBeginNormalized, timeIncr, event.mValueBegin, event.mValueEnd );	break;
+			}
+
 			samplesWritten += count;
 
 			// if this ramp ended with the current processing block, update mValue then remove event
 			if( endIndex < arrayLength ) {
 				event.mIsComplete = true;
 				mValue = event.mValueEnd;
-				eventIt = mEvents.erase( eventIt );
+				retireEvent( eventIndex );
 			}
 			else if( samplesWritten == arrayLength ) {
 				// the array was filled, store the last calculated samples in mValue and finish evaluating
@@ -313,10 +384,10 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 				break;
 			}
 			else
-				++eventIt;
+				++eventIndex;
 		}
 		else
-			++eventIt;
+			++eventIndex;
 	}
 
 	if( ! samplesWritten )
@@ -331,13 +402,108 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 // Protected
 // ----------------------------------------------------------------------------------------------------
 
+EventRef Param::scheduleEvent( bool append, bool copyValueOnBegin, float valueBegin, float valueEnd, double rampSeconds, const Options &options )
+{
+	initInternalBuffer();
+
+	auto ctx = getContext();
+	lock_guard<mutex> lock( mScheduleMutex );
+	collectRetiredEvents();
+
+	double timeBegin;
+	if( options.getBeginTime() >= 0 )
+		timeBegin = options.getBeginTime();
+	else if( append && ! mEvents.empty() )
+		timeBegin = mEvents.back()->mTimeEnd + options.getDelay();
+	else
+		timeBegin = ctx->getNumProcessedSeconds() + options.getDelay();
+
+	if( append && copyValueOnBegin && ! mEvents.empty() )
+		valueBegin = mEvents.back()->mValueEnd;
+
+	EventRef event( new Event( timeBegin, timeBegin + rampSeconds, valueBegin, valueEnd, copyValueOnBegin, options.getRampType(), options.getRampFn() ) );
+
+	if( ! options.getLabel().empty() )
+		event->mLabel = options.getLabel();
+
+	if( ! append ) {
+		removeEventsAt( timeBegin );
+		if( mProcessor ) {
+			lock_guard<mutex> ctxLock( ctx->getMutex() );
+			mProcessor.reset();
+		}
+	}
+
+	// The queues are sized so that every live Event fits, which means the audio thread can always retire an Event without blocking.
+	// If they are full, wait for the audio thread to finish processing and grow them.
+	if( mEvents.size() >= mMaxEvents ) {
+		lock_guard<mutex> ctxLock( ctx->getMutex() );
+		collectEventsImpl();
+		if( mEvents.size() >= mMaxEvents )
+			growEventQueuesImpl( std::max( DEFAULT_MAX_EVENTS, mMaxEvents * 2 ) );
+	}
+
+	mEvents.push_back( event );
+	Event *eventPtr = event.get();
+	CI_VERIFY( mQueuedEvents.write( &eventPtr, 1 ) );
+
+	return event;
+}
+
+void Param::collectRetiredEvents() const
+{
+	Event *event;
+	while( mRetiredEvents.read( &event, 1 ) ) {
+		auto eventIt = find_if( mEvents.begin(), mEvents.end(), [event]( const EventRef &e ) { return e.get() == event; } );
+		CI_ASSERT( eventIt != mEvents.end() );
+		mEvents.erase( eventIt );
+	}
+}
+
+void Param::collectEventsImpl()
+{
+	readQueuedEvents();
+
+	for( size_t i = 0; i < mActiveEvents.size(); /* */ ) {
+		if( mActiveEvents[i]->mIsCanceled )
+			retireEvent( i );
+		else
+			i++;
+	}
+
+	collectRetiredEvents();
+}
+
+void Param::growEventQueuesImpl( size_t maxEvents )
+{
+	// only valid after collectEventsImpl(), when both queues are empty
+	mMaxEvents = maxEvents;
+	mQueuedEvents.resize( maxEvents );
+	mRetiredEvents.resize( maxEvents );
+	mActiveEvents.reserve( maxEvents );
+}
+
+void Param::readQueuedEvents()
+{
+	Event *event;
+	while( mQueuedEvents.read( &event, 1 ) )
+		mActiveEvents.push_back( event );
+}
+
+void Param::retireEvent( size_t index )
+{
+	Event *event = mActiveEvents[index];
+	mActiveEvents.erase( mActiveEvents.begin() + index );
+	CI_VERIFY( mRetiredEvents.write( &event, 1 ) );
+}
+
 void Param::resetImpl()
 {
 	if( ! mEvents.empty() ) {
 		for( auto &event : mEvents )
 			event->cancel();
 
-		mEvents.clear();
+		collectEventsImpl();
 	}
 
 	mProcessor.reset();
@@ -345,27 +511,22 @@ void Param::resetImpl()
 
 void Param::removeEventsAt( double time )
 {
-	auto context = mParentNode->getContext();
-	bool contextDisabled = ! context || ! context->isEnabled();
-	for( auto eventIt = mEvents.begin(); eventIt != mEvents.end(); /* */ ) {
-		Event &event = **eventIt;
-		if( event.getTimeBegin() >= time ) {
-			if( contextDisabled ) {
-				eventIt = mEvents.erase( eventIt );
-			}
-			else {
-				event.cancel();
-			}
-		}
-		else if( event.getTimeEnd() >= time ) {
+	for( auto &event : mEvents ) {
+		if( event->getTimeBegin() >= time )
+			event->cancel();
+		else if( event->getTimeEnd() >= time ) {
 			// Handle cancel later to allow the ramp to continue until the cancel point. Only reset cancel time if it is newer than a previous setting.
-			if( event.mTimeCancel > 0 ) {
-				event.mTimeCancel = min( event.mTimeCancel, time );
-			}
-			else
-				event.mTimeCancel = time;
+			double timeCancel = event->mTimeCancel;
+			event->mTimeCancel = timeCancel > 0 ? min( timeCancel, time ) : time;
 		}
 	}
+
+	// if the Context isn't processing, nothing else will remove the cancelled Events
+	auto context = mParentNode->getContext();
+	if( context && ! context->isEnabled() ) {
+		lock_guard<mutex> lock( context->getMutex() );
+		collectEventsImpl();
+	}
 }
 
 void Param::initInternalBuffer()
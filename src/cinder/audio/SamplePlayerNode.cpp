@@ -217,13 +217,13 @@ void BufferPlayerNode::process( Buffer *buffer )
 // ----------------------------------------------------------------------------------------------------
 
 FilePlayerNode::FilePlayerNode( const Format &format )
-	: SamplePlayerNode( format ), mRingBufferPaddingFactor( 2 ), mLastUnderrun( 0 ), mLastOverrun( 0 ), mIsReadAsync( true )
+	: SamplePlayerNode( format ), mRingBufferPaddingFactor( 2 ), mLastUnderrun( 0 ), mLastOverrun( 0 ), mLastAsyncReadPos( 0 ), mIsReadAsync( true )
 {
 }
 
 FilePlayerNode::FilePlayerNode( const SourceFileRef &sourceFile, bool isReadAsync, const Format &format )
 	: SamplePlayerNode( format ), mSourceFile( sourceFile ), mIsReadAsync( isReadAsync ), mRingBufferPaddingFactor( 2 ),
-		mLastUnderrun( 0 ), mLastOverrun( 0 )
+		mLastUnderrun( 0 ), mLastOverrun( 0 ), mLastAsyncReadPos( 0 )
 {
 	if( mSourceFile ) {
 		mNumFrames = mSourceFile->getNumFrames();
@@ -236,7 +236,7 @@ FilePlayerNode::FilePlayerNode( const SourceFileRef &sourceFile, bool isReadAsyn
 FilePlayerNode::~FilePlayerNode()
 {
 	if( isInitialized() )
-		destroyReadThreadImpl();
+		removeReaderImpl();
 }
 
 void FilePlayerNode::initialize()
@@ -249,27 +249,23 @@ void FilePlayerNode::initialize()
 
 		mNumFrames = mSourceFile->getNumFrames();
 
-		mIoBuffer.setSize( mSourceFile->getMaxFramesPerRead(), getNumChannels() );
-
-		for( size_t i = 0; i < getNumChannels(); i++ )
-			mRingBuffers.emplace_back( mSourceFile->getMaxFramesPerRead() * mRingBufferPaddingFactor );
-
-		mBufferFramesThreshold = mRingBuffers[0].getSize() / 2;
+		mRingBuffer.resize( mSourceFile->getMaxFramesPerRead() * mRingBufferPaddingFactor, getNumChannels() );
+		mBufferFramesThreshold = mRingBuffer.getSize() / 2;
 	}
 
 	if( ! mLoopEnd  || mLoopEnd > mNumFrames )
 		mLoopEnd = mNumFrames;
 
 	if( mIsReadAsync ) {
-		mAsyncReadShouldQuit = false;
-		mReadThread = unique_ptr<thread>( new thread( bind( &FilePlayerNode::readAsyncImpl, this ) ) );
+		mLastAsyncReadPos = mReadPos;
+		mReader = FileReadScheduler::get()->addReader( bind( &FilePlayerNode::readAsyncImpl, this ) );
 	}
 }
 
 void FilePlayerNode::uninitialize()
 {
-	destroyReadThreadImpl();
-	mRingBuffers.clear();
+	removeReaderImpl();
+	mRingBuffer.resize( 0, 0 );
 }
 
 void FilePlayerNode::enableProcessing()
@@ -370,21 +366,20 @@ void FilePlayerNode::process( Buffer *buffer )
 {
 	size_t numFrames = buffer->getNumFrames();
 	size_t readPos = mReadPos;
-	size_t numReadAvail = mRingBuffers[0].getAvailableRead();
+	size_t numReadAvail = mRingBuffer.getAvailableRead();
 
 	if( numReadAvail < mBufferFramesThreshold ) {
+		// the deadline is when the frames still buffered will have been played
 		if( mIsReadAsync )
-			mIssueAsyncReadCond.notify_one();
+			FileReadScheduler::get()->requestRead( mReader, (double)numReadAvail / (double)getSampleRate() );
 		else
 			readImpl();
 	}
 
 	size_t readCount = std::min( numReadAvail, numFrames );
 
-	for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ ) {
-		if( ! mRingBuffers[ch].read( buffer->getChannel( ch ), readCount ) )
-			mLastUnderrun = getContext()->getNumProcessedFrames();
-	}
+	if( ! mRingBuffer.read( buffer, readCount ) )
+		mLastUnderrun = getContext()->getNumProcessedFrames();
 
 	// handle loop or EOF
 	if( readCount < numFrames ) {
@@ -402,27 +397,20 @@ void FilePlayerNode::process( Buffer *buffer )
 
 void FilePlayerNode::readAsyncImpl()
 {
-	size_t lastReadPos = mReadPos;
-	while( true ) {
-		unique_lock<mutex> lock( mAsyncReadMutex );
-		mIssueAsyncReadCond.wait( lock );
-
-		if( mAsyncReadShouldQuit )
-			return;
+	lock_guard<mutex> lock( mAsyncReadMutex );
 
-		size_t readPos = mReadPos;
-		if( readPos != lastReadPos )
-			mSourceFile->seek( readPos );
+	size_t readPos = mReadPos;
+	if( readPos != mLastAsyncReadPos )
+		mSourceFile->seek( readPos );
 
-		readImpl();
-		lastReadPos = mReadPos;
-	}
+	readImpl();
+	mLastAsyncReadPos = mReadPos;
 }
 
 void FilePlayerNode::readImpl()
 {
 	size_t readPos = mReadPos;
-	size_t availableWrite = mRingBuffers[0].getAvailableWrite();
+	size_t availableWrite = mRingBuffer.getAvailableWrite();
 	size_t readEnd = mLoop ? mLoopEnd.load() : mNumFrames;
 	size_t numFramesToRead = readEnd < readPos ? 0 : min( availableWrite, readEnd - readPos );
 
@@ -435,16 +423,18 @@ void FilePlayerNode::readImpl()
 	if( readPos != mSourceFile->getReadPosition() )
 		mSourceFile->seek( readPos );
 
-	mIoBuffer.setNumFrames( numFramesToRead );
+	// decode into the ringbuffer's free region, which takes two reads when it wraps around the end
+	while( numFramesToRead && mSourceFile->getReadPosition() < mSourceFile->getNumFrames() ) {
+		size_t regionFrames;
+		size_t regionOffset = mRingBuffer.getWriteRegion( &regionFrames );
 
-	size_t numRead = mSourceFile->read( &mIoBuffer );
-	mReadPos += numRead;
+		size_t numRead = mSourceFile->read( mRingBuffer.getBuffer(), regionOffset, min( regionFrames, numFramesToRead ) );
+		if( ! numRead )
+			break;
 
-	for( size_t ch = 0; ch < getNumChannels(); ch++ ) {
-		if( ! mRingBuffers[ch].write( mIoBuffer.getChannel( ch ), numRead ) ) {
-			mLastOverrun = getContext()->getNumProcessedFrames();
-			return;
-		}
+		mRingBuffer.commitWrite( numRead );
+		mReadPos += numRead;
+		numFramesToRead -= numRead;
 	}
 }
 
@@ -465,18 +455,16 @@ void FilePlayerNode::stopImpl()
 {
 	disable();
 
-	for( auto &ringBuffer : mRingBuffers )
-		ringBuffer.clear();
+	mRingBuffer.clear();
 
 	seekImpl( 0 );
 }
 
-void FilePlayerNode::destroyReadThreadImpl()
+void FilePlayerNode::removeReaderImpl()
 {
-	if( mIsReadAsync && mReadThread ) {
-		mAsyncReadShouldQuit = true;
-		mIssueAsyncReadCond.notify_one();
-		mReadThread->join();
+	if( mReader ) {
+		FileReadScheduler::get()->removeReader( mReader );
+		mReader.reset();
 	}
 }
 
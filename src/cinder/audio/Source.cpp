@@ -151,6 +151,27 @@ size_t SourceFile::read( Buffer *buffer )
 	return numRead;
 }
 
+size_t SourceFile::read( Buffer *buffer, size_t bufferFrameOffset, size_t numFrames )
+{
+	CI_ASSERT( buffer->getNumChannels() == getNumChannels() );
+	CI_ASSERT( bufferFrameOffset + numFrames <= buffer->getNumFrames() );
+	CI_ASSERT( mReadPos < mNumFrames );
+
+	// the Converter always writes to the beginning of its destination, so converted frames are copied into place
+	if( mConverter ) {
+		mConverterOutputBuffer.setSize( numFrames, getNumChannels() );
+		size_t numRead = read( &mConverterOutputBuffer );
+		buffer->copyOffset( mConverterOutputBuffer, numRead, bufferFrameOffset, 0 );
+		return numRead;
+	}
+
+	size_t numFramesNeeded = std::min( mNumFrames - mReadPos, std::min( getMaxFramesPerRead(), numFrames ) );
+	size_t numRead = performRead( buffer, bufferFrameOffset, numFramesNeeded );
+
+	mReadPos += numRead;
+	return numRead;
+}
+
 BufferRef SourceFile::loadBuffer()
 {
 	seek( 0 );
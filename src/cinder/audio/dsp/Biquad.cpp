@@ -468,6 +468,15 @@ void Biquad::reset()
 
 
 
+void Biquad::getCoefficients( double *b0, double *b1, double *b2, double *a1, double *a2 ) const
+{
+	*b0 = mB0;
+	*b1 = mB1;
+	*b2 = mB2;
+	*a1 = mA1;
+	*a2 = mA2;
+}
+
 void Biquad::setNormalizedCoefficients( double b0, double b1, double b2, double a0, double a1, double a2 )
 {
 	double a0Inverse = 1 / a0;
@@ -0,0 +1,409 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/audio/dsp/BiquadCascade.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <immintrin.h>
+	// AVX2 kernels are compiled for that target individually and only called if dsp::getSimdBackend() selected it
+	#define CINDER_AUDIO_BIQUAD_AVX2
+	#if defined( _MSC_VER ) && ! defined( __clang__ )
+		#define CI_BIQUAD_TARGET_AVX2
+	#else
+		#define CI_BIQUAD_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+	#endif
+#elif defined( CINDER_SIMD_NEON )
+	#include <arm_neon.h>
+	#if defined( __aarch64__ ) || defined( _M_ARM64 )
+		#define CINDER_AUDIO_BIQUAD_NEON_DOUBLE
+	#endif
+#endif
+
+using namespace std;
+
+namespace cinder { namespace audio { namespace dsp {
+
+namespace {
+
+// Frames transposed into the scratch buffer at a time, small enough that a group's block stays in L1
+const size_t BLOCK_FRAMES = 64;
+const size_t NUM_COEFFICIENTS = 5; // b0, b1, b2, a1, a2
+
+template <typename T>
+using Kernel = void (*)( T *frames, size_t numFrames, size_t numLanes, const T *coefficients, T *state, size_t numSections );
+
+// Runs every section in turn over a block of frames for one group of channels, laid out as [frame][lane] and processed
+// in place. Each section uses the transposed direct form II recurrence:
+//
+// y = b0 * x + z1
+// z1 = b1 * x - a1 * y + z2
+// z2 = b2 * x - a2 * y
+template <typename Ops, typename T>
+void processSections( T *frames, size_t numFrames, size_t numLanes, const T *coefficients, T *state, size_t numSections )
+{
+	for( size_t section = 0; section < numSections; section++ ) {
+		const T *c = coefficients + section * NUM_COEFFICIENTS * numLanes;
+		T *z = state + section * 2 * numLanes;
+
+		for( size_t lane = 0; lane < numLanes; lane += Ops::WIDTH ) {
+			const auto b0 = Ops::load( c + lane );
+			const auto b1 = Ops::load( c + numLanes + lane );
+			const auto b2 = Ops::load( c + 2 * numLanes + lane );
+			const auto a1 = Ops::load( c + 3 * numLanes + lane );
+			const auto a2 = Ops::load( c + 4 * numLanes + lane );
+			auto z1 = Ops::load( z + lane );
+			auto z2 = Ops::load( z + numLanes + lane );
+
+			T *frame = frames + lane;
+			for( size_t i = 0; i < numFrames; i++, frame += numLanes ) {
+				const auto x = Ops::load( frame );
+				const auto y = Ops::add( Ops::mul( b0, x ), z1 );
+				z1 = Ops::add( Ops::sub( Ops::mul( b1, x ), Ops::mul( a1, y ) ), z2 );
+				z2 = Ops::sub( Ops::mul( b2, x ), Ops::mul( a2, y ) );
+				Ops::store( frame, y );
+			}
+
+			Ops::store( z + lane, z1 );
+			Ops::store( z + numLanes + lane, z2 );
+		}
+	}
+}
+
+template <typename T>
+struct ScalarOps {
+	typedef T Vec;
+	static const size_t WIDTH = 1;
+
+	static Vec	load( const T *p )			{ return *p; }
+	static void	store( T *p, Vec v )		{ *p = v; }
+	static Vec	add( Vec a, Vec b )			{ return a + b; }
+	static Vec	sub( Vec a, Vec b )			{ return a - b; }
+	static Vec	mul( Vec a, Vec b )			{ return a * b; }
+};
+
+#if defined( CINDER_SIMD_SSE2 )
+
+struct Sse2FloatOps {
+	typedef __m128 Vec;
+	static const size_t WIDTH = 4;
+
+	static Vec	load( const float *p )		{ return _mm_loadu_ps( p ); }
+	static void	store( float *p, Vec v )	{ _mm_storeu_ps( p, v ); }
+	static Vec	add( Vec a, Vec b )			{ return _mm_add_ps( a, b ); }
+	static Vec	sub( Vec a, Vec b )			{ return _mm_sub_ps( a, b ); }
+	static Vec	mul( Vec a, Vec b )			{ return _mm_mul_ps( a, b ); }
+};
+
+struct Sse2DoubleOps {
+	typedef __m128d Vec;
+	static const size_t WIDTH = 2;
+
+	static Vec	load( const double *p )		{ return _mm_loadu_pd( p ); }
+	static void	store( double *p, Vec v )	{ _mm_storeu_pd( p, v ); }
+	static Vec	add( Vec a, Vec b )			{ return _mm_add_pd( a, b ); }
+	static Vec	sub( Vec a, Vec b )			{ return _mm_sub_pd( a, b ); }
+	static Vec	mul( Vec a, Vec b )			{ return _mm_mul_pd( a, b ); }
+};
+
+#endif // defined( CINDER_SIMD_SSE2 )
+
+#if defined( CINDER_AUDIO_BIQUAD_AVX2 )
+
+// A group is exactly one AVX register wide in both precisions, so these are written out rather than going through processSections().
+CI_BIQUAD_TARGET_AVX2 void processSectionsAvx2( float *frames, size_t numFrames, size_t numLanes, const float *coefficients, float *state, size_t numSections )
+{
+	CI_ASSERT( numLanes == 8 );
+
+	for( size_t section = 0; section < numSections; section++ ) {
+		const float *c = coefficients + section * NUM_COEFFICIENTS * 8;
+		float *z = state + section * 2 * 8;
+
+		const __m256 b0 = _mm256_loadu_ps( c );
+		const __m256 b1 = _mm256_loadu_ps( c + 8 );
+		const __m256 b2 = _mm256_loadu_ps( c + 16 );
+		const __m256 a1 = _mm256_loadu_ps( c + 24 );
+		const __m256 a2 = _mm256_loadu_ps( c + 32 );
+		__m256 z1 = _mm256_loadu_ps( z );
+		__m256 z2 = _mm256_loadu_ps( z + 8 );
+
+		float *frame = frames;
+		for( size_t i = 0; i < numFrames; i++, frame += 8 ) {
+			const __m256 x = _mm256_loadu_ps( frame );
+			const __m256 y = _mm256_add_ps( _mm256_mul_ps( b0, x ), z1 );
+			z1 = _mm256_add_ps( _mm256_sub_ps( _mm256_mul_ps( b1, x ), _mm256_mul_ps( a1, y ) ), z2 );
+			z2 = _mm256_sub_ps( _mm256_mul_ps( b2, x ), _mm256_mul_ps( a2, y ) );
+			_mm256_storeu_ps( frame, y );
+		}
+
+		_mm256_storeu_ps( z, z1 );
+		_mm256_storeu_ps( z + 8, z2 );
+	}
+}
+
+CI_BIQUAD_TARGET_AVX2 void processSectionsAvx2( double *frames, size_t numFrames, size_t numLanes, const double *coefficients, double *state, size_t numSections )
+{
+	CI_ASSERT( numLanes == 4 );
+
+	for( size_t section = 0; section < numSections; section++ ) {
+		const double *c = coefficients + section * NUM_COEFFICIENTS * 4;
+		double *z = state + section * 2 * 4;
+
+		const __m256d b0 = _mm256_loadu_pd( c );
+		const __m256d b1 = _mm256_loadu_pd( c + 4 );
+		const __m256d b2 = _mm256_loadu_pd( c + 8 );
+		const __m256d a1 = _mm256_loadu_pd( c + 12 );
+		const __m256d a2 = _mm256_loadu_pd( c + 16 );
+		__m256d z1 = _mm256_loadu_pd( z );
+		__m256d z2 = _mm256_loadu_pd( z + 4 );
+
+		double *frame = frames;
+		for( size_t i = 0; i < numFrames; i++, frame += 4 ) {
+			const __m256d x = _mm256_loadu_pd( frame );
+			const __m256d y = _mm256_add_pd( _mm256_mul_pd( b0, x ), z1 );
+			z1 = _mm256_add_pd( _mm256_sub_pd( _mm256_mul_pd( b1, x ), _mm256_mul_pd( a1, y ) ), z2 );
+			z2 = _mm256_sub_pd( _mm256_mul_pd( b2, x ), _mm256_mul_pd( a2, y ) );
+			_mm256_storeu_pd( frame, y );
+		}
+
+		_mm256_storeu_pd( z, z1 );
+		_mm256_storeu_pd( z + 4, z2 );
+	}
+}
+
+#endif // defined( CINDER_AUDIO_BIQUAD_AVX2 )
+
+#if defined( CINDER_SIMD_NEON )
+
+struct NeonFloatOps {
+	typedef float32x4_t Vec;
+	static const size_t WIDTH = 4;
+
+	static Vec	load( const float *p )		{ return vld1q_f32( p ); }
+	static void	store( float *p, Vec v )	{ vst1q_f32( p, v ); }
+	static Vec	add( Vec a, Vec b )			{ return vaddq_f32( a, b ); }
+	static Vec	sub( Vec a, Vec b )			{ return vsubq_f32( a, b ); }
+	static Vec	mul( Vec a, Vec b )			{ return vmulq_f32( a, b ); }
+};
+
+#if defined( CINDER_AUDIO_BIQUAD_NEON_DOUBLE )
+
+struct NeonDoubleOps {
+	typedef float64x2_t Vec;
+	static const size_t WIDTH = 2;
+
+	static Vec	load( const double *p )		{ return vld1q_f64( p ); }
+	static void	store( double *p, Vec v )	{ vst1q_f64( p, v ); }
+	static Vec	add( Vec a, Vec b )			{ return vaddq_f64( a, b ); }
+	static Vec	sub( Vec a, Vec b )			{ return vsubq_f64( a, b ); }
+	static Vec	mul( Vec a, Vec b )			{ return vmulq_f64( a, b ); }
+};
+
+#endif // defined( CINDER_AUDIO_BIQUAD_NEON_DOUBLE )
+
+#endif // defined( CINDER_SIMD_NEON )
+
+// vDSP builds use whichever vector instruction set the target guarantees, as vDSP has no equivalent of this layout.
+SimdBackend resolveBackend( SimdBackend backend )
+{
+	if( backend != SimdBackend::VDSP )
+		return backend;
+
+#if defined( CINDER_SIMD_SSE2 )
+	return SimdBackend::SSE2;
+#elif defined( CINDER_SIMD_NEON )
+	return SimdBackend::NEON;
+#else
+	return SimdBackend::SCALAR;
+#endif
+}
+
+Kernel<float> getKernel( SimdBackend backend, float * )
+{
+	switch( resolveBackend( backend ) ) {
+#if defined( CINDER_SIMD_SSE2 )
+		case SimdBackend::SSE2:
+			return processSections<Sse2FloatOps, float>;
+#endif
+#if defined( CINDER_AUDIO_BIQUAD_AVX2 )
+		case SimdBackend::AVX2:
+			return processSectionsAvx2;
+#endif
+#if defined( CINDER_SIMD_NEON )
+		case SimdBackend::NEON:
+			return processSections<NeonFloatOps, float>;
+#endif
+		default:
+			return processSections<ScalarOps<float>, float>;
+	}
+}
+
+Kernel<double> getKernel( SimdBackend backend, double * )
+{
+	switch( resolveBackend( backend ) ) {
+#if defined( CINDER_SIMD_SSE2 )
+		case SimdBackend::SSE2:
+			return processSections<Sse2DoubleOps, double>;
+#endif
+#if defined( CINDER_AUDIO_BIQUAD_AVX2 )
+		case SimdBackend::AVX2:
+			return processSectionsAvx2;
+#endif
+#if defined( CINDER_AUDIO_BIQUAD_NEON_DOUBLE )
+		case SimdBackend::NEON:
+			return processSections<NeonDoubleOps, double>;
+#endif
+		default:
+			return processSections<ScalarOps<double>, double>;
+	}
+}
+
+} // anonymous namespace
+
+BiquadCascade::BiquadCascade( size_t numChannels, size_t numSections, Precision precision )
+	: mNumChannels( numChannels ), mNumSections( numSections ), mPrecision( precision )
+{
+	CI_ASSERT( numChannels > 0 && numSections > 0 );
+
+	mNumLanes = ( precision == Precision::FLOAT ? 8 : 4 );
+	const size_t numGroups = ( mNumChannels + mNumLanes - 1 ) / mNumLanes;
+	const size_t numCoefficients = numGroups * mNumSections * NUM_COEFFICIENTS * mNumLanes;
+	const size_t numState = numGroups * mNumSections * 2 * mNumLanes;
+	const size_t numScratch = BLOCK_FRAMES * mNumLanes;
+
+	// Lanes past the last channel are never written, so they stay silent
+	if( precision == Precision::FLOAT ) {
+		mCoefficientsf.resize( numCoefficients );
+		mStatef.resize( numState );
+		mScratchf.resize( numScratch );
+	}
+	else {
+		mCoefficientsd.resize( numCoefficients );
+		mStated.resize( numState );
+		mScratchd.resize( numScratch );
+	}
+
+	// Initialize as pass-thru
+	for( size_t ch = 0; ch < mNumChannels; ch++ ) {
+		for( size_t section = 0; section < mNumSections; section++ )
+			setCoefficients( ch, section, 1, 0, 0, 0, 0 );
+	}
+}
+
+void BiquadCascade::setCoefficients( size_t channel, size_t section, double b0, double b1, double b2, double a1, double a2 )
+{
+	CI_ASSERT( channel < mNumChannels && section < mNumSections );
+
+	const double values[NUM_COEFFICIENTS] = { b0, b1, b2, a1, a2 };
+	if( mPrecision == Precision::FLOAT )
+		storeCoefficients( mCoefficientsf, channel, section, values );
+	else
+		storeCoefficients( mCoefficientsd, channel, section, values );
+}
+
+void BiquadCascade::setSection( size_t channel, size_t section, const Biquad &biquad )
+{
+	double b0, b1, b2, a1, a2;
+	biquad.getCoefficients( &b0, &b1, &b2, &a1, &a2 );
+	setCoefficients( channel, section, b0, b1, b2, a1, a2 );
+}
+
+void BiquadCascade::setSection( size_t section, const Biquad &biquad )
+{
+	for( size_t ch = 0; ch < mNumChannels; ch++ )
+		setSection( ch, section, biquad );
+}
+
+void BiquadCascade::process( Buffer *buffer )
+{
+	process( *buffer, buffer );
+}
+
+void BiquadCascade::process( const Buffer &source, Buffer *dest )
+{
+	CI_ASSERT( source.getNumChannels() == mNumChannels && dest->getNumChannels() == mNumChannels );
+	CI_ASSERT( source.getNumFrames() == dest->getNumFrames() );
+
+	process( source.getData(), dest->getData(), source.getNumFrames(), source.getNumFrames() );
+}
+
+void BiquadCascade::process( const float *source, float *dest, size_t framesToProcess, size_t channelStride )
+{
+	if( mPrecision == Precision::FLOAT )
+		processImpl( source, dest, framesToProcess, channelStride, mCoefficientsf, mStatef, mScratchf );
+	else
+		processImpl( source, dest, framesToProcess, channelStride, mCoefficientsd, mStated, mScratchd );
+}
+
+void BiquadCascade::reset()
+{
+	fill( mStatef.begin(), mStatef.end(), 0.0f );
+	fill( mStated.begin(), mStated.end(), 0.0 );
+}
+
+template <typename T>
+void BiquadCascade::processImpl( const float *source, float *dest, size_t framesToProcess, size_t channelStride, vector<T> &coefficients, vector<T> &state, vector<T> &scratch )
+{
+	const Kernel<T> kernel = getKernel( getSimdBackend(), (T *)nullptr );
+	const size_t numLanes = mNumLanes;
+	T *frames = scratch.data();
+
+	for( size_t firstChannel = 0; firstChannel < mNumChannels; firstChannel += numLanes ) {
+		const size_t group = firstChannel / numLanes;
+		const size_t numChannels = min( numLanes, mNumChannels - firstChannel );
+		const T *groupCoefficients = &coefficients[group * mNumSections * NUM_COEFFICIENTS * numLanes];
+		T *groupState = &state[group * mNumSections * 2 * numLanes];
+
+		for( size_t offset = 0; offset < framesToProcess; offset += BLOCK_FRAMES ) {
+			const size_t numFrames = min( BLOCK_FRAMES, framesToProcess - offset );
+
+			for( size_t lane = 0; lane < numChannels; lane++ ) {
+				const float *channel = source + ( firstChannel + lane ) * channelStride + offset;
+				for( size_t i = 0; i < numFrames; i++ )
+					frames[i * numLanes + lane] = channel[i];
+			}
+
+			kernel( frames, numFrames, numLanes, groupCoefficients, groupState, mNumSections );
+
+			for( size_t lane = 0; lane < numChannels; lane++ ) {
+				float *channel = dest + ( firstChannel + lane ) * channelStride + offset;
+				for( size_t i = 0; i < numFrames; i++ )
+					channel[i] = static_cast<float>( frames[i * numLanes + lane] );
+			}
+		}
+	}
+}
+
+template <typename T>
+void BiquadCascade::storeCoefficients( vector<T> &coefficients, size_t channel, size_t section, const double *values )
+{
+	const size_t group = channel / mNumLanes;
+	const size_t lane = channel % mNumLanes;
+	T *c = &coefficients[( group * mNumSections + section ) * NUM_COEFFICIENTS * mNumLanes + lane];
+	for( size_t i = 0; i < NUM_COEFFICIENTS; i++ )
+		c[i * mNumLanes] = static_cast<T>( values[i] );
+}
+
+} } } // namespace cinder::audio::dsp
@@ -0,0 +1,128 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/audio/dsp/Convolver.h"
+#include "cinder/audio/Exception.h"
+#include "cinder/CinderMath.h"
+
+#include <cstring>
+
+using namespace std;
+
+namespace cinder { namespace audio { namespace dsp {
+
+namespace {
+
+// Accumulates the product of spectra \a a and \a b into \a result. Bin 0 packs the DC and Nyquist components, which are both real.
+void multiplyAccumulate( const BufferSpectral &a, const BufferSpectral &b, BufferSpectral *result )
+{
+	const float *aReal = a.getReal();
+	const float *aImag = a.getImag();
+	const float *bReal = b.getReal();
+	const float *bImag = b.getImag();
+	float *real = result->getReal();
+	float *imag = result->getImag();
+
+	real[0] += aReal[0] * bReal[0];
+	imag[0] += aImag[0] * bImag[0];
+
+	const size_t numBins = a.getNumFrames();
+	for( size_t i = 1; i < numBins; i++ ) {
+		real[i] += aReal[i] * bReal[i] - aImag[i] * bImag[i];
+		imag[i] += aReal[i] * bImag[i] + aImag[i] * bReal[i];
+	}
+}
+
+} // anonymous namespace
+
+Convolver::Convolver( const float *impulseResponse, size_t impulseResponseLength, size_t partitionSize )
+	: mPartitionSize( partitionSize ), mDelayLineIndex( 0 )
+{
+	if( ! partitionSize || ! isPowerOf2( partitionSize ) )
+		throw AudioExc( "Convolver partition size must be a power of two." );
+
+	const size_t fftSize = partitionSize * 2;
+	mFft.reset( new Fft( fftSize ) );
+	mTimeDomain = Buffer( fftSize );
+	mInverse = Buffer( fftSize );
+	mSum = BufferSpectral( fftSize );
+
+	// The forward transform is scaled differently depending on the implementation, so measure the gain of a unit impulse
+	// and fold its inverse into the impulse response spectra. Products of two spectra carry the gain twice, while the inverse
+	// transform removes it once.
+	mTimeDomain.zero();
+	mTimeDomain[0] = 1;
+	mFft->forward( &mTimeDomain, &mSum );
+	const float scale = 1.0f / mSum.getReal()[0];
+
+	const size_t numPartitions = max<size_t>( 1, ( impulseResponseLength + partitionSize - 1 ) / partitionSize );
+	mImpulseResponseSpectra.resize( numPartitions, BufferSpectral( fftSize ) );
+	mDelayLine.resize( numPartitions, BufferSpectral( fftSize ) );
+
+	for( size_t i = 0; i < numPartitions; i++ ) {
+		const size_t offset = i * partitionSize;
+		const size_t length = offset < impulseResponseLength ? min( partitionSize, impulseResponseLength - offset ) : 0;
+
+		mTimeDomain.zero();
+		for( size_t frame = 0; frame < length; frame++ )
+			mTimeDomain[frame] = impulseResponse[offset + frame] * scale;
+
+		mFft->forward( &mTimeDomain, &mImpulseResponseSpectra[i] );
+	}
+
+	reset();
+}
+
+void Convolver::process( const float *input, float *output )
+{
+	// The time domain buffer holds the previous partition of input followed by the current one
+	float *timeDomain = mTimeDomain.getData();
+	memcpy( timeDomain, timeDomain + mPartitionSize, mPartitionSize * sizeof( float ) );
+	memcpy( timeDomain + mPartitionSize, input, mPartitionSize * sizeof( float ) );
+
+	mFft->forward( &mTimeDomain, &mDelayLine[mDelayLineIndex] );
+
+	const size_t numPartitions = mImpulseResponseSpectra.size();
+	mSum.zero();
+	for( size_t i = 0; i < numPartitions; i++ ) {
+		const size_t inputIndex = ( mDelayLineIndex + numPartitions - i ) % numPartitions;
+		multiplyAccumulate( mDelayLine[inputIndex], mImpulseResponseSpectra[i], &mSum );
+	}
+
+	mDelayLineIndex = ( mDelayLineIndex + 1 ) % numPartitions;
+
+	// The first half of the inverse transform is circular aliasing and discarded
+	mFft->inverse( &mSum, &mInverse );
+	memcpy( output, mInverse.getData() + mPartitionSize, mPartitionSize * sizeof( float ) );
+}
+
+void Convolver::reset()
+{
+	mTimeDomain.zero();
+	for( auto &spectrum : mDelayLine )
+		spectrum.zero();
+
+	mDelayLineIndex = 0;
+}
+
+} } } // namespace cinder::audio::dsp
@@ -25,8 +25,24 @@
 
 #include "cinder/CinderMath.h"
 
+#include <algorithm>
+
 #if defined( CINDER_AUDIO_VDSP )
 	#include <Accelerate/Accelerate.h>
+#else
+	#if defined( CINDER_SIMD_SSE2 )
+		#include <immintrin.h>
+		// AVX2 kernels are compiled for that target individually and only called if the CPU supports it
+		#define CINDER_AUDIO_DSP_AVX2
+		#if defined( _MSC_VER ) && ! defined( __clang__ )
+			#include <intrin.h>
+			#define CI_DSP_TARGET_AVX2
+		#else
+			#define CI_DSP_TARGET_AVX2 __attribute__(( target( "avx2" ) ))
+		#endif
+	#elif defined( CINDER_SIMD_NEON )
+		#include <arm_neon.h>
+	#endif
 #endif
 
 using namespace ci;
@@ -164,67 +180,688 @@ void addMul( const float *arrayA, const float *arrayB, float scalar, float *resu
 	vDSP_vasm( const_cast<float *>( arrayA ), 1, const_cast<float *>( arrayB ), 1, &scalar, result, 1, length );
 }
 
+static float maxValue( const float *array, size_t length )
+{
+	float result;
+	vDSP_maxv( const_cast<float *>( array ), 1, &result, length );
+	return result;
+}
+
+SimdBackend getSimdBackend()
+{
+	return SimdBackend::VDSP;
+}
+
+bool isSimdBackendSupported( SimdBackend backend )
+{
+	return backend == SimdBackend::VDSP;
+}
+
+bool setSimdBackend( SimdBackend backend )
+{
+	return backend == SimdBackend::VDSP;
+}
+
 #else // ! defined( CINDER_AUDIO_VDSP )
 
-void fill( float value, float *array, size_t length )
+namespace {
+
+// ----------------------------------------------------------------------------------------------------
+// Scalar kernels, also used for the remainder of the SIMD kernels
+// ----------------------------------------------------------------------------------------------------
+
+void fillScalar( float value, float *array, size_t length )
 {
 	for( size_t i = 0; i < length; i++ )
 		array[i] = value;
 }
 
-float sum( const float *array, size_t length )
+void addScalarScalar( const float *array, float scalar, float *result, size_t length )
 {
-	float result( 0.0f );
 	for( size_t i = 0; i < length; i++ )
-		result += array[i];
-	return result;
+		result[i] = array[i] + scalar;
 }
 
-void add( const float *array, float scalar, float *result, size_t length )
+void addScalar( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
 	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] + scalar;
+		result[i] = arrayA[i] + arrayB[i];
 }
 
-void add( const float *arrayA, const float *arrayB, float *result, size_t length )
+void subScalar( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
 	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] + arrayB[i];
+		result[i] = arrayA[i] - arrayB[i];
 }
 
-void sub( const float *array, float scalar, float *result, size_t length )
+void mulScalarScalar( const float *array, float scalar, float *result, size_t length )
 {
 	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] - scalar;
+		result[i] = array[i] * scalar;
 }
 
-void sub( const float *arrayA, const float *arrayB, float *result, size_t length )
+void mulScalar( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
 	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] - arrayB[i];
+		result[i] = arrayA[i] * arrayB[i];
 }
 
-float rms( const float *array, size_t length )
+void divideScalar( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	float sumSquared( 0.0f );
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] / arrayB[i];
+}
+
+void addMulScalar( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+}
+
+float sumScalar( const float *array, size_t length )
+{
+	float result( 0.0f );
+	for( size_t i = 0; i < length; i++ )
+		result += array[i];
+	return result;
+}
+
+float sumOfSquaresScalar( const float *array, size_t length )
+{
+	float result( 0.0f );
 	for( size_t i = 0; i < length; i++ ) {
 		float val = array[i];
-		sumSquared += val * val;
+		result += val * val;
+	}
+	return result;
+}
+
+float maxScalar( const float *array, size_t length )
+{
+	float result = 0;
+	for( size_t i = 0; i < length; i++ ) {
+		if( result < array[i] )
+			result = array[i];
+	}
+	return result;
+}
+
+// ----------------------------------------------------------------------------------------------------
+// SSE2 kernels
+// ----------------------------------------------------------------------------------------------------
+
+#if defined( CINDER_SIMD_SSE2 )
+
+inline float horizontalSum( __m128 v )
+{
+	__m128 shuffled = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+	__m128 sums = _mm_add_ps( v, shuffled );
+	shuffled = _mm_movehl_ps( shuffled, sums );
+	return _mm_cvtss_f32( _mm_add_ss( sums, shuffled ) );
+}
+
+inline float horizontalMax( __m128 v )
+{
+	__m128 shuffled = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+	__m128 maxs = _mm_max_ps( v, shuffled );
+	shuffled = _mm_movehl_ps( shuffled, maxs );
+	return _mm_cvtss_f32( _mm_max_ss( maxs, shuffled ) );
+}
+
+void fillSse2( float value, float *array, size_t length )
+{
+	const __m128 v = _mm_set1_ps( value );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( array + i, v );
+
+	fillScalar( value, array + i, length - i );
+}
+
+void addScalarSse2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m128 s = _mm_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_add_ps( _mm_loadu_ps( array + i ), s ) );
+
+	addScalarScalar( array + i, scalar, result + i, length - i );
+}
+
+void addSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_add_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+
+	addScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void subSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_sub_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+
+	subScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void mulScalarSse2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m128 s = _mm_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_mul_ps( _mm_loadu_ps( array + i ), s ) );
+
+	mulScalarScalar( array + i, scalar, result + i, length - i );
+}
+
+void mulSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_mul_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+
+	mulScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void divideSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_div_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+
+	divideScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void addMulSse2( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	const __m128 s = _mm_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_mul_ps( _mm_add_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ), s ) );
+
+	addMulScalar( arrayA + i, arrayB + i, scalar, result + i, length - i );
+}
+
+float sumSse2( const float *array, size_t length )
+{
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		acc0 = _mm_add_ps( acc0, _mm_loadu_ps( array + i ) );
+		acc1 = _mm_add_ps( acc1, _mm_loadu_ps( array + i + 4 ) );
+	}
+
+	return horizontalSum( _mm_add_ps( acc0, acc1 ) ) + sumScalar( array + i, length - i );
+}
+
+float sumOfSquaresSse2( const float *array, size_t length )
+{
+	__m128 acc0 = _mm_setzero_ps(), acc1 = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		__m128 v0 = _mm_loadu_ps( array + i );
+		__m128 v1 = _mm_loadu_ps( array + i + 4 );
+		acc0 = _mm_add_ps( acc0, _mm_mul_ps( v0, v0 ) );
+		acc1 = _mm_add_ps( acc1, _mm_mul_ps( v1, v1 ) );
+	}
+
+	return horizontalSum( _mm_add_ps( acc0, acc1 ) ) + sumOfSquaresScalar( array + i, length - i );
+}
+
+float maxSse2( const float *array, size_t length )
+{
+	__m128 acc = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		acc = _mm_max_ps( acc, _mm_loadu_ps( array + i ) );
+
+	return std::max( horizontalMax( acc ), maxScalar( array + i, length - i ) );
+}
+
+#endif // defined( CINDER_SIMD_SSE2 )
+
+// ----------------------------------------------------------------------------------------------------
+// AVX2 kernels
+// ----------------------------------------------------------------------------------------------------
+
+#if defined( CINDER_AUDIO_DSP_AVX2 )
+
+bool cpuSupportsAvx2()
+{
+#if defined( _MSC_VER ) && ! defined( __clang__ )
+	int info[4];
+	__cpuid( info, 0 );
+	if( info[0] < 7 )
+		return false;
+
+	// AVX needs to be enabled by the OS as well, which is reported through OSXSAVE and XCR0
+	__cpuid( info, 1 );
+	const bool hasOsxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+	const bool hasAvx = ( info[2] & ( 1 << 28 ) ) != 0;
+	if( ! hasOsxsave || ! hasAvx || ( _xgetbv( 0 ) & 6 ) != 6 )
+		return false;
+
+	__cpuidex( info, 7, 0 );
+	return ( info[1] & ( 1 << 5 ) ) != 0;
+#else
+	__builtin_cpu_init();
+	return __builtin_cpu_supports( "avx2" ) != 0;
+#endif
+}
+
+CI_DSP_TARGET_AVX2 inline __m128 horizontalFold( __m256 v )
+{
+	return _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+}
+
+CI_DSP_TARGET_AVX2 void fillAvx2( float value, float *array, size_t length )
+{
+	const __m256 v = _mm256_set1_ps( value );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( array + i, v );
+
+	fillScalar( value, array + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void addScalarAvx2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m256 s = _mm256_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_add_ps( _mm256_loadu_ps( array + i ), s ) );
+
+	addScalarScalar( array + i, scalar, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void addAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_add_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+
+	addScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void subAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_sub_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+
+	subScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void mulScalarAvx2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m256 s = _mm256_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_mul_ps( _mm256_loadu_ps( array + i ), s ) );
+
+	mulScalarScalar( array + i, scalar, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void mulAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_mul_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+
+	mulScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void divideAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_div_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+
+	divideScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 void addMulAvx2( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	// not fused, so that results match the other back-ends exactly
+	const __m256 s = _mm256_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_mul_ps( _mm256_add_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ), s ) );
+
+	addMulScalar( arrayA + i, arrayB + i, scalar, result + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 float sumAvx2( const float *array, size_t length )
+{
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 16 <= length; i += 16 ) {
+		acc0 = _mm256_add_ps( acc0, _mm256_loadu_ps( array + i ) );
+		acc1 = _mm256_add_ps( acc1, _mm256_loadu_ps( array + i + 8 ) );
+	}
+
+	return horizontalSum( horizontalFold( _mm256_add_ps( acc0, acc1 ) ) ) + sumScalar( array + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 float sumOfSquaresAvx2( const float *array, size_t length )
+{
+	__m256 acc0 = _mm256_setzero_ps(), acc1 = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 16 <= length; i += 16 ) {
+		__m256 v0 = _mm256_loadu_ps( array + i );
+		__m256 v1 = _mm256_loadu_ps( array + i + 8 );
+		acc0 = _mm256_add_ps( acc0, _mm256_mul_ps( v0, v0 ) );
+		acc1 = _mm256_add_ps( acc1, _mm256_mul_ps( v1, v1 ) );
 	}
 
-	return math<float>::sqrt( sumSquared / (float)length );
+	return horizontalSum( horizontalFold( _mm256_add_ps( acc0, acc1 ) ) ) + sumOfSquaresScalar( array + i, length - i );
+}
+
+CI_DSP_TARGET_AVX2 float maxAvx2( const float *array, size_t length )
+{
+	__m256 acc = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		acc = _mm256_max_ps( acc, _mm256_loadu_ps( array + i ) );
+
+	const __m128 folded = _mm_max_ps( _mm256_castps256_ps128( acc ), _mm256_extractf128_ps( acc, 1 ) );
+	return std::max( horizontalMax( folded ), maxScalar( array + i, length - i ) );
+}
+
+#endif // defined( CINDER_AUDIO_DSP_AVX2 )
+
+// ----------------------------------------------------------------------------------------------------
+// NEON kernels
+// ----------------------------------------------------------------------------------------------------
+
+#if defined( CINDER_SIMD_NEON )
+
+inline float horizontalSum( float32x4_t v )
+{
+	float32x2_t sums = vadd_f32( vget_low_f32( v ), vget_high_f32( v ) );
+	return vget_lane_f32( vpadd_f32( sums, sums ), 0 );
+}
+
+inline float horizontalMax( float32x4_t v )
+{
+	float32x2_t maxs = vmax_f32( vget_low_f32( v ), vget_high_f32( v ) );
+	return vget_lane_f32( vpmax_f32( maxs, maxs ), 0 );
+}
+
+void fillNeon( float value, float *array, size_t length )
+{
+	const float32x4_t v = vdupq_n_f32( value );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( array + i, v );
+
+	fillScalar( value, array + i, length - i );
+}
+
+void addScalarNeon( const float *array, float scalar, float *result, size_t length )
+{
+	const float32x4_t s = vdupq_n_f32( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vaddq_f32( vld1q_f32( array + i ), s ) );
+
+	addScalarScalar( array + i, scalar, result + i, length - i );
+}
+
+void addNeon( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vaddq_f32( vld1q_f32( arrayA + i ), vld1q_f32( arrayB + i ) ) );
+
+	addScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void subNeon( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vsubq_f32( vld1q_f32( arrayA + i ), vld1q_f32( arrayB + i ) ) );
+
+	subScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void mulScalarNeon( const float *array, float scalar, float *result, size_t length )
+{
+	const float32x4_t s = vdupq_n_f32( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vmulq_f32( vld1q_f32( array + i ), s ) );
+
+	mulScalarScalar( array + i, scalar, result + i, length - i );
+}
+
+void mulNeon( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vmulq_f32( vld1q_f32( arrayA + i ), vld1q_f32( arrayB + i ) ) );
+
+	mulScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+#if defined( __aarch64__ ) || defined( _M_ARM64 )
+void divideNeon( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vdivq_f32( vld1q_f32( arrayA + i ), vld1q_f32( arrayB + i ) ) );
+
+	divideScalar( arrayA + i, arrayB + i, result + i, length - i );
+}
+#else
+// ARMv7 NEON only has a reciprocal estimate, which would not match the other back-ends
+void divideNeon( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	divideScalar( arrayA, arrayB, result, length );
+}
+#endif
+
+void addMulNeon( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	const float32x4_t s = vdupq_n_f32( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		vst1q_f32( result + i, vmulq_f32( vaddq_f32( vld1q_f32( arrayA + i ), vld1q_f32( arrayB + i ) ), s ) );
+
+	addMulScalar( arrayA + i, arrayB + i, scalar, result + i, length - i );
+}
+
+float sumNeon( const float *array, size_t length )
+{
+	float32x4_t acc0 = vdupq_n_f32( 0 ), acc1 = vdupq_n_f32( 0 );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		acc0 = vaddq_f32( acc0, vld1q_f32( array + i ) );
+		acc1 = vaddq_f32( acc1, vld1q_f32( array + i + 4 ) );
+	}
+
+	return horizontalSum( vaddq_f32( acc0, acc1 ) ) + sumScalar( array + i, length - i );
+}
+
+float sumOfSquaresNeon( const float *array, size_t length )
+{
+	float32x4_t acc0 = vdupq_n_f32( 0 ), acc1 = vdupq_n_f32( 0 );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		float32x4_t v0 = vld1q_f32( array + i );
+		float32x4_t v1 = vld1q_f32( array + i + 4 );
+		acc0 = vaddq_f32( acc0, vmulq_f32( v0, v0 ) );
+		acc1 = vaddq_f32( acc1, vmulq_f32( v1, v1 ) );
+	}
+
+	return horizontalSum( vaddq_f32( acc0, acc1 ) ) + sumOfSquaresScalar( array + i, length - i );
+}
+
+float maxNeon( const float *array, size_t length )
+{
+	float32x4_t acc = vdupq_n_f32( 0 );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		acc = vmaxq_f32( acc, vld1q_f32( array + i ) );
+
+	return std::max( horizontalMax( acc ), maxScalar( array + i, length - i ) );
+}
+
+#endif // defined( CINDER_SIMD_NEON )
+
+// ----------------------------------------------------------------------------------------------------
+// Runtime dispatch
+// ----------------------------------------------------------------------------------------------------
+
+struct VectorFunctions {
+	SimdBackend		mBackend;
+	void			(*mFill)( float, float *, size_t );
+	void			(*mAddScalar)( const float *, float, float *, size_t );
+	void			(*mAdd)( const float *, const float *, float *, size_t );
+	void			(*mSub)( const float *, const float *, float *, size_t );
+	void			(*mMulScalar)( const float *, float, float *, size_t );
+	void			(*mMul)( const float *, const float *, float *, size_t );
+	void			(*mDivide)( const float *, const float *, float *, size_t );
+	void			(*mAddMul)( const float *, const float *, float, float *, size_t );
+	float			(*mSum)( const float *, size_t );
+	float			(*mSumOfSquares)( const float *, size_t );
+	float			(*mMax)( const float *, size_t );
+};
+
+const VectorFunctions sScalarFunctions = {
+	SimdBackend::SCALAR, fillScalar, addScalarScalar, addScalar, subScalar, mulScalarScalar, mulScalar, divideScalar, addMulScalar, sumScalar, sumOfSquaresScalar, maxScalar
+};
+
+#if defined( CINDER_SIMD_SSE2 )
+const VectorFunctions sSse2Functions = {
+	SimdBackend::SSE2, fillSse2, addScalarSse2, addSse2, subSse2, mulScalarSse2, mulSse2, divideSse2, addMulSse2, sumSse2, sumOfSquaresSse2, maxSse2
+};
+#endif
+
+#if defined( CINDER_AUDIO_DSP_AVX2 )
+const VectorFunctions sAvx2Functions = {
+	SimdBackend::AVX2, fillAvx2, addScalarAvx2, addAvx2, subAvx2, mulScalarAvx2, mulAvx2, divideAvx2, addMulAvx2, sumAvx2, sumOfSquaresAvx2, maxAvx2
+};
+#endif
+
+#if defined( CINDER_SIMD_NEON )
+const VectorFunctions sNeonFunctions = {
+	SimdBackend::NEON, fillNeon, addScalarNeon, addNeon, subNeon, mulScalarNeon, mulNeon, divideNeon, addMulNeon, sumNeon, sumOfSquaresNeon, maxNeon
+};
+#endif
+
+const VectorFunctions* getFunctionsForBackend( SimdBackend backend )
+{
+	switch( backend ) {
+		case SimdBackend::SCALAR:
+			return &sScalarFunctions;
+#if defined( CINDER_SIMD_SSE2 )
+		case SimdBackend::SSE2:
+			return &sSse2Functions;
+#endif
+#if defined( CINDER_AUDIO_DSP_AVX2 )
+		case SimdBackend::AVX2: {
+			static const bool supported = cpuSupportsAvx2();
+			return supported ? &sAvx2Functions : nullptr;
+		}
+#endif
+#if defined( CINDER_SIMD_NEON )
+		case SimdBackend::NEON:
+			return &sNeonFunctions;
+#endif
+		default:
+			return nullptr;
+	}
+}
+
+// Selected on first use. Every table is constant, so a racing first use from two threads selects the same one.
+std::atomic<const VectorFunctions *> sFunctions( nullptr );
+
+inline const VectorFunctions* functions()
+{
+	const VectorFunctions *result = sFunctions.load( std::memory_order_relaxed );
+	if( ! result ) {
+		for( SimdBackend backend : { SimdBackend::AVX2, SimdBackend::SSE2, SimdBackend::NEON, SimdBackend::SCALAR } ) {
+			result = getFunctionsForBackend( backend );
+			if( result )
+				break;
+		}
+
+		sFunctions.store( result, std::memory_order_relaxed );
+	}
+
+	return result;
+}
+
+} // anonymous namespace
+
+SimdBackend getSimdBackend()
+{
+	return functions()->mBackend;
+}
+
+bool isSimdBackendSupported( SimdBackend backend )
+{
+	return getFunctionsForBackend( backend ) != nullptr;
+}
+
+bool setSimdBackend( SimdBackend backend )
+{
+	const VectorFunctions *result = getFunctionsForBackend( backend );
+	if( ! result )
+		return false;
+
+	sFunctions.store( result, std::memory_order_relaxed );
+	return true;
+}
+
+void fill( float value, float *array, size_t length )
+{
+	functions()->mFill( value, array, length );
+}
+
+float sum( const float *array, size_t length )
+{
+	return functions()->mSum( array, length );
+}
+
+void add( const float *array, float scalar, float *result, size_t length )
+{
+	functions()->mAddScalar( array, scalar, result, length );
+}
+
+void add( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	functions()->mAdd( arrayA, arrayB, result, length );
+}
+
+void sub( const float *array, float scalar, float *result, size_t length )
+{
+	// x + (-s) is exactly x - s
+	functions()->mAddScalar( array, - scalar, result, length );
+}
+
+void sub( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	functions()->mSub( arrayA, arrayB, result, length );
+}
+
+float rms( const float *array, size_t length )
+{
+	return math<float>::sqrt( functions()->mSumOfSquares( array, length ) / (float)length );
 }
 
 void mul( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] * scalar;
+	functions()->mMulScalar( array, scalar, result, length );
 }
 
 void mul( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] * arrayB[i];
+	functions()->mMul( arrayA, arrayB, result, length );
 }
 
 void divide( const float *array, float scalar, float *result, size_t length )
@@ -234,28 +871,39 @@ void divide( const float *array, float scalar, float *result, size_t length )
 
 void divide( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] / arrayB[i];
+	functions()->mDivide( arrayA, arrayB, result, length );
 }
 
 void addMul( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+	functions()->mAddMul( arrayA, arrayB, scalar, result, length );
+}
+
+static float maxValue( const float *array, size_t length )
+{
+	return functions()->mMax( array, length );
 }
 
 #endif // ! defined( CINDER_AUDIO_VDSP )
 
-void normalize( float *array, size_t length, float maxValue )
+const char* getSimdBackendName( SimdBackend backend )
 {
-	float max = 0;
-	for( size_t i = 0; i < length; i++ ) {
-		if( max < array[i] )
-			max = array[i];
+	switch( backend ) {
+		case SimdBackend::SCALAR:	return "scalar";
+		case SimdBackend::SSE2:		return "SSE2";
+		case SimdBackend::AVX2:		return "AVX2";
+		case SimdBackend::NEON:		return "NEON";
+		case SimdBackend::VDSP:		return "vDSP";
+		default:					return "unknown";
 	}
+}
+
+void normalize( float *array, size_t length, float normalizedMax )
+{
+	float max = dsp::maxValue( array, length );
 
 	if( max > 0.00001f ) {
-		mul( array, maxValue / max, array, length );
+		mul( array, normalizedMax / max, array, length );
 	}
 }
 
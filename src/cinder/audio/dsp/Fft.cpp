@@ -26,12 +26,38 @@
 #include "cinder/audio/Exception.h"
 #include "cinder/CinderMath.h"
 
+#include <map>
+#include <mutex>
+
 #if defined( CINDER_AUDIO_FFT_OOURA )
 	#include "cinder/audio/dsp/ooura/fftsg.h"
+
+	#if defined( CINDER_SIMD_SSE2 )
+		#include <emmintrin.h>
+	#elif defined( CINDER_SIMD_NEON )
+		#include <arm_neon.h>
+	#endif
 #endif
 
 namespace cinder { namespace audio { namespace dsp {
 
+namespace {
+
+template <typename PlanT>
+struct PlanCache {
+	std::mutex									mMutex;
+	std::map<size_t, std::shared_ptr<const PlanT>>	mPlans;
+};
+
+template <typename PlanT>
+PlanCache<PlanT>& getPlanCache()
+{
+	static PlanCache<PlanT> sCache;
+	return sCache;
+}
+
+} // anonymous namespace
+
 Fft::Fft( size_t fftSize )
 : mSize( fftSize )
 {
@@ -39,72 +65,598 @@ Fft::Fft( size_t fftSize )
 		throw AudioExc( "invalid fft size" );
 
 	mSizeOverTwo = mSize / 2;
+	mPlan = getPlan( mSize );
 
 	init();
 }
 
+std::shared_ptr<const Fft::Plan> Fft::getPlan( size_t fftSize )
+{
+	auto &cache = getPlanCache<Plan>();
+	std::lock_guard<std::mutex> lock( cache.mMutex );
+
+	auto &plan = cache.mPlans[fftSize];
+	if( ! plan )
+		plan = std::make_shared<const Plan>( fftSize );
+
+	return plan;
+}
+
+size_t Fft::getNumCachedPlans()
+{
+	auto &cache = getPlanCache<Plan>();
+	std::lock_guard<std::mutex> lock( cache.mMutex );
+
+	return cache.mPlans.size();
+}
+
+void Fft::clearPlanCache()
+{
+	auto &cache = getPlanCache<Plan>();
+	std::lock_guard<std::mutex> lock( cache.mMutex );
+
+	for( auto it = cache.mPlans.begin(); it != cache.mPlans.end(); ) {
+		if( it->second.use_count() == 1 )
+			it = cache.mPlans.erase( it );
+		else
+			++it;
+	}
+}
+
+void Fft::forwardBatch( const Buffer &waveforms, BufferSpectral *spectra )
+{
+	CI_ASSERT( waveforms.getNumFrames() == mSize );
+
+	mBatchWaveforms.resize( waveforms.getNumChannels() );
+	for( size_t ch = 0; ch < waveforms.getNumChannels(); ch++ )
+		mBatchWaveforms[ch] = const_cast<float *>( waveforms.getChannel( ch ) );
+
+	forwardBatch( mBatchWaveforms.data(), spectra, mBatchWaveforms.size() );
+}
+
+void Fft::inverseBatch( const BufferSpectral *spectra, Buffer *waveforms )
+{
+	CI_ASSERT( waveforms->getNumFrames() == mSize );
+
+	mBatchWaveforms.resize( waveforms->getNumChannels() );
+	for( size_t ch = 0; ch < waveforms->getNumChannels(); ch++ )
+		mBatchWaveforms[ch] = waveforms->getChannel( ch );
+
+	inverseBatch( spectra, mBatchWaveforms.data(), mBatchWaveforms.size() );
+}
+
 #if defined( CINDER_AUDIO_VDSP )
 
+struct Fft::Plan {
+	Plan( size_t fftSize )
+		: mLog2FftSize( (size_t)log2f( fftSize ) )
+	{
+		mFftSetup = vDSP_create_fftsetup( mLog2FftSize, FFT_RADIX2 );
+		CI_ASSERT( mFftSetup );
+	}
+
+	~Plan()
+	{
+		vDSP_destroy_fftsetup( mFftSetup );
+	}
+
+	size_t		mLog2FftSize;
+	::FFTSetup	mFftSetup;
+};
+
 void Fft::init()
 {
 	mSplitComplexResult.realp = (float *)malloc( mSizeOverTwo * sizeof( float ) );
 	mSplitComplexResult.imagp = (float *)malloc( mSizeOverTwo * sizeof( float ) );
-
-	mLog2FftSize = log2f( mSize );
-	mFftSetup = vDSP_create_fftsetup( mLog2FftSize, FFT_RADIX2 );
-	CI_ASSERT( mFftSetup );
 }
 
 Fft::~Fft()
 {
 	free( mSplitComplexResult.realp );
 	free( mSplitComplexResult.imagp );
-	vDSP_destroy_fftsetup( mFftSetup );
 }
 
 void Fft::forward( const Buffer *waveform, BufferSpectral *spectral )
 {
 	CI_ASSERT( waveform->getNumFrames() == mSize );
-	CI_ASSERT( spectral->getNumFrames() == mSizeOverTwo );
-
-	mSplitComplexSignal.realp = spectral->getReal();
-	mSplitComplexSignal.imagp = spectral->getImag();
 
-	// in-place transfrom is okay here because we already first copy the data from waveform -> spectral
-	vDSP_ctoz( (::DSPComplex *)waveform->getData(), 2, &mSplitComplexSignal, 1, mSizeOverTwo );
-	vDSP_fft_zrip( mFftSetup, &mSplitComplexSignal, 1, mLog2FftSize, FFT_FORWARD );
+	const float *data = waveform->getData();
+	forwardBatch( &data, spectral, 1 );
 }
 
 void Fft::inverse( const BufferSpectral *spectral, Buffer *waveform )
 {
 	CI_ASSERT( waveform->getNumFrames() == mSize );
-	CI_ASSERT( spectral->getNumFrames() == mSizeOverTwo );
 
-	mSplitComplexSignal.realp = const_cast<float *>( spectral->getReal() );
-	mSplitComplexSignal.imagp = const_cast<float *>( spectral->getImag() );
 	float *data = waveform->getData();
+	inverseBatch( spectral, &data, 1 );
+}
+
+// vDSP already uses the widest vector unit available for a single transform, so batches are transformed one at a time.
+void Fft::forwardBatch( const float * const *waveforms, BufferSpectral *spectra, size_t count )
+{
+	for( size_t i = 0; i < count; i++ ) {
+		CI_ASSERT( spectra[i].getNumFrames() == mSizeOverTwo );
 
-	// use out-of-place transfrom so as to not overwrite spectral
-	vDSP_fft_zrop( mFftSetup, &mSplitComplexSignal, 1, &mSplitComplexResult, 1, mLog2FftSize, FFT_INVERSE );
-	vDSP_ztoc( &mSplitComplexResult, 1, (::DSPComplex *)data, 2, mSizeOverTwo );
+		mSplitComplexSignal.realp = spectra[i].getReal();
+		mSplitComplexSignal.imagp = spectra[i].getImag();
 
-	float scale = 1.0f / float( 2 * mSize );
-	vDSP_vsmul( data, 1, &scale, data, 1, mSize );
+		// in-place transfrom is okay here because we already first copy the data from waveform -> spectral
+		vDSP_ctoz( (const ::DSPComplex *)waveforms[i], 2, &mSplitComplexSignal, 1, mSizeOverTwo );
+		vDSP_fft_zrip( mPlan->mFftSetup, &mSplitComplexSignal, 1, mPlan->mLog2FftSize, FFT_FORWARD );
+	}
+}
+
+void Fft::inverseBatch( const BufferSpectral *spectra, float * const *waveforms, size_t count )
+{
+	const float scale = 1.0f / float( 2 * mSize );
+
+	for( size_t i = 0; i < count; i++ ) {
+		CI_ASSERT( spectra[i].getNumFrames() == mSizeOverTwo );
+
+		mSplitComplexSignal.realp = const_cast<float *>( spectra[i].getReal() );
+		mSplitComplexSignal.imagp = const_cast<float *>( spectra[i].getImag() );
+		float *data = waveforms[i];
+
+		// use out-of-place transfrom so as to not overwrite spectral
+		vDSP_fft_zrop( mPlan->mFftSetup, &mSplitComplexSignal, 1, &mSplitComplexResult, 1, mPlan->mLog2FftSize, FFT_INVERSE );
+		vDSP_ztoc( &mSplitComplexResult, 1, (::DSPComplex *)data, 2, mSizeOverTwo );
+		vDSP_vsmul( data, 1, &scale, data, 1, mSize );
+	}
 }
 
 #elif defined( CINDER_AUDIO_FFT_OOURA )
 
+namespace {
+
+// The batched transforms run the same algorithm on one waveform per vector lane. A real DFT of size N is computed as a
+// complex DFT of size M = N / 2 over z[j] = x[2j] + i x[2j + 1], followed by a pass that separates the spectra of the
+// even and odd samples. The complex DFT is an iterative decimation in time FFT that fuses pairs of radix-2 stages into
+// radix-4 butterflies, halving the number of passes over the data. Work buffers are laid out as [index][lane].
+
+struct ScalarOps {
+	typedef float Vec;
+	static const size_t WIDTH = 1;
+
+	static Vec	load( const float *p )		{ return *p; }
+	static void	store( float *p, Vec v )	{ *p = v; }
+	static Vec	set1( float f )				{ return f; }
+	static Vec	add( Vec a, Vec b )			{ return a + b; }
+	static Vec	sub( Vec a, Vec b )			{ return a - b; }
+	static Vec	mul( Vec a, Vec b )			{ return a * b; }
+	static void	transpose( Vec * /*rows*/ )	{}
+};
+
+#if defined( CINDER_SIMD_SSE2 )
+
+struct Sse2Ops {
+	typedef __m128 Vec;
+	static const size_t WIDTH = 4;
+
+	static Vec	load( const float *p )		{ return _mm_loadu_ps( p ); }
+	static void	store( float *p, Vec v )	{ _mm_storeu_ps( p, v ); }
+	static Vec	set1( float f )				{ return _mm_set1_ps( f ); }
+	static Vec	add( Vec a, Vec b )			{ return _mm_add_ps( a, b ); }
+	static Vec	sub( Vec a, Vec b )			{ return _mm_sub_ps( a, b ); }
+	static Vec	mul( Vec a, Vec b )			{ return _mm_mul_ps( a, b ); }
+	static void	transpose( Vec *rows )		{ _MM_TRANSPOSE4_PS( rows[0], rows[1], rows[2], rows[3] ); }
+};
+
+#elif defined( CINDER_SIMD_NEON )
+
+struct NeonOps {
+	typedef float32x4_t Vec;
+	static const size_t WIDTH = 4;
+
+	static Vec	load( const float *p )		{ return vld1q_f32( p ); }
+	static void	store( float *p, Vec v )	{ vst1q_f32( p, v ); }
+	static Vec	set1( float f )				{ return vdupq_n_f32( f ); }
+	static Vec	add( Vec a, Vec b )			{ return vaddq_f32( a, b ); }
+	static Vec	sub( Vec a, Vec b )			{ return vsubq_f32( a, b ); }
+	static Vec	mul( Vec a, Vec b )			{ return vmulq_f32( a, b ); }
+
+	static void transpose( Vec *rows )
+	{
+		const float32x4x2_t t01 = vtrnq_f32( rows[0], rows[1] );
+		const float32x4x2_t t23 = vtrnq_f32( rows[2], rows[3] );
+		rows[0] = vcombine_f32( vget_low_f32( t01.val[0] ), vget_low_f32( t23.val[0] ) );
+		rows[1] = vcombine_f32( vget_low_f32( t01.val[1] ), vget_low_f32( t23.val[1] ) );
+		rows[2] = vcombine_f32( vget_high_f32( t01.val[0] ), vget_high_f32( t23.val[0] ) );
+		rows[3] = vcombine_f32( vget_high_f32( t01.val[1] ), vget_high_f32( t23.val[1] ) );
+	}
+};
+
+#endif
+
+const size_t MAX_LANES = 4;
+
+// Multiplies (xr, xi) by the twiddle factor (wr, wi), or by its conjugate for the inverse transform.
+template <typename Ops, bool INVERSE>
+inline void twiddle( typename Ops::Vec wr, typename Ops::Vec wi, typename Ops::Vec xr, typename Ops::Vec xi, typename Ops::Vec *yr, typename Ops::Vec *yi )
+{
+	if( INVERSE ) {
+		*yr = Ops::add( Ops::mul( wr, xr ), Ops::mul( wi, xi ) );
+		*yi = Ops::sub( Ops::mul( wr, xi ), Ops::mul( wi, xr ) );
+	}
+	else {
+		*yr = Ops::sub( Ops::mul( wr, xr ), Ops::mul( wi, xi ) );
+		*yi = Ops::add( Ops::mul( wr, xi ), Ops::mul( wi, xr ) );
+	}
+}
+
+// Complex DFT of size m over bit reversed input, producing output in natural order. twiddleReal / twiddleImag
+// hold e^(-2 pi i k / m) for k < m / 2.
+template <typename Ops, bool INVERSE>
+void complexFft( float *re, float *im, size_t m, const float *twiddleReal, const float *twiddleImag )
+{
+	typedef typename Ops::Vec Vec;
+	const size_t W = Ops::WIDTH;
+
+	size_t half = 1;
+
+	// an odd number of radix-2 stages leaves one over, which has no twiddle factors
+	if( m > 1 && ( log2floor( (uint32_t)m ) & 1 ) ) {
+		for( size_t i = 0; i < m; i += 2 ) {
+			float *r0 = re + i * W, *i0 = im + i * W;
+			Vec ar = Ops::load( r0 ), ai = Ops::load( i0 );
+			Vec br = Ops::load( r0 + W ), bi = Ops::load( i0 + W );
+			Ops::store( r0, Ops::add( ar, br ) );
+			Ops::store( i0, Ops::add( ai, bi ) );
+			Ops::store( r0 + W, Ops::sub( ar, br ) );
+			Ops::store( i0 + W, Ops::sub( ai, bi ) );
+		}
+		half = 2;
+	}
+
+	// radix-4 butterflies, each the two radix-2 stages of distance half and 2 * half
+	for( ; half * 4 <= m; half *= 4 ) {
+		const size_t stride1 = m / ( 2 * half );
+		const size_t stride2 = m / ( 4 * half );
+		const size_t offset = half * W;
+
+		// butterflies within a block are adjacent in memory, so each stage is a single pass over the data
+		for( size_t block = 0; block < m; block += 4 * half ) {
+			for( size_t k = 0; k < half; k++ ) {
+				const Vec w1r = Ops::set1( twiddleReal[k * stride1] ), w1i = Ops::set1( twiddleImag[k * stride1] );
+				const Vec w2r = Ops::set1( twiddleReal[k * stride2] ), w2i = Ops::set1( twiddleImag[k * stride2] );
+
+				float *r0 = re + ( block + k ) * W, *i0 = im + ( block + k ) * W;
+				float *r1 = r0 + offset, *i1 = i0 + offset;
+				float *r2 = r1 + offset, *i2 = i1 + offset;
+				float *r3 = r2 + offset, *i3 = i2 + offset;
+
+				// first stage: (0, 1) and (2, 3)
+				Vec tr, ti;
+				twiddle<Ops, INVERSE>( w1r, w1i, Ops::load( r1 ), Ops::load( i1 ), &tr, &ti );
+				Vec x0r = Ops::load( r0 ), x0i = Ops::load( i0 );
+				const Vec y0r = Ops::add( x0r, tr ), y0i = Ops::add( x0i, ti );
+				const Vec y1r = Ops::sub( x0r, tr ), y1i = Ops::sub( x0i, ti );
+
+				twiddle<Ops, INVERSE>( w1r, w1i, Ops::load( r3 ), Ops::load( i3 ), &tr, &ti );
+				Vec x2r = Ops::load( r2 ), x2i = Ops::load( i2 );
+				const Vec y2r = Ops::add( x2r, tr ), y2i = Ops::add( x2i, ti );
+				const Vec y3r = Ops::sub( x2r, tr ), y3i = Ops::sub( x2i, ti );
+
+				// second stage: (0, 2) with w2 and (1, 3) with w2 * e^(-i pi / 2), which is w2 rotated by -i (+i inverse)
+				twiddle<Ops, INVERSE>( w2r, w2i, y2r, y2i, &tr, &ti );
+				Ops::store( r0, Ops::add( y0r, tr ) );
+				Ops::store( i0, Ops::add( y0i, ti ) );
+				Ops::store( r2, Ops::sub( y0r, tr ) );
+				Ops::store( i2, Ops::sub( y0i, ti ) );
+
+				twiddle<Ops, INVERSE>( w2r, w2i, y3r, y3i, &tr, &ti );
+				if( INVERSE ) {
+					Ops::store( r1, Ops::sub( y1r, ti ) );
+					Ops::store( i1, Ops::add( y1i, tr ) );
+					Ops::store( r3, Ops::add( y1r, ti ) );
+					Ops::store( i3, Ops::sub( y1i, tr ) );
+				}
+				else {
+					Ops::store( r1, Ops::add( y1r, ti ) );
+					Ops::store( i1, Ops::sub( y1i, tr ) );
+					Ops::store( r3, Ops::sub( y1r, ti ) );
+					Ops::store( i3, Ops::add( y1i, tr ) );
+				}
+			}
+		}
+	}
+}
+
+struct BatchTables {
+	size_t			mSizeOverTwo;
+	const uint32_t	*mBitReverse;
+	const float		*mTwiddleReal, *mTwiddleImag;	// e^(-2 pi i k / M), k < M / 2
+	const float		*mPostReal, *mPostImag;			// e^(-2 pi i k / N), k <= M / 2
+};
+
+// Transforms up to Ops::WIDTH waveforms, lanes past count are zero filled and discarded.
+template <typename Ops>
+void forwardLanes( const BatchTables &tables, const float * const *waveforms, BufferSpectral *spectra, size_t count, float *re, float *im )
+{
+	typedef typename Ops::Vec Vec;
+	const size_t W = Ops::WIDTH;
+	const size_t m = tables.mSizeOverTwo;
+
+	// Pack the even and odd samples into complex values, in bit reversed order. A full group of 4 lanes transposes
+	// 4 samples (2 complex values) of each waveform at a time, so that both the loads and stores are whole vectors.
+	if( W == 4 && count == W && m >= 4 ) {
+		Vec rows[4];
+		for( size_t j = 0; j < m; j += 2 ) {
+			for( size_t lane = 0; lane < W; lane++ )
+				rows[lane] = Ops::load( waveforms[lane] + 2 * j );
+
+			Ops::transpose( rows );
+			Ops::store( re + tables.mBitReverse[j] * W, rows[0] );
+			Ops::store( im + tables.mBitReverse[j] * W, rows[1] );
+			Ops::store( re + tables.mBitReverse[j + 1] * W, rows[2] );
+			Ops::store( im + tables.mBitReverse[j + 1] * W, rows[3] );
+		}
+	}
+	else for( size_t lane = 0; lane < W; lane++ ) {
+		if( lane < count ) {
+			const float *x = waveforms[lane];
+			for( size_t j = 0; j < m; j++ ) {
+				const size_t index = tables.mBitReverse[j] * W + lane;
+				re[index] = x[2 * j];
+				im[index] = x[2 * j + 1];
+			}
+		}
+		else {
+			for( size_t j = 0; j < m; j++ ) {
+				re[j * W + lane] = 0;
+				im[j * W + lane] = 0;
+			}
+		}
+	}
+
+	complexFft<Ops, false>( re, im, m, tables.mTwiddleReal, tables.mTwiddleImag );
+
+	// Separate the spectra of the even (Fe) and odd (Fo) samples from Z[k] and Z[M - k], then X[k] = Fe[k] + w^k Fo[k].
+	// Each pass computes the pair k, M - k in place, where X[M - k] = conj( Fe[k] - w^k Fo[k] ).
+	const Vec half = Ops::set1( 0.5f );
+	for( size_t k = 1; k <= m / 2; k++ ) {
+		float *rk = re + k * W, *ik = im + k * W;
+		float *rj = re + ( m - k ) * W, *ij = im + ( m - k ) * W;
+		const Vec ar = Ops::load( rk ), ai = Ops::load( ik );
+		const Vec br = Ops::load( rj ), bi = Ops::load( ij );
+
+		const Vec per = Ops::mul( half, Ops::add( ar, br ) );
+		const Vec pei = Ops::mul( half, Ops::sub( ai, bi ) );
+		const Vec por = Ops::mul( half, Ops::add( ai, bi ) );
+		const Vec poi = Ops::mul( half, Ops::sub( br, ar ) );
+
+		Vec qr, qi;
+		twiddle<Ops, false>( Ops::set1( tables.mPostReal[k] ), Ops::set1( tables.mPostImag[k] ), por, poi, &qr, &qi );
+
+		// stored with the same sign convention as ooura's rdft, imag = -Im( X )
+		Ops::store( rj, Ops::sub( per, qr ) );
+		Ops::store( ij, Ops::sub( pei, qi ) );
+		Ops::store( rk, Ops::add( per, qr ) );
+		Ops::store( ik, Ops::sub( Ops::set1( 0 ), Ops::add( pei, qi ) ) );
+	}
+
+	// DC and nyquist are both real, nyquist is packed into imag[0]
+	{
+		const Vec ar = Ops::load( re ), ai = Ops::load( im );
+		Ops::store( re, Ops::add( ar, ai ) );
+		Ops::store( im, Ops::sub( ar, ai ) );
+	}
+
+	if( W == 4 && count == W && m >= 4 ) {
+		Vec rows[4];
+		for( size_t k = 0; k < m; k += 4 ) {
+			for( size_t i = 0; i < 4; i++ )
+				rows[i] = Ops::load( re + ( k + i ) * W );
+			Ops::transpose( rows );
+			for( size_t lane = 0; lane < W; lane++ )
+				Ops::store( spectra[lane].getReal() + k, rows[lane] );
+
+			for( size_t i = 0; i < 4; i++ )
+				rows[i] = Ops::load( im + ( k + i ) * W );
+			Ops::transpose( rows );
+			for( size_t lane = 0; lane < W; lane++ )
+				Ops::store( spectra[lane].getImag() + k, rows[lane] );
+		}
+	}
+	else for( size_t lane = 0; lane < count; lane++ ) {
+		float *real = spectra[lane].getReal();
+		float *imag = spectra[lane].getImag();
+		for( size_t k = 0; k < m; k++ ) {
+			real[k] = re[k * W + lane];
+			imag[k] = im[k * W + lane];
+		}
+	}
+}
+
+// Inverse of forwardLanes(): rebuilds Z[k] = Fe[k] + i Fo[k] from X, then runs the inverse complex DFT.
+template <typename Ops>
+void inverseLanes( const BatchTables &tables, const BufferSpectral *spectra, float * const *waveforms, size_t count, float *re, float *im )
+{
+	typedef typename Ops::Vec Vec;
+	const size_t W = Ops::WIDTH;
+	const size_t m = tables.mSizeOverTwo;
+
+	if( W == 4 && count == W && m >= 4 ) {
+		Vec rows[4];
+		for( size_t k = 0; k < m; k += 4 ) {
+			for( size_t lane = 0; lane < W; lane++ )
+				rows[lane] = Ops::load( spectra[lane].getReal() + k );
+			Ops::transpose( rows );
+			for( size_t i = 0; i < 4; i++ )
+				Ops::store( re + ( k + i ) * W, rows[i] );
+
+			for( size_t lane = 0; lane < W; lane++ )
+				rows[lane] = Ops::load( spectra[lane].getImag() + k );
+			Ops::transpose( rows );
+			for( size_t i = 0; i < 4; i++ )
+				Ops::store( im + ( k + i ) * W, rows[i] );
+		}
+	}
+	else for( size_t lane = 0; lane < W; lane++ ) {
+		if( lane < count ) {
+			const float *real = spectra[lane].getReal();
+			const float *imag = spectra[lane].getImag();
+			for( size_t k = 0; k < m; k++ ) {
+				re[k * W + lane] = real[k];
+				im[k * W + lane] = imag[k];
+			}
+		}
+		else {
+			for( size_t k = 0; k < m; k++ ) {
+				re[k * W + lane] = 0;
+				im[k * W + lane] = 0;
+			}
+		}
+	}
+
+	const Vec half = Ops::set1( 0.5f );
+
+	// X[0] is in re[0] and X[M] in im[0]
+	{
+		const Vec dc = Ops::load( re ), nyquist = Ops::load( im );
+		Ops::store( re, Ops::mul( half, Ops::add( dc, nyquist ) ) );
+		Ops::store( im, Ops::mul( half, Ops::sub( dc, nyquist ) ) );
+	}
+
+	// im holds -Im( X ). Fe[k] = ( X[k] + conj( X[M - k] ) ) / 2, Fo[k] = ( X[k] - conj( X[M - k] ) ) / 2 * conj( w^k ),
+	// and the pair M - k uses their conjugates.
+	for( size_t k = 1; k <= m / 2; k++ ) {
+		float *rk = re + k * W, *ik = im + k * W;
+		float *rj = re + ( m - k ) * W, *ij = im + ( m - k ) * W;
+		const Vec ar = Ops::load( rk ), ai = Ops::load( ik );
+		const Vec br = Ops::load( rj ), bi = Ops::load( ij );
+
+		const Vec fer = Ops::mul( half, Ops::add( ar, br ) );
+		const Vec fei = Ops::mul( half, Ops::sub( bi, ai ) );
+		const Vec dr = Ops::mul( half, Ops::sub( ar, br ) );
+		const Vec di = Ops::sub( Ops::set1( 0 ), Ops::mul( half, Ops::add( ai, bi ) ) );
+
+		Vec fr, fi;
+		twiddle<Ops, true>( Ops::set1( tables.mPostReal[k] ), Ops::set1( tables.mPostImag[k] ), dr, di, &fr, &fi );
+
+		Ops::store( rj, Ops::add( fer, fi ) );
+		Ops::store( ij, Ops::sub( fr, fei ) );
+		Ops::store( rk, Ops::sub( fer, fi ) );
+		Ops::store( ik, Ops::add( fei, fr ) );
+	}
+
+	// bit reverse in place, swapping whole lane vectors
+	for( size_t j = 0; j < m; j++ ) {
+		const size_t r = tables.mBitReverse[j];
+		if( j < r ) {
+			for( size_t lane = 0; lane < W; lane++ ) {
+				std::swap( re[j * W + lane], re[r * W + lane] );
+				std::swap( im[j * W + lane], im[r * W + lane] );
+			}
+		}
+	}
+
+	complexFft<Ops, true>( re, im, m, tables.mTwiddleReal, tables.mTwiddleImag );
+
+	const float scale = 1.0f / float( m );
+	if( W == 4 && count == W && m >= 4 ) {
+		const Vec scaleVec = Ops::set1( scale );
+		Vec rows[4];
+		for( size_t j = 0; j < m; j += 2 ) {
+			rows[0] = Ops::mul( Ops::load( re + j * W ), scaleVec );
+			rows[1] = Ops::mul( Ops::load( im + j * W ), scaleVec );
+			rows[2] = Ops::mul( Ops::load( re + ( j + 1 ) * W ), scaleVec );
+			rows[3] = Ops::mul( Ops::load( im + ( j + 1 ) * W ), scaleVec );
+			Ops::transpose( rows );
+			for( size_t lane = 0; lane < W; lane++ )
+				Ops::store( waveforms[lane] + 2 * j, rows[lane] );
+		}
+	}
+	else for( size_t lane = 0; lane < count; lane++ ) {
+		float *x = waveforms[lane];
+		for( size_t j = 0; j < m; j++ ) {
+			x[2 * j] = re[j * W + lane] * scale;
+			x[2 * j + 1] = im[j * W + lane] * scale;
+		}
+	}
+}
+
+typedef void (*ForwardLanesFn)( const BatchTables &, const float * const *, BufferSpectral *, size_t, float *, float * );
+typedef void (*InverseLanesFn)( const BatchTables &, const BufferSpectral *, float * const *, size_t, float *, float * );
+
+// AVX2 uses the 4 lane kernels, the extra width doesn't pay for itself with the scattered loads and stores.
+bool useVectorLanes()
+{
+	switch( getSimdBackend() ) {
+		case SimdBackend::SSE2:
+		case SimdBackend::AVX2:
+		case SimdBackend::NEON:
+		case SimdBackend::VDSP:
+			return true;
+		default:
+			return false;
+	}
+}
+
+} // anonymous namespace
+
+struct Fft::Plan {
+	Plan( size_t fftSize )
+	{
+		const size_t sizeOverTwo = fftSize / 2;
+
+		// rdft() fills in its tables on the first call and only reads them after that, so they can be shared
+		mOouraIp.resize( 2 + (size_t)sqrt( sizeOverTwo ) );
+		mOouraW.resize( sizeOverTwo );
+		std::vector<float> scratch( fftSize );
+		ooura::rdft( (int)fftSize, 1, scratch.data(), mOouraIp.data(), mOouraW.data() );
+
+		const uint32_t numBits = log2floor( (uint32_t)sizeOverTwo );
+		mBitReverse.resize( sizeOverTwo );
+		for( uint32_t j = 0; j < sizeOverTwo; j++ ) {
+			uint32_t reversed = 0;
+			for( uint32_t bit = 0; bit < numBits; bit++ )
+				reversed |= ( ( j >> bit ) & 1 ) << ( numBits - 1 - bit );
+			mBitReverse[j] = reversed;
+		}
+
+		mTwiddleReal.resize( sizeOverTwo / 2 + 1 );
+		mTwiddleImag.resize( sizeOverTwo / 2 + 1 );
+		for( size_t k = 0; k < mTwiddleReal.size(); k++ ) {
+			double theta = 2 * M_PI * k / sizeOverTwo;
+			mTwiddleReal[k] = (float)cos( theta );
+			mTwiddleImag[k] = (float)-sin( theta );
+		}
+
+		mPostReal.resize( sizeOverTwo / 2 + 1 );
+		mPostImag.resize( sizeOverTwo / 2 + 1 );
+		for( size_t k = 0; k < mPostReal.size(); k++ ) {
+			double theta = 2 * M_PI * k / fftSize;
+			mPostReal[k] = (float)cos( theta );
+			mPostImag[k] = (float)-sin( theta );
+		}
+
+		mTables.mSizeOverTwo = sizeOverTwo;
+		mTables.mBitReverse = mBitReverse.data();
+		mTables.mTwiddleReal = mTwiddleReal.data();
+		mTables.mTwiddleImag = mTwiddleImag.data();
+		mTables.mPostReal = mPostReal.data();
+		mTables.mPostImag = mPostImag.data();
+	}
+
+	// rdft() takes non-const pointers, though it doesn't write to primed tables
+	int*	getOouraIp() const	{ return const_cast<int *>( mOouraIp.data() ); }
+	float*	getOouraW() const	{ return const_cast<float *>( mOouraW.data() ); }
+
+	std::vector<int>		mOouraIp;
+	std::vector<float>		mOouraW;
+	std::vector<uint32_t>	mBitReverse;
+	std::vector<float>		mTwiddleReal, mTwiddleImag, mPostReal, mPostImag;
+	BatchTables				mTables;
+};
+
 void Fft::init()
 {
-	mOouraIp = (int *)calloc( 2 + (int)sqrt( mSizeOverTwo ), sizeof( int ) );
-	mOouraW = (float *)calloc( mSizeOverTwo, sizeof( float ) );
 	mBufferCopy = Buffer( mSize );
 }
 
 Fft::~Fft()
 {
-	free( mOouraIp );
-	free( mOouraW );
 }
 
 void Fft::forward( const Buffer *waveform, BufferSpectral *spectral )
@@ -118,7 +670,7 @@ void Fft::forward( const Buffer *waveform, BufferSpectral *spectral )
 	float *real = spectral->getReal();
 	float *imag = spectral->getImag();
 
-	ooura::rdft( (int)mSize, 1, a, mOouraIp, mOouraW );
+	ooura::rdft( (int)mSize, 1, a, mPlan->getOouraIp(), mPlan->getOouraW() );
 
 	real[0] = a[0];
 	imag[0] = a[1];
@@ -134,7 +686,8 @@ void Fft::inverse( const BufferSpectral *spectral, Buffer *waveform )
 	CI_ASSERT( waveform->getNumFrames() == mSize );
 	CI_ASSERT( spectral->getNumFrames() == mSizeOverTwo );
 
-	mBufferCopy.copy( *spectral );
+	// BufferT::copy() would only copy the first channel, real and imaginary parts are both needed
+	memcpy( mBufferCopy.getData(), spectral->getData(), mSize * sizeof( float ) );
 
 	float *real = mBufferCopy.getData();
 	float *imag = &mBufferCopy.getData()[mSizeOverTwo];
@@ -148,10 +701,64 @@ void Fft::inverse( const BufferSpectral *spectral, Buffer *waveform )
 		a[k * 2 + 1] = imag[k];
 	}
 
-	ooura::rdft( (int)mSize, -1, a, mOouraIp, mOouraW );
+	ooura::rdft( (int)mSize, -1, a, mPlan->getOouraIp(), mPlan->getOouraW() );
 	dsp::mul( a, 2.0f / (float)mSize, a, mSize );
 }
 
+void Fft::forwardBatch( const float * const *waveforms, BufferSpectral *spectra, size_t count )
+{
+	ForwardLanesFn fn = forwardLanes<ScalarOps>;
+	size_t width = 1;
+#if defined( CINDER_SIMD_SSE2 )
+	if( useVectorLanes() ) {
+		fn = forwardLanes<Sse2Ops>;
+		width = Sse2Ops::WIDTH;
+	}
+#elif defined( CINDER_SIMD_NEON )
+	if( useVectorLanes() ) {
+		fn = forwardLanes<NeonOps>;
+		width = NeonOps::WIDTH;
+	}
+#endif
+
+	mBatchReal.resize( mSizeOverTwo * MAX_LANES );
+	mBatchImag.resize( mSizeOverTwo * MAX_LANES );
+
+	for( size_t i = 0; i < count; i += width ) {
+		for( size_t lane = i; lane < i + width && lane < count; lane++ )
+			CI_ASSERT( spectra[lane].getNumFrames() == mSizeOverTwo );
+
+		fn( mPlan->mTables, waveforms + i, spectra + i, std::min( width, count - i ), mBatchReal.data(), mBatchImag.data() );
+	}
+}
+
+void Fft::inverseBatch( const BufferSpectral *spectra, float * const *waveforms, size_t count )
+{
+	InverseLanesFn fn = inverseLanes<ScalarOps>;
+	size_t width = 1;
+#if defined( CINDER_SIMD_SSE2 )
+	if( useVectorLanes() ) {
+		fn = inverseLanes<Sse2Ops>;
+		width = Sse2Ops::WIDTH;
+	}
+#elif defined( CINDER_SIMD_NEON )
+	if( useVectorLanes() ) {
+		fn = inverseLanes<NeonOps>;
+		width = NeonOps::WIDTH;
+	}
+#endif
+
+	mBatchReal.resize( mSizeOverTwo * MAX_LANES );
+	mBatchImag.resize( mSizeOverTwo * MAX_LANES );
+
+	for( size_t i = 0; i < count; i += width ) {
+		for( size_t lane = i; lane < i + width && lane < count; lane++ )
+			CI_ASSERT( spectra[lane].getNumFrames() == mSizeOverTwo );
+
+		fn( mPlan->mTables, spectra + i, waveforms + i, std::min( width, count - i ), mBatchReal.data(), mBatchImag.data() );
+	}
+}
+
 #endif // defined( CINDER_AUDIO_FFT_OOURA )
 
 } } } // namespace cinder::audio::dsp
@@ -0,0 +1,298 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/Batch2d.h"
+#include "cinder/gl/Context.h"
+#include "cinder/gl/Environment.h"
+#include "cinder/gl/GlslProg.h"
+#include "cinder/gl/StreamVbo.h"
+#include "cinder/gl/Texture.h"
+#include "cinder/gl/Vao.h"
+#include "cinder/gl/scoped.h"
+#include "cinder/CinderMath.h"
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <emmintrin.h>
+#elif defined( CINDER_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
+
+namespace cinder { namespace gl {
+
+namespace {
+
+#if defined( CINDER_GL_HAS_FBO_MULTISAMPLING )
+const GLenum FRAMEBUFFER_TARGET = GL_DRAW_FRAMEBUFFER;
+#else
+const GLenum FRAMEBUFFER_TARGET = GL_FRAMEBUFFER;
+#endif
+
+// Writes m * vec4( points[i], 0, 1 ) to result[i]
+void transformPoints( const mat4 &m, const vec2 *points, size_t count, vec4 *result )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128 c0 = _mm_loadu_ps( &m[0][0] );
+	const __m128 c1 = _mm_loadu_ps( &m[1][0] );
+	const __m128 c3 = _mm_loadu_ps( &m[3][0] );
+	for( size_t i = 0; i < count; ++i ) {
+		const __m128 x = _mm_mul_ps( c0, _mm_set1_ps( points[i].x ) );
+		const __m128 y = _mm_mul_ps( c1, _mm_set1_ps( points[i].y ) );
+		_mm_storeu_ps( &result[i].x, _mm_add_ps( _mm_add_ps( x, y ), c3 ) );
+	}
+#elif defined( CINDER_SIMD_NEON )
+	const float32x4_t c0 = vld1q_f32( &m[0][0] );
+	const float32x4_t c1 = vld1q_f32( &m[1][0] );
+	const float32x4_t c3 = vld1q_f32( &m[3][0] );
+	for( size_t i = 0; i < count; ++i )
+		vst1q_f32( &result[i].x, vmlaq_n_f32( vmlaq_n_f32( c3, c0, points[i].x ), c1, points[i].y ) );
+#else
+	for( size_t i = 0; i < count; ++i )
+		result[i] = m[0] * points[i].x + m[1] * points[i].y + m[3];
+#endif
+}
+
+} // anonymous namespace
+
+bool Batch2d::State::operator==( const State &rhs ) const
+{
+	return mGlslProg == rhs.mGlslProg && mPrimitive == rhs.mPrimitive && mTextureTarget == rhs.mTextureTarget && mTextureId == rhs.mTextureId
+		&& mBlend == rhs.mBlend && mBlendSrcRgb == rhs.mBlendSrcRgb && mBlendDstRgb == rhs.mBlendDstRgb && mBlendSrcAlpha == rhs.mBlendSrcAlpha
+		&& mBlendDstAlpha == rhs.mBlendDstAlpha && mFramebuffer == rhs.mFramebuffer && mViewport == rhs.mViewport && mLineWidth == rhs.mLineWidth
+		&& mViewMatrix == rhs.mViewMatrix && mProjectionMatrix == rhs.mProjectionMatrix;
+}
+
+Batch2dRef Batch2d::create()
+{
+	return Batch2dRef( new Batch2d );
+}
+
+Batch2d::Batch2d()
+	: mContext( gl::context() ), mCachedBatchable( false )
+{
+	mVao = Vao::create();
+	mStream = StreamVbo::create( GL_ARRAY_BUFFER );
+}
+
+bool Batch2d::isBatchable( const GlslProg *glsl )
+{
+	// a weak reference, so that a new GlslProg allocated at the address of a released one isn't mistaken for it
+	if( mCachedGlslProg.lock().get() != glsl ) {
+		mCachedGlslProg = glsl->shared_from_this();
+		mCachedBatchable = true;
+		for( const auto &attrib : glsl->getActiveAttributes() ) {
+			const geom::Attrib semantic = attrib.getSemantic();
+			if( semantic != geom::Attrib::POSITION && semantic != geom::Attrib::TEX_COORD_0 && semantic != geom::Attrib::COLOR )
+				mCachedBatchable = false;
+		}
+	}
+
+	return mCachedBatchable;
+}
+
+Batch2d::Vertex* Batch2d::beginVertices( const GlslProg *glsl, GLenum primitive, const TextureBaseRef &texture, size_t numVertices )
+{
+	if( ! glsl || ! isBatchable( glsl ) )
+		return nullptr;
+
+	State state;
+	state.mGlslProg = glsl->shared_from_this();
+	state.mPrimitive = primitive;
+	state.mTextureTarget = texture ? texture->getTarget() : GL_TEXTURE_2D;
+	state.mTextureId = texture ? texture->getId() : mContext->getTextureBinding( GL_TEXTURE_2D, 0 );
+	state.mBlend = mContext->getBoolState( GL_BLEND );
+	mContext->getBlendFuncSeparate( &state.mBlendSrcRgb, &state.mBlendDstRgb, &state.mBlendSrcAlpha, &state.mBlendDstAlpha );
+	state.mFramebuffer = mContext->getFramebuffer( FRAMEBUFFER_TARGET );
+	state.mViewport = mContext->getViewport();
+	state.mViewMatrix = mContext->getViewMatrixStack().back();
+	state.mProjectionMatrix = mContext->getProjectionMatrixStack().back();
+	state.mLineWidth = ( primitive == GL_LINES ) ? mContext->getLineWidth() : 1.0f;
+
+	if( ! mVertices.empty() && ( state != mState || mVertices.size() + numVertices > MAX_VERTICES ) )
+		flush();
+
+	mState = state;
+	if( texture )
+		mTexture = texture;
+
+	const size_t first = mVertices.size();
+	mVertices.resize( first + numVertices );
+	return &mVertices[first];
+}
+
+bool Batch2d::addQuad( const GlslProg *glsl, const TextureBaseRef &texture, const Rectf &r, const vec2 &upperLeftTexCoord, const vec2 &lowerRightTexCoord )
+{
+	Vertex *vertices = beginVertices( glsl, GL_TRIANGLES, texture, 6 );
+	if( ! vertices )
+		return false;
+
+	// the corners in the order of drawSolidRect()'s triangle strip
+	const vec2 corners[4] = { r.getUpperRight(), r.getUpperLeft(), r.getLowerRight(), r.getLowerLeft() };
+	const vec2 texCoords[4] = { vec2( lowerRightTexCoord.x, upperLeftTexCoord.y ), upperLeftTexCoord, lowerRightTexCoord, vec2( upperLeftTexCoord.x, lowerRightTexCoord.y ) };
+	vec4 positions[4];
+	transformPoints( mContext->getModelMatrixStack().back(), corners, 4, positions );
+
+	const ColorAf &currentColor = mContext->getCurrentColor();
+	const vec4 color( currentColor.r, currentColor.g, currentColor.b, currentColor.a );
+	const int indices[6] = { 0, 1, 2, 2, 1, 3 };
+	for( int i = 0; i < 6; ++i ) {
+		vertices[i].mPosition = positions[indices[i]];
+		vertices[i].mTexCoord = texCoords[indices[i]];
+		vertices[i].mColor = color;
+	}
+
+	return true;
+}
+
+bool Batch2d::addSolidRect( const Rectf &r, const vec2 &upperLeftTexCoord, const vec2 &lowerRightTexCoord )
+{
+	return addQuad( mContext->getGlslProg(), nullptr, r, upperLeftTexCoord, lowerRightTexCoord );
+}
+
+bool Batch2d::addTexture( const Texture2dRef &texture, const Rectf &texRect, const Rectf &dstRect )
+{
+	auto &glsl = mContext->getStockShader( ShaderDef().color().texture( texture ) );
+	if( ! addQuad( glsl.get(), texture, dstRect, texRect.getUpperLeft(), texRect.getLowerRight() ) )
+		return false;
+
+	glsl->uniform( "uTex0", 0 );
+	return true;
+}
+
+bool Batch2d::addSolidCircle( const vec2 &center, float radius, int numSegments )
+{
+	if( numSegments <= 0 )
+		numSegments = (int)math<double>::floor( radius * M_PI * 2 );
+	if( numSegments < 3 ) numSegments = 3;
+
+	Vertex *vertices = beginVertices( mContext->getGlslProg(), GL_TRIANGLES, nullptr, numSegments * 3 );
+	if( ! vertices )
+		return false;
+
+	// the center followed by the rim, as in drawSolidCircle()'s triangle fan
+	mPoints.resize( numSegments + 2 );
+	mTransformedPoints.resize( numSegments + 2 );
+	mPoints[0] = vec2( 0 );
+	const float tDelta = 1.0f / numSegments * 2 * (float)M_PI;
+	for( int s = 0; s <= numSegments; s++ )
+		mPoints[s+1] = vec2( math<float>::cos( s * tDelta ), math<float>::sin( s * tDelta ) );
+
+	mat4 m = mContext->getModelMatrixStack().back();
+	m[3] += m[0] * center.x + m[1] * center.y;
+	m[0] *= radius;
+	m[1] *= radius;
+	transformPoints( m, mPoints.data(), mPoints.size(), mTransformedPoints.data() );
+
+	const ColorAf &currentColor = mContext->getCurrentColor();
+	const vec4 color( currentColor.r, currentColor.g, currentColor.b, currentColor.a );
+	for( int s = 0; s < numSegments; s++ ) {
+		const int indices[3] = { 0, s + 1, s + 2 };
+		for( int i = 0; i < 3; ++i ) {
+			vertices->mPosition = mTransformedPoints[indices[i]];
+			vertices->mTexCoord = mPoints[indices[i]] * 0.5f + vec2( 0.5f );
+			vertices->mColor = color;
+			++vertices;
+		}
+	}
+
+	return true;
+}
+
+bool Batch2d::addLine( const vec2 &a, const vec2 &b )
+{
+	Vertex *vertices = beginVertices( mContext->getGlslProg(), GL_LINES, nullptr, 2 );
+	if( ! vertices )
+		return false;
+
+	const vec2 points[2] = { a, b };
+	vec4 positions[2];
+	transformPoints( mContext->getModelMatrixStack().back(), points, 2, positions );
+
+	const ColorAf &currentColor = mContext->getCurrentColor();
+	const vec4 color( currentColor.r, currentColor.g, currentColor.b, currentColor.a );
+	for( int i = 0; i < 2; ++i ) {
+		vertices[i].mPosition = positions[i];
+		vertices[i].mTexCoord = vec2( 0 );
+		vertices[i].mColor = color;
+	}
+
+	return true;
+}
+
+void Batch2d::flush()
+{
+	if( mVertices.empty() )
+		return;
+
+	// moved out before drawing, since Context::drawArrays() flushes any pending vertices; this also releases the GlslProg and texture afterwards
+	const State state = std::move( mState );
+	const GLsizei numVertices = (GLsizei)mVertices.size();
+	const GLintptr offset = mStream->write( mVertices.data(), mVertices.size() * sizeof( Vertex ) );
+	mVertices.clear();
+	const TextureBaseRef texture = std::move( mTexture );
+	mCachedGlslProg.reset();
+
+	ScopedFramebuffer fboScp( FRAMEBUFFER_TARGET, state.mFramebuffer );
+	ScopedViewport viewportScp( state.mViewport.first, state.mViewport.second );
+	ScopedGlslProg glslScp( state.mGlslProg );
+	ScopedTextureBind texBindScp( state.mTextureTarget, state.mTextureId, 0 );
+	ScopedState blendScp( GL_BLEND, state.mBlend );
+	mContext->pushBlendFuncSeparate( state.mBlendSrcRgb, state.mBlendDstRgb, state.mBlendSrcAlpha, state.mBlendDstAlpha );
+	if( state.mPrimitive == GL_LINES )
+		mContext->pushLineWidth( state.mLineWidth );
+
+	// positions are already in world space
+	ScopedModelMatrix modelScp;
+	ScopedViewMatrix viewScp;
+	ScopedProjectionMatrix projectionScp;
+	gl::setModelMatrix( mat4() );
+	gl::setViewMatrix( state.mViewMatrix );
+	gl::setProjectionMatrix( state.mProjectionMatrix );
+
+	ScopedVao vaoScp( mVao );
+	mVao->replacementBindBegin();
+	ScopedBuffer vboScp( mStream->getVbo() );
+	const GLint posLoc = state.mGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
+	if( posLoc >= 0 ) {
+		enableVertexAttribArray( posLoc );
+		vertexAttribPointer( posLoc, 4, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)offset );
+	}
+	const GLint texLoc = state.mGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
+	if( texLoc >= 0 ) {
+		enableVertexAttribArray( texLoc );
+		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)( offset + sizeof( vec4 ) ) );
+	}
+	const GLint colorLoc = state.mGlslProg->getAttribSemanticLocation( geom::Attrib::COLOR );
+	if( colorLoc >= 0 ) {
+		enableVertexAttribArray( colorLoc );
+		vertexAttribPointer( colorLoc, 4, GL_FLOAT, GL_FALSE, sizeof( Vertex ), (const GLvoid*)( offset + sizeof( vec4 ) + sizeof( vec2 ) ) );
+	}
+	mVao->replacementBindEnd();
+
+	mContext->setDefaultShaderVars();
+	mContext->drawArrays( state.mPrimitive, 0, numVertices );
+
+	if( state.mPrimitive == GL_LINES )
+		mContext->popLineWidth();
+	mContext->popBlendFuncSeparate();
+}
+
+} } // namespace cinder::gl
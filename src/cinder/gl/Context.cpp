@@ -26,9 +26,11 @@
 #include "cinder/gl/Shader.h"
 #include "cinder/gl/Vao.h"
 #include "cinder/gl/Vbo.h"
+#include "cinder/gl/StreamVbo.h"
 #include "cinder/gl/TransformFeedbackObj.h"
 #include "cinder/gl/Fbo.h"
 #include "cinder/gl/Batch.h"
+#include "cinder/gl/Batch2d.h"
 #include "cinder/gl/ConstantConversions.h"
 #include "cinder/gl/scoped.h"
 #include "cinder/Log.h"
@@ -57,7 +59,8 @@ namespace cinder { namespace gl {
 #endif
 
 Context::Context( const std::shared_ptr<PlatformData> &platformData )
-	: mPlatformData( platformData ),
+	: mBatch2dDepth( 0 ),
+	mPlatformData( platformData ),
 	mColor( ColorAf::white() ),
 	mObjectTrackingEnabled( platformData->mObjectTracking )
 {
@@ -72,27 +75,21 @@ Context::Context( const std::shared_ptr<PlatformData> &platformData )
 	mDefaultVao->setContext( this );
 	mDefaultVao->bindImpl( NULL );
 
-	mBufferBindingStack[GL_ARRAY_BUFFER] = vector<int>();
 	mBufferBindingStack[GL_ARRAY_BUFFER].push_back( 0 );
-	mBufferBindingStack[GL_ELEMENT_ARRAY_BUFFER] = vector<int>();
 	mBufferBindingStack[GL_ELEMENT_ARRAY_BUFFER].push_back( 0 );
 
-	mRenderbufferBindingStack[GL_RENDERBUFFER] = vector<int>();
-	mRenderbufferBindingStack[GL_RENDERBUFFER].push_back( 0 );
+	mRenderbufferBindingStack.push_back( 0 );
 	 
 	mReadFramebufferStack.push_back( 0 );
 	mDrawFramebufferStack.push_back( 0 );	
 #else
 	mFramebufferStack.push_back( 0 );
 #endif
-	mDefaultArrayVboIdx = 0;
 
 	// initial state for depth mask is enabled
-	mBoolStateStack[GL_DEPTH_WRITEMASK] = vector<GLboolean>();
 	mBoolStateStack[GL_DEPTH_WRITEMASK].push_back( GL_TRUE );
 	
 	// initial state for depth test is disabled
-	mBoolStateStack[GL_DEPTH_TEST] = vector<GLboolean>();
 	mBoolStateStack[GL_DEPTH_TEST].push_back( GL_FALSE );
 	
 	// push default depth function
@@ -228,7 +225,7 @@ void Context::reflectCurrent( Context *context )
 void Context::bindVao( Vao *vao )
 {
 	Vao *prevVao = getVao();
-	if( setStackState( mVaoStack, vao ) ) {
+	if( countStateChange( setStackState( mVaoStack, vao ) ) ) {
 		if( prevVao )
 			prevVao->unbindImpl( this );
 		if( vao )
@@ -239,7 +236,7 @@ void Context::bindVao( Vao *vao )
 void Context::pushVao( Vao *vao )
 {
 	Vao *prevVao = getVao();
-	if( pushStackState( mVaoStack, vao ) ) {
+	if( countStateChange( pushStackState( mVaoStack, vao ) ) ) {
 		if( prevVao )
 			prevVao->unbindImpl( this );
 		if( vao )
@@ -259,7 +256,7 @@ void Context::popVao()
 	if( ! mVaoStack.empty() ) {
 		mVaoStack.pop_back();
 		if( ! mVaoStack.empty() ) {
-			if( prevVao != mVaoStack.back() ) {
+			if( countStateChange( prevVao != mVaoStack.back() ) ) {
 				if( prevVao )
 					prevVao->unbindImpl( this );
 				if( mVaoStack.back() )
@@ -308,13 +305,13 @@ void Context::vaoDeleted( const Vao *vao )
 // Viewport
 void Context::viewport( const std::pair<ivec2, ivec2> &viewport )
 {
-	if( setStackState( mViewportStack, viewport ) )
+	if( countStateChange( setStackState( mViewportStack, viewport ) ) )
 		glViewport( viewport.first.x, viewport.first.y, viewport.second.x, viewport.second.y );
 }
 
 void Context::pushViewport( const std::pair<ivec2, ivec2> &viewport )
 {
-	if( pushStackState( mViewportStack, viewport ) )
+	if( countStateChange( pushStackState( mViewportStack, viewport ) ) )
 		glViewport( viewport.first.x, viewport.first.y, viewport.second.x, viewport.second.y );
 }
 
@@ -327,7 +324,7 @@ void Context::popViewport( bool forceRestore )
 {
 	if( mViewportStack.empty() )
 		CI_LOG_E( "Viewport stack underflow" );
-	else if( popStackState( mViewportStack ) || forceRestore ) {
+	else if( countStateChange( popStackState( mViewportStack ) || forceRestore ) ) {
 		auto viewport = getViewport();
 		glViewport( viewport.first.x, viewport.first.y, viewport.second.x, viewport.second.y );
 	}
@@ -350,13 +347,13 @@ std::pair<ivec2, ivec2> Context::getViewport()
 // Scissor Test
 void Context::setScissor( const std::pair<ivec2, ivec2> &scissor )
 {
-	if( setStackState( mScissorStack, scissor ) )
+	if( countStateChange( setStackState( mScissorStack, scissor ) ) )
 		glScissor( scissor.first.x, scissor.first.y, scissor.second.x, scissor.second.y );
 }
 
 void Context::pushScissor( const std::pair<ivec2, ivec2> &scissor )
 {
-	if( pushStackState( mScissorStack, scissor ) )
+	if( countStateChange( pushStackState( mScissorStack, scissor ) ) )
 		glScissor( scissor.first.x, scissor.first.y, scissor.second.x, scissor.second.y );
 }
 
@@ -369,7 +366,7 @@ void Context::popScissor( bool forceRestore )
 {
 	if( mScissorStack.empty() )
 		CI_LOG_E( "Scissor stack underflow" );
-	else if( popStackState( mScissorStack ) || forceRestore ) {
+	else if( countStateChange( popStackState( mScissorStack ) || forceRestore ) ) {
 		auto scissor = getScissor();
 		glScissor( scissor.first.x, scissor.first.y, scissor.second.x, scissor.second.y );
 	}
@@ -392,14 +389,14 @@ std::pair<ivec2, ivec2> Context::getScissor()
 // Face Culling
 void Context::cullFace( GLenum face )
 {
-	if( setStackState( mCullFaceStack, face ) ) {
+	if( countStateChange( setStackState( mCullFaceStack, face ) ) ) {
 		glCullFace( face );
 	}
 }
 
 void Context::pushCullFace( GLenum face )
 {
-	if( pushStackState( mCullFaceStack, face ) ) {
+	if( countStateChange( pushStackState( mCullFaceStack, face ) ) ) {
 		glCullFace( face );
 	}
 }
@@ -413,7 +410,7 @@ void Context::popCullFace( bool forceRestore )
 {
 	if( mCullFaceStack.empty() )
 		CI_LOG_E( "Cull face stack underflow" );
-	else if( popStackState( mCullFaceStack ) || forceRestore )
+	else if( countStateChange( popStackState( mCullFaceStack ) || forceRestore ) )
 		glCullFace( getCullFace() );
 }
 
@@ -433,14 +430,14 @@ GLenum Context::getCullFace()
 // FrontFace
 void Context::frontFace( GLenum mode )
 {
-	if( setStackState( mFrontFaceStack, mode ) ) {
+	if( countStateChange( setStackState( mFrontFaceStack, mode ) ) ) {
 		glFrontFace( mode );
 	}
 }
 
 void Context::pushFrontFace( GLenum mode )
 {
-	if( pushStackState( mFrontFaceStack, mode ) ) {
+	if( countStateChange( pushStackState( mFrontFaceStack, mode ) ) ) {
 		glFrontFace( mode );
 	}
 }
@@ -454,7 +451,7 @@ void Context::popFrontFace( bool forceRestore )
 {
 	if( mFrontFaceStack.empty() )
 		CI_LOG_E( "Front face stack underflow" );
-	else if( popStackState( mFrontFaceStack ) || forceRestore )
+	else if( countStateChange( popStackState( mFrontFaceStack ) || forceRestore ) )
 		glFrontFace( getFrontFace() );
 }
 
@@ -475,13 +472,13 @@ GLenum Context::getFrontFace()
 #if ! defined( CINDER_GL_ES )
 void Context::logicOp( GLenum mode )
 {
-	if( setStackState( mLogicOpStack, mode ) )
+	if( countStateChange( setStackState( mLogicOpStack, mode ) ) )
 		glLogicOp( mode );
 }
 
 void Context::pushLogicOp( GLenum mode )
 {
-	if( pushStackState( mLogicOpStack, mode ) )
+	if( countStateChange( pushStackState( mLogicOpStack, mode ) ) )
 		glLogicOp( mode );
 }
 
@@ -489,7 +486,7 @@ void Context::popLogicOp( bool forceRefresh )
 {
 	if( mLogicOpStack.empty() )
 		CI_LOG_E( "Logic Op stack underflow" );
-	else if( popStackState( mLogicOpStack ) || forceRefresh )
+	else if( countStateChange( popStackState( mLogicOpStack ) || forceRefresh ) )
 		glLogicOp( getLogicOp() );
 }
 
@@ -511,7 +508,7 @@ GLenum Context::getLogicOp()
 void Context::bindBuffer( GLenum target, GLuint id )
 {
 	GLuint prevValue = getBufferBinding( target );
-	if( prevValue != id ) {
+	if( countStateChange( prevValue != id ) ) {
 		mBufferBindingStack[target].back() = id;
 		if( target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER ) {
 			Vao* vao = getVao();
@@ -540,25 +537,25 @@ void Context::pushBufferBinding( GLenum target )
 void Context::popBufferBinding( GLenum target )
 {
 	GLuint prevValue = getBufferBinding( target );
-	auto cachedIt = mBufferBindingStack.find( target );
-	cachedIt->second.pop_back();
-	if( ! cachedIt->second.empty() && cachedIt->second.back() != prevValue ) {
+	auto &stack = mBufferBindingStack[target];
+	stack.pop_back();
+	if( ! stack.empty() && countStateChange( stack.back() != prevValue ) ) {
 		if( target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER ) {
 			Vao* vao = getVao();
 			if( vao )
-				vao->reflectBindBufferImpl( target, cachedIt->second.back() );
+				vao->reflectBindBufferImpl( target, stack.back() );
 			else
-				glBindBuffer( target, cachedIt->second.back() );
+				glBindBuffer( target, stack.back() );
 		}
 		else
-			glBindBuffer( target, cachedIt->second.back() );
+			glBindBuffer( target, stack.back() );
 	}
 }
 
 GLuint Context::getBufferBinding( GLenum target )
 {
-	auto cachedIt = mBufferBindingStack.find( target );
-	if( (cachedIt == mBufferBindingStack.end()) || ( cachedIt->second.empty() ) || ( cachedIt->second.back() == -1 ) ) {
+	auto &stack = mBufferBindingStack[target];
+	if( stack.empty() || ( stack.back() == -1 ) ) {
 		GLint queriedInt = 0;
 		GLenum targetBinding = BufferObj::getBindingConstantForTarget( target );
 		if( targetBinding > 0 ) {
@@ -567,28 +564,26 @@ GLuint Context::getBufferBinding( GLenum target )
 		else
 			return 0; // warning?
 		
-		if( mBufferBindingStack[target].empty() ) { // bad - empty stack; push twice to allow for the pop later and not lead to an empty stack
-			mBufferBindingStack[target] = vector<GLint>();
-			mBufferBindingStack[target].push_back( queriedInt );
-			mBufferBindingStack[target].push_back( queriedInt );			
+		if( stack.empty() ) { // bad - empty stack; push twice to allow for the pop later and not lead to an empty stack
+			stack.push_back( queriedInt );
+			stack.push_back( queriedInt );
 		}
 		else
-			mBufferBindingStack[target].back() = queriedInt;
+			stack.back() = queriedInt;
 		return (GLuint)queriedInt;
 	}
 	else
-		return (GLuint)cachedIt->second.back();
+		return (GLuint)stack.back();
 }
 
 void Context::reflectBufferBinding( GLenum target, GLuint id )
 {
-	// first time we've met this target; start an empty stack
-	if( mBufferBindingStack.find(target) == mBufferBindingStack.end() ) {
-		mBufferBindingStack[target] = vector<int>();
-		mBufferBindingStack[target].push_back( id );
-	}
-	else if( ! mBufferBindingStack[target].empty() )
-		mBufferBindingStack[target].back() = id;
+	// first time we've met this target; start the stack
+	auto &stack = mBufferBindingStack[target];
+	if( stack.empty() )
+		stack.push_back( id );
+	else
+		stack.back() = id;
 }
 
 void Context::bufferCreated( const BufferObj *buffer )
@@ -606,10 +601,10 @@ void Context::bufferDeleted( const BufferObj *buffer )
 	auto target = buffer->getTarget();
 
 	// if 'id' was bound to 'target', mark 'target's binding as 0
-	auto existingIt = mBufferBindingStack.find( target );
-	if( existingIt != mBufferBindingStack.end() && ! existingIt->second.empty() ) {
-		if( mBufferBindingStack[target].back() == buffer->getId() ) {
-			mBufferBindingStack[target].back() = 0;
+	auto &stack = mBufferBindingStack[target];
+	if( ! stack.empty() ) {
+		if( stack.back() == (GLint)buffer->getId() ) {
+			stack.back() = 0;
 			// alert the currently bound VAO
 			if( target == GL_ARRAY_BUFFER || target == GL_ELEMENT_ARRAY_BUFFER ) {
 				Vao* vao = getVao();
@@ -619,25 +614,23 @@ void Context::bufferDeleted( const BufferObj *buffer )
 		}
 	}
 	else
-		mBufferBindingStack[target].push_back( 0 );
+		stack.push_back( 0 );
 }
 
 void Context::invalidateBufferBindingCache( GLenum target )
 {
-	if( mBufferBindingStack.find(target) == mBufferBindingStack.end() ) {
-		mBufferBindingStack[target] = vector<int>();
-		mBufferBindingStack[target].push_back( -1 );
-	}
-	else if( ! mBufferBindingStack[target].empty() )
-		mBufferBindingStack[target].back() = -1;
+	auto &stack = mBufferBindingStack[target];
+	if( stack.empty() )
+		stack.push_back( -1 );
+	else
+		stack.back() = -1;
 }
 	
 void Context::restoreInvalidatedBufferBinding( GLenum target )
 {
-	if( mBufferBindingStack.find(target) != mBufferBindingStack.end() ) {
-		if( ! mBufferBindingStack[target].empty() )
-			glBindBuffer( target, mBufferBindingStack[target].back() );
-	}
+	auto stack = mBufferBindingStack.find( target );
+	if( stack && ! stack->empty() )
+		glBindBuffer( target, stack->back() );
 }
 
 //////////////////////////////////////////////////////////////////
@@ -645,8 +638,8 @@ void Context::restoreInvalidatedBufferBinding( GLenum target )
 void Context::bindRenderbuffer( GLenum target, GLuint id )
 {
 	GLuint prevValue = getRenderbufferBinding( target );
-	if( prevValue != id ) {
-		mRenderbufferBindingStack[target].back() = id;
+	if( countStateChange( prevValue != id ) ) {
+		mRenderbufferBindingStack.back() = id;
 		glBindRenderbuffer( target, id );
 	}
 }
@@ -660,16 +653,15 @@ void Context::pushRenderbufferBinding( GLenum target, GLuint id )
 void Context::pushRenderbufferBinding( GLenum target )
 {
 	GLuint curValue = getRenderbufferBinding( target );
-	mRenderbufferBindingStack[target].push_back( curValue );
+	mRenderbufferBindingStack.push_back( curValue );
 }
 
 void Context::popRenderbufferBinding( GLenum target )
 {
 	GLuint prevValue = getRenderbufferBinding( target );
-	auto cachedIt = mRenderbufferBindingStack.find( target );
-	cachedIt->second.pop_back();
-	if( ! cachedIt->second.empty() && cachedIt->second.back() != prevValue ) {
-		glBindRenderbuffer( target, cachedIt->second.back() );
+	mRenderbufferBindingStack.pop_back();
+	if( ! mRenderbufferBindingStack.empty() && countStateChange( mRenderbufferBindingStack.back() != prevValue ) ) {
+		glBindRenderbuffer( target, mRenderbufferBindingStack.back() );
 	}
 }
 
@@ -678,36 +670,31 @@ GLuint Context::getRenderbufferBinding( GLenum target )
 	// currently only GL_RENDERBUFFER is legal in GL
 	CI_ASSERT( target == GL_RENDERBUFFER );
 	
-	auto cachedIt = mRenderbufferBindingStack.find( target );
-	if( (cachedIt == mRenderbufferBindingStack.end()) || ( cachedIt->second.empty() ) || ( cachedIt->second.back() == -1 ) ) {
+	if( mRenderbufferBindingStack.empty() || ( mRenderbufferBindingStack.back() == -1 ) ) {
 		GLint queriedInt = 0;
 		glGetIntegerv( GL_RENDERBUFFER_BINDING, &queriedInt );
 		
-		if( mRenderbufferBindingStack[target].empty() ) { // bad - empty stack; push twice to allow for the pop later and not lead to an empty stack
-			mRenderbufferBindingStack[target] = vector<GLint>();
-			mRenderbufferBindingStack[target].push_back( queriedInt );
-			mRenderbufferBindingStack[target].push_back( queriedInt );			
+		if( mRenderbufferBindingStack.empty() ) { // bad - empty stack; push twice to allow for the pop later and not lead to an empty stack
+			mRenderbufferBindingStack.push_back( queriedInt );
+			mRenderbufferBindingStack.push_back( queriedInt );
 		}
 		else
-			mRenderbufferBindingStack[target].back() = queriedInt;
+			mRenderbufferBindingStack.back() = queriedInt;
 		return (GLuint)queriedInt;
 	}
 	else
-		return (GLuint)cachedIt->second.back();
+		return (GLuint)mRenderbufferBindingStack.back();
 }
 
 void Context::renderbufferDeleted( const Renderbuffer *buffer )
 {
-	GLenum target = GL_RENDERBUFFER;
-
-	// if 'id' was bound to 'target', mark 'target's binding as 0
-	auto existingIt = mRenderbufferBindingStack.find( target );
-	if( existingIt != mRenderbufferBindingStack.end() ) {
-		if( mRenderbufferBindingStack[target].back() == buffer->getId() )
-			mRenderbufferBindingStack[target].back() = 0;
+	// if 'id' was bound, mark the binding as 0
+	if( ! mRenderbufferBindingStack.empty() ) {
+		if( mRenderbufferBindingStack.back() == (GLint)buffer->getId() )
+			mRenderbufferBindingStack.back() = 0;
 	}
 	else
-		mRenderbufferBindingStack[target].push_back( 0 );
+		mRenderbufferBindingStack.push_back( 0 );
 }
 
 #if ! defined( CINDER_GL_ES_2 )
@@ -716,17 +703,27 @@ void Context::bindBufferBase( GLenum target, GLuint index, const BufferObjRef &b
 	if( target == GL_TRANSFORM_FEEDBACK && mCachedTransformFeedbackObj )
 		mCachedTransformFeedbackObj->setIndex( index, buffer );
 	else
-		glBindBufferBase( target, index, buffer->getId() );
+		bindBufferBase( target, index, buffer->getId() );
 }
 
 void Context::bindBufferBase( GLenum target, GLuint index, GLuint id )
 {
 	glBindBufferBase( target, index, id );
+	indexedBufferBound( target, id );
 }
 
 void Context::bindBufferRange( GLenum target, GLuint index, const BufferObjRef &buffer, GLintptr offset, GLsizeiptr size )
 {
 	glBindBufferRange( target, index, buffer->getId(), offset, size );
+	indexedBufferBound( target, buffer->getId() );
+}
+
+void Context::indexedBufferBound( GLenum target, GLuint id )
+{
+	// glBindBufferBase() and glBindBufferRange() also bind the buffer to the generic binding point of target
+	auto stack = mBufferBindingStack.find( target );
+	if( stack && ! stack->empty() )
+		stack->back() = id;
 }
 
 #endif // ! defined( CINDER_GL_ES_2 )
@@ -800,7 +797,7 @@ void Context::pushGlslProg( const GlslProg* prog )
 	const GlslProg* prevGlsl = getGlslProg();
 
 	mGlslProgStack.push_back( prog );
-	if( prog != prevGlsl ) {
+	if( countStateChange( prog != prevGlsl ) ) {
 		if( prog )
 			prog->bindImpl();
 		else
@@ -820,7 +817,7 @@ void Context::popGlslProg( bool forceRestore )
 	if( ! mGlslProgStack.empty() ) {
 		mGlslProgStack.pop_back();
 		if( ! mGlslProgStack.empty() ) {
-			if( forceRestore || ( prevGlsl != mGlslProgStack.back() ) ) {
+			if( countStateChange( forceRestore || ( prevGlsl != mGlslProgStack.back() ) ) ) {
 				if( mGlslProgStack.back() )
 					mGlslProgStack.back()->bindImpl();
 				else
@@ -836,7 +833,7 @@ void Context::popGlslProg( bool forceRestore )
 
 void Context::bindGlslProg( const GlslProg *prog )
 {
-	if( mGlslProgStack.empty() || (mGlslProgStack.back() != prog) ) {
+	if( countStateChange( mGlslProgStack.empty() || (mGlslProgStack.back() != prog) ) ) {
 		if( ! mGlslProgStack.empty() )
 			mGlslProgStack.back() = prog;
 		if( prog )
@@ -875,12 +872,9 @@ void Context::bindTexture( GLenum target, GLuint textureId )
 
 void Context::bindTexture( GLenum target, GLuint textureId, uint8_t textureUnit )
 {
-	if( mTextureBindingStack.find( textureUnit ) == mTextureBindingStack.end() )
-		mTextureBindingStack[textureUnit] = std::map<GLenum,std::vector<GLint>>();
-
 	GLuint prevValue = getTextureBinding( target, textureUnit );
-	if( prevValue != textureId ) {
-		mTextureBindingStack[textureUnit][target].back() = textureId;
+	if( countStateChange( prevValue != textureId ) ) {
+		mTextureBindingStack[getTextureBindingKey( target, textureUnit )].back() = textureId;
 		ScopedActiveTexture actScp( textureUnit );
 		glBindTexture( target, textureId );
 	}
@@ -888,28 +882,18 @@ void Context::bindTexture( GLenum target, GLuint textureId, uint8_t textureUnit
 
 void Context::pushTextureBinding( GLenum target, uint8_t textureUnit )
 {
-	if( mTextureBindingStack.find( textureUnit ) == mTextureBindingStack.end() ) {
-		mTextureBindingStack[textureUnit] = std::map<GLenum,std::vector<GLint>>();
-		GLenum targetBinding = Texture::getBindingConstantForTarget( target );
-		GLint queriedInt = -1;
-		if( targetBinding > 0 ) {
-			ScopedActiveTexture actScp( textureUnit );
-			glGetIntegerv( targetBinding, &queriedInt );
-		}
-		mTextureBindingStack[textureUnit][target].push_back( queriedInt );
-	}
-	else if( mTextureBindingStack[textureUnit].find( target ) == mTextureBindingStack[textureUnit].end() ) {
-		mTextureBindingStack[textureUnit][target] = std::vector<GLint>();
+	auto &stack = mTextureBindingStack[getTextureBindingKey( target, textureUnit )];
+	if( stack.empty() ) {
 		GLenum targetBinding = Texture::getBindingConstantForTarget( target );
 		GLint queriedInt = -1;
 		if( targetBinding > 0 ) {
 			ScopedActiveTexture actScp( textureUnit );
 			glGetIntegerv( targetBinding, &queriedInt );
 		}
-		mTextureBindingStack[textureUnit][target].push_back( queriedInt );
+		stack.push_back( queriedInt );
 	}
 	
-	mTextureBindingStack[textureUnit][target].push_back( mTextureBindingStack[textureUnit][target].back() );
+	stack.push_back( stack.back() );
 }
 
 void Context::pushTextureBinding( GLenum target, GLuint textureId, uint8_t textureUnit )
@@ -920,31 +904,26 @@ void Context::pushTextureBinding( GLenum target, GLuint textureId, uint8_t textu
 
 void Context::popTextureBinding( GLenum target, uint8_t textureUnit, bool forceRestore )
 {
-	if( mTextureBindingStack.find( textureUnit ) == mTextureBindingStack.end() ) {
-		mTextureBindingStack[textureUnit] = std::map<GLenum,std::vector<GLint>>();
+	auto &stack = mTextureBindingStack[getTextureBindingKey( target, textureUnit )];
+	if( stack.empty() ) {
 		CI_LOG_E( "Popping unencountered texture binding target:" << gl::constantToString( target ) );
+		return;
 	}
 
-	auto cached = mTextureBindingStack[textureUnit].find( target );
-	if( ( cached != mTextureBindingStack[textureUnit].end() ) && ( ! cached->second.empty() ) ) {
-		GLint prevValue = cached->second.back();
-		cached->second.pop_back();
-		if( ! cached->second.empty() ) {
-			if( forceRestore || ( cached->second.back() != prevValue ) ) {
-				ScopedActiveTexture actScp( textureUnit );
-				glBindTexture( target, cached->second.back() );
-			}
+	GLint prevValue = stack.back();
+	stack.pop_back();
+	if( ! stack.empty() ) {
+		if( countStateChange( forceRestore || ( stack.back() != prevValue ) ) ) {
+			ScopedActiveTexture actScp( textureUnit );
+			glBindTexture( target, stack.back() );
 		}
 	}
 }
 
 GLuint Context::getTextureBinding( GLenum target, uint8_t textureUnit )
 {
-	if( mTextureBindingStack.find( textureUnit ) == mTextureBindingStack.end() )
-		mTextureBindingStack[textureUnit] = std::map<GLenum,std::vector<GLint>>();
-
-	auto cachedIt = mTextureBindingStack[textureUnit].find( target );
-	if( (cachedIt == mTextureBindingStack[textureUnit].end()) || ( cachedIt->second.empty() ) || ( cachedIt->second.back() == -1 ) ) {
+	auto &stack = mTextureBindingStack[getTextureBindingKey( target, textureUnit )];
+	if( stack.empty() || ( stack.back() == -1 ) ) {
 		GLint queriedInt = 0;
 		GLenum targetBinding = Texture::getBindingConstantForTarget( target );
 		if( targetBinding > 0 ) {
@@ -954,17 +933,16 @@ GLuint Context::getTextureBinding( GLenum target, uint8_t textureUnit )
 		else
 			return 0; // warning?
 		
-		if( mTextureBindingStack[textureUnit][target].empty() ) { // bad - empty stack; push twice to allow for the pop later and not lead to an empty stack
-			mTextureBindingStack[textureUnit][target] = vector<GLint>();
-			mTextureBindingStack[textureUnit][target].push_back( queriedInt );
-			mTextureBindingStack[textureUnit][target].push_back( queriedInt );			
+		if( stack.empty() ) { // bad - empty stack; push twice to allow for the pop later and not lead to an empty stack
+			stack.push_back( queriedInt );
+			stack.push_back( queriedInt );
 		}
 		else
-			mTextureBindingStack[textureUnit][target].back() = queriedInt;
+			stack.back() = queriedInt;
 		return (GLuint)queriedInt;
 	}
 	else
-		return (GLuint)cachedIt->second.back();
+		return (GLuint)stack.back();
 }
 
 void Context::textureCreated( const TextureBase *texture )
@@ -982,12 +960,11 @@ void Context::textureDeleted( const TextureBase *texture )
 	if( mObjectTrackingEnabled )
 		mLiveTextures.erase( texture );
 
-	for( auto &unit : mTextureBindingStack ) {
-		auto cachedIt = unit.second.find( target );
-		if( cachedIt != unit.second.end() && ( ! cachedIt->second.empty() ) && ( cachedIt->second.back() != textureId ) ) {
+	for( int unit = 0; unit < 256; ++unit ) {
+		auto stack = mTextureBindingStack.find( getTextureBindingKey( target, (uint8_t)unit ) );
 		// GL will have set the binding to 0 for target, so let's do the same
-			unit.second[target].back() = 0;
-	}
+		if( stack && ( ! stack->empty() ) && ( stack->back() == (GLint)textureId ) )
+			stack->back() = 0;
 	}
 }
 
@@ -995,13 +972,13 @@ void Context::textureDeleted( const TextureBase *texture )
 // ActiveTexture
 void Context::setActiveTexture( uint8_t textureUnit )
 {
-	if( setStackState<uint8_t>( mActiveTextureStack, textureUnit ) )
+	if( countStateChange( setStackState<uint8_t>( mActiveTextureStack, textureUnit ) ) )
 		glActiveTexture( GL_TEXTURE0 + textureUnit );
 }
 
 void Context::pushActiveTexture( uint8_t textureUnit )
 {
-	if( pushStackState<uint8_t>( mActiveTextureStack, textureUnit ) )
+	if( countStateChange( pushStackState<uint8_t>( mActiveTextureStack, textureUnit ) ) )
 		glActiveTexture( GL_TEXTURE0 + textureUnit );
 }
 
@@ -1015,7 +992,7 @@ void Context::popActiveTexture( bool forceRefresh )
 {
 	if( mActiveTextureStack.empty() )
 		CI_LOG_E( "Active texture stack underflow" );
-	else if( popStackState<uint8_t>( mActiveTextureStack ) || forceRefresh )
+	else if( countStateChange( popStackState<uint8_t>( mActiveTextureStack ) || forceRefresh ) )
 		glActiveTexture( GL_TEXTURE0 + getActiveTexture() );
 }
 
@@ -1038,7 +1015,7 @@ uint8_t Context::getActiveTexture()
 void Context::bindSampler( uint8_t textureUnit, GLuint samplerId )
 {
 	GLuint prevValue = getSamplerBinding( textureUnit );
-	if( prevValue != samplerId ) {
+	if( countStateChange( prevValue != samplerId ) ) {
 		mSamplerBindingStack[textureUnit].back() = samplerId;
 		glBindSampler( textureUnit, samplerId );
 	}
@@ -1048,7 +1025,7 @@ void Context::pushSamplerBinding( uint8_t textureUnit, GLuint samplerId )
 {
 	GLuint prevSampler = getSamplerBinding( textureUnit );
 	mSamplerBindingStack[textureUnit].push_back( samplerId );
-	if( prevSampler != samplerId )
+	if( countStateChange( prevSampler != samplerId ) )
 		glBindSampler( textureUnit, samplerId );
 }
 
@@ -1063,7 +1040,7 @@ void Context::popSamplerBinding( uint8_t textureUnit, bool forceRestore )
 	mSamplerBindingStack[textureUnit].pop_back();
 	if( mSamplerBindingStack[textureUnit].empty() )
 		CI_LOG_E( "Stack underflow popping sampler binding on unit " << textureUnit );
-	else if( (mSamplerBindingStack[textureUnit].back() != prevSampler) || forceRestore )
+	else if( countStateChange( (mSamplerBindingStack[textureUnit].back() != prevSampler) || forceRestore ) )
 		glBindSampler( textureUnit, mSamplerBindingStack[textureUnit].back() ); 
 }
 
@@ -1091,7 +1068,7 @@ void Context::bindFramebuffer( GLenum target, GLuint framebuffer )
 {
 #if ! defined( CINDER_GL_HAS_FBO_MULTISAMPLING )
 	if( target == GL_FRAMEBUFFER ) {
-		if( setStackState<GLint>( mFramebufferStack, framebuffer ) )
+		if( countStateChange( setStackState<GLint>( mFramebufferStack, framebuffer ) ) )
 			glBindFramebuffer( target, framebuffer );
 	}
 	else {
@@ -1101,15 +1078,15 @@ void Context::bindFramebuffer( GLenum target, GLuint framebuffer )
 	if( target == GL_FRAMEBUFFER ) {
 		bool readRequiresBind = setStackState<GLint>( mReadFramebufferStack, framebuffer );
 		bool drawRequiresBind = setStackState<GLint>( mDrawFramebufferStack, framebuffer );
-		if( readRequiresBind || drawRequiresBind )
+		if( countStateChange( readRequiresBind || drawRequiresBind ) )
 			glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
 	}
 	else if( target == GL_READ_FRAMEBUFFER ) {
-		if( setStackState<GLint>( mReadFramebufferStack, framebuffer ) )
+		if( countStateChange( setStackState<GLint>( mReadFramebufferStack, framebuffer ) ) )
 			glBindFramebuffer( target, framebuffer );
 	}
 	else if( target == GL_DRAW_FRAMEBUFFER ) {
-		if( setStackState<GLint>( mDrawFramebufferStack, framebuffer ) )
+		if( countStateChange( setStackState<GLint>( mDrawFramebufferStack, framebuffer ) ) )
 			glBindFramebuffer( target, framebuffer );		
 	}
 	else {
@@ -1138,15 +1115,15 @@ void Context::pushFramebuffer( const FboRef &fbo, GLenum target )
 void Context::pushFramebuffer( GLenum target, GLuint framebuffer )
 {
 #if ! defined( CINDER_GL_HAS_FBO_MULTISAMPLING )
-	if( pushStackState<GLint>( mFramebufferStack, framebuffer ) )
+	if( countStateChange( pushStackState<GLint>( mFramebufferStack, framebuffer ) ) )
 		glBindFramebuffer( target, framebuffer );
 #else
 	if( target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER ) {
-		if( pushStackState<GLint>( mReadFramebufferStack, framebuffer ) )
+		if( countStateChange( pushStackState<GLint>( mReadFramebufferStack, framebuffer ) ) )
 			glBindFramebuffer( GL_READ_FRAMEBUFFER, framebuffer );
 	}
 	if( target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER ) {
-		if( pushStackState<GLint>( mDrawFramebufferStack, framebuffer ) )
+		if( countStateChange( pushStackState<GLint>( mDrawFramebufferStack, framebuffer ) ) )
 			glBindFramebuffer( GL_DRAW_FRAMEBUFFER, framebuffer );	
 	}
 #endif
@@ -1169,17 +1146,17 @@ void Context::pushFramebuffer( GLenum target )
 void Context::popFramebuffer( GLenum target )
 {
 #if ! defined( CINDER_GL_HAS_FBO_MULTISAMPLING )
-	if( popStackState<GLint>( mFramebufferStack ) )
+	if( countStateChange( popStackState<GLint>( mFramebufferStack ) ) )
 		if( ! mFramebufferStack.empty() )
 			glBindFramebuffer( target, mFramebufferStack.back() );
 #else
 	if( target == GL_FRAMEBUFFER || target == GL_READ_FRAMEBUFFER ) {
-		if( popStackState<GLint>( mReadFramebufferStack ) )
+		if( countStateChange( popStackState<GLint>( mReadFramebufferStack ) ) )
 			if( ! mReadFramebufferStack.empty() )
 				glBindFramebuffer( target, mReadFramebufferStack.back() );
 	}
 	if( target == GL_FRAMEBUFFER || target == GL_DRAW_FRAMEBUFFER ) {
-		if( popStackState<GLint>( mDrawFramebufferStack ) )
+		if( countStateChange( popStackState<GLint>( mDrawFramebufferStack ) ) )
 			if( ! mDrawFramebufferStack.empty() )
 				glBindFramebuffer( target, mDrawFramebufferStack.back() );
 	}
@@ -1241,17 +1218,13 @@ void Context::framebufferDeleted( const Fbo *fbo )
 // States
 void Context::setBoolState( GLenum cap, GLboolean value )
 {
-	bool needsToBeSet = true;
-	auto cached = mBoolStateStack.find( cap );
-	if( ( cached != mBoolStateStack.end() ) && ( ! cached->second.empty() ) && ( cached->second.back() == value ) )
-		needsToBeSet = false;
-	if( cached == mBoolStateStack.end() ) {
-		mBoolStateStack[cap] = vector<GLboolean>();
-		mBoolStateStack[cap].push_back( value );
-	}
+	auto &stack = mBoolStateStack[cap];
+	const bool needsToBeSet = stack.empty() || ( stack.back() != value );
+	if( stack.empty() )
+		stack.push_back( value );
 	else
-		mBoolStateStack[cap].back() = value;
-	if( needsToBeSet ) {
+		stack.back() = value;
+	if( countStateChange( needsToBeSet ) ) {
 		if( value )
 			glEnable( cap );
 		else
@@ -1261,32 +1234,24 @@ void Context::setBoolState( GLenum cap, GLboolean value )
 
 void Context::setBoolState( GLenum cap, GLboolean value, const std::function<void(GLboolean)> &setter )
 {
-	bool needsToBeSet = true;
-	auto cached = mBoolStateStack.find( cap );
-	if( ( cached != mBoolStateStack.end() ) && ( ! cached->second.empty() ) && ( cached->second.back() == value ) )
-		needsToBeSet = false;
-	if( cached == mBoolStateStack.end() ) {
-		mBoolStateStack[cap] = vector<GLboolean>();
-		mBoolStateStack[cap].push_back( value );
-	}
+	auto &stack = mBoolStateStack[cap];
+	const bool needsToBeSet = stack.empty() || ( stack.back() != value );
+	if( stack.empty() )
+		stack.push_back( value );
 	else
-		mBoolStateStack[cap].back() = value;
-	if( needsToBeSet )
+		stack.back() = value;
+	if( countStateChange( needsToBeSet ) )
 		setter( value );
 }
 
 void Context::pushBoolState( GLenum cap, GLboolean value )
 {
-	bool needsToBeSet = true;
-	auto cached = mBoolStateStack.find( cap );
-	if( ( cached != mBoolStateStack.end() ) && ( ! cached->second.empty() ) && ( cached->second.back() == value ) )
-		needsToBeSet = false;
-	else if( cached == mBoolStateStack.end() ) {
-		mBoolStateStack[cap] = vector<GLboolean>();
-		mBoolStateStack[cap].push_back( glIsEnabled( cap ) );
-	}
-	mBoolStateStack[cap].push_back( value );
-	if( needsToBeSet ) {
+	auto &stack = mBoolStateStack[cap];
+	const bool needsToBeSet = stack.empty() || ( stack.back() != value );
+	if( stack.empty() )
+		stack.push_back( glIsEnabled( cap ) );
+	stack.push_back( value );
+	if( countStateChange( needsToBeSet ) ) {
 		if( value )
 			glEnable( cap );
 		else
@@ -1302,13 +1267,13 @@ void Context::pushBoolState( GLenum cap )
 
 void Context::popBoolState( GLenum cap, bool forceRestore )
 {
-	auto cached = mBoolStateStack.find( cap );
-	if( ( cached != mBoolStateStack.end() ) && ( ! cached->second.empty() ) ) {
-		GLboolean prevValue = cached->second.back();
-		cached->second.pop_back();
-		if( ! cached->second.empty() ) {
-			if( forceRestore || ( cached->second.back() != prevValue ) ) {
-				if( cached->second.back() )
+	auto &stack = mBoolStateStack[cap];
+	if( ! stack.empty() ) {
+		GLboolean prevValue = stack.back();
+		stack.pop_back();
+		if( ! stack.empty() ) {
+			if( countStateChange( forceRestore || ( stack.back() != prevValue ) ) ) {
+				if( stack.back() )
 					glEnable( cap );
 				else
 					glDisable( cap );
@@ -1327,18 +1292,16 @@ void Context::enable( GLenum cap, GLboolean value )
 
 GLboolean Context::getBoolState( GLenum cap )
 {
-	auto cached = mBoolStateStack.find( cap );
-	if( ( cached == mBoolStateStack.end() ) || cached->second.empty() ) {
+	auto &stack = mBoolStateStack[cap];
+	if( stack.empty() ) {
 		GLboolean result = glIsEnabled( cap );
-		if( cached == mBoolStateStack.end() )
-			mBoolStateStack[cap] = vector<GLboolean>();
 		// push twice to accommodate later pop
-		mBoolStateStack[cap].push_back( result );
-		mBoolStateStack[cap].push_back( result );
+		stack.push_back( result );
+		stack.push_back( result );
 		return result;
 	}
 	else
-		return cached->second.back();
+		return stack.back();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1354,7 +1317,7 @@ void Context::blendFuncSeparate( GLenum srcRGB, GLenum dstRGB, GLenum srcAlpha,
 	needsChange = setStackState<GLint>( mBlendDstRgbStack, dstRGB ) || needsChange;
 	needsChange = setStackState<GLint>( mBlendSrcAlphaStack, srcAlpha ) || needsChange;
 	needsChange = setStackState<GLint>( mBlendDstAlphaStack, dstAlpha ) || needsChange;
-	if( needsChange )
+	if( countStateChange( needsChange ) )
 		glBlendFuncSeparate( srcRGB, dstRGB, srcAlpha, dstAlpha );
 }
 
@@ -1364,7 +1327,7 @@ void Context::pushBlendFuncSeparate( GLenum srcRGB, GLenum dstRGB, GLenum srcAlp
 	needsChange = pushStackState<GLint>( mBlendDstRgbStack, dstRGB ) || needsChange;
 	needsChange = pushStackState<GLint>( mBlendSrcAlphaStack, srcAlpha ) || needsChange;
 	needsChange = pushStackState<GLint>( mBlendDstAlphaStack, dstAlpha ) || needsChange;
-	if( needsChange )
+	if( countStateChange( needsChange ) )
 		glBlendFuncSeparate( srcRGB, dstRGB, srcAlpha, dstAlpha );
 }
 
@@ -1386,7 +1349,7 @@ void Context::popBlendFuncSeparate( bool forceRestore )
 	needsChange = popStackState<GLint>( mBlendSrcAlphaStack ) || needsChange;
 	needsChange = popStackState<GLint>( mBlendDstAlphaStack ) || needsChange;
 	needsChange = forceRestore || needsChange;
-	if( needsChange && ( ! mBlendSrcRgbStack.empty() ) && ( ! mBlendSrcAlphaStack.empty() ) && ( ! mBlendDstRgbStack.empty() ) && ( ! mBlendDstAlphaStack.empty() ) )
+	if( countStateChange( needsChange ) && ( ! mBlendSrcRgbStack.empty() ) && ( ! mBlendSrcAlphaStack.empty() ) && ( ! mBlendDstRgbStack.empty() ) && ( ! mBlendDstAlphaStack.empty() ) )
 		glBlendFuncSeparate( mBlendSrcRgbStack.back(), mBlendDstRgbStack.back(), mBlendSrcAlphaStack.back(), mBlendDstAlphaStack.back() );
 }
 
@@ -1421,13 +1384,13 @@ void Context::getBlendFuncSeparate( GLenum *resultSrcRGB, GLenum *resultDstRGB,
 // LineWidth
 void Context::lineWidth( float lineWidth )
 {
-	if( setStackState<float>( mLineWidthStack, lineWidth ) )
+	if( countStateChange( setStackState<float>( mLineWidthStack, lineWidth ) ) )
 		glLineWidth( lineWidth );
 }
 
 void Context::pushLineWidth( float lineWidth )
 {
-	if( pushStackState<float>( mLineWidthStack, lineWidth ) )
+	if( countStateChange( pushStackState<float>( mLineWidthStack, lineWidth ) ) )
 		glLineWidth( lineWidth );
 }
 
@@ -1440,7 +1403,7 @@ void Context::popLineWidth( bool forceRestore )
 {
 	if( mLineWidthStack.empty() )
 		CI_LOG_E( "LineWidth stack underflow" );
-	else if( popStackState<float>( mLineWidthStack ) || forceRestore )
+	else if( countStateChange( popStackState<float>( mLineWidthStack ) || forceRestore ) )
 		glLineWidth( getLineWidth() );
 }
 
@@ -1461,14 +1424,14 @@ float Context::getLineWidth()
 // DepthMask
 void Context::depthMask( GLboolean enable )
 {
-	if( setStackState( mDepthMaskStack, enable ) ) {
+	if( countStateChange( setStackState( mDepthMaskStack, enable ) ) ) {
 		glDepthMask( enable );
 	}
 }
 
 void Context::pushDepthMask( GLboolean enable )
 {
-	if( pushStackState( mDepthMaskStack, enable ) ) {
+	if( countStateChange( pushStackState( mDepthMaskStack, enable ) ) ) {
 		glDepthMask( enable );
 	}
 }
@@ -1482,7 +1445,7 @@ void Context::popDepthMask( bool forceRestore )
 {
 	if( mDepthMaskStack.empty() )
 		CI_LOG_E( "Depth mask stack underflow" );
-	else if( popStackState( mDepthMaskStack ) || forceRestore )
+	else if( countStateChange( popStackState( mDepthMaskStack ) || forceRestore ) )
 		glDepthMask( getDepthMask() );
 }
 
@@ -1505,7 +1468,7 @@ void Context::depthFunc( GLenum func )
 	if( func != GL_NEVER && func != GL_LESS && func != GL_EQUAL && func != GL_LEQUAL && func != GL_GREATER && func != GL_NOTEQUAL && func != GL_GEQUAL && func != GL_ALWAYS )
 		CI_LOG_E( "Wrong enum for the depth buffer comparison function" );
 	
-	if( setStackState( mDepthFuncStack, func ) ) {
+	if( countStateChange( setStackState( mDepthFuncStack, func ) ) ) {
 		glDepthFunc( func );
 	}
 }
@@ -1515,7 +1478,7 @@ void Context::pushDepthFunc( GLenum func )
 	if( func != GL_NEVER && func != GL_LESS && func != GL_EQUAL && func != GL_LEQUAL && func != GL_GREATER && func != GL_NOTEQUAL && func != GL_GEQUAL && func != GL_ALWAYS )
 		CI_LOG_E( "Wrong enum for the depth buffer comparison function" );
 	
-	if( pushStackState( mDepthFuncStack, func ) ) {
+	if( countStateChange( pushStackState( mDepthFuncStack, func ) ) ) {
 		glDepthFunc( func );
 	}
 }
@@ -1529,7 +1492,7 @@ void Context::popDepthFunc( bool forceRestore )
 {
 	if( mDepthFuncStack.empty() )
 		CI_LOG_E( "Depth function stack underflow" );
-	else if( popStackState( mDepthFuncStack ) || forceRestore )
+	else if( countStateChange( popStackState( mDepthFuncStack ) || forceRestore ) )
 		glDepthFunc( getDepthFunc() );
 }
 
@@ -1553,7 +1516,7 @@ void Context::polygonMode( GLenum face, GLenum mode )
 	if( face != GL_FRONT_AND_BACK )
 		CI_LOG_E( "Only GL_FRONT_AND_BACK is legal for polygonMode face" );
 
-	if( setStackState( mPolygonModeStack, mode ) )
+	if( countStateChange( setStackState( mPolygonModeStack, mode ) ) )
 		glPolygonMode( GL_FRONT_AND_BACK, mode );
 }
 
@@ -1562,7 +1525,7 @@ void Context::pushPolygonMode( GLenum face, GLenum mode )
 	if( face != GL_FRONT_AND_BACK )
 		CI_LOG_E( "Only GL_FRONT_AND_BACK is legal for polygonMode face" );
 
-	if( pushStackState( mPolygonModeStack, mode ) )
+	if( countStateChange( pushStackState( mPolygonModeStack, mode ) ) )
 		glPolygonMode( GL_FRONT_AND_BACK, mode );
 }
 
@@ -1581,7 +1544,7 @@ void Context::popPolygonMode( GLenum face, bool forceRefresh )
 
 	if( mPolygonModeStack.empty() )
 		CI_LOG_E( "Polygon mode stack underflow" );
-	else if( popStackState( mPolygonModeStack ) || forceRefresh )
+	else if( countStateChange( popStackState( mPolygonModeStack ) || forceRefresh ) )
 		glPolygonMode( GL_FRONT_AND_BACK, getPolygonMode( GL_FRONT_AND_BACK ) );
 }
 
@@ -1601,6 +1564,120 @@ GLenum Context::getPolygonMode( GLenum face )
 
 #endif // ! defined( CINDER_GL_ES )
 
+//////////////////////////////////////////////////////////////////////////////////////////
+// State stack slots
+size_t Context::getBufferSlot( GLenum target )
+{
+	switch( target ) {
+		case GL_ARRAY_BUFFER:				return BUFFER_SLOT_ARRAY;
+		case GL_ELEMENT_ARRAY_BUFFER:		return BUFFER_SLOT_ELEMENT_ARRAY;
+#if defined( GL_UNIFORM_BUFFER )
+		case GL_UNIFORM_BUFFER:				return BUFFER_SLOT_UNIFORM;
+#endif
+#if defined( GL_PIXEL_PACK_BUFFER )
+		case GL_PIXEL_PACK_BUFFER:			return BUFFER_SLOT_PIXEL_PACK;
+		case GL_PIXEL_UNPACK_BUFFER:		return BUFFER_SLOT_PIXEL_UNPACK;
+#endif
+#if defined( GL_TRANSFORM_FEEDBACK_BUFFER )
+		case GL_TRANSFORM_FEEDBACK_BUFFER:	return BUFFER_SLOT_TRANSFORM_FEEDBACK;
+#endif
+#if defined( GL_COPY_READ_BUFFER )
+		case GL_COPY_READ_BUFFER:			return BUFFER_SLOT_COPY_READ;
+		case GL_COPY_WRITE_BUFFER:			return BUFFER_SLOT_COPY_WRITE;
+#endif
+#if defined( GL_TEXTURE_BUFFER )
+		case GL_TEXTURE_BUFFER:				return BUFFER_SLOT_TEXTURE;
+#endif
+#if defined( GL_DRAW_INDIRECT_BUFFER )
+		case GL_DRAW_INDIRECT_BUFFER:		return BUFFER_SLOT_DRAW_INDIRECT;
+#endif
+#if defined( GL_DISPATCH_INDIRECT_BUFFER )
+		case GL_DISPATCH_INDIRECT_BUFFER:	return BUFFER_SLOT_DISPATCH_INDIRECT;
+#endif
+#if defined( GL_SHADER_STORAGE_BUFFER )
+		case GL_SHADER_STORAGE_BUFFER:		return BUFFER_SLOT_SHADER_STORAGE;
+#endif
+#if defined( GL_ATOMIC_COUNTER_BUFFER )
+		case GL_ATOMIC_COUNTER_BUFFER:		return BUFFER_SLOT_ATOMIC_COUNTER;
+#endif
+		default:							return NUM_BUFFER_SLOTS;
+	}
+}
+
+size_t Context::getBoolStateSlot( GLenum cap )
+{
+	switch( cap ) {
+		case GL_BLEND:						return BOOL_STATE_SLOT_BLEND;
+		case GL_DEPTH_TEST:					return BOOL_STATE_SLOT_DEPTH_TEST;
+		case GL_CULL_FACE:					return BOOL_STATE_SLOT_CULL_FACE;
+		case GL_SCISSOR_TEST:				return BOOL_STATE_SLOT_SCISSOR_TEST;
+		case GL_STENCIL_TEST:				return BOOL_STATE_SLOT_STENCIL_TEST;
+		case GL_POLYGON_OFFSET_FILL:		return BOOL_STATE_SLOT_POLYGON_OFFSET_FILL;
+		case GL_SAMPLE_ALPHA_TO_COVERAGE:	return BOOL_STATE_SLOT_SAMPLE_ALPHA_TO_COVERAGE;
+		case GL_DITHER:						return BOOL_STATE_SLOT_DITHER;
+#if defined( GL_MULTISAMPLE )
+		case GL_MULTISAMPLE:				return BOOL_STATE_SLOT_MULTISAMPLE;
+#endif
+#if defined( GL_LINE_SMOOTH )
+		case GL_LINE_SMOOTH:				return BOOL_STATE_SLOT_LINE_SMOOTH;
+#endif
+#if defined( GL_PROGRAM_POINT_SIZE )
+		case GL_PROGRAM_POINT_SIZE:			return BOOL_STATE_SLOT_PROGRAM_POINT_SIZE;
+#endif
+#if defined( GL_FRAMEBUFFER_SRGB )
+		case GL_FRAMEBUFFER_SRGB:			return BOOL_STATE_SLOT_FRAMEBUFFER_SRGB;
+#endif
+#if defined( GL_RASTERIZER_DISCARD )
+		case GL_RASTERIZER_DISCARD:			return BOOL_STATE_SLOT_RASTERIZER_DISCARD;
+#endif
+#if defined( GL_PRIMITIVE_RESTART_FIXED_INDEX )
+		case GL_PRIMITIVE_RESTART_FIXED_INDEX:	return BOOL_STATE_SLOT_PRIMITIVE_RESTART_FIXED_INDEX;
+#endif
+		default:							return NUM_BOOL_STATE_SLOTS;
+	}
+}
+
+size_t Context::getTextureBindingSlot( GLenum key )
+{
+	const size_t textureUnit = key >> 16;
+	size_t targetSlot;
+	switch( key & 0xFFFF ) {
+		case GL_TEXTURE_2D:					targetSlot = TEXTURE_TARGET_SLOT_2D; break;
+		case GL_TEXTURE_CUBE_MAP:			targetSlot = TEXTURE_TARGET_SLOT_CUBE_MAP; break;
+#if defined( GL_TEXTURE_3D )
+		case GL_TEXTURE_3D:					targetSlot = TEXTURE_TARGET_SLOT_3D; break;
+#endif
+#if defined( GL_TEXTURE_2D_ARRAY )
+		case GL_TEXTURE_2D_ARRAY:			targetSlot = TEXTURE_TARGET_SLOT_2D_ARRAY; break;
+#endif
+#if defined( GL_TEXTURE_RECTANGLE )
+		case GL_TEXTURE_RECTANGLE:			targetSlot = TEXTURE_TARGET_SLOT_RECTANGLE; break;
+#endif
+#if defined( GL_TEXTURE_1D )
+		case GL_TEXTURE_1D:					targetSlot = TEXTURE_TARGET_SLOT_1D; break;
+		case GL_TEXTURE_1D_ARRAY:			targetSlot = TEXTURE_TARGET_SLOT_1D_ARRAY; break;
+#endif
+#if defined( GL_TEXTURE_CUBE_MAP_ARRAY )
+		case GL_TEXTURE_CUBE_MAP_ARRAY:		targetSlot = TEXTURE_TARGET_SLOT_CUBE_MAP_ARRAY; break;
+#endif
+#if defined( GL_TEXTURE_BUFFER )
+		case GL_TEXTURE_BUFFER:				targetSlot = TEXTURE_TARGET_SLOT_BUFFER; break;
+#endif
+#if defined( GL_TEXTURE_2D_MULTISAMPLE )
+		case GL_TEXTURE_2D_MULTISAMPLE:		targetSlot = TEXTURE_TARGET_SLOT_2D_MULTISAMPLE; break;
+#endif
+#if defined( GL_TEXTURE_EXTERNAL_OES )
+		case GL_TEXTURE_EXTERNAL_OES:		targetSlot = TEXTURE_TARGET_SLOT_EXTERNAL; break;
+#endif
+		default:							return MAX_SLOT_TEXTURE_UNITS * NUM_TEXTURE_TARGET_SLOTS;
+	}
+
+	if( textureUnit >= MAX_SLOT_TEXTURE_UNITS )
+		return MAX_SLOT_TEXTURE_UNITS * NUM_TEXTURE_TARGET_SLOTS;
+
+	return textureUnit * NUM_TEXTURE_TARGET_SLOTS + targetSlot;
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////
 // Templated stack management routines
 template<typename T>
@@ -1824,11 +1901,15 @@ void Context::vertexAttrib4f( GLuint index, float v0, float v1, float v2, float
 // draw*
 void Context::drawArrays( GLenum mode, GLint first, GLsizei count )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glDrawArrays( mode, first, count );
 }
 
 void Context::drawElements( GLenum mode, GLsizei count, GLenum type, const GLvoid *indices )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glDrawElements( mode, count, type, indices );
 }
 
@@ -1836,11 +1917,15 @@ void Context::drawElements( GLenum mode, GLsizei count, GLenum type, const GLvoi
 
 void Context::multiDrawArrays( GLenum mode, GLint *first, GLsizei *count, GLsizei primcount )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glMultiDrawArrays( mode, first, count, primcount );
 }
 
 void Context::multiDrawElements( GLenum mode, GLsizei *count, GLenum type, const GLvoid * const *indices, GLsizei primcount )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glMultiDrawElements( mode, count, type, indices, primcount );
 }
 
@@ -1850,6 +1935,8 @@ void Context::multiDrawElements( GLenum mode, GLsizei *count, GLenum type, const
 
 void Context::drawArraysInstanced( GLenum mode, GLint first, GLsizei count, GLsizei primcount )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 #if defined( CINDER_GL_ANGLE )
 	glDrawArraysInstancedANGLE( mode, first, count, primcount );
 #elif defined( CINDER_GL_ES_2 ) && defined( CINDER_COCOA_TOUCH )
@@ -1861,6 +1948,8 @@ void Context::drawArraysInstanced( GLenum mode, GLint first, GLsizei count, GLsi
 
 void Context::drawElementsInstanced( GLenum mode, GLsizei count, GLenum type, const GLvoid *indices, GLsizei primcount )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 #if defined( CINDER_GL_ANGLE )
 	glDrawElementsInstancedANGLE( mode, count, type, indices, primcount );
 #elif defined( CINDER_GL_ES_2 ) && defined( CINDER_COCOA_TOUCH )
@@ -1876,11 +1965,15 @@ void Context::drawElementsInstanced( GLenum mode, GLsizei count, GLenum type, co
 
 void Context::drawArraysIndirect( GLenum mode, const GLvoid *indirect )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glDrawArraysIndirect( mode, indirect );
 }
 
 void Context::drawElementsIndirect( GLenum mode, GLenum type, const GLvoid *indirect )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glDrawElementsIndirect( mode, type, indirect );
 }
 
@@ -1890,16 +1983,32 @@ void Context::drawElementsIndirect( GLenum mode, GLenum type, const GLvoid *indi
 
 void Context::multiDrawArraysIndirect( GLenum mode, const GLvoid *indirect, GLsizei drawcount, GLsizei stride )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glMultiDrawArraysIndirect( mode, indirect, drawcount, stride );
 }
 
 void Context::multiDrawElementsIndirect( GLenum mode, GLenum type, const GLvoid *indirect, GLsizei drawcount, GLsizei stride )
 {
+	flushBatch2d();
+	flushGlslProgUniforms();
 	glMultiDrawElementsIndirect( mode, type, indirect, drawcount, stride );
 }
 
 #endif // defined( CINDER_GL_HAS_MULTI_DRAW_INDIRECT )
 
+#if defined( CINDER_GL_HAS_COMPUTE_SHADER )
+
+void Context::dispatchCompute( GLuint numGroupsX, GLuint numGroupsY, GLuint numGroupsZ )
+{
+	// pending 2D draws may write what the compute program reads
+	flushBatch2d();
+	flushGlslProgUniforms();
+	glDispatchCompute( numGroupsX, numGroupsY, numGroupsZ );
+}
+
+#endif // defined( CINDER_GL_HAS_COMPUTE_SHADER )
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 // Shaders
 GlslProgRef& Context::getStockShader( const ShaderDef &shaderDef )
@@ -2042,6 +2151,35 @@ void Context::setDefaultShaderVars()
 	}
 }
 
+void Context::pushBatch2d()
+{
+	if( ! mBatch2d )
+		mBatch2d = Batch2d::create();
+
+	mBatch2dDepth++;
+}
+
+void Context::popBatch2d()
+{
+	if( mBatch2dDepth > 0 && --mBatch2dDepth == 0 )
+		mBatch2d->flush();
+}
+
+void Context::flushBatch2d()
+{
+	if( mBatch2dDepth && mBatch2d->getNumPendingVertices() ) {
+		mBatch2d->flush();
+		// the batch may have used the same GlslProg with its own matrices
+		setDefaultShaderVars();
+	}
+}
+
+void Context::flushGlslProgUniforms()
+{
+	if( ! mGlslProgStack.empty() && mGlslProgStack.back() )
+		mGlslProgStack.back()->flushUniforms();
+}
+
 Vao* Context::getDefaultVao()
 {
 	if( ! mDefaultVao ) {
@@ -2099,16 +2237,14 @@ void Context::allocateDrawTextureVboAndVao()
 
 VboRef Context::getDefaultArrayVbo( size_t requiredSize )
 {
-	mDefaultArrayVboIdx = 0;//( mDefaultArrayVboIdx + 1 ) % 4;
-
-	if( ! mDefaultArrayVbo[mDefaultArrayVboIdx] ) {
-		mDefaultArrayVbo[mDefaultArrayVboIdx] = Vbo::create( GL_ARRAY_BUFFER, std::max<size_t>( 1, requiredSize ), NULL, GL_STREAM_DRAW );
+	if( ! mDefaultArrayVbo ) {
+		mDefaultArrayVbo = Vbo::create( GL_ARRAY_BUFFER, std::max<size_t>( 1, requiredSize ), NULL, GL_STREAM_DRAW );
 	}
 	else {
-		mDefaultArrayVbo[mDefaultArrayVboIdx]->ensureMinimumSize( std::max<size_t>( 1, requiredSize ) );
+		mDefaultArrayVbo->ensureMinimumSize( std::max<size_t>( 1, requiredSize ) );
 	}
 
-	return mDefaultArrayVbo[mDefaultArrayVboIdx];
+	return mDefaultArrayVbo;
 }
 
 VboRef Context::getDefaultElementVbo( size_t requiredSize )
@@ -2123,6 +2259,22 @@ VboRef Context::getDefaultElementVbo( size_t requiredSize )
 	return mDefaultElementVbo;
 }
 
+const StreamVboRef& Context::getStreamArrayVbo()
+{
+	if( ! mStreamArrayVbo )
+		mStreamArrayVbo = StreamVbo::create( GL_ARRAY_BUFFER );
+
+	return mStreamArrayVbo;
+}
+
+const StreamVboRef& Context::getStreamElementVbo()
+{
+	if( ! mStreamElementVbo )
+		mStreamElementVbo = StreamVbo::create( GL_ELEMENT_ARRAY_BUFFER, 1024 * 1024 );
+
+	return mStreamElementVbo;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 #if defined( CINDER_GL_HAS_DEBUG_OUTPUT )
 namespace {
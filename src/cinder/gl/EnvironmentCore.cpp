@@ -47,6 +47,7 @@ class EnvironmentCore : public Environment {
 	bool	supportsTextureLod() const override;
 	bool	supportsGeometryShader() const override;
 	bool	supportsTessellationShader() const override;
+	bool	supportsBufferStorage() const override;
 
 	GLenum	getPreferredIndexType() const override;
 
@@ -135,6 +136,12 @@ bool EnvironmentCore::supportsTessellationShader() const
 	return isExtensionAvailable( "GL_EXT_tessellation_shader" );
 }
 
+bool EnvironmentCore::supportsBufferStorage() const
+{
+	static bool result = ogl_IsVersionGEQ( 4, 4 ) || isExtensionAvailable( "GL_ARB_buffer_storage" );
+	return result;
+}
+
 GLenum EnvironmentCore::getPreferredIndexType() const
 {
 	return GL_UNSIGNED_INT;
@@ -90,6 +90,7 @@ class EnvironmentEs : public Environment {
 	bool	supportsTextureLod() const override;
 	bool	supportsGeometryShader() const override;
 	bool	supportsTessellationShader() const override;	
+	bool	supportsBufferStorage() const override;
 
 	GLenum	getPreferredIndexType() const override;
 		
@@ -228,6 +229,12 @@ bool EnvironmentEs::supportsTessellationShader() const
 	return result;
 }
 
+bool EnvironmentEs::supportsBufferStorage() const
+{
+	// GL_EXT_buffer_storage is rare on ES, and streaming falls back to orphaning without it
+	return false;
+}
+
 GLenum EnvironmentEs::getPreferredIndexType() const
 {
 #if defined( CINDER_GL_ES_2 )
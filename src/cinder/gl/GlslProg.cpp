@@ -27,12 +27,20 @@
 #include "cinder/gl/ConstantConversions.h"
 #include "cinder/gl/Environment.h"
 #include "cinder/gl/scoped.h"
+#include "cinder/gl/Ubo.h"
+#include "cinder/app/AppBase.h"
 #include "cinder/Log.h"
 #include "cinder/Noncopyable.h"
+#include "cinder/Thread.h"
+#include "cinder/Timer.h"
 #include "cinder/Utilities.h"
 
 #include "glm/gtc/type_ptr.hpp"
 
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
 #include <type_traits>
 
 // For stoi and std:;to_string
@@ -98,6 +106,135 @@ class UniformValueCache : cinder::Noncopyable {
 	std::unique_ptr<bool[]>			mValidBytes;
 	uint32_t						mBufferSize;
 };
+
+// Uniform values that have been set since the last GlslProg::flushUniforms(), see GlslProg::Format::uniformStaging()
+class UniformStaging : cinder::Noncopyable {
+  public:
+	// one per active uniform, parallel to GlslProg::mUniforms
+	struct Entry {
+		uint32_t	mOffset;		// into mData
+		uint32_t	mElementSize;
+		int			mCount;
+		int			mDirtyBegin, mDirtyEnd; // range of array elements changed since the last flush
+	};
+
+	void stage( size_t index, int arrayIndex, int count, const void *data, size_t elementSize )
+	{
+		Entry &entry = mEntries[index];
+		CI_ASSERT( elementSize == entry.mElementSize );
+		count = std::min( count, entry.mCount - arrayIndex );
+		if( arrayIndex < 0 || count <= 0 )
+			return;
+
+		memcpy( mData.data() + entry.mOffset + arrayIndex * entry.mElementSize, data, count * entry.mElementSize );
+		if( entry.mDirtyBegin == entry.mDirtyEnd ) {
+			mDirtyEntries.push_back( (uint32_t)index );
+			entry.mDirtyBegin = arrayIndex;
+			entry.mDirtyEnd = arrayIndex + count;
+		}
+		else {
+			entry.mDirtyBegin = std::min( entry.mDirtyBegin, arrayIndex );
+			entry.mDirtyEnd = std::max( entry.mDirtyEnd, arrayIndex + count );
+		}
+	}
+
+	std::vector<Entry>		mEntries;
+	std::vector<uint8_t>	mData; // in the layout glUniform*v() expects
+	std::vector<uint32_t>	mDirtyEntries;
+
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	// the CPU copy of a buffer-backed uniform block, see GlslProg::Format::uniformBufferBacking()
+	struct Block {
+		UboRef					mUbo;
+		std::vector<uint8_t>	mData;
+		GLuint					mBinding;
+		size_t					mDirtyBegin, mDirtyEnd; // byte range changed since the last flush
+	};
+
+	struct BlockMember {
+		std::string		mName; // without the "[0]" suffix of arrays
+		GLenum			mType;
+		GLint			mCount, mOffset, mArrayStride, mMatrixStride;
+		bool			mRowMajor; // matrices declared layout(row_major) store each row at mMatrixStride
+		size_t			mBlock;
+	};
+
+	// copies \a size bytes to \a offset in \a block and extends its dirty range, unless they haven't changed
+	static void write( Block *block, size_t offset, const void *data, size_t size )
+	{
+		if( offset + size > block->mData.size() || memcmp( block->mData.data() + offset, data, size ) == 0 )
+			return;
+
+		memcpy( block->mData.data() + offset, data, size );
+		block->mDirtyBegin = std::min( block->mDirtyBegin, offset );
+		block->mDirtyEnd = std::max( block->mDirtyEnd, offset + size );
+	}
+
+	std::vector<Block>			mBlocks; // parallel to GlslProg::mUniformBlocks
+	std::vector<BlockMember>	mBlockMembers;
+#endif
+};
+
+namespace {
+
+// Uploads staged uniform values, which are stored in the layout of the glUniform*v() variant matching \a type
+void uniformStaged( GLenum type, GLint location, GLsizei count, const uint8_t *data )
+{
+	switch( type ) {
+		case GL_FLOAT:				glUniform1fv( location, count, (const GLfloat*)data ); break;
+		case GL_FLOAT_VEC2:			glUniform2fv( location, count, (const GLfloat*)data ); break;
+		case GL_FLOAT_VEC3:			glUniform3fv( location, count, (const GLfloat*)data ); break;
+		case GL_FLOAT_VEC4:			glUniform4fv( location, count, (const GLfloat*)data ); break;
+		case GL_FLOAT_MAT2:			glUniformMatrix2fv( location, count, GL_FALSE, (const GLfloat*)data ); break;
+		case GL_FLOAT_MAT3:			glUniformMatrix3fv( location, count, GL_FALSE, (const GLfloat*)data ); break;
+		case GL_FLOAT_MAT4:			glUniformMatrix4fv( location, count, GL_FALSE, (const GLfloat*)data ); break;
+		case GL_INT_VEC2:			glUniform2iv( location, count, (const GLint*)data ); break;
+		case GL_INT_VEC3:			glUniform3iv( location, count, (const GLint*)data ); break;
+		case GL_INT_VEC4:			glUniform4iv( location, count, (const GLint*)data ); break;
+#if ! defined( CINDER_GL_ES_2 )
+		case GL_UNSIGNED_INT:		glUniform1uiv( location, count, (const GLuint*)data ); break;
+		case GL_UNSIGNED_INT_VEC2:	glUniform2uiv( location, count, (const GLuint*)data ); break;
+		case GL_UNSIGNED_INT_VEC3:	glUniform3uiv( location, count, (const GLuint*)data ); break;
+		case GL_UNSIGNED_INT_VEC4:	glUniform4uiv( location, count, (const GLuint*)data ); break;
+#endif
+		// GL_INT, GL_BOOL and the samplers
+		default:					glUniform1iv( location, count, (const GLint*)data ); break;
+	}
+}
+
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+
+// Block members are laid out as std140 or shared describes them; the offsets and strides are queried from GL
+template<typename T>
+void writeBlockValue( UniformStaging::Block *block, size_t offset, const UniformStaging::BlockMember &/*member*/, const T &value )
+{
+	UniformStaging::write( block, offset, &value, sizeof( T ) );
+}
+
+// bools occupy 4 bytes in a uniform block
+void writeBlockValue( UniformStaging::Block *block, size_t offset, const UniformStaging::BlockMember &/*member*/, const bool &value )
+{
+	const uint32_t converted = value ? 1 : 0;
+	UniformStaging::write( block, offset, &converted, sizeof( converted ) );
+}
+
+// glm matrices are column-major, so a row_major member is written as the columns of the transpose
+template<typename MatT>
+void writeBlockMatrix( UniformStaging::Block *block, size_t offset, const UniformStaging::BlockMember &member, const MatT &value )
+{
+	const MatT stored = member.mRowMajor ? glm::transpose( value ) : value;
+	const size_t numColumns = sizeof( MatT ) / sizeof( stored[0] );
+	for( size_t c = 0; c < numColumns; ++c )
+		UniformStaging::write( block, offset + c * member.mMatrixStride, &stored[c], sizeof( stored[c] ) );
+}
+
+void writeBlockValue( UniformStaging::Block *block, size_t offset, const UniformStaging::BlockMember &member, const mat2 &value )	{ writeBlockMatrix( block, offset, member, value ); }
+void writeBlockValue( UniformStaging::Block *block, size_t offset, const UniformStaging::BlockMember &member, const mat3 &value )	{ writeBlockMatrix( block, offset, member, value ); }
+void writeBlockValue( UniformStaging::Block *block, size_t offset, const UniformStaging::BlockMember &member, const mat4 &value )	{ writeBlockMatrix( block, offset, member, value ); }
+
+#endif // defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+
+} // anonymous namespace
 	
 //////////////////////////////////////////////////////////////////////////
 // GlslProg::Attribute
@@ -490,19 +627,22 @@ GlslProg::GlslProg( const Format &format )
 		, mTransformFeedbackFormat( -1 )
 #endif
 {
+	Timer timer( true );
 	mHandle = glCreateProgram();
 
-	GLuint vertexHandle = loadShader( format.getVertex(), format.mVertexShaderPath, GL_VERTEX_SHADER, format.getPreprocessor() );
-	GLuint fragmentHandle = loadShader( format.getFragment(), format.mFragmentShaderPath, GL_FRAGMENT_SHADER, format.getPreprocessor() );
+	// preprocess every stage up front, the binary cache is keyed by the preprocessed sources
+	vector<pair<GLint,string>> shaderSources;
+	shaderSources.push_back( make_pair( GL_VERTEX_SHADER, preprocessShader( format.getVertex(), format.mVertexShaderPath, format.getPreprocessor() ) ) );
+	shaderSources.push_back( make_pair( GL_FRAGMENT_SHADER, preprocessShader( format.getFragment(), format.mFragmentShaderPath, format.getPreprocessor() ) ) );
 #if defined( CINDER_GL_HAS_GEOM_SHADER )
-	GLuint geometryHandle = loadShader( format.getGeometry(), format.mGeometryShaderPath, GL_GEOMETRY_SHADER, format.getPreprocessor() );
+	shaderSources.push_back( make_pair( GL_GEOMETRY_SHADER, preprocessShader( format.getGeometry(), format.mGeometryShaderPath, format.getPreprocessor() ) ) );
 #endif
 #if defined( CINDER_GL_HAS_TESS_SHADER )
-	GLuint tessellationCtrlHandle = loadShader( format.getTessellationCtrl(), format.mTessellationCtrlShaderPath, GL_TESS_CONTROL_SHADER, format.getPreprocessor() );
-	GLuint tessellationEvalHandle = loadShader( format.getTessellationEval(), format.mTessellationEvalShaderPath, GL_TESS_EVALUATION_SHADER, format.getPreprocessor() );
+	shaderSources.push_back( make_pair( GL_TESS_CONTROL_SHADER, preprocessShader( format.getTessellationCtrl(), format.mTessellationCtrlShaderPath, format.getPreprocessor() ) ) );
+	shaderSources.push_back( make_pair( GL_TESS_EVALUATION_SHADER, preprocessShader( format.getTessellationEval(), format.mTessellationEvalShaderPath, format.getPreprocessor() ) ) );
 #endif
 #if defined( CINDER_GL_HAS_COMPUTE_SHADER )
-	GLuint computeHandle = loadShader( format.getCompute(), format.mComputeShaderPath, GL_COMPUTE_SHADER, format.getPreprocessor() );
+	shaderSources.push_back( make_pair( GL_COMPUTE_SHADER, preprocessShader( format.getCompute(), format.mComputeShaderPath, format.getPreprocessor() ) ) );
 #endif
 
 	auto &userDefinedAttribs = format.getAttributes();
@@ -564,27 +704,38 @@ GlslProg::GlslProg( const Format &format )
 		glBindFragDataLocation( mHandle, fragDataLocation.second, fragDataLocation.first.c_str() );
 #endif
 
-	link();
-
-	// Detach all shaders, allowing GL to free the associated memory
-	if( vertexHandle )
-		glDetachShader( mHandle, vertexHandle );
-	if( fragmentHandle )
-		glDetachShader( mHandle, fragmentHandle );
-#if defined( CINDER_GL_HAS_GEOM_SHADER )
-	if( geometryHandle )
-		glDetachShader( mHandle, geometryHandle );
+	// the attribute, varying and fragment data bindings above are part of a program binary
+	bool loadedBinary = false;
+#if defined( CINDER_GL_HAS_PROGRAM_BINARY )
+	const fs::path binaryPath = format.isBinaryCacheEnabled() ? getProgramBinaryPath( format, shaderSources ) : fs::path();
+	if( ! binaryPath.empty() )
+		loadedBinary = loadProgramBinary( binaryPath );
 #endif
-#if defined( CINDER_GL_HAS_TESS_SHADER )
-	if( tessellationCtrlHandle )
-		glDetachShader( mHandle, tessellationCtrlHandle );
-	if( tessellationEvalHandle )
-		glDetachShader( mHandle, tessellationEvalHandle );
+
+	if( ! loadedBinary ) {
+		vector<GLuint> shaderHandles;
+		for( const auto &shaderSource : shaderSources )
+			shaderHandles.push_back( loadShader( shaderSource.second, shaderSource.first ) );
+
+#if defined( CINDER_GL_HAS_PROGRAM_BINARY )
+		if( ! binaryPath.empty() )
+			glProgramParameteri( mHandle, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE );
 #endif
-#if defined( CINDER_GL_HAS_COMPUTE_SHADER )
-	if( computeHandle )
-		glDetachShader( mHandle, computeHandle );	
+		link();
+
+		// Detach all shaders, allowing GL to free the associated memory
+		for( GLuint shaderHandle : shaderHandles ) {
+			if( shaderHandle )
+				glDetachShader( mHandle, shaderHandle );
+		}
+
+#if defined( CINDER_GL_HAS_PROGRAM_BINARY )
+		if( ! binaryPath.empty() )
+			storeProgramBinary( binaryPath );
 #endif
+	}
+
+	recordCreateTime( loadedBinary, timer.getSeconds() );
 	
 	cacheActiveAttribs();
 	cacheActiveUniforms();
@@ -596,6 +747,8 @@ GlslProg::GlslProg( const Format &format )
 #if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
 	cacheActiveUniformBlocks();
 #endif
+	if( format.isUniformStagingEnabled() )
+		setupUniformStaging( format );
 
 	auto & userDefinedUniforms = format.getUniforms();
 	// check if the user thinks there's a uniform that isn't active
@@ -691,26 +844,26 @@ GlslProg::AttribSemanticMap& GlslProg::getDefaultAttribNameToSemanticMap()
 	return sDefaultAttribNameToSemanticMap;
 }
 
-GLuint GlslProg::loadShader( const string &shaderSource, const fs::path &shaderPath, GLint shaderType, const ShaderPreprocessorRef &preprocessor )
+string GlslProg::preprocessShader( const string &shaderSource, const fs::path &shaderPath, const ShaderPreprocessorRef &preprocessor )
+{
+	if( shaderSource.empty() || ! preprocessor )
+		return shaderSource;
+
+	set<fs::path> includedFiles;
+	string preprocessedSource = preprocessor->parse( shaderSource, shaderPath, &includedFiles );
+	mShaderPreprocessorIncludedFiles.insert( mShaderPreprocessorIncludedFiles.end(), includedFiles.begin(), includedFiles.end() );
+	return preprocessedSource;
+}
+
+GLuint GlslProg::loadShader( const string &shaderSource, GLint shaderType )
 {
 	GLuint handle = 0;
 
 	if( ! shaderSource.empty() ) {
 		handle = glCreateShader( shaderType );
 
-		if( preprocessor ) {
-			set<fs::path> includedFiles;
-			string preprocessedSource = preprocessor->parse( shaderSource, shaderPath, &includedFiles );
-			mShaderPreprocessorIncludedFiles.insert( mShaderPreprocessorIncludedFiles.end(), includedFiles.begin(), includedFiles.end() );
-
-			const char *cStr = preprocessedSource.c_str();
-			glShaderSource( handle, 1, reinterpret_cast<const GLchar**>( &cStr ), NULL );
-		}
-		else {
-			const char *cStr = shaderSource.c_str();
-			glShaderSource( handle, 1, reinterpret_cast<const GLchar**>( &cStr ), NULL );
-		}
-
+		const char *cStr = shaderSource.c_str();
+		glShaderSource( handle, 1, reinterpret_cast<const GLchar**>( &cStr ), NULL );
 		glCompileShader( handle );
 
 		GLint status;
@@ -771,6 +924,322 @@ void GlslProg::link()
 	}
 }
 	
+//////////////////////////////////////////////////////////////////////////
+// Program binary cache and creation stats
+
+namespace {
+
+std::mutex				sCreateMutex;
+fs::path				sBinaryCacheDirectory;
+GlslProg::CreateStats	sCreateStats;
+
+const uint32_t PROGRAM_BINARY_MAGIC		= 0x42504943; // "CIPB"
+const uint32_t PROGRAM_BINARY_VERSION	= 1;
+
+// 64-bit FNV-1a
+void hashBytes( uint64_t *hash, const void *data, size_t size )
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t*>( data );
+	for( size_t i = 0; i < size; ++i ) {
+		*hash ^= bytes[i];
+		*hash *= 1099511628211ULL;
+	}
+}
+
+void hashValue( uint64_t *hash, int64_t value )
+{
+	hashBytes( hash, &value, sizeof( value ) );
+}
+
+// the length keeps consecutive strings from running together
+void hashString( uint64_t *hash, const string &str )
+{
+	hashValue( hash, (int64_t)str.size() );
+	hashBytes( hash, str.data(), str.size() );
+}
+
+void hashGlString( uint64_t *hash, GLenum name )
+{
+	const GLubyte *str = glGetString( name );
+	hashString( hash, str ? string( reinterpret_cast<const char*>( str ) ) : string() );
+}
+
+} // anonymous namespace
+
+#if defined( CINDER_GL_HAS_PROGRAM_BINARY )
+
+fs::path GlslProg::getProgramBinaryPath( const Format &format, const vector<pair<GLint,string>> &shaderSources )
+{
+	const fs::path directory = getBinaryCacheDirectory();
+	if( directory.empty() )
+		return fs::path();
+
+#if ! defined( CINDER_GL_ES )
+	if( ! glProgramBinary || ! glGetProgramBinary || ! glProgramParameteri )
+		return fs::path();
+#endif
+	GLint numBinaryFormats = 0;
+	glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats );
+	if( numBinaryFormats <= 0 )
+		return fs::path();
+
+	uint64_t hash = 14695981039346656037ULL;
+	for( const auto &shaderSource : shaderSources ) {
+		hashValue( &hash, shaderSource.first );
+		hashString( &hash, shaderSource.second );
+	}
+	// the preprocessor has applied these to the sources already; hashing them keeps variants apart regardless
+	for( const auto &define : format.getDefines() ) {
+		hashString( &hash, define.first );
+		hashString( &hash, define.second );
+	}
+	hashValue( &hash, format.getVersion() );
+	for( const auto &attrib : format.getAttributes() ) {
+		hashString( &hash, attrib.getName() );
+		hashValue( &hash, (int64_t)attrib.getSemantic() );
+		hashValue( &hash, attrib.getLocation() );
+	}
+#if defined( CINDER_GL_HAS_TRANSFORM_FEEDBACK )
+	for( const auto &varying : format.getVaryings() )
+		hashString( &hash, varying );
+	hashValue( &hash, format.getTransformFormat() );
+#endif
+#if ! defined( CINDER_GL_ES )
+	for( const auto &fragDataLocation : format.getFragDataLocations() ) {
+		hashString( &hash, fragDataLocation.first );
+		hashValue( &hash, fragDataLocation.second );
+	}
+#endif
+	// a binary is only valid for the driver that produced it
+	hashGlString( &hash, GL_VENDOR );
+	hashGlString( &hash, GL_RENDERER );
+	hashGlString( &hash, GL_VERSION );
+
+	char name[32];
+	snprintf( name, sizeof( name ), "%016llx.bin", (unsigned long long)hash );
+	return directory / name;
+}
+
+bool GlslProg::loadProgramBinary( const fs::path &path )
+{
+	ifstream stream( path.string().c_str(), ios::binary );
+	if( ! stream )
+		return false;
+
+	uint32_t header[4] = {}; // magic, version, binary format, binary size
+	if( ! stream.read( reinterpret_cast<char*>( header ), sizeof( header ) ) || header[0] != PROGRAM_BINARY_MAGIC || header[1] != PROGRAM_BINARY_VERSION )
+		return false;
+
+	// the size comes from the file, so check it against what the file actually holds before allocating
+	const streamoff binaryStart = stream.tellg();
+	if( ! stream.seekg( 0, ios::end ) )
+		return false;
+	const streamoff fileSize = stream.tellg();
+	if( binaryStart < 0 || header[3] == 0 || header[3] > (uint64_t)std::numeric_limits<GLsizei>::max() || fileSize - binaryStart != (streamoff)header[3] ) {
+		CI_LOG_W( "Ignoring corrupt program binary " << path );
+		return false;
+	}
+	stream.seekg( binaryStart );
+
+	vector<char> binary( header[3] );
+	if( ! stream.read( binary.data(), binary.size() ) )
+		return false;
+
+	glProgramBinary( mHandle, header[2], binary.data(), (GLsizei)binary.size() );
+	GLint status = GL_FALSE;
+	glGetProgramiv( mHandle, GL_LINK_STATUS, &status );
+	if( status != GL_TRUE ) {
+		// the driver may still reject a binary after an update that kept its version string, so recompile
+		CI_LOG_I( "Driver rejected cached program binary " << path << ", recompiling" );
+		return false;
+	}
+
+	return true;
+}
+
+void GlslProg::storeProgramBinary( const fs::path &path ) const
+{
+	GLint size = 0;
+	glGetProgramiv( mHandle, GL_PROGRAM_BINARY_LENGTH, &size );
+	if( size <= 0 )
+		return;
+
+	vector<char> binary( size );
+	GLenum binaryFormat = 0;
+	GLsizei length = 0;
+	glGetProgramBinary( mHandle, size, &length, &binaryFormat, binary.data() );
+	if( length <= 0 )
+		return;
+
+	try {
+		fs::create_directories( path.parent_path() );
+
+		// written under a unique name and renamed, so that concurrent writers never produce a partial file
+		const fs::path tempPath = path.string() + "." + to_string( std::hash<std::thread::id>()( std::this_thread::get_id() ) ) + ".tmp";
+		{
+			ofstream stream( tempPath.string().c_str(), ios::binary | ios::trunc );
+			const uint32_t header[4] = { PROGRAM_BINARY_MAGIC, PROGRAM_BINARY_VERSION, binaryFormat, (uint32_t)length };
+			stream.write( reinterpret_cast<const char*>( header ), sizeof( header ) );
+			stream.write( binary.data(), length );
+			if( ! stream ) {
+				CI_LOG_W( "Failed to write program binary " << tempPath );
+				return;
+			}
+		}
+		fs::rename( tempPath, path );
+	}
+	catch( const fs::filesystem_error &exc ) {
+		CI_LOG_EXCEPTION( "Failed to store program binary " << path, exc );
+	}
+}
+
+#endif // defined( CINDER_GL_HAS_PROGRAM_BINARY )
+
+void GlslProg::recordCreateTime( bool loadedFromCache, double seconds )
+{
+	lock_guard<mutex> lock( sCreateMutex );
+	if( loadedFromCache ) {
+		sCreateStats.mNumLoadedFromCache++;
+		sCreateStats.mLoadSeconds += seconds;
+	}
+	else {
+		sCreateStats.mNumCompiled++;
+		sCreateStats.mCompileSeconds += seconds;
+	}
+}
+
+GlslProg::CreateStats GlslProg::getCreateStats()
+{
+	lock_guard<mutex> lock( sCreateMutex );
+	return sCreateStats;
+}
+
+void GlslProg::resetCreateStats()
+{
+	lock_guard<mutex> lock( sCreateMutex );
+	sCreateStats = CreateStats();
+}
+
+void GlslProg::setBinaryCacheDirectory( const fs::path &directory )
+{
+	lock_guard<mutex> lock( sCreateMutex );
+	sBinaryCacheDirectory = directory;
+}
+
+fs::path GlslProg::getBinaryCacheDirectory()
+{
+	lock_guard<mutex> lock( sCreateMutex );
+	return sBinaryCacheDirectory;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Asynchronous creation
+
+namespace {
+
+// Creates GlslProgs in order on a thread with its own gl::Context, shared with the Context current when the worker was started
+class GlslProgWorker : private Noncopyable {
+  public:
+	GlslProgWorker()
+		: mQuit( false )
+	{
+		auto context = gl::Context::create( gl::context() );
+		mThread = thread( bind( &GlslProgWorker::threadFn, this, context ) );
+
+		// the shared context has to go away before the app tears down the platform
+		if( app::AppBase::get() )
+			mConnectionCleanup = app::AppBase::get()->getSignalCleanup().connect( bind( &GlslProgWorker::stop, this ) );
+	}
+
+	~GlslProgWorker()
+	{
+		mConnectionCleanup.disconnect();
+		stop();
+	}
+
+	future<GlslProgRef> create( const GlslProg::Format &format )
+	{
+		Request request;
+		request.mFormat = format;
+		auto result = request.mPromise.get_future();
+		{
+			lock_guard<mutex> lock( mMutex );
+			if( mQuit )
+				throw GlslProgExc( "GlslProg::createAsync() called after the worker thread has stopped" );
+			mRequests.push_back( std::move( request ) );
+		}
+		mCondition.notify_one();
+		return result;
+	}
+
+	void stop()
+	{
+		{
+			lock_guard<mutex> lock( mMutex );
+			mQuit = true;
+		}
+		mCondition.notify_one();
+		if( mThread.joinable() )
+			mThread.join();
+	}
+
+  private:
+	struct Request {
+		GlslProg::Format			mFormat;
+		promise<GlslProgRef>		mPromise;
+	};
+
+	void threadFn( ContextRef context )
+	{
+		ThreadSetup threadSetup;
+		context->makeCurrent();
+
+		while( true ) {
+			Request request;
+			{
+				unique_lock<mutex> lock( mMutex );
+				mCondition.wait( lock, [this] { return mQuit || ! mRequests.empty(); } );
+				// pending requests are still serviced, their futures may be waited on
+				if( mRequests.empty() )
+					break;
+				request = std::move( mRequests.front() );
+				mRequests.pop_front();
+			}
+
+			try {
+				auto glslProg = GlslProg::create( request.mFormat );
+				// the program has to be complete before another context uses it
+				glFinish();
+				request.mPromise.set_value( glslProg );
+			}
+			catch( ... ) {
+				request.mPromise.set_exception( current_exception() );
+			}
+		}
+	}
+
+	thread					mThread;
+	mutex					mMutex;
+	condition_variable		mCondition;
+	deque<Request>			mRequests;
+	bool					mQuit;
+	signals::Connection		mConnectionCleanup;
+};
+
+std::mutex						sWorkerMutex;
+unique_ptr<GlslProgWorker>		sWorker;
+
+} // anonymous namespace
+
+future<GlslProgRef> GlslProg::createAsync( const Format &format )
+{
+	lock_guard<mutex> lock( sWorkerMutex );
+	if( ! sWorker )
+		sWorker.reset( new GlslProgWorker );
+
+	return sWorker->create( format );
+}
+
 void GlslProg::cacheActiveAttribs()
 {
 	GLint numActiveAttrs = 0;
@@ -850,6 +1319,64 @@ void GlslProg::cacheActiveUniforms()
 #endif
 }
 
+void GlslProg::setupUniformStaging( const Format &format )
+{
+	mUniformStaging = unique_ptr<UniformStaging>( new UniformStaging );
+
+	uint32_t dataSize = 0;
+	for( const auto &uniform : mUniforms ) {
+		UniformStaging::Entry entry;
+		entry.mOffset = dataSize;
+		// bools are staged as the GLint glUniform1iv() expects
+		entry.mElementSize = ( uniform.mType == GL_BOOL ) ? sizeof( GLint ) : uniform.mTypeSize;
+		entry.mCount = uniform.mCount;
+		entry.mDirtyBegin = entry.mDirtyEnd = 0;
+		mUniformStaging->mEntries.push_back( entry );
+		dataSize += entry.mElementSize * entry.mCount;
+	}
+	mUniformStaging->mData.resize( dataSize );
+
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	if( ! format.isUniformBufferBackingEnabled() )
+		return;
+
+	GLuint binding = format.getUniformBufferBackingBinding();
+	for( auto &uniformBlock : mUniformBlocks ) {
+		UniformStaging::Block block;
+		block.mData.resize( uniformBlock.mDataSize, 0 );
+		block.mUbo = Ubo::create( uniformBlock.mDataSize, block.mData.data(), GL_DYNAMIC_DRAW );
+		block.mDirtyBegin = block.mData.size();
+		block.mDirtyEnd = 0;
+		// every backed block needs its own binding, as each one has its own Ubo
+		block.mBinding = binding++;
+		uniformBlock.mBlockBinding = block.mBinding;
+		glUniformBlockBinding( mHandle, uniformBlock.mLoc, block.mBinding );
+
+		const auto &offsets = uniformBlock.mActiveUniformInfo[GL_UNIFORM_OFFSET];
+		const auto &arrayStrides = uniformBlock.mActiveUniformInfo[GL_UNIFORM_ARRAY_STRIDE];
+		const auto &matrixStrides = uniformBlock.mActiveUniformInfo[GL_UNIFORM_MATRIX_STRIDE];
+		const auto &rowMajors = uniformBlock.mActiveUniformInfo[GL_UNIFORM_IS_ROW_MAJOR];
+		for( size_t i = 0; i < uniformBlock.mActiveUniforms.size(); ++i ) {
+			const auto &uniform = uniformBlock.mActiveUniforms[i];
+			UniformStaging::BlockMember member;
+			member.mName = uniform.mName;
+			if( member.mName.size() > 3 && member.mName.compare( member.mName.size() - 3, 3, "[0]" ) == 0 )
+				member.mName.resize( member.mName.size() - 3 );
+			member.mType = uniform.mType;
+			member.mCount = uniform.mCount;
+			member.mOffset = offsets[i];
+			member.mArrayStride = arrayStrides[i];
+			member.mMatrixStride = matrixStrides[i];
+			member.mRowMajor = rowMajors[i] != 0;
+			member.mBlock = mUniformStaging->mBlocks.size();
+			mUniformStaging->mBlockMembers.push_back( member );
+		}
+
+		mUniformStaging->mBlocks.push_back( std::move( block ) );
+	}
+#endif
+}
+
 #if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
 void GlslProg::cacheActiveUniformBlocks()
 {
@@ -928,10 +1455,17 @@ void GlslProg::cacheActiveUniformBlocks()
 							  unSignedIndices.data(),
 							  GL_UNIFORM_MATRIX_STRIDE,
 							  uniformMatrixStride.data() );
+		std::vector<GLint> uniformIsRowMajor( numActiveUniforms );
+		glGetActiveUniformsiv( mHandle,
+							  numActiveUniforms,
+							  unSignedIndices.data(),
+							  GL_UNIFORM_IS_ROW_MAJOR,
+							  uniformIsRowMajor.data() );
 		
 		uniformBlock.mActiveUniformInfo.insert( make_pair( GL_UNIFORM_OFFSET, uniformOffset ) );
 		uniformBlock.mActiveUniformInfo.insert( make_pair( GL_UNIFORM_ARRAY_STRIDE, uniformArrayStride ) );
 		uniformBlock.mActiveUniformInfo.insert( make_pair( GL_UNIFORM_MATRIX_STRIDE, uniformMatrixStride ) );
+		uniformBlock.mActiveUniformInfo.insert( make_pair( GL_UNIFORM_IS_ROW_MAJOR, uniformIsRowMajor ) );
 		
 		mUniformBlocks.push_back( uniformBlock );
 	}
@@ -977,6 +1511,40 @@ void GlslProg::bind() const
 void GlslProg::bindImpl() const
 {
 	glUseProgram( mHandle );
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	if( mUniformStaging ) {
+		for( const auto &block : mUniformStaging->mBlocks )
+			gl::context()->bindBufferBase( GL_UNIFORM_BUFFER, block.mBinding, block.mUbo );
+	}
+#endif
+}
+
+void GlslProg::flushUniforms() const
+{
+	if( ! mUniformStaging )
+		return;
+
+	auto &staging = *mUniformStaging;
+	if( ! staging.mDirtyEntries.empty() ) {
+		ScopedGlslProg shaderBind( this );
+		for( uint32_t index : staging.mDirtyEntries ) {
+			auto &entry = staging.mEntries[index];
+			const auto &uniform = mUniforms[index];
+			uniformStaged( uniform.mType, uniform.mLoc + entry.mDirtyBegin, entry.mDirtyEnd - entry.mDirtyBegin, staging.mData.data() + entry.mOffset + entry.mDirtyBegin * entry.mElementSize );
+			entry.mDirtyBegin = entry.mDirtyEnd = 0;
+		}
+		staging.mDirtyEntries.clear();
+	}
+
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	for( auto &block : staging.mBlocks ) {
+		if( block.mDirtyBegin < block.mDirtyEnd ) {
+			block.mUbo->bufferSubData( block.mDirtyBegin, block.mDirtyEnd - block.mDirtyBegin, block.mData.data() + block.mDirtyBegin );
+			block.mDirtyBegin = block.mData.size();
+			block.mDirtyEnd = 0;
+		}
+	}
+#endif
 }
 
 std::string GlslProg::getShaderLog( GLuint handle ) const
@@ -1178,6 +1746,78 @@ const GlslProg::Uniform* GlslProg::findUniform( int location, int *resultLocatio
 	
 	return ret;
 }
+
+const GlslProg::Uniform* GlslProg::findUniform( const UniformHandle &handle, int *resultLocation ) const
+{
+	CI_ASSERT_MSG( handle.mProgram == mHandle || ! handle.isValid(), "UniformHandle belongs to another GlslProg" );
+	if( handle.mUniform < 0 || handle.mUniform >= (int)mUniforms.size() )
+		return nullptr;
+
+	if( resultLocation )
+		*resultLocation = handle.mLocation;
+	return &mUniforms[handle.mUniform];
+}
+
+int GlslProg::findBlockMember( const std::string &name, int *arrayIndex ) const
+{
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	if( ! mUniformStaging )
+		return -1;
+
+	const auto &members = mUniformStaging->mBlockMembers;
+	for( size_t i = 0; i < members.size(); ++i ) {
+		const auto &memberName = members[i].mName;
+		if( name == memberName ) {
+			*arrayIndex = 0;
+			return (int)i;
+		}
+		// "example[2]" addresses the third element of the member "example"
+		if( name.size() > memberName.size() + 2 && name.compare( 0, memberName.size(), memberName ) == 0 && name[memberName.size()] == '[' && name.back() == ']' ) {
+			try {
+				*arrayIndex = stoi( name.substr( memberName.size() + 1, name.size() - memberName.size() - 2 ) );
+			}
+			catch( std::logic_error & ) {
+				return -1;
+			}
+			return ( *arrayIndex >= 0 && *arrayIndex < members[i].mCount ) ? (int)i : -1;
+		}
+	}
+#endif
+	return -1;
+}
+
+int GlslProg::findBlockMember( const UniformHandle &handle, int *arrayIndex ) const
+{
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	if( mUniformStaging && handle.mBlockMember >= 0 && handle.mBlockMember < (int)mUniformStaging->mBlockMembers.size() ) {
+		*arrayIndex = handle.mArrayIndex;
+		return handle.mBlockMember;
+	}
+#endif
+	return -1;
+}
+
+GlslProg::UniformHandle GlslProg::getUniformHandle( const std::string &name ) const
+{
+	UniformHandle result;
+	result.mProgram = mHandle;
+
+	int location = -1;
+	auto found = findUniform( name, &location );
+	if( found ) {
+		result.mUniform = int( found - mUniforms.data() );
+		result.mLocation = location;
+	}
+	else {
+		int arrayIndex = 0;
+		result.mBlockMember = findBlockMember( name, &arrayIndex );
+		result.mArrayIndex = arrayIndex;
+		if( result.mBlockMember < 0 )
+			logMissingUniform( name );
+	}
+
+	return result;
+}
     
 bool GlslProg::hasAttribSemantic( geom::Attrib semantic ) const
 {
@@ -1248,6 +1888,13 @@ void GlslProg::uniformBlock( int loc, int binding ) const
 		if( found->mBlockBinding != binding ) {
 			found->mBlockBinding = binding;
 			glUniformBlockBinding( mHandle, found->mLoc, binding );
+			// a buffer-backed block brings its Ubo along to the new binding
+			if( mUniformStaging && ! mUniformStaging->mBlocks.empty() ) {
+				auto &block = mUniformStaging->mBlocks[found - mUniformBlocks.begin()];
+				block.mBinding = binding;
+				if( gl::context()->getGlslProg() == this )
+					gl::context()->bindBufferBase( GL_UNIFORM_BUFFER, binding, block.mUbo );
+			}
 		}
 	}
 	else {
@@ -1258,15 +1905,10 @@ void GlslProg::uniformBlock( int loc, int binding ) const
 void GlslProg::uniformBlock( const std::string &name, GLint binding ) const
 {
 	auto found = findUniformBlock( name );
-	if( found ) {
-		if( found->mBlockBinding != binding ) {
-			found->mBlockBinding = binding;
-			glUniformBlockBinding( mHandle, found->mLoc, binding );
-		}
-	}
-	else {
+	if( found )
+		uniformBlock( found->mLoc, binding );
+	else
 		CI_LOG_W( "Uniform block \"" << name << "\" not found" );
-	}
 }
 
 GLint GlslProg::getUniformBlockLocation( const std::string &name ) const
@@ -1326,29 +1968,84 @@ bool GlslProg::checkUniformValueCache( const Uniform &uniform, int location, con
 		return true;
 }
 	
+template<typename T>
+bool GlslProg::stageUniform( const Uniform &uniform, int location, const T *data, int count ) const
+{
+	if( ! mUniformStaging )
+		return false;
+
+	mUniformStaging->stage( size_t( &uniform - mUniforms.data() ), location - uniform.mLoc, count, data, sizeof( T ) );
+	return true;
+}
+
+// bools are staged as the GLint glUniform1iv() expects
+template<>
+bool GlslProg::stageUniform( const Uniform &uniform, int location, const bool *data, int count ) const
+{
+	if( ! mUniformStaging )
+		return false;
+
+	vector<GLint> converted( data, data + count );
+	mUniformStaging->stage( size_t( &uniform - mUniforms.data() ), location - uniform.mLoc, count, converted.data(), sizeof( GLint ) );
+	return true;
+}
+
+template<typename LookUp, typename T>
+bool GlslProg::uniformBlockMemberImpl( const LookUp &lookUp, const T *data, int count ) const
+{
+#if defined( CINDER_GL_HAS_UNIFORM_BLOCKS )
+	int arrayIndex = 0;
+	const int index = findBlockMember( lookUp, &arrayIndex );
+	if( index < 0 )
+		return false;
+
+	const auto &member = mUniformStaging->mBlockMembers[index];
+	if( ! checkUniformType<T>( member.mType ) ) {
+		logUniformWrongType( member.mName, member.mType, cppTypeToGlslTypeName<T>() );
+		return true;
+	}
+
+	auto &block = mUniformStaging->mBlocks[member.mBlock];
+	count = std::min( count, member.mCount - arrayIndex );
+	for( int i = 0; i < count; ++i )
+		writeBlockValue( &block, member.mOffset + ( arrayIndex + i ) * member.mArrayStride, member, data[i] );
+	return true;
+#else
+	return false;
+#endif
+}
+
 template<typename LookUp, typename T>
 inline void GlslProg::uniformImpl( const LookUp &lookUp, const T &data ) const
 {
 	int uniformLocation = -1;
 	auto found = findUniform( lookUp, &uniformLocation );
 	if( ! found ) {
-		logMissingUniform( lookUp );
+		if( ! uniformBlockMemberImpl( lookUp, &data, 1 ) )
+			logMissingUniform( lookUp );
 		return;
 	}
-	if( validateUniform( *found, uniformLocation, data ) )
+	if( validateUniform( *found, uniformLocation, data ) && ! stageUniform( *found, uniformLocation, &data, 1 ) )
 		uniformFunc( uniformLocation, data );
 }
 
 template<typename LookUp, typename T>
 inline void	GlslProg::uniformMatImpl( const LookUp &lookUp, const T &data, bool transpose ) const
 {
+	// staged matrices are uploaded untransposed
+	if( transpose && mUniformStaging ) {
+		uniformMatImpl( lookUp, glm::transpose( data ), false );
+		return;
+	}
+
 	int uniformLocation = -1;
 	auto found = findUniform( lookUp, &uniformLocation );
 	if( ! found ) {
-		logMissingUniform( lookUp );
+		if( ! uniformBlockMemberImpl( lookUp, &data, 1 ) )
+			logMissingUniform( lookUp );
 		return;
 	}
-	if( validateUniform( *found, uniformLocation, data ) )
+	if( validateUniform( *found, uniformLocation, data ) && ! stageUniform( *found, uniformLocation, &data, 1 ) )
 		uniformMatFunc( uniformLocation, data, transpose );
 }
 
@@ -1358,23 +2055,34 @@ inline void	GlslProg::uniformImpl( const LookUp &lookUp, const T *data, int coun
 	int uniformLocation = -1;
 	auto found = findUniform( lookUp, &uniformLocation );
 	if( ! found ) {
-		logMissingUniform( lookUp );
+		if( ! uniformBlockMemberImpl( lookUp, data, count ) )
+			logMissingUniform( lookUp );
 		return;
 	}
-	if( validateUniform( *found, uniformLocation, data, count ) )
+	if( validateUniform( *found, uniformLocation, data, count ) && ! stageUniform( *found, uniformLocation, data, count ) )
 		uniformFunc( uniformLocation, data, count );
 }
 
 template<typename LookUp, typename T>
 inline void	GlslProg::uniformMatImpl( const LookUp &lookUp, const T *data, int count, bool transpose ) const
 {
+	// staged matrices are uploaded untransposed
+	if( transpose && mUniformStaging ) {
+		vector<T> transposed( count );
+		for( int i = 0; i < count; ++i )
+			transposed[i] = glm::transpose( data[i] );
+		uniformMatImpl( lookUp, transposed.data(), count, false );
+		return;
+	}
+
 	int uniformLocation = -1;
 	auto found = findUniform( lookUp, &uniformLocation );
 	if( ! found ) {
-		logMissingUniform( lookUp );
+		if( ! uniformBlockMemberImpl( lookUp, data, count ) )
+			logMissingUniform( lookUp );
 		return;
 	}
-	if( validateUniform( *found, uniformLocation, data, count ) )
+	if( validateUniform( *found, uniformLocation, data, count ) && ! stageUniform( *found, uniformLocation, data, count ) )
 		uniformMatFunc( uniformLocation, data, count, transpose );
 }
 	
@@ -1971,6 +2679,139 @@ void GlslProg::uniformMatFunc( int location, const mat4 *data, int count, bool t
     glUniformMatrix4fv( location, count, ( transpose ) ? GL_TRUE : GL_FALSE, glm::value_ptr( *data ) );
 }
 
+// UniformHandle
+void GlslProg::uniform( const UniformHandle &handle, bool data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, int data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, float data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const vec2 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const vec3 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const vec4 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const ivec2 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const ivec3 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const ivec4 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+#if ! defined( CINDER_GL_ES_2 )
+void GlslProg::uniform( const UniformHandle &handle, uint32_t data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const uvec2 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const uvec3 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const uvec4 &data ) const
+{
+	uniformImpl( handle, data );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const uint32_t *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+#endif // ! defined( CINDER_GL_ES_2 )
+
+void GlslProg::uniform( const UniformHandle &handle, const mat2 &data, bool transpose ) const
+{
+	uniformMatImpl( handle, data, transpose );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const mat3 &data, bool transpose ) const
+{
+	uniformMatImpl( handle, data, transpose );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const mat4 &data, bool transpose ) const
+{
+	uniformMatImpl( handle, data, transpose );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const int *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const float *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const ivec2 *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const vec2 *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const vec3 *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const vec4 *data, int count ) const
+{
+	uniformImpl( handle, data, count );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const mat2 *data, int count, bool transpose ) const
+{
+	uniformMatImpl( handle, data, count, transpose );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const mat3 *data, int count, bool transpose ) const
+{
+	uniformMatImpl( handle, data, count, transpose );
+}
+
+void GlslProg::uniform( const UniformHandle &handle, const mat4 *data, int count, bool transpose ) const
+{
+	uniformMatImpl( handle, data, count, transpose );
+}
+
 std::ostream& operator<<( std::ostream &os, const GlslProg &rhs )
 {
 	os << "ID: " << rhs.mHandle << std::endl;
@@ -0,0 +1,149 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/gl/StreamVbo.h"
+#include "cinder/gl/Environment.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cinder { namespace gl {
+
+StreamVboRef StreamVbo::create( GLenum target, GLsizeiptr size, size_t numRegions )
+{
+	return StreamVboRef( new StreamVbo( target, size, numRegions ) );
+}
+
+StreamVbo::StreamVbo( GLenum target, GLsizeiptr size, size_t numRegions )
+	: mTarget( target ), mSize( 0 ), mHead( 0 ), mMappedData( nullptr ), mReservedOffset( 0 ), mReservedSize( 0 ), mNumRegions( std::max<size_t>( 1, numRegions ) ), mCurrentRegion( 0 )
+{
+	allocate( std::max<GLsizeiptr>( size, ALIGNMENT * mNumRegions ) );
+}
+
+void StreamVbo::allocate( GLsizeiptr size )
+{
+	// the previous Vbo may still be in use by the GPU, which keeps its storage alive until it is done with it
+	if( mMappedData )
+		mVbo->unmap();
+	mMappedData = nullptr;
+	mSize = size;
+	mHead = 0;
+	mCurrentRegion = 0;
+
+#if ! defined( CINDER_GL_ES )
+	mRegionSyncs.assign( mNumRegions, nullptr );
+	if( env()->supportsBufferStorage() ) {
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		mVbo = Vbo::create( mTarget );
+		mVbo->bufferStorage( mSize, nullptr, flags );
+		mMappedData = reinterpret_cast<uint8_t*>( mVbo->mapBufferRange( 0, mSize, flags ) );
+		if( mMappedData )
+			return;
+	}
+#endif
+
+	mVbo = Vbo::create( mTarget, mSize, nullptr, GL_STREAM_DRAW );
+}
+
+size_t StreamVbo::getRegion( GLintptr offset ) const
+{
+	return std::min<size_t>( offset / ( mSize / mNumRegions ), mNumRegions - 1 );
+}
+
+void StreamVbo::enterNextRegion()
+{
+#if ! defined( CINDER_GL_ES )
+	mRegionSyncs[mCurrentRegion] = Sync::create();
+	mCurrentRegion = ( mCurrentRegion + 1 ) % mNumRegions;
+
+	auto &sync = mRegionSyncs[mCurrentRegion];
+	if( sync ) {
+		// the first wait flushes, so that the fence is guaranteed to be signaled eventually
+		GLbitfield flags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		while( sync->clientWaitSync( flags, 1000000 ) == GL_TIMEOUT_EXPIRED )
+			flags = 0;
+		sync.reset();
+	}
+#else
+	mCurrentRegion = ( mCurrentRegion + 1 ) % mNumRegions;
+#endif
+}
+
+void* StreamVbo::reserve( GLsizeiptr size, GLintptr *offset )
+{
+	if( size > mSize ) {
+		const GLsizeiptr granularity = ALIGNMENT * mNumRegions;
+		allocate( ( std::max( size, mSize * 2 ) + granularity - 1 ) / granularity * granularity );
+	}
+
+	GLintptr start = ( mHead + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+	if( start + size > mSize ) {
+		if( mMappedData ) {
+			do {
+				enterNextRegion();
+			} while( mCurrentRegion != 0 );
+		}
+		else
+			mVbo->bufferData( mSize, nullptr, GL_STREAM_DRAW );
+		start = 0;
+	}
+
+	mHead = start + std::max<GLsizeiptr>( size, 0 );
+	mReservedOffset = start;
+	mReservedSize = std::max<GLsizeiptr>( size, 0 );
+	*offset = start;
+
+	if( mMappedData ) {
+		if( mReservedSize > 0 ) {
+			const size_t lastRegion = getRegion( start + mReservedSize - 1 );
+			while( mCurrentRegion != lastRegion )
+				enterNextRegion();
+		}
+		return mMappedData + start;
+	}
+	else {
+		if( mStagingData.size() < (size_t)mReservedSize )
+			mStagingData.resize( mReservedSize );
+		return mStagingData.data();
+	}
+}
+
+void StreamVbo::commit()
+{
+	if( ! mMappedData && mReservedSize > 0 )
+		mVbo->bufferSubData( mReservedOffset, mReservedSize, mStagingData.data() );
+
+	mReservedSize = 0;
+}
+
+GLintptr StreamVbo::write( const void *data, GLsizeiptr size )
+{
+	GLintptr offset;
+	void *dest = reserve( size, &offset );
+	if( size > 0 )
+		memcpy( dest, data, size );
+	commit();
+
+	return offset;
+}
+
+} } // namespace cinder::gl
@@ -24,6 +24,7 @@
 #include "cinder/gl/Context.h"
 #include "cinder/gl/Vao.h"
 #include "cinder/gl/Vbo.h"
+#include "cinder/gl/StreamVbo.h"
 #include "cinder/gl/scoped.h"
 
 #include "cinder/Text.h"
@@ -533,41 +534,43 @@ void TextureFont::drawGlyphs( const vector<pair<Font::Glyph,vec2> > &glyphMeasur
 		size_t dataSize = (verts.size() + texCoords.size()) * sizeof(float) + vertColors.size() * sizeof(ColorA8u);
 		gl::ScopedVao vaoScp( ctx->getDefaultVao() );
 		ctx->getDefaultVao()->replacementBindBegin();
-		VboRef defaultElementVbo = ctx->getDefaultElementVbo( indices.size() * sizeof(curIdx) );
-		VboRef defaultArrayVbo = ctx->getDefaultArrayVbo( dataSize );
-
-		ScopedBuffer vboArrayScp( defaultArrayVbo );
-		ScopedBuffer vboElScp( defaultElementVbo );
-
-		size_t dataOffset = 0;
+		GLintptr arrayOffset;
+		StreamVbo *arrayStream = ctx->getStreamArrayVbo().get();
+		uint8_t *arrayData = reinterpret_cast<uint8_t*>( arrayStream->reserve( dataSize, &arrayOffset ) );
+		memcpy( arrayData, verts.data(), verts.size() * sizeof(float) );
+		memcpy( arrayData + verts.size() * sizeof(float), texCoords.data(), texCoords.size() * sizeof(float) );
+		if( ! vertColors.empty() )
+			memcpy( arrayData + ( verts.size() + texCoords.size() ) * sizeof(float), vertColors.data(), vertColors.size() * sizeof(ColorA8u) );
+		arrayStream->commit();
+		const GLintptr elementOffset = ctx->getStreamElementVbo()->write( indices.data(), indices.size() * sizeof(curIdx) );
+
+		ScopedBuffer vboArrayScp( arrayStream->getVbo() );
+		ScopedBuffer vboElScp( ctx->getStreamElementVbo()->getVbo() );
+
+		size_t dataOffset = arrayOffset;
 		int posLoc = shader->getAttribSemanticLocation( geom::Attrib::POSITION );
 		if( posLoc >= 0 ) {
 			enableVertexAttribArray( posLoc );
-			vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-			defaultArrayVbo->bufferSubData( dataOffset, verts.size() * sizeof(float), verts.data() );
-			dataOffset += verts.size() * sizeof(float);
+			vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataOffset );
 		}
+		dataOffset += verts.size() * sizeof(float);
 		int texLoc = shader->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 		if( texLoc >= 0 ) {
 			enableVertexAttribArray( texLoc );
 			vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataOffset );
-			defaultArrayVbo->bufferSubData( dataOffset, texCoords.size() * sizeof(float), texCoords.data() );
-			dataOffset += texCoords.size() * sizeof(float);
 		}
+		dataOffset += texCoords.size() * sizeof(float);
 		if( ! vertColors.empty() ) {
 			int colorLoc = shader->getAttribSemanticLocation( geom::Attrib::COLOR );
 			if( colorLoc >= 0 ) {
 				enableVertexAttribArray( colorLoc );
 				vertexAttribPointer( colorLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)dataOffset );
-				defaultArrayVbo->bufferSubData( dataOffset, vertColors.size() * sizeof(ColorA8u), vertColors.data() );
-				dataOffset += vertColors.size() * sizeof(ColorA8u);				
 			}
 		}
 
-		defaultElementVbo->bufferSubData( 0, indices.size() * sizeof(curIdx), indices.data() );
 		ctx->getDefaultVao()->replacementBindEnd();
 		gl::setDefaultShaderVars();
-		ctx->drawElements( GL_TRIANGLES, (GLsizei)indices.size(), indexType, 0 );
+		ctx->drawElements( GL_TRIANGLES, (GLsizei)indices.size(), indexType, (void*)elementOffset );
 	}
 }
 
@@ -670,41 +673,43 @@ void TextureFont::drawGlyphs( const std::vector<std::pair<Font::Glyph,vec2> > &g
 		size_t dataSize = (verts.size() + texCoords.size()) * sizeof(float) + vertColors.size() * sizeof(ColorA8u);
 		gl::ScopedVao vaoScp( ctx->getDefaultVao() );
 		ctx->getDefaultVao()->replacementBindBegin();
-		VboRef defaultElementVbo = ctx->getDefaultElementVbo( indices.size() * sizeof(curIdx) );
-		VboRef defaultArrayVbo = ctx->getDefaultArrayVbo( dataSize );
-
-		ScopedBuffer vboArrayScp( defaultArrayVbo );
-		ScopedBuffer vboElScp( defaultElementVbo );
-
-		size_t dataOffset = 0;
+		GLintptr arrayOffset;
+		StreamVbo *arrayStream = ctx->getStreamArrayVbo().get();
+		uint8_t *arrayData = reinterpret_cast<uint8_t*>( arrayStream->reserve( dataSize, &arrayOffset ) );
+		memcpy( arrayData, verts.data(), verts.size() * sizeof(float) );
+		memcpy( arrayData + verts.size() * sizeof(float), texCoords.data(), texCoords.size() * sizeof(float) );
+		if( ! vertColors.empty() )
+			memcpy( arrayData + ( verts.size() + texCoords.size() ) * sizeof(float), vertColors.data(), vertColors.size() * sizeof(ColorA8u) );
+		arrayStream->commit();
+		const GLintptr elementOffset = ctx->getStreamElementVbo()->write( indices.data(), indices.size() * sizeof(curIdx) );
+
+		ScopedBuffer vboArrayScp( arrayStream->getVbo() );
+		ScopedBuffer vboElScp( ctx->getStreamElementVbo()->getVbo() );
+
+		size_t dataOffset = arrayOffset;
 		int posLoc = shader->getAttribSemanticLocation( geom::Attrib::POSITION );
 		if( posLoc >= 0 ) {
 			enableVertexAttribArray( posLoc );
-			vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
-			defaultArrayVbo->bufferSubData( dataOffset, verts.size() * sizeof(float), verts.data() );
-			dataOffset += verts.size() * sizeof(float);
+			vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataOffset );
 		}
+		dataOffset += verts.size() * sizeof(float);
 		int texLoc = shader->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 		if( texLoc >= 0 ) {
 			enableVertexAttribArray( texLoc );
 			vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataOffset );
-			defaultArrayVbo->bufferSubData( dataOffset, texCoords.size() * sizeof(float), texCoords.data() );
-			dataOffset += texCoords.size() * sizeof(float);
 		}
+		dataOffset += texCoords.size() * sizeof(float);
 		if( ! vertColors.empty() ) {
 			int colorLoc = shader->getAttribSemanticLocation( geom::Attrib::COLOR );
 			if( colorLoc >= 0 ) {
 				enableVertexAttribArray( colorLoc );
 				vertexAttribPointer( colorLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)dataOffset );
-				defaultArrayVbo->bufferSubData( dataOffset, vertColors.size() * sizeof(ColorA8u), vertColors.data() );
-				dataOffset += vertColors.size() * sizeof(ColorA8u);				
 			}
 		}
 
-		defaultElementVbo->bufferSubData( 0, indices.size() * sizeof(curIdx), indices.data() );
 		ctx->getDefaultVao()->replacementBindEnd();
 		gl::setDefaultShaderVars();
-		ctx->drawElements( GL_TRIANGLES, (GLsizei)indices.size(), indexType, 0 );
+		ctx->drawElements( GL_TRIANGLES, (GLsizei)indices.size(), indexType, (void*)elementOffset );
 	}
 }
 
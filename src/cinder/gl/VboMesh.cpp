@@ -507,14 +507,15 @@ void VboMesh::buildVao( const GlslProg* shader, const AttribGlslMap &attributeMa
 
 void VboMesh::drawImpl( GLint first, GLsizei count )
 {
+	auto ctx = gl::context();
 	if( mIndices ) {
 		size_t firstByteOffset = first;
 		if( mIndexType == GL_UNSIGNED_INT ) firstByteOffset *= 4;
 		else if( mIndexType == GL_UNSIGNED_SHORT ) firstByteOffset *= 2;
-		glDrawElements( mGlPrimitive, ( count < 0 ) ? ( mNumIndices - first ) : count, mIndexType, (GLvoid*)( firstByteOffset ) );
+		ctx->drawElements( mGlPrimitive, ( count < 0 ) ? ( mNumIndices - first ) : count, mIndexType, (GLvoid*)( firstByteOffset ) );
 	}
 	else
-		glDrawArrays( mGlPrimitive, first, ( count < 0 ) ? ( mNumVertices - first ) : count );
+		ctx->drawArrays( mGlPrimitive, first, ( count < 0 ) ? ( mNumVertices - first ) : count );
 }
 
 #if defined( CINDER_GL_HAS_DRAW_INSTANCED )
@@ -25,6 +25,8 @@
 #include "cinder/gl/Context.h"
 #include "cinder/gl/Vao.h"
 #include "cinder/gl/VboMesh.h"
+#include "cinder/gl/StreamVbo.h"
+#include "cinder/gl/Batch2d.h"
 #include "cinder/gl/scoped.h"
 #include "cinder/gl/Environment.h"
 #include "cinder/Log.h"
@@ -192,47 +194,60 @@ void drawCubeImpl( const vec3 &c, const vec3 &size, bool faceColors )
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
 
-	VboRef defaultArrayVbo = ctx->getDefaultArrayVbo( totalArrayBufferSize );
-	ScopedBuffer vboScp( defaultArrayVbo );
-	VboRef elementVbo = ctx->getDefaultElementVbo( 6*6 );
-	// we seem to need to orphan the existing element vbo on AMD on OS X
-	elementVbo->bufferData( 36, nullptr, GL_STREAM_DRAW );
-
-	elementVbo->bind();
+	GLintptr arrayOffset;
+	StreamVbo *arrayStream = ctx->getStreamArrayVbo().get();
+	uint8_t *arrayData = reinterpret_cast<uint8_t*>( arrayStream->reserve( totalArrayBufferSize, &arrayOffset ) );
 	size_t curBufferOffset = 0;
+	if( hasPositions ) {
+		memcpy( arrayData + curBufferOffset, vertices, sizeof(float)*24*3 );
+		curBufferOffset += sizeof(float)*24*3;
+	}
+	if( hasNormals ) {
+		memcpy( arrayData + curBufferOffset, normals, sizeof(float)*24*3 );
+		curBufferOffset += sizeof(float)*24*3;
+	}
+	if( hasTextureCoords ) {
+		memcpy( arrayData + curBufferOffset, texs, sizeof(float)*24*2 );
+		curBufferOffset += sizeof(float)*24*2;
+	}
+	if( hasColors ) {
+		memcpy( arrayData + curBufferOffset, colors, 24*4 );
+		curBufferOffset += 24*4;
+	}
+	arrayStream->commit();
+	const GLintptr elementOffset = ctx->getStreamElementVbo()->write( elements, 36 );
+
+	ScopedBuffer vboScp( arrayStream->getVbo() );
+	ctx->getStreamElementVbo()->getVbo()->bind();
+	curBufferOffset = arrayOffset;
 	if( hasPositions ) {
 		int loc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 		enableVertexAttribArray( loc );
 		vertexAttribPointer( loc, 3, GL_FLOAT, GL_FALSE, 0, (void*)curBufferOffset );
-		defaultArrayVbo->bufferSubData( curBufferOffset, sizeof(float)*24*3, vertices );
 		curBufferOffset += sizeof(float)*24*3;
 	}
 	if( hasNormals ) {
 		int loc = curGlslProg->getAttribSemanticLocation( geom::Attrib::NORMAL );
 		enableVertexAttribArray( loc );
 		vertexAttribPointer( loc, 3, GL_FLOAT, GL_FALSE, 0, (void*)curBufferOffset );
-		defaultArrayVbo->bufferSubData( curBufferOffset, sizeof(float)*24*3, normals );
 		curBufferOffset += sizeof(float)*24*3;
 	}
 	if( hasTextureCoords ) {
 		int loc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 		enableVertexAttribArray( loc );
 		vertexAttribPointer( loc, 2, GL_FLOAT, GL_FALSE, 0, (void*)curBufferOffset );
-		defaultArrayVbo->bufferSubData( curBufferOffset, sizeof(float)*24*2, texs );
 		curBufferOffset += sizeof(float)*24*2;
 	}
 	if( hasColors ) {
 		int loc = curGlslProg->getAttribSemanticLocation( geom::Attrib::COLOR );
 		enableVertexAttribArray( loc );
 		vertexAttribPointer( loc, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, (void*)curBufferOffset );
-		defaultArrayVbo->bufferSubData( curBufferOffset, 24*4, colors );
 		curBufferOffset += 24*4;
 	}
 
-	elementVbo->bufferSubData( 0, 36, elements );
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
-	ctx->drawElements( GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, 0 );
+	ctx->drawElements( GL_TRIANGLES, 36, GL_UNSIGNED_BYTE, (void*)elementOffset );
 	ctx->popVao();
 }
 
@@ -265,22 +280,20 @@ void drawStrokedCube( const vec3 &center, const vec3 &size )
 	
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	gl::VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(vec3) * 8 );
-	gl::VboRef elementVbo = ctx->getDefaultElementVbo( 24 );
-	gl::ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, sizeof(vec3) * 8, vertices.data() );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( vertices.data(), sizeof(vec3) * 8 );
+	const GLintptr elementOffset = ctx->getStreamElementVbo()->write( indices.data(), 24 );
+	gl::ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 	
-	elementVbo->bind();
+	ctx->getStreamElementVbo()->getVbo()->bind();
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		gl::enableVertexAttribArray( posLoc );
-		gl::vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		gl::vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	
-	elementVbo->bufferSubData( 0, 24, indices.data() );
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
-	ctx->drawElements( GL_LINES, 24, GL_UNSIGNED_BYTE, 0 );
+	ctx->drawElements( GL_LINES, 24, GL_UNSIGNED_BYTE, (void*)elementOffset );
 	ctx->popVao();
 }
 
@@ -293,6 +306,10 @@ void draw( const TextureRef &texture, const Area &srcArea, const Rectf &dstRect
 
 	Rectf texRect = texture->getAreaTexCoords( srcArea );
 
+	auto batch2d = ctx->getBatch2d();
+	if( batch2d && batch2d->addTexture( texture, texRect, dstRect ) )
+		return;
+
 	ScopedVao vaoScp( ctx->getDrawTextureVao() );
 	ScopedBuffer vboScp( ctx->getDrawTextureVbo() );
 	ScopedTextureBind texBindScope( texture );
@@ -339,16 +356,15 @@ void draw( const Path2d &path, float approximationScale )
 	}
 
 	vector<vec2> points = path.subdivide( approximationScale );
-	VboRef arrayVbo = ctx->getDefaultArrayVbo( sizeof(vec2) * points.size() );
-	arrayVbo->bufferSubData( 0, sizeof(vec2) * points.size(), points.data() );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( points.data(), sizeof(vec2) * points.size() );
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	ScopedBuffer bufferBindScp( arrayVbo );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)nullptr );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)arrayOffset );
 	}
 
 	ctx->getDefaultVao()->replacementBindEnd();
@@ -373,16 +389,15 @@ void draw( const PolyLine2 &polyLine )
 	}
 
 	const vector<vec2> &points = polyLine.getPoints();
-	VboRef arrayVbo = ctx->getDefaultArrayVbo( sizeof(vec2) * points.size() );
-	arrayVbo->bufferSubData( 0, sizeof(vec2) * points.size(), points.data() );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( points.data(), sizeof(vec2) * points.size() );
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	ScopedBuffer bufferBindScp( arrayVbo );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)nullptr );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)arrayOffset );
 	}
 
 	ctx->getDefaultVao()->replacementBindEnd();
@@ -400,16 +415,15 @@ void draw( const std::vector<vec3> &points, bool isClosed )
 		return;
 	}
 	
-	VboRef arrayVbo = ctx->getDefaultArrayVbo( sizeof(vec3) * points.size() );
-	arrayVbo->bufferSubData( 0, sizeof(vec3) * points.size(), points.data() );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( points.data(), sizeof(vec3) * points.size() );
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	ScopedBuffer bufferBindScp( arrayVbo );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)nullptr );
+		vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)arrayOffset );
 	}
 
 	ctx->getDefaultVao()->replacementBindEnd();
@@ -434,14 +448,13 @@ void drawLine( const vec3 &a, const vec3 &b )
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
 
-	VboRef arrayVbo = ctx->getDefaultArrayVbo( size );
-	ScopedBuffer bufferBindScp( arrayVbo );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( points.data(), size );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
-	arrayVbo->bufferSubData( 0, size, points.data() );
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, dims, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)nullptr );
+		vertexAttribPointer( posLoc, dims, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)arrayOffset );
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
@@ -461,17 +474,20 @@ void drawLine( const vec2 &a, const vec2 &b )
 		return;
 	}
 
+	auto batch2d = ctx->getBatch2d();
+	if( batch2d && batch2d->addLine( a, b ) )
+		return;
+
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
 
-	VboRef arrayVbo = ctx->getDefaultArrayVbo( size );
-	ScopedBuffer bufferBindScp( arrayVbo );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( points.data(), size );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
-	arrayVbo->bufferSubData( 0, size, points.data() );
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, dims, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)nullptr );
+		vertexAttribPointer( posLoc, dims, GL_FLOAT, GL_FALSE, 0, (const GLvoid*)arrayOffset );
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
@@ -492,7 +508,7 @@ namespace {
 class DefaultVboTarget : public geom::Target {
   public:
 	DefaultVboTarget( const geom::Source *source )
-		: mSource( source ), mContext( context() ), mArrayVboOffset( 0 ), mTempStorageSizeBytes( 0 )
+		: mSource( source ), mContext( context() ), mArrayStream( nullptr ), mElementStream( nullptr ), mArrayVboOffset( 0 ), mElementVboOffset( 0 ), mArrayData( nullptr ), mElementData( nullptr )
 	{
 		size_t requiredSize = 0;
 		size_t numVertices = source->getNumVertices();
@@ -505,14 +521,19 @@ class DefaultVboTarget : public geom::Target {
 			}
 		}
 
-		mArrayVbo = mContext->getDefaultArrayVbo( requiredSize );
+		// attributes are copied straight into the reserved ranges, and uploaded by commit() if the streams aren't persistently mapped
+		mArrayStream = mContext->getStreamArrayVbo().get();
+		mArrayData = reinterpret_cast<uint8_t*>( mArrayStream->reserve( requiredSize, &mArrayVboOffset ) );
+		mArrayVbo = mArrayStream->getVbo();
 		mGlslProg = mContext->getGlslProg();
 
 		CI_ASSERT_MSG( mGlslProg, "No GLSL program bound" );
 
 		mContext->pushBufferBinding( mArrayVbo->getTarget(), mArrayVbo->getId() );
 		if( source->getNumIndices() ) {
-			mElementVbo = mContext->getDefaultElementVbo( source->getNumIndices() * sizeof( GLint ) );
+			mElementStream = mContext->getStreamElementVbo().get();
+			mElementData = reinterpret_cast<uint8_t*>( mElementStream->reserve( source->getNumIndices() * sizeof( GLint ), &mElementVboOffset ) );
+			mElementVbo = mElementStream->getVbo();
 			mContext->pushBufferBinding( mElementVbo->getTarget(), mElementVbo->getId() );
 		}
 	}
@@ -534,6 +555,20 @@ class DefaultVboTarget : public geom::Target {
 		return mIndexType;
 	}
 
+	//! Returns the offset of the indices in the element Vbo
+	GLintptr	getElementVboOffset() const
+	{
+		return mElementVboOffset;
+	}
+
+	//! Finishes writing vertex and index data, which must precede drawing
+	void	commit()
+	{
+		mArrayStream->commit();
+		if( mElementVbo )
+			mElementStream->commit();
+	}
+
 	//! Returns whether \a attr has data
 	bool attribHasData( geom::Attrib attr ) const
 	{
@@ -550,24 +585,16 @@ class DefaultVboTarget : public geom::Target {
 		if( loc >= 0 ) {
 			size_t totalBytes = count * dims * sizeof(float);
 
-			// if this is not tightly packed, we're going to need a temporary
-			if( ( strideBytes != 0 ) && ( strideBytes != dims * sizeof(float) ) ) {
-				if( totalBytes > mTempStorageSizeBytes ) {
-					// dim=4 should be the worst case; might as well allocate that much for potential next attrib
-					mTempStorageSizeBytes = count * 4 /*dims*/ * sizeof(float);
-					mTempStorage = unique_ptr<uint8_t[]>( new uint8_t[mTempStorageSizeBytes] );
-				}
-				geom::copyData( dims, strideBytes, sourceData, count, dims, 0, reinterpret_cast<float*>( mTempStorage.get() ) );
-				
-				mArrayVbo->bufferSubData( mArrayVboOffset, totalBytes, mTempStorage.get() );
-			}
-			else {
-				mArrayVbo->bufferSubData( mArrayVboOffset, totalBytes, sourceData );
-			}
+			// if this is not tightly packed, it is packed while copying
+			if( ( strideBytes != 0 ) && ( strideBytes != dims * sizeof(float) ) )
+				geom::copyData( dims, strideBytes, sourceData, count, dims, 0, reinterpret_cast<float*>( mArrayData ) );
+			else
+				memcpy( mArrayData, sourceData, totalBytes );
 
 			mContext->enableVertexAttribArray( loc );
 			mContext->vertexAttribPointer( loc, dims, GL_FLOAT, GL_FALSE, 0, (void*)mArrayVboOffset );
 			mArrayVboOffset += totalBytes;
+			mArrayData += totalBytes;
 		}
 		
 		mReceivedAttribs.push_back( attr );
@@ -579,7 +606,7 @@ class DefaultVboTarget : public geom::Target {
 			return;
 
 		mIndexType = GL_UNSIGNED_INT;
-		mElementVbo->bufferSubData( 0, numIndices * 4, sourceData );
+		memcpy( mElementData, sourceData, numIndices * 4 );
 	}
 
 	const geom::Source*		mSource;
@@ -587,14 +614,12 @@ class DefaultVboTarget : public geom::Target {
 	vector<geom::Attrib>	mRequestedAttribs, mReceivedAttribs;
 
 	gl::VboRef			mArrayVbo, mElementVbo;
+	StreamVbo			*mArrayStream, *mElementStream;
 	const gl::GlslProg*	mGlslProg;
-	size_t				mArrayVboOffset;
-	
+	GLintptr			mArrayVboOffset, mElementVboOffset;
+	uint8_t				*mArrayData, *mElementData;
 	
 	GLenum				mIndexType;
-	
-	std::unique_ptr<uint8_t[]>	mTempStorage;
-	size_t						mTempStorageSizeBytes;
 };
 
 } // anonymous namespace
@@ -620,6 +645,7 @@ void draw( const geom::Source &source )
 
 	DefaultVboTarget target( &source );
 	source.loadInto( &target, requestedAttribs );
+	target.commit();
 
 	ctx->getDefaultVao()->replacementBindEnd();
 
@@ -636,7 +662,7 @@ void draw( const geom::Source &source )
 	GLenum primitive = toGl( source.getPrimitive() );
 	const size_t numIndices = source.getNumIndices();
 	if( numIndices )
-		ctx->drawElements( primitive, (GLsizei)numIndices, target.getIndexType(), (GLvoid*)( 0 ) );
+		ctx->drawElements( primitive, (GLsizei)numIndices, target.getIndexType(), (GLvoid*)target.getElementVboOffset() );
 	else
 		ctx->drawArrays( primitive, 0, (GLsizei)source.getNumVertices() );
 
@@ -833,21 +859,24 @@ void drawCrossImpl( const gl::TextureCubeMapRef &texture, const vector<vec2> &po
 	auto ctx = gl::context();
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	gl::VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(float)*(positions.size()*2+texCoords.size()*3) );
-	gl::ScopedBuffer bufferBindScp( defaultVbo );
+	GLintptr arrayOffset;
+	StreamVbo *arrayStream = ctx->getStreamArrayVbo().get();
+	uint8_t *arrayData = reinterpret_cast<uint8_t*>( arrayStream->reserve( sizeof(float)*(positions.size()*2+texCoords.size()*3), &arrayOffset ) );
+	memcpy( arrayData, positions.data(), sizeof(float)*positions.size()*2 );
+	memcpy( arrayData + sizeof(float)*positions.size()*2, texCoords.data(), sizeof(float)*texCoords.size()*3 );
+	arrayStream->commit();
+	gl::ScopedBuffer bufferBindScp( arrayStream->getVbo() );
 	gl::ScopedTextureBind texScp( texture );
-	defaultVbo->bufferSubData( 0, sizeof(float)*positions.size()*2, positions.data() );
-	defaultVbo->bufferSubData( sizeof(float)*positions.size()*2, sizeof(float)*texCoords.size()*3, texCoords.data() );
 
 	int posLoc = glsl->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		gl::enableVertexAttribArray( posLoc );
-		gl::vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		gl::vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	int texLoc = glsl->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 	if( texLoc >= 0 ) {
 		gl::enableVertexAttribArray( texLoc );
-		gl::vertexAttribPointer( texLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(float)*positions.size()*2) );
+		gl::vertexAttribPointer( texLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)(arrayOffset+sizeof(float)*positions.size()*2) );
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
@@ -931,6 +960,10 @@ void drawSolidRect( const Rectf &r, const vec2 &upperLeftTexCoord, const vec2 &l
 		return;
 	}
 
+	auto batch2d = ctx->getBatch2d();
+	if( batch2d && batch2d->addSolidRect( r, upperLeftTexCoord, lowerRightTexCoord ) )
+		return;
+
 	GLfloat data[8+8]; // both verts and texCoords
 	GLfloat *verts = data, *texs = data + 8;
 
@@ -945,19 +978,18 @@ void drawSolidRect( const Rectf &r, const vec2 &upperLeftTexCoord, const vec2 &l
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(float)*16 );
-	ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, sizeof(float)*16, data );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( data, sizeof(float)*16 );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	int texLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 	if( texLoc >= 0 ) {
 		enableVertexAttribArray( texLoc );
-		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(float)*8) );
+		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(arrayOffset+sizeof(float)*8) );
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
@@ -988,14 +1020,13 @@ void drawStrokedRect( const Rectf &rect )
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
 
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( 8 * sizeof( float ) );
-	ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, 8 * sizeof( float ), verts );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( verts, 8 * sizeof( float ) );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 
 	ctx->setDefaultShaderVars();
@@ -1035,14 +1066,13 @@ void drawStrokedRect( const Rectf &rect, float lineWidth )
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
 
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( 32 * sizeof( float ) );
-	ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, 32 * sizeof( float ), verts );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( verts, 32 * sizeof( float ) );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 
 	ctx->setDefaultShaderVars();
@@ -1098,17 +1128,16 @@ void drawStrokedEllipse( const vec2 &center, float radiusX, float radiusY, int n
 	}
 	// copy data to GPU
 	const size_t size = positions.size() * sizeof( vec2 );
-	auto arrayVbo = ctx->getDefaultArrayVbo( size );
-	arrayVbo->bufferSubData( 0, size, (GLvoid*)positions.data() );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( positions.data(), size );
 	// set attributes
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	ScopedBuffer bufferBindScp( arrayVbo );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)nullptr );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (GLvoid*)arrayOffset );
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
@@ -1126,6 +1155,10 @@ void drawSolidCircle( const vec2 &center, float radius, int numSegments )
 		return;
 	}
 
+	auto batch2d = ctx->getBatch2d();
+	if( batch2d && batch2d->addSolidCircle( center, radius, numSegments ) )
+		return;
+
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
 
@@ -1134,39 +1167,31 @@ void drawSolidCircle( const vec2 &center, float radius, int numSegments )
 	if( numSegments < 3 ) numSegments = 3;
 	size_t numVertices = numSegments + 2;
 
-	size_t worstCaseSize = numVertices * sizeof(float) * ( 2 + 2 + 3 );
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( worstCaseSize );
-	ScopedBuffer vboScp( defaultVbo );
-
 	size_t dataSizeBytes = 0;
 
 	size_t vertsOffset{}, texCoordsOffset{}, normalsOffset{};
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
-		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataSizeBytes );
 		vertsOffset = dataSizeBytes;
 		dataSizeBytes += numVertices * 2 * sizeof(float);
 	}
 	int texLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 	if( texLoc >= 0 ) {
-		enableVertexAttribArray( texLoc );
-		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataSizeBytes );
 		texCoordsOffset = dataSizeBytes;
 		dataSizeBytes += numVertices * 2 * sizeof(float);
 	}
 	int normalLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::NORMAL );
 	if( normalLoc >= 0 ) {
-		enableVertexAttribArray( normalLoc );
-		vertexAttribPointer( normalLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)(dataSizeBytes) );
 		normalsOffset = dataSizeBytes;
 		dataSizeBytes += numVertices * 3 * sizeof(float);
 	}
 
-	unique_ptr<uint8_t[]> data( new uint8_t[dataSizeBytes] );
-	vec2 *verts = ( posLoc >= 0 ) ? reinterpret_cast<vec2*>( data.get() + vertsOffset ) : nullptr;
-	vec2 *texCoords = ( texLoc >= 0 ) ? reinterpret_cast<vec2*>( data.get() + texCoordsOffset ) : nullptr;
-	vec3 *normals = ( normalLoc >= 0 ) ? reinterpret_cast<vec3*>( data.get() + normalsOffset ) : nullptr;
+	GLintptr arrayOffset;
+	StreamVbo *arrayStream = ctx->getStreamArrayVbo().get();
+	uint8_t *data = reinterpret_cast<uint8_t*>( arrayStream->reserve( dataSizeBytes, &arrayOffset ) );
+	vec2 *verts = ( posLoc >= 0 ) ? reinterpret_cast<vec2*>( data + vertsOffset ) : nullptr;
+	vec2 *texCoords = ( texLoc >= 0 ) ? reinterpret_cast<vec2*>( data + texCoordsOffset ) : nullptr;
+	vec3 *normals = ( normalLoc >= 0 ) ? reinterpret_cast<vec3*>( data + normalsOffset ) : nullptr;
 
 	if( verts )
 		verts[0] = center;
@@ -1185,7 +1210,21 @@ void drawSolidCircle( const vec2 &center, float radius, int numSegments )
 			normals[s+1] = vec3( 0, 0, 1 );
 	}
 
-	defaultVbo->bufferSubData( 0, dataSizeBytes, data.get() );
+	arrayStream->commit();
+
+	ScopedBuffer vboScp( arrayStream->getVbo() );
+	if( posLoc >= 0 ) {
+		enableVertexAttribArray( posLoc );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)( arrayOffset + vertsOffset ) );
+	}
+	if( texLoc >= 0 ) {
+		enableVertexAttribArray( texLoc );
+		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)( arrayOffset + texCoordsOffset ) );
+	}
+	if( normalLoc >= 0 ) {
+		enableVertexAttribArray( normalLoc );
+		vertexAttribPointer( normalLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)( arrayOffset + normalsOffset ) );
+	}
 	ctx->getDefaultVao()->replacementBindEnd();
 
 	ctx->setDefaultShaderVars();
@@ -1210,39 +1249,31 @@ void drawSolidEllipse( const vec2 &center, float radiusX, float radiusY, int num
 	if( numSegments < 2 ) numSegments = 2;
 	size_t numVertices = (numSegments+2)*2;
 	
-	size_t worstCaseSize = numVertices * sizeof(float) * ( 2 + 2 + 3 );
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( worstCaseSize );
-	ScopedBuffer vboScp( defaultVbo );
-
 	size_t dataSizeBytes = 0;
 
-	size_t vertsOffset, texCoordsOffset, normalsOffset;
+	size_t vertsOffset{}, texCoordsOffset{}, normalsOffset{};
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
-		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataSizeBytes );
 		vertsOffset = dataSizeBytes;
 		dataSizeBytes += numVertices * 2 * sizeof(float);
 	}
 	int texLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 	if( texLoc >= 0 ) {
-		enableVertexAttribArray( texLoc );
-		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)dataSizeBytes );
 		texCoordsOffset = dataSizeBytes;
 		dataSizeBytes += numVertices * 2 * sizeof(float);
 	}
 	int normalLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::NORMAL );
 	if( normalLoc >= 0 ) {
-		enableVertexAttribArray( normalLoc );
-		vertexAttribPointer( normalLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)(dataSizeBytes) );
 		normalsOffset = dataSizeBytes;
 		dataSizeBytes += numVertices * 3 * sizeof(float);
 	}
 
-	unique_ptr<uint8_t[]> data( new uint8_t[dataSizeBytes] );
-	vec2 *verts = ( posLoc >= 0 ) ? reinterpret_cast<vec2*>( data.get() + vertsOffset ) : nullptr;
-	vec2 *texCoords = ( texLoc >= 0 ) ? reinterpret_cast<vec2*>( data.get() + texCoordsOffset ) : nullptr;
-	vec3 *normals = ( normalLoc >= 0 ) ? reinterpret_cast<vec3*>( data.get() + normalsOffset ) : nullptr;
+	GLintptr arrayOffset;
+	StreamVbo *arrayStream = ctx->getStreamArrayVbo().get();
+	uint8_t *data = reinterpret_cast<uint8_t*>( arrayStream->reserve( dataSizeBytes, &arrayOffset ) );
+	vec2 *verts = ( posLoc >= 0 ) ? reinterpret_cast<vec2*>( data + vertsOffset ) : nullptr;
+	vec2 *texCoords = ( texLoc >= 0 ) ? reinterpret_cast<vec2*>( data + texCoordsOffset ) : nullptr;
+	vec3 *normals = ( normalLoc >= 0 ) ? reinterpret_cast<vec3*>( data + normalsOffset ) : nullptr;
 
 	if( verts )
 		verts[0] = center;
@@ -1263,7 +1294,21 @@ void drawSolidEllipse( const vec2 &center, float radiusX, float radiusY, int num
 		t += tDelta;
 	}
 
-	defaultVbo->bufferSubData( 0, dataSizeBytes, data.get() );
+	arrayStream->commit();
+
+	ScopedBuffer vboScp( arrayStream->getVbo() );
+	if( posLoc >= 0 ) {
+		enableVertexAttribArray( posLoc );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)( arrayOffset + vertsOffset ) );
+	}
+	if( texLoc >= 0 ) {
+		enableVertexAttribArray( texLoc );
+		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)( arrayOffset + texCoordsOffset ) );
+	}
+	if( normalLoc >= 0 ) {
+		enableVertexAttribArray( normalLoc );
+		vertexAttribPointer( normalLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)( arrayOffset + normalsOffset ) );
+	}
 	ctx->getDefaultVao()->replacementBindEnd();
 
 	ctx->setDefaultShaderVars();
@@ -1313,20 +1358,19 @@ void drawSolidTriangle( const vec2 pts[3], const vec2 texCoord[3] )
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(float)*12 );
-	ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, sizeof(float) * ( texCoord ? 12 : 6 ), data );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( data, sizeof(float) * ( texCoord ? 12 : 6 ) );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		vertexAttribPointer( posLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	if( texCoord ) {
 		int texLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 		if( texLoc >= 0 ) {
 			enableVertexAttribArray( texLoc );
-			vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(float)*6) );
+			vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(arrayOffset+sizeof(float)*6) );
 		}
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
@@ -1361,24 +1405,23 @@ void drawSolidTriangle( const vec3 pts[3], const vec2 texCoord[3] )
 	GLfloat data[3*3+3*2]; // both verts and texCoords
 	memcpy( data, pts, sizeof(float) * 3 * 3 );
 	if( texCoord )
-		memcpy( data + 3 * 2, texCoord, sizeof(float) * 3 * 2 );
+		memcpy( data + 3 * 3, texCoord, sizeof(float) * 3 * 2 );
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(float)*15 );
-	ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, sizeof(float) * ( texCoord ? 15 : 9 ), data );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( data, sizeof(float) * ( texCoord ? 15 : 9 ) );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	if( texCoord ) {
 		int texLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 		if( texLoc >= 0 ) {
 			enableVertexAttribArray( texLoc );
-			vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(float)*6) );
+			vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(arrayOffset+sizeof(float)*9) );
 		}
 	}
 	ctx->getDefaultVao()->replacementBindEnd();
@@ -1424,19 +1467,18 @@ void drawBillboard( const vec3 &pos, const vec2 &scale, float rotationRadians, c
 
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(float)*20 );
-	ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, sizeof(float)*20, data );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( data, sizeof(float)*20 );
+	ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		enableVertexAttribArray( posLoc );
-		vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	int texLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::TEX_COORD_0 );
 	if( texLoc >= 0 ) {
 		enableVertexAttribArray( texLoc );
-		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(sizeof(float)*12) );
+		vertexAttribPointer( texLoc, 2, GL_FLOAT, GL_FALSE, 0, (void*)(arrayOffset+sizeof(float)*12) );
 	}
 
 	ctx->getDefaultVao()->replacementBindEnd();
@@ -1485,22 +1527,20 @@ void drawFrustum( const Camera &cam )
 	
 	ctx->pushVao();
 	ctx->getDefaultVao()->replacementBindBegin();
-	gl::VboRef defaultVbo = ctx->getDefaultArrayVbo( sizeof(vec3)*9 );
-	gl::VboRef elementVbo = ctx->getDefaultElementVbo( 32 );
-	gl::ScopedBuffer bufferBindScp( defaultVbo );
-	defaultVbo->bufferSubData( 0, sizeof(vec3)*9, vertices.data() );
+	const GLintptr arrayOffset = ctx->getStreamArrayVbo()->write( vertices.data(), sizeof(vec3)*9 );
+	const GLintptr elementOffset = ctx->getStreamElementVbo()->write( indices.data(), 32 );
+	gl::ScopedBuffer bufferBindScp( ctx->getStreamArrayVbo()->getVbo() );
 	
-	elementVbo->bind();
+	ctx->getStreamElementVbo()->getVbo()->bind();
 	int posLoc = curGlslProg->getAttribSemanticLocation( geom::Attrib::POSITION );
 	if( posLoc >= 0 ) {
 		gl::enableVertexAttribArray( posLoc );
-		gl::vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)0 );
+		gl::vertexAttribPointer( posLoc, 3, GL_FLOAT, GL_FALSE, 0, (void*)arrayOffset );
 	}
 	
-	elementVbo->bufferSubData( 0, 32, indices.data() );
 	ctx->getDefaultVao()->replacementBindEnd();
 	ctx->setDefaultShaderVars();
-	ctx->drawElements( GL_LINES, 32, GL_UNSIGNED_BYTE, 0 );
+	ctx->drawElements( GL_LINES, 32, GL_UNSIGNED_BYTE, (void*)elementOffset );
 	ctx->popVao();
 }
 	
@@ -513,6 +513,19 @@ ScopedFrontFace::~ScopedFrontFace()
 	mCtx->popFrontFace();
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////
+// ScopedBatch2d
+ScopedBatch2d::ScopedBatch2d()
+	: mCtx( gl::context() )
+{
+	mCtx->pushBatch2d();
+}
+
+ScopedBatch2d::~ScopedBatch2d()
+{
+	mCtx->popBatch2d();
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 // ScopedDebugGroup
 #if defined( CINDER_GL_HAS_KHR_DEBUG )
@@ -978,6 +978,11 @@ void readPixels( GLint x, GLint y, GLsizei width, GLsizei height, GLenum format,
 
 // Compute
 #if defined( CINDER_GL_HAS_COMPUTE_SHADER )
+void dispatchCompute( GLuint numGroupsX, GLuint numGroupsY, GLuint numGroupsZ )
+{
+	context()->dispatchCompute( numGroupsX, numGroupsY, numGroupsZ );
+}
+
 ivec3 getMaxComputeWorkGroupCount()
 {
 	ivec3 count;
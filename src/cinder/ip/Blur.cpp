@@ -21,6 +21,16 @@
 */
 
 #include "cinder/ip/Blur.h"
+#include "cinder/ThreadPool.h"
+
+#include <algorithm>
+#include <type_traits>
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <emmintrin.h>
+#elif defined( CINDER_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
 
 namespace cinder { namespace ip { 
 
@@ -208,8 +218,401 @@ void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &a
 	free( tempPixelData );
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// Parallel stackBlur. Each pass is the same 1D recurrence, run over rows into a temporary buffer and then over
+// columns back into the destination. The running sums are held in lane types, so that a single instance of the
+// recurrence advances all channels of a pixel (or, for single-channel images, 4 rows / columns) at once.
+
+// Portable fallback lanes, also used for 16u (whose int64_t sums have no suitable SIMD equivalent)
+template<typename SUMT, int N>
+struct ScalarLanes {
+	static const int NUM_LANES = N;
+
+	ScalarLanes()	{ for( int i = 0; i < N; ++i ) mV[i] = 0; }
+
+	static ScalarLanes load( const SUMT *p )
+	{
+		ScalarLanes result;
+		for( int i = 0; i < N; ++i )
+			result.mV[i] = p[i];
+		return result;
+	}
+
+	template<typename T>
+	static ScalarLanes gather( const T *p, ptrdiff_t stride, int count )
+	{
+		ScalarLanes result;
+		for( int i = 0; i < count; ++i )
+			result.mV[i] = (SUMT)p[i * stride];
+		return result;
+	}
+
+	template<typename T>
+	void scatter( T *p, ptrdiff_t stride, int count ) const
+	{
+		for( int i = 0; i < count; ++i )
+			p[i * stride] = (T)mV[i];
+	}
+
+	ScalarLanes& operator+=( const ScalarLanes &rhs )	{ for( int i = 0; i < N; ++i ) mV[i] += rhs.mV[i]; return *this; }
+	ScalarLanes& operator-=( const ScalarLanes &rhs )	{ for( int i = 0; i < N; ++i ) mV[i] -= rhs.mV[i]; return *this; }
+	ScalarLanes operator*( int32_t s ) const			{ ScalarLanes result; for( int i = 0; i < N; ++i ) result.mV[i] = mV[i] * s; return result; }
+
+	ScalarLanes divide( SUMT divisor, SUMT invDivisor ) const
+	{
+		ScalarLanes result;
+		for( int i = 0; i < N; ++i ) {
+			if( std::is_integral<SUMT>::value )
+				result.mV[i] = mV[i] / divisor;
+			else
+				result.mV[i] = mV[i] * invDivisor;
+		}
+		return result;
+	}
+
+	SUMT mV[N];
+};
+
+#if defined( CINDER_SIMD_SSE2 )
+
+struct SseLanes4i {
+	static const int NUM_LANES = 4;
+
+	SseLanes4i() : mV( _mm_setzero_si128() ) {}
+	explicit SseLanes4i( __m128i v ) : mV( v ) {}
+
+	static SseLanes4i load( const int32_t *p )	{ return SseLanes4i( _mm_load_si128( (const __m128i *)p ) ); }
+
+	template<typename T>
+	static SseLanes4i gather( const T *p, ptrdiff_t stride, int count )
+	{
+		if( count == 4 )
+			return SseLanes4i( _mm_setr_epi32( p[0], p[stride], p[2 * stride], p[3 * stride] ) );
+		else
+			return SseLanes4i( _mm_setr_epi32( p[0], p[stride], p[2 * stride], 0 ) );
+	}
+
+	template<typename T>
+	void scatter( T *p, ptrdiff_t stride, int count ) const
+	{
+		alignas(16) int32_t v[4];
+		_mm_store_si128( (__m128i *)v, mV );
+		for( int i = 0; i < count; ++i )
+			p[i * stride] = (T)v[i];
+	}
+
+	SseLanes4i& operator+=( const SseLanes4i &rhs )	{ mV = _mm_add_epi32( mV, rhs.mV ); return *this; }
+	SseLanes4i& operator-=( const SseLanes4i &rhs )	{ mV = _mm_sub_epi32( mV, rhs.mV ); return *this; }
+
+	// SSE2 has no 32-bit multiply, so build one from two 32x32->64 multiplies of the even and odd lanes.
+	// Sums are never negative, which makes the unsigned multiply safe.
+	SseLanes4i operator*( int32_t s ) const
+	{
+		const __m128i scale = _mm_set1_epi32( s );
+		const __m128i even = _mm_mul_epu32( mV, scale );
+		const __m128i odd = _mm_mul_epu32( _mm_srli_si128( mV, 4 ), scale );
+		return SseLanes4i( _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ), _mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) ) );
+	}
+
+	// Integer division through double precision, which is exact for any sum representable in 32 bits. Half a step is
+	// added before truncating so that exact multiples of the divisor aren't rounded down.
+	SseLanes4i divide( int32_t divisor, int32_t /*invDivisor*/ ) const
+	{
+		const __m128d inv = _mm_set1_pd( 1.0 / divisor );
+		const __m128d bias = _mm_set1_pd( 0.5 / divisor );
+		const __m128d lo = _mm_add_pd( _mm_mul_pd( _mm_cvtepi32_pd( mV ), inv ), bias );
+		const __m128d hi = _mm_add_pd( _mm_mul_pd( _mm_cvtepi32_pd( _mm_shuffle_epi32( mV, _MM_SHUFFLE( 1, 0, 3, 2 ) ) ), inv ), bias );
+		return SseLanes4i( _mm_unpacklo_epi64( _mm_cvttpd_epi32( lo ), _mm_cvttpd_epi32( hi ) ) );
+	}
+
+	__m128i mV;
+};
+
+struct SseLanes4f {
+	static const int NUM_LANES = 4;
+
+	SseLanes4f() : mV( _mm_setzero_ps() ) {}
+	explicit SseLanes4f( __m128 v ) : mV( v ) {}
+
+	static SseLanes4f load( const float *p )	{ return SseLanes4f( _mm_load_ps( p ) ); }
+
+	template<typename T>
+	static SseLanes4f gather( const T *p, ptrdiff_t stride, int count )
+	{
+		if( count == 4 )
+			return SseLanes4f( _mm_setr_ps( p[0], p[stride], p[2 * stride], p[3 * stride] ) );
+		else
+			return SseLanes4f( _mm_setr_ps( p[0], p[stride], p[2 * stride], 0 ) );
+	}
+
+	template<typename T>
+	void scatter( T *p, ptrdiff_t stride, int count ) const
+	{
+		alignas(16) float v[4];
+		_mm_store_ps( v, mV );
+		for( int i = 0; i < count; ++i )
+			p[i * stride] = (T)v[i];
+	}
+
+	SseLanes4f& operator+=( const SseLanes4f &rhs )	{ mV = _mm_add_ps( mV, rhs.mV ); return *this; }
+	SseLanes4f& operator-=( const SseLanes4f &rhs )	{ mV = _mm_sub_ps( mV, rhs.mV ); return *this; }
+	SseLanes4f operator*( int32_t s ) const			{ return SseLanes4f( _mm_mul_ps( mV, _mm_set1_ps( (float)s ) ) ); }
+
+	SseLanes4f divide( float /*divisor*/, float invDivisor ) const	{ return SseLanes4f( _mm_mul_ps( mV, _mm_set1_ps( invDivisor ) ) ); }
+
+	__m128 mV;
+};
+
+#elif defined( CINDER_SIMD_NEON )
+
+struct NeonLanes4i {
+	static const int NUM_LANES = 4;
+
+	NeonLanes4i() : mV( vdupq_n_s32( 0 ) ) {}
+	explicit NeonLanes4i( int32x4_t v ) : mV( v ) {}
+
+	static NeonLanes4i load( const int32_t *p )	{ return NeonLanes4i( vld1q_s32( p ) ); }
+
+	template<typename T>
+	static NeonLanes4i gather( const T *p, ptrdiff_t stride, int count )
+	{
+		alignas(16) int32_t v[4] = { p[0], p[stride], p[2 * stride], ( count == 4 ) ? (int32_t)p[3 * stride] : 0 };
+		return NeonLanes4i( vld1q_s32( v ) );
+	}
+
+	template<typename T>
+	void scatter( T *p, ptrdiff_t stride, int count ) const
+	{
+		alignas(16) int32_t v[4];
+		vst1q_s32( v, mV );
+		for( int i = 0; i < count; ++i )
+			p[i * stride] = (T)v[i];
+	}
+
+	NeonLanes4i& operator+=( const NeonLanes4i &rhs )	{ mV = vaddq_s32( mV, rhs.mV ); return *this; }
+	NeonLanes4i& operator-=( const NeonLanes4i &rhs )	{ mV = vsubq_s32( mV, rhs.mV ); return *this; }
+	NeonLanes4i operator*( int32_t s ) const			{ return NeonLanes4i( vmulq_n_s32( mV, s ) ); }
+
+	// NEON has no integer divide, and 32-bit ARM lacks double precision vectors, so divide per lane
+	NeonLanes4i divide( int32_t divisor, int32_t /*invDivisor*/ ) const
+	{
+		alignas(16) int32_t v[4];
+		vst1q_s32( v, mV );
+		for( int i = 0; i < 4; ++i )
+			v[i] /= divisor;
+		return NeonLanes4i( vld1q_s32( v ) );
+	}
+
+	int32x4_t mV;
+};
+
+struct NeonLanes4f {
+	static const int NUM_LANES = 4;
+
+	NeonLanes4f() : mV( vdupq_n_f32( 0 ) ) {}
+	explicit NeonLanes4f( float32x4_t v ) : mV( v ) {}
+
+	static NeonLanes4f load( const float *p )	{ return NeonLanes4f( vld1q_f32( p ) ); }
+
+	template<typename T>
+	static NeonLanes4f gather( const T *p, ptrdiff_t stride, int count )
+	{
+		alignas(16) float v[4] = { p[0], p[stride], p[2 * stride], ( count == 4 ) ? (float)p[3 * stride] : 0 };
+		return NeonLanes4f( vld1q_f32( v ) );
+	}
+
+	template<typename T>
+	void scatter( T *p, ptrdiff_t stride, int count ) const
+	{
+		alignas(16) float v[4];
+		vst1q_f32( v, mV );
+		for( int i = 0; i < count; ++i )
+			p[i * stride] = (T)v[i];
+	}
+
+	NeonLanes4f& operator+=( const NeonLanes4f &rhs )	{ mV = vaddq_f32( mV, rhs.mV ); return *this; }
+	NeonLanes4f& operator-=( const NeonLanes4f &rhs )	{ mV = vsubq_f32( mV, rhs.mV ); return *this; }
+	NeonLanes4f operator*( int32_t s ) const			{ return NeonLanes4f( vmulq_n_f32( mV, (float)s ) ); }
+
+	NeonLanes4f divide( float /*divisor*/, float invDivisor ) const	{ return NeonLanes4f( vmulq_n_f32( mV, invDivisor ) ); }
+
+	float32x4_t mV;
+};
+
+#endif
+
+// Selects the widest available 4-lane type for a given sum type
+template<typename SUMT>
+struct Lanes4 {
+	typedef ScalarLanes<SUMT,4> type;
+};
+
+#if defined( CINDER_SIMD_SSE2 )
+template<> struct Lanes4<int32_t> { typedef SseLanes4i type; };
+template<> struct Lanes4<float> { typedef SseLanes4f type; };
+#elif defined( CINDER_SIMD_NEON )
+template<> struct Lanes4<int32_t> { typedef NeonLanes4i type; };
+template<> struct Lanes4<float> { typedef NeonLanes4f type; };
+#endif
+
+// The stackBlur recurrence along a single line of \a length samples. \a load( i ) returns the lanes at index i (which is
+// always within [0, length)), and \a store( i, sum ) receives the undivided sum for index i. \a stack must hold
+// 2 * radius + 1 lanes.
+template<typename LanesT, typename LoadFnT, typename StoreFnT>
+inline void stackBlurLine( int32_t length, int32_t radius, LanesT *stack, const LoadFnT &load, const StoreFnT &store )
+{
+	const int32_t div = radius + radius + 1;
+	const int32_t radiusPlusOne = radius + 1;
+	const int32_t lengthMinusOne = length - 1;
+
+	LanesT inSum, outSum, sum;
+	for( int32_t i = -radius; i <= radius; i++ ) {
+		LanesT &sir = stack[i + radius];
+		sir = load( std::min( lengthMinusOne, std::max( i, 0 ) ) );
+		sum += sir * ( radiusPlusOne - abs( i ) );
+		if( i > 0 )
+			inSum += sir;
+		else
+			outSum += sir;
+	}
+
+	int32_t stackPointer = radius;
+	for( int32_t x = 0; x < length; x++ ) {
+		store( x, sum );
+		sum -= outSum;
+
+		LanesT &sirOut = stack[( stackPointer - radius + div ) % div];
+		outSum -= sirOut;
+		sirOut = load( std::min( x + radiusPlusOne, lengthMinusOne ) );
+		inSum += sirOut;
+		sum += inSum;
+
+		stackPointer = ( stackPointer + 1 ) % div;
+		const LanesT &sirIn = stack[stackPointer];
+		outSum += sirIn;
+		inSum -= sirIn;
+	}
+}
+
+template<typename T, typename SUMT, typename IMAGET, uint8_t CHANNELS>
+void stackBlurParallel_impl( IMAGET *surface, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	typedef typename Lanes4<SUMT>::type				LanesT;
+	typedef ScalarLanes<SUMT,1>						Lanes1T;
+
+	const int32_t width = area.getWidth();
+	const int32_t height = area.getHeight();
+	if( width <= 0 || height <= 0 )
+		return;
+
+	const int32_t div = radius + radius + 1;
+	const SUMT divisor = (SUMT)(((div+1)>>1)*((div+1)>>1));
+	const SUMT invDivisor = 1 / divisor;
+	const ptrdiff_t pixelInc = ( CHANNELS == 4 ) ? 4 : getPixelIncrement( *surface );
+	const ptrdiff_t rowInc = surface->getRowBytes() / sizeof(T);
+	T *pixelData = surface->getData( area.getUL() ) + getPixelDataOffset( *surface );
+
+	// multichannel pixels occupy one set of lanes each, padded to 4, while single-channel images are processed 4 lines at a time
+	const int32_t tempPixelInc = ( CHANNELS == 1 ) ? 1 : 4;
+	ThreadPool *threadPool = ThreadPool::getDefault();
+	const size_t numChunks = ( threadPool->getNumThreads() + 1 ) * 4;
+
+	// layout: the intermediate image, followed by a stack for each chunk
+	const size_t tempBytes = ( ( (size_t)width * height * tempPixelInc * sizeof(SUMT) + 15 ) / 16 ) * 16;
+	const size_t stackBytes = div * sizeof(LanesT);
+	const size_t totalBytes = tempBytes + numChunks * stackBytes;
+
+	StackBlurScratch localScratch;
+	uint8_t *scratchData = (uint8_t *)( scratch ? scratch : &localScratch )->reserve( totalBytes );
+	SUMT *tempData = (SUMT *)scratchData;
+	auto getChunkStack = [=]( size_t chunk ) { return (LanesT *)( scratchData + tempBytes + chunk * stackBytes ); };
+
+	// horizontal pass: rows of the source into the intermediate image
+	const int32_t numRowGroups = ( CHANNELS == 1 ) ? ( height + 3 ) / 4 : height;
+	threadPool->parallelFor( 0, numChunks, [&]( size_t chunkBegin, size_t chunkEnd ) {
+		LanesT *stack = getChunkStack( chunkBegin );
+		const int32_t groupBegin = (int32_t)( numRowGroups * chunkBegin / numChunks );
+		const int32_t groupEnd = (int32_t)( numRowGroups * chunkEnd / numChunks );
+		for( int32_t group = groupBegin; group < groupEnd; ++group ) {
+			if( CHANNELS != 1 ) {
+				const T *srcRow = pixelData + group * rowInc;
+				SUMT *tempRow = tempData + (size_t)group * width * 4;
+				stackBlurLine( width, radius, stack,
+					[=]( int32_t x ) { return LanesT::gather( srcRow + x * pixelInc, 1, CHANNELS ); },
+					[=]( int32_t x, const LanesT &sum ) { sum.divide( divisor, invDivisor ).scatter( tempRow + x * 4, 1, 4 ); } );
+			}
+			else if( group * 4 + 4 <= height ) {
+				const T *srcRow = pixelData + group * 4 * rowInc;
+				SUMT *tempRow = tempData + (size_t)group * 4 * width;
+				stackBlurLine( width, radius, stack,
+					[=]( int32_t x ) { return LanesT::gather( srcRow + x * pixelInc, rowInc, 4 ); },
+					[=]( int32_t x, const LanesT &sum ) { sum.divide( divisor, invDivisor ).scatter( tempRow + x, width, 4 ); } );
+			}
+			else {
+				// remaining rows of a single-channel image which don't fill all 4 lanes
+				Lanes1T *stack1 = (Lanes1T *)stack;
+				for( int32_t y = group * 4; y < height; ++y ) {
+					const T *srcRow = pixelData + y * rowInc;
+					SUMT *tempRow = tempData + (size_t)y * width;
+					stackBlurLine( width, radius, stack1,
+						[=]( int32_t x ) { return Lanes1T::gather( srcRow + x * pixelInc, 0, 1 ); },
+						[=]( int32_t x, const Lanes1T &sum ) { sum.divide( divisor, invDivisor ).scatter( tempRow + x, 0, 1 ); } );
+				}
+			}
+		}
+	} );
+
+	// vertical pass: columns of the intermediate image into the destination
+	const int32_t numColumnGroups = ( CHANNELS == 1 ) ? ( width + 3 ) / 4 : width;
+	threadPool->parallelFor( 0, numChunks, [&]( size_t chunkBegin, size_t chunkEnd ) {
+		LanesT *stack = getChunkStack( chunkBegin );
+		const int32_t groupBegin = (int32_t)( numColumnGroups * chunkBegin / numChunks );
+		const int32_t groupEnd = (int32_t)( numColumnGroups * chunkEnd / numChunks );
+		const ptrdiff_t tempRowInc = (ptrdiff_t)width * tempPixelInc;
+		for( int32_t group = groupBegin; group < groupEnd; ++group ) {
+			if( CHANNELS != 1 ) {
+				const SUMT *tempColumn = tempData + group * 4;
+				T *dstColumn = pixelData + group * pixelInc;
+				stackBlurLine( height, radius, stack,
+					[=]( int32_t y ) { return LanesT::load( tempColumn + y * tempRowInc ); },
+					[=]( int32_t y, const LanesT &sum ) { sum.divide( divisor, invDivisor ).scatter( dstColumn + y * rowInc, 1, CHANNELS ); } );
+			}
+			else if( group * 4 + 4 <= width ) {
+				const SUMT *tempColumn = tempData + group * 4;
+				T *dstColumn = pixelData + group * 4 * pixelInc;
+				stackBlurLine( height, radius, stack,
+					[=]( int32_t y ) { return LanesT::gather( tempColumn + y * tempRowInc, 1, 4 ); },
+					[=]( int32_t y, const LanesT &sum ) { sum.divide( divisor, invDivisor ).scatter( dstColumn + y * rowInc, pixelInc, 4 ); } );
+			}
+			else {
+				Lanes1T *stack1 = (Lanes1T *)stack;
+				for( int32_t x = group * 4; x < width; ++x ) {
+					const SUMT *tempColumn = tempData + x;
+					T *dstColumn = pixelData + x * pixelInc;
+					stackBlurLine( height, radius, stack1,
+						[=]( int32_t y ) { return Lanes1T::gather( tempColumn + y * tempRowInc, 0, 1 ); },
+						[=]( int32_t y, const Lanes1T &sum ) { sum.divide( divisor, invDivisor ).scatter( dstColumn + y * rowInc, 0, 1 ); } );
+				}
+			}
+		}
+	} );
+}
+
 } // anonymous namespace
 
+///////////////////////////////////////////////////////////////////////////////////
+// StackBlurScratch
+void* StackBlurScratch::reserve( size_t numBytes )
+{
+	if( numBytes > mCapacity || ! mData ) {
+		mData.reset( new uint8_t[numBytes + 15] );
+		mAligned = (uint8_t *)( ( (uintptr_t)mData.get() + 15 ) & ~(uintptr_t)15 );
+		mCapacity = numBytes;
+	}
+
+	return mAligned;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 // Surface8u
 void stackBlur( Surface8u *surface, int radius )
@@ -405,4 +808,127 @@ Channel32f stackBlurCopy( const Channel32f &channel, int radius )
 	return result;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// stackBlurParallel
+
+void stackBlurParallel( Surface8u *surface, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	if( surface->hasAlpha() )
+		stackBlurParallel_impl<uint8_t,int32_t,Surface8u,4>( surface, surface->getBounds(), radius, scratch );
+	else
+		stackBlurParallel_impl<uint8_t,int32_t,Surface8u,3>( surface, surface->getBounds(), radius, scratch );
+}
+
+void stackBlurParallel( Surface8u *surface, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	const Area clippedArea = area.getClipBy( surface->getBounds() );
+	if( surface->hasAlpha() )
+		stackBlurParallel_impl<uint8_t,int32_t,Surface8u,4>( surface, clippedArea, radius, scratch );
+	else
+		stackBlurParallel_impl<uint8_t,int32_t,Surface8u,3>( surface, clippedArea, radius, scratch );
+}
+
+void stackBlurParallel( Channel8u *channel, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	stackBlurParallel_impl<uint8_t,int32_t,Channel8u,1>( channel, channel->getBounds(), radius, scratch );
+}
+
+void stackBlurParallel( Channel8u *channel, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	const Area clippedArea = area.getClipBy( channel->getBounds() );
+	stackBlurParallel_impl<uint8_t,int32_t,Channel8u,1>( channel, clippedArea, radius, scratch );
+}
+
+void stackBlurParallel( Surface16u *surface, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	if( surface->hasAlpha() )
+		stackBlurParallel_impl<uint16_t,int64_t,Surface16u,4>( surface, surface->getBounds(), radius, scratch );
+	else
+		stackBlurParallel_impl<uint16_t,int64_t,Surface16u,3>( surface, surface->getBounds(), radius, scratch );
+}
+
+void stackBlurParallel( Surface16u *surface, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	const Area clippedArea = area.getClipBy( surface->getBounds() );
+	if( surface->hasAlpha() )
+		stackBlurParallel_impl<uint16_t,int64_t,Surface16u,4>( surface, clippedArea, radius, scratch );
+	else
+		stackBlurParallel_impl<uint16_t,int64_t,Surface16u,3>( surface, clippedArea, radius, scratch );
+}
+
+void stackBlurParallel( Channel16u *channel, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	stackBlurParallel_impl<uint16_t,int64_t,Channel16u,1>( channel, channel->getBounds(), radius, scratch );
+}
+
+void stackBlurParallel( Channel16u *channel, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	const Area clippedArea = area.getClipBy( channel->getBounds() );
+	stackBlurParallel_impl<uint16_t,int64_t,Channel16u,1>( channel, clippedArea, radius, scratch );
+}
+
+void stackBlurParallel( Surface32f *surface, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	if( surface->hasAlpha() )
+		stackBlurParallel_impl<float,float,Surface32f,4>( surface, surface->getBounds(), radius, scratch );
+	else
+		stackBlurParallel_impl<float,float,Surface32f,3>( surface, surface->getBounds(), radius, scratch );
+}
+
+void stackBlurParallel( Surface32f *surface, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	const Area clippedArea = area.getClipBy( surface->getBounds() );
+	if( surface->hasAlpha() )
+		stackBlurParallel_impl<float,float,Surface32f,4>( surface, clippedArea, radius, scratch );
+	else
+		stackBlurParallel_impl<float,float,Surface32f,3>( surface, clippedArea, radius, scratch );
+}
+
+void stackBlurParallel( Channel32f *channel, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	stackBlurParallel_impl<float,float,Channel32f,1>( channel, channel->getBounds(), radius, scratch );
+}
+
+void stackBlurParallel( Channel32f *channel, const Area &area, int radius, StackBlurScratch *scratch )
+{
+	if( radius < 1 )
+		return;
+
+	const Area clippedArea = area.getClipBy( channel->getBounds() );
+	stackBlurParallel_impl<float,float,Channel32f,1>( channel, clippedArea, radius, scratch );
+}
+
 } } // namespace cinder::ip
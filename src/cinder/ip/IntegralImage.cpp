@@ -0,0 +1,153 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/ip/IntegralImage.h"
+
+#include <algorithm>
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <emmintrin.h>
+#elif defined( CINDER_SIMD_NEON )
+	#include <arm_neon.h>
+#endif
+
+namespace cinder { namespace ip {
+
+namespace {
+
+// Writes row[x+1] = prevRow[x+1] + src[0] + ... + src[x * srcInc] for a single row of the table
+template<typename T, typename SumT>
+void integrateRow( const T *src, uint8_t srcInc, int32_t width, const SumT *prevRow, SumT *row )
+{
+	SumT sum = 0;
+	row[0] = 0;
+	for( int32_t x = 0; x < width; ++x ) {
+		sum += src[x * srcInc];
+		row[x + 1] = prevRow[x + 1] + sum;
+	}
+}
+
+#if defined( CINDER_SIMD_SSE2 ) || defined( CINDER_SIMD_NEON )
+// 8-bit -> 32-bit specialization for densely packed Channels, which computes the running sum of 4 pixels at a time with an in-register prefix sum
+template<>
+void integrateRow<uint8_t, uint32_t>( const uint8_t *src, uint8_t srcInc, int32_t width, const uint32_t *prevRow, uint32_t *row )
+{
+	row[0] = 0;
+	int32_t x = 0;
+	uint32_t sum = 0;
+	if( srcInc == 1 ) {
+#if defined( CINDER_SIMD_SSE2 )
+		const __m128i zero = _mm_setzero_si128();
+		__m128i carry = zero;
+		for( ; x + 16 <= width; x += 16 ) {
+			const __m128i bytes = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x ) );
+			const __m128i words[2] = { _mm_unpacklo_epi8( bytes, zero ), _mm_unpackhi_epi8( bytes, zero ) };
+			for( int q = 0; q < 4; ++q ) {
+				__m128i v = ( q & 1 ) ? _mm_unpackhi_epi16( words[q >> 1], zero ) : _mm_unpacklo_epi16( words[q >> 1], zero );
+				v = _mm_add_epi32( v, _mm_slli_si128( v, 4 ) );
+				v = _mm_add_epi32( v, _mm_slli_si128( v, 8 ) );
+				v = _mm_add_epi32( v, carry );
+				carry = _mm_shuffle_epi32( v, 0xFF );
+				const __m128i above = _mm_loadu_si128( reinterpret_cast<const __m128i*>( prevRow + x + q * 4 + 1 ) );
+				_mm_storeu_si128( reinterpret_cast<__m128i*>( row + x + q * 4 + 1 ), _mm_add_epi32( v, above ) );
+			}
+		}
+		sum = static_cast<uint32_t>( _mm_cvtsi128_si32( carry ) );
+#else
+		const uint32x4_t zero = vdupq_n_u32( 0 );
+		uint32x4_t carry = zero;
+		for( ; x + 16 <= width; x += 16 ) {
+			const uint8x16_t bytes = vld1q_u8( src + x );
+			const uint16x8_t words[2] = { vmovl_u8( vget_low_u8( bytes ) ), vmovl_u8( vget_high_u8( bytes ) ) };
+			for( int q = 0; q < 4; ++q ) {
+				uint32x4_t v = ( q & 1 ) ? vmovl_u16( vget_high_u16( words[q >> 1] ) ) : vmovl_u16( vget_low_u16( words[q >> 1] ) );
+				v = vaddq_u32( v, vextq_u32( zero, v, 3 ) );
+				v = vaddq_u32( v, vextq_u32( zero, v, 2 ) );
+				v = vaddq_u32( v, carry );
+				carry = vdupq_n_u32( vgetq_lane_u32( v, 3 ) );
+				vst1q_u32( row + x + q * 4 + 1, vaddq_u32( v, vld1q_u32( prevRow + x + q * 4 + 1 ) ) );
+			}
+		}
+		sum = vgetq_lane_u32( carry, 0 );
+#endif
+	}
+
+	for( ; x < width; ++x ) {
+		sum += src[x * srcInc];
+		row[x + 1] = prevRow[x + 1] + sum;
+	}
+}
+#endif
+
+} // anonymous namespace
+
+template<typename SumT>
+template<typename T>
+void IntegralImageT<SumT>::calculate( const ChannelT<T> &channel )
+{
+	mWidth = channel.getWidth();
+	mHeight = channel.getHeight();
+	mData.resize( ( mWidth + 1 ) * ( mHeight + 1 ) );
+
+	const ptrdiff_t stride = getRowStride();
+	std::fill( mData.begin(), mData.begin() + stride, SumT( 0 ) );
+	for( int32_t y = 0; y < mHeight; ++y )
+		integrateRow( channel.getData( 0, y ), channel.getIncrement(), mWidth, &mData[y * stride], &mData[( y + 1 ) * stride] );
+}
+
+template<typename SumT>
+SumT IntegralImageT<SumT>::getSum( const Area &area ) const
+{
+	const Area clipped = area.getClipBy( getBounds() );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return 0;
+
+	return getSum( clipped.x1, clipped.y1, clipped.x2, clipped.y2 );
+}
+
+template<typename SumT>
+double IntegralImageT<SumT>::getMean( const Area &area ) const
+{
+	const Area clipped = area.getClipBy( getBounds() );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return 0;
+
+	return static_cast<double>( getSum( clipped.x1, clipped.y1, clipped.x2, clipped.y2 ) ) / ( (double)clipped.getWidth() * clipped.getHeight() );
+}
+
+template class CI_API IntegralImageT<uint32_t>;
+template class CI_API IntegralImageT<uint64_t>;
+template class CI_API IntegralImageT<double>;
+
+#define integralImage_PROTOTYPES(SUMT,T)\
+	template CI_API void IntegralImageT<SUMT>::calculate( const ChannelT<T> &channel );
+
+integralImage_PROTOTYPES(uint32_t,uint8_t)
+integralImage_PROTOTYPES(uint32_t,uint16_t)
+integralImage_PROTOTYPES(uint64_t,uint8_t)
+integralImage_PROTOTYPES(uint64_t,uint16_t)
+integralImage_PROTOTYPES(double,uint8_t)
+integralImage_PROTOTYPES(double,uint16_t)
+integralImage_PROTOTYPES(double,float)
+
+} } // namespace cinder::ip
@@ -0,0 +1,385 @@
+/*
+ Copyright (c) 2017, The Cinder Project, All rights reserved.
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+    * Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+    * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/ThreadPool.h"
+
+#include <algorithm>
+#include <limits>
+#include <mutex>
+
+namespace cinder { namespace ip {
+
+// A run of operations which can be evaluated tile by tile. Passes are separated by global operations (hdrNormalize()),
+// whose min/max reduction is gathered while the preceding pass writes its output and applied at the start of the next one.
+template<typename T>
+struct PipelineT<T>::Pass {
+	Pass( size_t opBegin )
+		: mOpBegin( opBegin ), mOpEnd( opBegin ), mHalo( 0 ), mHasFlip( false ), mHasSobel( false ), mNormalizeInput( false ), mReduceOutput( false )
+	{}
+
+	// A pass with no halo and no flips can run directly on tiles of the destination
+	bool	isLocal() const		{ return mHalo == 0 && ! mHasFlip; }
+
+	size_t	mOpBegin, mOpEnd;
+	int		mHalo;
+	bool	mHasFlip, mHasSobel;
+	bool	mNormalizeInput, mReduceOutput;
+	float	mInputMin, mInputMax;
+};
+
+namespace {
+
+// Wraps the pixels of \a surface inside \a area without copying them
+template<typename T>
+SurfaceT<T> makeView( const SurfaceT<T> &surface, const Area &area )
+{
+	SurfaceT<T> result( const_cast<T*>( surface.getData( area.getUL() ) ), area.getWidth(), area.getHeight(), surface.getRowBytes(), surface.getChannelOrder() );
+	result.setPremultiplied( surface.isPremultiplied() );
+	return result;
+}
+
+// Matches the arithmetic of ip::hdrNormalize()
+template<typename T>
+void normalizeRgb( SurfaceT<T> *surface, float minVal, float maxVal )
+{
+	if( minVal == maxVal ) {
+		fill( surface, ColorT<T>( 0, 0, 0 ) );
+		return;
+	}
+
+	const float scale = 1.0f / ( maxVal - minVal );
+	const uint8_t pixelInc = surface->getPixelInc();
+	const uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset();
+	for( int32_t y = 0; y < surface->getHeight(); ++y ) {
+		T *dstPtr = surface->getData( ivec2( 0, y ) );
+		for( int32_t x = 0; x < surface->getWidth(); ++x ) {
+			dstPtr[redOffset] = static_cast<T>( ( dstPtr[redOffset] - minVal ) * scale );
+			dstPtr[greenOffset] = static_cast<T>( ( dstPtr[greenOffset] - minVal ) * scale );
+			dstPtr[blueOffset] = static_cast<T>( ( dstPtr[blueOffset] - minVal ) * scale );
+			dstPtr += pixelInc;
+		}
+	}
+}
+
+template<typename T>
+void accumulateMinMaxRgb( const SurfaceT<T> &surface, const Area &area, float *minVal, float *maxVal )
+{
+	const uint8_t pixelInc = surface.getPixelInc();
+	const uint8_t redOffset = surface.getRedOffset(), greenOffset = surface.getGreenOffset(), blueOffset = surface.getBlueOffset();
+	for( int32_t y = area.getY1(); y < area.getY2(); ++y ) {
+		const T *srcPtr = surface.getData( ivec2( area.getX1(), y ) );
+		for( int32_t x = area.getX1(); x < area.getX2(); ++x ) {
+			*minVal = std::min( *minVal, std::min( (float)srcPtr[redOffset], std::min( (float)srcPtr[greenOffset], (float)srcPtr[blueOffset] ) ) );
+			*maxVal = std::max( *maxVal, std::max( (float)srcPtr[redOffset], std::max( (float)srcPtr[greenOffset], (float)srcPtr[blueOffset] ) ) );
+			srcPtr += pixelInc;
+		}
+	}
+}
+
+// Mirrors \a area within an image of \a size
+Area flipArea( const Area &area, const ivec2 &size, bool horizontal, bool vertical )
+{
+	Area result( area );
+	if( horizontal ) {
+		result.x1 = size.x - area.x2;
+		result.x2 = size.x - area.x1;
+	}
+	if( vertical ) {
+		result.y1 = size.y - area.y2;
+		result.y2 = size.y - area.y1;
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::grayscale()
+{
+	return pushOp( Op( Op::GRAYSCALE ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::threshold( T value )
+{
+	Op op( Op::THRESHOLD );
+	op.mValue = value;
+	return pushOp( op );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::premultiply()
+{
+	return pushOp( Op( Op::PREMULTIPLY ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::unpremultiply()
+{
+	return pushOp( Op( Op::UNPREMULTIPLY ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::flipVertical()
+{
+	return pushOp( Op( Op::FLIP_VERTICAL ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::flipHorizontal()
+{
+	return pushOp( Op( Op::FLIP_HORIZONTAL ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::blend( const SurfaceT<T> &foreground, const ivec2 &offset )
+{
+	Op op( Op::BLEND );
+	op.mForeground = &foreground;
+	op.mOffset = offset;
+	return pushOp( op );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::edgeDetectSobel()
+{
+	return pushOp( Op( Op::EDGE_DETECT_SOBEL ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::stackBlur( int radius )
+{
+	Op op( Op::STACK_BLUR );
+	op.mRadius = std::max( radius, 0 );
+	return pushOp( op );
+}
+
+template<typename T>
+void PipelineT<T>::setTileSize( const ivec2 &size )
+{
+	mTileSize = glm::max( size, ivec2( 1 ) );
+}
+
+template<typename T>
+void PipelineT<T>::run( SurfaceT<T> *surface ) const
+{
+	run( *surface, surface );
+}
+
+template<typename T>
+SurfaceT<T> PipelineT<T>::runCopy( const SurfaceT<T> &srcSurface ) const
+{
+	SurfaceT<T> result( srcSurface.getWidth(), srcSurface.getHeight(), srcSurface.hasAlpha(), srcSurface.getChannelOrder() );
+	run( srcSurface, &result );
+	return result;
+}
+
+template<typename T>
+void PipelineT<T>::run( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const
+{
+	CI_ASSERT( srcSurface.getSize() == dstSurface->getSize() );
+
+	// split the chain into passes at each global operation, tracking the premultiplication state the ip:: functions would leave behind
+	std::vector<Pass> passes( 1, Pass( 0 ) );
+	bool premultiplied = srcSurface.isPremultiplied();
+	for( size_t i = 0; i < mOps.size(); ++i ) {
+		Pass &pass = passes.back();
+		switch( mOps[i].mType ) {
+			case Op::HDR_NORMALIZE:
+				pass.mReduceOutput = true;
+				passes.push_back( Pass( i + 1 ) );
+				passes.back().mNormalizeInput = true;
+			continue;
+			case Op::PREMULTIPLY:
+				premultiplied = premultiplied || srcSurface.hasAlpha();
+			break;
+			case Op::UNPREMULTIPLY:
+				premultiplied = premultiplied && ! srcSurface.hasAlpha();
+			break;
+			case Op::FLIP_VERTICAL:
+			case Op::FLIP_HORIZONTAL:
+				pass.mHasFlip = true;
+			break;
+			case Op::EDGE_DETECT_SOBEL:
+				pass.mHasSobel = true;
+				pass.mHalo += 1;
+			break;
+			case Op::STACK_BLUR:
+				pass.mHalo += mOps[i].mRadius;
+			break;
+			default:
+			break;
+		}
+		pass.mOpEnd = i + 1;
+	}
+
+	for( size_t p = 0; p < passes.size(); ++p ) {
+		const SurfaceT<T> *input = ( p == 0 ) ? &srcSurface : dstSurface;
+		// a pass which reads outside of the tile it writes can't run in-place
+		SurfaceT<T> inputCopy;
+		if( input->getData() == dstSurface->getData() && ! passes[p].isLocal() ) {
+			inputCopy = input->clone();
+			input = &inputCopy;
+		}
+
+		float minMax[2];
+		runPass( passes[p], *input, dstSurface, minMax );
+		if( passes[p].mReduceOutput ) {
+			passes[p+1].mInputMin = minMax[0];
+			passes[p+1].mInputMax = minMax[1];
+		}
+	}
+
+	dstSurface->setPremultiplied( premultiplied );
+}
+
+template<typename T>
+void PipelineT<T>::runPass( const Pass &pass, const SurfaceT<T> &input, SurfaceT<T> *dst, float *minMax ) const
+{
+	const ivec2 size = input.getSize();
+	const ivec2 numTiles = ( size + mTileSize - ivec2( 1 ) ) / mTileSize;
+	const int halo = pass.mHalo;
+
+	std::mutex minMaxMutex;
+	minMax[0] = std::numeric_limits<float>::max();
+	minMax[1] = std::numeric_limits<float>::lowest();
+
+	ThreadPool::getDefault()->parallelFor( 0, (size_t)numTiles.x * numTiles.y, [&]( size_t tileBegin, size_t tileEnd ) {
+		SurfaceT<T> buffers[2];
+		float localMin = std::numeric_limits<float>::max(), localMax = std::numeric_limits<float>::lowest();
+
+		for( size_t t = tileBegin; t < tileEnd; ++t ) {
+			const ivec2 tileUL = ivec2( (int32_t)( t % numTiles.x ), (int32_t)( t / numTiles.x ) ) * mTileSize;
+			const Area tile( tileUL, glm::min( tileUL + mTileSize, size ) );
+
+			// 'region' is the Area of the image held in 'views[cur]', in the coordinate frame of the operation being applied
+			Area region;
+			SurfaceT<T> views[2];
+			int cur = 0;
+			if( pass.isLocal() ) {
+				region = tile;
+				views[0] = makeView( *dst, tile );
+				if( input.getData() != dst->getData() )
+					views[0].copyFrom( input, tile, -tile.getUL() );
+			}
+			else {
+				if( ! buffers[0].getData() ) {
+					const ivec2 bufferSize = glm::min( mTileSize + ivec2( 2 * halo ), size );
+					buffers[0] = SurfaceT<T>( bufferSize.x, bufferSize.y, input.hasAlpha(), input.getChannelOrder() );
+					if( pass.mHasSobel )
+						buffers[1] = SurfaceT<T>( bufferSize.x, bufferSize.y, input.hasAlpha(), input.getChannelOrder() );
+				}
+				// load the tile plus its halo from wherever the flips in this pass will have moved it from
+				bool flipH = false, flipV = false;
+				for( size_t i = pass.mOpBegin; i < pass.mOpEnd; ++i ) {
+					flipH = flipH != ( mOps[i].mType == Op::FLIP_HORIZONTAL );
+					flipV = flipV != ( mOps[i].mType == Op::FLIP_VERTICAL );
+				}
+				region = flipArea( Area( tile.getUL() - ivec2( halo ), tile.getLR() + ivec2( halo ) ).getClipBy( input.getBounds() ), size, flipH, flipV );
+				for( int b = 0; b < ( pass.mHasSobel ? 2 : 1 ); ++b )
+					views[b] = makeView( buffers[b], Area( ivec2(), region.getSize() ) );
+				views[0].copyFrom( input, region, -region.getUL() );
+			}
+			views[0].setPremultiplied( input.isPremultiplied() );
+
+			if( pass.mNormalizeInput )
+				normalizeRgb( &views[0], pass.mInputMin, pass.mInputMax );
+
+			for( size_t i = pass.mOpBegin; i < pass.mOpEnd; ++i ) {
+				const Op &op = mOps[i];
+				SurfaceT<T> &view = views[cur];
+				switch( op.mType ) {
+					case Op::GRAYSCALE:
+						ip::grayscale( view, &view );
+					break;
+					case Op::THRESHOLD:
+						ip::threshold( &view, op.mValue );
+					break;
+					case Op::PREMULTIPLY:
+						ip::premultiply( &view );
+					break;
+					case Op::UNPREMULTIPLY:
+						ip::unpremultiply( &view );
+					break;
+					case Op::FLIP_VERTICAL:
+						ip::flipVertical( &view );
+						region = flipArea( region, size, false, true );
+					break;
+					case Op::FLIP_HORIZONTAL:
+						ip::flipHorizontal( &view );
+						region = flipArea( region, size, true, false );
+					break;
+					case Op::BLEND:
+						ip::blend( &view, *op.mForeground, op.mForeground->getBounds(), op.mOffset - region.getUL() );
+					break;
+					case Op::EDGE_DETECT_SOBEL: {
+						SurfaceT<T> &target = views[1 - cur];
+						ip::edgeDetectSobel( view, &target );
+						// clear the border edgeDetectSobel() skips; only the part on the image's edge survives into the output
+						const Area bounds = target.getBounds();
+						const ColorAT<T> zero( 0, 0, 0, 0 );
+						fill( &target, zero, Area( bounds.x1, bounds.y1, bounds.x2, bounds.y1 + 1 ) );
+						fill( &target, zero, Area( bounds.x1, bounds.y2 - 1, bounds.x2, bounds.y2 ) );
+						fill( &target, zero, Area( bounds.x1, bounds.y1, bounds.x1 + 1, bounds.y2 ) );
+						fill( &target, zero, Area( bounds.x2 - 1, bounds.y1, bounds.x2, bounds.y2 ) );
+						target.setPremultiplied( view.isPremultiplied() );
+						cur = 1 - cur;
+					}
+					break;
+					case Op::STACK_BLUR:
+						ip::stackBlur( &view, op.mRadius );
+					break;
+					default:
+					break;
+				}
+			}
+
+			const Area tileInView = tile - region.getUL();
+			if( pass.mReduceOutput )
+				accumulateMinMaxRgb( views[cur], tileInView, &localMin, &localMax );
+			if( ! pass.isLocal() )
+				dst->copyFrom( views[cur], tileInView, region.getUL() );
+		}
+
+		if( pass.mReduceOutput ) {
+			std::lock_guard<std::mutex> lock( minMaxMutex );
+			minMax[0] = std::min( minMax[0], localMin );
+			minMax[1] = std::max( minMax[1], localMax );
+		}
+	} );
+}
+
+template class CI_API PipelineT<uint8_t>;
+template class CI_API PipelineT<float>;
+
+} } // namespace cinder::ip
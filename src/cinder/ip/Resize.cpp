@@ -25,6 +25,8 @@
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/ThreadPool.h"
 
 #include <math.h>
 #include <vector>
@@ -34,9 +36,16 @@ using std::unique_ptr;
 #include <limits>
 #include <fstream>
 #include <algorithm>
+#include <cstring>
+
+#if defined( CINDER_SIMD_SSE2 )
+	#include <emmintrin.h>
+#endif
 
 namespace cinder { namespace ip {
 
+namespace {
+
 template<typename T>
 struct SCALETRAIT {
 	static const uint8_t dataType;
@@ -92,141 +101,6 @@ class WeightTable {		/* SAMPLED FILTER WEIGHT TABLE */
     T		*weight;		/* weight[i] goes with pixel at start+i */
 };
 
-template<typename LT, typename AT>
-void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t lineBufferWidth, AT *accum );
-template<typename T, typename WT>
-void makeWeightTable( int32_t b, float cen, const FilterBase &filter, const FilterParams *params, int32_t len, bool trimzeros, WeightTable<WT> *wtab );
-
-template<typename AT, typename T>
-void scanlineShiftAccumToChannel( AT *accum, int32_t x1, int32_t y, int32_t width, ChannelT<T> *channel )
-{
-	AT result;
-	T *dst;
-
-	dst = channel->getData( x1, y );
-	int8_t pixelStride = channel->getIncrement();
-
-	for( int32_t i = 0; i < width; i++ ) {
-		result = SCALETRAIT<T>::ACCUMTOCHANNEL( *accum++ );
-		*dst = static_cast<T>( result );
-		dst += pixelStride;
-	}
-}
-
-template<typename T, typename WT, typename AT>
-void scanlineFilterChannelToBuffer( WeightTable<WT> *weights, int32_t x, int32_t y, const ChannelT<T> &channel, AT *lineBuffer, int32_t width )
-{
-	int32_t b, af;
-	AT sum;
-	AT *wp;
-	const T *srcLine, *src;
-
-	srcLine = channel.getData( x, y );
-
-	int8_t pixelStride = channel.getIncrement();
-	for ( b = 0; b < width; b++ ) {
-		if( std::numeric_limits<AT>::is_integer )
-			sum = 1 << 7;
-		else
-			sum = 0;
-		src = srcLine + weights->start * pixelStride;
-		wp = weights->weight;
-		for ( af = weights->start; af < weights->end; af++ ) {
-			sum += *wp++ * *src;
-			src += pixelStride;
-		}
-		*lineBuffer++ = SCALETRAIT<T>::CHANNELTOBUFFER( sum );
-		weights++;
-	}	
-}
-
-// assumes channels are of same dimensions
-template<typename T>
-void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &filter, const Area &srcArea, const Area &dstArea, const vector<ChannelT<T>*> &dstChannels )
-{
-	Rectf clippedSrcRect;
-	Area clippedDstArea;
-	getClippedScaledRects( srcChannels[0]->getBounds(), Rectf( srcArea ), dstChannels[0]->getBounds(), dstArea, &clippedSrcRect, &clippedDstArea );
-	
-	if ( ( clippedSrcRect.getWidth() <= 0 ) || ( clippedDstArea.getWidth() <= 0 ) 
-		|| ( clippedSrcRect.getHeight() <= 0 ) || ( clippedDstArea.getHeight() <= 0 ) )
-		return;
-	
-	FilterParams filterParamsX, filterParamsY;
-	Mapping m;
-	int32_t dstWidth = (int32_t)clippedDstArea.getWidth(), dstHeight = (int32_t)clippedDstArea.getHeight();
-	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
-	int32_t srcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
-	int32_t srcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
-	vector<pair<int32_t,unique_ptr<typename SCALETRAIT<T>::SUMT[]>>> linesBuffer;
-
-	m.sx = dstWidth / (float)srcWidth;
-	m.sy = dstHeight / (float)srcHeight;
-	m.tx = clippedDstArea.getX1() - 0.5f - m.sx * ( clippedSrcRect.getX1() - 0.5f );
-	m.ty = clippedDstArea.getY1() - 0.5f - m.sy * ( clippedSrcRect.getY1() - 0.5f );
-	m.ux = clippedDstArea.getX1() - m.sx * ( clippedSrcRect.getX1()- 0.5f ) - m.tx;
-	m.uy = clippedDstArea.getY1() - m.sy * ( clippedSrcRect.getY1()- 0.5f ) - m.ty;
-
-	filterParamsX.scale = std::max( 1.0f, 1.0f / m.sx );
-	filterParamsX.supp = std::max( 0.5f, filterParamsX.scale * filter.getSupport() );
-	filterParamsX.width = (int32_t)ceil( 2.0f * filterParamsX.supp );
-
-	filterParamsY.scale = std::max( 1.0f, 1.0f / m.sy );
-	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
-	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
-
-	for( int32_t i = 0; i < filterParamsY.width; i++ )
-		linesBuffer.push_back( std::make_pair( -1, unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] ) ) );
-
-	WeightTable<typename SCALETRAIT<T>::SUMT> *xWeights, yWeights;
-	typename SCALETRAIT<T>::SUMT *xWeightBuffer, *xWeightPtr;
-	xWeights = (WeightTable<typename SCALETRAIT<T>::SUMT>*)malloc( sizeof(WeightTable<int32_t>) * dstWidth );
-	xWeightBuffer = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * dstWidth * filterParamsX.width );
-	yWeights.weight = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * filterParamsY.width );
-	unique_ptr<typename SCALETRAIT<T>::SUMT[]> accum = unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] );
-
-	xWeightPtr = xWeightBuffer;
-	for ( int32_t bx = 0; bx < dstWidth; bx++, xWeightPtr += filterParamsX.width ) {
-		xWeights[bx].weight = xWeightPtr;
-		makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
-	}
-
-	for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
-		for ( int32_t dstY = 0; dstY < dstHeight; ++dstY ) {     // loop over dest scanlines
-			// prepare a weight table for dest y position by
-			makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
-
-			memset( accum.get(), 0, sizeof(int32_t) * dstWidth );
-
-			// loop over source scanlines that influence this dest scanline
-			for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
-				typename SCALETRAIT<T>::SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
-				if( linesBuffer[ayf % filterParamsY.width].first != ayf ) {
-					scanlineFilterChannelToBuffer( xWeights, srcOffsetX, srcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
-					linesBuffer[ayf % filterParamsY.width].first = ayf;
-				}
-				scanlineAccumulate<typename SCALETRAIT<T>::SUMT,typename SCALETRAIT<T>::SUMT>( yWeights.weight[ayf - yWeights.start], line, dstWidth, accum.get() );
-			}
-
-			scanlineShiftAccumToChannel( accum.get(), clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
-		}
-	}
-
-	free( xWeights );
-	free( xWeightBuffer );
-	free( yWeights.weight );
-}
-
-template<typename LT, typename AT>
-void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t width, AT *accum )
-{
-	AT *dest = accum;
-	int32_t x;
-
-	for ( x = 0; x < width; x++ )
-		*dest++ += *lineBuffer++ * weight;
-}
-
 template<typename T, typename WT>
 void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *params, int32_t len, bool trimzeros, WeightTable<WT> *wtab )
 {
@@ -307,36 +181,454 @@ void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *p
 	}   
 }
 
-template<typename T>
-void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+///////////////////////////////////////////////////////////////////////////////////
+// Resampling kernels. The horizontal pass filters a source row into a line of LINE_INC values per destination pixel,
+// and the vertical pass accumulates the lines covered by a destination row. Multichannel pixels are filtered
+// together, with 3-channel pixels padded to 4 values per line to suit the SIMD kernels.
+
+template<typename WeightT>
+struct ResampleTables {
+	int32_t			dstWidth;
+	int32_t			xWidth, yWidth;
+	const int32_t	*xStart, *xCount, *yStart, *yCount;
+	const WeightT	*xWeights, *yWeights;
+};
+
+template<typename T, typename WeightT, typename LineT>
+struct ResampleKernels {
+	typedef typename SCALETRAIT<T>::SUMT SUMT;
+
+	template<int N, int LINE_INC>
+	static void filterRow( const ResampleTables<WeightT> &tables, const T *src, ptrdiff_t pixelInc, LineT *line )
+	{
+		for( int32_t x = 0; x < tables.dstWidth; ++x ) {
+			const WeightT *weights = tables.xWeights + x * tables.xWidth;
+			const T *srcPixel = src + tables.xStart[x] * pixelInc;
+			const int32_t count = tables.xCount[x];
+			for( int c = 0; c < N; ++c ) {
+				SUMT sum = std::numeric_limits<SUMT>::is_integer ? (SUMT)( 1 << 7 ) : (SUMT)0;
+				for( int32_t k = 0; k < count; ++k )
+					sum += weights[k] * srcPixel[k * pixelInc + c];
+				line[x * LINE_INC + c] = (LineT)SCALETRAIT<T>::CHANNELTOBUFFER( sum );
+			}
+		}
+	}
+
+	template<int N, int LINE_INC>
+	static void accumulateRow( const ResampleTables<WeightT> &tables, int32_t y, const LineT * const *lines, SUMT *accum, T *dst, ptrdiff_t pixelInc )
+	{
+		const int32_t lineLength = tables.dstWidth * LINE_INC;
+		const WeightT *weights = tables.yWeights + y * tables.yWidth;
+		std::fill( accum, accum + lineLength, (SUMT)0 );
+		for( int32_t k = 0; k < tables.yCount[y]; ++k ) {
+			const LineT *line = lines[k];
+			const SUMT weight = weights[k];
+			for( int32_t i = 0; i < lineLength; ++i )
+				accum[i] += line[i] * weight;
+		}
+
+		for( int32_t x = 0; x < tables.dstWidth; ++x )
+			for( int c = 0; c < N; ++c )
+				dst[x * pixelInc + c] = static_cast<T>( SCALETRAIT<T>::ACCUMTOCHANNEL( accum[x * LINE_INC + c] ) );
+	}
+};
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// 8-bit kernels, used when the weights and the horizontal results fit in 16 bits. Pairs of taps are interleaved so
+// that _mm_madd_epi16 applies two weights per instruction, accumulating into the same 32-bit sums as the scalar path.
+template<>
+struct ResampleKernels<uint8_t, int16_t, int16_t> {
+	static __m128i loadPixel( const uint8_t *p, int numComponents )
+	{
+		int32_t v = p[0] | ( p[1] << 8 ) | ( p[2] << 16 );
+		if( numComponents == 4 )
+			v |= p[3] << 24;
+		return _mm_cvtsi32_si128( v );
+	}
+
+	template<int N, int LINE_INC>
+	static void filterRow( const ResampleTables<int16_t> &tables, const uint8_t *src, ptrdiff_t pixelInc, int16_t *line )
+	{
+		if( N == 1 ) {
+			for( int32_t x = 0; x < tables.dstWidth; ++x ) {
+				const int16_t *weights = tables.xWeights + x * tables.xWidth;
+				const uint8_t *srcPixel = src + tables.xStart[x] * pixelInc;
+				int32_t sum = 1 << 7;
+				for( int32_t k = 0; k < tables.xCount[x]; ++k )
+					sum += weights[k] * srcPixel[k * pixelInc];
+				line[x] = (int16_t)SCALETRAIT<uint8_t>::CHANNELTOBUFFER( sum );
+			}
+			return;
+		}
+
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i round = _mm_set1_epi32( 1 << 7 );
+		for( int32_t x = 0; x < tables.dstWidth; ++x ) {
+			const int16_t *weights = tables.xWeights + x * tables.xWidth;
+			const uint8_t *srcPixel = src + tables.xStart[x] * pixelInc;
+			const int32_t count = tables.xCount[x];
+			__m128i sum = round;
+			int32_t k = 0;
+			for( ; k + 1 < count; k += 2 ) {
+				const __m128i pair = _mm_unpacklo_epi8( _mm_unpacklo_epi8( loadPixel( srcPixel + k * pixelInc, N ), loadPixel( srcPixel + ( k + 1 ) * pixelInc, N ) ), zero );
+				const __m128i weightPair = _mm_set1_epi32( ( (uint16_t)weights[k] ) | ( (uint32_t)(uint16_t)weights[k + 1] << 16 ) );
+				sum = _mm_add_epi32( sum, _mm_madd_epi16( pair, weightPair ) );
+			}
+			if( k < count ) {
+				const __m128i single = _mm_unpacklo_epi8( _mm_unpacklo_epi8( loadPixel( srcPixel + k * pixelInc, N ), zero ), zero );
+				sum = _mm_add_epi32( sum, _mm_madd_epi16( single, _mm_set1_epi32( (uint16_t)weights[k] ) ) );
+			}
+			sum = _mm_srai_epi32( sum, 8 );
+			_mm_storel_epi64( (__m128i *)( line + x * LINE_INC ), _mm_packs_epi32( sum, sum ) );
+		}
+	}
+
+	template<int N, int LINE_INC>
+	static void accumulateRow( const ResampleTables<int16_t> &tables, int32_t y, const int16_t * const *lines, int32_t *accum, uint8_t *dst, ptrdiff_t pixelInc )
+	{
+		const int32_t lineLength = tables.dstWidth * LINE_INC;
+		const int16_t *weights = tables.yWeights + y * tables.yWidth;
+		const int32_t count = tables.yCount[y];
+		const __m128i half = _mm_set1_epi32( SCALETRAIT<uint8_t>::HALFFINALSHIFT );
+
+		// the 8-bit results are staged in accum (which is large enough, being 32-bit), then copied out with the destination's stride
+		uint8_t *result = reinterpret_cast<uint8_t *>( accum );
+		int32_t i = 0;
+		for( ; i + 8 <= lineLength; i += 8 ) {
+			__m128i sumLo = _mm_setzero_si128(), sumHi = _mm_setzero_si128();
+			int32_t k = 0;
+			for( ; k + 1 < count; k += 2 ) {
+				const __m128i a = _mm_loadu_si128( (const __m128i *)( lines[k] + i ) );
+				const __m128i b = _mm_loadu_si128( (const __m128i *)( lines[k + 1] + i ) );
+				const __m128i weightPair = _mm_set1_epi32( ( (uint16_t)weights[k] ) | ( (uint32_t)(uint16_t)weights[k + 1] << 16 ) );
+				sumLo = _mm_add_epi32( sumLo, _mm_madd_epi16( _mm_unpacklo_epi16( a, b ), weightPair ) );
+				sumHi = _mm_add_epi32( sumHi, _mm_madd_epi16( _mm_unpackhi_epi16( a, b ), weightPair ) );
+			}
+			if( k < count ) {
+				const __m128i a = _mm_loadu_si128( (const __m128i *)( lines[k] + i ) );
+				const __m128i weightSingle = _mm_set1_epi32( (uint16_t)weights[k] );
+				sumLo = _mm_add_epi32( sumLo, _mm_madd_epi16( _mm_unpacklo_epi16( a, _mm_setzero_si128() ), weightSingle ) );
+				sumHi = _mm_add_epi32( sumHi, _mm_madd_epi16( _mm_unpackhi_epi16( a, _mm_setzero_si128() ), weightSingle ) );
+			}
+			sumLo = _mm_srai_epi32( _mm_add_epi32( sumLo, half ), SCALETRAIT<uint8_t>::FINALSHIFT );
+			sumHi = _mm_srai_epi32( _mm_add_epi32( sumHi, half ), SCALETRAIT<uint8_t>::FINALSHIFT );
+			const __m128i packed = _mm_packs_epi32( sumLo, sumHi );
+			_mm_storel_epi64( (__m128i *)( result + i ), _mm_packus_epi16( packed, packed ) );
+		}
+		for( ; i < lineLength; ++i ) {
+			int32_t sum = 0;
+			for( int32_t k = 0; k < count; ++k )
+				sum += lines[k][i] * weights[k];
+			result[i] = SCALETRAIT<uint8_t>::ACCUMTOCHANNEL( sum );
+		}
+
+		if( N == LINE_INC && pixelInc == N )
+			memcpy( dst, result, lineLength );
+		else {
+			for( int32_t x = 0; x < tables.dstWidth; ++x )
+				for( int c = 0; c < N; ++c )
+					dst[x * pixelInc + c] = result[x * LINE_INC + c];
+		}
+	}
+};
+
+template<>
+struct ResampleKernels<float, float, float> {
+	static __m128 loadPixel( const float *p, int numComponents )
+	{
+		return _mm_setr_ps( p[0], p[1], p[2], ( numComponents == 4 ) ? p[3] : 0.0f );
+	}
+
+	template<int N, int LINE_INC>
+	static void filterRow( const ResampleTables<float> &tables, const float *src, ptrdiff_t pixelInc, float *line )
+	{
+		if( N == 1 ) {
+			for( int32_t x = 0; x < tables.dstWidth; ++x ) {
+				const float *weights = tables.xWeights + x * tables.xWidth;
+				const float *srcPixel = src + tables.xStart[x] * pixelInc;
+				float sum = 0;
+				for( int32_t k = 0; k < tables.xCount[x]; ++k )
+					sum += weights[k] * srcPixel[k * pixelInc];
+				line[x] = sum;
+			}
+			return;
+		}
+
+		for( int32_t x = 0; x < tables.dstWidth; ++x ) {
+			const float *weights = tables.xWeights + x * tables.xWidth;
+			const float *srcPixel = src + tables.xStart[x] * pixelInc;
+			__m128 sum = _mm_setzero_ps();
+			for( int32_t k = 0; k < tables.xCount[x]; ++k )
+				sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( weights[k] ), loadPixel( srcPixel + k * pixelInc, N ) ) );
+			_mm_storeu_ps( line + x * LINE_INC, sum );
+		}
+	}
+
+	template<int N, int LINE_INC>
+	static void accumulateRow( const ResampleTables<float> &tables, int32_t y, const float * const *lines, float *accum, float *dst, ptrdiff_t pixelInc )
+	{
+		const int32_t lineLength = tables.dstWidth * LINE_INC;
+		const float *weights = tables.yWeights + y * tables.yWidth;
+		const int32_t count = tables.yCount[y];
+
+		int32_t i = 0;
+		for( ; i + 4 <= lineLength; i += 4 ) {
+			__m128 sum = _mm_setzero_ps();
+			for( int32_t k = 0; k < count; ++k )
+				sum = _mm_add_ps( sum, _mm_mul_ps( _mm_loadu_ps( lines[k] + i ), _mm_set1_ps( weights[k] ) ) );
+			_mm_storeu_ps( accum + i, sum );
+		}
+		for( ; i < lineLength; ++i ) {
+			float sum = 0;
+			for( int32_t k = 0; k < count; ++k )
+				sum += lines[k][i] * weights[k];
+			accum[i] = sum;
+		}
+
+		if( N == LINE_INC && pixelInc == N )
+			memcpy( dst, accum, lineLength * sizeof(float) );
+		else {
+			for( int32_t x = 0; x < tables.dstWidth; ++x )
+				for( int c = 0; c < N; ++c )
+					dst[x * pixelInc + c] = accum[x * LINE_INC + c];
+		}
+	}
+};
+
+#endif // defined( CINDER_SIMD_SSE2 )
+
+// Resamples destination rows [rowBegin, rowEnd). Source rows shared by consecutive destination rows are kept in a
+// ring of horizontally filtered lines, so each is filtered only once per band.
+template<typename T, typename WeightT, typename LineT, int N>
+void resampleRows( const ResampleTables<WeightT> &tables, const T *src, ptrdiff_t srcRowInc, ptrdiff_t srcPixelInc, T *dst, ptrdiff_t dstRowInc, ptrdiff_t dstPixelInc, int32_t rowBegin, int32_t rowEnd )
 {
-	vector<const ChannelT<T>*> srcChannels;
-	vector<ChannelT<T>*> dstChannels;
-
-	srcChannels.push_back( &srcSurface.getChannelRed() );
-	dstChannels.push_back( &dstSurface->getChannelRed() );
-	srcChannels.push_back( &srcSurface.getChannelGreen() );
-	dstChannels.push_back( &dstSurface->getChannelGreen() );
-	srcChannels.push_back( &srcSurface.getChannelBlue() );
-	dstChannels.push_back( &dstSurface->getChannelBlue() );
-	if ( srcSurface.hasAlpha() && dstSurface->hasAlpha() ) {
-		srcChannels.push_back( &srcSurface.getChannelAlpha() );
-		dstChannels.push_back( &dstSurface->getChannelAlpha() );	
+	typedef ResampleKernels<T, WeightT, LineT> Kernels;
+	typedef typename SCALETRAIT<T>::SUMT SUMT;
+	static const int LINE_INC = ( N == 1 ) ? 1 : 4;
+
+	const int32_t lineLength = tables.dstWidth * LINE_INC;
+	unique_ptr<LineT[]> lineStorage( new LineT[lineLength * tables.yWidth] );
+	vector<int32_t> ringRows( tables.yWidth, -1 );
+	vector<const LineT*> lines( tables.yWidth );
+	unique_ptr<SUMT[]> accum( new SUMT[lineLength] );
+
+	for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+		for( int32_t k = 0; k < tables.yCount[y]; ++k ) {
+			const int32_t srcRow = tables.yStart[y] + k;
+			const int32_t slot = srcRow % tables.yWidth;
+			LineT *line = lineStorage.get() + slot * lineLength;
+			if( ringRows[slot] != srcRow ) {
+				Kernels::template filterRow<N, LINE_INC>( tables, src + srcRow * srcRowInc, srcPixelInc, line );
+				ringRows[slot] = srcRow;
+			}
+			lines[k] = line;
+		}
+
+		Kernels::template accumulateRow<N, LINE_INC>( tables, y, lines.data(), accum.get(), dst + y * dstRowInc, dstPixelInc );
 	}
+}
 
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+template<typename T, typename WeightT, typename LineT>
+void resampleParallel( const ResampleTables<WeightT> &tables, int32_t dstHeight, const T *src, ptrdiff_t srcRowInc, ptrdiff_t srcPixelInc, T *dst, ptrdiff_t dstRowInc, ptrdiff_t dstPixelInc, int numComponents )
+{
+	// each band refilters the source rows it shares with its neighbors, so keep bands reasonably tall
+	const size_t minRowsPerBand = std::max<size_t>( 16, tables.yWidth * 4 );
+	ThreadPool::getDefault()->parallelFor( 0, dstHeight, [&]( size_t rowBegin, size_t rowEnd ) {
+		if( numComponents == 4 )
+			resampleRows<T, WeightT, LineT, 4>( tables, src, srcRowInc, srcPixelInc, dst, dstRowInc, dstPixelInc, (int32_t)rowBegin, (int32_t)rowEnd );
+		else if( numComponents == 3 )
+			resampleRows<T, WeightT, LineT, 3>( tables, src, srcRowInc, srcPixelInc, dst, dstRowInc, dstPixelInc, (int32_t)rowBegin, (int32_t)rowEnd );
+		else
+			resampleRows<T, WeightT, LineT, 1>( tables, src, srcRowInc, srcPixelInc, dst, dstRowInc, dstPixelInc, (int32_t)rowBegin, (int32_t)rowEnd );
+	}, minRowsPerBand );
 }
 
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////////
+// ResizePlan
 template<typename T>
-void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter )
+ResizePlan<T>::ResizePlan( const ivec2 &srcSize, const ivec2 &dstSize, const FilterBase &filter )
 {
-	vector<const ChannelT<T>*> srcChannels;
-	vector<ChannelT<T>*> dstChannels;
+	init( srcSize, Area( ivec2( 0 ), srcSize ), dstSize, Area( ivec2( 0 ), dstSize ), filter );
+}
+
+template<typename T>
+ResizePlan<T>::ResizePlan( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter )
+{
+	init( srcSize, srcArea, dstSize, dstArea, filter );
+}
+
+template<typename T>
+void ResizePlan<T>::init( const ivec2 &srcSize, const Area &srcArea, const ivec2 &dstSize, const Area &dstArea, const FilterBase &filter )
+{
+	mSrcSize = srcSize;
+	mDstSize = dstSize;
+	mXWidth = mYWidth = 0;
+	mFits16 = false;
+
+	Rectf clippedSrcRect;
+	getClippedScaledRects( Area( ivec2( 0 ), srcSize ), Rectf( srcArea ), Area( ivec2( 0 ), dstSize ), dstArea, &clippedSrcRect, &mClippedDstArea );
 	
-	srcChannels.push_back( &srcChannel );
-	dstChannels.push_back( dstChannel );
+	if ( ( clippedSrcRect.getWidth() <= 0 ) || ( mClippedDstArea.getWidth() <= 0 ) 
+		|| ( clippedSrcRect.getHeight() <= 0 ) || ( mClippedDstArea.getHeight() <= 0 ) ) {
+		mClippedDstArea = Area( 0, 0, 0, 0 );
+		return;
+	}
 	
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+	FilterParams filterParamsX, filterParamsY;
+	Mapping m;
+	int32_t dstWidth = (int32_t)mClippedDstArea.getWidth(), dstHeight = (int32_t)mClippedDstArea.getHeight();
+	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
+	mSrcOffset.x = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
+	mSrcOffset.y = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
+
+	m.sx = dstWidth / (float)srcWidth;
+	m.sy = dstHeight / (float)srcHeight;
+	m.tx = mClippedDstArea.getX1() - 0.5f - m.sx * ( clippedSrcRect.getX1() - 0.5f );
+	m.ty = mClippedDstArea.getY1() - 0.5f - m.sy * ( clippedSrcRect.getY1() - 0.5f );
+	m.ux = mClippedDstArea.getX1() - m.sx * ( clippedSrcRect.getX1()- 0.5f ) - m.tx;
+	m.uy = mClippedDstArea.getY1() - m.sy * ( clippedSrcRect.getY1()- 0.5f ) - m.ty;
+
+	filterParamsX.scale = std::max( 1.0f, 1.0f / m.sx );
+	filterParamsX.supp = std::max( 0.5f, filterParamsX.scale * filter.getSupport() );
+	filterParamsX.width = (int32_t)ceil( 2.0f * filterParamsX.supp );
+
+	filterParamsY.scale = std::max( 1.0f, 1.0f / m.sy );
+	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
+	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
+
+	mXWidth = filterParamsX.width;
+	mYWidth = filterParamsY.width;
+	mXStart.resize( dstWidth );
+	mXCount.resize( dstWidth );
+	mXWeights.assign( dstWidth * mXWidth, 0 );
+	mYStart.resize( dstHeight );
+	mYCount.resize( dstHeight );
+	mYWeights.assign( dstHeight * mYWidth, 0 );
+
+	WeightTable<WeightT> weightTable;
+	for( int32_t bx = 0; bx < dstWidth; bx++ ) {
+		weightTable.weight = &mXWeights[bx * mXWidth];
+		makeWeightTable<T,WeightT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &weightTable );
+		mXStart[bx] = weightTable.start;
+		mXCount[bx] = weightTable.end - weightTable.start;
+	}
+
+	for( int32_t by = 0; by < dstHeight; by++ ) {
+		weightTable.weight = &mYWeights[by * mYWidth];
+		makeWeightTable<T,WeightT>( MAP(by, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &weightTable );
+		mYStart[by] = weightTable.start;
+		mYCount[by] = weightTable.end - weightTable.start;
+	}
+
+	// The 16-bit kernels require every weight, and every horizontally filtered value, to fit in 16 bits
+	if( std::numeric_limits<WeightT>::is_integer ) {
+		mFits16 = true;
+		for( int32_t bx = 0; bx < dstWidth && mFits16; bx++ ) {
+			int64_t absSum = 0;
+			for( int32_t k = 0; k < mXCount[bx]; ++k ) {
+				const int64_t w = (int64_t)mXWeights[bx * mXWidth + k];
+				mFits16 = mFits16 && ( w >= std::numeric_limits<int16_t>::min() ) && ( w <= std::numeric_limits<int16_t>::max() );
+				absSum += ( w < 0 ) ? -w : w;
+			}
+			mFits16 = mFits16 && ( ( absSum * 255 + ( 1 << 7 ) ) >> 8 ) <= std::numeric_limits<int16_t>::max();
+		}
+		for( auto w : mYWeights )
+			mFits16 = mFits16 && ( w >= std::numeric_limits<int16_t>::min() ) && ( w <= std::numeric_limits<int16_t>::max() );
+
+		if( mFits16 ) {
+			mXWeights16.assign( mXWeights.begin(), mXWeights.end() );
+			mYWeights16.assign( mYWeights.begin(), mYWeights.end() );
+		}
+	}
+}
+
+template<typename T>
+typename ResizePlan<T>::Taps ResizePlan<T>::getColumnTaps( int32_t x ) const
+{
+	Taps result = { mXStart[x], mXCount[x], &mXWeights[x * mXWidth] };
+	return result;
+}
+
+template<typename T>
+typename ResizePlan<T>::Taps ResizePlan<T>::getRowTaps( int32_t y ) const
+{
+	Taps result = { mYStart[y], mYCount[y], &mYWeights[y * mYWidth] };
+	return result;
+}
+
+template<typename T>
+void ResizePlan<T>::resample( const T *srcData, ptrdiff_t srcRowInc, ptrdiff_t srcPixelInc, T *dstData, ptrdiff_t dstRowInc, ptrdiff_t dstPixelInc, int numComponents ) const
+{
+	const int32_t dstHeight = mClippedDstArea.getHeight();
+
+	if( mFits16 ) {
+		ResampleTables<int16_t> tables = { mClippedDstArea.getWidth(), mXWidth, mYWidth, mXStart.data(), mXCount.data(), mYStart.data(), mYCount.data(), mXWeights16.data(), mYWeights16.data() };
+		resampleParallel<T, int16_t, int16_t>( tables, dstHeight, srcData, srcRowInc, srcPixelInc, dstData, dstRowInc, dstPixelInc, numComponents );
+	}
+	else {
+		ResampleTables<WeightT> tables = { mClippedDstArea.getWidth(), mXWidth, mYWidth, mXStart.data(), mXCount.data(), mYStart.data(), mYCount.data(), mXWeights.data(), mYWeights.data() };
+		resampleParallel<T, WeightT, typename SCALETRAIT<T>::SUMT>( tables, dstHeight, srcData, srcRowInc, srcPixelInc, dstData, dstRowInc, dstPixelInc, numComponents );
+	}
+}
+
+template<typename T>
+void ResizePlan<T>::resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface ) const
+{
+	CI_ASSERT( srcSurface.getSize() == mSrcSize && dstSurface->getSize() == mDstSize );
+	if( srcSurface.getSize() != mSrcSize || dstSurface->getSize() != mDstSize || mClippedDstArea.calcArea() == 0 )
+		return;
+
+	// matching layouts are filtered a pixel at a time; otherwise each channel is resampled on its own
+	if( srcSurface.getChannelOrder() == dstSurface->getChannelOrder() && srcSurface.hasAlpha() == dstSurface->hasAlpha() ) {
+		const int numComponents = srcSurface.getPixelInc();
+		resample( srcSurface.getData( mSrcOffset ), srcSurface.getRowBytes() / sizeof(T), numComponents,
+				dstSurface->getData( mClippedDstArea.getUL() ), dstSurface->getRowBytes() / sizeof(T), numComponents, numComponents );
+	}
+	else {
+		resize( srcSurface.getChannelRed(), &dstSurface->getChannelRed() );
+		resize( srcSurface.getChannelGreen(), &dstSurface->getChannelGreen() );
+		resize( srcSurface.getChannelBlue(), &dstSurface->getChannelBlue() );
+		if( srcSurface.hasAlpha() && dstSurface->hasAlpha() )
+			resize( srcSurface.getChannelAlpha(), &dstSurface->getChannelAlpha() );
+	}
+}
+
+template<typename T>
+void ResizePlan<T>::resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel ) const
+{
+	CI_ASSERT( srcChannel.getSize() == mSrcSize && dstChannel->getSize() == mDstSize );
+	if( srcChannel.getSize() != mSrcSize || dstChannel->getSize() != mDstSize || mClippedDstArea.calcArea() == 0 )
+		return;
+
+	resample( srcChannel.getData( mSrcOffset ), srcChannel.getRowBytes() / sizeof(T), srcChannel.getIncrement(),
+			dstChannel->getData( mClippedDstArea.getUL() ), dstChannel->getRowBytes() / sizeof(T), dstChannel->getIncrement(), 1 );
+}
+
+template<typename T>
+void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const ResizePlan<T> &plan )
+{
+	plan.resize( srcSurface, dstSurface );
+}
+
+template<typename T>
+void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const ResizePlan<T> &plan )
+{
+	plan.resize( srcChannel, dstChannel );
+}
+
+template<typename T>
+void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+{
+	ResizePlan<T>( srcSurface.getSize(), srcArea, dstSurface->getSize(), dstArea, filter ).resize( srcSurface, dstSurface );
+}
+
+template<typename T>
+void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter )
+{
+	ResizePlan<T>( srcChannel.getSize(), srcArea, dstChannel->getSize(), dstArea, filter ).resize( srcChannel, dstChannel );
 }
 
 template<typename T>
@@ -364,7 +656,10 @@ void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Filte
 	template CI_API void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter ); \
 	template CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter ); \
 	template CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter ); \
-	template CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter );
+	template CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter ); \
+	template CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const ResizePlan<T> &plan ); \
+	template CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const ResizePlan<T> &plan ); \
+	template class CI_API ResizePlan<T>;
 
 // These should match CHANNEL_TYPES
 resize_PROTOTYPES(uint8_t)
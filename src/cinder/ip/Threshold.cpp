@@ -21,9 +21,12 @@
 */
 
 #include "cinder/ip/Threshold.h"
+#include "cinder/ip/Grayscale.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/ThreadPool.h"
 
-#include <stdlib.h>
+#include <algorithm>
 
 namespace cinder { namespace ip {
 
@@ -118,135 +121,116 @@ void threshold( const ChannelT<T> &srcChannel, T value, ChannelT<T> *dstChannel
 	thresholdImpl( srcChannel, value, srcChannel.getBounds(), ivec2(), dstChannel );
 }
 
-template<typename T>
-void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+namespace {
+
+// The fixed-point comparison of the original implementation, evaluated in the accumulator type
+template<typename T, typename SumT>
+struct LegacyPercentageCompare {
+	explicit LegacyPercentageCompare( float percentageDelta ) : mMult( static_cast<SumT>( ( 1.0f - percentageDelta ) * 256 ) ) {}
+	T operator()( T v, int32_t count, SumT sum ) const	{ return ( (SumT)( v * count ) < ( sum * mMult / 256 ) ) ? 0 : CHANTRAIT<T>::max(); }
+
+	SumT	mMult;
+};
+
+template<typename T, typename SumT>
+struct LegacyZeroCompare {
+	T operator()( T v, int32_t count, SumT sum ) const
+	{
+		//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
+		int32_t diffSignExtended = (int32_t)( sum - v * count );
+		diffSignExtended >>= 31;
+		return (T)( diffSignExtended & 0xFF );
+	}
+};
+
+// v < mean * ( 1 - percentageDelta ), evaluated without overflow
+template<typename T, typename SumT>
+struct PercentageCompare {
+	explicit PercentageCompare( float percentageDelta ) : mScale( 1.0 - percentageDelta ) {}
+	T operator()( T v, int32_t count, SumT sum ) const	{ return ( (double)v * count < (double)sum * mScale ) ? 0 : CHANTRAIT<T>::max(); }
+
+	double	mScale;
+};
+
+// Sets each pixel of \a dstChannel to compare( src, count, sum ) where sum is the total of the count pixels in the windowSize box around src.
+// The box is clipped to the image. With \a legacyBox the box excludes its first row and column, matching the original implementation,
+// which read an integral image without a leading row and column of zeros. Rows are processed in parallel bands.
+template<typename T, typename SumT, typename CompareT>
+void adaptiveThresholdImpl( const IntegralImageT<SumT> &integralImage, const ChannelT<T> &srcChannel, int32_t windowSize, bool legacyBox, const CompareT &compare, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel->getWidth();
-	int32_t imageHeight = srcChannel->getHeight();
-
-	int s2 = windowSize / 2;
-	uint8_t srcInc = srcChannel->getIncrement();
-	uint8_t dstInc = dstChannel->getIncrement();
-
-	SUMT comparisonMult = static_cast<SUMT>( ( 1.0f - percentageDelta ) * 256 );
-	const T maxValue = CHANTRAIT<T>::max();
-
-	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
-			dst += dstInc;
-			src += srcInc;
+	CI_ASSERT( integralImage.getSize() == srcChannel.getSize() );
+
+	const int32_t imageWidth = std::min( srcChannel.getWidth(), dstChannel->getWidth() );
+	const int32_t imageHeight = std::min( srcChannel.getHeight(), dstChannel->getHeight() );
+	const int32_t s2 = std::max( windowSize / 2, 0 );
+	const int32_t bias = legacyBox ? 1 : 0;
+	const uint8_t srcInc = srcChannel.getIncrement();
+	const uint8_t dstInc = dstChannel->getIncrement();
+	const SumT *table = integralImage.getData();
+	const ptrdiff_t stride = integralImage.getRowStride();
+	// pixels whose box isn't clipped horizontally
+	const int32_t interiorBegin = std::min( s2, imageWidth ), interiorEnd = std::max( imageWidth - s2 - 1, interiorBegin );
+
+	ThreadPool::getDefault()->parallelFor( 0, imageHeight, [&]( size_t rowBegin, size_t rowEnd ) {
+		for( int32_t y = (int32_t)rowBegin; y < (int32_t)rowEnd; ++y ) {
+			const int32_t y1 = std::max( y - s2, 0 ) + bias, y2 = std::min( y + s2 + 1, imageHeight );
+			const SumT *top = table + y1 * stride, *bottom = table + y2 * stride;
+			const int32_t rows = y2 - y1;
+			const T *src = srcChannel.getData( 0, y );
+			T *dst = dstChannel->getData( 0, y );
+
+			auto clippedPixel = [&]( int32_t x ) {
+				const int32_t x1 = std::max( x - s2, 0 ) + bias, x2 = std::min( x + s2 + 1, imageWidth );
+				const SumT sum = bottom[x2] - bottom[x1] - top[x2] + top[x1];
+				dst[x * dstInc] = compare( src[x * srcInc], ( x2 - x1 ) * rows, sum );
+			};
+
+			for( int32_t x = 0; x < interiorBegin; ++x )
+				clippedPixel( x );
+			const int32_t count = ( 2 * s2 + 1 - bias ) * rows;
+			if( srcInc == 1 && dstInc == 1 ) { // common case of a densely packed Channel, which the compiler can vectorize
+				for( int32_t x = interiorBegin; x < interiorEnd; ++x ) {
+					const int32_t x1 = x - s2 + bias, x2 = x + s2 + 1;
+					dst[x] = compare( src[x], count, bottom[x2] - bottom[x1] - top[x2] + top[x1] );
+				}
+			}
+			else {
+				for( int32_t x = interiorBegin; x < interiorEnd; ++x ) {
+					const int32_t x1 = x - s2 + bias, x2 = x + s2 + 1;
+					dst[x * dstInc] = compare( src[x * srcInc], count, bottom[x2] - bottom[x1] - top[x2] + top[x1] );
+				}
+			}
+			for( int32_t x = interiorEnd; x < imageWidth; ++x )
+				clippedPixel( x );
 		}
-	}
+	}, 16 );
 }
 
-template<typename T>
-void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
-{
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel->getWidth();
-	int32_t imageHeight = srcChannel->getHeight();
-	int s2 = windowSize / 2;
-	uint8_t srcInc = srcChannel->getIncrement();
-	uint8_t dstInc = dstChannel->getIncrement();
-
-	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
-			int32_t diffSignExtended = (int32_t)( sum - *src * count );
-			diffSignExtended >>= 31;
-			*dst = (T)(diffSignExtended & 0xFF);
-			dst += dstInc;
-			src += srcInc;
-		}
-	}
+} // anonymous namespace
 
+template<typename T, typename SumT>
+void adaptiveThreshold( const IntegralImageT<SumT> &integralImage, const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+{
+	adaptiveThresholdImpl( integralImage, srcChannel, windowSize, false, PercentageCompare<T,SumT>( percentageDelta ), dstChannel );
 }
 
 template<typename T>
-void calculateIntegralImage( const ChannelT<T> &channel, typename CHANTRAIT<T>::Accum *integralImage )
+void adaptiveThreshold( const SurfaceT<T> &srcSurface, int32_t windowSize, float percentageDelta, SurfaceT<T> *dstSurface )
 {
-	int32_t imageWidth = channel.getWidth(), imageHeight = channel.getHeight();
-	ptrdiff_t srcRowBytes = channel.getRowBytes();
-	uint8_t srcInc = channel.getIncrement();
-	const T *src = channel.getData();
-	/*for( int32_t i = 0; i < imageWidth; i++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t j = 0; j < imageHeight; j++ ) {
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( i == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-1] + sum;
-		}
-	}*/
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t i = 0; i < imageWidth; i++ ) {		
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( j == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-imageWidth] + sum;
+	ChannelT<T> luminance( srcSurface.getWidth(), srcSurface.getHeight() );
+	ip::grayscale( srcSurface, &luminance );
+	const IntegralImageT<typename IntegralImageSum<T>::Type> integralImage( luminance );
+	adaptiveThreshold( integralImage, luminance, windowSize, percentageDelta, &luminance );
+
+	const Area area = srcSurface.getBounds().getClipBy( dstSurface->getBounds() );
+	const uint8_t pixelInc = dstSurface->getPixelInc();
+	const uint8_t redOffset = dstSurface->getRedOffset(), greenOffset = dstSurface->getGreenOffset(), blueOffset = dstSurface->getBlueOffset();
+	for( int32_t y = 0; y < area.getHeight(); ++y ) {
+		const T *srcPtr = luminance.getData( 0, y );
+		T *dstPtr = dstSurface->getData( ivec2( 0, y ) );
+		for( int32_t x = 0; x < area.getWidth(); ++x ) {
+			dstPtr[redOffset] = dstPtr[greenOffset] = dstPtr[blueOffset] = *srcPtr++;
+			dstPtr += pixelInc;
 		}
 	}
 }
@@ -254,96 +238,42 @@ void calculateIntegralImage( const ChannelT<T> &channel, typename CHANTRAIT<T>::
 template<typename T>
 void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel );
-
-	free( integralImage );	
+	const IntegralImageT<typename IntegralImageSum<T>::Type> integralImage( srcChannel );
+	adaptiveThresholdImpl( integralImage, srcChannel, windowSize, true, LegacyPercentageCompare<T,typename IntegralImageSum<T>::Type>( percentageDelta ), dstChannel );
 }
 
 template<typename T>
 void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-
-	calculateAdaptiveThreshold( channel, integralImage, windowSize, percentageDelta, channel );
-
-	free( integralImage );	
+	adaptiveThreshold( *channel, windowSize, percentageDelta, channel );
 }
 
 template<typename T>
 void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-	
-	calculateAdaptiveThresholdZero( channel, integralImage, windowSize, channel );
-
-	free( integralImage );	
+	adaptiveThresholdZero( *channel, windowSize, channel );
 }
 
 template<typename T>
 void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThresholdZero( &srcChannel, integralImage, windowSize, dstChannel );
-
-	free( integralImage );	
+	const IntegralImageT<typename IntegralImageSum<T>::Type> integralImage( srcChannel );
+	adaptiveThresholdImpl( integralImage, srcChannel, windowSize, true, LegacyZeroCompare<T,typename IntegralImageSum<T>::Type>(), dstChannel );
 }
 
 template<typename T>
 AdaptiveThresholdT<T>::AdaptiveThresholdT( const ChannelT<T> *channel )
-	: mChannel( channel )
+	: mChannel( channel ), mIntegralImage( *channel )
 {
-	mImageWidth = mChannel->getWidth();
-	mImageHeight = mChannel->getHeight();
-	mIncrement = mChannel->getIncrement();
-
-	// create the integral image
-	mIntegralImage.resize( mImageWidth * mImageHeight );
-	calculateIntegralImage( *channel, mIntegralImage.data() );
 }
 
 template<typename T>
 void AdaptiveThresholdT<T>::calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
 {
-	if( percentageDelta < 0.0001f ) {
-		calculateAdaptiveThresholdZero( mChannel, mIntegralImage.data(), windowSize, dstChannel );
-	} else {
-		calculateAdaptiveThreshold( mChannel, mIntegralImage.data(), windowSize, percentageDelta, dstChannel );
-	}
+	if( percentageDelta < 0.0001f )
+		adaptiveThresholdImpl( mIntegralImage, *mChannel, windowSize, true, LegacyZeroCompare<T,SumT>(), dstChannel );
+	else
+		adaptiveThresholdImpl( mIntegralImage, *mChannel, windowSize, true, LegacyPercentageCompare<T,SumT>( percentageDelta ), dstChannel );
 }
 
 template class CI_API AdaptiveThresholdT<uint8_t>;
@@ -357,8 +287,23 @@ template class CI_API AdaptiveThresholdT<float>;
 	template CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel ); \
 	template CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta ); \
 	template CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize ); \
-	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel ); \
+	template CI_API void adaptiveThreshold( const SurfaceT<T> &srcSurface, int32_t windowSize, float percentageDelta, SurfaceT<T> *dstSurface );
+
+#define adaptiveThresholdIntegral_PROTOTYPES(T,SUMT)\
+	template CI_API void adaptiveThreshold( const IntegralImageT<SUMT> &integralImage, const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
 
 threshold_PROTOTYPES(uint8_t)
+adaptiveThresholdIntegral_PROTOTYPES(uint8_t,uint32_t)
+adaptiveThresholdIntegral_PROTOTYPES(uint8_t,uint64_t)
+adaptiveThresholdIntegral_PROTOTYPES(uint8_t,double)
+adaptiveThresholdIntegral_PROTOTYPES(float,double)
+
+template CI_API void adaptiveThreshold( const SurfaceT<float> &srcSurface, int32_t windowSize, float percentageDelta, SurfaceT<float> *dstSurface );
+
+template CI_API void threshold( SurfaceT<float> *surface, float value );
+template CI_API void threshold( SurfaceT<float> *surface, float value, const Area &area );
+template CI_API void threshold( const SurfaceT<float> &srcSurface, float value, SurfaceT<float> *dstSurface );
+template CI_API void threshold( const ChannelT<float> &srcChannel, float value, ChannelT<float> *dstChannel );
 
 } } // namespace cinder::ip
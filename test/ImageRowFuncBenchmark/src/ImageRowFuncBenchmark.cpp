@@ -0,0 +1,105 @@
+// Times loading 8-bit images into Surfaces of every common channel order, comparing the generic ImageSource row functions
+// against the SIMD row conversion kernels selected by setupRowFunc().
+// Run from a terminal, results are printed to stdout.
+
+#include "cinder/ImageIo.h"
+#include "cinder/Rand.h"
+#include "cinder/Surface.h"
+#include "cinder/Timer.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace ci;
+
+namespace {
+
+const int32_t WIDTH = 1920;
+const int32_t HEIGHT = 1080;
+const size_t NUM_ITERATIONS = 50;
+
+// Hands out rows of random pixels from memory, so that only the row conversion is timed.
+class ImageSourceMemory : public ImageSource {
+  public:
+	ImageSourceMemory( ImageIo::ColorModel colorModel, ImageIo::ChannelOrder channelOrder )
+	{
+		mWidth = WIDTH;
+		mHeight = HEIGHT;
+		setDataType( ImageIo::UINT8 );
+		setColorModel( colorModel );
+		setChannelOrder( channelOrder );
+
+		mData.resize( WIDTH * HEIGHT * channelOrderNumChannels( channelOrder ) );
+		for( auto &value : mData )
+			value = uint8_t( randInt( 256 ) );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		ImageSource::RowFunc func = setupRowFunc( target );
+		const size_t rowBytes = getRowBytes();
+		for( int32_t y = 0; y < mHeight; ++y )
+			( ( *this ).*func )( target, y, mData.data() + y * rowBytes );
+	}
+
+  private:
+	std::vector<uint8_t>	mData;
+};
+
+struct Conversion {
+	const char				*mName;
+	ImageIo::ColorModel		mColorModel;
+	ImageIo::ChannelOrder	mSourceOrder;
+	SurfaceChannelOrder		mTargetOrder;
+	bool					mFloat;
+};
+
+// returns millions of pixels per second
+template<typename T>
+double run( const Conversion &conversion, bool kernels )
+{
+	ImageSource::setRowFuncKernelsEnabled( kernels );
+	ImageSourceRef source( new ImageSourceMemory( conversion.mColorModel, conversion.mSourceOrder ) );
+	SurfaceT<T> surface( WIDTH, HEIGHT, conversion.mTargetOrder.hasAlpha(), conversion.mTargetOrder );
+	ImageTargetRef target = surface;
+
+	source->load( target );
+	Timer timer( true );
+	for( size_t i = 0; i < NUM_ITERATIONS; i++ )
+		source->load( target );
+
+	return double( WIDTH ) * HEIGHT * NUM_ITERATIONS / timer.getSeconds() / 1e6;
+}
+
+} // anonymous namespace
+
+int main()
+{
+	const Conversion conversions[] = {
+		{ "RGB -> RGBA",		ImageIo::CM_RGB, ImageIo::RGB, SurfaceChannelOrder::RGBA, false },
+		{ "RGB -> BGRA",		ImageIo::CM_RGB, ImageIo::RGB, SurfaceChannelOrder::BGRA, false },
+		{ "RGB -> RGB",			ImageIo::CM_RGB, ImageIo::RGB, SurfaceChannelOrder::RGB, false },
+		{ "BGR -> RGB",			ImageIo::CM_RGB, ImageIo::BGR, SurfaceChannelOrder::RGB, false },
+		{ "BGRA -> RGBA",		ImageIo::CM_RGB, ImageIo::BGRA, SurfaceChannelOrder::RGBA, false },
+		{ "ARGB -> RGBA",		ImageIo::CM_RGB, ImageIo::ARGB, SurfaceChannelOrder::RGBA, false },
+		{ "RGBA -> RGB",		ImageIo::CM_RGB, ImageIo::RGBA, SurfaceChannelOrder::RGB, false },
+		{ "RGBA -> RGBA",		ImageIo::CM_RGB, ImageIo::RGBA, SurfaceChannelOrder::RGBA, false },
+		{ "Y -> RGB",			ImageIo::CM_GRAY, ImageIo::Y, SurfaceChannelOrder::RGB, false },
+		{ "Y -> RGBA",			ImageIo::CM_GRAY, ImageIo::Y, SurfaceChannelOrder::RGBA, false },
+		{ "YA -> RGBA",			ImageIo::CM_GRAY, ImageIo::YA, SurfaceChannelOrder::RGBA, false },
+		{ "RGB 8u -> 32f",		ImageIo::CM_RGB, ImageIo::RGB, SurfaceChannelOrder::RGB, true },
+		{ "RGBA 8u -> 32f",		ImageIo::CM_RGB, ImageIo::RGBA, SurfaceChannelOrder::RGBA, true }
+	};
+
+	std::printf( "image: %d x %d, million pixels per second\n", WIDTH, HEIGHT );
+	std::printf( "%-18s%14s%14s%10s\n", "conversion", "generic", "kernel", "speedup" );
+
+	for( const auto &conversion : conversions ) {
+		const double generic = conversion.mFloat ? run<float>( conversion, false ) : run<uint8_t>( conversion, false );
+		const double kernel = conversion.mFloat ? run<float>( conversion, true ) : run<uint8_t>( conversion, true );
+		std::printf( "%-18s%14.1f%14.1f%9.2fx\n", conversion.mName, generic, kernel, kernel / generic );
+	}
+
+	ImageSource::setRowFuncKernelsEnabled( true );
+	return 0;
+}
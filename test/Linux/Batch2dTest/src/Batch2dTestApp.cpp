@@ -0,0 +1,184 @@
+// Checks that ScopedBatch2d draws the same pixels as the unbatched 2D convenience functions while merging their draw calls,
+// and that a GlslProg released while its draws are pending stays alive until the batch is flushed.
+// Works with the headless renderer (libcinder built with CINDER_HEADLESS, using EGL or OSMesa) as well as with a window.
+// Prints each check and quits after the first frame, returning a non-zero exit code if any check failed.
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/gl/Batch2d.h"
+
+#include <cstdlib>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+namespace {
+
+#if defined( CINDER_GL_ES )
+const char *VERSION_DIRECTIVE = "#version 300 es\nprecision highp float;\n";
+#else
+const char *VERSION_DIRECTIVE = "#version 150\n";
+#endif
+
+const char *VERTEX_SHADER =
+	"uniform mat4 ciModelViewProjection;\n"
+	"in vec4 ciPosition;\n"
+	"void main() {\n"
+	"	gl_Position = ciModelViewProjection * ciPosition;\n"
+	"}\n";
+
+const char *FRAGMENT_SHADER =
+	"out vec4 oColor;\n"
+	"void main() {\n"
+	"	oColor = vec4( 1.0, 0.0, 1.0, 1.0 );\n"
+	"}\n";
+
+const ivec2 FBO_SIZE( 200, 200 );
+const Rectf TEMPORARY_PROG_RECT( 150, 150, 190, 190 );
+
+gl::Texture2dRef createCheckerboard()
+{
+	Surface8u surface( 8, 8, false );
+	for( int32_t y = 0; y < 8; ++y ) {
+		for( int32_t x = 0; x < 8; ++x )
+			surface.setPixel( ivec2( x, y ), ( ( x + y ) % 2 ) ? Color8u( 255, 255, 255 ) : Color8u( 0, 0, 64 ) );
+	}
+	return gl::Texture2d::create( surface, gl::Texture2d::Format().minFilter( GL_NEAREST ).magFilter( GL_NEAREST ) );
+}
+
+// Draws a mix of batchable calls, with state changes between some of them
+void drawScene( const gl::Texture2dRef &texture )
+{
+	gl::color( 1, 0, 0 );
+	gl::drawSolidRect( Rectf( 10, 10, 60, 40 ) );
+
+	{
+		gl::ScopedModelMatrix modelScp;
+		gl::translate( 80, 20 );
+		gl::scale( 2, 2 );
+		gl::ScopedBlendAlpha blendScp;
+		gl::color( 0, 1, 0, 0.5f );
+		gl::drawSolidRect( Rectf( 0, 0, 20, 10 ) );
+	}
+
+	gl::color( 0, 0, 1 );
+	gl::drawSolidCircle( vec2( 150, 60 ), 20 );
+	gl::drawLine( vec2( 10, 90 ), vec2( 190, 90 ) );
+
+	gl::color( 1, 1, 1 );
+	gl::draw( texture, Rectf( 20, 100, 84, 164 ) );
+
+	gl::color( 1, 1, 0 );
+	for( int i = 0; i < 10; ++i )
+		gl::drawSolidRect( Rectf( 100, 100, 104, 104 ) + vec2( i * 5, 0 ) );
+
+	// the program is released before the batch is flushed
+	{
+		auto prog = gl::GlslProg::create( string( VERSION_DIRECTIVE ) + VERTEX_SHADER, string( VERSION_DIRECTIVE ) + FRAGMENT_SHADER );
+		gl::ScopedGlslProg progScp( prog );
+		gl::drawSolidRect( TEMPORARY_PROG_RECT );
+	}
+}
+
+} // anonymous namespace
+
+class Batch2dTestApp : public App {
+  public:
+	void draw() override;
+
+  private:
+	void		check( bool condition, const string &description );
+	Surface8u	render( bool batched, const gl::Texture2dRef &texture );
+
+	int		mNumFailures = 0;
+};
+
+void Batch2dTestApp::check( bool condition, const string &description )
+{
+	console() << ( condition ? "PASS: " : "FAIL: " ) << description << endl;
+	if( ! condition )
+		mNumFailures++;
+}
+
+Surface8u Batch2dTestApp::render( bool batched, const gl::Texture2dRef &texture )
+{
+	auto fbo = gl::Fbo::create( FBO_SIZE.x, FBO_SIZE.y );
+	{
+		gl::ScopedFramebuffer fboScp( fbo );
+		gl::ScopedViewport viewportScp( FBO_SIZE );
+		gl::ScopedMatrices matricesScp;
+		gl::setMatricesWindow( FBO_SIZE );
+		gl::clear( Color::black() );
+
+		if( batched ) {
+			gl::ScopedBatch2d batchScp;
+			drawScene( texture );
+		}
+		else
+			drawScene( texture );
+	}
+
+	return fbo->readPixels8u( fbo->getBounds() );
+}
+
+void Batch2dTestApp::draw()
+{
+	auto ctx = gl::context();
+	auto texture = createCheckerboard();
+
+	const Surface8u unbatched = render( false, texture );
+	const Surface8u batched = render( true, texture );
+
+	// vertices are transformed on the CPU when batched, so allow the odd pixel whose center lies on an edge to differ
+	size_t numDifferent = 0;
+	for( int32_t y = 0; y < FBO_SIZE.y; ++y ) {
+		for( int32_t x = 0; x < FBO_SIZE.x; ++x ) {
+			const ColorA8u a = unbatched.getPixel( ivec2( x, y ) ), b = batched.getPixel( ivec2( x, y ) );
+			if( abs( a.r - b.r ) > 2 || abs( a.g - b.g ) > 2 || abs( a.b - b.b ) > 2 )
+				numDifferent++;
+		}
+	}
+	console() << numDifferent << " of " << FBO_SIZE.x * FBO_SIZE.y << " pixels differ" << endl;
+	check( numDifferent <= size_t( FBO_SIZE.x * FBO_SIZE.y / 1000 ), "batched output matches unbatched output" );
+
+	const ivec2 temporaryProgCenter( TEMPORARY_PROG_RECT.getCenter() );
+	check( batched.getPixel( temporaryProgCenter ) == ColorA8u( 255, 0, 255, 255 ), "a GlslProg released while batched still draws" );
+
+	// identical draws are merged into a single pending draw, and issue far fewer state changes than unbatched ones
+	gl::ScopedMatrices matricesScp;
+	gl::setMatricesWindow( getWindowSize() );
+	gl::color( 1, 1, 1 );
+
+	ctx->resetStateChangeCounters();
+	for( int i = 0; i < 100; ++i )
+		gl::drawSolidRect( Rectf( 0, 0, 10, 10 ) + vec2( i, i ) );
+	const size_t unbatchedIssued = ctx->getStateChangeCounters().mIssued;
+
+	ctx->resetStateChangeCounters();
+	{
+		gl::ScopedBatch2d batchScp;
+		for( int i = 0; i < 100; ++i )
+			gl::drawSolidRect( Rectf( 0, 0, 10, 10 ) + vec2( i, i ) );
+		check( ctx->getBatch2d() && ctx->getBatch2d()->getNumPendingVertices() == 600, "100 rects are merged into one pending draw" );
+	}
+	const size_t batchedIssued = ctx->getStateChangeCounters().mIssued;
+	console() << "100 rects: " << unbatchedIssued << " state changes issued unbatched, " << batchedIssued << " batched" << endl;
+	check( batchedIssued < unbatchedIssued, "batching issues fewer state changes" );
+
+	// a state change flushes what was recorded before it
+	{
+		gl::ScopedBatch2d batchScp;
+		gl::drawSolidRect( Rectf( 0, 0, 10, 10 ) );
+		gl::draw( texture, Rectf( 0, 0, 10, 10 ) );
+		check( ctx->getBatch2d()->getNumPendingVertices() == 6, "changing the texture flushes the pending draw" );
+	}
+	check( glGetError() == GL_NO_ERROR, "no OpenGL errors" );
+
+	ctx->sanityCheck();
+	console() << ( mNumFailures ? "FAILED" : "PASSED" ) << endl;
+	std::exit( mNumFailures ? 1 : 0 );
+}
+
+CINDER_APP( Batch2dTestApp, RendererGl )
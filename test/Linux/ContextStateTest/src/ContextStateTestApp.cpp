@@ -0,0 +1,119 @@
+// Checks that gl::Context elides redundant state changes, counts them, and that its cached state matches OpenGL's.
+// Works with the headless renderer (libcinder built with CINDER_HEADLESS, using EGL or OSMesa) as well as with a window.
+// Prints each check and quits after the first frame, returning a non-zero exit code if any check failed.
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+
+#include <cstdlib>
+
+using namespace ci;
+using namespace ci::app;
+
+class ContextStateTestApp : public App {
+  public:
+	void draw() override;
+
+  private:
+	void	check( bool condition, const std::string &description );
+	GLint	getInteger( GLenum pname );
+
+	int		mNumFailures = 0;
+};
+
+void ContextStateTestApp::check( bool condition, const std::string &description )
+{
+	console() << ( condition ? "PASS: " : "FAIL: " ) << description << std::endl;
+	if( ! condition )
+		mNumFailures++;
+}
+
+GLint ContextStateTestApp::getInteger( GLenum pname )
+{
+	GLint result = 0;
+	glGetIntegerv( pname, &result );
+	return result;
+}
+
+void ContextStateTestApp::draw()
+{
+	auto ctx = gl::context();
+	gl::clear();
+
+	// blending is enabled by default, so enabling it again shouldn't reach OpenGL
+	ctx->resetStateChangeCounters();
+	gl::enable( GL_BLEND );
+	check( ctx->getStateChangeCounters().mIssued == 0 && ctx->getStateChangeCounters().mElided == 1, "redundant enable is elided" );
+
+	ctx->resetStateChangeCounters();
+	{
+		gl::ScopedBlend blendScp( false );
+		check( ! glIsEnabled( GL_BLEND ), "scoped disable reaches OpenGL" );
+	}
+	check( glIsEnabled( GL_BLEND ) && ctx->getStateChangeCounters().mIssued == 2, "scoped disable is restored" );
+
+	// a capability without a slot falls back to the map
+	{
+		gl::ScopedState sampleCoverageScp( GL_SAMPLE_COVERAGE, true );
+		check( glIsEnabled( GL_SAMPLE_COVERAGE ) && ctx->getBoolState( GL_SAMPLE_COVERAGE ), "capability without a slot is tracked" );
+	}
+	check( ! glIsEnabled( GL_SAMPLE_COVERAGE ), "capability without a slot is restored" );
+
+	auto textureA = gl::Texture2d::create( 4, 4 );
+	auto textureB = gl::Texture2d::create( 4, 4 );
+	{
+		gl::ScopedTextureBind outerScp( textureA, 0 );
+		ctx->resetStateChangeCounters();
+		{
+			gl::ScopedTextureBind innerScp( textureA, 0 );
+		}
+		check( ctx->getStateChangeCounters().mIssued == 0 && ctx->getStateChangeCounters().mElided > 0, "nested bind of the same texture is elided" );
+		check( getInteger( GL_TEXTURE_BINDING_2D ) == (GLint)textureA->getId(), "texture binding matches OpenGL" );
+	}
+
+	// texture units past the flat array fall back to the map
+	const uint8_t highUnit = (uint8_t)std::min<GLint>( 40, getInteger( GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS ) - 1 );
+	{
+		gl::ScopedTextureBind highScp( textureB, highUnit );
+		gl::ScopedActiveTexture activeScp( highUnit );
+		check( getInteger( GL_TEXTURE_BINDING_2D ) == (GLint)textureB->getId() && ctx->getTextureBinding( GL_TEXTURE_2D, highUnit ) == textureB->getId(),
+			"binding on texture unit " + std::to_string( highUnit ) + " matches OpenGL" );
+	}
+
+	// deleting a texture only clears the bindings that referred to it
+	{
+		auto textureC = gl::Texture2d::create( 4, 4 );
+		gl::ScopedTextureBind bScp( textureB, 1 );
+		ctx->bindTexture( GL_TEXTURE_2D, textureC->getId(), 0 );
+		textureC.reset();
+		check( ctx->getTextureBinding( GL_TEXTURE_2D, 0 ) == 0 && ctx->getTextureBinding( GL_TEXTURE_2D, 1 ) == textureB->getId(),
+			"deleting a texture clears only its bindings" );
+	}
+
+	auto vbo = gl::Vbo::create( GL_ARRAY_BUFFER, 64 );
+	{
+		gl::ScopedBuffer outerScp( vbo );
+		ctx->resetStateChangeCounters();
+		{
+			gl::ScopedBuffer innerScp( vbo );
+		}
+		check( ctx->getStateChangeCounters().mIssued == 0, "nested bind of the same buffer is elided" );
+		check( getInteger( GL_ARRAY_BUFFER_BINDING ) == (GLint)vbo->getId(), "buffer binding matches OpenGL" );
+	}
+
+	// many draws with the same state should mostly elide
+	ctx->resetStateChangeCounters();
+	gl::setMatricesWindow( getWindowSize() );
+	for( int i = 0; i < 100; ++i )
+		gl::drawSolidRect( Rectf( 0, 0, 10, 10 ) + vec2( i, i ) );
+	const auto counters = ctx->getStateChangeCounters();
+	console() << "100 rects: " << counters.mIssued << " state changes issued, " << counters.mElided << " elided" << std::endl;
+	check( counters.mElided > counters.mIssued, "repeated draws elide most state changes" );
+
+	ctx->sanityCheck();
+	console() << ( mNumFailures ? "FAILED" : "PASSED" ) << std::endl;
+	std::exit( mNumFailures ? 1 : 0 );
+}
+
+CINDER_APP( ContextStateTestApp, RendererGl )
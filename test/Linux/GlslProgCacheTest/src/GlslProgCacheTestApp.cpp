@@ -0,0 +1,179 @@
+// Reports cold and warm startup time for creating many GlslProg variants, with the program binary cache and createAsync().
+// The cold pass compiles every variant into an empty cache, the warm passes load the same variants from the cache.
+// Works with the headless renderer (libcinder built with CINDER_HEADLESS, using EGL or OSMesa) as well as with a window.
+// Prints the timings and quits after the first frame, returning a non-zero exit code if a check failed.
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+#include "cinder/Timer.h"
+
+#include <cstdlib>
+#include <fstream>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+namespace {
+
+const int NUM_VARIANTS = 300;
+
+#if defined( CINDER_GL_ES )
+const char *VERSION_DIRECTIVE = "#version 300 es\nprecision highp float;\n";
+#else
+const char *VERSION_DIRECTIVE = "#version 150\n";
+#endif
+
+const char *VERTEX_SHADER =
+	"uniform mat4 ciModelViewProjection;\n"
+	"in vec4 ciPosition;\n"
+	"in vec4 ciColor;\n"
+	"out vec4 vColor;\n"
+	"void main() {\n"
+	"	vColor = ciColor * float( VARIANT % 7 + 1 ) / 7.0;\n"
+	"	gl_Position = ciModelViewProjection * ciPosition;\n"
+	"}\n";
+
+const char *FRAGMENT_SHADER =
+	"uniform float uScale;\n"
+	"in vec4 vColor;\n"
+	"out vec4 oColor;\n"
+	"void main() {\n"
+	"	vec4 color = vColor;\n"
+	"	for( int i = 0; i < VARIANT % 5; ++i )\n"
+	"		color = sqrt( color * uScale );\n"
+	"	oColor = color;\n"
+	"}\n";
+
+gl::GlslProg::Format variantFormat( int variant )
+{
+	return gl::GlslProg::Format()
+		.vertex( string( VERSION_DIRECTIVE ) + VERTEX_SHADER )
+		.fragment( string( VERSION_DIRECTIVE ) + FRAGMENT_SHADER )
+		.define( "VARIANT", to_string( variant ) );
+}
+
+} // anonymous namespace
+
+class GlslProgCacheTestApp : public App {
+  public:
+	void draw() override;
+
+  private:
+	void	check( bool condition, const string &description );
+	void	report( const string &pass, double seconds );
+
+	int		mNumFailures = 0;
+};
+
+void GlslProgCacheTestApp::check( bool condition, const string &description )
+{
+	console() << ( condition ? "PASS: " : "FAIL: " ) << description << endl;
+	if( ! condition )
+		mNumFailures++;
+}
+
+void GlslProgCacheTestApp::report( const string &pass, double seconds )
+{
+	const auto stats = gl::GlslProg::getCreateStats();
+	console() << pass << ": " << NUM_VARIANTS << " programs in " << seconds * 1000 << " ms, "
+		<< stats.mNumCompiled << " compiled (" << stats.mCompileSeconds * 1000 << " ms), "
+		<< stats.mNumLoadedFromCache << " loaded from cache (" << stats.mLoadSeconds * 1000 << " ms)" << endl;
+}
+
+void GlslProgCacheTestApp::draw()
+{
+	const fs::path cacheDirectory = fs::temp_directory_path() / "cinder_glslprog_cache_test";
+	fs::remove_all( cacheDirectory );
+	gl::GlslProg::setBinaryCacheDirectory( cacheDirectory );
+
+	GLint numBinaryFormats = 0;
+	glGetIntegerv( GL_NUM_PROGRAM_BINARY_FORMATS, &numBinaryFormats );
+	console() << "renderer: " << gl::getString( GL_RENDERER ) << ", " << numBinaryFormats << " program binary formats" << endl;
+
+	try {
+		// cold: every variant is compiled and stored
+		gl::GlslProg::resetCreateStats();
+		Timer timer( true );
+		vector<gl::GlslProgRef> coldProgs;
+		for( int i = 0; i < NUM_VARIANTS; ++i )
+			coldProgs.push_back( gl::GlslProg::create( variantFormat( i ) ) );
+		report( "cold", timer.getSeconds() );
+		check( gl::GlslProg::getCreateStats().mNumCompiled == NUM_VARIANTS, "cold pass compiles every variant" );
+
+		// warm: the same variants load from the cache
+		gl::GlslProg::resetCreateStats();
+		timer.start();
+		vector<gl::GlslProgRef> warmProgs;
+		for( int i = 0; i < NUM_VARIANTS; ++i )
+			warmProgs.push_back( gl::GlslProg::create( variantFormat( i ) ) );
+		report( "warm", timer.getSeconds() );
+		if( numBinaryFormats > 0 )
+			check( gl::GlslProg::getCreateStats().mNumLoadedFromCache == NUM_VARIANTS, "warm pass loads every variant from the cache" );
+
+		bool sameInterface = true;
+		for( int i = 0; i < NUM_VARIANTS; ++i ) {
+			sameInterface = sameInterface && warmProgs[i]->getActiveUniforms().size() == coldProgs[i]->getActiveUniforms().size()
+				&& warmProgs[i]->getAttribSemanticLocation( geom::POSITION ) == coldProgs[i]->getAttribSemanticLocation( geom::POSITION );
+		}
+		check( sameInterface, "cached programs have the same uniforms and attributes" );
+
+		// a different define is a different program
+		gl::GlslProg::resetCreateStats();
+		gl::GlslProg::create( variantFormat( NUM_VARIANTS ) );
+		check( gl::GlslProg::getCreateStats().mNumCompiled == 1, "a new variant misses the cache" );
+
+		// a cache file claiming a huge binary, with the binary itself truncated, is ignored instead of allocated
+		if( numBinaryFormats > 0 ) {
+			for( fs::directory_iterator it( cacheDirectory ), end; it != end; ++it ) {
+				fstream stream( it->path().string().c_str(), ios::in | ios::out | ios::binary );
+				const uint32_t hugeSize = 0xFFFFFFF0;
+				stream.seekp( 3 * sizeof( uint32_t ) );
+				stream.write( reinterpret_cast<const char*>( &hugeSize ), sizeof( hugeSize ) );
+				stream.close();
+				fs::resize_file( it->path(), 4 * sizeof( uint32_t ) + 16 );
+			}
+
+			gl::GlslProg::resetCreateStats();
+			gl::GlslProg::create( variantFormat( 0 ) );
+			check( gl::GlslProg::getCreateStats().mNumCompiled == 1, "a corrupt cache file falls back to compiling" );
+		}
+
+		// async: the warm variants are created on the worker thread while this one waits
+		gl::GlslProg::resetCreateStats();
+		timer.start();
+		vector<future<gl::GlslProgRef>> futures;
+		for( int i = 0; i < NUM_VARIANTS; ++i )
+			futures.push_back( gl::GlslProg::createAsync( variantFormat( i ) ) );
+		vector<gl::GlslProgRef> asyncProgs;
+		for( auto &result : futures )
+			asyncProgs.push_back( result.get() );
+		report( "warm async", timer.getSeconds() );
+
+		// an async program is usable on this context
+		gl::ScopedGlslProg glslProgScp( asyncProgs.back() );
+		asyncProgs.back()->uniform( "uScale", 0.5f );
+		gl::drawSolidRect( Rectf( 0, 0, 10, 10 ) );
+		check( glGetError() == GL_NO_ERROR, "async program draws on the primary context" );
+
+		auto badFormat = gl::GlslProg::Format().vertex( string( VERSION_DIRECTIVE ) + "void main() { syntax error }" ).fragment( string( VERSION_DIRECTIVE ) + FRAGMENT_SHADER );
+		bool threw = false;
+		try {
+			gl::GlslProg::createAsync( badFormat ).get();
+		}
+		catch( const gl::GlslProgCompileExc & ) {
+			threw = true;
+		}
+		check( threw, "async compile errors are rethrown by the future" );
+	}
+	catch( const std::exception &exc ) {
+		check( false, string( "unexpected exception: " ) + exc.what() );
+	}
+
+	gl::GlslProg::setBinaryCacheDirectory( fs::path() );
+	fs::remove_all( cacheDirectory );
+	std::exit( mNumFailures ? 1 : 0 );
+}
+
+CINDER_APP( GlslProgCacheTestApp, RendererGl )
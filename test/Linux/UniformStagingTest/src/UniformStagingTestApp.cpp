@@ -0,0 +1,182 @@
+// Checks that uniforms set on a GlslProg with uniform staging reach GL only when drawing, that only the changed part of an
+// array is uploaded, and that members of buffer-backed uniform blocks land in their Ubo with the layout the shader declares.
+// Works with the headless renderer (libcinder built with CINDER_HEADLESS, using EGL or OSMesa) as well as with a window.
+// Prints each check and quits after the first frame, returning a non-zero exit code if any check failed.
+
+#include "cinder/app/App.h"
+#include "cinder/app/RendererGl.h"
+#include "cinder/gl/gl.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace ci;
+using namespace ci::app;
+using namespace std;
+
+namespace {
+
+#if defined( CINDER_GL_ES )
+const char *VERSION_DIRECTIVE = "#version 300 es\nprecision highp float;\n";
+#else
+const char *VERSION_DIRECTIVE = "#version 150\n";
+#endif
+
+const char *VERTEX_SHADER =
+	"uniform mat4 ciModelViewProjection;\n"
+	"in vec4 ciPosition;\n"
+	"void main() {\n"
+	"	gl_Position = ciModelViewProjection * ciPosition;\n"
+	"}\n";
+
+// every uniform contributes to the output so that none of them is optimized away
+const char *FRAGMENT_SHADER =
+	"uniform float uScale;\n"
+	"uniform vec4 uArray[4];\n"
+	"uniform mat3 uMatrix;\n"
+	"layout(std140) uniform Params {\n"
+	"	vec4 uTint;\n"
+	"	layout(row_major) mat4 uRowMajor;\n"
+	"	mat4 uColumnMajor;\n"
+	"};\n"
+	"out vec4 oColor;\n"
+	"void main() {\n"
+	"	oColor = uTint * uScale + uArray[0] + uArray[1] + uArray[2] + uArray[3] + vec4( uMatrix * vec3( 1.0 ), 0.0 )\n"
+	"		+ uRowMajor * vec4( 1.0 ) + uColumnMajor * vec4( 1.0 );\n"
+	"}\n";
+
+// std140 offsets of the members of Params
+const GLintptr TINT_OFFSET = 0, ROW_MAJOR_OFFSET = 16, COLUMN_MAJOR_OFFSET = 80;
+
+const GLuint PARAMS_BINDING = 3;
+
+// A matrix whose elements are all different, so that a transposed upload shows
+template<typename MatT>
+MatT distinctMatrix()
+{
+	MatT result;
+	const int size = MatT::length();
+	for( int c = 0; c < size; ++c ) {
+		for( int r = 0; r < size; ++r )
+			result[c][r] = float( c * size + r + 1 );
+	}
+	return result;
+}
+
+template<typename MatT>
+bool equalMatrices( const MatT &a, const float *b )
+{
+	return memcmp( &a[0][0], b, sizeof( MatT ) ) == 0;
+}
+
+vector<float> getUniformFloats( const gl::GlslProgRef &glsl, const string &name, size_t count )
+{
+	vector<float> result( count, -1 );
+	glGetUniformfv( glsl->getHandle(), glGetUniformLocation( glsl->getHandle(), name.c_str() ), result.data() );
+	return result;
+}
+
+#if ! defined( CINDER_GL_ES )
+// Reads back \a count floats at \a offset of the Ubo bound to the Params block
+vector<float> getParamsFloats( GLintptr offset, size_t count )
+{
+	GLint ubo = 0;
+	glGetIntegeri_v( GL_UNIFORM_BUFFER_BINDING, PARAMS_BINDING, &ubo );
+	vector<float> result( count, -1 );
+	gl::ScopedBuffer bufferScp( GL_UNIFORM_BUFFER, (GLuint)ubo );
+	glGetBufferSubData( GL_UNIFORM_BUFFER, offset, count * sizeof( float ), result.data() );
+	return result;
+}
+#endif
+
+} // anonymous namespace
+
+class UniformStagingTestApp : public App {
+  public:
+	void draw() override;
+
+  private:
+	void	check( bool condition, const string &description );
+
+	int		mNumFailures = 0;
+};
+
+void UniformStagingTestApp::check( bool condition, const string &description )
+{
+	console() << ( condition ? "PASS: " : "FAIL: " ) << description << endl;
+	if( ! condition )
+		mNumFailures++;
+}
+
+void UniformStagingTestApp::draw()
+{
+	gl::ScopedMatrices matricesScp;
+	gl::setMatricesWindow( getWindowSize() );
+	const Rectf rect( 0, 0, 10, 10 );
+
+	try {
+		auto glsl = gl::GlslProg::create( gl::GlslProg::Format()
+			.vertex( string( VERSION_DIRECTIVE ) + VERTEX_SHADER )
+			.fragment( string( VERSION_DIRECTIVE ) + FRAGMENT_SHADER )
+			.uniformBufferBacking( true, PARAMS_BINDING ) );
+		check( glsl->isUniformStagingEnabled(), "uniform buffer backing enables staging" );
+
+		gl::ScopedGlslProg glslScp( glsl );
+
+		// a staged value is uploaded by the next draw, not when it is set
+		glsl->uniform( "uScale", 0.25f );
+		check( getUniformFloats( glsl, "uScale", 1 )[0] == 0, "a staged uniform is not uploaded before drawing" );
+		gl::drawSolidRect( rect );
+		check( getUniformFloats( glsl, "uScale", 1 )[0] == 0.25f, "a staged uniform is uploaded by the draw" );
+
+		const auto scaleHandle = glsl->getUniformHandle( "uScale" );
+		check( scaleHandle.isValid(), "a handle to an active uniform is valid" );
+		glsl->uniform( scaleHandle, 0.5f );
+		gl::drawSolidRect( rect );
+		check( getUniformFloats( glsl, "uScale", 1 )[0] == 0.5f, "a uniform set through its handle is uploaded by the draw" );
+
+		// only the changed element of the array is uploaded; element 0 is changed behind GlslProg's back to tell
+		const vec4 ones[4] = { vec4( 1 ), vec4( 1 ), vec4( 1 ), vec4( 1 ) };
+		glsl->uniform( "uArray", ones, 4 );
+		gl::drawSolidRect( rect );
+		glUniform4f( glGetUniformLocation( glsl->getHandle(), "uArray[0]" ), 7, 7, 7, 7 );
+		glsl->uniform( "uArray[2]", vec4( 5 ) );
+		gl::drawSolidRect( rect );
+		check( getUniformFloats( glsl, "uArray[2]", 4 ) == vector<float>( 4, 5 ), "the changed array element is uploaded" );
+		check( getUniformFloats( glsl, "uArray[1]", 4 ) == vector<float>( 4, 1 ), "unchanged array elements keep their value" );
+		check( getUniformFloats( glsl, "uArray[0]", 4 ) == vector<float>( 4, 7 ), "only the changed range of the array is uploaded" );
+
+		// a transposed staged matrix is uploaded as its transpose
+		const mat3 matrix = distinctMatrix<mat3>();
+		glsl->uniform( "uMatrix", matrix, true );
+		gl::drawSolidRect( rect );
+		check( equalMatrices( glm::transpose( matrix ), getUniformFloats( glsl, "uMatrix", 9 ).data() ), "a staged matrix set with transpose is uploaded transposed" );
+
+#if ! defined( CINDER_GL_ES )
+		// members of the buffer-backed block are written by name and uploaded by the draw
+		const vec4 tint( 0.1f, 0.2f, 0.3f, 0.4f );
+		glsl->uniform( "uTint", tint );
+		check( getParamsFloats( TINT_OFFSET, 4 ) == vector<float>( 4, 0 ), "a block member is not uploaded before drawing" );
+		gl::drawSolidRect( rect );
+		check( getParamsFloats( TINT_OFFSET, 4 ) == vector<float>( &tint[0], &tint[0] + 4 ), "a block member written by name is uploaded to its Ubo" );
+
+		// the row_major member stores the rows of the matrix, which are the columns of its transpose
+		const mat4 blockMatrix = distinctMatrix<mat4>();
+		glsl->uniform( "uRowMajor", blockMatrix );
+		glsl->uniform( "uColumnMajor", blockMatrix );
+		gl::drawSolidRect( rect );
+		check( equalMatrices( glm::transpose( blockMatrix ), getParamsFloats( ROW_MAJOR_OFFSET, 16 ).data() ), "a row_major block member is stored row by row" );
+		check( equalMatrices( blockMatrix, getParamsFloats( COLUMN_MAJOR_OFFSET, 16 ).data() ), "a column-major block member is stored column by column" );
+#endif
+
+		check( glGetError() == GL_NO_ERROR, "no OpenGL errors" );
+	}
+	catch( const std::exception &exc ) {
+		check( false, string( "unexpected exception: " ) + exc.what() );
+	}
+
+	console() << ( mNumFailures ? "FAILED" : "PASSED" ) << endl;
+	std::exit( mNumFailures ? 1 : 0 );
+}
+
+CINDER_APP( UniformStagingTestApp, RendererGl )
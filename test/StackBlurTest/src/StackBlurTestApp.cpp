@@ -16,9 +16,10 @@ class StackBlurTestApp : public App {
 	void keyDown( KeyEvent event ) override;
 	void draw() override;
 
-	void profile();
+	void profile( bool parallel );
 	
 	SurfaceT<T>		mSourceImage, mBlurredImage;
+	ip::StackBlurScratch	mBlurScratch;
 	ChannelT<T>		mSourceChannel, mBlurredChannel;
 	gl::TextureRef	mBlurredTex;
 };
@@ -43,10 +44,12 @@ void StackBlurTestApp::mouseDrag( MouseEvent event )
 void StackBlurTestApp::keyDown( KeyEvent event )
 {
 	if( event.getChar() == 'p' )
-		profile();
+		profile( false );
+	else if( event.getChar() == 'P' )
+		profile( true );
 }
 
-void StackBlurTestApp::profile()
+void StackBlurTestApp::profile( bool parallel )
 {
 	mBlurredImage.copyFrom( mSourceImage, mSourceImage.getBounds() );
 
@@ -54,11 +57,15 @@ void StackBlurTestApp::profile()
 	const int maxRadius = 777;
 	const int iterations = 1;
 	for( int radius = 0; radius < maxRadius; radius += 1 )
-		for( int i = 0; i < iterations; ++i )
-			ip::stackBlur( &mBlurredImage, radius );
+		for( int i = 0; i < iterations; ++i ) {
+			if( parallel )
+				ip::stackBlurParallel( &mBlurredImage, radius, &mBlurScratch );
+			else
+				ip::stackBlur( &mBlurredImage, radius );
+		}
 	
 	timer.stop();
-	console() << iterations * maxRadius << " iterations in " << timer.getSeconds() << std::endl;
+	console() << iterations * maxRadius << ( parallel ? " parallel" : "" ) << " iterations in " << timer.getSeconds() << std::endl;
 }
 
 void StackBlurTestApp::draw()
@@ -0,0 +1,161 @@
+// Compares the throughput of each audio::dsp vector math back-end supported by this machine against the scalar path,
+// then times an 8 band EQ on 16 channels with dsp::Biquad and dsp::BiquadCascade.
+// Run from a terminal, results are printed to stdout.
+
+#include "cinder/audio/dsp/BiquadCascade.h"
+#include "cinder/audio/dsp/Dsp.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const size_t FRAMES_PER_BLOCK = 512;
+const size_t NUM_ITERATIONS = 200000;
+const size_t EQ_CHANNELS = 16;
+const size_t EQ_BANDS = 8;
+const size_t EQ_FRAMES_PER_BLOCK = 64;
+const size_t EQ_ITERATIONS = 20000;
+
+std::vector<float> sBufferA, sBufferB, sResult;
+volatile float sSink; // keeps reductions from being optimized away
+
+struct Benchmark {
+	const char					*mName;
+	std::function<void()>		mFn;
+};
+
+// returns nanoseconds per block
+double run( const Benchmark &benchmark, size_t numIterations = NUM_ITERATIONS )
+{
+	for( size_t i = 0; i < 1000; i++ )
+		benchmark.mFn();
+
+	Timer timer( true );
+	for( size_t i = 0; i < numIterations; i++ )
+		benchmark.mFn();
+
+	return timer.getSeconds() * 1e9 / numIterations;
+}
+
+void runEqBenchmarks( const dsp::SimdBackend *backends, size_t numBackends )
+{
+	audio::Buffer buffer( EQ_FRAMES_PER_BLOCK, EQ_CHANNELS );
+	for( size_t i = 0; i < buffer.getSize(); i++ )
+		buffer[i] = randFloat( -1, 1 );
+
+	std::vector<dsp::Biquad> bands( EQ_BANDS );
+	for( size_t band = 0; band < EQ_BANDS; band++ )
+		bands[band].setPeakingParams( 0.005 * std::pow( 2.0, (double)band ), 1.5, band % 2 ? 3.0 : -3.0 );
+
+	std::vector<dsp::Biquad> biquads;
+	dsp::BiquadCascade cascadef( EQ_CHANNELS, EQ_BANDS, dsp::BiquadCascade::Precision::FLOAT );
+	dsp::BiquadCascade cascaded( EQ_CHANNELS, EQ_BANDS, dsp::BiquadCascade::Precision::DOUBLE );
+	for( size_t ch = 0; ch < EQ_CHANNELS; ch++ ) {
+		for( size_t band = 0; band < EQ_BANDS; band++ ) {
+			biquads.push_back( bands[band] );
+			cascadef.setSection( ch, band, bands[band] );
+			cascaded.setSection( ch, band, bands[band] );
+		}
+	}
+
+	const Benchmark benchmarks[] = {
+		{ "Biquad", [&] {
+			for( size_t ch = 0; ch < EQ_CHANNELS; ch++ ) {
+				float *channel = buffer.getChannel( ch );
+				for( size_t band = 0; band < EQ_BANDS; band++ )
+					biquads[ch * EQ_BANDS + band].process( channel, channel, EQ_FRAMES_PER_BLOCK );
+			}
+		} },
+		{ "cascade f32", [&] { cascadef.process( &buffer ); } },
+		{ "cascade f64", [&] { cascaded.process( &buffer ); } }
+	};
+
+	std::printf( "\n%zu band EQ on %zu channels, frames per block: %zu, microseconds per block\n", EQ_BANDS, EQ_CHANNELS, EQ_FRAMES_PER_BLOCK );
+	for( const auto &benchmark : benchmarks ) {
+		std::printf( "%-12s", benchmark.mName );
+		for( size_t i = 0; i < numBackends; i++ ) {
+			if( ! dsp::setSimdBackend( backends[i] ) )
+				continue;
+
+			std::printf( "%14.2f us   ", run( benchmark, EQ_ITERATIONS ) / 1000.0 );
+		}
+		std::printf( "\n" );
+	}
+}
+
+} // anonymous namespace
+
+int main()
+{
+	sBufferA.resize( FRAMES_PER_BLOCK );
+	sBufferB.resize( FRAMES_PER_BLOCK );
+	sResult.resize( FRAMES_PER_BLOCK );
+	for( size_t i = 0; i < FRAMES_PER_BLOCK; i++ ) {
+		sBufferA[i] = randFloat( -1, 1 );
+		sBufferB[i] = randFloat( 0.5f, 1 );
+	}
+
+	const float *a = sBufferA.data();
+	const float *b = sBufferB.data();
+	float *result = sResult.data();
+	const size_t n = FRAMES_PER_BLOCK;
+
+	const Benchmark benchmarks[] = {
+		{ "fill",			[=] { dsp::fill( 0.5f, result, n ); } },
+		{ "add scalar",		[=] { dsp::add( a, 0.5f, result, n ); } },
+		{ "add",			[=] { dsp::add( a, b, result, n ); } },
+		{ "sub",			[=] { dsp::sub( a, b, result, n ); } },
+		{ "mul scalar",		[=] { dsp::mul( a, 0.5f, result, n ); } },
+		{ "mul",			[=] { dsp::mul( a, b, result, n ); } },
+		{ "divide",			[=] { dsp::divide( a, b, result, n ); } },
+		{ "addMul",			[=] { dsp::addMul( a, b, 0.5f, result, n ); } },
+		{ "sum",			[=] { sSink = dsp::sum( a, n ); } },
+		{ "rms",			[=] { sSink = dsp::rms( a, n ); } },
+		{ "normalize",		[=] { dsp::normalize( result, n, 0.9f ); } }
+	};
+
+	const dsp::SimdBackend backends[] = { dsp::SimdBackend::SCALAR, dsp::SimdBackend::SSE2, dsp::SimdBackend::AVX2, dsp::SimdBackend::NEON, dsp::SimdBackend::VDSP };
+	const dsp::SimdBackend initial = dsp::getSimdBackend();
+
+	std::printf( "frames per block: %zu, iterations: %zu, default back-end: %s\n", FRAMES_PER_BLOCK, NUM_ITERATIONS, dsp::getSimdBackendName( initial ) );
+	std::printf( "%-12s", "" );
+	for( auto backend : backends ) {
+		if( dsp::isSimdBackendSupported( backend ) )
+			std::printf( "%20s", dsp::getSimdBackendName( backend ) );
+	}
+	std::printf( "\n" );
+
+	for( const auto &benchmark : benchmarks ) {
+		std::printf( "%-12s", benchmark.mName );
+
+		double scalarNanos = 0;
+		for( auto backend : backends ) {
+			if( ! dsp::setSimdBackend( backend ) )
+				continue;
+
+			double nanos = run( benchmark );
+			if( backend == dsp::SimdBackend::SCALAR ) {
+				scalarNanos = nanos;
+				std::printf( "%14.1f ns   ", nanos );
+			}
+			else if( scalarNanos > 0 )
+				std::printf( "%8.1f ns (%4.1fx)", nanos, scalarNanos / nanos );
+			else
+				std::printf( "%14.1f ns   ", nanos );
+		}
+		std::printf( "\n" );
+	}
+
+	runEqBenchmarks( backends, sizeof( backends ) / sizeof( backends[0] ) );
+
+	dsp::setSimdBackend( initial );
+	return 0;
+}
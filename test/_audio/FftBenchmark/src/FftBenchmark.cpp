@@ -0,0 +1,93 @@
+// Times spectral analysis of many channels at once, comparing dsp::Fft::forward() and inverse() on each channel against
+// forwardBatch() and inverseBatch(), with the scalar and the default vector back-ends.
+// Run from a terminal, results are printed to stdout.
+
+#include "cinder/audio/dsp/Fft.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const size_t NUM_CHANNELS = 32;
+const size_t FFT_SIZES[] = { 512, 2048, 8192 };
+const size_t SAMPLES_PER_SIZE = 1 << 24; // iterations are scaled so that every size transforms about as many samples
+
+struct Benchmark {
+	const char					*mName;
+	std::function<void()>		mFn;
+};
+
+// returns microseconds per call
+double run( const Benchmark &benchmark, size_t numIterations )
+{
+	for( size_t i = 0; i < numIterations / 10 + 1; i++ )
+		benchmark.mFn();
+
+	Timer timer( true );
+	for( size_t i = 0; i < numIterations; i++ )
+		benchmark.mFn();
+
+	return timer.getSeconds() * 1e6 / numIterations;
+}
+
+void runSize( size_t fftSize )
+{
+	dsp::Fft fft( fftSize );
+	audio::Buffer waveforms( fftSize, NUM_CHANNELS );
+	for( size_t i = 0; i < waveforms.getSize(); i++ )
+		waveforms[i] = randFloat( -1, 1 );
+
+	std::vector<audio::Buffer> channels( NUM_CHANNELS, audio::Buffer( fftSize ) );
+	for( size_t ch = 0; ch < NUM_CHANNELS; ch++ )
+		channels[ch].copyChannel( 0, waveforms.getChannel( ch ) );
+
+	std::vector<BufferSpectral> spectra( NUM_CHANNELS, BufferSpectral( fftSize ) );
+	fft.forwardBatch( waveforms, spectra.data() );
+
+	const Benchmark benchmarks[] = {
+		{ "forward", [&] {
+			for( size_t ch = 0; ch < NUM_CHANNELS; ch++ )
+				fft.forward( &channels[ch], &spectra[ch] );
+		} },
+		{ "forwardBatch", [&] { fft.forwardBatch( waveforms, spectra.data() ); } },
+		{ "inverse", [&] {
+			for( size_t ch = 0; ch < NUM_CHANNELS; ch++ )
+				fft.inverse( &spectra[ch], &channels[ch] );
+		} },
+		{ "inverseBatch", [&] { fft.inverseBatch( spectra.data(), &waveforms ); } }
+	};
+
+	const dsp::SimdBackend backends[] = { dsp::SimdBackend::SCALAR, dsp::getSimdBackend() };
+	const size_t numIterations = SAMPLES_PER_SIZE / ( fftSize * NUM_CHANNELS );
+
+	std::printf( "\nfft size: %zu, channels: %zu, microseconds per call\n", fftSize, NUM_CHANNELS );
+	for( const auto &benchmark : benchmarks ) {
+		std::printf( "%-14s", benchmark.mName );
+		for( auto backend : backends ) {
+			if( dsp::setSimdBackend( backend ) )
+				std::printf( "%14.1f us   ", run( benchmark, numIterations ) );
+		}
+		std::printf( "\n" );
+	}
+}
+
+} // anonymous namespace
+
+int main( int argc, char *argv[] )
+{
+	const dsp::SimdBackend initial = dsp::getSimdBackend();
+
+	std::printf( "back-ends: %s, %s\n", dsp::getSimdBackendName( dsp::SimdBackend::SCALAR ), dsp::getSimdBackendName( initial ) );
+	for( size_t fftSize : FFT_SIZES )
+		runSize( fftSize );
+
+	dsp::setSimdBackend( initial );
+	return 0;
+}
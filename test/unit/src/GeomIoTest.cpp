@@ -0,0 +1,268 @@
+#include "cinder/GeomIo.h"
+#include "cinder/AxisAlignedBox.h"
+
+#include "catch.hpp"
+
+#include <map>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// Records everything a geom::Source loads into it
+class RecordingTarget : public geom::Target {
+  public:
+	RecordingTarget( const geom::Source &source )
+		: mSource( source ), mPrimitive( geom::NUM_PRIMITIVES )
+	{
+		source.loadInto( this, source.getAvailableAttribs() );
+	}
+
+	uint8_t	getAttribDims( geom::Attrib attr ) const override { return mSource.getAttribDims( attr ); }
+
+	void copyAttrib( geom::Attrib attr, uint8_t dims, size_t strideBytes, const float *srcData, size_t count ) override
+	{
+		auto &data = mAttribs[attr];
+		data.resize( dims * count );
+		geom::copyData( dims, strideBytes, srcData, count, dims, 0, data.data() );
+	}
+
+	void copyIndices( geom::Primitive primitive, const uint32_t *source, size_t numIndices, uint8_t /*requiredBytesPerIndex*/ ) override
+	{
+		mPrimitive = primitive;
+		mIndices.assign( source, source + numIndices );
+	}
+
+	const geom::Source				&mSource;
+	map<geom::Attrib, vector<float>>	mAttribs;
+	vector<uint32_t>				mIndices;
+	geom::Primitive					mPrimitive;
+};
+
+// Counts the calls to loadInto(), which only happen when SourceMods has to regenerate the geometry
+class CountingSource : public geom::Source {
+  public:
+	CountingSource( int *numLoads )
+		: mNumLoads( numLoads )
+	{}
+
+	size_t				getNumVertices() const override { return 3; }
+	size_t				getNumIndices() const override { return 3; }
+	geom::Primitive		getPrimitive() const override { return geom::TRIANGLES; }
+	uint8_t				getAttribDims( geom::Attrib attr ) const override { return attr == geom::POSITION ? 3 : 0; }
+	geom::AttribSet		getAvailableAttribs() const override { return { geom::POSITION }; }
+	CountingSource*		clone() const override { return new CountingSource( *this ); }
+	bool				hashParams( uint64_t *hash ) const override { *hash ^= 0x1234; return true; }
+
+	void loadInto( geom::Target *target, const geom::AttribSet & /*requestedAttribs*/ ) const override
+	{
+		++*mNumLoads;
+		const float positions[] = { 0, 0, 0,	1, 0, 0,	0, 1, 0 };
+		const uint32_t indices[] = { 0, 1, 2 };
+		target->copyAttrib( geom::POSITION, 3, 0, positions, 3 );
+		target->copyIndices( geom::TRIANGLES, indices, 3, 4 );
+	}
+
+	int		*mNumLoads;
+};
+
+// Hashes identically to CountingSource but loads different geometry, as a hash collision would
+class CollidingSource : public CountingSource {
+  public:
+	CollidingSource( int *numLoads )
+		: CountingSource( numLoads )
+	{}
+
+	CollidingSource*	clone() const override { return new CollidingSource( *this ); }
+
+	void loadInto( geom::Target *target, const geom::AttribSet & /*requestedAttribs*/ ) const override
+	{
+		++*mNumLoads;
+		const float positions[] = { 5, 0, 0,	6, 0, 0,	5, 1, 0 };
+		const uint32_t indices[] = { 0, 1, 2 };
+		target->copyAttrib( geom::POSITION, 3, 0, positions, 3 );
+		target->copyIndices( geom::TRIANGLES, indices, 3, 4 );
+	}
+};
+
+uint64_t hashOf( const geom::Source &source )
+{
+	uint64_t result = 0;
+	REQUIRE( source.hashParams( &result ) );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "geom::Source" )
+{
+	SECTION( "large Sphere matches serial evaluation" )
+	{
+		// large enough to be generated in parallel
+		const int subdivisions = 400;
+		const vec3 center( 1, 2, 3 );
+		RecordingTarget target( geom::Sphere().subdivisions( subdivisions ).center( center ).radius( 2.0f ) );
+
+		const int numSegments = subdivisions + 1;
+		const int numRings = subdivisions / 2 + 1;
+		const auto &positions = target.mAttribs[geom::POSITION];
+		REQUIRE( positions.size() == size_t( numRings * numSegments * 3 ) );
+		REQUIRE( target.mIndices.size() == size_t( ( numRings - 1 ) * ( numSegments - 1 ) * 6 ) );
+
+		float ringIncr = 1.0f / (float)( numRings - 1 );
+		float segIncr = 1.0f / (float)( numSegments - 1 );
+		size_t i = 0;
+		for( int r = 0; r < numRings; r++ ) {
+			float v = r * ringIncr;
+			for( int s = 0; s < numSegments; s++, i += 3 ) {
+				float u = 1.0f - s * segIncr;
+				float x = math<float>::sin( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
+				float y = math<float>::sin( float(M_PI) * (v - 0.5f) );
+				float z = math<float>::cos( float(M_PI * 2) * u ) * math<float>::sin( float(M_PI) * v );
+				REQUIRE( positions[i + 0] == x * 2.0f + center.x );
+				REQUIRE( positions[i + 1] == y * 2.0f + center.y );
+				REQUIRE( positions[i + 2] == z * 2.0f + center.z );
+			}
+		}
+
+		// the last row of triangles references the last ring
+		const size_t lastRow = ( numRings - 2 ) * ( numSegments - 1 ) * 6;
+		REQUIRE( target.mIndices[lastRow + 0] == uint32_t( ( numRings - 2 ) * numSegments + 1 ) );
+		REQUIRE( target.mIndices[lastRow + 2] == uint32_t( ( numRings - 1 ) * numSegments + 1 ) );
+	}
+
+	SECTION( "Sphere reports the counts it loads" )
+	{
+		for( int subdivisions : { 0, 3, 12, 400 } ) {
+			geom::Sphere sphere = geom::Sphere().subdivisions( subdivisions );
+			RecordingTarget target( sphere );
+			REQUIRE( target.mAttribs[geom::POSITION].size() == sphere.getNumVertices() * 3 );
+			REQUIRE( target.mIndices.size() == sphere.getNumIndices() );
+		}
+	}
+
+	SECTION( "large Torus and TorusKnot are well formed" )
+	{
+		geom::Torus torus;
+		torus.subdivisionsAxis( 300 ).subdivisionsHeight( 300 ).radius( 1.0f, 0.5f ).colors();
+		RecordingTarget torusTarget( torus );
+		REQUIRE( torusTarget.mAttribs[geom::POSITION].size() == torus.getNumVertices() * 3 );
+		REQUIRE( torusTarget.mAttribs[geom::COLOR].size() == torus.getNumVertices() * 3 );
+		REQUIRE( torusTarget.mIndices.size() == torus.getNumIndices() );
+
+		// every vertex lies on a tube of radius (major - minor) around a circle of radius minor
+		const auto &positions = torusTarget.mAttribs[geom::POSITION];
+		for( size_t i = 0; i < positions.size(); i += 3 ) {
+			vec3 p( positions[i], positions[i + 1], positions[i + 2] );
+			float distanceFromAxis = length( vec2( p.x, p.z ) );
+			float tubeDistance = length( vec2( distanceFromAxis - 0.5f, p.y ) );
+			REQUIRE( fabs( tubeDistance - 0.5f ) < 0.0001f );
+		}
+
+		geom::TorusKnot knot;
+		knot.subdivisionsAxis( 64 ).subdivisionsHeight( 1024 );
+		RecordingTarget knotTarget( knot );
+		REQUIRE( knotTarget.mIndices.size() == knot.getNumIndices() );
+
+		for( auto *target : { &torusTarget, &knotTarget } ) {
+			size_t numVertices = target->mAttribs[geom::POSITION].size() / 3;
+			for( size_t i = 0; i < target->mIndices.size(); i += 3 ) {
+				REQUIRE( target->mIndices[i + 0] < numVertices );
+				REQUIRE( target->mIndices[i + 1] < numVertices );
+				REQUIRE( target->mIndices[i + 2] < numVertices );
+				// no degenerate triangles
+				REQUIRE( target->mIndices[i + 0] != target->mIndices[i + 1] );
+			}
+		}
+	}
+
+	SECTION( "hashParams distinguishes parameters" )
+	{
+		REQUIRE( hashOf( geom::Sphere() ) == hashOf( geom::Sphere() ) );
+		REQUIRE( hashOf( geom::Sphere() ) != hashOf( geom::Sphere().radius( 2 ) ) );
+		REQUIRE( hashOf( geom::Torus() ) != hashOf( geom::Helix() ) );
+		REQUIRE( hashOf( geom::Sphere() >> geom::Translate( 1, 0, 0 ) ) == hashOf( geom::Sphere() >> geom::Translate( 1, 0, 0 ) ) );
+		REQUIRE( hashOf( geom::Sphere() >> geom::Translate( 1, 0, 0 ) ) != hashOf( geom::Sphere() >> geom::Translate( 2, 0, 0 ) ) );
+		REQUIRE( hashOf( geom::Sphere() >> geom::Lines() ) != hashOf( geom::Sphere() >> geom::Subdivide() ) );
+
+		REQUIRE( hashOf( geom::Cube() ) != hashOf( geom::Cube().size( 2, 1, 1 ) ) );
+		REQUIRE( hashOf( geom::Cylinder() ) != hashOf( geom::Cone() ) );
+		REQUIRE( hashOf( geom::Cylinder() ) != hashOf( geom::Cylinder().subdivisionsCap( 4 ) ) );
+		REQUIRE( hashOf( geom::Plane() ) != hashOf( geom::WirePlane() ) );
+		REQUIRE( hashOf( geom::Circle() ) != hashOf( geom::Circle().radius( 2 ) ) );
+		REQUIRE( hashOf( geom::Icosphere() ) != hashOf( geom::Icosphere().subdivisions( 4 ) ) );
+		REQUIRE( hashOf( geom::WireCube() ) == hashOf( geom::WireCube() ) );
+		REQUIRE( hashOf( geom::Cube() >> geom::Constant( geom::COLOR, vec3( 1, 0, 0 ) ) ) != hashOf( geom::Cube() >> geom::Constant( geom::COLOR, vec3( 0, 1, 0 ) ) ) );
+
+		Shape2d square, triangle;
+		square.moveTo( 0, 0 ); square.lineTo( 1, 0 ); square.lineTo( 1, 1 ); square.lineTo( 0, 1 ); square.close();
+		triangle.moveTo( 0, 0 ); triangle.lineTo( 1, 0 ); triangle.lineTo( 1, 1 ); triangle.close();
+		REQUIRE( hashOf( geom::Extrude( square, 1 ) ) == hashOf( geom::Extrude( square, 1 ) ) );
+		REQUIRE( hashOf( geom::Extrude( square, 1 ) ) != hashOf( geom::Extrude( triangle, 1 ) ) );
+
+		// output that depends on a callback, or a modifier with side effects, can't be identified
+		AxisAlignedBox bounds;
+		uint64_t hash = 0;
+		REQUIRE( ! ( geom::Sphere() >> geom::Bounds( &bounds ) ).hashParams( &hash ) );
+		REQUIRE( ! ( geom::Sphere() >> geom::ColorFromAttrib( geom::POSITION, []( vec3 ) { return Colorf::white(); } ) ).hashParams( &hash ) );
+	}
+
+	SECTION( "SourceMods cache returns memoized geometry" )
+	{
+		geom::SourceMods::clearCache();
+
+		int numLoads = 0;
+		auto chain = CountingSource( &numLoads ) >> geom::Translate( 1, 2, 3 );
+		RecordingTarget uncached( chain );
+		REQUIRE( numLoads == 1 );
+
+		chain.cache();
+		RecordingTarget first( chain );
+		RecordingTarget second( chain );
+		geom::SourceMods chainCopy = chain;
+		RecordingTarget copy( chainCopy );
+		REQUIRE( numLoads == 2 );
+		REQUIRE( geom::SourceMods::getCacheSize() == 1 );
+
+		for( auto *target : { &first, &second, &copy } ) {
+			REQUIRE( target->mAttribs == uncached.mAttribs );
+			REQUIRE( target->mIndices == uncached.mIndices );
+			REQUIRE( target->mPrimitive == geom::TRIANGLES );
+		}
+
+		// a different chain misses
+		auto other = ( CountingSource( &numLoads ) >> geom::Translate( 3, 2, 1 ) ).cache();
+		RecordingTarget otherTarget( other );
+		REQUIRE( numLoads == 3 );
+		REQUIRE( otherTarget.mAttribs[geom::POSITION][0] == 3.0f );
+
+		// a chain whose hash collides but whose types differ misses too, and replaces the entry
+		auto colliding = ( CollidingSource( &numLoads ) >> geom::Translate( 1, 2, 3 ) ).cache();
+		uint64_t chainHash = 0, collidingHash = 0;
+		REQUIRE( ( chain.hashParams( &chainHash ) && colliding.hashParams( &collidingHash ) ) );
+		REQUIRE( chainHash == collidingHash );
+		RecordingTarget collidingTarget( colliding );
+		REQUIRE( numLoads == 4 );
+		REQUIRE( collidingTarget.mAttribs[geom::POSITION][0] == 6.0f );
+
+		// chains that can't be hashed are loaded every time
+		AxisAlignedBox bounds;
+		auto unhashable = ( CountingSource( &numLoads ) >> geom::Bounds( &bounds ) ).cache();
+		RecordingTarget unhashable1( unhashable );
+		RecordingTarget unhashable2( unhashable );
+		REQUIRE( numLoads == 6 );
+		REQUIRE( bounds.getMax().x == Approx( 1 ) );
+		REQUIRE( bounds.getMax().y == Approx( 1 ) );
+
+		geom::SourceMods::setCacheCapacity( 1 );
+		REQUIRE( geom::SourceMods::getCacheSize() == 1 );
+		RecordingTarget evicted( chain );
+		REQUIRE( numLoads == 7 );
+		REQUIRE( evicted.mAttribs == uncached.mAttribs );
+
+		geom::SourceMods::clearCache();
+		geom::SourceMods::setCacheCapacity( 32 );
+		REQUIRE( geom::SourceMods::getCacheSize() == 0 );
+	}
+}
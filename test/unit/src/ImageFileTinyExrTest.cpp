@@ -0,0 +1,331 @@
+#include "cinder/ImageFileTinyExr.h"
+#include "cinder/Stream.h"
+#include "cinder/Buffer.h"
+
+#include "tinyexr/tinyexr.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// every value is an integer below 2048, which half floats represent exactly
+float sampleValue( int32_t x, int32_t y, size_t channel )
+{
+	return float( ( x * 3 + y * 5 + channel * 7 ) % 2000 );
+}
+
+template<typename T>
+void append( vector<uint8_t> *data, T value )
+{
+	const uint8_t *bytes = reinterpret_cast<const uint8_t*>( &value );
+	data->insert( data->end(), bytes, bytes + sizeof( T ) );
+}
+
+void appendAttribute( vector<uint8_t> *data, const string &name, const string &type, const vector<uint8_t> &value )
+{
+	data->insert( data->end(), name.c_str(), name.c_str() + name.size() + 1 );
+	data->insert( data->end(), type.c_str(), type.c_str() + type.size() + 1 );
+	append( data, int32_t( value.size() ) );
+	data->insert( data->end(), value.begin(), value.end() );
+}
+
+// Compresses a block the way OpenEXR does for RLE: even bytes then odd ones, delta predicted, then run length encoded.
+vector<uint8_t> compressBlock( const vector<uint8_t> &raw, int compression )
+{
+	if( compression == TINYEXR_COMPRESSIONTYPE_NONE )
+		return raw;
+
+	vector<uint8_t> predicted( raw.size() );
+	const size_t numEven = ( raw.size() + 1 ) / 2;
+	for( size_t i = 0; i < raw.size(); ++i )
+		predicted[( i & 1 ) ? numEven + i / 2 : i / 2] = raw[i];
+	for( size_t i = raw.size() - 1; i > 0; --i )
+		predicted[i] = uint8_t( predicted[i] - predicted[i - 1] + 128 );
+
+	vector<uint8_t> result;
+	for( size_t i = 0; i < predicted.size(); ) {
+		size_t run = 1;
+		while( i + run < predicted.size() && run < 128 && predicted[i + run] == predicted[i] )
+			run++;
+		if( run >= 3 ) {
+			result.push_back( uint8_t( run - 1 ) );
+			result.push_back( predicted[i] );
+		}
+		else {
+			run = std::min<size_t>( predicted.size() - i, 2 );
+			result.push_back( uint8_t( -int( run ) ) );
+			result.insert( result.end(), predicted.begin() + i, predicted.begin() + i + run );
+		}
+		i += run;
+	}
+
+	// blocks that compression doesn't shrink are stored as they are
+	return ( result.size() < raw.size() ) ? result : raw;
+}
+
+// Builds a half float OpenEXR file with NONE or RLE compression, tiled when \a tileSize is not zero. Channel names must be sorted.
+BufferRef buildExr( int32_t width, int32_t height, const vector<string> &channels, int compression, ivec2 tileSize = ivec2( 0 ) )
+{
+	vector<uint8_t> file = { 0x76, 0x2f, 0x31, 0x01 };
+	append( &file, int32_t( tileSize.x ? 0x202 : 2 ) );
+
+	vector<uint8_t> chlist, window, tiles;
+	for( const auto &name : channels ) {
+		chlist.insert( chlist.end(), name.c_str(), name.c_str() + name.size() + 1 );
+		for( int32_t value : { TINYEXR_PIXELTYPE_HALF, 0, 1, 1 } )
+			append( &chlist, value );
+	}
+	chlist.push_back( 0 );
+	for( int32_t value : { 0, 0, width - 1, height - 1 } )
+		append( &window, value );
+
+	appendAttribute( &file, "channels", "chlist", chlist );
+	appendAttribute( &file, "compression", "compression", { uint8_t( compression ) } );
+	appendAttribute( &file, "dataWindow", "box2i", window );
+	appendAttribute( &file, "displayWindow", "box2i", window );
+	appendAttribute( &file, "lineOrder", "lineOrder", { 0 } );
+	if( tileSize.x ) {
+		append( &tiles, uint32_t( tileSize.x ) );
+		append( &tiles, uint32_t( tileSize.y ) );
+		tiles.push_back( 0 ); // one level
+		appendAttribute( &file, "tiles", "tiledesc", tiles );
+	}
+	file.push_back( 0 );
+
+	const ivec2 blockSize = tileSize.x ? tileSize : ivec2( width, 1 );
+	const ivec2 numBlocks( ( width + blockSize.x - 1 ) / blockSize.x, ( height + blockSize.y - 1 ) / blockSize.y );
+	vector<vector<uint8_t>> blocks;
+	for( int32_t by = 0; by < numBlocks.y; ++by ) {
+		for( int32_t bx = 0; bx < numBlocks.x; ++bx ) {
+			const Area area( bx * blockSize.x, by * blockSize.y, std::min( ( bx + 1 ) * blockSize.x, width ), std::min( ( by + 1 ) * blockSize.y, height ) );
+			vector<uint8_t> raw;
+			for( int32_t y = area.y1; y < area.y2; ++y )
+				for( size_t c = 0; c < channels.size(); ++c )
+					for( int32_t x = area.x1; x < area.x2; ++x )
+						append( &raw, floatToHalf( sampleValue( x, y, c ) ).u );
+
+			vector<uint8_t> block;
+			if( tileSize.x ) {
+				for( int32_t value : { bx, by, 0, 0 } )
+					append( &block, value );
+			}
+			else
+				append( &block, area.y1 );
+			const auto data = compressBlock( raw, compression );
+			append( &block, int32_t( data.size() ) );
+			block.insert( block.end(), data.begin(), data.end() );
+			blocks.push_back( block );
+		}
+	}
+
+	uint64_t offset = file.size() + blocks.size() * 8;
+	for( const auto &block : blocks ) {
+		append( &file, offset );
+		offset += block.size();
+	}
+	for( const auto &block : blocks )
+		file.insert( file.end(), block.begin(), block.end() );
+
+	auto buffer = make_shared<Buffer>( file.size() );
+	memcpy( buffer->getData(), file.data(), file.size() );
+	return buffer;
+}
+
+// Writes RGBA half floats with TinyExr's own encoder.
+BufferRef saveWithTinyExr( int32_t width, int32_t height, int compression )
+{
+	vector<vector<uint16_t>> planes( 4, vector<uint16_t>( width * height ) );
+	const size_t sampleChannels[4] = { 3, 2, 1, 0 }; // A, B, G and R hold the samples of R, G, B and A
+	unsigned char *images[4];
+	for( size_t c = 0; c < 4; ++c ) {
+		for( int32_t y = 0; y < height; ++y )
+			for( int32_t x = 0; x < width; ++x )
+				planes[c][y * width + x] = floatToHalf( sampleValue( x, y, sampleChannels[c] ) ).u;
+		images[c] = reinterpret_cast<unsigned char *>( planes[c].data() );
+	}
+
+	EXRImage image;
+	InitEXRImage( &image );
+	image.num_channels = 4;
+	image.width = width;
+	image.height = height;
+	image.images = images;
+
+	vector<EXRChannelInfo> info( 4 );
+	int pixelTypes[4], requestedPixelTypes[4];
+	const char *names[4] = { "A", "B", "G", "R" };
+	for( size_t c = 0; c < 4; ++c ) {
+		strcpy( info[c].name, names[c] );
+		pixelTypes[c] = requestedPixelTypes[c] = TINYEXR_PIXELTYPE_HALF;
+	}
+
+	EXRHeader header;
+	InitEXRHeader( &header );
+	header.num_channels = 4;
+	header.channels = info.data();
+	header.pixel_types = pixelTypes;
+	header.requested_pixel_types = requestedPixelTypes;
+	header.compression_type = compression;
+
+	unsigned char *memory = nullptr;
+	const char *error = nullptr;
+	const size_t size = SaveEXRImageToMemory( &image, &header, &memory, &error );
+	REQUIRE( size > 0 );
+	auto buffer = make_shared<Buffer>( size );
+	memcpy( buffer->getData(), memory, size );
+	free( memory );
+	return buffer;
+}
+
+Surface32f loadExr( const BufferRef &buffer, const ImageSource::Options &options = ImageSource::Options() )
+{
+	return Surface32f( ImageSourceFileTinyExr::create( DataSourceBuffer::create( buffer ), options ) );
+}
+
+// Returns whether every pixel matches sampleValue(), with \a channels giving the sample channel of R, G, B and A.
+bool matchesSamples( const Surface32f &surface, int32_t width, int32_t height, const vector<size_t> &channels )
+{
+	if( surface.getSize() != ivec2( width, height ) )
+		return false;
+
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			const ColorAf pixel = surface.getPixel( ivec2( x, y ) );
+			for( size_t c = 0; c < channels.size(); ++c ) {
+				if( pixel[int( c )] != sampleValue( x, y, channels[c] ) )
+					return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+// Collects half float rows, one thread at a time.
+class ImageTargetHalf : public ImageTarget {
+  public:
+	ImageTargetHalf( int32_t width, int32_t height )
+		: mRows( width * height * 4 )
+	{
+		setSize( width, height );
+		setDataType( ImageIo::FLOAT16 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::RGBA );
+	}
+
+	bool	hasAlpha() const override						{ return true; }
+	void*	getRowPointer( int32_t row ) override			{ return &mRows[row * mWidth * 4]; }
+
+	vector<uint16_t>	mRows;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ImageFileTinyExr" )
+{
+	const int32_t width = 67, height = 45;
+	const vector<string> rgba = { "A", "B", "G", "R" };
+
+	SECTION( "half float conversion" )
+	{
+		REQUIRE( floatToHalf( 1.0f ).u == 0x3c00 );
+		REQUIRE( floatToHalf( -21.0f ).u == 0xcd40 );
+		half_float smallest;
+		smallest.u = 1;
+		REQUIRE( halfToFloat( smallest ) == 1.0f / ( 1 << 24 ) );
+		REQUIRE( floatToHalf( halfToFloat( smallest ) ).u == 1 );
+	}
+
+	SECTION( "scanline compressions" )
+	{
+		for( int compression : { TINYEXR_COMPRESSIONTYPE_NONE, TINYEXR_COMPRESSIONTYPE_RLE } )
+			REQUIRE( matchesSamples( loadExr( buildExr( width, height, rgba, compression ) ), width, height, { 3, 2, 1, 0 } ) );
+
+		// ZIP blocks compressed by TinyExr, and PIZ, which is decoded by TinyExr
+		for( int compression : { TINYEXR_COMPRESSIONTYPE_ZIPS, TINYEXR_COMPRESSIONTYPE_ZIP, TINYEXR_COMPRESSIONTYPE_PIZ } )
+			REQUIRE( matchesSamples( loadExr( saveWithTinyExr( width, height, compression ) ), width, height, { 0, 1, 2, 3 } ) );
+	}
+
+	SECTION( "tiled images" )
+	{
+		for( int compression : { TINYEXR_COMPRESSIONTYPE_NONE, TINYEXR_COMPRESSIONTYPE_RLE } ) {
+			for( ivec2 tileSize : { ivec2( 16, 16 ), ivec2( 32, 8 ), ivec2( 128, 64 ) } )
+				REQUIRE( matchesSamples( loadExr( buildExr( width, height, rgba, compression, tileSize ) ), width, height, { 3, 2, 1, 0 } ) );
+		}
+	}
+
+	SECTION( "selected channels" )
+	{
+		const auto buffer = buildExr( width, height, { "A", "B", "G", "R", "depth.Z" }, TINYEXR_COMPRESSIONTYPE_RLE, ivec2( 16, 16 ) );
+		auto source = std::dynamic_pointer_cast<ImageSourceFileTinyExr>( ImageSourceFileTinyExr::create( DataSourceBuffer::create( buffer ) ) );
+		REQUIRE( source->getChannelNames() == vector<string>( { "A", "B", "G", "R", "depth.Z" } ) );
+		REQUIRE( source->hasAlpha() );
+
+		auto depth = ImageSourceFileTinyExr::create( DataSourceBuffer::create( buffer ), ImageSource::Options().channels( { "depth.Z" } ) );
+		REQUIRE( depth->getColorModel() == ImageIo::CM_GRAY );
+		REQUIRE( matchesSamples( Surface32f( depth ), width, height, { 4, 4, 4 } ) );
+
+		const Surface32f bgr = loadExr( buffer, ImageSource::Options().channels( { "B", "G", "R" } ) );
+		REQUIRE( ! bgr.hasAlpha() );
+		REQUIRE( matchesSamples( bgr, width, height, { 1, 2, 3 } ) );
+
+		REQUIRE_THROWS_AS( loadExr( buffer, ImageSource::Options().channels( { "R", "missing" } ) ), const ImageIoExceptionFailedLoadTinyExr & );
+	}
+
+	SECTION( "half float and 8 bit targets" )
+	{
+		const auto buffer = saveWithTinyExr( width, height, TINYEXR_COMPRESSIONTYPE_ZIP );
+		auto source = ImageSourceFileTinyExr::create( DataSourceBuffer::create( buffer ) );
+		REQUIRE( source->getDataType() == ImageIo::FLOAT16 );
+
+		auto half = make_shared<ImageTargetHalf>( width, height );
+		source->load( half );
+		REQUIRE( source->getDataType() == ImageIo::FLOAT16 );
+		REQUIRE( half->mRows[( 7 * width + 9 ) * 4 + 0] == floatToHalf( sampleValue( 9, 7, 0 ) ).u );
+		REQUIRE( half->mRows[( 44 * width + 66 ) * 4 + 3] == floatToHalf( sampleValue( 66, 44, 3 ) ).u );
+
+		// every sample is at least 1, so clamps to 255
+		const Surface8u clamped( source );
+		REQUIRE( clamped.getPixel( ivec2( 20, 30 ) ) == ColorA8u( 255, 255, 255, 255 ) );
+	}
+
+	SECTION( "parallel writer" )
+	{
+		Surface32f surface( width, height, true );
+		for( int32_t y = 0; y < height; ++y )
+			for( int32_t x = 0; x < width; ++x )
+				surface.setPixel( ivec2( x, y ), ColorAf( sampleValue( x, y, 0 ), sampleValue( x, y, 1 ), sampleValue( x, y, 2 ), sampleValue( x, y, 3 ) ) );
+
+		for( int level : { -1, 0, 1, 9 } ) {
+			for( size_t numThreads : { 0, 1, 3 } ) {
+				auto stream = OStreamMem::create();
+				writeImage( ImageTargetFileTinyExr::create( DataTargetStream::createRef( stream ), surface, ImageTarget::Options().compressionLevel( level ).numThreads( numThreads ), "exr" ), surface );
+
+				auto buffer = make_shared<Buffer>( (size_t)stream->tell() );
+				memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+				REQUIRE( matchesSamples( loadExr( buffer ), width, height, { 0, 1, 2, 3 } ) );
+
+				// TinyExr reads the result too
+				EXRVersion version;
+				EXRHeader header;
+				EXRImage image;
+				const char *error = nullptr;
+				const auto memory = static_cast<const unsigned char *>( buffer->getData() );
+				InitEXRHeader( &header );
+				InitEXRImage( &image );
+				REQUIRE( ParseEXRVersionFromMemory( &version, memory ) == TINYEXR_SUCCESS );
+				REQUIRE( ParseEXRHeaderFromMemory( &header, &version, memory, &error ) == TINYEXR_SUCCESS );
+				REQUIRE( header.compression_type == ( level > 0 ? TINYEXR_COMPRESSIONTYPE_ZIP : TINYEXR_COMPRESSIONTYPE_NONE ) );
+				REQUIRE( LoadEXRImageFromMemory( &image, &header, memory, &error ) == TINYEXR_SUCCESS );
+				half_float red;
+				red.u = reinterpret_cast<uint16_t*>( image.images[3] )[11 * width + 5];
+				REQUIRE( halfToFloat( red ) == sampleValue( 5, 11, 0 ) );
+				FreeEXRImage( &image );
+				FreeEXRHeader( &header );
+			}
+		}
+	}
+}
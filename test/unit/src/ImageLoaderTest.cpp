@@ -0,0 +1,179 @@
+#include "cinder/ImageLoader.h"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <fstream>
+#include <thread>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+const string EXTENSION = "cinderunitimage";
+
+atomic<int> sNumStarted( 0 ), sNumDecodes( 0 );
+
+// Decodes files holding "<width> <height>" into an RGB gradient, slowly enough that concurrent requests overlap. Any other contents fail to load.
+class ImageSourceTest : public ImageSource {
+  public:
+	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options /*options*/ )	{ return ImageSourceRef( new ImageSourceTest( dataSource ) ); }
+
+	ImageSourceTest( DataSourceRef dataSource )
+	{
+		sNumStarted++;
+		this_thread::sleep_for( chrono::milliseconds( 20 ) );
+		auto buffer = dataSource->getBuffer();
+		string contents( (const char *)buffer->getData(), buffer->getSize() );
+		if( sscanf( contents.c_str(), "%d %d", &mWidth, &mHeight ) != 2 )
+			throw ImageIoExceptionFailedLoad( "not a test image" );
+
+		setDataType( ImageIo::UINT8 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::RGB );
+		sNumDecodes++;
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		ImageSource::RowFunc func = setupRowFunc( target );
+		vector<uint8_t> row( mWidth * 3 );
+		for( int32_t y = 0; y < mHeight; ++y ) {
+			for( int32_t x = 0; x < mWidth; ++x ) {
+				row[x * 3 + 0] = uint8_t( x );
+				row[x * 3 + 1] = uint8_t( y );
+				row[x * 3 + 2] = 0;
+			}
+			( ( *this ).*func )( target, y, row.data() );
+		}
+	}
+};
+
+fs::path writeTestImage( const string &name, const string &contents )
+{
+	const auto path = fs::temp_directory_path() / ( "cinder_unit_" + name + "." + EXTENSION );
+	ofstream( path.string() ) << contents;
+	return path;
+}
+
+void waitForPending( ImageLoader &loader )
+{
+	for( int i = 0; i < 500 && loader.getNumPending() != 0; ++i ) {
+		this_thread::sleep_for( chrono::milliseconds( 5 ) );
+		loader.update();
+	}
+	loader.update();
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageLoader" )
+{
+	static bool sRegistered = false;
+	if( ! sRegistered ) {
+		ImageIoRegistrar::registerSourceType( EXTENSION, ImageSourceTest::create );
+		sRegistered = true;
+	}
+
+	const auto small = writeTestImage( "small", "16 8" );
+	const auto large = writeTestImage( "large", "64 64" );
+	const auto invalid = writeTestImage( "invalid", "not an image" );
+	const size_t smallBytes = 16 * 3 * 8, largeBytes = 64 * 3 * 64;
+
+	SECTION( "duplicate requests share a decode and are cached" )
+	{
+		sNumDecodes = 0;
+		auto loader = ImageLoader::create( ImageLoader::Options().numThreads( 2 ).connectToAppUpdate( false ) );
+
+		int numSmall = 0, numLarge = 0, numSignaled = 0;
+		loader->getSignalLoaded().connect( [&]( const ImageLoader::Result & ) { numSignaled++; } );
+		for( int i = 0; i < 3; ++i ) {
+			loader->load( small, [&]( const ImageLoader::Result &result ) {
+				REQUIRE( result.getPath() == small );
+				REQUIRE( result.getSurface()->getSize() == ivec2( 16, 8 ) );
+				REQUIRE( result.getSurface()->getPixel( ivec2( 5, 3 ) ) == ColorA8u( 5, 3, 0, 255 ) );
+				numSmall++;
+			} );
+		}
+		loader->load( large, [&]( const ImageLoader::Result & ) { numLarge++; } );
+
+		// callbacks only fire from update()
+		REQUIRE( numSmall == 0 );
+		waitForPending( *loader );
+		REQUIRE( numSmall == 3 );
+		REQUIRE( numLarge == 1 );
+		REQUIRE( numSignaled == 2 );
+		REQUIRE( sNumDecodes == 2 );
+		REQUIRE( loader->getNumCached() == 2 );
+		REQUIRE( loader->getCacheSize() == smallBytes + largeBytes );
+
+		bool fromCache = false;
+		loader->load( small, [&]( const ImageLoader::Result &result ) { fromCache = result.isFromCache(); } );
+		waitForPending( *loader );
+		REQUIRE( fromCache );
+		REQUIRE( sNumDecodes == 2 );
+		REQUIRE( loader->getCached( small ) == loader->getCached( small ) );
+	}
+
+	SECTION( "cache is bounded by bytes and evicts the least recently used image" )
+	{
+		auto loader = ImageLoader::create( ImageLoader::Options().numThreads( 1 ).connectToAppUpdate( false ).cacheCapacity( largeBytes + smallBytes ) );
+		loader->load( small );
+		loader->load( large );
+		waitForPending( *loader );
+		REQUIRE( loader->isCached( small ) );
+		REQUIRE( loader->isCached( large ) );
+
+		// touching small makes large the eviction candidate
+		REQUIRE( loader->getCached( small ) );
+		loader->setCacheCapacity( largeBytes );
+		REQUIRE( loader->isCached( small ) );
+		REQUIRE( ! loader->isCached( large ) );
+		REQUIRE( loader->getCacheSize() == smallBytes );
+
+		// images larger than the whole cache are delivered but not cached
+		Surface8uRef delivered;
+		loader->setCacheCapacity( smallBytes );
+		loader->load( large, [&]( const ImageLoader::Result &result ) { delivered = result.getSurface(); } );
+		waitForPending( *loader );
+		REQUIRE( delivered );
+		REQUIRE( ! loader->isCached( large ) );
+
+		loader->clearCache();
+		REQUIRE( loader->getNumCached() == 0 );
+		REQUIRE( loader->getCacheSize() == 0 );
+	}
+
+	SECTION( "failures and cancelation" )
+	{
+		auto loader = ImageLoader::create( ImageLoader::Options().numThreads( 1 ).connectToAppUpdate( false ) );
+
+		string error;
+		const int numStarted = sNumStarted;
+		loader->load( invalid, [&]( const ImageLoader::Result &result ) {
+			REQUIRE( ! result.getSurface() );
+			error = result.getError();
+		} );
+
+		// once the single worker is busy with the invalid image, the other requests stay queued
+		while( sNumStarted == numStarted )
+			this_thread::yield();
+
+		bool canceledCalled = false;
+		loader->load( small, [&]( const ImageLoader::Result & ) { canceledCalled = true; } );
+		loader->load( large );
+		REQUIRE( loader->cancel( small ) );
+		REQUIRE( ! loader->cancel( small ) );
+		loader->cancelAll();
+
+		waitForPending( *loader );
+		REQUIRE( ! error.empty() );
+		REQUIRE( ! canceledCalled );
+		REQUIRE( loader->getNumCached() == 0 );
+	}
+
+	fs::remove( small );
+	fs::remove( large );
+	fs::remove( invalid );
+}
@@ -0,0 +1,149 @@
+#include "cinder/ImageIo.h"
+#include "cinder/Buffer.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+int sNumRowsDecoded = 0;
+
+// Produces an RGB image of the size written in its data source, where each pixel is ( x, y, x + y ). Sources created
+// through the "cinderunitregion" extension apply Options::area() and maxSize() themselves, the others are wrapped by loadImage().
+class ImageSourceGradient : public ImageSource {
+  public:
+	static ImageSourceRef createRegion( DataSourceRef dataSource, ImageSource::Options options )	{ return ImageSourceRef( new ImageSourceGradient( dataSource, options, true ) ); }
+	static ImageSourceRef createFull( DataSourceRef dataSource, ImageSource::Options options )		{ return ImageSourceRef( new ImageSourceGradient( dataSource, options, false ) ); }
+
+	ImageSourceGradient( DataSourceRef dataSource, const ImageSource::Options &options, bool region )
+	{
+		auto buffer = dataSource->getBuffer();
+		string contents( (const char *)buffer->getData(), buffer->getSize() );
+		sscanf( contents.c_str(), "%d %d", &mWidth, &mHeight );
+		mFullWidth = mWidth;
+
+		setDataType( ImageIo::UINT8 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::RGB );
+		if( region && options.isRegionSpecified() )
+			setupRegion( options );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		ImageSource::RowFunc func = setupRowFunc( target );
+		vector<uint8_t> row( mFullWidth * 3 );
+		for( int32_t y = 0; ; ++y ) {
+			for( int32_t x = 0; x < mFullWidth; ++x ) {
+				row[x * 3 + 0] = uint8_t( x );
+				row[x * 3 + 1] = uint8_t( y );
+				row[x * 3 + 2] = uint8_t( x + y );
+			}
+			sNumRowsDecoded++;
+			if( ! processRow( target, func, y, row.data() ) )
+				break;
+		}
+	}
+
+	int32_t		mFullWidth;
+};
+
+ImageSourceRef loadGradientSource( const string &extension, int32_t width, int32_t height, const ImageSource::Options &options = ImageSource::Options() )
+{
+	const string size = to_string( width ) + " " + to_string( height );
+	auto buffer = make_shared<Buffer>( size.size() );
+	memcpy( buffer->getData(), size.data(), size.size() );
+
+	sNumRowsDecoded = 0;
+	return loadImage( DataSourceBuffer::create( buffer ), options, extension );
+}
+
+Surface8u loadGradient( const string &extension, int32_t width, int32_t height, const ImageSource::Options &options = ImageSource::Options() )
+{
+	return Surface8u( loadGradientSource( extension, width, height, options ) );
+}
+
+bool surfacesEqual( const Surface8u &a, const Surface8u &b )
+{
+	if( a.getSize() != b.getSize() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getPixel( ivec2( x, y ) ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageSourceRegion" )
+{
+	static bool sRegistered = false;
+	if( ! sRegistered ) {
+		ImageIoRegistrar::registerSourceType( "cinderunitregion", ImageSourceGradient::createRegion );
+		ImageIoRegistrar::registerSourceType( "cinderunitfull", ImageSourceGradient::createFull );
+		sRegistered = true;
+	}
+
+	SECTION( "whole image" )
+	{
+		auto surface = loadGradient( "cinderunitregion", 100, 60 );
+		REQUIRE( surface.getSize() == ivec2( 100, 60 ) );
+		REQUIRE( surface.getPixel( ivec2( 99, 59 ) ) == ColorA8u( 99, 59, 158, 255 ) );
+		REQUIRE( sNumRowsDecoded == 60 );
+	}
+
+	SECTION( "area" )
+	{
+		const auto options = ImageSource::Options().area( Area( 10, 20, 50, 40 ) );
+		auto surface = loadGradient( "cinderunitregion", 100, 60, options );
+		REQUIRE( surface.getSize() == ivec2( 40, 20 ) );
+		REQUIRE( surface.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 10, 20, 30, 255 ) );
+		REQUIRE( surface.getPixel( ivec2( 39, 19 ) ) == ColorA8u( 49, 39, 88, 255 ) );
+		// the source stops once the last row of the area has been decoded
+		REQUIRE( sNumRowsDecoded == 40 );
+
+		REQUIRE( surfacesEqual( surface, loadGradient( "cinderunitfull", 100, 60, options ) ) );
+
+		// areas are clipped to the image, and must overlap it
+		REQUIRE( loadGradient( "cinderunitregion", 100, 60, ImageSource::Options().area( Area( 90, 50, 200, 200 ) ) ).getSize() == ivec2( 10, 10 ) );
+		REQUIRE_THROWS_AS( loadGradient( "cinderunitregion", 100, 60, ImageSource::Options().area( Area( 200, 0, 300, 10 ) ) ), const ImageIoException & );
+	}
+
+	SECTION( "max size" )
+	{
+		auto source = loadGradientSource( "cinderunitregion", 100, 60, ImageSource::Options().maxSize( ivec2( 30, 30 ) ) );
+		REQUIRE( source->isRegionApplied() );
+		REQUIRE( source->getSourceArea() == Area( 0, 0, 100, 60 ) );
+		REQUIRE( source->getReduction() == 4 );
+		REQUIRE( ! loadGradientSource( "cinderunitregion", 100, 60 )->isRegionApplied() );
+
+		// 100 x 60 in 30 x 30 is reduced by a factor of 4, with each pixel the average of a 4 x 4 box
+		const auto options = ImageSource::Options().maxSize( ivec2( 30, 30 ) );
+		auto surface = loadGradient( "cinderunitregion", 100, 60, options );
+		REQUIRE( surface.getSize() == ivec2( 25, 15 ) );
+		REQUIRE( surface.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 2, 2, 3, 255 ) );
+		REQUIRE( surface.getPixel( ivec2( 10, 5 ) ) == ColorA8u( 42, 22, 63, 255 ) );
+		REQUIRE( sNumRowsDecoded == 60 );
+
+		REQUIRE( surfacesEqual( surface, loadGradient( "cinderunitfull", 100, 60, options ) ) );
+
+		// a single bound limits only that dimension
+		REQUIRE( loadGradient( "cinderunitregion", 100, 60, ImageSource::Options().maxSize( ivec2( 0, 20 ) ) ).getSize() == ivec2( 33, 20 ) );
+	}
+
+	SECTION( "area and max size" )
+	{
+		const auto options = ImageSource::Options().area( Area( 8, 4, 88, 44 ) ).maxSize( ivec2( 16, 16 ) );
+		auto surface = loadGradient( "cinderunitfull", 100, 60, options );
+		REQUIRE( surface.getSize() == ivec2( 16, 8 ) );
+		REQUIRE( surface.getPixel( ivec2( 1, 1 ) ) == ColorA8u( 15, 11, 26, 255 ) );
+		REQUIRE( surfacesEqual( surface, loadGradient( "cinderunitregion", 100, 60, options ) ) );
+	}
+}
@@ -0,0 +1,118 @@
+#include "cinder/ImageIo.h"
+#include "cinder/Rand.h"
+#include "cinder/Surface.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// Emits random 8-bit rows in any channel order, for comparing the row conversion kernels with the generic row functions.
+class ImageSourceRandom : public ImageSource {
+  public:
+	ImageSourceRandom( int32_t width, int32_t height, ImageIo::ColorModel colorModel, ImageIo::ChannelOrder channelOrder )
+	{
+		mWidth = width;
+		mHeight = height;
+		setDataType( ImageIo::UINT8 );
+		setColorModel( colorModel );
+		setChannelOrder( channelOrder );
+
+		Rand rand( width * 31 + height );
+		mData.resize( width * height * channelOrderNumChannels( channelOrder ) );
+		for( auto &value : mData )
+			value = uint8_t( rand.nextUint( 256 ) );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		ImageSource::RowFunc func = setupRowFunc( target );
+		const size_t rowBytes = getRowBytes();
+		for( int32_t y = 0; y < mHeight; ++y )
+			( ( *this ).*func )( target, y, mData.data() + y * rowBytes );
+	}
+
+	vector<uint8_t>		mData;
+};
+
+struct OrderConstraints : public SurfaceConstraints {
+	OrderConstraints( SurfaceChannelOrder order ) : mOrder( order ) {}
+
+	SurfaceChannelOrder	getChannelOrder( bool /*alpha*/ ) const override	{ return mOrder; }
+
+	SurfaceChannelOrder	mOrder;
+};
+
+template<typename T>
+SurfaceT<T> loadSurface( const ImageSourceRef &source, SurfaceChannelOrder order, bool kernels )
+{
+	ImageSource::setRowFuncKernelsEnabled( kernels );
+	SurfaceT<T> result( source, OrderConstraints( order ), order.hasAlpha() );
+	ImageSource::setRowFuncKernelsEnabled( true );
+	return result;
+}
+
+template<typename T>
+bool surfacesEqual( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || a.getChannelOrder().getCode() != b.getChannelOrder().getCode() )
+		return false;
+
+	const size_t rowBytes = a.getWidth() * a.getPixelInc() * sizeof( T );
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ivec2( 0, y ) ), b.getData( ivec2( 0, y ) ), rowBytes ) != 0 )
+			return false;
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageSourceRowFunc" )
+{
+	const ImageIo::ChannelOrder rgbSources[] = { ImageIo::RGB, ImageIo::BGR, ImageIo::RGBA, ImageIo::BGRA, ImageIo::ARGB, ImageIo::ABGR };
+	const ImageIo::ChannelOrder graySources[] = { ImageIo::Y, ImageIo::YA };
+	const SurfaceChannelOrder targets[] = { SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR, SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR };
+	// widths around the vector sizes exercise both the vector loops and the scalar tails
+	const int32_t widths[] = { 1, 3, 4, 5, 7, 16, 17, 31, 37, 64 };
+
+	SECTION( "8-bit targets match the generic conversion" )
+	{
+		for( int32_t width : widths ) {
+			for( auto sourceOrder : rgbSources ) {
+				auto source = make_shared<ImageSourceRandom>( width, 3, ImageIo::CM_RGB, sourceOrder );
+				for( const auto &target : targets )
+					REQUIRE( surfacesEqual( loadSurface<uint8_t>( source, target, true ), loadSurface<uint8_t>( source, target, false ) ) );
+			}
+			for( auto sourceOrder : graySources ) {
+				auto source = make_shared<ImageSourceRandom>( width, 3, ImageIo::CM_GRAY, sourceOrder );
+				for( const auto &target : targets )
+					REQUIRE( surfacesEqual( loadSurface<uint8_t>( source, target, true ), loadSurface<uint8_t>( source, target, false ) ) );
+			}
+		}
+	}
+
+	SECTION( "float targets match the generic conversion" )
+	{
+		for( int32_t width : widths ) {
+			for( auto sourceOrder : rgbSources ) {
+				auto source = make_shared<ImageSourceRandom>( width, 3, ImageIo::CM_RGB, sourceOrder );
+				for( const auto &target : targets )
+					REQUIRE( surfacesEqual( loadSurface<float>( source, target, true ), loadSurface<float>( source, target, false ) ) );
+			}
+		}
+	}
+
+	SECTION( "missing alpha is opaque" )
+	{
+		auto source = make_shared<ImageSourceRandom>( 20, 1, ImageIo::CM_GRAY, ImageIo::Y );
+		auto surface = loadSurface<uint8_t>( source, SurfaceChannelOrder::BGRA, true );
+		for( int32_t x = 0; x < 20; ++x ) {
+			const uint8_t gray = source->mData[x];
+			REQUIRE( surface.getPixel( ivec2( x, 0 ) ) == ColorA8u( gray, gray, gray, 255 ) );
+		}
+	}
+}
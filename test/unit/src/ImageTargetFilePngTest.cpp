@@ -0,0 +1,155 @@
+#include "cinder/ImageTargetFilePng.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/ImageWriter.h"
+#include "cinder/Stream.h"
+#include "cinder/Buffer.h"
+
+#include "catch.hpp"
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// a pattern with smooth and noisy regions, so that every filter gets picked by the adaptive one
+template<typename T>
+SurfaceT<T> makePattern( int32_t width, int32_t height, bool alpha )
+{
+	SurfaceT<T> surface( width, height, alpha );
+	uint32_t noise = 12345;
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			noise = noise * 1664525 + 1013904223;
+			const T n = T( noise >> 16 );
+			const T a = T( ( x * 7 + y * 3 ) * 131 );
+			surface.setPixel( ivec2( x, y ), ColorAT<T>( T( x * 257 ), ( y < height / 2 ) ? T( y * 257 ) : n, a, T( ~a ) ) );
+		}
+	}
+	return surface;
+}
+
+Surface8u encodeAndDecode( const ImageSourceRef &source, const ImageTarget::Options &options, size_t *numBytes = nullptr )
+{
+	auto stream = OStreamMem::create();
+	writeImage( DataTargetStream::createRef( stream ), source, options, "png" );
+
+	auto buffer = make_shared<Buffer>( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	if( numBytes )
+		*numBytes = buffer->getSize();
+
+	return Surface8u( loadImage( DataSourceBuffer::create( buffer ), ImageSource::Options(), "png" ) );
+}
+
+bool surfacesEqual( const Surface8u &a, const Surface8u &b )
+{
+	if( a.getSize() != b.getSize() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getPixel( ivec2( x, y ) ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageTargetFilePng" )
+{
+	ImageTargetFilePng::registerSelf();
+	ImageSourceFileStbImage::registerSelf();
+
+	// 300 x 4 bytes per row makes bands of a couple hundred rows, so several threads produce several bands
+	const auto rgba = makePattern<uint8_t>( 300, 517, true );
+	const auto rgb = makePattern<uint8_t>( 300, 517, false );
+
+	SECTION( "every filter round trips, on one thread and split into bands" )
+	{
+		const ImageTarget::Options::PngFilter filters[] = { ImageTarget::Options::PNG_FILTER_NONE, ImageTarget::Options::PNG_FILTER_SUB, ImageTarget::Options::PNG_FILTER_UP,
+			ImageTarget::Options::PNG_FILTER_AVERAGE, ImageTarget::Options::PNG_FILTER_PAETH, ImageTarget::Options::PNG_FILTER_ADAPTIVE };
+
+		for( auto filter : filters ) {
+			for( size_t numThreads : { 1, 4 } ) {
+				const auto options = ImageTarget::Options().pngFilter( filter ).numThreads( numThreads );
+				REQUIRE( surfacesEqual( encodeAndDecode( rgba, options ), rgba ) );
+				REQUIRE( surfacesEqual( encodeAndDecode( rgb, options ), rgb ) );
+			}
+		}
+	}
+
+	SECTION( "gray and 16 bit sources" )
+	{
+		const auto options = ImageTarget::Options().numThreads( 3 );
+		auto converted = encodeAndDecode( rgb, ImageTarget::Options( options ).colorModel( ImageIo::CM_GRAY ) );
+		const ColorA8u convertedPixel = converted.getPixel( ivec2( 10, 400 ) );
+		REQUIRE( converted.getSize() == rgb.getSize() );
+		REQUIRE( ( convertedPixel.r == convertedPixel.g && convertedPixel.g == convertedPixel.b ) );
+
+		Channel8u gray( rgb.getWidth(), rgb.getHeight() );
+		for( int32_t y = 0; y < gray.getHeight(); ++y )
+			for( int32_t x = 0; x < gray.getWidth(); ++x )
+				gray.setValue( ivec2( x, y ), uint8_t( x + y ) );
+		auto decodedGray = encodeAndDecode( gray, options );
+		REQUIRE( decodedGray.getPixel( ivec2( 40, 300 ) ) == ColorA8u( 84, 84, 84, 255 ) );
+
+		// 16 bit sources are written as 16 bit, which decode to their high bytes
+		const auto wide = makePattern<uint16_t>( 120, 90, true );
+		auto decodedWide = encodeAndDecode( wide, options );
+		for( int32_t y = 0; y < wide.getHeight(); y += 7 ) {
+			for( int32_t x = 0; x < wide.getWidth(); x += 5 ) {
+				const ColorAT<uint16_t> expected = wide.getPixel( ivec2( x, y ) );
+				REQUIRE( decodedWide.getPixel( ivec2( x, y ) ) == ColorA8u( expected.r >> 8, expected.g >> 8, expected.b >> 8, expected.a >> 8 ) );
+			}
+		}
+	}
+
+	SECTION( "compression level" )
+	{
+		size_t stored, fast, best;
+		encodeAndDecode( rgb, ImageTarget::Options().compressionLevel( 0 ), &stored );
+		encodeAndDecode( rgb, ImageTarget::Options().compressionLevel( 1 ), &fast );
+		REQUIRE( surfacesEqual( encodeAndDecode( rgb, ImageTarget::Options().compressionLevel( 9 ), &best ), rgb ) );
+		REQUIRE( stored > rgb.getWidth() * rgb.getHeight() * 3 );
+		REQUIRE( fast < stored );
+		REQUIRE( best < stored );
+	}
+}
+
+TEST_CASE( "ImageWriter" )
+{
+	ImageTargetFilePng::registerSelf();
+	ImageSourceFileStbImage::registerSelf();
+
+	const auto surface = makePattern<uint8_t>( 64, 48, true );
+	vector<fs::path> paths;
+	for( int i = 0; i < 5; ++i )
+		paths.push_back( fs::temp_directory_path() / ( "cinder_unit_writer_" + to_string( i ) + ".png" ) );
+
+	auto writer = ImageWriter::create( ImageWriter::Options().numThreads( 2 ).maxQueued( 1 ).connectToAppUpdate( false ) );
+
+	int numWritten = 0, numSignaled = 0;
+	string error;
+	writer->getSignalWritten().connect( [&]( const ImageWriter::Result & ) { numSignaled++; } );
+	for( const auto &path : paths )
+		writer->write( path, surface, ImageTarget::Options(), "", [&]( const ImageWriter::Result & ) { numWritten++; } );
+	writer->write( paths[0].string() + ".unknownextension", surface, ImageTarget::Options(), "", [&]( const ImageWriter::Result &result ) { error = result.getError(); } );
+
+	writer->flush();
+	// callbacks only fire from update()
+	REQUIRE( numWritten == 0 );
+	REQUIRE( writer->getNumPending() == paths.size() + 1 );
+	writer->update();
+	REQUIRE( numWritten == (int)paths.size() );
+	REQUIRE( numSignaled == (int)paths.size() + 1 );
+	REQUIRE( ! error.empty() );
+	REQUIRE( writer->getNumPending() == 0 );
+
+	for( const auto &path : paths ) {
+		REQUIRE( surfacesEqual( Surface8u( loadImage( path ) ), surface ) );
+		fs::remove( path );
+	}
+}
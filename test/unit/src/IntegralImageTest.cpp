@@ -0,0 +1,94 @@
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/Rand.h"
+
+#include "catch.hpp"
+
+#include <cstring>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+Channel8u randomChannel( int32_t width, int32_t height, uint32_t seed )
+{
+	Rand rnd( seed );
+	Channel8u result( width, height );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x )
+			*result.getData( x, y ) = (uint8_t)rnd.nextInt( 256 );
+	}
+	return result;
+}
+
+uint64_t bruteForceSum( const Channel8u &channel, const Area &area )
+{
+	uint64_t result = 0;
+	for( int32_t y = area.y1; y < area.y2; ++y ) {
+		for( int32_t x = area.x1; x < area.x2; ++x )
+			result += channel.getValue( ivec2( x, y ) );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::IntegralImage" )
+{
+	SECTION( "box sums match brute force" )
+	{
+		Rand rnd( 7 );
+		// widths straddle the 16 pixel SIMD blocks
+		for( int32_t width : { 1, 15, 16, 17, 53 } ) {
+			Channel8u channel = randomChannel( width, 23, width );
+			ip::IntegralImage integral32( channel );
+			ip::IntegralImage64u integral64( channel );
+			ip::IntegralImage64f integralDouble( channel );
+			REQUIRE( integral32.getSize() == channel.getSize() );
+
+			for( int i = 0; i < 50; ++i ) {
+				int32_t x1 = rnd.nextInt( width + 1 ), x2 = rnd.nextInt( width + 1 );
+				int32_t y1 = rnd.nextInt( 24 ), y2 = rnd.nextInt( 24 );
+				const Area area( std::min( x1, x2 ), std::min( y1, y2 ), std::max( x1, x2 ), std::max( y1, y2 ) );
+				const uint64_t expected = bruteForceSum( channel, area );
+				REQUIRE( integral32.getSum( area ) == expected );
+				REQUIRE( integral64.getSum( area ) == expected );
+				REQUIRE( integralDouble.getSum( area ) == (double)expected );
+			}
+
+			REQUIRE( integral32.getSum( Area( -5, -5, width + 5, 100 ) ) == bruteForceSum( channel, channel.getBounds() ) );
+		}
+	}
+
+	SECTION( "strided Channels" )
+	{
+		Surface8u surface( 40, 30, true );
+		Channel8u &green = surface.getChannelGreen();
+		REQUIRE( green.getIncrement() == 4 );
+		Channel8u packed = randomChannel( 40, 30, 3 );
+		green.copyFrom( packed, packed.getBounds() );
+
+		ip::IntegralImage fromStrided( green ), fromPacked( packed );
+		REQUIRE( memcmp( fromStrided.getData(), fromPacked.getData(), 41 * 31 * sizeof( uint32_t ) ) == 0 );
+	}
+
+	SECTION( "adaptiveThreshold compares against the centered box mean" )
+	{
+		Channel8u channel = randomChannel( 61, 47, 11 );
+		ip::IntegralImage integral( channel );
+		for( int32_t windowSize : { 1, 8, 15, 200 } ) {
+			Channel8u result( channel.getWidth(), channel.getHeight() );
+			ip::adaptiveThreshold( integral, channel, windowSize, 0.1f, &result );
+
+			const int32_t s2 = windowSize / 2;
+			for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+				for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+					const Area box = Area( x - s2, y - s2, x + s2 + 1, y + s2 + 1 ).getClipBy( channel.getBounds() );
+					const bool below = (double)channel.getValue( ivec2( x, y ) ) * box.calcArea() < (double)bruteForceSum( channel, box ) * ( 1.0 - 0.1f );
+					REQUIRE( result.getValue( ivec2( x, y ) ) == ( below ? 0 : 255 ) );
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,180 @@
+#include "cinder/LockFreeCircularBuffer.h"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// Copies throw once the shared countdown reaches zero
+struct ThrowingCopy {
+	ThrowingCopy( int value, int *copiesLeft ) : mValue( value ), mCopiesLeft( copiesLeft ) {}
+	ThrowingCopy( const ThrowingCopy &other )
+		: mValue( other.mValue ), mCopiesLeft( other.mCopiesLeft )
+	{
+		if( (*mCopiesLeft)-- <= 0 )
+			throw std::runtime_error( "copy failed" );
+	}
+	ThrowingCopy( ThrowingCopy &&other ) noexcept = default;
+	ThrowingCopy& operator=( ThrowingCopy &&other ) noexcept = default;
+
+	int		mValue;
+	int		*mCopiesLeft;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "LockFreeCircularBuffer" )
+{
+	SECTION( "single thread matches ConcurrentCircularBuffer" )
+	{
+		LockFreeCircularBuffer<int> buffer( 10 );
+		REQUIRE( buffer.getCapacity() == 10 );
+		for( int i = 0; i < 10; ++i )
+			buffer.pushFront( i );
+
+		REQUIRE( buffer.getSize() == 10 );
+		REQUIRE( buffer.isNotEmpty() );
+		REQUIRE( ! buffer.isNotFull() );
+		int temp;
+		REQUIRE( ! buffer.tryPushFront( 11 ) );
+		for( int i = 0; i < 10; ++i ) {
+			buffer.popBack( &temp );
+			REQUIRE( temp == i );
+		}
+		REQUIRE( ! buffer.tryPopBack( &temp ) );
+		REQUIRE( ! buffer.isNotEmpty() );
+		REQUIRE( buffer.isNotFull() );
+	}
+
+	SECTION( "zero capacity is rejected" )
+	{
+		REQUIRE_THROWS_AS( LockFreeCircularBuffer<int>( 0 ), const ci::Exception & );
+	}
+
+	SECTION( "a throwing copy leaves the buffer usable" )
+	{
+		int copiesLeft = 1;
+		LockFreeCircularBuffer<ThrowingCopy> buffer( 2 );
+		buffer.pushFront( ThrowingCopy( 1, &copiesLeft ) );
+		REQUIRE_THROWS_AS( buffer.pushFront( ThrowingCopy( 2, &copiesLeft ) ), const std::runtime_error & );
+		REQUIRE_THROWS_AS( buffer.tryPushFront( ThrowingCopy( 3, &copiesLeft ) ), const std::runtime_error & );
+		REQUIRE( buffer.getSize() == 1 );
+
+		ThrowingCopy item( 0, &copiesLeft );
+		REQUIRE( buffer.tryPopBack( &item ) );
+		REQUIRE( item.mValue == 1 );
+		REQUIRE( ! buffer.tryPopBack( &item ) );
+
+		copiesLeft = 1;
+		REQUIRE( buffer.tryPushFront( ThrowingCopy( 4, &copiesLeft ) ) );
+		buffer.popBack( &item );
+		REQUIRE( item.mValue == 4 );
+	}
+
+	SECTION( "batch pop wraps around" )
+	{
+		LockFreeCircularBuffer<string> buffer( 7 );
+		int next = 0, expected = 0;
+		string items[5];
+		for( int iteration = 0; iteration < 20; iteration++ ) {
+			while( buffer.tryPushFront( to_string( next ) ) )
+				next++;
+
+			size_t count = buffer.tryPopBack( items, 5 );
+			REQUIRE( count == 5 );
+			for( size_t i = 0; i < count; i++ )
+				REQUIRE( items[i] == to_string( expected++ ) );
+		}
+
+		REQUIRE( buffer.tryPopBack( items, 5 ) == 2 );
+		REQUIRE( buffer.tryPopBack( items, 5 ) == 0 );
+	}
+
+	SECTION( "remaining items are destroyed" )
+	{
+		auto item = make_shared<int>( 1 );
+		{
+			LockFreeCircularBuffer<shared_ptr<int>> buffer( 4 );
+			buffer.pushFront( item );
+			buffer.pushFront( item );
+			shared_ptr<int> popped;
+			buffer.popBack( &popped );
+			REQUIRE( item.use_count() == 3 );
+		}
+		REQUIRE( item.use_count() == 1 );
+	}
+
+	SECTION( "many producers and consumers" )
+	{
+		LockFreeCircularBuffer<uint64_t> buffer( 64 );
+		const size_t numProducers = 4, numConsumers = 3;
+		const uint64_t numItemsPerProducer = 20000;
+
+		atomic<uint64_t> sum( 0 ), numPopped( 0 );
+		vector<thread> threads;
+		for( size_t p = 0; p < numProducers; p++ ) {
+			threads.emplace_back( [&, p] {
+				for( uint64_t i = 0; i < numItemsPerProducer; i++ )
+					buffer.pushFront( p * numItemsPerProducer + i + 1 );
+			} );
+		}
+		for( size_t c = 0; c < numConsumers; c++ ) {
+			threads.emplace_back( [&, c] {
+				uint64_t items[16];
+				while( numPopped < numProducers * numItemsPerProducer ) {
+					size_t count = 1;
+					if( c == 0 )
+						count = buffer.tryPopBack( items, 16 ); // one consumer drains in batches
+					else if( ! buffer.tryPopBack( items ) )
+						count = 0;
+
+					for( size_t i = 0; i < count; i++ )
+						sum += items[i];
+					numPopped += count;
+					if( ! count )
+						this_thread::yield();
+				}
+			} );
+		}
+
+		for( auto &thread : threads )
+			thread.join();
+
+		const uint64_t n = numProducers * numItemsPerProducer;
+		REQUIRE( numPopped == n );
+		REQUIRE( sum == n * ( n + 1 ) / 2 );
+		REQUIRE( buffer.getSize() == 0 );
+	}
+
+	SECTION( "cancel wakes waiting threads" )
+	{
+		LockFreeCircularBuffer<int> buffer( 2 );
+		atomic<bool> popReturned( false );
+		thread consumer( [&] {
+			int item;
+			buffer.popBack( &item );
+			popReturned = true;
+		} );
+
+		this_thread::sleep_for( chrono::milliseconds( 20 ) );
+		REQUIRE( ! popReturned );
+		buffer.cancel();
+		consumer.join();
+		REQUIRE( popReturned );
+
+		// after cancel, blocking calls return immediately
+		buffer.pushFront( 1 );
+		buffer.pushFront( 2 );
+		buffer.pushFront( 3 );
+		REQUIRE( buffer.getSize() == 0 );
+	}
+}
@@ -0,0 +1,156 @@
+#include "cinder/MappedTriMesh.h"
+#include "cinder/DataSource.h"
+#include "cinder/Buffer.h"
+
+#include "catch.hpp"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+fs::path tempMeshPath( const string &name )
+{
+	return fs::temp_directory_path() / ( "cinder_unit_" + name + ".trimesh" );
+}
+
+vector<char> readFile( const fs::path &path )
+{
+	ifstream stream( path.string(), ios::binary );
+	return vector<char>( istreambuf_iterator<char>( stream ), istreambuf_iterator<char>() );
+}
+
+void writeFile( const fs::path &path, const vector<char> &contents )
+{
+	ofstream stream( path.string(), ios::binary );
+	stream.write( contents.data(), contents.size() );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "MappedTriMesh" )
+{
+	SECTION( "round trip of a geom::Source" )
+	{
+		const auto path = tempMeshPath( "torus" );
+		auto source = geom::Torus().subdivisionsAxis( 40 ).subdivisionsHeight( 20 ).colors();
+		MappedTriMeshWriter::write( path, source );
+
+		TriMesh expected( source );
+		auto mapped = MappedTriMesh::create( path );
+		REQUIRE( mapped->getVersion() == 1 );
+		REQUIRE( mapped->getNumVertices() == expected.getNumVertices() );
+		REQUIRE( mapped->getNumIndices() == expected.getNumIndices() );
+		REQUIRE( mapped->getAvailableAttribs() == expected.getAvailableAttribs() );
+		REQUIRE( mapped->getAttribDims( geom::COLOR ) == 3 );
+
+		// every array is aligned for SIMD access
+		REQUIRE( reinterpret_cast<uintptr_t>( mapped->getIndices() ) % 64 == 0 );
+		REQUIRE( reinterpret_cast<uintptr_t>( mapped->getPositions<3>() ) % 64 == 0 );
+		REQUIRE( reinterpret_cast<uintptr_t>( mapped->getNormals() ) % 64 == 0 );
+
+		REQUIRE( equal( expected.getIndices().begin(), expected.getIndices().end(), mapped->getIndices() ) );
+		REQUIRE( equal( expected.getBufferPositions().begin(), expected.getBufferPositions().end(), (const float*)mapped->getPositions<3>() ) );
+		REQUIRE( equal( expected.getNormals().begin(), expected.getNormals().end(), mapped->getNormals() ) );
+		REQUIRE( equal( expected.getBufferColors().begin(), expected.getBufferColors().end(), mapped->getAttribData( geom::COLOR ) ) );
+		REQUIRE( mapped->getAttribData( geom::BONE_WEIGHT ) == nullptr );
+
+		// a TriMesh loaded from the mapping matches the original
+		TriMesh copy( *mapped );
+		REQUIRE( copy.getIndices() == expected.getIndices() );
+		REQUIRE( copy.getBufferTexCoords0() == expected.getBufferTexCoords0() );
+
+		// loading from a DataSource that isn't a file uses the buffer
+		auto contents = readFile( path );
+		auto buffer = make_shared<Buffer>( contents.size() );
+		memcpy( buffer->getData(), contents.data(), contents.size() );
+		auto fromBuffer = MappedTriMesh::create( DataSourceBuffer::create( buffer ) );
+		REQUIRE( ! fromBuffer->isMapped() );
+		REQUIRE( equal( mapped->getIndices(), mapped->getIndices() + mapped->getNumIndices(), fromBuffer->getIndices() ) );
+
+		mapped.reset();
+		fs::remove( path );
+	}
+
+	SECTION( "writer appends in pieces" )
+	{
+		const auto path = tempMeshPath( "pieces" );
+		const size_t numVertices = 1000;
+		vector<vec3> positions( numVertices );
+		vector<vec2> texCoords( numVertices );
+		vector<uint32_t> indices;
+		for( size_t i = 0; i < numVertices; ++i ) {
+			positions[i] = vec3( float( i ), 1, 2 );
+			texCoords[i] = vec2( 0.5f, float( i ) );
+		}
+		for( uint32_t i = 0; i + 2 < numVertices; ++i ) {
+			indices.push_back( i );
+			indices.push_back( i + 1 );
+			indices.push_back( i + 2 );
+		}
+
+		{
+			MappedTriMeshWriter writer( path, TriMesh::Format().positions().texCoords(), numVertices, indices.size() );
+			// interleave the attributes to make sure each lands in its own section
+			for( size_t i = 0; i < numVertices; i += 100 ) {
+				writer.appendAttrib( geom::TEX_COORD_0, (const float*)&texCoords[i], 100 );
+				writer.appendAttrib( geom::POSITION, (const float*)&positions[i], 100 );
+			}
+			writer.appendIndices( indices.data(), indices.size() / 2 - 1 );
+			REQUIRE_THROWS_AS( writer.appendAttrib( geom::POSITION, (const float*)positions.data(), 1 ), const MappedTriMeshExc & );
+			REQUIRE_THROWS_AS( writer.appendAttrib( geom::NORMAL, (const float*)positions.data(), 1 ), const MappedTriMeshExc & );
+			writer.appendIndices( indices.data() + indices.size() / 2 - 1, indices.size() - indices.size() / 2 + 1 );
+			REQUIRE( writer.getNumIndicesAppended() == indices.size() );
+			writer.finish();
+		}
+
+		auto mapped = MappedTriMesh::create( loadFile( path ) );
+		REQUIRE( mapped->isMapped() );
+		REQUIRE( mapped->getNumVertices() == numVertices );
+		REQUIRE( mapped->getNumTriangles() == indices.size() / 3 );
+		REQUIRE( equal( positions.begin(), positions.end(), mapped->getPositions<3>() ) );
+		REQUIRE( equal( texCoords.begin(), texCoords.end(), (const vec2*)mapped->getAttribData( geom::TEX_COORD_0 ) ) );
+		REQUIRE( equal( indices.begin(), indices.end(), mapped->getIndices() ) );
+
+		mapped.reset();
+		fs::remove( path );
+	}
+
+	SECTION( "incomplete and invalid files are rejected" )
+	{
+		const auto path = tempMeshPath( "invalid" );
+		{
+			MappedTriMeshWriter writer( path, TriMesh::Format().positions(), 10, 3 );
+			const uint32_t indices[] = { 0, 1, 2 };
+			writer.appendIndices( indices, 3 );
+			REQUIRE_THROWS_AS( writer.finish(), const MappedTriMeshExc & );
+		}
+
+		MappedTriMeshWriter::write( path, geom::Cube() );
+		auto contents = readFile( path );
+
+		auto truncated = contents;
+		truncated.resize( truncated.size() - 4 );
+		writeFile( path, truncated );
+		REQUIRE_THROWS_AS( MappedTriMesh::create( path ), const MappedTriMeshExc & );
+
+		auto badMagic = contents;
+		badMagic[0] = 'X';
+		writeFile( path, badMagic );
+		REQUIRE_THROWS_AS( MappedTriMesh::create( path ), const MappedTriMeshExc & );
+
+		auto badVersion = contents;
+		badVersion[8] = 99;
+		writeFile( path, badVersion );
+		REQUIRE_THROWS_AS( MappedTriMesh::create( path ), const MappedTriMeshExc & );
+
+		writeFile( path, contents );
+		REQUIRE( MappedTriMesh::create( path )->getNumIndices() == geom::Cube().getNumIndices() );
+
+		fs::remove( path );
+		REQUIRE_THROWS_AS( MappedTriMesh::create( path ), const MappedTriMeshExc & );
+	}
+}
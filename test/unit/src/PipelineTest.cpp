@@ -0,0 +1,131 @@
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Hdr.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/Rand.h"
+
+#include "catch.hpp"
+
+#include <cstring>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+template<typename T>
+SurfaceT<T> randomSurface( int32_t width, int32_t height, bool alpha, uint32_t seed )
+{
+	Rand rnd( seed );
+	SurfaceT<T> result( width, height, alpha );
+	auto iter = result.getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			iter.g() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			iter.b() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+			if( alpha )
+				iter.a() = CHANTRAIT<T>::convert( (uint8_t)rnd.nextInt( 256 ) );
+		}
+	}
+	return result;
+}
+
+template<typename T>
+bool identical( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || a.isPremultiplied() != b.isPremultiplied() )
+		return false;
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ivec2( 0, y ) ), b.getData( ivec2( 0, y ) ), a.getWidth() * a.getPixelBytes() ) )
+			return false;
+	}
+	return true;
+}
+
+// ip::edgeDetectSobel() into a cleared Surface, which is what Pipeline::edgeDetectSobel() is defined as
+template<typename T>
+void edgeDetectSobelCleared( SurfaceT<T> *surface )
+{
+	SurfaceT<T> result( surface->getWidth(), surface->getHeight(), surface->hasAlpha(), surface->getChannelOrder() );
+	ip::fill( &result, ColorAT<T>( 0, 0, 0, 0 ) );
+	ip::edgeDetectSobel( *surface, &result );
+	result.setPremultiplied( surface->isPremultiplied() );
+	*surface = std::move( result );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::Pipeline" )
+{
+	const ivec2 tileSizes[] = { ivec2( 17, 13 ), ivec2( 64, 64 ), ivec2( 1000, 3 ) };
+
+	SECTION( "neighbourhood operations match sequential ip:: calls" )
+	{
+		for( bool alpha : { false, true } ) {
+			Surface8u src = randomSurface<uint8_t>( 203, 149, alpha, 1 );
+			Surface8u expected = src.clone();
+			ip::grayscale( expected, &expected );
+			ip::stackBlur( &expected, 3 );
+			edgeDetectSobelCleared( &expected );
+			ip::threshold( &expected, (uint8_t)64 );
+
+			for( const ivec2 &tileSize : tileSizes ) {
+				ip::Pipeline pipeline;
+				pipeline.tileSize( tileSize ).grayscale().stackBlur( 3 ).edgeDetectSobel().threshold( 64 );
+				REQUIRE( identical( pipeline.runCopy( src ), expected ) );
+
+				Surface8u inPlace = src.clone();
+				pipeline.run( &inPlace );
+				REQUIRE( identical( inPlace, expected ) );
+			}
+		}
+	}
+
+	SECTION( "flips and blends match sequential ip:: calls" )
+	{
+		Surface8u src = randomSurface<uint8_t>( 203, 149, true, 2 );
+		Surface8u foreground = randomSurface<uint8_t>( 60, 45, true, 3 );
+		Surface8u expected = src.clone();
+		ip::flipVertical( &expected );
+		ip::blend( &expected, foreground, foreground.getBounds(), ivec2( 150, -10 ) );
+		ip::flipHorizontal( &expected );
+		ip::stackBlur( &expected, 2 );
+		ip::premultiply( &expected );
+		ip::blend( &expected, foreground, foreground.getBounds(), ivec2( 5, 120 ) );
+
+		for( const ivec2 &tileSize : tileSizes ) {
+			ip::Pipeline pipeline;
+			pipeline.tileSize( tileSize ).flipVertical().blend( foreground, ivec2( 150, -10 ) ).flipHorizontal().stackBlur( 2 ).premultiply().blend( foreground, ivec2( 5, 120 ) );
+			REQUIRE( identical( pipeline.runCopy( src ), expected ) );
+		}
+	}
+
+	SECTION( "hdrNormalize splits the pipeline into passes" )
+	{
+		Surface32f src = randomSurface<float>( 203, 149, false, 4 );
+		Surface32f expected = src.clone();
+		ip::grayscale( expected, &expected );
+		ip::hdrNormalize( &expected );
+		edgeDetectSobelCleared( &expected );
+		ip::hdrNormalize( &expected );
+		ip::flipVertical( &expected );
+		ip::threshold( &expected, 0.5f );
+
+		for( const ivec2 &tileSize : tileSizes ) {
+			ip::Pipeline32f pipeline;
+			pipeline.tileSize( tileSize ).grayscale().hdrNormalize().edgeDetectSobel().hdrNormalize().flipVertical().threshold( 0.5f );
+			REQUIRE( identical( pipeline.runCopy( src ), expected ) );
+
+			Surface32f inPlace = src.clone();
+			pipeline.run( &inPlace );
+			REQUIRE( identical( inPlace, expected ) );
+		}
+	}
+}
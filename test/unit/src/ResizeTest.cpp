@@ -0,0 +1,252 @@
+#include "cinder/ip/Resize.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/Rand.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+template<typename T>
+ChannelT<T> randomChannel( int32_t width, int32_t height, uint32_t seed )
+{
+	Rand rnd( seed );
+	ChannelT<T> result( width, height );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x )
+			*result.getData( x, y ) = T( rnd.nextFloat() * CHANTRAIT<T>::max() );
+	}
+	return result;
+}
+
+template<typename T>
+SurfaceT<T> randomSurface( int32_t width, int32_t height, bool alpha, uint32_t seed )
+{
+	Rand rnd( seed );
+	SurfaceT<T> result( width, height, alpha );
+	for( int32_t y = 0; y < height; ++y ) {
+		T *row = result.getData( ivec2( 0, y ) );
+		for( int32_t i = 0; i < width * result.getPixelInc(); ++i )
+			row[i] = T( rnd.nextFloat() * CHANTRAIT<T>::max() );
+	}
+	return result;
+}
+
+// Rounding of the horizontally filtered lines and of the final values, matching the fixed-point resampler for 8-bit images
+int32_t filteredLine( int32_t sum )		{ return ( sum + ( 1 << 7 ) ) >> 8; }
+float filteredLine( float sum )			{ return sum; }
+void finalValue( int32_t accum, uint8_t *result )	{ *result = (uint8_t)std::min( 255, std::max( 0, ( accum + ( 1 << 19 ) ) >> 20 ) ); }
+void finalValue( float accum, float *result )		{ *result = accum; }
+
+// Straightforward separable resample of \a src through the taps of a \a plan that covers both images entirely
+template<typename T>
+ChannelT<T> referenceResize( const ChannelT<T> &src, const ip::ResizePlan<T> &plan )
+{
+	typedef typename ip::ResizePlan<T>::WeightT WeightT;
+
+	const ivec2 dstSize = plan.getDstSize();
+	vector<WeightT> lines( src.getHeight() * dstSize.x );
+	for( int32_t y = 0; y < src.getHeight(); ++y ) {
+		for( int32_t x = 0; x < dstSize.x; ++x ) {
+			auto taps = plan.getColumnTaps( x );
+			WeightT sum = 0;
+			for( int32_t k = 0; k < taps.count; ++k )
+				sum += taps.weights[k] * *src.getData( taps.start + k, y );
+			lines[y * dstSize.x + x] = filteredLine( sum );
+		}
+	}
+
+	ChannelT<T> result( dstSize.x, dstSize.y );
+	for( int32_t y = 0; y < dstSize.y; ++y ) {
+		auto taps = plan.getRowTaps( y );
+		for( int32_t x = 0; x < dstSize.x; ++x ) {
+			WeightT accum = 0;
+			for( int32_t k = 0; k < taps.count; ++k )
+				accum += lines[( taps.start + k ) * dstSize.x + x] * taps.weights[k];
+			finalValue( accum, result.getData( x, y ) );
+		}
+	}
+
+	return result;
+}
+
+template<typename T>
+float maxDifference( const ChannelT<T> &a, const ChannelT<T> &b )
+{
+	float result = 0;
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x )
+			result = std::max( result, std::abs( (float)*a.getData( x, y ) - (float)*b.getData( x, y ) ) );
+	}
+	return result;
+}
+
+// Compares every channel of \a dst with the reference resample of the same channel of \a src
+template<typename T>
+float maxDifferenceFromReference( const SurfaceT<T> &src, const SurfaceT<T> &dst, const ip::ResizePlan<T> &plan )
+{
+	float result = std::max( { maxDifference( referenceResize( src.getChannelRed(), plan ), dst.getChannelRed() ),
+							maxDifference( referenceResize( src.getChannelGreen(), plan ), dst.getChannelGreen() ),
+							maxDifference( referenceResize( src.getChannelBlue(), plan ), dst.getChannelBlue() ) } );
+	if( src.hasAlpha() )
+		result = std::max( result, maxDifference( referenceResize( src.getChannelAlpha(), plan ), dst.getChannelAlpha() ) );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip::ResizePlan" )
+{
+	// downsampling, upsampling, and a tall vertical support
+	const ivec2 sizes[][2] = { { ivec2( 61, 47 ), ivec2( 23, 31 ) }, { ivec2( 20, 13 ), ivec2( 57, 40 ) }, { ivec2( 9, 200 ), ivec2( 14, 5 ) } };
+
+	SECTION( "8-bit resize matches a reference resample of its taps" )
+	{
+		const FilterTriangle triangle;
+		const FilterCatmullRom catmullRom;	// negative lobes exercise clamping
+		for( const FilterBase *filter : { (const FilterBase *)&triangle, (const FilterBase *)&catmullRom } ) {
+			for( auto &size : sizes ) {
+				ip::ResizePlan<uint8_t> plan( size[0], size[1], *filter );
+				for( bool alpha : { false, true } ) {
+					auto src = randomSurface<uint8_t>( size[0].x, size[0].y, alpha, size[0].x );
+					Surface8u dst( size[1].x, size[1].y, alpha );
+					plan.resize( src, &dst );
+					REQUIRE( maxDifferenceFromReference( src, dst, plan ) == 0 );
+				}
+
+				auto srcChannel = randomChannel<uint8_t>( size[0].x, size[0].y, size[0].y );
+				Channel8u dstChannel( size[1].x, size[1].y );
+				ip::resize( srcChannel, &dstChannel, plan );
+				REQUIRE( maxDifference( referenceResize( srcChannel, plan ), dstChannel ) == 0 );
+			}
+		}
+	}
+
+	SECTION( "32-bit resize matches a reference resample of its taps" )
+	{
+		for( auto &size : sizes ) {
+			ip::ResizePlan<float> plan( size[0], size[1], FilterGaussian() );
+			auto src = randomSurface<float>( size[0].x, size[0].y, true, size[0].x );
+			Surface32f dst( size[1].x, size[1].y, true );
+			plan.resize( src, &dst );
+			REQUIRE( maxDifferenceFromReference( src, dst, plan ) < 1e-5f );
+
+			auto srcChannel = randomChannel<float>( size[0].x, size[0].y, size[0].y );
+			Channel32f dstChannel( size[1].x, size[1].y );
+			plan.resize( srcChannel, &dstChannel );
+			REQUIRE( maxDifference( referenceResize( srcChannel, plan ), dstChannel ) < 1e-5f );
+		}
+	}
+
+	SECTION( "weights of every tap sum to one" )
+	{
+		ip::ResizePlan<uint8_t> plan( ivec2( 61, 47 ), ivec2( 23, 31 ), FilterCatmullRom() );
+		for( int32_t x = 0; x < 23; ++x ) {
+			auto taps = plan.getColumnTaps( x );
+			REQUIRE( taps.start >= 0 );
+			REQUIRE( taps.start + taps.count <= 61 );
+			int32_t sum = 0;
+			for( int32_t k = 0; k < taps.count; ++k )
+				sum += taps.weights[k];
+			REQUIRE( sum == ( 1 << 14 ) );
+		}
+
+		ip::ResizePlan<float> floatPlan( ivec2( 61, 47 ), ivec2( 23, 31 ), FilterCatmullRom() );
+		for( int32_t y = 0; y < 31; ++y ) {
+			auto taps = floatPlan.getRowTaps( y );
+			REQUIRE( taps.start >= 0 );
+			REQUIRE( taps.start + taps.count <= 47 );
+			float sum = 0;
+			for( int32_t k = 0; k < taps.count; ++k )
+				sum += taps.weights[k];
+			REQUIRE( sum == Approx( 1.0f ) );
+		}
+	}
+
+	SECTION( "constant images and equal sizes are preserved" )
+	{
+		Channel8u constant( 64, 64 );
+		ip::fill( &constant, (uint8_t)173 );
+		Channel8u constantResized( 17, 90 );
+		ip::resize( constant, &constantResized, ip::ResizePlan<uint8_t>( constant.getSize(), constantResized.getSize(), FilterCatmullRom() ) );
+		for( int32_t y = 0; y < constantResized.getHeight(); ++y ) {
+			for( int32_t x = 0; x < constantResized.getWidth(); ++x )
+				REQUIRE( *constantResized.getData( x, y ) == 173 );
+		}
+
+		auto src = randomSurface<uint8_t>( 33, 21, true, 5 );
+		Surface8u dst( 33, 21, true );
+		ip::ResizePlan<uint8_t>( src.getSize(), dst.getSize() ).resize( src, &dst );
+		for( uint8_t c = 0; c < 4; ++c )
+			REQUIRE( maxDifference( src.getChannel( c ), dst.getChannel( c ) ) == 0 );
+	}
+
+	SECTION( "channels are resampled independently when the channel orders differ" )
+	{
+		// a tall vertical support keeps many filtered lines alive at once, which must not leak between channels
+		const ivec2 srcSize( 40, 300 ), dstSize( 12, 7 );
+		Surface8u src( srcSize.x, srcSize.y, false, SurfaceChannelOrder::RGB );
+		ip::fill( &src.getChannelRed(), (uint8_t)10 );
+		ip::fill( &src.getChannelGreen(), (uint8_t)200 );
+		auto blue = randomChannel<uint8_t>( srcSize.x, srcSize.y, 7 );
+		src.getChannelBlue().copyFrom( blue, blue.getBounds() );
+
+		Surface8u dst( dstSize.x, dstSize.y, false, SurfaceChannelOrder::BGR );
+		ip::ResizePlan<uint8_t> plan( srcSize, dstSize );
+		plan.resize( src, &dst );
+
+		for( int32_t y = 0; y < dstSize.y; ++y ) {
+			for( int32_t x = 0; x < dstSize.x; ++x ) {
+				REQUIRE( *dst.getChannelRed().getData( x, y ) == 10 );
+				REQUIRE( *dst.getChannelGreen().getData( x, y ) == 200 );
+			}
+		}
+		REQUIRE( maxDifference( referenceResize( src.getChannelBlue(), plan ), dst.getChannelBlue() ) == 0 );
+	}
+
+	SECTION( "only the clipped destination area is written" )
+	{
+		auto src = randomSurface<uint8_t>( 50, 40, false, 11 );
+		Surface8u dst( 30, 30, false );
+		ip::fill( &dst, ColorA8u( 1, 2, 3, 255 ) );
+
+		const Area dstArea( 5, 8, 25, 20 );
+		ip::ResizePlan<uint8_t> plan( src.getSize(), Area( 10, 10, 40, 30 ), dst.getSize(), dstArea );
+		const Area clippedDstArea = plan.getClippedDstArea();
+		REQUIRE( clippedDstArea.getUL() == dstArea.getUL() );
+		REQUIRE( clippedDstArea.getLR().x >= dstArea.getLR().x );
+		REQUIRE( clippedDstArea.getLR().y >= dstArea.getLR().y );
+		plan.resize( src, &dst );
+
+		// the plan agrees with resizing the same areas without one
+		Surface8u expected( 30, 30, false );
+		ip::fill( &expected, ColorA8u( 1, 2, 3, 255 ) );
+		ip::resize( src, Area( 10, 10, 40, 30 ), &expected, dstArea );
+
+		for( int32_t y = 0; y < dst.getHeight(); ++y ) {
+			for( int32_t x = 0; x < dst.getWidth(); ++x ) {
+				if( ! clippedDstArea.contains( ivec2( x, y ) ) )
+					REQUIRE( dst.getPixel( ivec2( x, y ) ) == ColorA8u( 1, 2, 3, 255 ) );
+				REQUIRE( dst.getPixel( ivec2( x, y ) ) == expected.getPixel( ivec2( x, y ) ) );
+			}
+		}
+	}
+
+	SECTION( "a plan can be reused" )
+	{
+		ip::ResizePlan<uint8_t> plan( ivec2( 61, 47 ), ivec2( 23, 31 ) );
+		for( uint32_t seed = 0; seed < 3; ++seed ) {
+			auto src = randomSurface<uint8_t>( 61, 47, true, seed );
+			Surface8u planned( 23, 31, true ), unplanned( 23, 31, true );
+			ip::resize( src, &planned, plan );
+			ip::resize( src, &unplanned );
+			REQUIRE( maxDifferenceFromReference( src, planned, plan ) == 0 );
+			REQUIRE( maxDifference( planned.getChannelGreen(), unplanned.getChannelGreen() ) == 0 );
+		}
+	}
+}
@@ -0,0 +1,259 @@
+#include "cinder/ThreadPool.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/Rand.h"
+
+#include "catch.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+
+using namespace ci;
+using namespace std;
+
+namespace {
+
+// Runs parallelFor() over [begin, end) and returns how often each index in [0, end) was visited, along with the chunk sizes
+vector<int> visitCounts( ThreadPool *pool, size_t begin, size_t end, size_t minChunkSize, vector<size_t> *chunkSizes )
+{
+	vector<atomic<int>> counts( end );
+	for( auto &count : counts )
+		count = 0;
+
+	mutex chunksMutex;
+	pool->parallelFor( begin, end, [&]( size_t chunkBegin, size_t chunkEnd ) {
+		for( size_t i = chunkBegin; i < chunkEnd; i++ )
+			counts[i]++;
+
+		lock_guard<mutex> lock( chunksMutex );
+		chunkSizes->push_back( chunkEnd - chunkBegin );
+	}, minChunkSize );
+
+	vector<int> result;
+	for( auto &count : counts )
+		result.push_back( count.load() );
+	return result;
+}
+
+template<typename T>
+SurfaceT<T> randomSurface( int32_t width, int32_t height, bool alpha, uint32_t seed )
+{
+	Rand rnd( seed );
+	SurfaceT<T> result( width, height, alpha );
+	const T maxValue = CHANTRAIT<T>::max();
+	for( int32_t y = 0; y < height; ++y ) {
+		T *row = result.getData( ivec2( 0, y ) );
+		for( int32_t i = 0; i < width * result.getPixelInc(); ++i )
+			row[i] = T( rnd.nextFloat() * maxValue );
+	}
+	return result;
+}
+
+template<typename T>
+ChannelT<T> randomChannel( int32_t width, int32_t height, uint32_t seed )
+{
+	Rand rnd( seed );
+	ChannelT<T> result( width, height );
+	const T maxValue = CHANTRAIT<T>::max();
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x )
+			*result.getData( x, y ) = T( rnd.nextFloat() * maxValue );
+	}
+	return result;
+}
+
+template<typename T>
+bool equalPixels( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ivec2( 0, y ) ), b.getData( ivec2( 0, y ) ), a.getWidth() * a.getPixelInc() * sizeof( T ) ) != 0 )
+			return false;
+	}
+	return true;
+}
+
+template<typename T>
+bool equalPixels( const ChannelT<T> &a, const ChannelT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( *a.getData( x, y ) != *b.getData( x, y ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ThreadPool" )
+{
+	SECTION( "parallelFor covers every index exactly once" )
+	{
+		auto pool = ThreadPool::create( 3 );
+		for( size_t minChunkSize : { 1, 7, 64, 1000 } ) {
+			vector<size_t> chunkSizes;
+			auto counts = visitCounts( pool.get(), 3, 1003, minChunkSize, &chunkSizes );
+			for( size_t i = 0; i < counts.size(); i++ )
+				REQUIRE( counts[i] == ( i < 3 ? 0 : 1 ) );
+
+			for( size_t size : chunkSizes )
+				REQUIRE( size >= minChunkSize );
+		}
+
+		// chunks never drop below minChunkSize, so a range shorter than two chunks is a single chunk
+		vector<size_t> chunkSizes;
+		visitCounts( pool.get(), 0, 10, 7, &chunkSizes );
+		REQUIRE( chunkSizes == vector<size_t>( 1, 10 ) );
+
+		// an empty range never calls fn
+		visitCounts( pool.get(), 5, 5, 1, &chunkSizes );
+		REQUIRE( chunkSizes.size() == 1 );
+	}
+
+	SECTION( "a single chunk runs inline on the calling thread" )
+	{
+		auto pool = ThreadPool::create( 2 );
+		const auto callingThread = this_thread::get_id();
+		int numCalls = 0;
+		thread::id chunkThread;
+		pool->parallelFor( 0, 100, [&]( size_t begin, size_t end ) {
+			numCalls++;
+			chunkThread = this_thread::get_id();
+			REQUIRE( begin == 0 );
+			REQUIRE( end == 100 );
+		}, 100 );
+
+		REQUIRE( numCalls == 1 );
+		REQUIRE( chunkThread == callingThread );
+	}
+
+	SECTION( "a pool without workers runs parallelFor inline" )
+	{
+		// 0 requests one worker less than the hardware threads, so a single core machine gets none
+		auto pool = ThreadPool::create( 0 );
+		const size_t hardwareThreads = thread::hardware_concurrency();
+		REQUIRE( pool->getNumThreads() == ( hardwareThreads > 1 ? hardwareThreads - 1 : 0 ) );
+
+		const auto callingThread = this_thread::get_id();
+		size_t numVisited = 0;
+		bool allOnCallingThread = true;
+		mutex visitMutex;
+		pool->parallelFor( 0, 1000, [&]( size_t begin, size_t end ) {
+			lock_guard<mutex> lock( visitMutex );
+			numVisited += end - begin;
+			allOnCallingThread = allOnCallingThread && this_thread::get_id() == callingThread;
+		} );
+
+		REQUIRE( numVisited == 1000 );
+		if( pool->getNumThreads() == 0 )
+			REQUIRE( allOnCallingThread );
+	}
+
+	SECTION( "parallelFor rethrows the exception of a chunk" )
+	{
+		auto pool = ThreadPool::create( 3 );
+		atomic<size_t> numVisited( 0 );
+		REQUIRE_THROWS_AS( pool->parallelFor( 0, 1000, [&]( size_t begin, size_t end ) {
+			numVisited += end - begin;
+			if( begin <= 500 && 500 < end )
+				throw std::runtime_error( "chunk failed" );
+		}, 10 ), const std::runtime_error & );
+
+		// the other chunks still run to completion before the exception is rethrown
+		REQUIRE( numVisited == 1000 );
+
+		// the pool remains usable
+		vector<size_t> chunkSizes;
+		auto counts = visitCounts( pool.get(), 0, 100, 1, &chunkSizes );
+		REQUIRE( count( counts.begin(), counts.end(), 1 ) == 100 );
+	}
+
+	SECTION( "nested parallelFor completes" )
+	{
+		// a single worker makes the nested calls contend for it
+		for( size_t numThreads : { 1, 3 } ) {
+			auto pool = ThreadPool::create( numThreads );
+			vector<atomic<int>> counts( 64 * 64 );
+			for( auto &count : counts )
+				count = 0;
+
+			pool->parallelFor( 0, 64, [&]( size_t rowBegin, size_t rowEnd ) {
+				for( size_t row = rowBegin; row < rowEnd; row++ ) {
+					pool->parallelFor( 0, 64, [&]( size_t begin, size_t end ) {
+						for( size_t i = begin; i < end; i++ )
+							counts[row * 64 + i]++;
+					} );
+				}
+			} );
+
+			for( auto &count : counts )
+				REQUIRE( count == 1 );
+		}
+	}
+
+	SECTION( "enqueue returns results and exceptions" )
+	{
+		auto pool = ThreadPool::create( 2 );
+		auto result = pool->enqueue( [] { return 42; } );
+		auto failed = pool->enqueue( []() -> int { throw std::runtime_error( "task failed" ); } );
+		REQUIRE( result.get() == 42 );
+		REQUIRE_THROWS_AS( failed.get(), const std::runtime_error & );
+	}
+}
+
+TEST_CASE( "ip::stackBlurParallel" )
+{
+	SECTION( "matches stackBlur" )
+	{
+		ip::StackBlurScratch scratch;
+		// sizes straddle the 4-lane SIMD blocks, and the last radius exceeds the image
+		for( int32_t width : { 1, 5, 64, 131 } ) {
+			const int32_t height = 37;
+			for( int radius : { 1, 3, 12, 80 } ) {
+				for( bool alpha : { false, true } ) {
+					auto surface = randomSurface<uint8_t>( width, height, alpha, width * radius );
+					auto expected = surface.clone();
+					ip::stackBlur( &expected, radius );
+					ip::stackBlurParallel( &surface, radius, &scratch );
+					REQUIRE( equalPixels( surface, expected ) );
+				}
+
+				auto channel = randomChannel<uint8_t>( width, height, width + radius );
+				auto expectedChannel = channel.clone();
+				ip::stackBlur( &expectedChannel, radius );
+				ip::stackBlurParallel( &channel, radius );
+				REQUIRE( equalPixels( channel, expectedChannel ) );
+			}
+		}
+	}
+
+	SECTION( "matches stackBlur in an area and for other data types" )
+	{
+		const Area area( 7, 3, 90, 50 );
+
+		auto surface = randomSurface<uint8_t>( 100, 60, true, 1 );
+		auto expected = surface.clone();
+		ip::stackBlur( &expected, area, 9 );
+		ip::stackBlurParallel( &surface, area, 9 );
+		REQUIRE( equalPixels( surface, expected ) );
+
+		auto surface16 = randomSurface<uint16_t>( 100, 60, false, 2 );
+		auto expected16 = surface16.clone();
+		ip::stackBlur( &expected16, area, 9 );
+		ip::stackBlurParallel( &surface16, area, 9 );
+		REQUIRE( equalPixels( surface16, expected16 ) );
+
+		auto surface32 = randomSurface<float>( 100, 60, true, 3 );
+		auto expected32 = surface32.clone();
+		ip::stackBlur( &expected32, 9 );
+		ip::stackBlurParallel( &surface32, 9 );
+		REQUIRE( equalPixels( surface32, expected32 ) );
+
+		auto channel32 = randomChannel<float>( 100, 60, 4 );
+		auto expectedChannel32 = channel32.clone();
+		ip::stackBlur( &expectedChannel32, area, 9 );
+		ip::stackBlurParallel( &channel32, area, 9 );
+		REQUIRE( equalPixels( channel32, expectedChannel32 ) );
+	}
+}
@@ -0,0 +1,127 @@
+#include "catch.hpp"
+#include "cinder/audio/dsp/BiquadCascade.h"
+#include "utils.h"
+
+#include <vector>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const dsp::SimdBackend sAllBackends[] = { dsp::SimdBackend::SCALAR, dsp::SimdBackend::SSE2, dsp::SimdBackend::AVX2, dsp::SimdBackend::NEON, dsp::SimdBackend::VDSP };
+
+// Configures a different filter for each channel and section, so that misplaced coefficients or lanes show up.
+dsp::Biquad makeSection( size_t channel, size_t section )
+{
+	dsp::Biquad result;
+	double freq = 0.02 + 0.05 * channel + 0.1 * section;
+	switch( section % 3 ) {
+		case 0:		result.setLowpassParams( freq, 3.0 );			break;
+		case 1:		result.setPeakingParams( freq, 2.0, -6.0 );		break;
+		default:	result.setHighShelfParams( freq, 4.0 );			break;
+	}
+	return result;
+}
+
+// Processes \a input with one dsp::Biquad per channel and section, in blocks of \a blockFrames.
+audio::Buffer processReference( const audio::Buffer &input, size_t numSections, size_t blockFrames )
+{
+	audio::Buffer result( input.getNumFrames(), input.getNumChannels() );
+	result.copy( input );
+
+	for( size_t ch = 0; ch < input.getNumChannels(); ch++ ) {
+		for( size_t section = 0; section < numSections; section++ ) {
+			dsp::Biquad biquad = makeSection( ch, section );
+			for( size_t offset = 0; offset < input.getNumFrames(); offset += blockFrames ) {
+				float *channel = result.getChannel( ch ) + offset;
+				biquad.process( channel, channel, std::min( blockFrames, input.getNumFrames() - offset ) );
+			}
+		}
+	}
+
+	return result;
+}
+
+audio::Buffer processCascade( dsp::BiquadCascade *cascade, const audio::Buffer &input, size_t blockFrames )
+{
+	for( size_t ch = 0; ch < cascade->getNumChannels(); ch++ ) {
+		for( size_t section = 0; section < cascade->getNumSections(); section++ )
+			cascade->setSection( ch, section, makeSection( ch, section ) );
+	}
+
+	audio::Buffer result( input.getNumFrames(), input.getNumChannels() );
+	for( size_t offset = 0; offset < input.getNumFrames(); offset += blockFrames )
+		cascade->process( input.getData() + offset, result.getData() + offset, std::min( blockFrames, input.getNumFrames() - offset ), input.getNumFrames() );
+
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/BiquadCascade" )
+{
+
+SECTION( "matches a chain of Biquads on every backend" )
+{
+	const dsp::SimdBackend initial = dsp::getSimdBackend();
+
+	// 11 channels fill one group and part of another in both precisions, 150 frame blocks span several internal blocks
+	const size_t numChannels = 11;
+	const size_t numSections = 4;
+	const size_t blockFrames = 150;
+	audio::Buffer input( blockFrames * 3, numChannels );
+	fillRandom( &input );
+
+	audio::Buffer expected = processReference( input, numSections, blockFrames );
+
+	for( auto precision : { dsp::BiquadCascade::Precision::FLOAT, dsp::BiquadCascade::Precision::DOUBLE } ) {
+		for( auto backend : sAllBackends ) {
+			if( ! dsp::setSimdBackend( backend ) )
+				continue;
+
+			INFO( "backend: " << dsp::getSimdBackendName( backend ) << ", double precision: " << ( precision == dsp::BiquadCascade::Precision::DOUBLE ) );
+			dsp::BiquadCascade cascade( numChannels, numSections, precision );
+			audio::Buffer actual = processCascade( &cascade, input, blockFrames );
+
+			float tolerance = precision == dsp::BiquadCascade::Precision::DOUBLE ? 0.00001f : 0.001f;
+			REQUIRE( maxError( expected, actual ) < tolerance );
+		}
+	}
+
+	dsp::setSimdBackend( initial );
+}
+
+SECTION( "pass-through, in place processing and reset" )
+{
+	const size_t numFrames = 200;
+	audio::Buffer input( numFrames, 3 );
+	fillRandom( &input );
+
+	dsp::BiquadCascade passThrough( 3, 2 );
+	audio::Buffer buffer( numFrames, 3 );
+	buffer.copy( input );
+	passThrough.process( &buffer );
+	REQUIRE( maxError( input, buffer ) == 0 );
+
+	dsp::Biquad lowpass;
+	lowpass.setLowpassParams( 0.1, 0 );
+	dsp::BiquadCascade cascade( 3, 2, dsp::BiquadCascade::Precision::FLOAT );
+	cascade.setSection( 0, lowpass );
+	cascade.setSection( 1, lowpass );
+
+	audio::Buffer first( numFrames, 3 );
+	cascade.process( input, &first );
+
+	// processing in place continues from the previous state, reset() starts over
+	buffer.copy( input );
+	cascade.process( &buffer );
+	REQUIRE( maxError( first, buffer ) > 0 );
+
+	cascade.reset();
+	buffer.copy( input );
+	cascade.process( &buffer );
+	REQUIRE( maxError( first, buffer ) == 0 );
+}
+
+} // "audio/BiquadCascade"
@@ -0,0 +1,125 @@
+#include "catch.hpp"
+#include "cinder/audio/ContextOffline.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/GainNode.h"
+#include "cinder/audio/Utilities.h"
+#include "utils.h"
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+ContextOfflineRef makeSineContext( size_t framesPerBlock = 512 )
+{
+	auto ctx = ContextOffline::create( 44100, framesPerBlock, Node::Format().channels( 1 ) );
+	auto gen = ctx->makeNode<GenSineNode>( 440.0f );
+	gen >> ctx->getOutput();
+	gen->enable();
+
+	return ctx;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/ContextOffline" )
+{
+
+SECTION( "format" )
+{
+	auto ctx = ContextOffline::create( 48000, 256 );
+	REQUIRE( ctx->getSampleRate() == 48000 );
+	REQUIRE( ctx->getFramesPerBlock() == 256 );
+	REQUIRE( ctx->getOutput()->getNumChannels() == 2 );
+	REQUIRE_THROWS_AS( ctx->createOutputDeviceNode( nullptr ), const AudioContextExc & );
+}
+
+SECTION( "render is deterministic" )
+{
+	BufferDynamic a, b;
+	makeSineContext()->render( 10000, &a );
+	makeSineContext()->render( 10000, &b );
+
+	REQUIRE( a.getNumFrames() == 10000 );
+	REQUIRE( a.getNumChannels() == 1 );
+	REQUIRE( maxError( a, b ) == 0 );
+}
+
+SECTION( "partial blocks are continued by the next render" )
+{
+	BufferDynamic whole;
+	makeSineContext()->render( 3000, &whole );
+
+	auto ctx = makeSineContext();
+	audio::Buffer pieced( 3000, 1 );
+	size_t offset = 0;
+	for( size_t numFrames : { 100, 700, 1, 1223, 976 } ) {
+		BufferDynamic piece;
+		ctx->render( numFrames, &piece );
+		pieced.copyOffset( piece, numFrames, offset, 0 );
+		offset += numFrames;
+	}
+
+	REQUIRE( offset == 3000 );
+	REQUIRE( maxError( whole, pieced ) == 0 );
+	REQUIRE( ctx->getNumProcessedFrames() == 3072 ); // 6 blocks of 512
+}
+
+SECTION( "scheduled enable is sample accurate" )
+{
+	const uint64_t eventFrame = 1000;
+
+	auto ctx = ContextOffline::create( 44100, 512, Node::Format().channels( 1 ) );
+	auto gen = ctx->makeNode<GenSineNode>( 440.0f );
+	gen >> ctx->getOutput();
+	gen->setPhase( 0.25f ); // first processed sample is 1
+	gen->enable( (double)eventFrame / 44100.0 );
+
+	BufferDynamic buffer;
+	ctx->render( 2048, &buffer );
+
+	for( size_t i = 0; i < eventFrame; i++ )
+		REQUIRE( buffer[i] == 0 );
+
+	REQUIRE( buffer[eventFrame] == Approx( 1 ) );
+}
+
+SECTION( "param ramp is sample accurate" )
+{
+	const size_t rampFrames = 4410;
+
+	auto ctx = ContextOffline::create( 44100, 512, Node::Format().channels( 1 ) );
+	auto gen = ctx->makeNode<GenSineNode>( 0.0f );
+	auto gain = ctx->makeNode<GainNode>( 0.0f );
+	gen >> gain >> ctx->getOutput();
+	gen->setPhase( 0.25f ); // constant 1
+	gen->enable();
+	gain->getParam()->applyRamp( 1, (double)rampFrames / 44100.0 );
+
+	BufferDynamic buffer;
+	ctx->render( 8192, &buffer );
+
+	REQUIRE( buffer[0] < 0.001f );
+	for( size_t i = 1; i < rampFrames; i++ )
+		REQUIRE( buffer[i] >= buffer[i - 1] );
+	for( size_t i = rampFrames; i < buffer.getNumFrames(); i++ )
+		REQUIRE( buffer[i] == Approx( 1 ) );
+}
+
+SECTION( "consumer receives contiguous chunks" )
+{
+	auto ctx = makeSineContext( 64 );
+
+	size_t totalFrames = 0;
+	ctx->render( 1000, [&totalFrames]( const audio::Buffer *buffer, size_t numFrames, size_t frameOffset ) {
+		REQUIRE( numFrames > 0 );
+		REQUIRE( numFrames + frameOffset <= buffer->getNumFrames() );
+		totalFrames += numFrames;
+	} );
+
+	REQUIRE( totalFrames == 1000 );
+	REQUIRE( ctx->getNumRenderedBlocks() == 16 );
+	REQUIRE( ctx->getRealtimeRatio() >= 0 );
+}
+
+} // "audio/ContextOffline"
@@ -0,0 +1,115 @@
+#include "catch.hpp"
+#include "cinder/audio/ContextOffline.h"
+#include "cinder/audio/ConvolverNode.h"
+#include "cinder/audio/SamplePlayerNode.h"
+#include "utils.h"
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// Direct form convolution of \a input with \a ir, truncated to the length of \a input.
+audio::Buffer convolveDirect( const audio::Buffer &input, const audio::Buffer &ir )
+{
+	audio::Buffer result( input.getNumFrames() );
+	for( size_t n = 0; n < input.getNumFrames(); n++ ) {
+		double sum = 0;
+		for( size_t k = 0; k < ir.getNumFrames() && k <= n; k++ )
+			sum += double( ir[k] ) * double( input[n - k] );
+		result[n] = float( sum );
+	}
+	return result;
+}
+
+// An impulse response that decays, similar in shape to a reverb.
+audio::BufferRef makeImpulseResponse( size_t numFrames )
+{
+	auto result = std::make_shared<audio::Buffer>( numFrames );
+	fillRandom( result.get() );
+	for( size_t i = 0; i < numFrames; i++ )
+		(*result)[i] *= 0.1f * std::exp( -3.0f * float( i ) / float( numFrames ) );
+	return result;
+}
+
+// Renders \a input through a ConvolverNode at 64 frames per block.
+audio::Buffer renderConvolver( const audio::BufferRef &input, const audio::BufferRef &ir, size_t tailPartitionSize, bool *tailThreaded = nullptr )
+{
+	auto ctx = ContextOffline::create( 44100, 64, Node::Format().channels( 1 ) );
+	auto player = ctx->makeNode<BufferPlayerNode>( input );
+	auto convolver = ctx->makeNode<ConvolverNode>( ir );
+	convolver->setTailPartitionSize( tailPartitionSize );
+	player >> convolver >> ctx->getOutput();
+	player->start();
+
+	BufferDynamic rendered;
+	ctx->render( input->getNumFrames(), &rendered );
+	if( tailThreaded )
+		*tailThreaded = convolver->isTailThreaded();
+
+	audio::Buffer result( input->getNumFrames() );
+	result.copy( rendered );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Convolver" )
+{
+
+SECTION( "dsp::Convolver matches direct convolution" )
+{
+	const size_t partitionSize = 64;
+	auto ir = makeImpulseResponse( 1000 );
+	audio::Buffer input( partitionSize * 30 );
+	fillRandom( &input );
+
+	dsp::Convolver convolver( ir->getData(), ir->getNumFrames(), partitionSize );
+	REQUIRE( convolver.getNumPartitions() == 16 );
+
+	audio::Buffer actual( input.getNumFrames() );
+	for( size_t offset = 0; offset < input.getNumFrames(); offset += partitionSize )
+		convolver.process( input.getData() + offset, actual.getData() + offset );
+
+	REQUIRE( maxError( convolveDirect( input, *ir ), actual ) < 0.0001f );
+
+	// reset() forgets the input history, processing in place is allowed
+	convolver.reset();
+	audio::Buffer inPlace( partitionSize );
+	inPlace.copy( input );
+	convolver.process( inPlace.getData(), inPlace.getData() );
+	for( size_t i = 0; i < partitionSize; i++ )
+		REQUIRE( inPlace[i] == Approx( actual[i] ) );
+
+	REQUIRE_THROWS_AS( dsp::Convolver( ir->getData(), ir->getNumFrames(), 100 ), const AudioExc & );
+}
+
+SECTION( "ConvolverNode with a threaded tail matches direct convolution" )
+{
+	auto ir = makeImpulseResponse( 3000 );
+	auto input = std::make_shared<audio::Buffer>( 6000 );
+	fillRandom( input.get() );
+	const audio::Buffer expected = convolveDirect( *input, *ir );
+
+	// the head covers 512 frames, the tail 10 partitions of 256 frames
+	bool tailThreaded = false;
+	audio::Buffer threaded = renderConvolver( input, ir, 200, &tailThreaded );
+	REQUIRE( tailThreaded );
+	REQUIRE( maxError( expected, threaded ) < 0.0001f );
+
+	audio::Buffer uniform = renderConvolver( input, ir, 0, &tailThreaded );
+	REQUIRE( ! tailThreaded );
+	REQUIRE( maxError( expected, uniform ) < 0.0001f );
+}
+
+SECTION( "ConvolverNode without an impulse response is silent" )
+{
+	auto input = std::make_shared<audio::Buffer>( 512 );
+	fillRandom( input.get() );
+
+	audio::Buffer result = renderConvolver( input, nullptr, 1024 );
+	for( size_t i = 0; i < result.getNumFrames(); i++ )
+		REQUIRE( result[i] == 0 );
+}
+
+} // "audio/Convolver"
@@ -0,0 +1,117 @@
+#include "catch.hpp"
+#include "cinder/audio/dsp/Dsp.h"
+#include "utils.h"
+
+#include <vector>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+const dsp::SimdBackend sAllBackends[] = { dsp::SimdBackend::SCALAR, dsp::SimdBackend::SSE2, dsp::SimdBackend::AVX2, dsp::SimdBackend::NEON, dsp::SimdBackend::VDSP };
+
+// Lengths that cover the vectorized loops, their remainders and zero.
+const size_t sLengths[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 64, 67, 513 };
+
+struct Results {
+	std::vector<float>	mElementWise;
+	std::vector<float>	mReductions;
+};
+
+// Runs every vector routine on \a a and \a b, starting at \a offset to exercise unaligned pointers.
+Results computeAll( const audio::Buffer &a, const audio::Buffer &b, size_t offset, size_t length )
+{
+	const float *inA = a.getData() + offset;
+	const float *inB = b.getData() + offset;
+	std::vector<float> out( length + 1 );
+	float *result = out.data() + 1; // unaligned output
+
+	Results results;
+	auto append = [&] {
+		results.mElementWise.insert( results.mElementWise.end(), result, result + length );
+	};
+
+	dsp::fill( 0.25f, result, length );				append();
+	dsp::add( inA, 0.5f, result, length );			append();
+	dsp::add( inA, inB, result, length );			append();
+	dsp::sub( inA, 0.5f, result, length );			append();
+	dsp::sub( inA, inB, result, length );			append();
+	dsp::mul( inA, 0.75f, result, length );			append();
+	dsp::mul( inA, inB, result, length );			append();
+	dsp::divide( inA, 3.0f, result, length );		append();
+	dsp::divide( inA, inB, result, length );		append();
+	dsp::addMul( inA, inB, 0.3f, result, length );	append();
+
+	std::copy( inA, inA + length, result );
+	dsp::normalize( result, length, 0.9f );			append();
+
+	results.mReductions.push_back( dsp::sum( inA, length ) );
+	if( length )
+		results.mReductions.push_back( dsp::rms( inA, length ) );
+
+	return results;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Dsp" )
+{
+
+SECTION( "backend selection" )
+{
+	dsp::SimdBackend initial = dsp::getSimdBackend();
+	REQUIRE( dsp::isSimdBackendSupported( initial ) );
+
+	for( auto backend : sAllBackends ) {
+		bool supported = dsp::isSimdBackendSupported( backend );
+		REQUIRE( dsp::setSimdBackend( backend ) == supported );
+		if( supported )
+			REQUIRE( dsp::getSimdBackend() == backend );
+	}
+
+	dsp::setSimdBackend( initial );
+	REQUIRE( dsp::getSimdBackend() == initial );
+}
+
+SECTION( "backends match scalar" )
+{
+	const dsp::SimdBackend initial = dsp::getSimdBackend();
+	if( ! dsp::isSimdBackendSupported( dsp::SimdBackend::SCALAR ) )
+		return; // vDSP builds only have the one back-end
+
+	const size_t maxLength = 513 + 1;
+	audio::Buffer a( maxLength ), b( maxLength );
+	fillRandom( &a );
+	fillRandom( &b );
+	// keep the divisors away from zero
+	for( size_t i = 0; i < b.getSize(); i++ )
+		b[i] = b[i] < 0 ? b[i] - 0.5f : b[i] + 0.5f;
+
+	for( size_t length : sLengths ) {
+		for( size_t offset = 0; offset < 2; offset++ ) {
+			dsp::setSimdBackend( dsp::SimdBackend::SCALAR );
+			Results expected = computeAll( a, b, offset, length );
+
+			for( auto backend : sAllBackends ) {
+				if( backend == dsp::SimdBackend::SCALAR || ! dsp::setSimdBackend( backend ) )
+					continue;
+
+				INFO( "backend: " << dsp::getSimdBackendName( backend ) << ", length: " << length << ", offset: " << offset );
+				Results actual = computeAll( a, b, offset, length );
+
+				REQUIRE( actual.mElementWise == expected.mElementWise );
+
+				REQUIRE( actual.mReductions.size() == expected.mReductions.size() );
+				for( size_t i = 0; i < expected.mReductions.size(); i++ ) {
+					float tolerance = 0.0001f * std::max( 1.0f, std::fabs( expected.mReductions[i] ) );
+					REQUIRE( std::fabs( actual.mReductions[i] - expected.mReductions[i] ) <= tolerance );
+				}
+			}
+		}
+	}
+
+	dsp::setSimdBackend( initial );
+}
+
+} // "audio/Dsp"
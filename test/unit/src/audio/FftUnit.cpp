@@ -1,8 +1,3 @@
-#include "cinder/Cinder.h"
-
-// FIXME: OOURA roundtrip FFT seems to be broken on windows for sizeFft = 4 (https://github.com/cinder/Cinder/issues/1263)
-#if defined( CINDER_MAC )
-
 #include "catch.hpp"
 #include "utils.h"
 
@@ -10,6 +5,7 @@
 #include "cinder/audio/dsp/Fft.h"
 
 #include <iostream>
+#include <vector>
 
 using namespace ci::audio;
 
@@ -43,6 +39,42 @@ void computeRoundTrip( size_t sizeFft )
 	REQUIRE( maxErr < ACCEPTABLE_FLOAT_ERROR );
 }
 
+// Compares the batched transforms of \a count waveforms against forward() and inverse() on each.
+void computeBatch( size_t sizeFft, size_t count )
+{
+	dsp::Fft fft( sizeFft );
+	Buffer waveforms( sizeFft, count );
+	fillRandom( &waveforms );
+
+	std::vector<BufferSpectral> expected( count, BufferSpectral( sizeFft ) );
+	for( size_t i = 0; i < count; i++ ) {
+		Buffer channel( sizeFft );
+		channel.copyChannel( 0, waveforms.getChannel( i ) );
+		fft.forward( &channel, &expected[i] );
+	}
+
+	std::vector<BufferSpectral> spectra( count, BufferSpectral( sizeFft ) );
+	fft.forwardBatch( waveforms, spectra.data() );
+
+	// the spectrum grows with the fft size, so the error is relative to that
+	const float spectralTolerance = ACCEPTABLE_FLOAT_ERROR * sizeFft;
+	for( size_t i = 0; i < count; i++ ) {
+		INFO( "sizeFft: " << sizeFft << ", count: " << count << ", waveform: " << i );
+		REQUIRE( maxError( spectra[i], expected[i] ) < spectralTolerance );
+	}
+
+	Buffer result( sizeFft, count );
+	fft.inverseBatch( spectra.data(), &result );
+	for( size_t i = 0; i < count; i++ ) {
+		Buffer expectedWaveform( sizeFft ), resultWaveform( sizeFft );
+		fft.inverse( &spectra[i], &expectedWaveform );
+		resultWaveform.copyChannel( 0, result.getChannel( i ) );
+
+		INFO( "sizeFft: " << sizeFft << ", count: " << count << ", waveform: " << i );
+		REQUIRE( maxError( resultWaveform, expectedWaveform ) < ACCEPTABLE_FLOAT_ERROR * 10 );
+	}
+}
+
 }
 
 TEST_CASE( "audio/Fft" )
@@ -55,6 +87,41 @@ SECTION( "round trip error" )
 		computeRoundTrip( 2 << i );
 }
 
-} // "audio/Fft"
+SECTION( "batched transforms match forward and inverse" )
+{
+	const dsp::SimdBackend initial = dsp::getSimdBackend();
+	const dsp::SimdBackend backends[] = { dsp::SimdBackend::SCALAR, initial };
+	const size_t counts[] = { 1, 3, 4, 9 };
+
+	for( auto backend : backends ) {
+		if( ! dsp::setSimdBackend( backend ) )
+			continue;
+
+		for( size_t i = 0; i < 14; i ++ ) {
+			for( size_t count : counts )
+				computeBatch( 2 << i, count );
+		}
+	}
 
-#endif // ! defined( CINDER_MSW )
+	dsp::setSimdBackend( initial );
+}
+
+SECTION( "plans are shared by size" )
+{
+	dsp::Fft::clearPlanCache();
+	const size_t numPlans = dsp::Fft::getNumCachedPlans();
+
+	{
+		dsp::Fft a( 1 << 17 ), b( 1 << 17 ), c( 1 << 18 );
+		REQUIRE( dsp::Fft::getNumCachedPlans() == numPlans + 2 );
+
+		// plans still in use are kept
+		dsp::Fft::clearPlanCache();
+		REQUIRE( dsp::Fft::getNumCachedPlans() == numPlans + 2 );
+	}
+
+	dsp::Fft::clearPlanCache();
+	REQUIRE( dsp::Fft::getNumCachedPlans() == numPlans );
+}
+
+} // "audio/Fft"
@@ -0,0 +1,115 @@
+#include "catch.hpp"
+#include "cinder/audio/FileReadScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+void waitFor( const std::function<bool()> &condition )
+{
+	for( size_t i = 0; i < 5000 && ! condition(); i++ )
+		std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/FileReadScheduler" )
+{
+
+SECTION( "every request is serviced" )
+{
+	FileReadScheduler scheduler( 3 );
+	REQUIRE( scheduler.getNumThreads() == 3 );
+
+	const size_t numReaders = 200;
+	std::vector<std::atomic<size_t>> counts( numReaders );
+	std::vector<FileReadScheduler::ReaderRef> readers;
+	for( size_t i = 0; i < numReaders; i++ ) {
+		counts[i] = 0;
+		readers.push_back( scheduler.addReader( [&counts, i] { counts[i]++; } ) );
+	}
+	REQUIRE( scheduler.getNumReaders() == numReaders );
+
+	for( size_t i = 0; i < numReaders; i++ )
+		scheduler.requestRead( readers[i], 0.01 * i );
+
+	waitFor( [&] { return scheduler.getNumReadsServiced() == numReaders; } );
+	REQUIRE( scheduler.getNumReadsServiced() == numReaders );
+	for( size_t i = 0; i < numReaders; i++ )
+		REQUIRE( counts[i] == 1 );
+
+	for( auto &reader : readers )
+		scheduler.removeReader( reader );
+	REQUIRE( scheduler.getNumReaders() == 0 );
+}
+
+SECTION( "earliest deadline is read first" )
+{
+	FileReadScheduler scheduler( 1 );
+
+	// occupy the only thread, so that the following requests queue up
+	std::atomic<bool> blocking( true ), started( false );
+	auto blocker = scheduler.addReader( [&] {
+		started = true;
+		while( blocking )
+			std::this_thread::yield();
+	} );
+	scheduler.requestRead( blocker, 0 );
+	waitFor( [&] { return started.load(); } );
+
+	std::mutex orderMutex;
+	std::vector<int> order;
+	std::vector<FileReadScheduler::ReaderRef> readers;
+	for( int i = 0; i < 3; i++ ) {
+		readers.push_back( scheduler.addReader( [&, i] {
+			std::lock_guard<std::mutex> lock( orderMutex );
+			order.push_back( i );
+		} ) );
+	}
+
+	scheduler.requestRead( readers[0], 3.0 );
+	scheduler.requestRead( readers[1], 1.0 );
+	scheduler.requestRead( readers[2], 2.0 );
+	REQUIRE( readers[0]->isPending() );
+
+	blocking = false;
+	waitFor( [&] { return scheduler.getNumReadsServiced() == 4; } );
+
+	REQUIRE( order == std::vector<int>( { 1, 2, 0 } ) );
+}
+
+SECTION( "removeReader waits for the read in progress" )
+{
+	FileReadScheduler scheduler( 2 );
+
+	std::atomic<bool> started( false ), finished( false );
+	auto reader = scheduler.addReader( [&] {
+		started = true;
+		std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+		finished = true;
+	} );
+
+	scheduler.requestRead( reader, 0 );
+	waitFor( [&] { return started.load(); } );
+	scheduler.removeReader( reader );
+	REQUIRE( finished );
+
+	// changing the number of threads keeps working
+	scheduler.setNumThreads( 1 );
+	REQUIRE( scheduler.getNumThreads() == 1 );
+	std::atomic<size_t> count( 0 );
+	auto other = scheduler.addReader( [&] { count++; } );
+	scheduler.requestRead( other, 0 );
+	waitFor( [&] { return count == 1; } );
+	REQUIRE( count == 1 );
+	scheduler.removeReader( other );
+}
+
+} // "audio/FileReadScheduler"
@@ -0,0 +1,110 @@
+#include "catch.hpp"
+#include "cinder/audio/ContextOffline.h"
+#include "cinder/audio/GraphScheduler.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/GainNode.h"
+#include "cinder/audio/FilterNode.h"
+#include "cinder/audio/PanNode.h"
+#include "utils.h"
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// Builds voices of GenSineNode -> FilterLowPassNode -> Pan2dNode -> GainNode, grouped into sub-mixes that feed the output.
+// A shared modulator is connected to the last voice of each group, so some branches must stay serial.
+void buildVoices( const ContextRef &ctx, size_t numGroups, size_t voicesPerGroup )
+{
+	auto shared = ctx->makeNode<GenTriangleNode>( 3.0f );
+	auto sharedGain = ctx->makeNode<GainNode>( 0.1f );
+	shared >> sharedGain;
+	shared->enable();
+
+	for( size_t group = 0; group < numGroups; group++ ) {
+		auto subMix = ctx->makeNode<GainNode>( 0.5f );
+		subMix >> ctx->getOutput();
+
+		for( size_t voice = 0; voice < voicesPerGroup; voice++ ) {
+			float index = float( group * voicesPerGroup + voice );
+
+			auto gen = ctx->makeNode<GenSineNode>( 110.0f + index * 37.0f );
+			auto filter = ctx->makeNode<FilterLowPassNode>();
+			auto pan = ctx->makeNode<Pan2dNode>();
+			auto gain = ctx->makeNode<GainNode>( 0.0f );
+
+			filter->setCutoffFreq( 500.0f + index * 100.0f );
+			pan->setPos( index / float( numGroups * voicesPerGroup ) );
+			gain->getParam()->applyRamp( 0.2f, 0.05 );
+
+			gen >> filter >> pan >> gain >> subMix;
+			gen->enable( 0.001 * index );
+
+			if( voice == voicesPerGroup - 1 )
+				sharedGain >> filter;
+		}
+	}
+}
+
+void render( const ContextOfflineRef &ctx, size_t numFrames, BufferDynamic *result )
+{
+	ctx->getOutput()->enable();
+	ctx->render( numFrames, result );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/GraphScheduler" )
+{
+
+SECTION( "parallel output matches serial output" )
+{
+	auto serialCtx = ContextOffline::create( 44100, 256 );
+	buildVoices( serialCtx, 4, 8 );
+	BufferDynamic serial;
+	render( serialCtx, 44100 / 4, &serial );
+
+	auto parallelCtx = ContextOffline::create( 44100, 256 );
+	parallelCtx->enableParallelProcessing( 3 );
+	REQUIRE( parallelCtx->isParallelProcessingEnabled() );
+	REQUIRE( parallelCtx->getGraphScheduler()->getNumThreads() == 3 );
+
+	buildVoices( parallelCtx, 4, 8 );
+	BufferDynamic parallel;
+	render( parallelCtx, 44100 / 4, &parallel );
+
+	// every voice is a task, except for the last one of each group, where only the generator is since its filter also sums the shared modulator
+	REQUIRE( parallelCtx->getGraphScheduler()->getNumTasks() == 4 * 8 );
+	// Node::getInputs() is ordered by pointer, so the two contexts may sum their sub-mixes in a different order
+	REQUIRE( maxError( serial, parallel ) < 1e-6f );
+}
+
+SECTION( "connection changes are rescheduled" )
+{
+	auto ctx = ContextOffline::create( 44100, 128, Node::Format().channels( 1 ) );
+	ctx->enableParallelProcessing( 2 );
+
+	auto a = ctx->makeNode<GenSineNode>( 220.0f );
+	auto b = ctx->makeNode<GenSineNode>( 330.0f );
+	a >> ctx->getOutput();
+	a->enable();
+	b->enable();
+
+	BufferDynamic buffer;
+	render( ctx, 128, &buffer );
+	REQUIRE( ctx->getGraphScheduler()->getNumTasks() == 0 ); // a single input is not summed
+
+	b >> ctx->getOutput();
+	render( ctx, 128, &buffer );
+	REQUIRE( ctx->getGraphScheduler()->getNumTasks() == 2 );
+
+	b->disconnectAll();
+	render( ctx, 128, &buffer );
+	REQUIRE( ctx->getGraphScheduler()->getNumTasks() == 0 );
+
+	ctx->disableParallelProcessing();
+	REQUIRE( ! ctx->isParallelProcessingEnabled() );
+	REQUIRE( ctx->getGraphScheduler() == nullptr );
+}
+
+} // "audio/GraphScheduler"
@@ -0,0 +1,171 @@
+#include "catch.hpp"
+#include "cinder/audio/ContextOffline.h"
+#include "cinder/audio/GainNode.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/Param.h"
+#include "utils.h"
+
+#include <thread>
+
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// Reference implementation of the built-in ramps, evaluated one sample at a time.
+void rampReference( RampType type, float *array, size_t count, double t, double tIncr, float valueBegin, float valueEnd )
+{
+	for( size_t i = 0; i < count; i++ ) {
+		double factor = t;
+		if( type == RampType::IN_QUAD )
+			factor = t * t;
+		else if( type == RampType::OUT_QUAD )
+			factor = -t * ( t - 2 );
+
+		array[i] = valueBegin + ( valueEnd - valueBegin ) * float( factor );
+		t += tIncr;
+	}
+}
+
+// Returns a Context rendering a constant 1 through a GainNode, so that the output equals the gain Param.
+std::shared_ptr<ContextOffline> makeGainContext( GainNodeRef *gain )
+{
+	auto ctx = ContextOffline::create( 44100, 512, Node::Format().channels( 1 ) );
+	auto gen = ctx->makeNode<GenSineNode>( 0.0f );
+	*gain = ctx->makeNode<GainNode>( 0.0f );
+	gen >> *gain >> ctx->getOutput();
+	gen->setPhase( 0.25f );
+	gen->enable();
+	return ctx;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Param" )
+{
+
+SECTION( "built-in ramps match reference" )
+{
+	const RampType types[] = { RampType::LINEAR, RampType::IN_QUAD, RampType::OUT_QUAD };
+	const size_t counts[] = { 0, 1, 3, 4, 5, 17, 512 };
+
+	for( auto type : types ) {
+		for( size_t count : counts ) {
+			audio::Buffer expected( count + 1 ), actual( count + 1 );
+			rampReference( type, expected.getData(), count, 0.1, 1.0 / 700.0, -0.5f, 2.0f );
+
+			Param::Options options;
+			options.rampType( type );
+			options.getRampFn()( actual.getData(), count, 0.1, 1.0 / 700.0, -0.5f, 2.0f );
+
+			REQUIRE( maxError( expected, actual ) < 0.00001f );
+		}
+	}
+}
+
+SECTION( "options recognize built-in ramp functions" )
+{
+	REQUIRE( Param::Options().getRampType() == RampType::LINEAR );
+	REQUIRE( Param::Options().rampFn( rampInQuad ).getRampType() == RampType::IN_QUAD );
+	REQUIRE( Param::Options().rampFn( &rampOutQuad ).getRampType() == RampType::OUT_QUAD );
+	REQUIRE( Param::Options().rampFn( rampOutQuad ).rampType( RampType::LINEAR ).getRampType() == RampType::LINEAR );
+
+	auto custom = []( float *array, size_t count, double, double, float, float valueEnd ) {
+		std::fill( array, array + count, valueEnd );
+	};
+	REQUIRE( Param::Options().rampFn( custom ).getRampType() == RampType::CUSTOM );
+}
+
+SECTION( "custom ramp function is evaluated" )
+{
+	GainNodeRef gain;
+	auto ctx = makeGainContext( &gain );
+
+	auto custom = []( float *array, size_t count, double, double, float, float ) {
+		std::fill( array, array + count, 0.75f );
+	};
+	gain->getParam()->applyRamp( 1, 1024.0 / 44100.0, Param::Options().rampFn( custom ) );
+
+	BufferDynamic buffer;
+	ctx->render( 512, &buffer );
+	for( size_t i = 0; i < buffer.getNumFrames(); i++ )
+		REQUIRE( buffer[i] == Approx( 0.75f ) );
+}
+
+SECTION( "event queue grows past its initial size" )
+{
+	GainNodeRef gain;
+	auto ctx = makeGainContext( &gain );
+	auto param = gain->getParam();
+
+	const size_t numRamps = 300;
+	EventRef lastEvent;
+	for( size_t i = 0; i < numRamps; i++ )
+		lastEvent = param->appendRamp( float( i + 1 ) / numRamps, 64.0 / 44100.0 );
+
+	REQUIRE( param->getNumEvents() == numRamps );
+
+	// the Events run back to back, so the output rises monotonically to the last ramp's end value
+	BufferDynamic buffer;
+	ctx->render( numRamps * 64 + 1024, &buffer );
+	for( size_t i = 1; i < buffer.getNumFrames(); i++ )
+		REQUIRE( buffer[i] >= buffer[i - 1] - 0.00001f );
+
+	REQUIRE( lastEvent->isComplete() );
+	REQUIRE( param->getNumEvents() == 0 );
+	REQUIRE( param->getValue() == Approx( 1 ) );
+}
+
+SECTION( "applyRamp replaces scheduled events" )
+{
+	GainNodeRef gain;
+	auto ctx = makeGainContext( &gain );
+	auto param = gain->getParam();
+
+	auto first = param->appendRamp( 0.5f, 0.1 );
+	auto second = param->appendRamp( 0.8f, 0.1 );
+	auto replacement = param->applyRamp( 0.2f, 0.1, Param::Options().beginTime( 0.05 ) );
+
+	BufferDynamic buffer;
+	ctx->render( 44100 / 4, &buffer );
+
+	// the first ramp is cut off where the replacement begins, the second never runs
+	REQUIRE( ! first->isComplete() );
+	REQUIRE( ! second->isComplete() );
+	REQUIRE( replacement->isComplete() );
+	REQUIRE( param->getNumEvents() == 0 );
+
+	const size_t replacementFrame = size_t( 0.05 * 44100 );
+	REQUIRE( buffer[replacementFrame - 1] < 0.26f );
+	for( size_t i = replacementFrame + 1; i < buffer.getNumFrames(); i++ )
+		REQUIRE( buffer[i] < 0.26f );
+	REQUIRE( buffer[buffer.getNumFrames() - 1] == Approx( 0.2f ) );
+}
+
+SECTION( "scheduling from another thread while rendering" )
+{
+	GainNodeRef gain;
+	auto ctx = makeGainContext( &gain );
+	auto param = gain->getParam();
+
+	const size_t numRamps = 2000;
+	std::thread scheduler( [param, numRamps] {
+		for( size_t i = 0; i < numRamps; i++ )
+			param->applyRamp( float( i % 10 ) / 10.0f, 0.001 );
+
+		param->applyRamp( 0.5f, 0.001 );
+	} );
+
+	BufferDynamic buffer;
+	for( size_t i = 0; i < 200; i++ )
+		ctx->render( 512, &buffer );
+
+	scheduler.join();
+	ctx->render( 4096, &buffer );
+
+	REQUIRE( param->getNumEvents() == 0 );
+	REQUIRE( param->getValue() == Approx( 0.5f ) );
+	REQUIRE( buffer[buffer.getNumFrames() - 1] == Approx( 0.5f ) );
+}
+
+} // "audio/Param"
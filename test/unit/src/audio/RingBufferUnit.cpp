@@ -74,4 +74,56 @@ SECTION( "threaded stress" )
 	CI_LOG_I( "writer joined." );
 }
 
+SECTION( "multichannel write regions wrap around" )
+{
+	dsp::MultiChannelRingBuffer rb( 10, 2 );
+	REQUIRE( rb.getSize() == 10 );
+	REQUIRE( rb.getAvailableWrite() == 10 );
+
+	audio::Buffer out( 10, 2 );
+	float nextValue = 0;
+	float expectedValue = 0;
+
+	// fill in place in uneven pieces, so that the free region regularly wraps around the end
+	for( size_t iteration = 0; iteration < 20; iteration++ ) {
+		size_t numToWrite = 3 + iteration % 5;
+		while( numToWrite ) {
+			size_t regionFrames;
+			size_t offset = rb.getWriteRegion( &regionFrames );
+			size_t count = std::min( regionFrames, numToWrite );
+			REQUIRE( count > 0 );
+			REQUIRE( offset + count <= rb.getBuffer()->getNumFrames() );
+
+			for( size_t i = 0; i < count; i++ ) {
+				rb.getBuffer()->getChannel( 0 )[offset + i] = nextValue;
+				rb.getBuffer()->getChannel( 1 )[offset + i] = -nextValue;
+				nextValue += 1;
+			}
+			rb.commitWrite( count );
+			numToWrite -= count;
+		}
+
+		size_t numToRead = rb.getAvailableRead();
+		REQUIRE( rb.read( &out, numToRead ) );
+		for( size_t i = 0; i < numToRead; i++ ) {
+			REQUIRE( out.getChannel( 0 )[i] == expectedValue );
+			REQUIRE( out.getChannel( 1 )[i] == -expectedValue );
+			expectedValue += 1;
+		}
+	}
+
+	// copying in behaves like RingBufferT
+	audio::Buffer in( 10, 2 );
+	for( size_t i = 0; i < in.getSize(); i++ )
+		in[i] = float( i );
+
+	REQUIRE( rb.write( in, 7 ) );
+	REQUIRE( ! rb.write( in, 4 ) );
+	REQUIRE( rb.write( in, 3 ) );
+	REQUIRE( rb.getAvailableWrite() == 0 );
+	REQUIRE( rb.read( &out, 7 ) );
+	REQUIRE( ! rb.read( &out, 4 ) );
+	REQUIRE( out.getChannel( 1 )[6] == in.getChannel( 1 )[6] );
+}
+
 } // audio/RingBuffer